@@ -23,14 +23,11 @@
 
 #include <ert/util/util.h>
 
-#include <ert/ecl/ecl_kw.h>
-#include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_util.h>
-#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_convert.h>
 
 
 void file_convert(const char * src_file , const char * target_file, ecl_file_enum file_type , bool fmt_src) {
-  fortio_type *src , *target;
   bool formatted_src;
 
   printf("Converting %s -> %s \n",src_file , target_file);
@@ -43,27 +40,8 @@ void file_convert(const char * src_file , const char * target_file, ecl_file_enu
       formatted_src = false;
   }
 
-  target = fortio_open_writer(target_file , !formatted_src , ECL_ENDIAN_FLIP );
-  src    = fortio_open_reader(src_file  , formatted_src , ECL_ENDIAN_FLIP);
-
-  while (true) {
-    if (fortio_read_at_eof( src ))
-      break;
-
-    {
-      ecl_kw_type * ecl_kw = ecl_kw_fread_alloc( src );
-      if (ecl_kw) {
-        ecl_kw_fwrite(ecl_kw , target);
-        ecl_kw_free(ecl_kw);
-      } else {
-        fprintf(stderr, "Reading keyword failed \n");
-        break;
-      }
-    }
-  }
-
-  fortio_fclose(src);
-  fortio_fclose(target);
+  if (!ecl_convert_file(src_file , formatted_src , target_file , 0))
+    fprintf(stderr, "Reading keyword failed \n");
 }
 
 
@@ -0,0 +1,905 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_GETRUSAGE
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/double_vector.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_init_file.h>
+#include <ert/ecl/ecl_rst_file.h>
+#include <ert/ecl/ecl_rsthead.h>
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_smspec.h>
+#include <ert/ecl/smspec_node.h>
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_grav.h>
+#include <ert/ecl/ecl_perf.h>
+#include <ert/ecl/ecl_cmp.h>
+#include <ert/ecl/ecl_convert.h>
+
+/*
+  Benchmark for the hot paths in libecl. The program first writes a
+  synthetic case (EGRID with NNCs, INIT, UNRST and unified summary)
+  with the library writer functions, and then times a fixed sequence
+  of operations on that case. The results are written as JSON so they
+  can be compared between builds.
+
+  The size of the case is controlled with the scale argument; all the
+  input is generated from a fixed seed so two runs with the same scale
+  operate on identical files. The default scale gives a case which is
+  processed in a few seconds, a scale of 8 gives an UNRST file of
+  several GB.
+*/
+
+#define BENCH_CASE        "BENCH"
+#define BENCH_MAX_RESULTS 32
+#define BENCH_PHASES      (ECL_OIL_PHASE + ECL_WATER_PHASE)
+
+
+typedef struct {
+  int    scale;
+  int    nx;
+  int    ny;
+  int    nz;
+  int    report_steps;
+  int    num_wells;
+  int    sum_tsteps;
+  int    num_points;
+  int    num_stations;
+  double dx;
+  double dy;
+  double dz;
+  time_t start_time;
+} bench_config_type;
+
+
+typedef struct {
+  const char * name;
+  double       seconds;
+  long long    items;
+  long long    bytes;
+  long long    bytes_read;
+  long long    kw_read;
+  long         max_rss_kb;
+  double       checksum;
+} bench_result_type;
+
+
+typedef struct {
+  bench_config_type config;
+  char            * path;
+  char            * case_name;
+  char            * grid_file;
+  char            * init_file;
+  char            * restart_file;
+  stringlist_type * files;        /* The files generated by the bench; removed unless -k is given. */
+  bool              created_path; /* The directory did not exist and was created by the bench. */
+  int               num_results;
+  bench_result_type results[BENCH_MAX_RESULTS];
+} bench_type;
+
+
+typedef struct {
+  const char * name;
+  int64_t      start_ns;
+  int64_t      bytes_read;
+  int64_t      kw_read;
+} bench_timer_type;
+
+
+/*****************************************************************/
+
+static long bench_max_rss_kb( void ) {
+#ifdef HAVE_GETRUSAGE
+  struct rusage usage;
+  if (getrusage( RUSAGE_SELF , &usage ) == 0)
+    return usage.ru_maxrss;
+#endif
+  return -1;
+}
+
+
+static void bench_timer_start( bench_timer_type * timer , const char * name ) {
+  timer->name       = name;
+  timer->bytes_read = ecl_perf_get( ECL_PERF_BYTES_READ );
+  timer->kw_read    = ecl_perf_get( ECL_PERF_KW_READ );
+  timer->start_ns   = ecl_perf_clock_ns( );
+}
+
+
+static void bench_timer_stop( bench_type * bench , const bench_timer_type * timer , long long items , long long bytes , double checksum) {
+  int64_t stop_ns = ecl_perf_clock_ns( );
+  if (bench->num_results == BENCH_MAX_RESULTS)
+    util_abort("%s: too many results \n",__func__);
+  {
+    bench_result_type * result = &bench->results[ bench->num_results ];
+    result->name       = timer->name;
+    result->seconds    = (stop_ns - timer->start_ns) * 1e-9;
+    result->items      = items;
+    result->bytes      = bytes;
+    result->bytes_read = ecl_perf_get( ECL_PERF_BYTES_READ ) - timer->bytes_read;
+    result->kw_read    = ecl_perf_get( ECL_PERF_KW_READ ) - timer->kw_read;
+    result->max_rss_kb = bench_max_rss_kb( );
+    result->checksum   = checksum;
+    bench->num_results++;
+
+    fprintf(stderr , "%-20s %10.4f s  %12lld items\n" , result->name , result->seconds , result->items );
+  }
+}
+
+
+/*****************************************************************/
+
+static void bench_config_init( bench_config_type * config , int scale ) {
+  config->scale        = scale;
+  config->nx           = 40 * scale;
+  config->ny           = 40 * scale;
+  config->nz           = 20;
+  config->report_steps = 10 * scale;
+  config->num_wells    = 100 * scale;
+  config->sum_tsteps   = 500 * scale;
+  config->num_points   = 10000;
+  config->num_stations = 10;
+  config->dx           = 50;
+  config->dy           = 50;
+  config->dz           = 5;
+  config->start_time   = util_make_date_utc( 1 , 1 , 2010 );
+}
+
+
+static bench_type * bench_alloc( const char * path , int scale ) {
+  bench_type * bench = util_malloc( sizeof * bench );
+  bench_config_init( &bench->config , scale );
+  bench->path         = util_alloc_string_copy( path );
+  bench->case_name    = util_alloc_filename( path , BENCH_CASE , NULL );
+  bench->grid_file    = ecl_util_alloc_filename( path , BENCH_CASE , ECL_EGRID_FILE , false , 0 );
+  bench->init_file    = ecl_util_alloc_filename( path , BENCH_CASE , ECL_INIT_FILE , false , 0 );
+  bench->restart_file = ecl_util_alloc_filename( path , BENCH_CASE , ECL_UNIFIED_RESTART_FILE , false , 0 );
+  bench->num_results  = 0;
+  bench->files        = stringlist_alloc_new( );
+  stringlist_append_copy( bench->files , bench->grid_file );
+  stringlist_append_copy( bench->files , bench->init_file );
+  stringlist_append_copy( bench->files , bench->restart_file );
+  stringlist_append_owned_ref( bench->files , ecl_util_alloc_filename( path , BENCH_CASE , ECL_SUMMARY_HEADER_FILE , false , 0 ));
+  stringlist_append_owned_ref( bench->files , ecl_util_alloc_filename( path , BENCH_CASE , ECL_UNIFIED_SUMMARY_FILE , false , 0 ));
+
+  bench->created_path = !util_is_directory( path );
+  util_make_path( path );
+  return bench;
+}
+
+
+/*
+  Removes the files generated by the bench, and the directory if it
+  was created by the bench and is empty; other content of the
+  directory is left alone.
+*/
+
+static void bench_remove_files( const bench_type * bench ) {
+  for (int i = 0; i < stringlist_get_size( bench->files ); i++)
+    util_unlink_existing( stringlist_iget( bench->files , i ));
+
+  if (bench->created_path)
+    rmdir( bench->path );
+}
+
+
+static void bench_free( bench_type * bench ) {
+  stringlist_free( bench->files );
+  free( bench->restart_file );
+  free( bench->init_file );
+  free( bench->grid_file );
+  free( bench->case_name );
+  free( bench->path );
+  free( bench );
+}
+
+
+/*****************************************************************/
+/* Generating the synthetic case. */
+
+static bool bench_cell_active( const bench_config_type * config , int i , int j , int k) {
+  return !(((i % 10) == 0) && ((k % 5) == 0));
+}
+
+
+static ecl_grid_type * bench_alloc_grid( const bench_config_type * config ) {
+  const int global_size = config->nx * config->ny * config->nz;
+  int * actnum = util_malloc( global_size * sizeof * actnum );
+  ecl_grid_type * grid;
+  int i,j,k;
+
+  for (k=0; k < config->nz; k++)
+    for (j=0; j < config->ny; j++)
+      for (i=0; i < config->nx; i++)
+        actnum[ i + j*config->nx + k*config->nx*config->ny ] = bench_cell_active( config , i , j , k ) ? 1 : 0;
+
+  grid = ecl_grid_alloc_rectangular( config->nx , config->ny , config->nz , config->dx , config->dy , config->dz , actnum );
+
+  /*
+    A fault through the middle of the grid; each cell on one side is
+    connected to the cell one layer further down on the other side.
+  */
+  {
+    int_vector_type * g1 = int_vector_alloc( 0 , 0 );
+    int_vector_type * g2 = int_vector_alloc( 0 , 0 );
+    int i1 = config->nx / 2 - 1;
+    for (k=0; k < config->nz - 1; k++) {
+      for (j=0; j < config->ny; j++) {
+        int_vector_append( g1 , ecl_grid_get_global_index3( grid , i1 , j , k ));
+        int_vector_append( g2 , ecl_grid_get_global_index3( grid , i1 + 1 , j , k + 1 ));
+      }
+    }
+    ecl_grid_add_self_nnc_list( grid , int_vector_get_ptr( g1 ) , int_vector_get_ptr( g2 ) , int_vector_size( g1 ));
+    int_vector_free( g2 );
+    int_vector_free( g1 );
+  }
+
+  free( actnum );
+  return grid;
+}
+
+
+static void bench_write_init( const bench_type * bench , const ecl_grid_type * grid , rng_type * rng) {
+  const int nactive = ecl_grid_get_nactive( grid );
+  ecl_kw_type * poro = ecl_kw_alloc( "PORO" , nactive , ECL_FLOAT );
+  ecl_kw_type * perm = ecl_kw_alloc( "PERMX" , nactive , ECL_FLOAT );
+  int i;
+
+  for (i=0; i < nactive; i++) {
+    ecl_kw_iset_float( poro , i , 0.15 + 0.15 * rng_get_double( rng ));
+    ecl_kw_iset_float( perm , i , 10 + 990 * rng_get_double( rng ));
+  }
+
+  {
+    fortio_type * fortio = fortio_open_writer( bench->init_file , false , ECL_ENDIAN_FLIP );
+    ecl_init_file_fwrite_header( fortio , grid , poro , ECL_METRIC_UNITS , BENCH_PHASES , bench->config.start_time );
+    ecl_kw_fwrite( perm , fortio );
+    fortio_fclose( fortio );
+  }
+
+  ecl_kw_free( perm );
+  ecl_kw_free( poro );
+}
+
+
+/*
+  The restart file contains the keywords needed to evaluate the
+  gravity response with the RPORV method, i.e. RPORV, SWAT and the
+  phase densities; in addition PRESSURE and SGAS are written to
+  get a realistic number of solution keywords.
+*/
+
+static long long bench_write_restart( const bench_type * bench , const ecl_grid_type * grid , rng_type * rng) {
+  const bench_config_type * config = &bench->config;
+  const int nactive = ecl_grid_get_nactive( grid );
+  ecl_file_type * init_file = ecl_file_open( bench->init_file , 0 );
+  const ecl_kw_type * porv_kw = ecl_file_iget_named_kw( init_file , PORV_KW , 0 );
+  ecl_rst_file_type * rst_file = ecl_rst_file_open_write( bench->restart_file );
+  ecl_kw_type * pressure = ecl_kw_alloc( "PRESSURE" , nactive , ECL_FLOAT );
+  ecl_kw_type * swat     = ecl_kw_alloc( "SWAT" , nactive , ECL_FLOAT );
+  ecl_kw_type * sgas     = ecl_kw_alloc( "SGAS" , nactive , ECL_FLOAT );
+  ecl_kw_type * rporv    = ecl_kw_alloc( RPORV_KW , nactive , ECL_FLOAT );
+  ecl_kw_type * oil_den  = ecl_kw_alloc( ECLIPSE100_OIL_DEN_KW , nactive , ECL_FLOAT );
+  ecl_kw_type * wat_den  = ecl_kw_alloc( ECLIPSE100_WATER_DEN_KW , nactive , ECL_FLOAT );
+  long long bytes = 0;
+  int report_step;
+
+  for (report_step = 1; report_step <= config->report_steps; report_step++) {
+    double sim_days = 30.0 * report_step;
+    double sw0 = 0.2 + 0.6 * report_step / config->report_steps;
+    int global_index;
+
+    for (global_index = 0; global_index < ecl_grid_get_global_size( grid ); global_index++) {
+      int active_index = ecl_grid_get_active_index1( grid , global_index );
+      if (active_index >= 0) {
+        double r = rng_get_double( rng );
+        double sw = util_double_min( 0.95 , sw0 * (0.9 + 0.2 * r));
+        ecl_kw_iset_float( pressure , active_index , 200 + 50 * r - 0.1 * report_step );
+        ecl_kw_iset_float( swat     , active_index , sw );
+        ecl_kw_iset_float( sgas     , active_index , 0 );
+        ecl_kw_iset_float( rporv    , active_index , ecl_kw_iget_float( porv_kw , global_index ) * (1 + 0.01 * r));
+        ecl_kw_iset_float( oil_den  , active_index , 800 + 20 * r );
+        ecl_kw_iset_float( wat_den  , active_index , 1000 + 10 * r );
+      }
+    }
+
+    {
+      ecl_rsthead_type * rsthead = ecl_rsthead_alloc_empty( );
+      rsthead->sim_time    = config->start_time + util_int_max( 1 , (int) (sim_days * 86400));
+      rsthead->sim_days    = sim_days;
+      rsthead->nx          = config->nx;
+      rsthead->ny          = config->ny;
+      rsthead->nz          = config->nz;
+      rsthead->nactive     = nactive;
+      rsthead->phase_sum   = BENCH_PHASES;
+      rsthead->unit_system = ECL_METRIC_UNITS;
+      ecl_rst_file_fwrite_header( rst_file , report_step , rsthead );
+      ecl_rsthead_free( rsthead );
+    }
+
+    ecl_rst_file_start_solution( rst_file );
+    ecl_rst_file_add_kw( rst_file , pressure );
+    ecl_rst_file_add_kw( rst_file , swat );
+    ecl_rst_file_add_kw( rst_file , sgas );
+    ecl_rst_file_add_kw( rst_file , rporv );
+    ecl_rst_file_add_kw( rst_file , oil_den );
+    ecl_rst_file_add_kw( rst_file , wat_den );
+    ecl_rst_file_end_solution( rst_file );
+    bytes += 6 * (long long) nactive * sizeof(float);
+  }
+
+  ecl_kw_free( wat_den );
+  ecl_kw_free( oil_den );
+  ecl_kw_free( rporv );
+  ecl_kw_free( sgas );
+  ecl_kw_free( swat );
+  ecl_kw_free( pressure );
+  ecl_rst_file_close( rst_file );
+  ecl_file_close( init_file );
+  return bytes;
+}
+
+
+static long long bench_write_summary( const bench_type * bench , rng_type * rng) {
+  const bench_config_type * config = &bench->config;
+  const int vars_per_well = 4;
+  const char * well_vars[4] = {"WOPR" , "WWPR" , "WGPR" , "WBHP"};
+  const int num_nodes = 2 + vars_per_well * config->num_wells;
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( bench->case_name , false , true , ":" , config->start_time , true , config->nx , config->ny , config->nz );
+  smspec_node_type ** nodes = util_malloc( num_nodes * sizeof * nodes );
+  int tstep_per_report = util_int_max( 1 , config->sum_tsteps / config->report_steps );
+  int w , v , t;
+
+  nodes[0] = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0 );
+  nodes[1] = ecl_sum_add_var( ecl_sum , "FOPR" , NULL , 0 , "SM3/DAY" , 0 );
+  for (w = 0; w < config->num_wells; w++) {
+    char well[16];
+    sprintf( well , "W%05d" , w );
+    for (v = 0; v < vars_per_well; v++)
+      nodes[ 2 + w*vars_per_well + v ] = ecl_sum_add_var( ecl_sum , well_vars[v] , well , 0 , "SM3/DAY" , 0 );
+  }
+
+  {
+    double fopt = 0;
+    for (t = 0; t < config->sum_tsteps; t++) {
+      double sim_days = 0.5 * (t + 1);
+      ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , 1 + t / tstep_per_report , sim_days * 86400 );
+      double fopr = 0;
+      int i;
+      for (i = 2; i < num_nodes; i++) {
+        float value = 100 * rng_get_double( rng );
+        ecl_sum_tstep_set_from_node( tstep , nodes[i] , value );
+        if (((i - 2) % vars_per_well) == 0)
+          fopr += value;
+      }
+      fopt += 0.5 * fopr;
+      ecl_sum_tstep_set_from_node( tstep , nodes[0] , fopt );
+      ecl_sum_tstep_set_from_node( tstep , nodes[1] , fopr );
+    }
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+  free( nodes );
+  return (long long) num_nodes * config->sum_tsteps * sizeof(float);
+}
+
+
+static void bench_generate( bench_type * bench ) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  bench_timer_type timer;
+  ecl_grid_type * grid;
+
+  bench_timer_start( &timer , "write_grid" );
+  grid = bench_alloc_grid( &bench->config );
+  ecl_grid_fwrite_EGRID2( grid , bench->grid_file , ECL_METRIC_UNITS );
+  bench_timer_stop( bench , &timer , ecl_grid_get_global_size( grid ) , util_file_size( bench->grid_file ) , 0);
+
+  bench_timer_start( &timer , "write_init" );
+  bench_write_init( bench , grid , rng );
+  bench_timer_stop( bench , &timer , ecl_grid_get_nactive( grid ) , util_file_size( bench->init_file ) , 0);
+
+  {
+    long long bytes;
+    bench_timer_start( &timer , "write_restart" );
+    bytes = bench_write_restart( bench , grid , rng );
+    bench_timer_stop( bench , &timer , 6 * bench->config.report_steps , bytes , 0);
+  }
+
+  {
+    long long bytes;
+    bench_timer_start( &timer , "write_summary" );
+    bytes = bench_write_summary( bench , rng );
+    bench_timer_stop( bench , &timer , bench->config.sum_tsteps , bytes , 0);
+  }
+
+  ecl_grid_free( grid );
+  rng_free( rng );
+}
+
+
+/*****************************************************************/
+/* The benchmarks proper. */
+
+static void bench_restart( bench_type * bench ) {
+  bench_timer_type timer;
+  long long file_size = util_file_size( bench->restart_file );
+
+  {
+    ecl_file_type * rst_file;
+    bench_timer_start( &timer , "open_scan" );
+    rst_file = ecl_file_open( bench->restart_file , 0 );
+    bench_timer_stop( bench , &timer , ecl_file_get_size( rst_file ) , file_size , 0);
+    ecl_file_close( rst_file );
+  }
+
+  {
+    ecl_file_type * rst_file = ecl_file_open( bench->restart_file , 0 );
+    int num_kw = ecl_file_get_num_named_kw( rst_file , "PRESSURE" );
+    double sum = 0;
+    long long bytes = 0;
+    int i;
+
+    bench_timer_start( &timer , "kw_load" );
+    for (i = 0; i < num_kw; i++) {
+      const ecl_kw_type * pressure = ecl_file_iget_named_kw( rst_file , "PRESSURE" , i );
+      sum += ecl_kw_iget_as_double( pressure , 0 );
+      bytes += ecl_kw_get_size( pressure ) * sizeof(float);
+    }
+    bench_timer_stop( bench , &timer , num_kw , bytes , sum);
+
+    bench_timer_start( &timer , "load_all" );
+    ecl_file_load_all( rst_file );
+    bench_timer_stop( bench , &timer , ecl_file_get_size( rst_file ) , file_size , 0);
+    ecl_file_close( rst_file );
+  }
+
+  {
+    ecl_file_type * file1 = ecl_file_open( bench->restart_file , 0 );
+    ecl_file_type * file2 = ecl_file_open( bench->restart_file , 0 );
+    ecl_cmp_type * ecl_cmp = ecl_cmp_alloc( 0 , 1e-6 );
+
+    bench_timer_start( &timer , "cmp_restart" );
+    ecl_cmp_files( ecl_cmp , file1 , file2 );
+    bench_timer_stop( bench , &timer , ecl_cmp_get_size( ecl_cmp ) , 2 * file_size , ecl_cmp_get_num_different( ecl_cmp ));
+
+    ecl_cmp_free( ecl_cmp );
+    ecl_file_close( file1 );
+    ecl_file_close( file2 );
+  }
+
+  {
+    /* The same restart data as one non-unified file per report step. */
+    ecl_file_type * unrst_file = ecl_file_open( bench->restart_file , 0 );
+    stringlist_type * x_files = stringlist_alloc_new( );
+    int num_steps = ecl_file_get_num_named_kw( unrst_file , SEQNUM_KW );
+    int i;
+
+    for (i = 0; i < num_steps; i++) {
+      ecl_file_view_type * view = ecl_file_alloc_global_blockview( unrst_file , SEQNUM_KW , i );
+      int report_step = ecl_kw_iget_int( ecl_file_view_iget_named_kw( view , SEQNUM_KW , 0 ) , 0 );
+      char * filename = ecl_util_alloc_filename( bench->path , BENCH_CASE , ECL_RESTART_FILE , false , report_step );
+      fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+
+      ecl_file_view_fwrite( view , fortio , 1 );
+      fortio_fclose( fortio );
+      ecl_file_view_free( view );
+      stringlist_append_owned_ref( x_files , filename );
+    }
+    ecl_file_close( unrst_file );
+
+    {
+      ecl_file_type * rst_set;
+      bench_timer_start( &timer , "open_restart_set" );
+      rst_set = ecl_file_open_restart_set( x_files , 0 );
+      bench_timer_stop( bench , &timer , ecl_file_get_size( rst_set ) , file_size , 0);
+
+      bench_timer_start( &timer , "load_all_restart_set" );
+      ecl_file_load_all( rst_set );
+      bench_timer_stop( bench , &timer , ecl_file_get_size( rst_set ) , file_size , 0);
+      ecl_file_close( rst_set );
+    }
+
+    {
+      /* Formatted conversion is slow; only the first report step is converted. */
+      const char * src_file = stringlist_iget( x_files , 0 );
+      char * fmt_file = util_alloc_sprintf( "%s.F" , src_file );
+      char * unfmt_file = util_alloc_sprintf( "%s.X" , src_file );
+      long long src_size = util_file_size( src_file );
+      long long fmt_size;
+
+      bench_timer_start( &timer , "convert_fmt_serial" );
+      ecl_convert_file( src_file , false , fmt_file , 1 );
+      bench_timer_stop( bench , &timer , 1 , src_size , 0);
+
+      bench_timer_start( &timer , "convert_fmt" );
+      ecl_convert_file( src_file , false , fmt_file , 0 );
+      bench_timer_stop( bench , &timer , 1 , src_size , 0);
+
+      fmt_size = util_file_size( fmt_file );
+      bench_timer_start( &timer , "convert_unfmt_serial" );
+      ecl_convert_file( fmt_file , true , unfmt_file , 1 );
+      bench_timer_stop( bench , &timer , 1 , fmt_size , 0);
+
+      bench_timer_start( &timer , "convert_unfmt" );
+      ecl_convert_file( fmt_file , true , unfmt_file , 0 );
+      bench_timer_stop( bench , &timer , 1 , fmt_size , 0);
+
+      util_unlink_existing( fmt_file );
+      util_unlink_existing( unfmt_file );
+      free( fmt_file );
+      free( unfmt_file );
+    }
+
+    for (i = 0; i < stringlist_get_size( x_files ); i++)
+      util_unlink_existing( stringlist_iget( x_files , i ));
+    stringlist_free( x_files );
+  }
+}
+
+
+static void bench_summary( bench_type * bench ) {
+  bench_timer_type timer;
+  ecl_sum_type * ecl_sum;
+
+  bench_timer_start( &timer , "summary_load" );
+  ecl_sum = ecl_sum_fread_alloc_case( bench->case_name , ":" );
+  bench_timer_stop( bench , &timer , ecl_sum_get_data_length( ecl_sum ) , 0 , 0);
+
+  {
+    const ecl_smspec_type * smspec = ecl_sum_get_smspec( ecl_sum );
+    int num_nodes = ecl_smspec_num_nodes( smspec );
+    long long items = 0;
+    double sum = 0;
+    int i;
+
+    bench_timer_start( &timer , "summary_vectors" );
+    for (i = 0; i < num_nodes; i++) {
+      const smspec_node_type * node = ecl_smspec_iget_node( smspec , i );
+      if (smspec_node_get_gen_key1( node )) {
+        double_vector_type * data = ecl_sum_alloc_data_vector( ecl_sum , smspec_node_get_params_index( node ) , false );
+        sum += double_vector_get_last( data );
+        items += double_vector_size( data );
+        double_vector_free( data );
+      }
+    }
+    bench_timer_stop( bench , &timer , items , items * sizeof(double) , sum);
+
+    {
+      double_vector_type * sim_days = double_vector_alloc( 0 , 0 );
+      double_vector_type * value = double_vector_alloc( 0 , 0 );
+      double length = ecl_sum_get_sim_length( ecl_sum );
+      double first = ecl_sum_get_first_day( ecl_sum );
+      int num_days = 365;
+
+      for (i = 0; i < num_days; i++)
+        double_vector_append( sim_days , first + (length - first) * i / (num_days - 1));
+
+      items = 0;
+      sum = 0;
+      bench_timer_start( &timer , "summary_resample" );
+      for (i = 0; i < num_nodes; i++) {
+        const smspec_node_type * node = ecl_smspec_iget_node( smspec , i );
+        const char * gen_key = smspec_node_get_gen_key1( node );
+        if (gen_key) {
+          ecl_sum_resample_from_sim_days( ecl_sum , sim_days , value , gen_key );
+          sum += double_vector_get_last( value );
+          items += double_vector_size( value );
+        }
+      }
+      bench_timer_stop( bench , &timer , items , items * sizeof(double) , sum);
+
+      double_vector_free( value );
+      double_vector_free( sim_days );
+    }
+
+    {
+      ecl_cmp_type * ecl_cmp = ecl_cmp_alloc( 0 , 1e-6 );
+      bench_timer_start( &timer , "cmp_summary" );
+      ecl_cmp_sum( ecl_cmp , ecl_sum , ecl_sum );
+      bench_timer_stop( bench , &timer , (long long) ecl_cmp_get_size( ecl_cmp ) * ecl_sum_get_data_length( ecl_sum ) , 0 , ecl_cmp_get_num_different( ecl_cmp ));
+      ecl_cmp_free( ecl_cmp );
+    }
+  }
+  ecl_sum_free( ecl_sum );
+}
+
+
+static void bench_grid( bench_type * bench ) {
+  const bench_config_type * config = &bench->config;
+  bench_timer_type timer;
+  ecl_grid_type * grid;
+
+  bench_timer_start( &timer , "grid_load" );
+  grid = ecl_grid_alloc( bench->grid_file );
+  bench_timer_stop( bench , &timer , ecl_grid_get_global_size( grid ) , util_file_size( bench->grid_file ) , 0);
+
+  {
+    double volume = 0;
+    int g;
+    bench_timer_start( &timer , "grid_volume" );
+    for (g = 0; g < ecl_grid_get_global_size( grid ); g++)
+      volume += ecl_grid_get_cell_volume1( grid , g );
+    bench_timer_stop( bench , &timer , ecl_grid_get_global_size( grid ) , 0 , volume);
+  }
+
+  /*
+    The points are visited along a random walk, so the start_index
+    hint passed to ecl_grid_get_global_index_from_xyz() is typically a
+    near neighbour; this is the access pattern when e.g. following a
+    well trajectory.
+  */
+  {
+    rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+    double xmax = config->nx * config->dx;
+    double ymax = config->ny * config->dy;
+    double zmax = config->nz * config->dz;
+    double x = 0.5 * xmax;
+    double y = 0.5 * ymax;
+    double z = 0.5 * zmax;
+    int start_index = 0;
+    long long found = 0;
+    int p;
+
+    bench_timer_start( &timer , "point_location" );
+    for (p = 0; p < config->num_points; p++) {
+      int global_index;
+      x = util_double_max( 0.01 , util_double_min( xmax - 0.01 , x + config->dx * (rng_get_double( rng ) - 0.5)));
+      y = util_double_max( 0.01 , util_double_min( ymax - 0.01 , y + config->dy * (rng_get_double( rng ) - 0.5)));
+      z = util_double_max( 0.01 , util_double_min( zmax - 0.01 , z + config->dz * (rng_get_double( rng ) - 0.5)));
+      global_index = ecl_grid_get_global_index_from_xyz( grid , x , y , z , start_index );
+      if (global_index >= 0) {
+        start_index = global_index;
+        found++;
+      }
+    }
+    bench_timer_stop( bench , &timer , config->num_points , 0 , found);
+
+    found = 0;
+    bench_timer_start( &timer , "point_location_xy" );
+    for (p = 0; p < config->num_points; p++) {
+      int i , j;
+      x = xmax * rng_get_double( rng );
+      y = ymax * rng_get_double( rng );
+      if (ecl_grid_get_ij_from_xy( grid , x , y , 0 , &i , &j ))
+        found++;
+    }
+    bench_timer_stop( bench , &timer , config->num_points , 0 , found);
+
+    {
+      double * xlist = util_malloc( config->num_points * sizeof * xlist );
+      double * ylist = util_malloc( config->num_points * sizeof * ylist );
+      int * ilist = util_malloc( config->num_points * sizeof * ilist );
+      int * jlist = util_malloc( config->num_points * sizeof * jlist );
+
+      for (p = 0; p < config->num_points; p++) {
+        xlist[p] = xmax * rng_get_double( rng );
+        ylist[p] = ymax * rng_get_double( rng );
+      }
+
+      bench_timer_start( &timer , "point_xy_list" );
+      found = ecl_grid_get_ij_from_xy_list( grid , 0 , config->num_points , xlist , ylist , ilist , jlist );
+      bench_timer_stop( bench , &timer , config->num_points , 0 , found);
+
+      free( jlist );
+      free( ilist );
+      free( ylist );
+      free( xlist );
+    }
+    rng_free( rng );
+  }
+
+  {
+    ecl_file_type * rst_file = ecl_file_open( bench->restart_file , 0 );
+    const ecl_kw_type * pressure = ecl_file_iget_named_kw( rst_file , "PRESSURE" , 0 );
+    const ecl_kw_type * swat = ecl_file_iget_named_kw( rst_file , "SWAT" , 0 );
+    ecl_region_type * region = ecl_region_alloc( grid , false );
+    long long selected = 0;
+    int repeat;
+
+    bench_timer_start( &timer , "region_select" );
+    for (repeat = 0; repeat < 10; repeat++) {
+      ecl_region_deselect_all( region );
+      ecl_region_select_from_ijkbox( region , 0 , config->nx / 2 , 0 , config->ny / 2 , 0 , config->nz - 1);
+      ecl_region_select_in_cylinder( region , 0.5 * config->nx * config->dx , 0.5 * config->ny * config->dy , 0.25 * config->nx * config->dx );
+      ecl_region_select_in_interval( region , pressure , 210 , 230 );
+      ecl_region_deselect_in_interval( region , swat , 0.5 , 1.0 );
+      selected += int_vector_size( ecl_region_get_active_list( region ));
+    }
+    bench_timer_stop( bench , &timer , 10 * (long long) ecl_grid_get_global_size( grid ) , 0 , selected);
+
+    ecl_region_free( region );
+    ecl_file_close( rst_file );
+  }
+
+  ecl_grid_free( grid );
+}
+
+
+static void bench_gravity( bench_type * bench ) {
+  const bench_config_type * config = &bench->config;
+  bench_timer_type timer;
+  ecl_grid_type * grid = ecl_grid_alloc( bench->grid_file );
+  ecl_file_type * init_file = ecl_file_open( bench->init_file , 0 );
+  ecl_file_type * rst_file = ecl_file_open( bench->restart_file , 0 );
+  ecl_grav_type * grav;
+
+  bench_timer_start( &timer , "gravity_setup" );
+  grav = ecl_grav_alloc( grid , init_file );
+  ecl_grav_add_survey_RPORV( grav , "BASE" , ecl_file_get_restart_view( rst_file , -1 , 1 , -1 , -1 ));
+  ecl_grav_add_survey_RPORV( grav , "MONITOR" , ecl_file_get_restart_view( rst_file , -1 , config->report_steps , -1 , -1 ));
+  bench_timer_stop( bench , &timer , 2 , 0 , 0);
+
+  {
+    double sum = 0;
+    int s;
+    bench_timer_start( &timer , "gravity_eval" );
+    for (s = 0; s < config->num_stations; s++) {
+      double x = config->nx * config->dx * (s + 0.5) / config->num_stations;
+      double y = config->ny * config->dy * 0.5;
+      sum += ecl_grav_eval( grav , "BASE" , "MONITOR" , NULL , x , y , 0 , BENCH_PHASES );
+    }
+    bench_timer_stop( bench , &timer , (long long) config->num_stations * ecl_grid_get_nactive( grid ) , 0 , sum);
+  }
+
+  {
+    double * utm_x  = util_calloc( config->num_stations , sizeof * utm_x );
+    double * utm_y  = util_calloc( config->num_stations , sizeof * utm_y );
+    double * depth  = util_calloc( config->num_stations , sizeof * depth );
+    double * result = util_calloc( config->num_stations , sizeof * result );
+    double sum = 0;
+    int s;
+
+    for (s = 0; s < config->num_stations; s++) {
+      utm_x[s] = config->nx * config->dx * (s + 0.5) / config->num_stations;
+      utm_y[s] = config->ny * config->dy * 0.5;
+      depth[s] = 0;
+    }
+
+    /* The first call builds the tree, later calls reuse it. */
+    bench_timer_start( &timer , "gravity_tree_setup" );
+    ecl_grav_eval_list( grav , "BASE" , "MONITOR" , NULL , config->num_stations , utm_x , utm_y , depth , BENCH_PHASES , 0.5 , result );
+    bench_timer_stop( bench , &timer , ecl_grid_get_nactive( grid ) , 0 , 0);
+
+    bench_timer_start( &timer , "gravity_eval_tree" );
+    ecl_grav_eval_list( grav , "BASE" , "MONITOR" , NULL , config->num_stations , utm_x , utm_y , depth , BENCH_PHASES , 0.5 , result );
+    for (s = 0; s < config->num_stations; s++)
+      sum += result[s];
+    bench_timer_stop( bench , &timer , (long long) config->num_stations * ecl_grid_get_nactive( grid ) , 0 , sum);
+
+    free( result );
+    free( depth );
+    free( utm_y );
+    free( utm_x );
+  }
+
+  ecl_grav_free( grav );
+  ecl_file_close( rst_file );
+  ecl_file_close( init_file );
+  ecl_grid_free( grid );
+}
+
+
+/*****************************************************************/
+
+static void bench_fprintf_json( const bench_type * bench , FILE * stream ) {
+  const bench_config_type * config = &bench->config;
+  int i;
+
+  fprintf( stream , "{\"benchmark\": \"ecl_bench\",\n" );
+  fprintf( stream , " \"config\": {\"scale\": %d, \"nx\": %d, \"ny\": %d, \"nz\": %d, \"report_steps\": %d, \"wells\": %d, \"summary_tsteps\": %d, \"points\": %d, \"stations\": %d},\n",
+           config->scale , config->nx , config->ny , config->nz , config->report_steps , config->num_wells , config->sum_tsteps , config->num_points , config->num_stations );
+  fprintf( stream , " \"results\": [" );
+  for (i = 0; i < bench->num_results; i++) {
+    const bench_result_type * result = &bench->results[i];
+    double mb_per_s    = (result->seconds > 0) ? result->bytes / (result->seconds * 1024 * 1024) : 0;
+    double items_per_s = (result->seconds > 0) ? result->items / result->seconds : 0;
+
+    fprintf( stream , "%s\n  {\"name\": \"%s\", \"seconds\": %.6f, \"items\": %lld, \"items_per_s\": %.1f, \"bytes\": %lld, \"mb_per_s\": %.2f, \"bytes_read\": %lld, \"kw_read\": %lld, \"max_rss_kb\": %ld, \"checksum\": %.10g}",
+             (i == 0) ? "" : "," ,
+             result->name , result->seconds , result->items , items_per_s , result->bytes , mb_per_s ,
+             result->bytes_read , result->kw_read , result->max_rss_kb , result->checksum );
+  }
+  fprintf( stream , "\n ],\n \"perf\": " );
+  ecl_perf_fprintf_json( stream );
+  fprintf( stream , "}\n" );
+}
+
+
+static void usage( const char * prog ) {
+  fprintf(stderr , "Usage: %s [-s scale] [-d path] [-o output.json] [-k]\n\n" , prog);
+  fprintf(stderr , "   -s scale : size of the synthetic case, default 1.\n");
+  fprintf(stderr , "   -d path  : directory for the generated files, default 'ecl_bench'.\n");
+  fprintf(stderr , "   -o file  : write the JSON results to file instead of stdout.\n");
+  fprintf(stderr , "   -k       : keep the generated files; otherwise only the files generated by the\n");
+  fprintf(stderr , "              bench are removed, and the directory only if the bench created it.\n");
+  exit(1);
+}
+
+
+int main( int argc , char ** argv ) {
+  const char * path   = "ecl_bench";
+  const char * output = NULL;
+  bool keep  = false;
+  int  scale = 1;
+  int  iarg;
+
+  for (iarg = 1; iarg < argc; iarg++) {
+    if (strcmp( argv[iarg] , "-k" ) == 0)
+      keep = true;
+    else if (iarg + 1 < argc) {
+      if (strcmp( argv[iarg] , "-s" ) == 0) {
+        if (!util_sscanf_int( argv[iarg + 1] , &scale ) || (scale < 1))
+          usage( argv[0] );
+      } else if (strcmp( argv[iarg] , "-d" ) == 0)
+        path = argv[iarg + 1];
+      else if (strcmp( argv[iarg] , "-o" ) == 0)
+        output = argv[iarg + 1];
+      else
+        usage( argv[0] );
+      iarg++;
+    } else
+      usage( argv[0] );
+  }
+
+  ecl_perf_enable( true );
+  {
+    bench_type * bench = bench_alloc( path , scale );
+
+    bench_generate( bench );
+    ecl_perf_reset( );
+
+    bench_restart( bench );
+    bench_summary( bench );
+    bench_grid( bench );
+    bench_gravity( bench );
+
+    if (output) {
+      FILE * stream = util_mkdir_fopen( output , "w" );
+      bench_fprintf_json( bench , stream );
+      fclose( stream );
+    } else
+      bench_fprintf_json( bench , stdout );
+
+    if (!keep)
+      bench_remove_files( bench );
+    bench_free( bench );
+  }
+  exit(0);
+}
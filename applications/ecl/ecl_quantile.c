@@ -307,6 +307,18 @@ static void output_free__( void * arg) {
 }
 
 
+static int output_num_quantiles( const output_type * output , const char * sum_key) {
+  int num_quantiles = 0;
+  int i;
+  for (i = 0; i < vector_get_size( output->keys ); i++) {
+    const quant_key_type * qkey = vector_iget_const( output->keys , i );
+    if (util_string_equal( qkey->sum_key , sum_key ))
+      num_quantiles++;
+  }
+  return num_quantiles;
+}
+
+
 /**
   The @qkey input argument can contain wildcards in the summary key;
   i.e. to get 75% quantile of all wells starting with 'B' you can use
@@ -659,10 +671,20 @@ void output_run_line( const output_type * output , ensemble_type * ensemble) {
 
        the interp_data_cache construction will ensure that the
        underlying ecl_sum object is only queried once; and also the
-       sorting will be performed once.
+       sorting will be performed once. When only one quantile is
+       requested for a key the data is not sorted, instead the
+       quantile is found with selection.
     */
 
     hash_type * interp_data_cache = hash_alloc();
+    double_vector_type * select_scratch = double_vector_alloc( 0 , 0 );
+    int * num_quantiles = util_calloc( util_int_max( 1 , vector_get_size( output->keys )) , sizeof * num_quantiles );
+
+    for (column_nr = 0; column_nr < vector_get_size( output->keys ); column_nr++) {
+      const quant_key_type * qkey = vector_iget( output->keys , column_nr );
+      num_quantiles[column_nr] = output_num_quantiles( output , qkey->sum_key );
+    }
+
 
     for (row_nr = 0; row_nr < data_rows; row_nr++) {
       time_t interp_time = time_t_vector_iget( ensemble->interp_time , row_nr);
@@ -684,15 +706,22 @@ void output_run_line( const output_type * output , ensemble_type * ensemble) {
 
             if ((interp_time >= sum_case->start_time) && (interp_time <= sum_case->end_time))  /* We allow the different simulations to have differing length */
               double_vector_append( interp_data , ecl_sum_get_general_var_from_sim_time( sum_case->ecl_sum , interp_time , qkey->sum_key)) ;
+          }
 
+          if (num_quantiles[column_nr] > 1)
             double_vector_sort( interp_data );
-          }
         }
-        data[row_nr][column_nr] = statistics_empirical_quantile__( interp_data , qkey->quantile );
+
+        if (num_quantiles[column_nr] > 1)
+          data[row_nr][column_nr] = statistics_empirical_quantile__( interp_data , qkey->quantile );
+        else
+          data[row_nr][column_nr] = statistics_empirical_quantile_select( interp_data , qkey->quantile , select_scratch );
       }
       hash_apply( interp_data_cache , double_vector_reset__ );
     }
     hash_free( interp_data_cache );
+    double_vector_free( select_scratch );
+    free( num_quantiles );
   }
 
   output_save( output , ensemble , (const double **) data);
@@ -58,20 +58,23 @@ int main(int argc, char ** argv) {
     if (!ecl_util_fmt_file(src_file, &fmt_src))
       util_exit("Hmm - could not determine formatted/unformatted status for:%s \n",src_file);
     
-    fmt_target        = fmt_src;                         /* Can in principle be different */
+    fmt_target        = fmt_src;
     fortio_src        = fortio_open_reader(src_file     , fmt_src , ECL_ENDIAN_FLIP);
     fortio_target     = fortio_open_writer(target_file , fmt_target , ECL_ENDIAN_FLIP);
 
     {
       ecl_kw_type * ecl_kw = ecl_kw_alloc_empty();
       while (true) {
+        offset_type kw_start = fortio_ftell( fortio_src );
         if (ecl_kw_fread_header( ecl_kw , fortio_src ) == ECL_KW_READ_OK) {
           const char * header = ecl_kw_get_header( ecl_kw ); 
           if (set_has_key( kw_set , header )) {
-            ecl_kw_fread_realloc_data(ecl_kw , fortio_src );
-            ecl_kw_fwrite( ecl_kw , fortio_target );
-          } else
-            ecl_kw_fskip_data( ecl_kw , fortio_src );
+            /* Source and target have the same format; the keyword is copied without decoding. */
+            fortio_fseek( fortio_src , kw_start , SEEK_SET );
+            if (!ecl_kw_fcopy_raw( fortio_src , fortio_target ))
+              util_exit("Failed to copy keyword:%s to %s - truncated file? \n", header , target_file);
+          } else if (!ecl_kw_fskip_data( ecl_kw , fortio_src ))
+            util_exit("Failed to read keyword:%s from %s - truncated file? \n", header , src_file);
         } else 
           break; /* We have reached EOF */
       }
@@ -0,0 +1,789 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_cmp.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/util.h>
+#include <ert/util/vector.h>
+#include <ert/util/hash.h>
+#include <ert/util/str_hash.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/thread_pool.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/fortio_cache.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_kw_kernel.h>
+#include <ert/ecl/ecl_cmp.h>
+
+
+/**
+   The ecl_cmp_struct holds the tolerances and the list of results
+   from the latest comparison(s); results are appended until
+   ecl_cmp_clear() is called.
+
+   When comparing two files the keywords are paired by (name,
+   occurence), and the data is read directly from the files with one
+   fortio reader pair per thread; i.e. the ecl_file instances are only
+   used as an index, and keywords are not loaded into them. Keywords
+   which are already loaded are taken from memory. Small keywords are
+   spread over worker threads, whereas keywords with more than
+   ECL_KW_KERNEL_PARALLEL_SIZE elements are compared one at a time
+   with the threaded kernels.
+
+   Summary cases are compared vector by vector; when the two cases
+   have identical time axes the vectors are compared element by
+   element, otherwise the second case is interpolated to the time
+   steps of the first case in the common time range. The indices in
+   the summary results are time step indices in the first case.
+*/
+
+#define ECL_CMP_SUM_BATCH 256
+
+struct ecl_cmp_result_struct {
+  char                   * key;
+  int                      occurence;
+  ecl_cmp_status_enum      status;
+  int                      size;
+  int64_t                  num_diff;
+  int                      first_diff;
+  double                   max_abs_diff;
+  int                      max_abs_index;
+  double                   max_rel_diff;
+  int                      max_rel_index;
+
+  double                   abs_epsilon;
+  double                   rel_epsilon;
+  const ecl_file_kw_type * file_kw1;
+  const ecl_file_kw_type * file_kw2;
+};
+
+
+struct ecl_cmp_struct {
+  double         abs_epsilon;
+  double         rel_epsilon;
+  str_hash_type * tolerance;
+  str_hash_type * ignore;
+  vector_type   * results;
+};
+
+
+typedef struct {
+  double abs_epsilon;
+  double rel_epsilon;
+} ecl_cmp_tolerance_type;
+
+
+/*****************************************************************/
+
+static ecl_cmp_result_type * ecl_cmp_result_alloc( const char * key , int occurence , ecl_cmp_status_enum status , int size) {
+  ecl_cmp_result_type * result = util_malloc( sizeof * result );
+  result->key           = util_alloc_string_copy( key );
+  result->occurence     = occurence;
+  result->status        = status;
+  result->size          = size;
+  result->num_diff      = 0;
+  result->first_diff    = -1;
+  result->max_abs_diff  = 0;
+  result->max_abs_index = -1;
+  result->max_rel_diff  = 0;
+  result->max_rel_index = -1;
+  result->abs_epsilon   = 0;
+  result->rel_epsilon   = 0;
+  result->file_kw1      = NULL;
+  result->file_kw2      = NULL;
+  return result;
+}
+
+
+static void ecl_cmp_result_free( ecl_cmp_result_type * result ) {
+  free( result->key );
+  free( result );
+}
+
+
+static void ecl_cmp_result_free__( void * arg ) {
+  ecl_cmp_result_free( (ecl_cmp_result_type *) arg );
+}
+
+
+static void ecl_cmp_result_set_kernel( ecl_cmp_result_type * result , const ecl_kw_kernel_cmp_type * cmp , int index_offset) {
+  result->num_diff      = cmp->num_diff;
+  result->first_diff    = (cmp->first_diff < 0)    ? -1 : cmp->first_diff + index_offset;
+  result->max_abs_diff  = cmp->max_abs_diff;
+  result->max_abs_index = (cmp->max_abs_index < 0) ? -1 : cmp->max_abs_index + index_offset;
+  result->max_rel_diff  = cmp->max_rel_diff;
+  result->max_rel_index = (cmp->max_rel_index < 0) ? -1 : cmp->max_rel_index + index_offset;
+  result->status        = (cmp->num_diff > 0) ? ECL_CMP_DIFFERENT : ECL_CMP_EQUAL;
+}
+
+
+/*
+  Character, bool and message keywords are compared element by
+  element with memcmp(); the max deviations are not meaningful and
+  left at zero.
+*/
+
+static void ecl_cmp_result_cmp_kw( ecl_cmp_result_type * result , const ecl_kw_type * kw1 , const ecl_kw_type * kw2) {
+  ecl_data_type data_type = ecl_kw_get_data_type( kw1 );
+  int size = ecl_kw_get_size( kw1 );
+  ecl_kw_kernel_cmp_type cmp;
+
+  if (ecl_type_is_float( data_type ))
+    ecl_kw_kernel_cmp_float( ecl_kw_get_float_ptr( kw1 ) , ecl_kw_get_float_ptr( kw2 ) , size , result->abs_epsilon , result->rel_epsilon , &cmp );
+  else if (ecl_type_is_double( data_type ))
+    ecl_kw_kernel_cmp_double( ecl_kw_get_double_ptr( kw1 ) , ecl_kw_get_double_ptr( kw2 ) , size , result->abs_epsilon , result->rel_epsilon , &cmp );
+  else if (ecl_type_is_int( data_type ))
+    ecl_kw_kernel_cmp_int( ecl_kw_get_int_ptr( kw1 ) , ecl_kw_get_int_ptr( kw2 ) , size , result->abs_epsilon , result->rel_epsilon , &cmp );
+  else {
+    const char * data1 = ecl_kw_get_void_ptr( kw1 );
+    const char * data2 = ecl_kw_get_void_ptr( kw2 );
+    int sizeof_ctype = ecl_type_get_sizeof_ctype( data_type );
+    int i;
+
+    cmp.num_diff      = 0;
+    cmp.first_diff    = -1;
+    cmp.max_abs_diff  = 0;
+    cmp.max_abs_index = -1;
+    cmp.max_rel_diff  = 0;
+    cmp.max_rel_index = -1;
+    for (i = 0; i < size; i++) {
+      size_t offset = (size_t) i * sizeof_ctype;
+      if (memcmp( &data1[offset] , &data2[offset] , sizeof_ctype ) != 0) {
+        if (cmp.num_diff == 0)
+          cmp.first_diff = i;
+        cmp.num_diff++;
+      }
+    }
+  }
+
+  ecl_cmp_result_set_kernel( result , &cmp , 0 );
+}
+
+
+const char * ecl_cmp_result_get_key( const ecl_cmp_result_type * result ) {
+  return result->key;
+}
+
+int ecl_cmp_result_get_occurence( const ecl_cmp_result_type * result ) {
+  return result->occurence;
+}
+
+ecl_cmp_status_enum ecl_cmp_result_get_status( const ecl_cmp_result_type * result ) {
+  return result->status;
+}
+
+int ecl_cmp_result_get_size( const ecl_cmp_result_type * result ) {
+  return result->size;
+}
+
+int64_t ecl_cmp_result_get_num_different( const ecl_cmp_result_type * result ) {
+  return result->num_diff;
+}
+
+int ecl_cmp_result_get_first_different( const ecl_cmp_result_type * result ) {
+  return result->first_diff;
+}
+
+double ecl_cmp_result_get_max_abs_diff( const ecl_cmp_result_type * result ) {
+  return result->max_abs_diff;
+}
+
+int ecl_cmp_result_get_max_abs_index( const ecl_cmp_result_type * result ) {
+  return result->max_abs_index;
+}
+
+double ecl_cmp_result_get_max_rel_diff( const ecl_cmp_result_type * result ) {
+  return result->max_rel_diff;
+}
+
+int ecl_cmp_result_get_max_rel_index( const ecl_cmp_result_type * result ) {
+  return result->max_rel_index;
+}
+
+
+/*****************************************************************/
+
+ecl_cmp_type * ecl_cmp_alloc( double abs_epsilon , double rel_epsilon ) {
+  ecl_cmp_type * ecl_cmp = util_malloc( sizeof * ecl_cmp );
+  ecl_cmp->abs_epsilon = abs_epsilon;
+  ecl_cmp->rel_epsilon = rel_epsilon;
+  ecl_cmp->tolerance   = str_hash_alloc( );
+  ecl_cmp->ignore      = str_hash_alloc( );
+  ecl_cmp->results     = vector_alloc_new( );
+  return ecl_cmp;
+}
+
+
+void ecl_cmp_free( ecl_cmp_type * ecl_cmp ) {
+  str_hash_free( ecl_cmp->tolerance );
+  str_hash_free( ecl_cmp->ignore );
+  vector_free( ecl_cmp->results );
+  free( ecl_cmp );
+}
+
+
+void ecl_cmp_clear( ecl_cmp_type * ecl_cmp ) {
+  vector_clear( ecl_cmp->results );
+}
+
+
+/*
+  The key is either a keyword name like 'PRESSURE', a full summary key
+  like 'WOPR:OP_1' or a summary variable like 'WOPR' which will then
+  apply to all the summary keys of that variable.
+*/
+
+void ecl_cmp_add_tolerance( ecl_cmp_type * ecl_cmp , const char * key , double abs_epsilon , double rel_epsilon ) {
+  ecl_cmp_tolerance_type * tolerance = util_malloc( sizeof * tolerance );
+  tolerance->abs_epsilon = abs_epsilon;
+  tolerance->rel_epsilon = rel_epsilon;
+  str_hash_insert_owned_ref( ecl_cmp->tolerance , key , tolerance , free );
+}
+
+
+void ecl_cmp_add_ignore( ecl_cmp_type * ecl_cmp , const char * key ) {
+  str_hash_insert_ref( ecl_cmp->ignore , key , NULL );
+}
+
+
+static bool ecl_cmp_has_key( const str_hash_type * str_hash , const char * key ) {
+  if (str_hash_has_key( str_hash , key ))
+    return true;
+  else {
+    const char * sep = strchr( key , ':' );
+    if (sep) {
+      char * var = util_alloc_substring_copy( key , 0 , sep - key );
+      bool has_key = str_hash_has_key( str_hash , var );
+      free( var );
+      return has_key;
+    } else
+      return false;
+  }
+}
+
+
+static const ecl_cmp_tolerance_type * ecl_cmp_get_tolerance( const ecl_cmp_type * ecl_cmp , const char * key ) {
+  if (str_hash_has_key( ecl_cmp->tolerance , key ))
+    return str_hash_get( ecl_cmp->tolerance , key );
+  else {
+    const char * sep = strchr( key , ':' );
+    const ecl_cmp_tolerance_type * tolerance = NULL;
+    if (sep) {
+      char * var = util_alloc_substring_copy( key , 0 , sep - key );
+      if (str_hash_has_key( ecl_cmp->tolerance , var ))
+        tolerance = str_hash_get( ecl_cmp->tolerance , var );
+      free( var );
+    }
+    return tolerance;
+  }
+}
+
+
+static ecl_cmp_result_type * ecl_cmp_add_result( ecl_cmp_type * ecl_cmp , const char * key , int occurence , ecl_cmp_status_enum status , int size) {
+  ecl_cmp_result_type * result = ecl_cmp_result_alloc( key , occurence , status , size );
+  const ecl_cmp_tolerance_type * tolerance = ecl_cmp_get_tolerance( ecl_cmp , key );
+
+  if (tolerance) {
+    result->abs_epsilon = tolerance->abs_epsilon;
+    result->rel_epsilon = tolerance->rel_epsilon;
+  } else {
+    result->abs_epsilon = ecl_cmp->abs_epsilon;
+    result->rel_epsilon = ecl_cmp->rel_epsilon;
+  }
+
+  vector_append_owned_ref( ecl_cmp->results , result , ecl_cmp_result_free__ );
+  return result;
+}
+
+
+bool ecl_cmp_equal( const ecl_cmp_type * ecl_cmp ) {
+  return (ecl_cmp_get_num_different( ecl_cmp ) == 0);
+}
+
+
+int ecl_cmp_get_size( const ecl_cmp_type * ecl_cmp ) {
+  return vector_get_size( ecl_cmp->results );
+}
+
+
+int ecl_cmp_get_num_different( const ecl_cmp_type * ecl_cmp ) {
+  int num_different = 0;
+  int i;
+  for (i = 0; i < vector_get_size( ecl_cmp->results ); i++) {
+    const ecl_cmp_result_type * result = vector_iget_const( ecl_cmp->results , i );
+    if (result->status != ECL_CMP_EQUAL)
+      num_different++;
+  }
+  return num_different;
+}
+
+
+const ecl_cmp_result_type * ecl_cmp_iget_result( const ecl_cmp_type * ecl_cmp , int index ) {
+  return vector_iget_const( ecl_cmp->results , index );
+}
+
+
+const ecl_cmp_result_type * ecl_cmp_get_result( const ecl_cmp_type * ecl_cmp , const char * key , int occurence ) {
+  int i;
+  for (i = 0; i < vector_get_size( ecl_cmp->results ); i++) {
+    const ecl_cmp_result_type * result = vector_iget_const( ecl_cmp->results , i );
+    if ((result->occurence == occurence) && (strcmp( result->key , key ) == 0))
+      return result;
+  }
+  return NULL;
+}
+
+
+static const char * ecl_cmp_status_name( ecl_cmp_status_enum status ) {
+  switch (status) {
+  case ECL_CMP_EQUAL:
+    return "EQUAL";
+  case ECL_CMP_DIFFERENT:
+    return "DIFFERENT";
+  case ECL_CMP_TYPE_MISMATCH:
+    return "MISMATCH";
+  case ECL_CMP_MISSING_FIRST:
+    return "MISSING1";
+  case ECL_CMP_MISSING_SECOND:
+    return "MISSING2";
+  default:
+    util_abort("%s: unrecognized status:%d \n",__func__ , status);
+    return NULL;
+  }
+}
+
+
+void ecl_cmp_fprintf( const ecl_cmp_type * ecl_cmp , FILE * stream , bool only_different ) {
+  int i;
+  for (i = 0; i < vector_get_size( ecl_cmp->results ); i++) {
+    const ecl_cmp_result_type * result = vector_iget_const( ecl_cmp->results , i );
+    if (only_different && (result->status == ECL_CMP_EQUAL))
+      continue;
+
+    fprintf(stream , "%-24s %4d %-9s %9d" , result->key , result->occurence , ecl_cmp_status_name( result->status ) , result->size);
+    if (result->status == ECL_CMP_DIFFERENT)
+      fprintf(stream , "  num_diff:%-9" PRId64 " first:%-9d max_abs:%-12.6g @ %-9d max_rel:%-12.6g @ %d" ,
+              result->num_diff , result->first_diff ,
+              result->max_abs_diff , result->max_abs_index ,
+              result->max_rel_diff , result->max_rel_index);
+    fprintf(stream , "\n");
+  }
+}
+
+
+/*****************************************************************/
+/* Comparison of two files.                                      */
+
+/*
+  The keywords of an ecl_file spanning several files, see
+  ecl_file_open_restart_set(), are read through the fortio_cache of
+  the file instead.
+*/
+
+typedef struct {
+  fortio_type       * fortio1;
+  fortio_type       * fortio2;
+  fortio_cache_type * cache1;
+  fortio_cache_type * cache2;
+} ecl_cmp_reader_type;
+
+
+static fortio_type * ecl_cmp_open_fortio( const char * filename ) {
+  bool fmt_file;
+  fortio_type * fortio;
+
+  ecl_util_fmt_file( filename , &fmt_file );
+  fortio = fortio_open_reader( filename , fmt_file , ECL_ENDIAN_FLIP );
+  if (!fortio)
+    util_abort("%s: failed to open:%s \n",__func__ , filename);
+  return fortio;
+}
+
+
+static void ecl_cmp_reader_init( ecl_cmp_reader_type * reader , const char * file1 , fortio_cache_type * cache1 , const char * file2 , fortio_cache_type * cache2) {
+  reader->fortio1 = cache1 ? NULL : ecl_cmp_open_fortio( file1 );
+  reader->fortio2 = cache2 ? NULL : ecl_cmp_open_fortio( file2 );
+  reader->cache1  = cache1;
+  reader->cache2  = cache2;
+}
+
+
+static void ecl_cmp_reader_close( ecl_cmp_reader_type * reader ) {
+  if (reader->fortio1)
+    fortio_fclose( reader->fortio1 );
+  if (reader->fortio2)
+    fortio_fclose( reader->fortio2 );
+}
+
+
+static ecl_kw_type * ecl_cmp_load_kw( const ecl_file_kw_type * file_kw , fortio_type * fortio , fortio_cache_type * cache , bool * owner) {
+  if (ecl_file_kw_is_loaded( file_kw )) {
+    *owner = false;
+    return ecl_file_kw_get_kw_ptr( (ecl_file_kw_type *) file_kw );
+  } else {
+    int source = ecl_file_kw_get_source( file_kw );
+    ecl_kw_type * ecl_kw = NULL;
+
+    if (source >= 0)
+      fortio = fortio_cache_acquire( cache , source );
+
+    if (fortio) {
+      fortio_fseek( fortio , ecl_file_kw_get_offset( file_kw ) , SEEK_SET );
+      ecl_kw = ecl_kw_fread_alloc( fortio );
+      if (!ecl_kw)
+        util_abort("%s: failed to load keyword:%s from:%s \n",__func__ , ecl_file_kw_get_header( file_kw ) , fortio_filename_ref( fortio ));
+
+      if (source >= 0)
+        fortio_cache_release( cache , source );
+    } else
+      util_abort("%s: failed to open:%s \n",__func__ , fortio_cache_iget_filename( cache , source ));
+
+    *owner = true;
+    return ecl_kw;
+  }
+}
+
+
+static void ecl_cmp_result_cmp_file_kw( ecl_cmp_result_type * result , ecl_cmp_reader_type * reader ) {
+  bool owner1 , owner2;
+  ecl_kw_type * kw1 = ecl_cmp_load_kw( result->file_kw1 , reader->fortio1 , reader->cache1 , &owner1 );
+  ecl_kw_type * kw2 = ecl_cmp_load_kw( result->file_kw2 , reader->fortio2 , reader->cache2 , &owner2 );
+
+  ecl_cmp_result_cmp_kw( result , kw1 , kw2 );
+
+  if (owner1)
+    ecl_kw_free( kw1 );
+  if (owner2)
+    ecl_kw_free( kw2 );
+}
+
+
+typedef struct {
+  const char           * file1;
+  const char           * file2;
+  fortio_cache_type    * cache1;
+  fortio_cache_type    * cache2;
+  ecl_cmp_result_type ** results;
+} ecl_cmp_file_job_type;
+
+
+/* Every range opens its own readers. */
+
+static void ecl_cmp_file_range( void * arg , int begin , int end ) {
+  ecl_cmp_file_job_type * job = arg;
+  ecl_cmp_reader_type reader;
+  int i;
+
+  ecl_cmp_reader_init( &reader , job->file1 , job->cache1 , job->file2 , job->cache2 );
+  for (i = begin; i < end; i++)
+    ecl_cmp_result_cmp_file_kw( job->results[i] , &reader );
+  ecl_cmp_reader_close( &reader );
+}
+
+
+static void ecl_cmp_file_pair( ecl_cmp_type * ecl_cmp , ecl_file_view_type * view1 , ecl_file_view_type * view2 , vector_type * pairs) {
+  hash_type * occurence1 = hash_alloc( );
+  hash_type * occurence2 = hash_alloc( );
+  int i;
+
+  for (i = 0; i < ecl_file_view_get_size( view1 ); i++) {
+    const ecl_file_kw_type * file_kw1 = ecl_file_view_iget_file_kw( view1 , i );
+    const char * header = ecl_file_kw_get_header( file_kw1 );
+    int occurence = hash_has_key( occurence1 , header ) ? hash_get_int( occurence1 , header ) : 0;
+
+    hash_insert_int( occurence1 , header , occurence + 1 );
+    if (ecl_cmp_has_key( ecl_cmp->ignore , header ))
+      continue;
+
+    if (occurence < ecl_file_view_get_num_named_kw( view2 , header )) {
+      const ecl_file_kw_type * file_kw2 = ecl_file_view_iget_named_file_kw( view2 , header , occurence );
+      int size = ecl_file_kw_get_size( file_kw1 );
+
+      if ((size == ecl_file_kw_get_size( file_kw2 )) &&
+          ecl_type_is_equal( ecl_file_kw_get_data_type( file_kw1 ) , ecl_file_kw_get_data_type( file_kw2 ))) {
+        ecl_cmp_result_type * result = ecl_cmp_add_result( ecl_cmp , header , occurence , ECL_CMP_EQUAL , size );
+        result->file_kw1 = file_kw1;
+        result->file_kw2 = file_kw2;
+        vector_append_ref( pairs , result );
+      } else
+        ecl_cmp_add_result( ecl_cmp , header , occurence , ECL_CMP_TYPE_MISMATCH , size );
+    } else
+      ecl_cmp_add_result( ecl_cmp , header , occurence , ECL_CMP_MISSING_SECOND , ecl_file_kw_get_size( file_kw1 ));
+  }
+
+  for (i = 0; i < ecl_file_view_get_size( view2 ); i++) {
+    const ecl_file_kw_type * file_kw2 = ecl_file_view_iget_file_kw( view2 , i );
+    const char * header = ecl_file_kw_get_header( file_kw2 );
+    int occurence = hash_has_key( occurence2 , header ) ? hash_get_int( occurence2 , header ) : 0;
+
+    hash_insert_int( occurence2 , header , occurence + 1 );
+    if (ecl_cmp_has_key( ecl_cmp->ignore , header ))
+      continue;
+
+    if (occurence >= ecl_file_view_get_num_named_kw( view1 , header ))
+      ecl_cmp_add_result( ecl_cmp , header , occurence , ECL_CMP_MISSING_FIRST , ecl_file_kw_get_size( file_kw2 ));
+  }
+
+  hash_free( occurence1 );
+  hash_free( occurence2 );
+}
+
+
+/*
+  Compares all the keywords in the two files, the return value is
+  true if all keywords are present in both files and equal within
+  the tolerances. The results are appended to the ecl_cmp instance.
+*/
+
+bool ecl_cmp_files( ecl_cmp_type * ecl_cmp , ecl_file_type * file1 , ecl_file_type * file2 ) {
+  int num_results0 = vector_get_size( ecl_cmp->results );
+  vector_type * pairs = vector_alloc_new( );
+  const char * filename1 = ecl_file_get_src_file( file1 );
+  const char * filename2 = ecl_file_get_src_file( file2 );
+  fortio_cache_type * cache1 = ecl_file_view_get_cache( ecl_file_get_global_view( file1 ));
+  fortio_cache_type * cache2 = ecl_file_view_get_cache( ecl_file_get_global_view( file2 ));
+
+  ecl_cmp_file_pair( ecl_cmp , ecl_file_get_global_view( file1 ) , ecl_file_get_global_view( file2 ) , pairs );
+  {
+    int num_pairs = vector_get_size( pairs );
+    ecl_cmp_result_type ** small = util_calloc( util_int_max( 1 , num_pairs ) , sizeof * small );
+    ecl_cmp_result_type ** large = util_calloc( util_int_max( 1 , num_pairs ) , sizeof * large );
+    int num_small = 0;
+    int num_large = 0;
+    int i;
+
+    for (i = 0; i < num_pairs; i++) {
+      ecl_cmp_result_type * result = vector_iget( pairs , i );
+      if (result->size >= ECL_KW_KERNEL_PARALLEL_SIZE)
+        large[num_large++] = result;
+      else
+        small[num_small++] = result;
+    }
+
+    if (num_small > 0) {
+      ecl_cmp_file_job_type job = { .file1 = filename1 , .cache1 = cache1 , .file2 = filename2 , .cache2 = cache2 , .results = small };
+#ifdef ERT_HAVE_THREAD_POOL
+      thread_pool_run_range( ecl_cmp_file_range , &job , num_small , ecl_kw_kernel_get_num_threads() );
+#else
+      ecl_cmp_file_range( &job , 0 , num_small );
+#endif
+    }
+
+    if (num_large > 0) {
+      ecl_cmp_reader_type reader;
+      ecl_cmp_reader_init( &reader , filename1 , cache1 , filename2 , cache2 );
+      for (i = 0; i < num_large; i++)
+        ecl_cmp_result_cmp_file_kw( large[i] , &reader );
+      ecl_cmp_reader_close( &reader );
+    }
+
+    free( small );
+    free( large );
+  }
+  vector_free( pairs );
+
+  {
+    bool equal = true;
+    int i;
+    for (i = num_results0; i < vector_get_size( ecl_cmp->results ); i++) {
+      ecl_cmp_result_type * result = vector_iget( ecl_cmp->results , i );
+      result->file_kw1 = NULL;
+      result->file_kw2 = NULL;
+      if (result->status != ECL_CMP_EQUAL)
+        equal = false;
+    }
+    return equal;
+  }
+}
+
+
+/*****************************************************************/
+/* Comparison of two summary cases.                              */
+
+typedef struct {
+  ecl_cmp_result_type ** results;
+  const double         * values1;
+  const double         * values2;
+  int                    length;
+  int                    index_offset;
+} ecl_cmp_sum_job_type;
+
+
+static void ecl_cmp_sum_range( void * arg , int begin , int end ) {
+  ecl_cmp_sum_job_type * job = arg;
+  int ivec;
+
+  for (ivec = begin; ivec < end; ivec++) {
+    ecl_cmp_result_type * result = job->results[ivec];
+    ecl_kw_kernel_cmp_type cmp;
+    size_t offset = (size_t) ivec * job->length;
+
+    ecl_kw_kernel_cmp_double( &job->values1[offset] , &job->values2[offset] , job->length , result->abs_epsilon , result->rel_epsilon , &cmp );
+    ecl_cmp_result_set_kernel( result , &cmp , job->index_offset );
+  }
+}
+
+
+static void ecl_cmp_sum_batch( ecl_cmp_result_type ** results , int num_vectors , const double * values1 , const double * values2 , int length , int index_offset) {
+  ecl_cmp_sum_job_type job = { .results = results , .values1 = values1 , .values2 = values2 , .length = length , .index_offset = index_offset };
+#ifdef ERT_HAVE_THREAD_POOL
+  int num_threads = 1;
+  if ((int64_t) num_vectors * length >= ECL_KW_KERNEL_PARALLEL_SIZE / 16)
+    num_threads = ecl_kw_kernel_get_num_threads();
+
+  thread_pool_run_range( ecl_cmp_sum_range , &job , num_vectors , num_threads );
+#else
+  ecl_cmp_sum_range( &job , 0 , num_vectors );
+#endif
+}
+
+
+bool ecl_cmp_sum( ecl_cmp_type * ecl_cmp , const ecl_sum_type * sum1 , const ecl_sum_type * sum2 ) {
+  int num_results0 = vector_get_size( ecl_cmp->results );
+  stringlist_type * keys1 = ecl_sum_alloc_matching_general_var_list( sum1 , NULL );
+  stringlist_type * keys2 = ecl_sum_alloc_matching_general_var_list( sum2 , NULL );
+  stringlist_type * common_keys = stringlist_alloc_new( );
+  int length1 = ecl_sum_get_export_length( sum1 , false );
+  int length2 = ecl_sum_get_export_length( sum2 , false );
+  double * days1 = util_calloc( util_int_max( 1 , length1 ) , sizeof * days1 );
+  double * days2 = util_calloc( util_int_max( 1 , length2 ) , sizeof * days2 );
+  bool same_axis;
+  int index1 = 0;
+  int length = 0;
+
+  stringlist_sort( keys1 , NULL );
+  stringlist_sort( keys2 , NULL );
+  ecl_sum_export_days( sum1 , false , days1 );
+  ecl_sum_export_days( sum2 , false , days2 );
+  same_axis = (length1 == length2) && (memcmp( days1 , days2 , length1 * sizeof * days1 ) == 0);
+
+  if (same_axis)
+    length = length1;
+  else if ((length1 > 0) && (length2 > 0)) {
+    /* The time steps of the first case within the time span of the second case. */
+    while ((index1 < length1) && (days1[index1] < days2[0]))
+      index1++;
+    while ((index1 + length < length1) && (days1[index1 + length] <= days2[length2 - 1]))
+      length++;
+  }
+
+  {
+    int i;
+    for (i = 0; i < stringlist_get_size( keys1 ); i++) {
+      const char * key = stringlist_iget( keys1 , i );
+      if (ecl_cmp_has_key( ecl_cmp->ignore , key ))
+        continue;
+
+      if (!ecl_sum_has_general_var( sum2 , key ))
+        ecl_cmp_add_result( ecl_cmp , key , 0 , ECL_CMP_MISSING_SECOND , length1 );
+      else if (length == 0)
+        ecl_cmp_add_result( ecl_cmp , key , 0 , ECL_CMP_TYPE_MISMATCH , 0 );
+      else
+        stringlist_append_copy( common_keys , key );
+    }
+
+    for (i = 0; i < stringlist_get_size( keys2 ); i++) {
+      const char * key = stringlist_iget( keys2 , i );
+      if (ecl_cmp_has_key( ecl_cmp->ignore , key ))
+        continue;
+
+      if (!ecl_sum_has_general_var( sum1 , key ))
+        ecl_cmp_add_result( ecl_cmp , key , 0 , ECL_CMP_MISSING_FIRST , length2 );
+    }
+  }
+
+  if (stringlist_get_size( common_keys ) > 0) {
+    int batch_size = util_int_min( ECL_CMP_SUM_BATCH , stringlist_get_size( common_keys ));
+    ecl_cmp_result_type ** results = util_calloc( batch_size , sizeof * results );
+    double * values1 = util_calloc( (size_t) batch_size * length1 , sizeof * values1 );
+    double * values2 = util_calloc( (size_t) batch_size * util_int_max( length1 , length2 ) , sizeof * values2 );
+    stringlist_type * batch_keys = stringlist_alloc_new( );
+    double_vector_type * sim_days = double_vector_alloc( 0 , 0 );
+    double_vector_type * value = double_vector_alloc( 0 , 0 );
+    int offset;
+
+    if (!same_axis) {
+      int i;
+      for (i = 0; i < length; i++)
+        double_vector_iset( sim_days , i , days1[index1 + i] );
+    }
+
+    for (offset = 0; offset < stringlist_get_size( common_keys ); offset += batch_size) {
+      int num_vectors = util_int_min( batch_size , stringlist_get_size( common_keys ) - offset );
+      int ivec;
+
+      stringlist_clear( batch_keys );
+      for (ivec = 0; ivec < num_vectors; ivec++) {
+        const char * key = stringlist_iget( common_keys , offset + ivec );
+        stringlist_append_copy( batch_keys , key );
+        results[ivec] = ecl_cmp_add_result( ecl_cmp , key , 0 , ECL_CMP_EQUAL , length );
+      }
+
+      ecl_sum_export_vectors( sum1 , batch_keys , false , values1 );
+      if (same_axis) {
+        ecl_sum_export_vectors( sum2 , batch_keys , false , values2 );
+        ecl_cmp_sum_batch( results , num_vectors , values1 , values2 , length , 0 );
+      } else {
+        /* Pack the common time range of the first case, and interpolate the second case to it. */
+        for (ivec = 0; ivec < num_vectors; ivec++) {
+          memmove( &values1[(size_t) ivec * length] , &values1[(size_t) ivec * length1 + index1] , length * sizeof * values1 );
+          ecl_sum_resample_from_sim_days( sum2 , sim_days , value , stringlist_iget( batch_keys , ivec ));
+          memcpy( &values2[(size_t) ivec * length] , double_vector_get_const_ptr( value ) , length * sizeof * values2 );
+        }
+        ecl_cmp_sum_batch( results , num_vectors , values1 , values2 , length , index1 );
+      }
+    }
+
+    double_vector_free( sim_days );
+    double_vector_free( value );
+    stringlist_free( batch_keys );
+    free( values1 );
+    free( values2 );
+    free( results );
+  }
+
+  free( days1 );
+  free( days2 );
+  stringlist_free( common_keys );
+  stringlist_free( keys1 );
+  stringlist_free( keys2 );
+
+  {
+    bool equal = true;
+    int i;
+    for (i = num_results0; i < vector_get_size( ecl_cmp->results ); i++) {
+      const ecl_cmp_result_type * result = vector_iget_const( ecl_cmp->results , i );
+      if (result->status != ECL_CMP_EQUAL)
+        equal = false;
+    }
+    return equal;
+  }
+}
@@ -0,0 +1,680 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_convert.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/util.h>
+#include <ert/util/thread_pool.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_type.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_kw_kernel.h>
+#include <ert/ecl/ecl_convert.h>
+
+
+/*
+  The pipeline splits the source file into chunks of whole keywords
+  without decoding the keyword data; only the headers are decoded, and
+  then the extent of the data is found from the element count:
+
+   - In an unformatted file the data is a sequence of Fortran records
+     holding element count * element size bytes in total; the records
+     are copied without looking at their content.
+
+   - In a formatted file the elements are whitespace separated tokens,
+     or quoted strings for the character types; the tokens are counted
+     but not parsed. As in ecl_kw_fread_data() the character following
+     the last element - i.e. the newline - belongs to the keyword.
+
+  The worker threads read the keywords of a chunk with
+  ecl_kw_fread_alloc() from a memory stream over the chunk, and write
+  them with ecl_kw_fwrite() to another memory stream; that way the
+  output is exactly what the serial conversion produces.
+*/
+
+#define ECL_CONVERT_BUFFER_SIZE 65536
+
+typedef enum {
+  CONVERT_READ_OK    = 0,
+  CONVERT_READ_EOF   = 1,
+  CONVERT_READ_ERROR = 2
+} convert_read_status_enum;
+
+
+typedef struct {
+  char   * input;
+  size_t   input_size;
+  size_t   input_alloc;
+  int      num_kw;
+  char   * output;
+  size_t   output_size;
+  bool     convert_ok;
+  bool     done;
+} convert_chunk_type;
+
+
+typedef struct {
+  FILE   * stream;
+  bool     fmt_file;
+  char   * buffer;
+  size_t   buffer_pos;
+  size_t   buffer_len;
+} convert_reader_type;
+
+
+
+static void convert_chunk_reserve( convert_chunk_type * chunk , size_t extra ) {
+  if (chunk->input_size + extra > chunk->input_alloc) {
+    size_t new_alloc = util_size_t_max( 2 * chunk->input_alloc , chunk->input_size + extra );
+    chunk->input = util_realloc( chunk->input , new_alloc );
+    chunk->input_alloc = new_alloc;
+  }
+}
+
+
+static int convert_chunk_iget_int( const convert_chunk_type * chunk , size_t offset ) {
+  int value;
+  memcpy( &value , &chunk->input[offset] , sizeof value );
+  if (ECL_ENDIAN_FLIP)
+    util_endian_flip_vector( &value , sizeof value , 1 );
+  return value;
+}
+
+
+static void convert_chunk_free_data( convert_chunk_type * chunk ) {
+  free( chunk->input );
+  free( chunk->output );
+}
+
+
+/*****************************************************************/
+/* Reading unformatted keywords. */
+
+static size_t convert_reader_fread( convert_reader_type * reader , convert_chunk_type * chunk , size_t bytes ) {
+  size_t read_bytes;
+  convert_chunk_reserve( chunk , bytes );
+  read_bytes = fread( &chunk->input[ chunk->input_size ] , 1 , bytes , reader->stream );
+  chunk->input_size += read_bytes;
+  return read_bytes;
+}
+
+
+static bool convert_reader_fread_record( convert_reader_type * reader , convert_chunk_type * chunk , int * record_size) {
+  size_t record_start = chunk->input_size;
+  int head , tail;
+
+  if (convert_reader_fread( reader , chunk , sizeof head ) != sizeof head)
+    return false;
+
+  head = convert_chunk_iget_int( chunk , record_start );
+  if (head < 0)
+    return false;
+
+  if (convert_reader_fread( reader , chunk , head + sizeof tail ) != head + sizeof tail)
+    return false;
+
+  tail = convert_chunk_iget_int( chunk , record_start + sizeof head + head );
+  if (tail != head)
+    return false;
+
+  *record_size = head;
+  return true;
+}
+
+
+static convert_read_status_enum convert_reader_fread_unformatted_kw( convert_reader_type * reader , convert_chunk_type * chunk ) {
+  size_t header_start = chunk->input_size;
+  int record_size;
+
+  {
+    int c = fgetc( reader->stream );
+    if (c == EOF)
+      return CONVERT_READ_EOF;
+    ungetc( c , reader->stream );
+  }
+
+  if (!convert_reader_fread_record( reader , chunk , &record_size ))
+    return CONVERT_READ_ERROR;
+
+  if (record_size != ECL_STRING8_LENGTH + sizeof(int) + ECL_TYPE_LENGTH)
+    return CONVERT_READ_ERROR;
+
+  {
+    size_t data_offset = header_start + sizeof record_size;
+    char type_name[ECL_TYPE_LENGTH + 1];
+    int size = convert_chunk_iget_int( chunk , data_offset + ECL_STRING8_LENGTH );
+
+    memcpy( type_name , &chunk->input[ data_offset + ECL_STRING8_LENGTH + sizeof size ] , ECL_TYPE_LENGTH );
+    type_name[ECL_TYPE_LENGTH] = '\0';
+    if (size < 0)
+      return CONVERT_READ_ERROR;
+
+    {
+      ecl_data_type data_type = ecl_type_create_from_name( type_name );
+      int64_t data_bytes = (int64_t) size * ecl_type_get_sizeof_ctype_fortio( data_type );
+
+      while (data_bytes > 0) {
+        if (!convert_reader_fread_record( reader , chunk , &record_size ))
+          return CONVERT_READ_ERROR;
+
+        if ((record_size <= 0) || (record_size > data_bytes))
+          return CONVERT_READ_ERROR;
+
+        data_bytes -= record_size;
+      }
+    }
+  }
+  return CONVERT_READ_OK;
+}
+
+
+/*****************************************************************/
+/* Reading formatted keywords. */
+
+static int convert_reader_getc( convert_reader_type * reader , convert_chunk_type * chunk ) {
+  if (reader->buffer_pos == reader->buffer_len) {
+    reader->buffer_len = fread( reader->buffer , 1 , ECL_CONVERT_BUFFER_SIZE , reader->stream );
+    reader->buffer_pos = 0;
+    if (reader->buffer_len == 0)
+      return EOF;
+  }
+
+  {
+    char c = reader->buffer[ reader->buffer_pos ];
+    reader->buffer_pos++;
+
+    if (chunk->input_size == chunk->input_alloc)
+      convert_chunk_reserve( chunk , 1 );
+    chunk->input[ chunk->input_size ] = c;
+    chunk->input_size++;
+
+    return (unsigned char) c;
+  }
+}
+
+
+static int convert_reader_skip_space( convert_reader_type * reader , convert_chunk_type * chunk ) {
+  int c;
+  do {
+    c = convert_reader_getc( reader , chunk );
+  } while ((c != EOF) && isspace( c ));
+  return c;
+}
+
+
+/*
+  Reads the remaining characters of a quoted string where the opening
+  quote has already been read; if string is non NULL the content is
+  stored there, and it must hold exactly length characters.
+*/
+
+static bool convert_reader_read_qstring( convert_reader_type * reader , convert_chunk_type * chunk , char * string , int length) {
+  int count = 0;
+  while (true) {
+    int c = convert_reader_getc( reader , chunk );
+    if (c == EOF)
+      return false;
+
+    if (c == '\'')
+      break;
+
+    if (string) {
+      if (count == length)
+        return false;
+      string[count] = c;
+    }
+    count++;
+  }
+
+  if (string) {
+    if (count != length)
+      return false;
+    string[count] = '\0';
+  }
+  return true;
+}
+
+
+static convert_read_status_enum convert_reader_fread_formatted_kw( convert_reader_type * reader , convert_chunk_type * chunk ) {
+  char header[ECL_STRING8_LENGTH + 1];
+  char type_name[ECL_TYPE_LENGTH + 1];
+  int size;
+  int c;
+
+  c = convert_reader_skip_space( reader , chunk );
+  if (c == EOF)
+    return CONVERT_READ_EOF;
+
+  if (c != '\'')
+    return CONVERT_READ_ERROR;
+
+  if (!convert_reader_read_qstring( reader , chunk , header , ECL_STRING8_LENGTH ))
+    return CONVERT_READ_ERROR;
+
+  {
+    char size_string[32];
+    int length = 0;
+    c = convert_reader_skip_space( reader , chunk );
+    while ((c != EOF) && !isspace( c ) && (c != '\'')) {
+      if (length == sizeof size_string - 1)
+        return CONVERT_READ_ERROR;
+      size_string[length] = c;
+      length++;
+      c = convert_reader_getc( reader , chunk );
+    }
+    size_string[length] = '\0';
+
+    if (!util_sscanf_int( size_string , &size ) || (size < 0))
+      return CONVERT_READ_ERROR;
+  }
+
+  if (isspace( c ))
+    c = convert_reader_skip_space( reader , chunk );
+
+  if (c != '\'')
+    return CONVERT_READ_ERROR;
+
+  if (!convert_reader_read_qstring( reader , chunk , type_name , ECL_TYPE_LENGTH ))
+    return CONVERT_READ_ERROR;
+
+  /* The trailing newline of the header. */
+  c = convert_reader_getc( reader , chunk );
+
+  if (size > 0) {
+    ecl_data_type data_type = ecl_type_create_from_name( type_name );
+    bool quoted = ecl_type_is_char( data_type ) || ecl_type_is_string( data_type ) || ecl_type_is_mess( data_type );
+    int index;
+
+    if (c == EOF)
+      return CONVERT_READ_ERROR;
+
+    for (index = 0; index < size; index++) {
+      c = convert_reader_skip_space( reader , chunk );
+      if (c == EOF)
+        return CONVERT_READ_ERROR;
+
+      if (quoted) {
+        if (c != '\'')
+          return CONVERT_READ_ERROR;
+
+        if (!convert_reader_read_qstring( reader , chunk , NULL , 0 ))
+          return CONVERT_READ_ERROR;
+
+        /* The separator following the element. */
+        if (index == (size - 1))
+          convert_reader_getc( reader , chunk );
+      } else {
+        /* The element is terminated by - and includes - one whitespace character. */
+        do {
+          c = convert_reader_getc( reader , chunk );
+        } while ((c != EOF) && !isspace( c ));
+      }
+    }
+  }
+
+  return CONVERT_READ_OK;
+}
+
+
+/*****************************************************************/
+
+static convert_reader_type * convert_reader_fopen( const char * filename , bool fmt_file ) {
+  FILE * stream = fopen( filename , "rb" );
+  if (stream) {
+    convert_reader_type * reader = util_malloc( sizeof * reader );
+    reader->stream     = stream;
+    reader->fmt_file   = fmt_file;
+    reader->buffer     = fmt_file ? util_malloc( ECL_CONVERT_BUFFER_SIZE ) : NULL;
+    reader->buffer_pos = 0;
+    reader->buffer_len = 0;
+    return reader;
+  } else
+    return NULL;
+}
+
+
+static void convert_reader_fclose( convert_reader_type * reader ) {
+  fclose( reader->stream );
+  free( reader->buffer );
+  free( reader );
+}
+
+
+/*
+  Reads whole keywords into the chunk until it holds at least
+  ECL_CONVERT_CHUNK_SIZE bytes, or the file is exhausted. If reading a
+  keyword fails the partly read keyword is removed from the chunk,
+  which then holds the keywords preceding the failure.
+*/
+
+static convert_read_status_enum convert_reader_fill_chunk( convert_reader_type * reader , convert_chunk_type * chunk ) {
+  convert_read_status_enum status = CONVERT_READ_OK;
+
+  chunk->input_size = 0;
+  chunk->num_kw = 0;
+  while (chunk->input_size < ECL_CONVERT_CHUNK_SIZE) {
+    size_t kw_start = chunk->input_size;
+
+    if (reader->fmt_file)
+      status = convert_reader_fread_formatted_kw( reader , chunk );
+    else
+      status = convert_reader_fread_unformatted_kw( reader , chunk );
+
+    if (status != CONVERT_READ_OK) {
+      chunk->input_size = kw_start;
+      break;
+    }
+    chunk->num_kw++;
+  }
+  return status;
+}
+
+
+/*****************************************************************/
+
+static bool ecl_convert_file_serial( const char * src_file , bool fmt_src , const char * target_file ) {
+  bool convert_ok = true;
+  fortio_type * src    = fortio_open_reader( src_file , fmt_src , ECL_ENDIAN_FLIP );
+  fortio_type * target = fortio_open_writer( target_file , !fmt_src , ECL_ENDIAN_FLIP );
+
+  if (!src)
+    util_abort("%s: failed to open:%s for reading \n",__func__ , src_file);
+
+  if (!target)
+    util_abort("%s: failed to open:%s for writing \n",__func__ , target_file);
+
+  while (!fortio_read_at_eof( src )) {
+    ecl_kw_type * ecl_kw = ecl_kw_fread_alloc( src );
+    if (ecl_kw) {
+      ecl_kw_fwrite( ecl_kw , target );
+      ecl_kw_free( ecl_kw );
+    } else {
+      convert_ok = false;
+      break;
+    }
+  }
+
+  fortio_fclose( src );
+  fortio_fclose( target );
+  return convert_ok;
+}
+
+
+#if defined(ERT_HAVE_THREAD_POOL) && defined(HAVE_FMEMOPEN) && defined(HAVE_OPEN_MEMSTREAM)
+
+/*
+  The chunks form a ring buffer. The counters are shared between the
+  threads, and protected by the lock:
+
+    write_count <= convert_count <= read_count <= write_count + num_chunks
+
+  The reader fills chunk read_count and the workers take chunks from
+  convert_count; the chunks in [write_count, read_count) are owned by
+  the workers and the writer, and chunk write_count is written when it
+  has been marked as done.
+*/
+
+typedef struct {
+  const char          * src_file;
+  bool                  fmt_src;
+  convert_reader_type * reader;
+  convert_chunk_type  * chunks;
+  int                   num_chunks;
+
+  int                   read_count;
+  int                   convert_count;
+  int                   write_count;
+  bool                  read_complete;
+  bool                  read_ok;
+  bool                  write_ok;
+
+  pthread_mutex_t       lock;
+  pthread_cond_t        cond;
+} convert_pipeline_type;
+
+
+
+static void convert_chunk_convert( convert_chunk_type * chunk , const char * src_file , bool fmt_src ) {
+  FILE * input_stream  = fmemopen( chunk->input , chunk->input_size , "r" );
+  FILE * output_stream = open_memstream( &chunk->output , &chunk->output_size );
+
+  if (!input_stream || !output_stream)
+    util_abort("%s: failed to open memory stream \n",__func__);
+
+  chunk->convert_ok = true;
+  {
+    fortio_type * src    = fortio_alloc_FILE_wrapper( src_file , ECL_ENDIAN_FLIP , fmt_src , false , input_stream );
+    fortio_type * target = fortio_alloc_FILE_wrapper( NULL , ECL_ENDIAN_FLIP , !fmt_src , true , output_stream );
+    int ikw;
+
+    for (ikw = 0; ikw < chunk->num_kw; ikw++) {
+      ecl_kw_type * ecl_kw = ecl_kw_fread_alloc( src );
+      if (ecl_kw) {
+        ecl_kw_fwrite( ecl_kw , target );
+        ecl_kw_free( ecl_kw );
+      } else {
+        chunk->convert_ok = false;
+        break;
+      }
+    }
+
+    fortio_free_FILE_wrapper( src );
+    fortio_free_FILE_wrapper( target );
+  }
+  fclose( input_stream );
+  fclose( output_stream );
+}
+
+
+static void * convert_pipeline_read_main( void * arg ) {
+  convert_pipeline_type * pipeline = (convert_pipeline_type *) arg;
+  convert_read_status_enum status = CONVERT_READ_OK;
+
+  while (status == CONVERT_READ_OK) {
+    convert_chunk_type * chunk = &pipeline->chunks[ pipeline->read_count % pipeline->num_chunks ];
+
+    pthread_mutex_lock( &pipeline->lock );
+    while (pipeline->write_ok && (pipeline->read_count - pipeline->write_count == pipeline->num_chunks))
+      pthread_cond_wait( &pipeline->cond , &pipeline->lock );
+    {
+      bool write_ok = pipeline->write_ok;
+      pthread_mutex_unlock( &pipeline->lock );
+      if (!write_ok)
+        break;
+    }
+
+    status = convert_reader_fill_chunk( pipeline->reader , chunk );
+
+    pthread_mutex_lock( &pipeline->lock );
+    if (chunk->num_kw > 0)
+      pipeline->read_count++;
+    pthread_cond_broadcast( &pipeline->cond );
+    pthread_mutex_unlock( &pipeline->lock );
+  }
+
+  pthread_mutex_lock( &pipeline->lock );
+  pipeline->read_complete = true;
+  pipeline->read_ok = (status != CONVERT_READ_ERROR);
+  pthread_cond_broadcast( &pipeline->cond );
+  pthread_mutex_unlock( &pipeline->lock );
+  return NULL;
+}
+
+
+static void * convert_pipeline_convert_main( void * arg ) {
+  convert_pipeline_type * pipeline = (convert_pipeline_type *) arg;
+
+  while (true) {
+    convert_chunk_type * chunk;
+
+    pthread_mutex_lock( &pipeline->lock );
+    while (!pipeline->read_complete && (pipeline->convert_count == pipeline->read_count))
+      pthread_cond_wait( &pipeline->cond , &pipeline->lock );
+
+    if (pipeline->convert_count == pipeline->read_count) {
+      pthread_mutex_unlock( &pipeline->lock );
+      break;
+    }
+    chunk = &pipeline->chunks[ pipeline->convert_count % pipeline->num_chunks ];
+    pipeline->convert_count++;
+    pthread_mutex_unlock( &pipeline->lock );
+
+    convert_chunk_convert( chunk , pipeline->src_file , pipeline->fmt_src );
+
+    pthread_mutex_lock( &pipeline->lock );
+    chunk->done = true;
+    pthread_cond_broadcast( &pipeline->cond );
+    pthread_mutex_unlock( &pipeline->lock );
+  }
+  return NULL;
+}
+
+
+/*
+  The writer runs in the calling thread. After a failure the remaining
+  chunks are still taken off the ring - without being written - so
+  that the reader and the workers can complete.
+*/
+
+static void convert_pipeline_write( convert_pipeline_type * pipeline , FILE * target_stream ) {
+  bool write_ok = true;
+
+  while (true) {
+    convert_chunk_type * chunk;
+
+    pthread_mutex_lock( &pipeline->lock );
+    while (true) {
+      if (pipeline->write_count < pipeline->read_count) {
+        if (pipeline->chunks[ pipeline->write_count % pipeline->num_chunks ].done)
+          break;
+      } else if (pipeline->read_complete)
+        break;
+
+      pthread_cond_wait( &pipeline->cond , &pipeline->lock );
+    }
+
+    if (pipeline->write_count == pipeline->read_count) {
+      pthread_mutex_unlock( &pipeline->lock );
+      break;
+    }
+    chunk = &pipeline->chunks[ pipeline->write_count % pipeline->num_chunks ];
+    pthread_mutex_unlock( &pipeline->lock );
+
+    if (write_ok) {
+      if (fwrite( chunk->output , 1 , chunk->output_size , target_stream ) != chunk->output_size)
+        write_ok = false;
+
+      if (!chunk->convert_ok)
+        write_ok = false;
+    }
+    free( chunk->output );
+    chunk->output = NULL;
+    chunk->output_size = 0;
+
+    pthread_mutex_lock( &pipeline->lock );
+    chunk->done = false;
+    pipeline->write_count++;
+    pipeline->write_ok = write_ok;
+    pthread_cond_broadcast( &pipeline->cond );
+    pthread_mutex_unlock( &pipeline->lock );
+  }
+}
+
+
+static bool ecl_convert_file_pipeline( const char * src_file , bool fmt_src , const char * target_file , int num_threads ) {
+  convert_reader_type * reader = convert_reader_fopen( src_file , fmt_src );
+  fortio_type * target = fortio_open_writer( target_file , !fmt_src , ECL_ENDIAN_FLIP );
+  convert_pipeline_type pipeline;
+
+  if (!reader)
+    util_abort("%s: failed to open:%s for reading \n",__func__ , src_file);
+
+  if (!target)
+    util_abort("%s: failed to open:%s for writing \n",__func__ , target_file);
+
+  pipeline.src_file      = src_file;
+  pipeline.fmt_src       = fmt_src;
+  pipeline.reader        = reader;
+  pipeline.num_chunks    = ECL_CONVERT_CHUNKS_PER_THREAD * num_threads;
+  pipeline.chunks        = util_calloc( pipeline.num_chunks , sizeof * pipeline.chunks );
+  pipeline.read_count    = 0;
+  pipeline.convert_count = 0;
+  pipeline.write_count   = 0;
+  pipeline.read_complete = false;
+  pipeline.read_ok       = true;
+  pipeline.write_ok      = true;
+  pthread_mutex_init( &pipeline.lock , NULL );
+  pthread_cond_init( &pipeline.cond , NULL );
+
+  {
+    thread_pool_type * tp = thread_pool_alloc( num_threads + 1 , true );
+    int i;
+
+    thread_pool_add_job( tp , convert_pipeline_read_main , &pipeline );
+    for (i = 0; i < num_threads; i++)
+      thread_pool_add_job( tp , convert_pipeline_convert_main , &pipeline );
+
+    convert_pipeline_write( &pipeline , fortio_get_FILE( target ));
+
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+  }
+
+  {
+    int i;
+    for (i = 0; i < pipeline.num_chunks; i++)
+      convert_chunk_free_data( &pipeline.chunks[i] );
+  }
+  free( pipeline.chunks );
+  pthread_mutex_destroy( &pipeline.lock );
+  pthread_cond_destroy( &pipeline.cond );
+
+  convert_reader_fclose( reader );
+  fortio_fclose( target );
+  return pipeline.read_ok && pipeline.write_ok;
+}
+
+#endif
+
+
+bool ecl_convert_file( const char * src_file , bool fmt_src , const char * target_file , int num_threads ) {
+  if (num_threads <= 0)
+    num_threads = ecl_kw_kernel_get_num_threads();
+
+#if defined(ERT_HAVE_THREAD_POOL) && defined(HAVE_FMEMOPEN) && defined(HAVE_OPEN_MEMSTREAM)
+  if (num_threads > 1)
+    return ecl_convert_file_pipeline( src_file , fmt_src , target_file , num_threads );
+#endif
+
+  return ecl_convert_file_serial( src_file , fmt_src , target_file );
+}
@@ -0,0 +1,599 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_dir.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/util/ert_api_config.h>
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#ifdef ERT_HAVE_OPENDIR
+#include <sys/types.h>
+#include <dirent.h>
+#endif
+
+#include <ert/util/util.h>
+#include <ert/util/vector.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/perm_vector.h>
+#include <ert/util/str_hash.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_dir.h>
+
+
+/**
+   The ecl_dir_struct is a catalogue of the ECLIPSE files in one
+   directory. Finding the files of a case with ecl_util involves one
+   glob() for every combination of formatted / unformatted and unified
+   / non-unified storage, and one stat() for every other candidate
+   file; on a large directory on a network filesystem each of these
+   is expensive. The catalogue is built with one pass of readdir(),
+   after which all the questions can be answered from memory.
+
+   The shared catalogues, ecl_dir_alloc_shared(), are kept in a small
+   registry and revalidated against the modification time of the
+   directory. The mtime has only second resolution on many
+   filesystems, so a scan is only trusted if the directory had been
+   left alone for some time before the scan - otherwise a file created
+   in the same second as the scan could be missed. An untrusted
+   catalogue is rescanned the next time it is asked for.
+*/
+
+#define ECL_DIR_NUM_TYPES       10
+#define ECL_DIR_SHARED_SIZE     64
+#define ECL_DIR_SETTLE_TIME      2    /* Seconds. */
+
+
+struct ecl_dir_case_struct {
+  char             * base;
+  stringlist_type  * files[ECL_DIR_NUM_TYPES][2];         /* Indexed with [type][fmt_file]; allocated on demand. */
+  int_vector_type  * report_steps[ECL_DIR_NUM_TYPES][2];  /* Only for the non-unified restart and summary files. */
+};
+
+
+struct ecl_dir_struct {
+  char          * path;
+  str_hash_type * files;       /* All the recognized files, with path. */
+  str_hash_type * case_index;
+  vector_type   * cases;
+  time_t          mtime;
+  long            inode;
+  bool            trusted;     /* The mtime can be used to validate the scan. */
+  int             ref_count;
+};
+
+
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t ecl_dir_lock = PTHREAD_MUTEX_INITIALIZER;
+#define ECL_DIR_LOCK()   pthread_mutex_lock( &ecl_dir_lock )
+#define ECL_DIR_UNLOCK() pthread_mutex_unlock( &ecl_dir_lock )
+#else
+#define ECL_DIR_LOCK()
+#define ECL_DIR_UNLOCK()
+#endif
+
+/* The registry holds one reference to each of the shared catalogues, most recently used last. */
+static vector_type * shared_dirs = NULL;
+
+
+static int ecl_dir_type_index( ecl_file_enum file_type ) {
+  int index = 0;
+  int bit = 1;
+
+  while (index < ECL_DIR_NUM_TYPES) {
+    if (file_type == bit)
+      return index;
+    bit <<= 1;
+    index++;
+  }
+  util_abort("%s: invalid file type:%d \n",__func__ , file_type);
+  return -1;
+}
+
+
+static bool ecl_dir_step_type( ecl_file_enum file_type ) {
+  return ((file_type == ECL_RESTART_FILE) || (file_type == ECL_SUMMARY_FILE));
+}
+
+
+/* The formatted flag has no meaning for the DATA file; it is stored as formatted. */
+static int ecl_dir_fmt_index( ecl_file_enum file_type , bool fmt_file ) {
+  if (file_type == ECL_DATA_FILE)
+    return 1;
+  return fmt_file ? 1 : 0;
+}
+
+
+/*****************************************************************/
+
+static ecl_dir_case_type * ecl_dir_case_alloc( const char * base ) {
+  ecl_dir_case_type * dir_case = util_malloc( sizeof * dir_case );
+  int type , fmt;
+
+  dir_case->base = util_alloc_string_copy( base );
+  for (type = 0; type < ECL_DIR_NUM_TYPES; type++) {
+    for (fmt = 0; fmt < 2; fmt++) {
+      dir_case->files[type][fmt] = NULL;
+      dir_case->report_steps[type][fmt] = NULL;
+    }
+  }
+  return dir_case;
+}
+
+
+static void ecl_dir_case_free( ecl_dir_case_type * dir_case ) {
+  int type , fmt;
+  for (type = 0; type < ECL_DIR_NUM_TYPES; type++) {
+    for (fmt = 0; fmt < 2; fmt++) {
+      if (dir_case->files[type][fmt])
+        stringlist_free( dir_case->files[type][fmt] );
+      if (dir_case->report_steps[type][fmt])
+        int_vector_free( dir_case->report_steps[type][fmt] );
+    }
+  }
+  free( dir_case->base );
+  free( dir_case );
+}
+
+
+static void ecl_dir_case_free__( void * arg ) {
+  ecl_dir_case_free( (ecl_dir_case_type *) arg );
+}
+
+
+static void ecl_dir_case_add_file( ecl_dir_case_type * dir_case , ecl_file_enum file_type , bool fmt_file , int report_step , const char * filename) {
+  int type = ecl_dir_type_index( file_type );
+  int fmt = ecl_dir_fmt_index( file_type , fmt_file );
+
+  if (dir_case->files[type][fmt] == NULL)
+    dir_case->files[type][fmt] = stringlist_alloc_new( );
+  stringlist_append_copy( dir_case->files[type][fmt] , filename );
+
+  if (ecl_dir_step_type( file_type )) {
+    if (dir_case->report_steps[type][fmt] == NULL)
+      dir_case->report_steps[type][fmt] = int_vector_alloc( 0 , 0 );
+    int_vector_append( dir_case->report_steps[type][fmt] , report_step );
+  }
+}
+
+
+/*
+  The readdir() order is arbitrary; the report step files are sorted
+  on report step, like ecl_util_select_filelist() does.
+*/
+
+static void ecl_dir_case_sort( ecl_dir_case_type * dir_case ) {
+  int type , fmt;
+  for (type = 0; type < ECL_DIR_NUM_TYPES; type++) {
+    for (fmt = 0; fmt < 2; fmt++) {
+      int_vector_type * report_steps = dir_case->report_steps[type][fmt];
+      if (report_steps && !int_vector_is_sorted( report_steps , false )) {
+        stringlist_type * files = dir_case->files[type][fmt];
+        perm_vector_type * perm = int_vector_alloc_sort_perm( report_steps );
+        stringlist_type * sorted_files = stringlist_alloc_new( );
+        int_vector_type * sorted_steps = int_vector_alloc( 0 , 0 );
+        int i;
+
+        for (i = 0; i < stringlist_get_size( files ); i++) {
+          int index = perm_vector_iget( perm , i );
+          stringlist_append_copy( sorted_files , stringlist_iget( files , index ));
+          int_vector_append( sorted_steps , int_vector_iget( report_steps , index ));
+        }
+
+        stringlist_free( files );
+        int_vector_free( report_steps );
+        perm_vector_free( perm );
+        dir_case->files[type][fmt] = sorted_files;
+        dir_case->report_steps[type][fmt] = sorted_steps;
+      }
+    }
+  }
+}
+
+
+const char * ecl_dir_case_get_base( const ecl_dir_case_type * dir_case ) {
+  return dir_case->base;
+}
+
+
+int ecl_dir_case_get_num_files( const ecl_dir_case_type * dir_case , ecl_file_enum file_type , bool fmt_file ) {
+  const stringlist_type * files = dir_case->files[ ecl_dir_type_index( file_type ) ][ ecl_dir_fmt_index( file_type , fmt_file ) ];
+  if (files)
+    return stringlist_get_size( files );
+  else
+    return 0;
+}
+
+
+const char * ecl_dir_case_iget_file( const ecl_dir_case_type * dir_case , ecl_file_enum file_type , bool fmt_file , int index ) {
+  const stringlist_type * files = dir_case->files[ ecl_dir_type_index( file_type ) ][ ecl_dir_fmt_index( file_type , fmt_file ) ];
+  if (files == NULL)
+    util_abort("%s: no files of type:%s in case:%s \n",__func__ , ecl_util_file_type_name( file_type ) , dir_case->base);
+  return stringlist_iget( files , index );
+}
+
+
+/* Returns NULL if the case does not have the file. */
+const char * ecl_dir_case_get_file( const ecl_dir_case_type * dir_case , ecl_file_enum file_type , bool fmt_file ) {
+  if (ecl_dir_step_type( file_type ))
+    util_abort("%s: %s files come in a list - use ecl_dir_case_iget_file() \n",__func__ , ecl_util_file_type_name( file_type ));
+
+  if (ecl_dir_case_get_num_files( dir_case , file_type , fmt_file ) > 0)
+    return ecl_dir_case_iget_file( dir_case , file_type , fmt_file , 0 );
+  else
+    return NULL;
+}
+
+
+int ecl_dir_case_iget_report_step( const ecl_dir_case_type * dir_case , ecl_file_enum file_type , bool fmt_file , int index ) {
+  const int_vector_type * report_steps = dir_case->report_steps[ ecl_dir_type_index( file_type ) ][ ecl_dir_fmt_index( file_type , fmt_file ) ];
+  if (report_steps == NULL)
+    util_abort("%s: no report step files of type:%s in case:%s \n",__func__ , ecl_util_file_type_name( file_type ) , dir_case->base);
+  return int_vector_iget( report_steps , index );
+}
+
+
+/*****************************************************************/
+
+static bool ecl_dir_stat( const char * path , time_t * mtime , long * inode) {
+  stat_type stat_info;
+  if (util_stat( path ? path : "." , &stat_info ) == 0) {
+    *mtime = stat_info.st_mtime;
+    *inode = (long) stat_info.st_ino;
+    return true;
+  } else
+    return false;
+}
+
+
+static ecl_dir_case_type * ecl_dir_get_or_add_case( ecl_dir_type * ecl_dir , const char * base ) {
+  ecl_dir_case_type * dir_case = str_hash_safe_get( ecl_dir->case_index , base );
+  if (dir_case == NULL) {
+    dir_case = ecl_dir_case_alloc( base );
+    str_hash_insert_ref( ecl_dir->case_index , base , dir_case );
+    vector_append_owned_ref( ecl_dir->cases , dir_case , ecl_dir_case_free__ );
+  }
+  return dir_case;
+}
+
+
+/*
+  Only names which are exactly what ecl_util_alloc_filename() creates
+  are accepted; i.e. upper case extensions and four digit report
+  steps as in the glob patterns used by ecl_util_select_filelist().
+*/
+
+static void ecl_dir_add_entry( ecl_dir_type * ecl_dir , const char * name ) {
+  bool fmt_file;
+  int report_step;
+  ecl_file_enum file_type = ecl_util_get_file_type( name , &fmt_file , &report_step );
+
+  if (file_type != ECL_OTHER_FILE) {
+    const char * ext = strrchr( name , '.' );
+    if ((ext != name) && (!ecl_dir_step_type( file_type ) || (strlen( ext + 1 ) == 5))) {
+      char * base = util_alloc_substring_copy( name , 0 , ext - name );
+      char * ecl_name = ecl_util_alloc_filename( NULL , base , file_type , fmt_file , report_step );
+
+      if (strcmp( ecl_name , name ) == 0) {
+        char * filename = util_alloc_filename( ecl_dir->path , name , NULL );
+        ecl_dir_case_type * dir_case = ecl_dir_get_or_add_case( ecl_dir , base );
+
+        ecl_dir_case_add_file( dir_case , file_type , fmt_file , report_step , filename );
+        str_hash_insert_ref( ecl_dir->files , filename , NULL );
+        free( filename );
+      }
+      free( ecl_name );
+      free( base );
+    }
+  }
+}
+
+
+static bool ecl_dir_scan( ecl_dir_type * ecl_dir ) {
+#ifdef ERT_HAVE_OPENDIR
+  time_t scan_time = time( NULL );
+  time_t mtime;
+  long inode;
+
+  if (ecl_dir_stat( ecl_dir->path , &mtime , &inode )) {
+    DIR * dirH = opendir( ecl_dir->path ? ecl_dir->path : "." );
+    if (dirH) {
+      struct dirent * dp;
+      while ((dp = readdir( dirH )) != NULL) {
+        if (dp->d_name[0] != '.')
+          ecl_dir_add_entry( ecl_dir , dp->d_name );
+      }
+      closedir( dirH );
+
+      {
+        int i;
+        for (i = 0; i < vector_get_size( ecl_dir->cases ); i++)
+          ecl_dir_case_sort( vector_iget( ecl_dir->cases , i ));
+      }
+
+      ecl_dir->mtime = mtime;
+      ecl_dir->inode = inode;
+      ecl_dir->trusted = (scan_time - mtime) >= ECL_DIR_SETTLE_TIME;
+      return true;
+    }
+  }
+#endif
+  return false;
+}
+
+
+static void ecl_dir_free__( ecl_dir_type * ecl_dir ) {
+  str_hash_free( ecl_dir->files );
+  str_hash_free( ecl_dir->case_index );
+  vector_free( ecl_dir->cases );
+  util_safe_free( ecl_dir->path );
+  free( ecl_dir );
+}
+
+
+/**
+   Scans the directory @path, NULL means the current working
+   directory. Returns NULL if the directory can not be read; on
+   platforms without opendir() this is always the case.
+*/
+
+ecl_dir_type * ecl_dir_alloc( const char * path ) {
+  ecl_dir_type * ecl_dir = util_malloc( sizeof * ecl_dir );
+
+  ecl_dir->path       = util_alloc_string_copy( path );
+  ecl_dir->files      = str_hash_alloc( );
+  ecl_dir->case_index = str_hash_alloc( );
+  ecl_dir->cases      = vector_alloc_new( );
+  ecl_dir->mtime      = -1;
+  ecl_dir->inode      = -1;
+  ecl_dir->trusted    = false;
+  ecl_dir->ref_count  = 1;
+
+  if (ecl_dir_scan( ecl_dir ))
+    return ecl_dir;
+  else {
+    ecl_dir_free__( ecl_dir );
+    return NULL;
+  }
+}
+
+
+/*
+  Returns true if the directory is unchanged since the scan, as far
+  as the mtime can tell.
+*/
+
+bool ecl_dir_is_current( const ecl_dir_type * ecl_dir ) {
+  time_t mtime;
+  long inode;
+
+  if (!ecl_dir->trusted)
+    return false;
+
+  if (ecl_dir_stat( ecl_dir->path , &mtime , &inode ))
+    return ((mtime == ecl_dir->mtime) && (inode == ecl_dir->inode));
+  else
+    return false;
+}
+
+
+static bool ecl_dir_path_equal( const char * path1 , const char * path2 ) {
+  if (path1 == NULL || path2 == NULL)
+    return (path1 == path2);
+  else
+    return (strcmp( path1 , path2 ) == 0);
+}
+
+
+/* Must be called with the lock held; returns NULL if the path is not in the registry. */
+static ecl_dir_type * ecl_dir_shared_pop( const char * path ) {
+  if (shared_dirs) {
+    int i;
+    for (i = 0; i < vector_get_size( shared_dirs ); i++) {
+      ecl_dir_type * ecl_dir = vector_iget( shared_dirs , i );
+      if (ecl_dir_path_equal( ecl_dir->path , path )) {
+        vector_idel( shared_dirs , i );
+        return ecl_dir;
+      }
+    }
+  }
+  return NULL;
+}
+
+
+/* Must be called with the lock held; the registry takes over the reference. */
+static ecl_dir_type * ecl_dir_shared_push( ecl_dir_type * ecl_dir ) {
+  ecl_dir_type * evicted = NULL;
+
+  if (shared_dirs == NULL)
+    shared_dirs = vector_alloc_new( );
+
+  if (vector_get_size( shared_dirs ) == ECL_DIR_SHARED_SIZE) {
+    evicted = vector_iget( shared_dirs , 0 );
+    vector_idel( shared_dirs , 0 );
+  }
+  vector_append_ref( shared_dirs , ecl_dir );
+  return evicted;
+}
+
+
+/**
+   Returns a reference counted catalogue which is shared with all
+   other callers asking for the same path; the reference is released
+   with ecl_dir_free(). If the registry holds a catalogue of the
+   directory which is still current it is returned, otherwise the
+   directory is scanned. Returns NULL if the directory can not be
+   read.
+
+   The path is compared as a string; 'case/' and './case' are
+   different directories for the registry.
+*/
+
+ecl_dir_type * ecl_dir_alloc_shared( const char * path ) {
+  ecl_dir_type * ecl_dir = ecl_dir_alloc_shared_current( path );
+  if (ecl_dir == NULL) {
+    ecl_dir = ecl_dir_alloc( path );
+    if (ecl_dir) {
+      ecl_dir_type * old_dir;
+      ecl_dir_type * evicted;
+
+      ECL_DIR_LOCK();
+      {
+        old_dir = ecl_dir_shared_pop( path );
+        evicted = ecl_dir_shared_push( ecl_dir );
+        ecl_dir->ref_count++;
+      }
+      ECL_DIR_UNLOCK();
+
+      if (old_dir)
+        ecl_dir_free( old_dir );
+      if (evicted)
+        ecl_dir_free( evicted );
+    }
+  }
+  return ecl_dir;
+}
+
+
+/**
+   As ecl_dir_alloc_shared(), but never scans the directory; returns
+   NULL unless there is a current catalogue of the directory in the
+   registry. Used for the lookups where a scan would be more expensive
+   than checking the files directly.
+*/
+
+ecl_dir_type * ecl_dir_alloc_shared_current( const char * path ) {
+  ecl_dir_type * ecl_dir;
+
+  ECL_DIR_LOCK();
+  {
+    ecl_dir = ecl_dir_shared_pop( path );
+    if (ecl_dir) {
+      ecl_dir_shared_push( ecl_dir );   /* Can not evict; it was just removed. */
+      ecl_dir->ref_count++;
+    }
+  }
+  ECL_DIR_UNLOCK();
+
+  if (ecl_dir && !ecl_dir_is_current( ecl_dir )) {
+    ecl_dir_free( ecl_dir );
+    ecl_dir = NULL;
+  }
+
+  return ecl_dir;
+}
+
+
+/**
+   Releases one reference to the catalogue; the catalogue is freed
+   when the last reference is released.
+*/
+
+void ecl_dir_free( ecl_dir_type * ecl_dir ) {
+  bool free_dir;
+
+  ECL_DIR_LOCK();
+  {
+    ecl_dir->ref_count--;
+    free_dir = (ecl_dir->ref_count == 0);
+  }
+  ECL_DIR_UNLOCK();
+
+  if (free_dir)
+    ecl_dir_free__( ecl_dir );
+}
+
+
+/* Drops the registry references; catalogues still in use are freed when released. */
+void ecl_dir_shared_clear( void ) {
+  vector_type * dirs;
+
+  ECL_DIR_LOCK();
+  {
+    dirs = shared_dirs;
+    shared_dirs = NULL;
+  }
+  ECL_DIR_UNLOCK();
+
+  if (dirs) {
+    int i;
+    for (i = 0; i < vector_get_size( dirs ); i++)
+      ecl_dir_free( vector_iget( dirs , i ));
+    vector_free( dirs );
+  }
+}
+
+
+const char * ecl_dir_get_path( const ecl_dir_type * ecl_dir ) {
+  return ecl_dir->path;
+}
+
+
+/*
+  The filename must be given with the same path as the catalogue,
+  i.e. as created by ecl_util_alloc_filename(). Only recognized
+  ECLIPSE files are in the catalogue.
+*/
+
+bool ecl_dir_has_file( const ecl_dir_type * ecl_dir , const char * filename ) {
+  return str_hash_has_key( ecl_dir->files , filename );
+}
+
+
+int ecl_dir_get_num_cases( const ecl_dir_type * ecl_dir ) {
+  return vector_get_size( ecl_dir->cases );
+}
+
+
+const ecl_dir_case_type * ecl_dir_iget_case( const ecl_dir_type * ecl_dir , int index ) {
+  return vector_iget_const( ecl_dir->cases , index );
+}
+
+
+const ecl_dir_case_type * ecl_dir_get_case( const ecl_dir_type * ecl_dir , const char * base ) {
+  return str_hash_safe_get( ecl_dir->case_index , base );
+}
+
+
+/**
+   The equivalent of ecl_util_select_filelist() for one case: the
+   stringlist is cleared and filled with the files of type @file_type,
+   report step files are sorted on report step.
+*/
+
+int ecl_dir_select_files( const ecl_dir_type * ecl_dir , const char * base , ecl_file_enum file_type , bool fmt_file , stringlist_type * filelist ) {
+  const ecl_dir_case_type * dir_case = ecl_dir_get_case( ecl_dir , base );
+
+  stringlist_clear( filelist );
+  if (dir_case) {
+    int num_files = ecl_dir_case_get_num_files( dir_case , file_type , fmt_file );
+    int i;
+    for (i = 0; i < num_files; i++)
+      stringlist_append_copy( filelist , ecl_dir_case_iget_file( dir_case , file_type , fmt_file , i ));
+  }
+  return stringlist_get_size( filelist );
+}
@@ -22,14 +22,20 @@
 #include <errno.h>
 #include <time.h>
 
+#include <ert/util/ert_api_config.h>
+#include <ert/util/arena.h>
+#include <ert/util/str_intern.h>
 #include <ert/util/hash.h>
 #include <ert/util/util.h>
 #include <ert/util/vector.h>
 #include <ert/util/int_vector.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/thread_pool.h>
 
 #include <ert/ecl/fortio.h>
+#include <ert/ecl/fortio_cache.h>
 #include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_kernel.h>
 #include <ert/ecl/ecl_file.h>
 #include <ert/ecl/ecl_file_view.h>
 #include <ert/ecl/ecl_endian_flip.h>
@@ -37,6 +43,7 @@
 #include <ert/ecl/ecl_rsthead.h>
 #include <ert/ecl/ecl_file_kw.h>
 #include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_perf.h>
 
 /**
    This file implements functionality to load an ECLIPSE file in
@@ -138,6 +145,10 @@ struct ecl_file_struct {
   int             flags;
   vector_type   * map_stack;
   inv_map_type  * inv_view;
+  arena_type    * arena;            /* The ecl_file_kw instances of the global view are allocated here. */
+  str_intern_type * strings;        /* The keyword headers are interned here. */
+  fortio_cache_type * cache;        /* Only for ecl_file instances spanning several files, */
+  int_vector_type   * cache_ids;    /* see ecl_file_open_restart_set(); fortio is then NULL. */
 };
 
 
@@ -182,7 +193,11 @@ ecl_file_type * ecl_file_alloc_empty( int flags ) {
   UTIL_TYPE_ID_INIT(ecl_file , ECL_FILE_ID);
   ecl_file->map_stack = vector_alloc_new();
   ecl_file->inv_view  = inv_map_alloc( );
+  ecl_file->arena     = arena_alloc( 0 );
+  ecl_file->strings   = str_intern_alloc( );
   ecl_file->flags     = flags;
+  ecl_file->cache     = NULL;
+  ecl_file->cache_ids = NULL;
   return ecl_file;
 }
 
@@ -394,6 +409,8 @@ const char * ecl_file_iget_distinct_kw(const ecl_file_type * ecl_file, int index
 
 
 const char * ecl_file_get_src_file( const ecl_file_type * ecl_file ) {
+  if (ecl_file->cache_ids)
+    return ecl_file_view_get_src_file( ecl_file->global_view );
   return fortio_filename_ref( ecl_file->fortio );
 }
 
@@ -443,6 +460,10 @@ ecl_kw_type * ecl_file_iget_named_kw( const ecl_file_type * file , const char *
   return ecl_file_view_iget_named_kw( file->active_view , kw , ith);
 }
 
+ecl_kw_type * ecl_file_iget_named_pinned_kw( const ecl_file_type * file , const char * kw, int ith) {
+  return ecl_file_view_iget_named_pinned_kw( file->active_view , kw , ith);
+}
+
 void ecl_file_indexed_read(const ecl_file_type * file , const char * kw, int index, const int_vector_type * index_map, char* buffer) {
     ecl_file_view_index_fload_kw(file->active_view, kw, index, index_map, buffer);
 }
@@ -514,6 +535,7 @@ ecl_file_view_type * ecl_file_get_summary_view( ecl_file_type * ecl_file , int r
 
 static bool ecl_file_scan( ecl_file_type * ecl_file ) {
   bool scan_ok = false;
+  int64_t start = ECL_PERF_START();
   fortio_fseek( ecl_file->fortio , 0 , SEEK_SET );
   {
     ecl_kw_type * work_kw = ecl_kw_alloc_new("WORK-KW" , 0 , ECL_INT , NULL);
@@ -531,7 +553,7 @@ static bool ecl_file_scan( ecl_file_type * ecl_file ) {
           break;
 
         if (read_status == ECL_KW_READ_OK) {
-          ecl_file_kw_type * file_kw = ecl_file_kw_alloc( work_kw , current_offset);
+          ecl_file_kw_type * file_kw = ecl_file_kw_alloc_arena( ecl_file->arena , ecl_file->strings , work_kw , current_offset);
           if (ecl_file_kw_fskip_data( file_kw , ecl_file->fortio ))
             ecl_file_view_add_kw( ecl_file->global_view , file_kw );
           else
@@ -545,6 +567,7 @@ static bool ecl_file_scan( ecl_file_type * ecl_file ) {
   if (scan_ok)
     ecl_file_view_make_index( ecl_file->global_view );
 
+  ECL_PERF_TRACE( "ecl_file_scan" , fortio_filename_ref( ecl_file->fortio ) , start );
   return scan_ok;
 }
 
@@ -589,6 +612,7 @@ ecl_file_type * ecl_file_open( const char * filename , int flags) {
     ecl_file_type * ecl_file = ecl_file_alloc_empty( flags );
     ecl_file->fortio = fortio;
     ecl_file->global_view = ecl_file_view_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , true );
+    ecl_file_view_set_strings( ecl_file->global_view , ecl_file->strings );
 
     if (ecl_file_scan( ecl_file )) {
       ecl_file_select_global( ecl_file );
@@ -609,6 +633,248 @@ ecl_file_type * ecl_file_open( const char * filename , int flags) {
 
 
 
+/*****************************************************************/
+/* Non-unified restart files presented as one unified file.      */
+
+/*
+  A simulation with non-unified restart output leaves one file for
+  each report step; CASE.X0001, CASE.X0002, ... The function
+  ecl_file_open_restart_set() will open a set of such files as one
+  ecl_file instance which looks like a unified restart file: a SEQNUM
+  keyword with the report step - taken from the filename - is added in
+  front of the keywords of each file, so that the restart view
+  functions and the well loading for unified restart files work
+  unchanged.
+
+  Only the keyword headers are read when the set is opened, and the
+  headers of the different files are read in parallel. The files are
+  kept in the shared fortio_cache, i.e. the number of open files is
+  limited also when there are thousands of report steps; the keyword
+  data is loaded on demand as for an ordinary ecl_file. The set can
+  not be opened writable, and an index file can not be written for it.
+*/
+
+typedef struct {
+  char           header[ECL_STRING8_LENGTH + 1];
+  ecl_data_type  data_type;
+  int            size;
+  offset_type    offset;
+} ecl_file_header_type;
+
+
+typedef struct {
+  const char           * filename;
+  bool                   fmt_file;
+  int                    report_step;
+  fortio_type          * fortio;
+  ecl_file_header_type * headers;
+  int                    num_headers;
+  bool                   scan_ok;
+} ecl_file_member_type;
+
+
+static void ecl_file_member_scan( ecl_file_member_type * member ) {
+  int alloc_size = 0;
+
+  member->fortio = fortio_open_reader( member->filename , member->fmt_file , ECL_ENDIAN_FLIP );
+  if (!member->fortio)
+    return;
+
+  {
+    ecl_kw_type * work_kw = ecl_kw_alloc_new("WORK-KW" , 0 , ECL_INT , NULL);
+
+    while (true) {
+      if (fortio_read_at_eof( member->fortio )) {
+        member->scan_ok = true;
+        break;
+      }
+
+      {
+        offset_type current_offset = fortio_ftell( member->fortio );
+        ecl_read_status_enum read_status = ecl_kw_fread_header( work_kw , member->fortio );
+        if (read_status == ECL_KW_READ_FAIL)
+          break;
+
+        if (read_status == ECL_KW_READ_OK) {
+          ecl_file_header_type * header;
+
+          if (!ecl_kw_fskip_data__( ecl_kw_get_data_type( work_kw ) , ecl_kw_get_size( work_kw ) , member->fortio ))
+            break;
+
+          if (member->num_headers == alloc_size) {
+            alloc_size = 2 * alloc_size + 16;
+            member->headers = util_realloc( member->headers , alloc_size * sizeof * member->headers );
+          }
+
+          header = &member->headers[ member->num_headers ];
+          strncpy( header->header , ecl_kw_get_header( work_kw ) , ECL_STRING8_LENGTH );
+          header->header[ECL_STRING8_LENGTH] = '\0';
+          {
+            ecl_data_type data_type = ecl_kw_get_data_type( work_kw );
+            memcpy( &header->data_type , &data_type , sizeof data_type );
+          }
+          header->size      = ecl_kw_get_size( work_kw );
+          header->offset    = current_offset;
+          member->num_headers++;
+        }
+      }
+    }
+
+    ecl_kw_free( work_kw );
+  }
+  fortio_fclose_stream( member->fortio );
+}
+
+
+static void ecl_file_scan_range( void * arg , int begin , int end ) {
+  ecl_file_member_type * members = arg;
+  int i;
+  for (i = begin; i < end; i++)
+    ecl_file_member_scan( &members[i] );
+}
+
+
+static void ecl_file_scan_members( ecl_file_member_type * members , int num_members ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  thread_pool_run_range( ecl_file_scan_range , members , num_members , ecl_kw_kernel_get_num_threads() );
+#else
+  ecl_file_scan_range( members , 0 , num_members );
+#endif
+}
+
+
+static int ecl_file_member_cmp( const void * arg1 , const void * arg2 ) {
+  const ecl_file_member_type * member1 = arg1;
+  const ecl_file_member_type * member2 = arg2;
+  return member1->report_step - member2->report_step;
+}
+
+
+static void ecl_file_add_member( ecl_file_type * ecl_file , ecl_file_member_type * member ) {
+  int id = fortio_cache_add( ecl_file->cache , member->fortio );
+  int i;
+
+  member->fortio = NULL;
+  int_vector_append( ecl_file->cache_ids , id );
+
+  if ((member->num_headers == 0) || (strcmp( member->headers[0].header , SEQNUM_KW ) != 0)) {
+    ecl_kw_type * seqnum_kw = ecl_kw_alloc( SEQNUM_KW , 1 , ECL_INT );
+    ecl_kw_iset_int( seqnum_kw , 0 , member->report_step );
+    ecl_file_view_add_kw( ecl_file->global_view , ecl_file_kw_alloc_memory( ecl_file->arena , ecl_file->strings , seqnum_kw , ecl_file->inv_view , id ));
+  }
+
+  for (i = 0; i < member->num_headers; i++) {
+    const ecl_file_header_type * header = &member->headers[i];
+    ecl_file_kw_type * file_kw = ecl_file_kw_alloc_source( ecl_file->arena , ecl_file->strings ,
+                                                           header->header , header->data_type , header->size , header->offset , id );
+    ecl_file_view_add_kw( ecl_file->global_view , file_kw );
+  }
+}
+
+
+/*
+  Will open the non-unified restart files in @restart_files as one
+  unified restart file; the files are ordered by report step. All the
+  files must be non-unified restart files with a report step in the
+  name, and a report step can only be present once. Will return NULL
+  if these conditions are not met, or if one of the files can not be
+  read.
+*/
+
+ecl_file_type * ecl_file_open_restart_set( const stringlist_type * restart_files , int flags ) {
+  int num_files = stringlist_get_size( restart_files );
+  ecl_file_member_type * members = util_calloc( util_int_max( 1 , num_files ) , sizeof * members );
+  ecl_file_type * ecl_file = NULL;
+  bool valid = (num_files > 0);
+  int i;
+
+  if (ecl_file_view_check_flags( flags , ECL_FILE_WRITABLE ))
+    util_abort("%s: a set of restart files can not be opened writable.\n",__func__);
+
+  for (i = 0; i < num_files; i++) {
+    ecl_file_member_type * member = &members[i];
+    member->filename    = stringlist_iget( restart_files , i );
+    member->fortio      = NULL;
+    member->headers     = NULL;
+    member->num_headers = 0;
+    member->scan_ok     = false;
+    if (ecl_util_get_file_type( member->filename , &member->fmt_file , &member->report_step ) != ECL_RESTART_FILE)
+      valid = false;
+  }
+
+  if (valid) {
+    qsort( members , num_files , sizeof * members , ecl_file_member_cmp );
+    for (i = 1; i < num_files; i++)
+      if (members[i].report_step == members[i - 1].report_step)
+        valid = false;
+  }
+
+  if (valid) {
+    int64_t start = ECL_PERF_START();
+    ecl_file_scan_members( members , num_files );
+    for (i = 0; i < num_files; i++)
+      if (!members[i].scan_ok)
+        valid = false;
+    ECL_PERF_TRACE( "ecl_file_open_restart_set" , members[0].filename , start );
+  }
+
+  if (valid) {
+    ecl_file = ecl_file_alloc_empty( flags );
+    ecl_file->fortio      = NULL;
+    ecl_file->cache       = fortio_cache_get_shared( );
+    ecl_file->cache_ids   = int_vector_alloc( 0 , 0 );
+    ecl_file->global_view = ecl_file_view_alloc( NULL , &ecl_file->flags , ecl_file->inv_view , true );
+    ecl_file_view_set_strings( ecl_file->global_view , ecl_file->strings );
+    ecl_file_view_set_cache( ecl_file->global_view , ecl_file->cache );
+
+    for (i = 0; i < num_files; i++)
+      ecl_file_add_member( ecl_file , &members[i] );
+
+    ecl_file_view_make_index( ecl_file->global_view );
+    ecl_file_select_global( ecl_file );
+  }
+
+  for (i = 0; i < num_files; i++) {
+    if (members[i].fortio)
+      fortio_fclose( members[i].fortio );
+    free( members[i].headers );
+  }
+  free( members );
+
+  return ecl_file;
+}
+
+
+/*
+  Opens the restart files of the case @base in directory @path, see
+  ecl_util_alloc_restart_files(); a unified restart file is opened
+  with ecl_file_open() and a list of non-unified files with
+  ecl_file_open_restart_set(). Will return NULL if the case has no
+  restart files.
+*/
+
+ecl_file_type * ecl_file_open_restart_case( const char * path , const char * base , int flags ) {
+  ecl_file_type * ecl_file = NULL;
+  char ** restart_files;
+  int num_files;
+  bool fmt_file , unified;
+
+  ecl_util_alloc_restart_files( path , base , &restart_files , &num_files , &fmt_file , &unified );
+  if (num_files > 0) {
+    if (unified)
+      ecl_file = ecl_file_open( restart_files[0] , flags );
+    else {
+      stringlist_type * file_list = stringlist_alloc_argv_ref( (const char **) restart_files , num_files );
+      ecl_file = ecl_file_open_restart_set( file_list , flags );
+      stringlist_free( file_list );
+    }
+  }
+  util_free_stringlist( restart_files , num_files );
+  return ecl_file;
+}
+
+
+
 int ecl_file_get_flags( const ecl_file_type * ecl_file ) {
   return ecl_file->flags;
 }
@@ -637,15 +903,31 @@ bool ecl_file_writable( const ecl_file_type * ecl_file ) {
    the ecl_kw instances which have been loaded on demand.
 */
 
+static void ecl_file_remove_cache_ids( ecl_file_type * ecl_file ) {
+  if (ecl_file->cache_ids) {
+    int i;
+    for (i = 0; i < int_vector_size( ecl_file->cache_ids ); i++)
+      fortio_cache_remove( ecl_file->cache , int_vector_iget( ecl_file->cache_ids , i ));
+
+    int_vector_free( ecl_file->cache_ids );
+    ecl_file->cache_ids = NULL;
+  }
+}
+
+
 void ecl_file_close(ecl_file_type * ecl_file) {
   if (ecl_file->fortio != NULL)
     fortio_fclose( ecl_file->fortio  );
 
+  ecl_file_remove_cache_ids( ecl_file );
+
   if (ecl_file->global_view)
     ecl_file_view_free( ecl_file->global_view );
 
   inv_map_free( ecl_file->inv_view );
   vector_free( ecl_file->map_stack );
+  arena_free( ecl_file->arena );
+  str_intern_free( ecl_file->strings );
   free( ecl_file );
 }
 
@@ -668,8 +950,10 @@ void ecl_file_close_fortio_stream(ecl_file_type * ecl_file) {
 
 
 void ecl_file_fortio_detach( ecl_file_type * ecl_file ) {
-  fortio_fclose( ecl_file->fortio );
+  if (ecl_file->fortio)
+    fortio_fclose( ecl_file->fortio );
   ecl_file->fortio = NULL;
+  ecl_file_remove_cache_ids( ecl_file );
 }
 
 
@@ -864,7 +1148,10 @@ bool ecl_file_has_kw_ptr( const ecl_file_type * ecl_file , const ecl_kw_type * e
 bool ecl_file_save_kw( const ecl_file_type * ecl_file , const ecl_kw_type * ecl_kw) {
   ecl_file_kw_type * file_kw = inv_map_get_file_kw( ecl_file->inv_view , ecl_kw );  // We just verify that the input ecl_kw points to an ecl_kw
   if (file_kw != NULL) {                                                             // we manage; from then on we use the reference contained in
-    if (fortio_assert_stream_open( ecl_file->fortio )) {                             // the corresponding ecl_file_kw instance.
+    if (ecl_file->fortio == NULL)                                                    // the corresponding ecl_file_kw instance.
+      return false;
+
+    if (fortio_assert_stream_open( ecl_file->fortio )) {
 
       ecl_file_kw_inplace_fwrite( file_kw , ecl_file->fortio );
 
@@ -1041,7 +1328,12 @@ bool ecl_file_index_valid(const char * file_name, const char * index_file_name)
 
 
 bool  ecl_file_write_index( const ecl_file_type * ecl_file , const char * index_filename) {
-  FILE * ostream = fopen(index_filename, "wb");
+  FILE * ostream;
+
+  if (ecl_file->fortio == NULL)   /* The index format can only describe one file. */
+    return false;
+
+  ostream = fopen(index_filename, "wb");
   if (!ostream)
     return false;
   {
@@ -1070,7 +1362,7 @@ ecl_file_type * ecl_file_fast_open(const char * file_name, const char * index_fi
     if (fortio) {
       ecl_file = ecl_file_alloc_empty( flags );
       ecl_file->fortio = fortio;
-      ecl_file->global_view = ecl_file_view_fread_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , istream );
+      ecl_file->global_view = ecl_file_view_fread_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , ecl_file->arena , ecl_file->strings , istream );
       if (ecl_file->global_view) {
         ecl_file_select_global( ecl_file );
         if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_CLOSE_STREAM))
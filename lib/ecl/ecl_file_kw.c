@@ -23,11 +23,14 @@
 
 #include <ert/util/size_t_vector.h>
 #include <ert/util/util.h>
+#include <ert/util/arena.h>
+#include <ert/util/str_intern.h>
 
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file_kw.h>
 #include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_perf.h>
 
 /*
   This file implements the datatype ecl_file_kw which is used to hold
@@ -62,6 +65,9 @@ struct ecl_file_kw_struct {
   int              ref_count;
   char           * header;
   ecl_kw_type    * kw;
+  bool             arena_owned;
+  bool             header_interned;   /* The header is owned by a str_intern table. */
+  int              source;            /* Id in the fortio_cache of the ecl_file, or -1 for the file of the ecl_file itself. */
 };
 
 
@@ -136,20 +142,38 @@ UTIL_IS_INSTANCE_FUNCTION( ecl_file_kw , ECL_FILE_KW_TYPE_ID )
 
 
 
-ecl_file_kw_type * ecl_file_kw_alloc0( const char * header , ecl_data_type data_type , int size , offset_type offset) {
-  ecl_file_kw_type * file_kw = util_malloc( sizeof * file_kw );
+static ecl_file_kw_type * ecl_file_kw_alloc__( arena_type * arena , str_intern_type * strings , const char * header , ecl_data_type data_type , int size , offset_type offset) {
+  ecl_file_kw_type * file_kw;
+  if (arena)
+    file_kw = arena_malloc( arena , sizeof * file_kw );
+  else
+    file_kw = util_malloc( sizeof * file_kw );
+
+  if (strings)
+    file_kw->header = (char *) str_intern_add( strings , header );
+  else if (arena)
+    file_kw->header = arena_alloc_string_copy( arena , header );
+  else
+    file_kw->header = util_alloc_string_copy( header );
   UTIL_TYPE_ID_INIT( file_kw , ECL_FILE_KW_TYPE_ID );
 
-  file_kw->header = util_alloc_string_copy( header );
   memcpy(&file_kw->data_type, &data_type, sizeof data_type);
   file_kw->kw_size = size;
   file_kw->file_offset = offset;
   file_kw->ref_count = 0;
   file_kw->kw = NULL;
+  file_kw->arena_owned = (arena != NULL);
+  file_kw->header_interned = (strings != NULL);
+  file_kw->source = -1;
 
   return file_kw;
 }
 
+
+ecl_file_kw_type * ecl_file_kw_alloc0( const char * header , ecl_data_type data_type , int size , offset_type offset) {
+  return ecl_file_kw_alloc__( NULL , NULL , header , data_type , size , offset );
+}
+
 /**
    Create a new ecl_file_kw instance based on header information from
    the input keyword. Typically only the header has been loaded from
@@ -167,11 +191,56 @@ ecl_file_kw_type * ecl_file_kw_alloc( const ecl_kw_type * ecl_kw , offset_type o
 }
 
 
+/*
+  As ecl_file_kw_alloc(), but the ecl_file_kw instance is allocated
+  from the arena, and the header is interned in the strings table, so
+  that the headers of all the keywords with the same name share one
+  pointer. Both the arena and the strings argument can be NULL.
+*/
+
+ecl_file_kw_type * ecl_file_kw_alloc_arena( arena_type * arena , str_intern_type * strings , const ecl_kw_type * ecl_kw , offset_type offset ) {
+  return ecl_file_kw_alloc__( arena , strings , ecl_kw_get_header( ecl_kw ) , ecl_kw_get_data_type( ecl_kw ) , ecl_kw_get_size( ecl_kw ) , offset );
+}
+
+
+/*
+  For ecl_file instances spanning several files: the keyword is found
+  at @offset in the file with id @source in the fortio_cache of the
+  ecl_file.
+*/
+
+ecl_file_kw_type * ecl_file_kw_alloc_source( arena_type * arena , str_intern_type * strings , const char * header , ecl_data_type data_type , int size , offset_type offset , int source) {
+  ecl_file_kw_type * file_kw = ecl_file_kw_alloc__( arena , strings , header , data_type , size , offset );
+  file_kw->source = source;
+  return file_kw;
+}
+
+
+/*
+  A keyword which only exists in memory, e.g. the SEQNUM keywords
+  which are added when non-unified restart files are presented as one
+  unified file. The file_kw takes ownership of @ecl_kw, which is never
+  dropped or reloaded; @source is only used to identify the file the
+  keyword belongs to.
+*/
+
+ecl_file_kw_type * ecl_file_kw_alloc_memory( arena_type * arena , str_intern_type * strings , ecl_kw_type * ecl_kw , inv_map_type * inv_map , int source) {
+  ecl_file_kw_type * file_kw = ecl_file_kw_alloc__( arena , strings , ecl_kw_get_header( ecl_kw ) , ecl_kw_get_data_type( ecl_kw ) , ecl_kw_get_size( ecl_kw ) , -1 );
+  file_kw->source = source;
+  file_kw->kw = ecl_kw;
+  file_kw->ref_count = 1;
+  inv_map_add_kw( inv_map , file_kw , ecl_kw );
+  return file_kw;
+}
+
+
 /**
     Does NOT copy the kw pointer which must be reloaded.
 */
 ecl_file_kw_type * ecl_file_kw_alloc_copy( const ecl_file_kw_type * src ) {
-  return ecl_file_kw_alloc0( src->header , ecl_file_kw_get_data_type(src) , src->kw_size , src->file_offset );
+  ecl_file_kw_type * file_kw = ecl_file_kw_alloc0( src->header , ecl_file_kw_get_data_type(src) , src->kw_size , src->file_offset );
+  file_kw->source = src->source;
+  return file_kw;
 }
 
 
@@ -182,8 +251,11 @@ void ecl_file_kw_free( ecl_file_kw_type * file_kw ) {
     ecl_kw_free( file_kw->kw );
     file_kw->kw = NULL;
   }
-  free( file_kw->header );
-  free( file_kw );
+  if (!file_kw->arena_owned) {
+    if (!file_kw->header_interned)
+      free( file_kw->header );
+    free( file_kw );
+  }
 }
 
 
@@ -256,6 +328,7 @@ ecl_kw_type * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw) {
   if (file_kw->ref_count == 0)
     return NULL;
 
+  ECL_PERF_ADD( ECL_PERF_CACHE_HIT , 1 );
   file_kw->ref_count++;
   return file_kw->kw;
 }
@@ -276,8 +349,11 @@ ecl_kw_type * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw) {
 
 
 ecl_kw_type * ecl_file_kw_get_kw( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map ) {
-  if (file_kw->ref_count == 0)
+  if (file_kw->ref_count == 0) {
+    ECL_PERF_ADD( ECL_PERF_CACHE_MISS , 1 );
     ecl_file_kw_load_kw( file_kw , fortio , inv_map);
+  } else
+    ECL_PERF_ADD( ECL_PERF_CACHE_HIT , 1 );
 
   if(file_kw->kw)
     file_kw->ref_count++;
@@ -286,6 +362,24 @@ ecl_kw_type * ecl_file_kw_get_kw( ecl_file_kw_type * file_kw , fortio_type * for
 }
 
 
+/*
+  Returns true if the keyword has been loaded into memory; the in
+  memory copy may have been modified and can differ from the file.
+*/
+
+bool ecl_file_kw_is_loaded( const ecl_file_kw_type * file_kw ) {
+  return (file_kw->kw != NULL);
+}
+
+
+bool ecl_file_kw_is_pinned( const ecl_file_kw_type * file_kw ) {
+  if (file_kw->kw)
+    return ecl_kw_is_pinned( file_kw->kw );
+  else
+    return false;
+}
+
+
 bool ecl_file_kw_ptr_eq( const ecl_file_kw_type * file_kw , const ecl_kw_type * ecl_kw) {
   if (file_kw->kw == ecl_kw)
     return true;
@@ -330,6 +424,10 @@ offset_type ecl_file_kw_get_offset(const ecl_file_kw_type * file_kw) {
     return file_kw->file_offset;
 }
 
+int ecl_file_kw_get_source( const ecl_file_kw_type * file_kw ) {
+  return file_kw->source;
+}
+
 bool ecl_file_kw_fskip_data( const ecl_file_kw_type * file_kw , fortio_type * fortio) {
   return ecl_kw_fskip_data__( ecl_file_kw_get_data_type(file_kw) , file_kw->kw_size , fortio );
 }
@@ -366,7 +464,7 @@ void ecl_file_kw_fwrite( const ecl_file_kw_type * file_kw , FILE * stream ) {
   util_fwrite_size_t( ecl_type_get_sizeof_ctype_fortio( file_kw->data_type ) , stream );
 }
 
-ecl_file_kw_type ** ecl_file_kw_fread_alloc_multiple( FILE * stream , int num) {
+static ecl_file_kw_type ** ecl_file_kw_fread_alloc_multiple__( FILE * stream , int num , arena_type * arena , str_intern_type * strings) {
   
   size_t file_kw_size = ECL_STRING8_LENGTH + 2 * sizeof(int) + sizeof(offset_type) + sizeof(size_t);
   size_t buffer_size = num * file_kw_size;
@@ -415,7 +513,7 @@ ecl_file_kw_type ** ecl_file_kw_fread_alloc_multiple( FILE * stream , int num) {
       type_size = *((size_t *) &buffer[ buffer_offset ]);
       buffer_offset += sizeof type_size;
 
-      kw_list[ikw] = ecl_file_kw_alloc0( header , ecl_type_create( ecl_type , type_size ), kw_size, file_offset );
+      kw_list[ikw] = ecl_file_kw_alloc__( arena , strings , header , ecl_type_create( ecl_type , type_size ), kw_size, file_offset );
     }
 
     free( buffer );
@@ -426,6 +524,16 @@ ecl_file_kw_type ** ecl_file_kw_fread_alloc_multiple( FILE * stream , int num) {
 
 
 
+ecl_file_kw_type ** ecl_file_kw_fread_alloc_multiple( FILE * stream , int num) {
+  return ecl_file_kw_fread_alloc_multiple__( stream , num , NULL , NULL );
+}
+
+
+ecl_file_kw_type ** ecl_file_kw_fread_alloc_multiple_arena( FILE * stream , int num , arena_type * arena , str_intern_type * strings) {
+  return ecl_file_kw_fread_alloc_multiple__( stream , num , arena , strings );
+}
+
+
 ecl_file_kw_type * ecl_file_kw_fread_alloc( FILE * stream ) {
   ecl_file_kw_type * file_kw = NULL;
   ecl_file_kw_type ** multiple = ecl_file_kw_fread_alloc_multiple( stream , 1 );
@@ -444,6 +552,14 @@ void ecl_file_kw_start_transaction(const ecl_file_kw_type * file_kw, int * ref_c
 }
 
 
+/*
+  Keywords which have been loaded during the transaction are released
+  again when the transaction ends. If the keyword has been pinned in
+  the meantime ecl_kw_free() defers releasing the data until the last
+  ecl_kw_unpin(), so the pinned data stays valid while the file_kw
+  itself is reset and will load the keyword again on the next access.
+*/
+
 void ecl_file_kw_end_transaction(ecl_file_kw_type * file_kw, int ref_count) {
   if (ref_count == 0 && file_kw->ref_count > 0) {
     ecl_kw_free(file_kw->kw);
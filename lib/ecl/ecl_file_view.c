@@ -18,10 +18,12 @@
 
 
 #include <ert/util/vector.h>
-#include <ert/util/hash.h>
+#include <ert/util/str_hash.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/str_intern.h>
 
 #include <ert/ecl/fortio.h>
+#include <ert/ecl/fortio_cache.h>
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_kw_magic.h>
 #include <ert/ecl/ecl_file_kw.h>
@@ -32,13 +34,15 @@
 
 struct ecl_file_view_struct {
   vector_type       * kw_list;      /* This is a vector of ecl_file_kw instances corresponding to the content of the file. */
-  hash_type         * kw_index;     /* A hash table with integer vectors of indices - see comment below. */
+  str_hash_type     * kw_index;     /* A hash table with integer vectors of indices - see comment below. */
   stringlist_type   * distinct_kw;  /* A stringlist of the keywords occuring in the file - each string occurs ONLY ONCE. */
   fortio_type       * fortio;       /* The same fortio instance pointer as in the ecl_file styructure. */
   bool                owner;        /* Is this map the owner of the ecl_file_kw instances; only true for the global_map. */
   inv_map_type      * inv_map;      /* Shared reference owned by the ecl_file structure. */
   vector_type       * child_list;
   int               * flags;
+  const str_intern_type * strings;  /* When != NULL all the headers in kw_list are interned in this table. */
+  fortio_cache_type * cache;        /* For keywords from other files, see ecl_file_kw_get_source(); owned by the ecl_file. */
 };
 
 struct ecl_file_transaction_struct {
@@ -65,26 +69,72 @@ bool ecl_file_view_flags_set( const ecl_file_view_type * file_view , int query_f
 }
 
 
+/*
+  For a view spanning several files this is the file of the first
+  keyword in the view.
+*/
+
 const char * ecl_file_view_get_src_file( const ecl_file_view_type * file_view ) {
-  return fortio_filename_ref( file_view->fortio );
+  if (file_view->fortio)
+    return fortio_filename_ref( file_view->fortio );
+
+  if (file_view->cache && (vector_get_size( file_view->kw_list ) > 0)) {
+    const ecl_file_kw_type * file_kw = vector_iget_const( file_view->kw_list , 0 );
+    if (ecl_file_kw_get_source( file_kw ) >= 0)
+      return fortio_cache_iget_filename( file_view->cache , ecl_file_kw_get_source( file_kw ));
+  }
+
+  return NULL;
 }
 
 
 ecl_file_view_type * ecl_file_view_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map , bool owner ) {
   ecl_file_view_type * ecl_file_view  = util_malloc( sizeof * ecl_file_view );
   ecl_file_view->kw_list              = vector_alloc_new();
-  ecl_file_view->kw_index             = hash_alloc();
+  ecl_file_view->kw_index             = str_hash_alloc();
   ecl_file_view->distinct_kw          = stringlist_alloc_new();
   ecl_file_view->child_list           = vector_alloc_new();
   ecl_file_view->owner                = owner;
   ecl_file_view->fortio               = fortio;
   ecl_file_view->inv_map              = inv_map;
   ecl_file_view->flags                = flags;
+  ecl_file_view->strings              = NULL;
+  ecl_file_view->cache                = NULL;
   return ecl_file_view;
 }
 
+
+/*
+  Set the fortio_cache holding the files of the keywords with a
+  source id; the views created from this view inherit the cache.
+*/
+
+void ecl_file_view_set_cache( ecl_file_view_type * ecl_file_view , fortio_cache_type * cache ) {
+  ecl_file_view->cache = cache;
+}
+
+
+fortio_cache_type * ecl_file_view_get_cache( const ecl_file_view_type * ecl_file_view ) {
+  return ecl_file_view->cache;
+}
+
+
+/*
+  Declare that the headers of the ecl_file_kw instances in this view
+  are interned in the strings table; header comparisons can then be
+  done by pointer. Must be called before keywords are added to the
+  view; if a keyword with a header which is not interned is added
+  later the view silently falls back to string comparison.
+*/
+
+void ecl_file_view_set_strings( ecl_file_view_type * ecl_file_view , const str_intern_type * strings ) {
+  if (vector_get_size( ecl_file_view->kw_list ) > 0)
+    util_abort("%s: the strings table must be set before keywords are added.\n",__func__);
+  ecl_file_view->strings = strings;
+}
+
 int ecl_file_view_get_global_index( const ecl_file_view_type * ecl_file_view , const char * kw , int ith) {
-  const int_vector_type * index_vector = hash_get(ecl_file_view->kw_index , kw);
+  const int_vector_type * index_vector = str_hash_get(ecl_file_view->kw_index , kw);
   int global_index = int_vector_iget( index_vector , ith);
   return global_index;
 }
@@ -102,28 +152,34 @@ int ecl_file_view_get_global_index( const ecl_file_view_type * ecl_file_view , c
 
 void ecl_file_view_make_index( ecl_file_view_type * ecl_file_view ) {
   stringlist_clear( ecl_file_view->distinct_kw );
-  hash_clear( ecl_file_view->kw_index );
+  str_hash_clear( ecl_file_view->kw_index );
   {
     int i;
     for (i=0; i < vector_get_size( ecl_file_view->kw_list ); i++) {
       const ecl_file_kw_type * file_kw = vector_iget_const( ecl_file_view->kw_list , i);
       const char             * header  = ecl_file_kw_get_header( file_kw );
-      if ( !hash_has_key( ecl_file_view->kw_index , header )) {
-        int_vector_type * index_vector = int_vector_alloc( 0 , -1 );
-        hash_insert_hash_owned_ref( ecl_file_view->kw_index , header , index_vector , int_vector_free__);
-        stringlist_append_copy( ecl_file_view->distinct_kw , header);
-      }
-
-      {
-        int_vector_type * index_vector = hash_get( ecl_file_view->kw_index , header);
-        int_vector_append( index_vector , i);
+      int_vector_type        * index_vector = str_hash_safe_get( ecl_file_view->kw_index , header );
+      if (!index_vector) {
+        index_vector = int_vector_alloc( 0 , -1 );
+        str_hash_insert_owned_ref( ecl_file_view->kw_index , header , index_vector , int_vector_free__);
+        if (ecl_file_view->strings)
+          stringlist_append_ref( ecl_file_view->distinct_kw , header);
+        else
+          stringlist_append_copy( ecl_file_view->distinct_kw , header);
       }
+      int_vector_append( index_vector , i);
     }
   }
+  /*
+    The index is not modified until the next call to
+    ecl_file_view_make_index(); lookups from several threads do not
+    need any locking.
+  */
+  str_hash_freeze( ecl_file_view->kw_index );
 }
 
 bool ecl_file_view_has_kw( const ecl_file_view_type * ecl_file_view, const char * kw) {
-  return hash_has_key( ecl_file_view->kw_index , kw );
+  return str_hash_has_key( ecl_file_view->kw_index , kw );
 }
 
 
@@ -150,15 +206,41 @@ void ecl_file_view_add_flag( ecl_file_view_type * file_view , int flag)  {
   *file_view->flags |= flag;
 }
 
+/*
+  Returns the fortio instance - with an open stream - where @file_kw
+  is stored, or NULL if the stream can not be opened. Every fortio
+  returned must be handed back with ecl_file_view_release_fortio().
+*/
+
+static fortio_type * ecl_file_view_acquire_fortio( const ecl_file_view_type * ecl_file_view , const ecl_file_kw_type * file_kw ) {
+  int source = ecl_file_kw_get_source( file_kw );
+  if (source < 0) {
+    if (fortio_assert_stream_open( ecl_file_view->fortio ))
+      return ecl_file_view->fortio;
+    else
+      return NULL;
+  } else
+    return fortio_cache_acquire( ecl_file_view->cache , source );
+}
+
+
+static void ecl_file_view_release_fortio( const ecl_file_view_type * ecl_file_view , const ecl_file_kw_type * file_kw , bool close_stream) {
+  int source = ecl_file_kw_get_source( file_kw );
+  if (source < 0) {
+    if (close_stream && ecl_file_view_flags_set( ecl_file_view , ECL_FILE_CLOSE_STREAM))
+      fortio_fclose_stream( ecl_file_view->fortio );
+  } else
+    fortio_cache_release( ecl_file_view->cache , source );
+}
+
+
 static ecl_kw_type * ecl_file_view_get_kw(const ecl_file_view_type * ecl_file_view, ecl_file_kw_type * file_kw) {
   ecl_kw_type * ecl_kw = ecl_file_kw_get_kw_ptr( file_kw );
   if (!ecl_kw) {
-    if (fortio_assert_stream_open( ecl_file_view->fortio )) {
-
-      ecl_kw = ecl_file_kw_get_kw( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map);
-
-      if (ecl_file_view_flags_set( ecl_file_view , ECL_FILE_CLOSE_STREAM))
-        fortio_fclose_stream( ecl_file_view->fortio );
+    fortio_type * fortio = ecl_file_view_acquire_fortio( ecl_file_view , file_kw );
+    if (fortio) {
+      ecl_kw = ecl_file_kw_get_kw( file_kw , fortio , ecl_file_view->inv_map);
+      ecl_file_view_release_fortio( ecl_file_view , file_kw , true );
     }
   }
   return ecl_kw;
@@ -171,13 +253,15 @@ ecl_kw_type * ecl_file_view_iget_kw( const ecl_file_view_type * ecl_file_view ,
 
 void ecl_file_view_index_fload_kw(const ecl_file_view_type * ecl_file_view, const char* kw, int index, const int_vector_type * index_map, char* buffer) {
     ecl_file_kw_type * file_kw = ecl_file_view_iget_named_file_kw( ecl_file_view , kw , index);
+    fortio_type * fortio = ecl_file_view_acquire_fortio( ecl_file_view , file_kw );
 
-    if (fortio_assert_stream_open( ecl_file_view->fortio )) {
+    if (fortio) {
         offset_type offset = ecl_file_kw_get_offset(file_kw);
         ecl_data_type data_type = ecl_file_kw_get_data_type(file_kw);
         int element_count = ecl_file_kw_get_size(file_kw);
 
-        ecl_kw_fread_indexed_data(ecl_file_view->fortio, offset + ECL_KW_HEADER_FORTIO_SIZE, data_type, element_count, index_map, buffer);
+        ecl_kw_fread_indexed_data(fortio, offset + ECL_KW_HEADER_FORTIO_SIZE, data_type, element_count, index_map, buffer);
+        ecl_file_view_release_fortio( ecl_file_view , file_kw , false );
     }
 }
 
@@ -185,7 +269,7 @@ void ecl_file_view_index_fload_kw(const ecl_file_view_type * ecl_file_view, cons
 int ecl_file_view_find_kw_value( const ecl_file_view_type * ecl_file_view , const char * kw , const void * value) {
   int global_index = -1;
   if ( ecl_file_view_has_kw( ecl_file_view , kw)) {
-    const int_vector_type * index_list = hash_get( ecl_file_view->kw_index , kw );
+    const int_vector_type * index_list = str_hash_get( ecl_file_view->kw_index , kw );
     int index = 0;
     while (index < int_vector_size( index_list )) {
       const ecl_kw_type * ecl_kw = ecl_file_view_iget_kw( ecl_file_view , int_vector_iget( index_list , index ));
@@ -233,6 +317,19 @@ ecl_kw_type * ecl_file_view_iget_named_kw( const ecl_file_view_type * ecl_file_v
   return ecl_file_view_get_kw(ecl_file_view, file_kw);
 }
 
+/*
+  Returns the keyword pinned; the data vector stays valid - and the
+  keyword stays cached in the file - until the caller calls
+  ecl_kw_unpin(), also if the file is closed in the meantime.
+*/
+
+ecl_kw_type * ecl_file_view_iget_named_pinned_kw( const ecl_file_view_type * ecl_file_view , const char * kw, int ith) {
+  ecl_kw_type * ecl_kw = ecl_file_view_iget_named_kw( ecl_file_view , kw , ith );
+  if (ecl_kw)
+    ecl_kw_pin( ecl_kw );
+  return ecl_kw;
+}
+
 ecl_data_type ecl_file_view_iget_named_data_type( const ecl_file_view_type * ecl_file_view , const char * kw , int ith) {
   ecl_file_kw_type * file_kw = ecl_file_view_iget_named_file_kw( ecl_file_view , kw, ith);
   return ecl_file_kw_get_data_type( file_kw );
@@ -257,7 +354,14 @@ void ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type
 
       if (insert_copy)
         insert_kw = ecl_kw_alloc_copy( new_kw );
-      ecl_file_kw_replace_kw( ikw , ecl_file_view->fortio , insert_kw );
+      {
+        fortio_type * fortio = ecl_file_view_acquire_fortio( ecl_file_view , ikw );
+        if (!fortio)
+          util_abort("%s: failed to open:%s \n",__func__ , ecl_file_view_get_src_file( ecl_file_view ));
+
+        ecl_file_kw_replace_kw( ikw , fortio , insert_kw );
+        ecl_file_view_release_fortio( ecl_file_view , ikw , false );
+      }
 
       ecl_file_view_make_index( ecl_file_view );
       return;
@@ -271,6 +375,17 @@ void ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type
 bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view ) {
   bool loadOK = false;
 
+  if (ecl_file_view->cache) {
+    int index;
+    loadOK = true;
+    for (index = 0; index < vector_get_size( ecl_file_view->kw_list); index++) {
+      ecl_file_kw_type * ikw = vector_iget( ecl_file_view->kw_list , index );
+      if (!ecl_file_view_get_kw( ecl_file_view , ikw ))
+        loadOK = false;
+    }
+    return loadOK;
+  }
+
   if (fortio_assert_stream_open( ecl_file_view->fortio )) {
     int index;
     for (index = 0; index < vector_get_size( ecl_file_view->kw_list); index++) {
@@ -292,6 +407,9 @@ bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view ) {
 
 
 void ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type * file_kw) {
+  if (ecl_file_view->strings && !str_intern_is_interned( ecl_file_view->strings , ecl_file_kw_get_header( file_kw )))
+    ecl_file_view->strings = NULL;
+
   if (ecl_file_view->owner)
     vector_append_owned_ref( ecl_file_view->kw_list , file_kw , ecl_file_kw_free__ );
   else
@@ -300,7 +418,7 @@ void ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type
 
 void ecl_file_view_free( ecl_file_view_type * ecl_file_view ) {
   vector_free( ecl_file_view->child_list );
-  hash_free( ecl_file_view->kw_index );
+  str_hash_free( ecl_file_view->kw_index );
   stringlist_free( ecl_file_view->distinct_kw );
   vector_free( ecl_file_view->kw_list );
   free( ecl_file_view );
@@ -313,18 +431,44 @@ void ecl_file_view_free__( void * arg ) {
 
 
 int ecl_file_view_get_num_named_kw(const ecl_file_view_type * ecl_file_view , const char * kw) {
-  if (hash_has_key(ecl_file_view->kw_index , kw)) {
-    const int_vector_type * index_vector = hash_get(ecl_file_view->kw_index , kw);
+  if (str_hash_has_key(ecl_file_view->kw_index , kw)) {
+    const int_vector_type * index_vector = str_hash_get(ecl_file_view->kw_index , kw);
     return int_vector_size( index_vector );
   } else
     return 0;
 }
 
+/*
+  Keywords which have not been loaded are copied byte for byte from
+  the source file when the target has the same format, see
+  ecl_kw_fcopy_raw(); loaded keywords - which might have been
+  modified - are written from memory.
+*/
+
 void ecl_file_view_fwrite( const ecl_file_view_type * ecl_file_view , fortio_type * target , int offset) {
   int index;
   for (index = offset; index < vector_get_size( ecl_file_view->kw_list ); index++) {
-    ecl_kw_type * ecl_kw = ecl_file_view_iget_kw( ecl_file_view , index );
-    ecl_kw_fwrite( ecl_kw , target );
+    ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file_view , index );
+    fortio_type * fortio = NULL;
+
+    if (!ecl_file_kw_is_loaded( file_kw ))
+      fortio = ecl_file_view_acquire_fortio( ecl_file_view , file_kw );
+
+    if (fortio && fortio_same_format( fortio , target )) {
+      fortio_fseek( fortio , ecl_file_kw_get_offset( file_kw ) , SEEK_SET );
+      if (!ecl_kw_fcopy_raw( fortio , target ))
+        util_abort("%s: failed to copy keyword:%s from %s to %s \n",__func__ ,
+                   ecl_file_kw_get_header( file_kw ) ,
+                   fortio_filename_ref( fortio ) ,
+                   fortio_filename_ref( target ));
+      ecl_file_view_release_fortio( ecl_file_view , file_kw , false );
+    } else {
+      if (fortio)
+        ecl_file_view_release_fortio( ecl_file_view , file_kw , false );
+
+      ecl_kw_type * ecl_kw = ecl_file_view_get_kw( ecl_file_view , file_kw );
+      ecl_kw_fwrite( ecl_kw , target );
+    }
   }
 }
 
@@ -334,7 +478,7 @@ void ecl_file_view_fwrite( const ecl_file_view_type * ecl_file_view , fortio_typ
 int ecl_file_view_iget_occurence( const ecl_file_view_type * ecl_file_view , int global_index) {
   const ecl_file_kw_type * file_kw = vector_iget_const( ecl_file_view->kw_list , global_index);
   const char * header              = ecl_file_kw_get_header( file_kw );
-  const int_vector_type * index_vector = hash_get( ecl_file_view->kw_index , header );
+  const int_vector_type * index_vector = str_hash_get( ecl_file_view->kw_index , header );
   const int * index_data = int_vector_get_const_ptr( index_vector );
 
   int occurence = -1;
@@ -375,10 +519,21 @@ ecl_file_view_type * ecl_file_view_alloc_blockview2(const ecl_file_view_type * e
   if (start_kw)
     kw_index = ecl_file_view_get_global_index( ecl_file_view , start_kw , occurence );
 
+  block_map->strings = ecl_file_view->strings;
+  block_map->cache   = ecl_file_view->cache;
   {
     ecl_file_kw_type * file_kw = vector_iget( ecl_file_view->kw_list , kw_index );
+    /*
+      With interned headers the end_kw is looked up once, and the
+      headers are compared by pointer; if end_kw is not in the strings
+      table it can not occur in the view at all.
+    */
+    const char * end_ptr = NULL;
+    if (end_kw && ecl_file_view->strings)
+      end_ptr = str_intern_get( ecl_file_view->strings , end_kw );
+
     while (true) {
-      ecl_file_view_add_kw( block_map , file_kw );
+      vector_append_ref( block_map->kw_list , file_kw );
 
       kw_index++;
       if (kw_index == vector_get_size( ecl_file_view->kw_list ))
@@ -386,7 +541,10 @@ ecl_file_view_type * ecl_file_view_alloc_blockview2(const ecl_file_view_type * e
       else {
         if (end_kw) {
           file_kw = vector_iget(ecl_file_view->kw_list , kw_index);
-          if (strcmp( end_kw , ecl_file_kw_get_header( file_kw )) == 0)
+          if (ecl_file_view->strings) {
+            if (ecl_file_kw_get_header( file_kw ) == end_ptr)
+              break;
+          } else if (strcmp( end_kw , ecl_file_kw_get_header( file_kw )) == 0)
             break;
         }
       }
@@ -589,7 +747,7 @@ double ecl_file_view_iget_restart_sim_days(const ecl_file_view_type * ecl_file_v
 int ecl_file_view_find_sim_time(const ecl_file_view_type * ecl_file_view , time_t sim_time) {
   int seqnum_index = -1;
   if ( ecl_file_view_has_kw( ecl_file_view , INTEHEAD_KW)) {
-    const int_vector_type * intehead_index_list = hash_get( ecl_file_view->kw_index , INTEHEAD_KW );
+    const int_vector_type * intehead_index_list = str_hash_get( ecl_file_view->kw_index , INTEHEAD_KW );
     int index = 0;
     while (index < int_vector_size( intehead_index_list )) {
       const ecl_kw_type * intehead_kw = ecl_file_view_iget_kw( ecl_file_view , int_vector_iget( intehead_index_list , index ));
@@ -772,7 +930,8 @@ ecl_file_view_type * ecl_file_view_add_summary_view( ecl_file_view_type * file_v
 
 
 void ecl_file_view_fclose_stream( ecl_file_view_type * file_view ) {
-  fortio_fclose_stream( file_view->fortio );
+  if (file_view->fortio)
+    fortio_fclose_stream( file_view->fortio );
 }
 
 void ecl_file_view_write_index(const ecl_file_view_type * file_view, FILE * ostream) {
@@ -786,12 +945,19 @@ void ecl_file_view_write_index(const ecl_file_view_type * file_view, FILE * ostr
   }
 }
 
-ecl_file_view_type * ecl_file_view_fread_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map, FILE * istream ) {
+/*
+  The arena argument can be NULL, in which case the ecl_file_kw
+  instances are allocated individually; the strings argument can be
+  NULL in which case the headers are not interned.
+*/
+
+ecl_file_view_type * ecl_file_view_fread_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map, arena_type * arena , str_intern_type * strings , FILE * istream ) {
 
   int index_size = util_fread_int(istream);
-  ecl_file_kw_type ** file_kw_list = ecl_file_kw_fread_alloc_multiple( istream, index_size);
+  ecl_file_kw_type ** file_kw_list = ecl_file_kw_fread_alloc_multiple_arena( istream, index_size , arena , strings);
   if (file_kw_list) {
     ecl_file_view_type * file_view = ecl_file_view_alloc( fortio , flags , inv_map , true ); 
+    ecl_file_view_set_strings( file_view , strings );
     for (int i=0; i < index_size; i++)
       ecl_file_view_add_kw(file_view , file_kw_list[i]);
 
@@ -75,6 +75,7 @@ struct ecl_grav_struct {
                                               is a double_vector() instance which is indexed by PVTNUM
                                               values. Used to lookup standard condition mass densities. Must
                                               be suuplied by user __BEFORE__ adding a FIP based survey. */
+  vector_type              * tree_list;    /* ecl_grav_tree_type instances used by ecl_grav_eval_list(); one for each region. */
 };
 
 
@@ -161,44 +162,65 @@ static void ecl_grav_phase_ensure_work( ecl_grav_phase_type * grav_phase) {
 }
 
 
+/*
+   Adds the difference in mass between the monitor and the base phase
+   for the cells parent_index[0 ... size) to the weight array; with
+   parent_index == NULL the mass_diff array is indexed with active
+   index.
+*/
+
+static void ecl_grav_phase_add_mass_diff( const ecl_grav_phase_type * base_phase ,
+                                          const ecl_grav_phase_type * monitor_phase,
+                                          const int * parent_index , int size ,
+                                          double * mass_diff) {
+
+  if ((monitor_phase == NULL) || (base_phase->phase == monitor_phase->phase)) {
+    int index;
+
+    if (monitor_phase == NULL) {
+      for (index = 0; index < size; index++) {
+        int active_index = parent_index ? parent_index[index] : index;
+        mass_diff[index] -= base_phase->fluid_mass[ active_index ];
+      }
+    } else {
+      for (index = 0; index < size; index++) {
+        int active_index = parent_index ? parent_index[index] : index;
+        mass_diff[index] += monitor_phase->fluid_mass[ active_index ] - base_phase->fluid_mass[ active_index ];
+      }
+    }
+  } else
+    util_abort("%s comparing different phases ... \n",__func__);
+}
+
+
 static double ecl_grav_phase_eval( ecl_grav_phase_type * base_phase ,
                                    const ecl_grav_phase_type * monitor_phase,
                                    ecl_region_type * region ,
                                    double utm_x , double utm_y , double depth) {
 
-  ecl_grav_phase_ensure_work( base_phase );
-  if ((monitor_phase == NULL) || (base_phase->phase == monitor_phase->phase)) {
-    const ecl_grid_cache_type * grid_cache = base_phase->grid_cache;
-    const bool   * aquifer   = base_phase->aquifer_cell;
-    double * mass_diff       = base_phase->work;
-    double deltag;
-    /*
-       Initialize a work array to contain the difference in mass for
-       every cell.
-    */
-    {
-      int index;
-      if (monitor_phase == NULL) {
-        for (index = 0; index < ecl_grid_cache_get_size( grid_cache ); index++)
-          mass_diff[index] = - base_phase->fluid_mass[index];
-      } else {
-        for (index = 0; index < ecl_grid_cache_get_size( grid_cache ); index++)
-          mass_diff[index] = monitor_phase->fluid_mass[index] - base_phase->fluid_mass[index];
-      }
-    }
+  const ecl_grid_cache_type * grid_cache = base_phase->grid_cache;
+  const int size = ecl_grid_cache_get_size( grid_cache );
+  double * mass_diff = NULL;
+  double deltag;
 
-    /**
-       The Gravitational constant is 6.67E-11 N (m/kg)^2, we
-       return the result in microGal, i.e. we scale with 10^2 *
-       10^6 => 6.67E-3.
-    */
-    deltag = 6.67428E-3 * ecl_grav_common_eval_biot_savart( grid_cache , region , aquifer , mass_diff , utm_x , utm_y , depth);
+  ecl_grav_phase_ensure_work( base_phase );
+  mass_diff = base_phase->work;
+  /*
+     Initialize a work array to contain the difference in mass for
+     every cell.
+  */
+  for (int index = 0; index < size; index++)
+    mass_diff[index] = 0;
+  ecl_grav_phase_add_mass_diff( base_phase , monitor_phase , NULL , size , mass_diff );
+
+  /**
+     The Gravitational constant is 6.67E-11 N (m/kg)^2, we
+     return the result in microGal, i.e. we scale with 10^2 *
+     10^6 => 6.67E-3.
+  */
+  deltag = 6.67428E-3 * ecl_grav_common_eval_biot_savart( grid_cache , region , base_phase->aquifer_cell , mass_diff , utm_x , utm_y , depth);
 
-    return deltag;
-  } else {
-    util_abort("%s comparing different phases ... \n",__func__);
-    return -1;
-  }
+  return deltag;
 }
 
 
@@ -563,7 +585,9 @@ static double ecl_grav_survey_eval( const ecl_grav_survey_type * base_survey,
 
 /*****************************************************************/
 /**
-   The grid instance is only used during the construction phase. The
+   The grid cache is shared with the other ecl_grav and ecl_subsidence
+   instances of the same grid, see ecl_grid_cache_alloc_shared(); the
+   grid must therefore not be destroyed before this object. The
    @init_file object is used by the ecl_grav_add_survey_XXX()
    functions; and calling scope must NOT destroy this object before
    all surveys have been added.
@@ -572,11 +596,12 @@ static double ecl_grav_survey_eval( const ecl_grav_survey_type * base_survey,
 ecl_grav_type * ecl_grav_alloc( const ecl_grid_type * ecl_grid, const ecl_file_type * init_file) {
   ecl_grav_type * ecl_grav = util_malloc( sizeof * ecl_grav );
   ecl_grav->init_file      = init_file;
-  ecl_grav->grid_cache     = ecl_grid_cache_alloc( ecl_grid );
+  ecl_grav->grid_cache     = ecl_grid_cache_alloc_shared( ecl_grid , false );
   ecl_grav->aquifer_cell   = ecl_grav_common_alloc_aquifer_cell( ecl_grav->grid_cache , ecl_grav->init_file );
 
   ecl_grav->surveys        = hash_alloc();
   ecl_grav->std_density    = hash_alloc();
+  ecl_grav->tree_list      = vector_alloc_new();
   return ecl_grav;
 }
 
@@ -645,6 +670,52 @@ double ecl_grav_eval( const ecl_grav_type * grav , const char * base, const char
 }
 
 
+/**
+   Evaluates the gravity change of ecl_grav_eval() for num_stations
+   stations; the result for station i is stored in result[i]. The
+   cells are organized in a tree which is reused by later calls, and
+   clusters of cells which are far away from a station compared to
+   their size are lumped together. The parameter theta is the largest
+   ratio size / distance of a cluster which is lumped; theta == 0
+   gives the same result as ecl_grav_eval(). With theta = 0.5 the
+   error is typically less than 0.1% of the sum of the absolute
+   contributions from the cells.
+
+   The trees of the most recently used regions are kept in the
+   ecl_grav instance, see ecl_grav_common_acquire_tree(); the function
+   can be called concurrently.
+*/
+
+void ecl_grav_eval_list( const ecl_grav_type * grav , const char * base, const char * monitor , ecl_region_type * region ,
+                         int num_stations , const double * utm_x , const double * utm_y , const double * depth ,
+                         int phase_mask , double theta , double * result) {
+  ecl_grav_survey_type * base_survey    = ecl_grav_get_survey( grav , base );
+  ecl_grav_survey_type * monitor_survey = ecl_grav_get_survey( grav , monitor );
+  ecl_grav_tree_type * tree             = ecl_grav_common_acquire_tree( grav->tree_list , grav->grid_cache , region , grav->aquifer_cell );
+  const ecl_grid_cache_type * subset    = ecl_grav_tree_get_subset( tree );
+  const int * parent_index              = ecl_grid_cache_get_parent_index( subset );
+  const int size                        = ecl_grid_cache_get_size( subset );
+  double * mass_diff                    = util_calloc( util_int_max( 1 , size ) , sizeof * mass_diff );
+
+  for (int phase_nr = 0; phase_nr < vector_get_size( base_survey->phase_list ); phase_nr++) {
+    const ecl_grav_phase_type * base_phase = vector_iget_const( base_survey->phase_list , phase_nr );
+    if (base_phase->phase & phase_mask) {
+      const ecl_grav_phase_type * monitor_phase = NULL;
+      if (monitor_survey != NULL)
+        monitor_phase = vector_iget_const( monitor_survey->phase_list , phase_nr );
+      ecl_grav_phase_add_mass_diff( base_phase , monitor_phase , parent_index , size , mass_diff );
+    }
+  }
+
+  ecl_grav_common_eval_biot_savart_tree( tree , mass_diff , num_stations , utm_x , utm_y , depth , theta , result );
+  for (int station = 0; station < num_stations; station++)
+    result[station] *= 6.67428E-3;
+
+  ecl_grav_common_release_tree( tree );
+  free( mass_diff );
+}
+
+
 /******************************************************************/
 /* The functions ecl_grav_new_std_density() and ecl_grav_add_std_density() are
    used to "install" standard conditions densities for the various phases
@@ -687,9 +758,10 @@ void ecl_grav_add_std_density( ecl_grav_type * grav , ecl_phase_enum phase , int
 
 
 void ecl_grav_free( ecl_grav_type * ecl_grav ) {
-  ecl_grid_cache_free( ecl_grav->grid_cache );
-  free( ecl_grav->aquifer_cell );
   hash_free( ecl_grav->surveys );
   hash_free( ecl_grav->std_density );
+  vector_free( ecl_grav->tree_list );
+  ecl_grid_cache_free( ecl_grav->grid_cache );
+  free( ecl_grav->aquifer_cell );
   free( ecl_grav );
 }
@@ -19,15 +19,26 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <math.h>
 
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <ert/util/ert_api_config.h>
 #include <ert/util/util.h>
+#include <ert/util/vector.h>
+#include <ert/util/thread_pool.h>
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file.h>
 #include <ert/ecl/ecl_region.h>
 #include <ert/ecl/ecl_grid_cache.h>
 #include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_grav_common.h>
 
 /*
   This file contains code which is common to both the ecl_grav
@@ -35,6 +46,22 @@
   implementation for changes in subsidence.
 */
 
+
+/*
+  The lock protects the per object tree lists, which are filled on
+  demand from functions taking a const ecl_grav or ecl_subsidence
+  instance, and the reference counts of the trees in them.
+*/
+
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t grav_common_lock = PTHREAD_MUTEX_INITIALIZER;
+#define ECL_GRAV_COMMON_LOCK()   pthread_mutex_lock( &grav_common_lock )
+#define ECL_GRAV_COMMON_UNLOCK() pthread_mutex_unlock( &grav_common_lock )
+#else
+#define ECL_GRAV_COMMON_LOCK()
+#define ECL_GRAV_COMMON_UNLOCK()
+#endif
+
 bool * ecl_grav_common_alloc_aquifer_cell( const ecl_grid_cache_type * grid_cache , const ecl_file_type * init_file) {
   bool * aquifer_cell = util_calloc( ecl_grid_cache_get_size( grid_cache ) , sizeof * aquifer_cell  );
 
@@ -56,45 +83,176 @@ bool * ecl_grav_common_alloc_aquifer_cell( const ecl_grid_cache_type * grid_cach
 
 
 
-double ecl_grav_common_eval_biot_savart( const ecl_grid_cache_type * grid_cache , ecl_region_type * region , const bool * aquifer , const double * weight , double utm_x , double utm_y , double depth) {
-  const double * xpos      = ecl_grid_cache_get_xpos( grid_cache );
-  const double * ypos      = ecl_grid_cache_get_ypos( grid_cache );
-  const double * zpos      = ecl_grid_cache_get_zpos( grid_cache );
-  double sum = 0;
-  if (region == NULL) {
-    const int      size   = ecl_grid_cache_get_size( grid_cache );
-    int index;
-    for ( index = 0; index < size; index++) {
-      if (!aquifer[index]) {
-        double dist_x  = (xpos[index] - utm_x );
-        double dist_y  = (ypos[index] - utm_y );
-        double dist_z  = (zpos[index] - depth );
-        double dist    = sqrt( dist_x*dist_x + dist_y*dist_y + dist_z*dist_z );
-
-        /**
-            For numerical precision it might be benficial to use the
-            util_kahan_sum() function to do a Kahan summation.
-        */
-        sum += weight[index] * dist_z/(dist * dist * dist );
-      }
+/*
+  The _subset eval functions work on a subset of the grid cache, see
+  ecl_grid_cache_get_subset(), where the positions of the cells to
+  include are stored contiguously and the weights are given in the
+  order of the subset. With float storage the positions are converted
+  to double one block at a time. The plain eval functions gather the
+  positions and weights of the cells in the region into the same
+  blocks.
+*/
+
+#define ECL_GRAV_COMMON_BLOCK_SIZE 1024
+
+typedef struct {
+  const double * xpos;
+  const double * ypos;
+  const double * zpos;
+  double         buffer[3][ECL_GRAV_COMMON_BLOCK_SIZE];
+  double         weight[ECL_GRAV_COMMON_BLOCK_SIZE];
+} ecl_grav_common_block_type;
+
+
+static void ecl_grav_common_load_block( const ecl_grid_cache_type * subset , int offset , int count , ecl_grav_common_block_type * block) {
+  if (ecl_grid_cache_float_storage( subset )) {
+    const float * xpos = ecl_grid_cache_get_xpos_float( subset );
+    const float * ypos = ecl_grid_cache_get_ypos_float( subset );
+    const float * zpos = ecl_grid_cache_get_zpos_float( subset );
+    double x0 , y0 , z0;
+
+    ecl_grid_cache_get_origin( subset , &x0 , &y0 , &z0 );
+    for (int i = 0; i < count; i++) {
+      block->buffer[0][i] = x0 + xpos[offset + i];
+      block->buffer[1][i] = y0 + ypos[offset + i];
+      block->buffer[2][i] = z0 + zpos[offset + i];
     }
+    block->xpos = block->buffer[0];
+    block->ypos = block->buffer[1];
+    block->zpos = block->buffer[2];
   } else {
+    block->xpos = &ecl_grid_cache_get_xpos( subset )[offset];
+    block->ypos = &ecl_grid_cache_get_ypos( subset )[offset];
+    block->zpos = &ecl_grid_cache_get_zpos( subset )[offset];
+  }
+}
+
+
+static ecl_grid_cache_type * ecl_grav_common_alloc_subset( const ecl_grid_cache_type * grid_cache , ecl_region_type * region , const bool * aquifer) {
+  if (region == NULL)
+    return ecl_grid_cache_get_subset( grid_cache , NULL , 0 , aquifer );
+  else {
     const int_vector_type * index_vector = ecl_region_get_active_list( region );
-    const int size = int_vector_size( index_vector );
-    const int * index_list = int_vector_get_const_ptr( index_vector );
-    int i, index;
-    for (i = 0; i < size; i++) {
-      index = index_list[i];
-      if (!aquifer[index]) {
-        double dist_x  = (xpos[index] - utm_x );
-        double dist_y  = (ypos[index] - utm_y );
-        double dist_z  = (zpos[index] - depth );
-        double dist    = sqrt( dist_x*dist_x + dist_y*dist_y + dist_z*dist_z );
-
-        sum += weight[index] * dist_z/(dist * dist * dist );
-      }
+    return ecl_grid_cache_get_subset( grid_cache ,
+                                      int_vector_get_const_ptr( index_vector ) ,
+                                      int_vector_size( index_vector ) ,
+                                      aquifer );
+  }
+}
+
+
+/*
+  Gathers the positions and weights of the next cells of the region,
+  i.e. index_list[*pos ...], or all the cells from *pos if index_list
+  is NULL, into the block; aquifer cells are skipped. Returns the
+  number of cells in the block, and advances *pos past them.
+*/
+
+static int ecl_grav_common_gather_block( const ecl_grid_cache_type * grid_cache , const int * index_list , int size , const bool * aquifer ,
+                                         const double * weight , int * pos , ecl_grav_common_block_type * block) {
+  const bool float_storage = ecl_grid_cache_float_storage( grid_cache );
+  const double * xpos = NULL , * ypos = NULL , * zpos = NULL;
+  const float * xposf = NULL , * yposf = NULL , * zposf = NULL;
+  double x0 = 0 , y0 = 0 , z0 = 0;
+  int count = 0;
+
+  if (float_storage) {
+    xposf = ecl_grid_cache_get_xpos_float( grid_cache );
+    yposf = ecl_grid_cache_get_ypos_float( grid_cache );
+    zposf = ecl_grid_cache_get_zpos_float( grid_cache );
+    ecl_grid_cache_get_origin( grid_cache , &x0 , &y0 , &z0 );
+  } else {
+    xpos = ecl_grid_cache_get_xpos( grid_cache );
+    ypos = ecl_grid_cache_get_ypos( grid_cache );
+    zpos = ecl_grid_cache_get_zpos( grid_cache );
+  }
+
+  while ((*pos < size) && (count < ECL_GRAV_COMMON_BLOCK_SIZE)) {
+    int index = index_list ? index_list[*pos] : *pos;
+    (*pos)++;
+    if (aquifer && aquifer[index])
+      continue;
+
+    if (float_storage) {
+      block->buffer[0][count] = x0 + xposf[index];
+      block->buffer[1][count] = y0 + yposf[index];
+      block->buffer[2][count] = z0 + zposf[index];
+    } else {
+      block->buffer[0][count] = xpos[index];
+      block->buffer[1][count] = ypos[index];
+      block->buffer[2][count] = zpos[index];
     }
+    block->weight[count] = weight[index];
+    count++;
+  }
+
+  block->xpos = block->buffer[0];
+  block->ypos = block->buffer[1];
+  block->zpos = block->buffer[2];
+  return count;
+}
+
+
+static double ecl_grav_common_biot_savart_block( const ecl_grav_common_block_type * block , const double * block_weight , int count , double utm_x , double utm_y , double depth) {
+  double sum = 0;
+  for (int index = 0; index < count; index++) {
+    double dist_x  = (block->xpos[index] - utm_x );
+    double dist_y  = (block->ypos[index] - utm_y );
+    double dist_z  = (block->zpos[index] - depth );
+    double dist    = sqrt( dist_x*dist_x + dist_y*dist_y + dist_z*dist_z );
+
+    /**
+        For numerical precision it might be benficial to use the
+        util_kahan_sum() function to do a Kahan summation.
+    */
+    sum += block_weight[index] * dist_z/(dist * dist * dist );
+  }
+  return sum;
+}
+
+
+double ecl_grav_common_eval_biot_savart_subset( const ecl_grid_cache_type * subset , const double * weight , double utm_x , double utm_y , double depth) {
+  const int size = ecl_grid_cache_get_size( subset );
+  ecl_grav_common_block_type * block = util_malloc( sizeof * block );
+  double sum = 0;
+
+  for (int offset = 0; offset < size; offset += ECL_GRAV_COMMON_BLOCK_SIZE) {
+    int count = util_int_min( ECL_GRAV_COMMON_BLOCK_SIZE , size - offset );
+    ecl_grav_common_load_block( subset , offset , count , block );
+    sum += ecl_grav_common_biot_savart_block( block , &weight[offset] , count , utm_x , utm_y , depth );
+  }
+
+  free( block );
+  return sum;
+}
+
+
+/*
+  The weight arrays passed to the functions below are indexed with
+  active index. The cells of the region are visited directly, i.e.
+  no subset is created; use the _subset functions with a subset held
+  by the caller when evaluating the same region many times.
+*/
+
+double ecl_grav_common_eval_biot_savart( const ecl_grid_cache_type * grid_cache , ecl_region_type * region , const bool * aquifer , const double * weight , double utm_x , double utm_y , double depth) {
+  const int * index_list = NULL;
+  int size = ecl_grid_cache_get_size( grid_cache );
+  ecl_grav_common_block_type * block = util_malloc( sizeof * block );
+  double sum = 0;
+  int pos = 0;
+
+  if (region != NULL) {
+    const int_vector_type * index_vector = ecl_region_get_active_list( region );
+    index_list = int_vector_get_const_ptr( index_vector );
+    size = int_vector_size( index_vector );
+  }
+
+  while (pos < size) {
+    int count = ecl_grav_common_gather_block( grid_cache , index_list , size , aquifer , weight , &pos , block );
+    sum += ecl_grav_common_biot_savart_block( block , block->weight , count , utm_x , utm_y , depth );
   }
+
+  free( block );
   return sum;
 }
 
@@ -124,40 +282,634 @@ static inline double ecl_grav_common_eval_geertsma_kernel(int index, const doubl
 }
 
 
+static double ecl_grav_common_geertsma_block( const ecl_grav_common_block_type * block , const double * block_weight , int count , double utm_x , double utm_y , double depth, double poisson_ratio, double seabed) {
+  double sum = 0;
+  for (int index = 0; index < count; index++) {
+    double displacement = ecl_grav_common_eval_geertsma_kernel( index, block->xpos , block->ypos , block->zpos, utm_x, utm_y , depth, poisson_ratio, seabed);
+
+    /**
+        For numerical precision it might be benficial to use the
+        util_kahan_sum() function to do a Kahan summation.
+    */
+    sum += block_weight[index] * displacement;
+  }
+  return sum;
+}
+
+
+double ecl_grav_common_eval_geertsma_subset( const ecl_grid_cache_type * subset , const double * weight , double utm_x , double utm_y , double depth, double poisson_ratio, double seabed) {
+  const int size = ecl_grid_cache_get_size( subset );
+  ecl_grav_common_block_type * block = util_malloc( sizeof * block );
+  double sum = 0;
+
+  for (int offset = 0; offset < size; offset += ECL_GRAV_COMMON_BLOCK_SIZE) {
+    int count = util_int_min( ECL_GRAV_COMMON_BLOCK_SIZE , size - offset );
+    ecl_grav_common_load_block( subset , offset , count , block );
+    sum += ecl_grav_common_geertsma_block( block , &weight[offset] , count , utm_x , utm_y , depth , poisson_ratio , seabed );
+  }
+
+  free( block );
+  return sum;
+}
+
+
 double ecl_grav_common_eval_geertsma( const ecl_grid_cache_type * grid_cache , ecl_region_type * region , const bool * aquifer , const double * weight , double utm_x , double utm_y , double depth, double poisson_ratio, double seabed) {
-  const double * xpos      = ecl_grid_cache_get_xpos( grid_cache );
-  const double * ypos      = ecl_grid_cache_get_ypos( grid_cache );
-  const double * zpos      = ecl_grid_cache_get_zpos( grid_cache );
+  const int * index_list = NULL;
+  int size = ecl_grid_cache_get_size( grid_cache );
+  ecl_grav_common_block_type * block = util_malloc( sizeof * block );
   double sum = 0;
-  if (region == NULL) {
-    const int      size = ecl_grid_cache_get_size( grid_cache );
-    int index;
-    for ( index = 0; index < size; index++) {
-      if (!aquifer[index]) {
-
-        double displacement = ecl_grav_common_eval_geertsma_kernel( index, xpos , ypos , zpos, utm_x, utm_y , depth, poisson_ratio, seabed);
-
-        /**
-            For numerical precision it might be benficial to use the
-            util_kahan_sum() function to do a Kahan summation.
-        */
-        sum += weight[index] * displacement;
+  int pos = 0;
+
+  if (region != NULL) {
+    const int_vector_type * index_vector = ecl_region_get_active_list( region );
+    index_list = int_vector_get_const_ptr( index_vector );
+    size = int_vector_size( index_vector );
+  }
+
+  while (pos < size) {
+    int count = ecl_grav_common_gather_block( grid_cache , index_list , size , aquifer , weight , &pos , block );
+    sum += ecl_grav_common_geertsma_block( block , block->weight , count , utm_x , utm_y , depth , poisson_ratio , seabed );
+  }
+
+  free( block );
+  return sum;
+}
+
+
+/*****************************************************************/
+/*
+  Tree accelerated evaluation for many stations.
+
+  The cells of a subset are organized in a kd-tree; each node has a
+  bounding box and the cells in the node are stored contiguously. For
+  a given set of weights the monopole, dipole and quadrupole moments
+  of the weights around the center of each node are calculated once,
+  and every station then walks the tree:
+
+    - A node which is small compared to the distance to the station,
+      i.e. size / distance < theta, is evaluated with a second order
+      Taylor expansion of the kernel around the node center.
+
+    - Otherwise the children of the node are visited; the cells in
+      the leaves which are reached are summed exactly.
+
+  The derivatives of the kernel are found with central differences,
+  so the same code serves both the biot-savart and the geertsma
+  kernels. The error decreases rapidly with theta; theta == 0 gives an
+  exact evaluation.
+*/
+
+#define ECL_GRAV_COMMON_MAX_TREES     4
+#define ECL_GRAV_TREE_LEAF_SIZE       32
+#define ECL_GRAV_TREE_MAX_DEPTH       128
+#define ECL_GRAV_TREE_MIN_PARALLEL    16
+#define ECL_GRAV_TREE_NUM_MOMENTS     10
+#define ECL_GRAV_TREE_FD_STEP         0.005
+
+typedef struct {
+  double center[3];
+  double size;           /* The diagonal of the bounding box. */
+  int    begin;          /* The cells of the node are [begin,end) in the tree order. */
+  int    end;
+  int    child[2];       /* -1 for leaf nodes. */
+} ecl_grav_tree_node_type;
+
+
+struct ecl_grav_tree_struct {
+  const ecl_grid_cache_type * subset;
+  ecl_grid_cache_type       * owned_subset; /* Set for the trees in a tree_list, which hold a reference to their subset. */
+  int                         ref_count;    /* The number of ecl_grav_common_acquire_tree() calls not yet released. */
+  int                         size;
+  int                       * perm;        /* The subset index of each cell in the tree order. */
+  double                    * xpos;        /* Positions in the tree order. */
+  double                    * ypos;
+  double                    * zpos;
+  int                         num_nodes;
+  int                         alloc_size;
+  ecl_grav_tree_node_type   * nodes;       /* A parent node always comes before its children. */
+};
+
+
+typedef struct {
+  double utm_x;
+  double utm_y;
+  double depth;
+  double poisson_ratio;
+  double seabed;
+  bool   geertsma;
+} ecl_grav_tree_station_type;
+
+
+static inline double ecl_grav_tree_kernel( const ecl_grav_tree_station_type * station , double x , double y , double z) {
+  if (station->geertsma)
+    return ecl_grav_common_eval_geertsma_kernel( 0 , &x , &y , &z , station->utm_x , station->utm_y , station->depth , station->poisson_ratio , station->seabed );
+  else {
+    double dist_x  = x - station->utm_x;
+    double dist_y  = y - station->utm_y;
+    double dist_z  = z - station->depth;
+    double dist    = sqrt( dist_x*dist_x + dist_y*dist_y + dist_z*dist_z );
+    return dist_z / (dist * dist * dist);
+  }
+}
+
+
+static void ecl_grav_tree_swap( ecl_grav_tree_type * tree , int i1 , int i2) {
+  double tmp;
+  int itmp;
+
+  tmp = tree->xpos[i1]; tree->xpos[i1] = tree->xpos[i2]; tree->xpos[i2] = tmp;
+  tmp = tree->ypos[i1]; tree->ypos[i1] = tree->ypos[i2]; tree->ypos[i2] = tmp;
+  tmp = tree->zpos[i1]; tree->zpos[i1] = tree->zpos[i2]; tree->zpos[i2] = tmp;
+  itmp = tree->perm[i1]; tree->perm[i1] = tree->perm[i2]; tree->perm[i2] = itmp;
+}
+
+
+/*
+  Reorders the cells in [begin,end) so that the cell at position nth
+  has the value it would have in sorted order along the axis, with
+  smaller or equal values before it and larger or equal after.
+*/
+
+static void ecl_grav_tree_select( ecl_grav_tree_type * tree , const double * key , int begin , int end , int nth) {
+  int lo = begin;
+  int hi = end - 1;
+
+  while (hi > lo) {
+    double pivot = key[ lo + (hi - lo) / 2 ];
+    int i = lo;
+    int j = hi;
+
+    while (i <= j) {
+      while (key[i] < pivot)
+        i++;
+      while (key[j] > pivot)
+        j--;
+      if (i <= j) {
+        ecl_grav_tree_swap( tree , i , j );
+        i++;
+        j--;
       }
     }
-  } else {
-    const int_vector_type * index_vector = ecl_region_get_active_list( region );
-    const int size = int_vector_size( index_vector );
-    const int * index_list = int_vector_get_const_ptr( index_vector );
-    int i, index;
-    for (i = 0; i < size; i++) {
-      index = index_list[i];
-      if (!aquifer[index]) {
-        double displacement = ecl_grav_common_eval_geertsma_kernel( index, xpos , ypos , zpos, utm_x, utm_y , depth , poisson_ratio, seabed);
-        sum += weight[index] * displacement;
+
+    if (nth <= j)
+      hi = j;
+    else if (nth >= i)
+      lo = i;
+    else
+      break;
+  }
+}
+
+
+static int ecl_grav_tree_add_node( ecl_grav_tree_type * tree , int begin , int end , int depth) {
+  int node_index = tree->num_nodes;
+  double min[3] , max[3];
+  int split_axis = 0;
+
+  if (tree->num_nodes == tree->alloc_size) {
+    tree->alloc_size = 2 * tree->alloc_size + 16;
+    tree->nodes = util_realloc( tree->nodes , tree->alloc_size * sizeof * tree->nodes );
+  }
+  tree->num_nodes++;
+
+  min[0] = max[0] = tree->xpos[begin];
+  min[1] = max[1] = tree->ypos[begin];
+  min[2] = max[2] = tree->zpos[begin];
+  for (int i = begin + 1; i < end; i++) {
+    const double pos[3] = { tree->xpos[i] , tree->ypos[i] , tree->zpos[i] };
+    for (int axis = 0; axis < 3; axis++) {
+      if (pos[axis] < min[axis])
+        min[axis] = pos[axis];
+      else if (pos[axis] > max[axis])
+        max[axis] = pos[axis];
+    }
+  }
+
+  {
+    ecl_grav_tree_node_type * node = &tree->nodes[node_index];
+    for (int axis = 0; axis < 3; axis++) {
+      node->center[axis] = 0.5 * (min[axis] + max[axis]);
+      if ((max[axis] - min[axis]) > (max[split_axis] - min[split_axis]))
+        split_axis = axis;
+    }
+    node->size = sqrt( (max[0] - min[0])*(max[0] - min[0]) +
+                       (max[1] - min[1])*(max[1] - min[1]) +
+                       (max[2] - min[2])*(max[2] - min[2]) );
+    node->begin = begin;
+    node->end = end;
+    node->child[0] = -1;
+    node->child[1] = -1;
+  }
+
+  if (((end - begin) > ECL_GRAV_TREE_LEAF_SIZE) && (depth < ECL_GRAV_TREE_MAX_DEPTH / 2) && (max[split_axis] > min[split_axis])) {
+    const double * key = (split_axis == 0) ? tree->xpos : ((split_axis == 1) ? tree->ypos : tree->zpos);
+    int mid = begin + (end - begin) / 2;
+    int child0 , child1;
+
+    ecl_grav_tree_select( tree , key , begin , end , mid );
+    child0 = ecl_grav_tree_add_node( tree , begin , mid , depth + 1 );
+    child1 = ecl_grav_tree_add_node( tree , mid , end , depth + 1 );
+
+    /* The node table can have been reallocated by the recursive calls. */
+    tree->nodes[node_index].child[0] = child0;
+    tree->nodes[node_index].child[1] = child1;
+  }
+
+  return node_index;
+}
+
+
+ecl_grav_tree_type * ecl_grav_tree_alloc( const ecl_grid_cache_type * subset ) {
+  ecl_grav_tree_type * tree = util_malloc( sizeof * tree );
+  ecl_grav_common_block_type * block = util_malloc( sizeof * block );
+  int size = ecl_grid_cache_get_size( subset );
+
+  tree->subset       = subset;
+  tree->owned_subset = NULL;
+  tree->ref_count    = 0;
+  tree->size         = size;
+  tree->perm       = util_calloc( util_int_max( 1 , size ) , sizeof * tree->perm );
+  tree->xpos       = util_calloc( util_int_max( 1 , size ) , sizeof * tree->xpos );
+  tree->ypos       = util_calloc( util_int_max( 1 , size ) , sizeof * tree->ypos );
+  tree->zpos       = util_calloc( util_int_max( 1 , size ) , sizeof * tree->zpos );
+  tree->num_nodes  = 0;
+  tree->alloc_size = 0;
+  tree->nodes      = NULL;
+
+  for (int offset = 0; offset < size; offset += ECL_GRAV_COMMON_BLOCK_SIZE) {
+    int count = util_int_min( ECL_GRAV_COMMON_BLOCK_SIZE , size - offset );
+    ecl_grav_common_load_block( subset , offset , count , block );
+    for (int i = 0; i < count; i++) {
+      tree->perm[offset + i] = offset + i;
+      tree->xpos[offset + i] = block->xpos[i];
+      tree->ypos[offset + i] = block->ypos[i];
+      tree->zpos[offset + i] = block->zpos[i];
+    }
+  }
+  free( block );
+
+  if (size > 0)
+    ecl_grav_tree_add_node( tree , 0 , size , 0 );
+
+  return tree;
+}
+
+
+void ecl_grav_tree_free( ecl_grav_tree_type * tree ) {
+  if (tree->owned_subset)
+    ecl_grid_cache_free( tree->owned_subset );
+  free( tree->perm );
+  free( tree->xpos );
+  free( tree->ypos );
+  free( tree->zpos );
+  util_safe_free( tree->nodes );
+  free( tree );
+}
+
+
+static void ecl_grav_tree_free__( void * arg ) {
+  ecl_grav_tree_free( arg );
+}
+
+
+const ecl_grid_cache_type * ecl_grav_tree_get_subset( const ecl_grav_tree_type * tree ) {
+  return tree->subset;
+}
+
+
+static ecl_grav_tree_type * ecl_grav_common_find_tree( const vector_type * tree_list , const ecl_grid_cache_type * subset ) {
+  for (int i = 0; i < vector_get_size( tree_list ); i++) {
+    ecl_grav_tree_type * tree = vector_iget( tree_list , i );
+    if (tree->subset == subset)
+      return tree;
+  }
+  return NULL;
+}
+
+
+/*
+  Removes the oldest trees which are not in use until the list has at
+  most ECL_GRAV_COMMON_MAX_TREES trees - or all the trees are in use.
+  Must be called with the lock held.
+*/
+
+static void ecl_grav_common_evict_trees( vector_type * tree_list ) {
+  int i = 0;
+  while ((vector_get_size( tree_list ) > ECL_GRAV_COMMON_MAX_TREES) && (i < vector_get_size( tree_list ))) {
+    const ecl_grav_tree_type * tree = vector_iget_const( tree_list , i );
+    if (tree->ref_count == 0)
+      vector_idel( tree_list , i );
+    else
+      i++;
+  }
+}
+
+
+/*
+  Returns the tree for the cells in the region (all cells if region ==
+  NULL) which are not aquifer cells, the tree is created and added to
+  the tree_list if it is not already there. The tree holds a reference
+  to its subset, see ecl_grav_tree_get_subset(), so the subset is
+  shared with the other users of the same region and released
+  together with the tree.
+
+  The tree can be used until it is handed back with
+  ecl_grav_common_release_tree(). At most ECL_GRAV_COMMON_MAX_TREES
+  trees which are not in use are kept in the list; the oldest are
+  released when new regions are added, so a region which is edited
+  repeatedly does not accumulate trees.
+
+  The function can be called concurrently for the same tree_list. The
+  tree is built without holding the lock; if another thread has added
+  a tree for the same subset in the meantime the new tree is
+  discarded.
+*/
+
+ecl_grav_tree_type * ecl_grav_common_acquire_tree( vector_type * tree_list , const ecl_grid_cache_type * grid_cache , ecl_region_type * region , const bool * aquifer) {
+  ecl_grid_cache_type * subset = ecl_grav_common_alloc_subset( grid_cache , region , aquifer );
+  ecl_grav_tree_type * tree;
+
+  ECL_GRAV_COMMON_LOCK();
+  tree = ecl_grav_common_find_tree( tree_list , subset );
+  if (tree)
+    tree->ref_count++;
+  ECL_GRAV_COMMON_UNLOCK();
+
+  if (tree == NULL) {
+    ecl_grav_tree_type * new_tree = ecl_grav_tree_alloc( subset );
+    new_tree->owned_subset = subset;
+    subset = NULL;
+
+    ECL_GRAV_COMMON_LOCK();
+    tree = ecl_grav_common_find_tree( tree_list , new_tree->subset );
+    if (tree == NULL) {
+      vector_append_owned_ref( tree_list , new_tree , ecl_grav_tree_free__ );
+      tree = new_tree;
+      new_tree = NULL;
+    }
+    tree->ref_count++;
+    ecl_grav_common_evict_trees( tree_list );
+    ECL_GRAV_COMMON_UNLOCK();
+
+    if (new_tree)
+      ecl_grav_tree_free( new_tree );
+  }
+
+  /* The tree already holds a reference to the subset. */
+  if (subset)
+    ecl_grid_cache_free( subset );
+
+  return tree;
+}
+
+
+void ecl_grav_common_release_tree( ecl_grav_tree_type * tree ) {
+  ECL_GRAV_COMMON_LOCK();
+  tree->ref_count--;
+  ECL_GRAV_COMMON_UNLOCK();
+}
+
+
+/*
+  The moments of node n are stored as moments[10*n + ...]: the sum of
+  the weights, the first moments (x,y,z) and the second moments
+  (xx,yy,zz,xy,xz,yz) of the weights around the node center. They are
+  calculated bottom up; the moments of a parent are the moments of
+  the children shifted to the parent center.
+*/
+
+static double * ecl_grav_tree_alloc_moments( const ecl_grav_tree_type * tree , const double * tree_weight ) {
+  double * moments = util_calloc( util_int_max( 1 , ECL_GRAV_TREE_NUM_MOMENTS * tree->num_nodes ) , sizeof * moments );
+
+  for (int node_index = tree->num_nodes - 1; node_index >= 0; node_index--) {
+    const ecl_grav_tree_node_type * node = &tree->nodes[node_index];
+    double * m = &moments[ ECL_GRAV_TREE_NUM_MOMENTS * node_index ];
+
+    for (int k = 0; k < ECL_GRAV_TREE_NUM_MOMENTS; k++)
+      m[k] = 0;
+
+    if (node->child[0] < 0) {
+      for (int i = node->begin; i < node->end; i++) {
+        double w  = tree_weight[i];
+        double dx = tree->xpos[i] - node->center[0];
+        double dy = tree->ypos[i] - node->center[1];
+        double dz = tree->zpos[i] - node->center[2];
+
+        m[0] += w;
+        m[1] += w*dx;    m[2] += w*dy;    m[3] += w*dz;
+        m[4] += w*dx*dx; m[5] += w*dy*dy; m[6] += w*dz*dz;
+        m[7] += w*dx*dy; m[8] += w*dx*dz; m[9] += w*dy*dz;
+      }
+    } else {
+      for (int c = 0; c < 2; c++) {
+        const ecl_grav_tree_node_type * child = &tree->nodes[ node->child[c] ];
+        const double * cm = &moments[ ECL_GRAV_TREE_NUM_MOMENTS * node->child[c] ];
+        double tx = child->center[0] - node->center[0];
+        double ty = child->center[1] - node->center[1];
+        double tz = child->center[2] - node->center[2];
+
+        m[0] += cm[0];
+        m[1] += cm[1] + cm[0]*tx;
+        m[2] += cm[2] + cm[0]*ty;
+        m[3] += cm[3] + cm[0]*tz;
+        m[4] += cm[4] + 2*cm[1]*tx + cm[0]*tx*tx;
+        m[5] += cm[5] + 2*cm[2]*ty + cm[0]*ty*ty;
+        m[6] += cm[6] + 2*cm[3]*tz + cm[0]*tz*tz;
+        m[7] += cm[7] + cm[1]*ty + cm[2]*tx + cm[0]*tx*ty;
+        m[8] += cm[8] + cm[1]*tz + cm[3]*tx + cm[0]*tx*tz;
+        m[9] += cm[9] + cm[2]*tz + cm[3]*ty + cm[0]*ty*tz;
       }
     }
   }
+
+  return moments;
+}
+
+
+static double ecl_grav_tree_eval_far( const ecl_grav_tree_station_type * station , const double * center , const double * m , double dist) {
+  const double h = ECL_GRAV_TREE_FD_STEP * dist;
+  const double cx = center[0];
+  const double cy = center[1];
+  const double cz = center[2];
+  double f0 = ecl_grav_tree_kernel( station , cx , cy , cz );
+  double fx[2] , fy[2] , fz[2];
+  double fxy[4] , fxz[4] , fyz[4];
+
+  fx[0] = ecl_grav_tree_kernel( station , cx - h , cy , cz );
+  fx[1] = ecl_grav_tree_kernel( station , cx + h , cy , cz );
+  fy[0] = ecl_grav_tree_kernel( station , cx , cy - h , cz );
+  fy[1] = ecl_grav_tree_kernel( station , cx , cy + h , cz );
+  fz[0] = ecl_grav_tree_kernel( station , cx , cy , cz - h );
+  fz[1] = ecl_grav_tree_kernel( station , cx , cy , cz + h );
+
+  /* Order: (+,+) , (+,-) , (-,+) , (-,-). */
+  fxy[0] = ecl_grav_tree_kernel( station , cx + h , cy + h , cz );
+  fxy[1] = ecl_grav_tree_kernel( station , cx + h , cy - h , cz );
+  fxy[2] = ecl_grav_tree_kernel( station , cx - h , cy + h , cz );
+  fxy[3] = ecl_grav_tree_kernel( station , cx - h , cy - h , cz );
+  fxz[0] = ecl_grav_tree_kernel( station , cx + h , cy , cz + h );
+  fxz[1] = ecl_grav_tree_kernel( station , cx + h , cy , cz - h );
+  fxz[2] = ecl_grav_tree_kernel( station , cx - h , cy , cz + h );
+  fxz[3] = ecl_grav_tree_kernel( station , cx - h , cy , cz - h );
+  fyz[0] = ecl_grav_tree_kernel( station , cx , cy + h , cz + h );
+  fyz[1] = ecl_grav_tree_kernel( station , cx , cy + h , cz - h );
+  fyz[2] = ecl_grav_tree_kernel( station , cx , cy - h , cz + h );
+  fyz[3] = ecl_grav_tree_kernel( station , cx , cy - h , cz - h );
+
+  {
+    double gx  = (fx[1] - fx[0]) / (2*h);
+    double gy  = (fy[1] - fy[0]) / (2*h);
+    double gz  = (fz[1] - fz[0]) / (2*h);
+    double hxx = (fx[1] - 2*f0 + fx[0]) / (h*h);
+    double hyy = (fy[1] - 2*f0 + fy[0]) / (h*h);
+    double hzz = (fz[1] - 2*f0 + fz[0]) / (h*h);
+    double hxy = (fxy[0] - fxy[1] - fxy[2] + fxy[3]) / (4*h*h);
+    double hxz = (fxz[0] - fxz[1] - fxz[2] + fxz[3]) / (4*h*h);
+    double hyz = (fyz[0] - fyz[1] - fyz[2] + fyz[3]) / (4*h*h);
+
+    return m[0]*f0 +
+      m[1]*gx + m[2]*gy + m[3]*gz +
+      0.5*(m[4]*hxx + m[5]*hyy + m[6]*hzz) +
+      m[7]*hxy + m[8]*hxz + m[9]*hyz;
+  }
+}
+
+
+static double ecl_grav_tree_eval_station( const ecl_grav_tree_type * tree , const double * moments , const double * tree_weight ,
+                                          const ecl_grav_tree_station_type * station , double theta) {
+  int stack[ECL_GRAV_TREE_MAX_DEPTH + 2];
+  int stack_size = 0;
+  double sum = 0;
+
+  if (tree->num_nodes == 0)
+    return 0;
+
+  stack[stack_size++] = 0;
+  while (stack_size > 0) {
+    const ecl_grav_tree_node_type * node = &tree->nodes[ stack[--stack_size] ];
+    double dx = node->center[0] - station->utm_x;
+    double dy = node->center[1] - station->utm_y;
+    double dz;
+    double dist;
+
+    /*
+      For the geertsma kernel the depth of the station is relative to
+      the seabed, and the closest of the cells and their mirror images
+      above the seabed decides.
+    */
+    if (station->geertsma) {
+      double z = node->center[2] - station->seabed;
+      dz = util_double_min( fabs( z - station->depth ) , fabs( z + station->depth ));
+    } else
+      dz = node->center[2] - station->depth;
+    dist = sqrt( dx*dx + dy*dy + dz*dz );
+
+    if ((theta > 0) && (node->size < theta * dist))
+      sum += ecl_grav_tree_eval_far( station , node->center , &moments[ ECL_GRAV_TREE_NUM_MOMENTS * (node - tree->nodes) ] , dist );
+    else if (node->child[0] < 0) {
+      for (int i = node->begin; i < node->end; i++)
+        sum += tree_weight[i] * ecl_grav_tree_kernel( station , tree->xpos[i] , tree->ypos[i] , tree->zpos[i] );
+    } else {
+      stack[stack_size++] = node->child[1];
+      stack[stack_size++] = node->child[0];
+    }
+  }
+
   return sum;
 }
 
 
+typedef struct {
+  const ecl_grav_tree_type * tree;
+  const double             * moments;
+  const double             * tree_weight;
+  const double             * utm_x;
+  const double             * utm_y;
+  const double             * depth;
+  double                     poisson_ratio;
+  double                     seabed;
+  bool                       geertsma;
+  double                     theta;
+  double                   * result;
+} ecl_grav_tree_job_type;
+
+
+static void ecl_grav_tree_eval_range( void * arg , int begin , int end ) {
+  ecl_grav_tree_job_type * job = arg;
+  ecl_grav_tree_station_type station;
+
+  station.poisson_ratio = job->poisson_ratio;
+  station.seabed        = job->seabed;
+  station.geertsma      = job->geertsma;
+  for (int s = begin; s < end; s++) {
+    station.utm_x = job->utm_x[s];
+    station.utm_y = job->utm_y[s];
+    station.depth = job->depth[s];
+    job->result[s] = ecl_grav_tree_eval_station( job->tree , job->moments , job->tree_weight , &station , job->theta );
+  }
+}
+
+
+static void ecl_grav_tree_eval( const ecl_grav_tree_type * tree , const double * weight ,
+                                int num_stations , const double * utm_x , const double * utm_y , const double * depth ,
+                                double poisson_ratio , double seabed , bool geertsma , double theta , double * result) {
+  double * tree_weight = util_calloc( util_int_max( 1 , tree->size ) , sizeof * tree_weight );
+  double * moments;
+
+  if ((theta < 0) || (theta >= 1))
+    util_abort("%s: theta must be in [0,1) - got:%g \n",__func__ , theta);
+
+  for (int i = 0; i < tree->size; i++)
+    tree_weight[i] = weight[ tree->perm[i] ];
+  moments = ecl_grav_tree_alloc_moments( tree , tree_weight );
+
+  {
+    ecl_grav_tree_job_type job;
+    job.tree          = tree;
+    job.moments       = moments;
+    job.tree_weight   = tree_weight;
+    job.utm_x         = utm_x;
+    job.utm_y         = utm_y;
+    job.depth         = depth;
+    job.poisson_ratio = poisson_ratio;
+    job.seabed        = seabed;
+    job.geertsma      = geertsma;
+    job.theta         = theta;
+    job.result        = result;
+
+#ifdef ERT_HAVE_THREAD_POOL
+    {
+      int num_threads = 1;
+      if (num_stations >= ECL_GRAV_TREE_MIN_PARALLEL)
+        num_threads = util_int_min( util_get_num_cpu() , num_stations / (ECL_GRAV_TREE_MIN_PARALLEL / 2) );
+      thread_pool_run_range( ecl_grav_tree_eval_range , &job , num_stations , num_threads );
+    }
+#else
+    ecl_grav_tree_eval_range( &job , 0 , num_stations );
+#endif
+  }
+
+  free( moments );
+  free( tree_weight );
+}
+
+
+/**
+   Evaluates the biot-savart sum of ecl_grav_common_eval_biot_savart_subset()
+   for num_stations stations, with the weights in the order of the
+   subset the tree was created from. The stations are evaluated in
+   parallel; theta controls the accuracy, see above.
+*/
+
+void ecl_grav_common_eval_biot_savart_tree( const ecl_grav_tree_type * tree , const double * weight ,
+                                            int num_stations , const double * utm_x , const double * utm_y , const double * depth ,
+                                            double theta , double * result) {
+  ecl_grav_tree_eval( tree , weight , num_stations , utm_x , utm_y , depth , 0 , 0 , false , theta , result );
+}
+
+
+void ecl_grav_common_eval_geertsma_tree( const ecl_grav_tree_type * tree , const double * weight ,
+                                         int num_stations , const double * utm_x , const double * utm_y , const double * depth ,
+                                         double poisson_ratio , double seabed , double theta , double * result) {
+  ecl_grav_tree_eval( tree , weight , num_stations , utm_x , utm_y , depth , poisson_ratio , seabed , true , theta , result );
+}
@@ -22,10 +22,19 @@
 #include <stdbool.h>
 #include <math.h>
 
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <ert/util/ert_api_config.h>
 #include <ert/util/util.h>
+#include <ert/util/thread_pool.h>
 #include <ert/util/double_vector.h>
 #include <ert/util/int_vector.h>
 #include <ert/util/hash.h>
+#include <ert/util/str_hash.h>
 #include <ert/util/vector.h>
 #include <ert/util/stringlist.h>
 
@@ -33,8 +42,10 @@
 #include <ert/geometry/geo_polygon.h>
 
 #include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_dir.h>
 #include <ert/ecl/ecl_type.h>
 #include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_kernel.h>
 #include <ert/ecl/ecl_file.h>
 #include <ert/ecl/ecl_kw_magic.h>
 #include <ert/ecl/ecl_endian_flip.h>
@@ -705,6 +716,8 @@ static const float * ecl_grid_get_mapaxes( const ecl_grid_type * grid );
 
 #define ECL_GRID_ID       991010
 
+typedef struct ecl_grid_xy_index_struct ecl_grid_xy_index_type;
+
 struct ecl_grid_struct {
   UTIL_TYPE_ID_DECLARATION;
   int                   lgr_nr;        /* EGRID files: corresponds to item 4 in gridhead - 0 for the main grid.
@@ -715,6 +728,7 @@ struct ecl_grid_struct {
   int                   total_active;
   int                   total_active_fracture;
   bool                * visited;                /* internal helper struct used when searching for index - can be NULL. */
+  ecl_grid_xy_index_type ** xy_index;           /* Lazily built (x,y) search structures, see ecl_grid_get_xy_index() - can be NULL. */
   int                 * index_map;              /* this a list of nx*ny*nz elements, where value -1 means inactive cell .*/
   int                 * inv_index_map;          /* this is list of total_active elements - which point back to the index_map. */
 
@@ -738,7 +752,7 @@ struct ecl_grid_struct {
   */
   vector_type         * LGR_list;      /* a vector of ecl_grid instances for LGRs - the index corresponds to the order LGRs are read from file*/
   int_vector_type     * lgr_index_map; /* a vector that maps LGR-nr for EGRID files to index into the LGR_list.*/
-  hash_type           * LGR_hash;      /* a hash of pointers to ecl_grid instances - for name based lookup of lgr. */
+  str_hash_type       * LGR_hash;      /* a hash of pointers to ecl_grid instances - for name based lookup of lgr. */
   int                   parent_box[6]; /* integers i1,i2, j1,j2, k1,k2 of the parent grid region containing this lgr. the indices are inclusive - zero offset */
                                        /* not used yet .. */
 
@@ -1616,6 +1630,7 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid,
   grid->dualp_flag            = dualp_flag;
   grid->coord_kw              = NULL;
   grid->visited               = NULL;
+  grid->xy_index              = NULL;
   grid->inv_index_map         = NULL;
   grid->index_map             = NULL;
   grid->fracture_index_map    = NULL;
@@ -1652,7 +1667,7 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid,
   if (ECL_GRID_MAINGRID_LGR_NR == lgr_nr) {  /* this is the main grid */
     grid->LGR_list      = vector_alloc_new();
     grid->lgr_index_map = int_vector_alloc(0,0);
-    grid->LGR_hash      = hash_alloc();
+    grid->LGR_hash      = str_hash_alloc();
   } else {
     grid->LGR_list      = NULL;
     grid->lgr_index_map = NULL;
@@ -2171,7 +2186,7 @@ static void ecl_grid_init_mapaxes( ecl_grid_type * ecl_grid , bool apply_mapaxes
 static void ecl_grid_add_lgr( ecl_grid_type * main_grid , ecl_grid_type * lgr_grid) {
   vector_append_owned_ref( main_grid->LGR_list , lgr_grid , ecl_grid_free__);
   int_vector_iset(main_grid->lgr_index_map, lgr_grid->lgr_nr, vector_get_size(main_grid->LGR_list)-1);
-  hash_insert_ref( main_grid->LGR_hash , lgr_grid->name , lgr_grid);
+  str_hash_insert_ref( main_grid->LGR_hash , lgr_grid->name , lgr_grid);
 }
 
 
@@ -3655,6 +3670,20 @@ bool ecl_grid_file_dims( const char * grid_filename , const char * init_restart_
 
 
 
+/*
+  If the directory has already been scanned into a current ecl_dir
+  catalogue, e.g. when the summary files of the case were found, the
+  grid files are looked up there instead of with stat().
+*/
+
+static bool ecl_grid_case_file_exists( const ecl_dir_type * ecl_dir , const char * filename ) {
+  if (ecl_dir)
+    return ecl_dir_has_file( ecl_dir , filename );
+  else
+    return util_file_exists( filename );
+}
+
+
 char * ecl_grid_alloc_case_filename( const char * case_input ) {
   ecl_file_enum    file_type;
   bool             fmt_file;
@@ -3668,20 +3697,22 @@ char * ecl_grid_alloc_case_filename( const char * case_input ) {
     char * grid_file = NULL;
     char * path;
     char * basename;
+    ecl_dir_type * ecl_dir;
     util_alloc_file_components( case_input , &path , &basename , NULL);
+    ecl_dir = ecl_dir_alloc_shared_current( path );
     if ((file_type == ECL_OTHER_FILE) || (file_type == ECL_DATA_FILE)) {          /* Case 3 - only basename recognized */
       char * EGRID  = ecl_util_alloc_filename( path , basename , ECL_EGRID_FILE , false , -1);
       char * GRID   = ecl_util_alloc_filename( path , basename , ECL_GRID_FILE  , false , -1);
       char * FEGRID = ecl_util_alloc_filename( path , basename , ECL_EGRID_FILE , true  , -1);
       char * FGRID  = ecl_util_alloc_filename( path , basename , ECL_GRID_FILE  , true  , -1);
 
-      if (util_file_exists( EGRID ))
+      if (ecl_grid_case_file_exists( ecl_dir , EGRID ))
         grid_file = util_alloc_string_copy( EGRID );
-      else if (util_file_exists( GRID ))
+      else if (ecl_grid_case_file_exists( ecl_dir , GRID ))
         grid_file = util_alloc_string_copy( GRID );
-      else if (util_file_exists( FEGRID ))
+      else if (ecl_grid_case_file_exists( ecl_dir , FEGRID ))
         grid_file = util_alloc_string_copy( FEGRID );
-      else if (util_file_exists( FGRID ))
+      else if (ecl_grid_case_file_exists( ecl_dir , FGRID ))
         grid_file = util_alloc_string_copy( FGRID );
       /*
         else: could not find a GRID/EGRID.
@@ -3695,14 +3726,19 @@ char * ecl_grid_alloc_case_filename( const char * case_input ) {
       char * EGRID  = ecl_util_alloc_filename( path , basename , ECL_EGRID_FILE , fmt_file , -1);
       char * GRID   = ecl_util_alloc_filename( path , basename , ECL_GRID_FILE  , fmt_file , -1);
 
-      if (util_file_exists( EGRID ))
+      if (ecl_grid_case_file_exists( ecl_dir , EGRID ))
         grid_file = util_alloc_string_copy( EGRID );
-      else if (util_file_exists( GRID ))
+      else if (ecl_grid_case_file_exists( ecl_dir , GRID ))
         grid_file = util_alloc_string_copy( GRID );
 
       free( EGRID );
       free( GRID );
     }
+
+    if (ecl_dir)
+      ecl_dir_free( ecl_dir );
+    util_safe_free( path );
+    util_safe_free( basename );
     return grid_file;
   }
 }
@@ -4154,6 +4190,434 @@ bool ecl_grid_cell_contains_xyz1( const ecl_grid_type * ecl_grid , int global_in
   return ecl_grid_cell_contains_xyz3( ecl_grid , i,j,k,x ,y  , z);
 }
 
+/*****************************************************************/
+/*
+  Bulk operations over many cells or points are split in contiguous
+  ranges [begin,end) which are handled by a thread_pool when the
+  amount of work is large enough; the range function must only write
+  to the elements in its own range.
+*/
+
+#define ECL_GRID_MIN_PARALLEL 10000
+
+static void ecl_grid_run_range( thread_pool_range_ftype * func , void * arg , int num_items) {
+#ifdef ERT_HAVE_THREAD_POOL
+  int num_threads = 1;
+  if (num_items >= ECL_GRID_MIN_PARALLEL)
+    num_threads = util_int_min( util_get_num_cpu() , num_items / (ECL_GRID_MIN_PARALLEL / 2) );
+
+  thread_pool_run_range( func , arg , num_items , num_threads );
+#else
+  func( arg , 0 , num_items );
+#endif
+}
+
+
+/*****************************************************************/
+/*
+  Locating the cell which contains a point (x,y) in one layer of the
+  grid is done with a uniform bucket grid over the footprints of the
+  cells in that layer. The bucket grid spans the bounding box of the
+  layer and has (roughly) one bucket per cell; every cell is registered
+  in all the buckets its bounding box overlaps, in increasing (i,j)
+  order. A query looks up the bucket of the point and runs the exact
+  containment test on the cells registered there, so the result is
+  identical to the result of a linear scan through the layer.
+
+  There are two kinds of layers:
+
+   corner layer k: The quadrilaterals spanned by the corners returned
+      from ecl_grid_get_corner_xyz( grid , i , j , k ), for k in
+      [0,nz]. This is the layer used by ecl_grid_get_ij_from_xy().
+
+   cell face: The lower (corners 0-3) or upper (corners 4-7) face of
+      all the cells in layer k, as used by
+      ecl_grid_get_global_index_from_xy().
+
+  The search structures are built on first use and cached in the grid;
+  the grid geometry is immutable, so they are never invalidated. A
+  missing structure is built under a lock, and a structure which has
+  been built is read without locking.
+*/
+
+struct ecl_grid_xy_index_struct {
+  const ecl_grid_type * grid;
+  int                   k;
+  int                   corner_offset;   /* -1 for a corner layer, 0 (lower) or 4 (upper) for a cell face. */
+  int                   num_items;       /* nx*ny; the item i + j*nx is column (i,j). */
+  double                xmin , xmax , ymin , ymax;
+  double                x_scale , y_scale;
+  int                   bx , by;
+  int                 * bucket_offset;   /* bx*by + 1 elements. */
+  int                 * bucket_items;
+  double              * item_box;        /* xmin,xmax,ymin,ymax for each item. */
+  double              * corner_x;        /* (nx+1)*(ny+1) elements - only for corner layers. */
+  double              * corner_y;
+};
+
+
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t xy_index_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+static void ecl_grid_xy_index_corners( const ecl_grid_xy_index_type * index , int item , double * xlist , double * ylist) {
+  int nx = index->grid->nx;
+  int i = item % nx;
+  int j = item / nx;
+  int c = i + j * (nx + 1);
+
+  xlist[0] = index->corner_x[c];               ylist[0] = index->corner_y[c];
+  xlist[1] = index->corner_x[c + 1];           ylist[1] = index->corner_y[c + 1];
+  xlist[2] = index->corner_x[c + nx + 2];      ylist[2] = index->corner_y[c + nx + 2];
+  xlist[3] = index->corner_x[c + nx + 1];      ylist[3] = index->corner_y[c + nx + 1];
+}
+
+
+/*
+  The containment test in triangle_contains() accepts points which are
+  within a small tolerance outside the cell face; the bounding box of
+  the face is padded correspondingly, using the shortest edge of the
+  face.
+*/
+
+static bool ecl_grid_xy_index_item_box( const ecl_grid_xy_index_type * index , int item , double * box) {
+  double xlist[4] , ylist[4];
+  double pad = 0;
+
+  if (index->corner_offset < 0)
+    ecl_grid_xy_index_corners( index , item , xlist , ylist );
+  else {
+    const ecl_grid_type * grid = index->grid;
+    const ecl_cell_type * cell = &grid->cells[ item + index->k * grid->nx * grid->ny ];
+    double min_edge = -1;
+    int c;
+
+    if (GET_CELL_FLAG(cell , CELL_FLAG_TAINTED))
+      return false;
+
+    for (c = 0; c < 4; c++) {
+      xlist[c] = cell->corner_list[index->corner_offset + c].x;
+      ylist[c] = cell->corner_list[index->corner_offset + c].y;
+    }
+
+    {
+      static const int edges[6][2] = {{0,1},{0,2},{1,2},{1,3},{2,3},{0,3}};
+      int e;
+      for (e = 0; e < 6; e++) {
+        double length = hypot( xlist[edges[e][1]] - xlist[edges[e][0]] , ylist[edges[e][1]] - ylist[edges[e][0]]);
+        if ((length > 0) && ((min_edge < 0) || (length < min_edge)))
+          min_edge = length;
+      }
+    }
+    if (min_edge < 0)
+      return false;        /* All four corners coincide - contains nothing. */
+
+    pad = 4e-10 / min_edge;
+  }
+
+  box[0] = box[1] = xlist[0];
+  box[2] = box[3] = ylist[0];
+  {
+    int c;
+    for (c = 1; c < 4; c++) {
+      box[0] = util_double_min( box[0] , xlist[c] );
+      box[1] = util_double_max( box[1] , xlist[c] );
+      box[2] = util_double_min( box[2] , ylist[c] );
+      box[3] = util_double_max( box[3] , ylist[c] );
+    }
+  }
+  pad += 1e-12 * (fabs( box[0] ) + fabs( box[1] ) + fabs( box[2] ) + fabs( box[3] ));
+
+  box[0] -= pad;
+  box[1] += pad;
+  box[2] -= pad;
+  box[3] += pad;
+
+  return (isfinite( box[0] ) && isfinite( box[1] ) && isfinite( box[2] ) && isfinite( box[3] ));
+}
+
+
+static int ecl_grid_xy_index_bucket_x( const ecl_grid_xy_index_type * index , double x) {
+  int bucket = (int) floor( (x - index->xmin) * index->x_scale );
+  return util_int_max( 0 , util_int_min( index->bx - 1 , bucket ));
+}
+
+
+static int ecl_grid_xy_index_bucket_y( const ecl_grid_xy_index_type * index , double y) {
+  int bucket = (int) floor( (y - index->ymin) * index->y_scale );
+  return util_int_max( 0 , util_int_min( index->by - 1 , bucket ));
+}
+
+
+static ecl_grid_xy_index_type * ecl_grid_xy_index_alloc( const ecl_grid_type * grid , int k , int corner_offset) {
+  ecl_grid_xy_index_type * index = util_malloc( sizeof * index );
+  int num_items = grid->nx * grid->ny;
+  bool * valid = util_malloc( num_items * sizeof * valid );
+  bool empty = true;
+  int item;
+
+  index->grid          = grid;
+  index->k             = k;
+  index->corner_offset = corner_offset;
+  index->num_items     = num_items;
+  index->corner_x      = NULL;
+  index->corner_y      = NULL;
+  index->item_box      = util_malloc( 4 * num_items * sizeof * index->item_box );
+  index->xmin = index->xmax = index->ymin = index->ymax = 0;
+
+  if (corner_offset < 0) {
+    int num_corners = (grid->nx + 1) * (grid->ny + 1);
+    int i , j;
+
+    index->corner_x = util_malloc( num_corners * sizeof * index->corner_x );
+    index->corner_y = util_malloc( num_corners * sizeof * index->corner_y );
+    for (j = 0; j <= grid->ny; j++) {
+      for (i = 0; i <= grid->nx; i++) {
+        double z;
+        int c = i + j * (grid->nx + 1);
+        ecl_grid_get_corner_xyz( grid , i , j , k , &index->corner_x[c] , &index->corner_y[c] , &z );
+      }
+    }
+  }
+
+  for (item = 0; item < num_items; item++) {
+    double * box = &index->item_box[4 * item];
+    valid[item] = ecl_grid_xy_index_item_box( index , item , box );
+    if (valid[item]) {
+      if (empty) {
+        index->xmin = box[0]; index->xmax = box[1];
+        index->ymin = box[2]; index->ymax = box[3];
+        empty = false;
+      } else {
+        index->xmin = util_double_min( index->xmin , box[0] );
+        index->xmax = util_double_max( index->xmax , box[1] );
+        index->ymin = util_double_min( index->ymin , box[2] );
+        index->ymax = util_double_max( index->ymax , box[3] );
+      }
+    }
+  }
+
+  if (empty) {
+    /* No cell in the layer can contain anything; the bounds are chosen so that every query is rejected. */
+    index->xmin = index->ymin = 1;
+    index->xmax = index->ymax = 0;
+  }
+
+  index->bx = util_int_max( 1 , grid->nx );
+  index->by = util_int_max( 1 , grid->ny );
+  index->x_scale = (index->xmax > index->xmin) ? index->bx / (index->xmax - index->xmin) : 0;
+  index->y_scale = (index->ymax > index->ymin) ? index->by / (index->ymax - index->ymin) : 0;
+
+  {
+    int num_buckets = index->bx * index->by;
+    int * fill = util_malloc( num_buckets * sizeof * fill );
+    int b;
+
+    index->bucket_offset = util_malloc( (num_buckets + 1) * sizeof * index->bucket_offset );
+    for (b = 0; b <= num_buckets; b++)
+      index->bucket_offset[b] = 0;
+
+    /* Pass 1: count the items in each bucket. */
+    for (item = 0; item < num_items; item++) {
+      if (valid[item]) {
+        const double * box = &index->item_box[4 * item];
+        int bx1 = ecl_grid_xy_index_bucket_x( index , box[0] );
+        int bx2 = ecl_grid_xy_index_bucket_x( index , box[1] );
+        int by1 = ecl_grid_xy_index_bucket_y( index , box[2] );
+        int by2 = ecl_grid_xy_index_bucket_y( index , box[3] );
+        int ix , iy;
+
+        for (iy = by1; iy <= by2; iy++)
+          for (ix = bx1; ix <= bx2; ix++)
+            index->bucket_offset[ ix + iy * index->bx + 1 ]++;
+      }
+    }
+
+    for (b = 0; b < num_buckets; b++) {
+      index->bucket_offset[b + 1] += index->bucket_offset[b];
+      fill[b] = index->bucket_offset[b];
+    }
+
+    /* Pass 2: fill the buckets; the items end up in increasing order within each bucket. */
+    index->bucket_items = util_malloc( util_int_max( 1 , index->bucket_offset[num_buckets] ) * sizeof * index->bucket_items );
+    for (item = 0; item < num_items; item++) {
+      if (valid[item]) {
+        const double * box = &index->item_box[4 * item];
+        int bx1 = ecl_grid_xy_index_bucket_x( index , box[0] );
+        int bx2 = ecl_grid_xy_index_bucket_x( index , box[1] );
+        int by1 = ecl_grid_xy_index_bucket_y( index , box[2] );
+        int by2 = ecl_grid_xy_index_bucket_y( index , box[3] );
+        int ix , iy;
+
+        for (iy = by1; iy <= by2; iy++)
+          for (ix = bx1; ix <= bx2; ix++) {
+            int bucket = ix + iy * index->bx;
+            index->bucket_items[ fill[bucket] ] = item;
+            fill[bucket]++;
+          }
+      }
+    }
+    free( fill );
+  }
+
+  free( valid );
+  return index;
+}
+
+
+static void ecl_grid_xy_index_free( ecl_grid_xy_index_type * index ) {
+  free( index->bucket_offset );
+  free( index->bucket_items );
+  free( index->item_box );
+  util_safe_free( index->corner_x );
+  util_safe_free( index->corner_y );
+  free( index );
+}
+
+
+/*
+  Returns the item, i.e. i + j*nx, of the first column in the layer
+  which contains the point (x,y); -1 if no column contains the point.
+*/
+
+static int ecl_grid_xy_index_find( const ecl_grid_xy_index_type * index , double x , double y) {
+  if (!((x >= index->xmin) && (x <= index->xmax) && (y >= index->ymin) && (y <= index->ymax)))
+    return -1;
+  {
+    int bucket = ecl_grid_xy_index_bucket_x( index , x ) + ecl_grid_xy_index_bucket_y( index , y ) * index->bx;
+    int pos;
+
+    for (pos = index->bucket_offset[bucket]; pos < index->bucket_offset[bucket + 1]; pos++) {
+      int item = index->bucket_items[pos];
+      const double * box = &index->item_box[4 * item];
+
+      if ((x < box[0]) || (x > box[1]) || (y < box[2]) || (y > box[3]))
+        continue;
+
+      if (index->corner_offset < 0) {
+        double xlist[4] , ylist[4];
+        ecl_grid_xy_index_corners( index , item , xlist , ylist );
+        if (geo_util_inside_polygon__( xlist , ylist , 4 , x , y , true ))
+          return item;
+      } else {
+        const ecl_grid_type * grid = index->grid;
+        const ecl_cell_type * cell = &grid->cells[ item + index->k * grid->nx * grid->ny ];
+        if (ecl_cell_layer_contains_xy( cell , index->corner_offset == 0 , x , y ))
+          return item;
+      }
+    }
+  }
+  return -1;
+}
+
+
+/*
+  The slots of the grid->xy_index table are the corner layers [0,nz],
+  followed by the lower and upper face of each cell layer.
+*/
+
+static ecl_grid_xy_index_type * ecl_grid_get_xy_index( const ecl_grid_type * ecl_grid , int k , int corner_offset) {
+  /* The search structures are a cache; they are attached to the otherwise const grid. */
+  ecl_grid_type * grid = (ecl_grid_type *) ecl_grid;
+  int num_slots = 3 * grid->nz + 1;
+  int slot;
+  ecl_grid_xy_index_type * index;
+
+  if (corner_offset < 0) {
+    if ((k < 0) || (k > grid->nz))
+      util_abort("%s: invalid k value:%d  Valid range: [0,%d] \n",__func__ , k , grid->nz);
+    slot = k;
+  } else {
+    if ((k < 0) || (k >= grid->nz))
+      util_abort("%s: invalid k value:%d  Valid range: [0,%d) \n",__func__ , k , grid->nz);
+    slot = grid->nz + 1 + 2*k + (corner_offset == 0 ? 0 : 1);
+  }
+
+  /*
+    Double checked publication: an index which has been built is found
+    without locking; the lock is only taken to build a missing index.
+  */
+  {
+    ecl_grid_xy_index_type ** table = __atomic_load_n( &grid->xy_index , __ATOMIC_ACQUIRE );
+    if (table != NULL) {
+      index = __atomic_load_n( &table[slot] , __ATOMIC_ACQUIRE );
+      if (index != NULL)
+        return index;
+    }
+  }
+
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock( &xy_index_lock );
+#endif
+  if (grid->xy_index == NULL) {
+    ecl_grid_xy_index_type ** table = util_malloc( num_slots * sizeof * table );
+    int s;
+    for (s = 0; s < num_slots; s++)
+      table[s] = NULL;
+    __atomic_store_n( &grid->xy_index , table , __ATOMIC_RELEASE );
+  }
+
+  index = grid->xy_index[slot];
+  if (index == NULL) {
+    index = ecl_grid_xy_index_alloc( grid , k , corner_offset );
+    __atomic_store_n( &grid->xy_index[slot] , index , __ATOMIC_RELEASE );
+  }
+#ifdef HAVE_PTHREAD
+  pthread_mutex_unlock( &xy_index_lock );
+#endif
+
+  return index;
+}
+
+
+static void ecl_grid_free_xy_index( ecl_grid_type * grid ) {
+  if (grid->xy_index != NULL) {
+    int num_slots = 3 * grid->nz + 1;
+    int slot;
+    for (slot = 0; slot < num_slots; slot++)
+      if (grid->xy_index[slot] != NULL)
+        ecl_grid_xy_index_free( grid->xy_index[slot] );
+    free( grid->xy_index );
+  }
+}
+
+
+typedef struct {
+  const ecl_grid_xy_index_type * index;
+  const double                 * x;
+  const double                 * y;
+  int                          * item;
+} ecl_grid_xy_find_type;
+
+
+static void ecl_grid_xy_find_range( void * arg , int begin , int end) {
+  ecl_grid_xy_find_type * find = arg;
+  int p;
+  for (p = begin; p < end; p++)
+    find->item[p] = ecl_grid_xy_index_find( find->index , find->x[p] , find->y[p] );
+}
+
+
+/*
+  Looks up num_points points in the index; the result for point p is
+  stored in item[p]. Returns the number of points found.
+*/
+
+static int ecl_grid_xy_index_find_list( const ecl_grid_xy_index_type * index , int num_points , const double * x , const double * y , int * item) {
+  ecl_grid_xy_find_type find = { index , x , y , item };
+  int found = 0;
+  int p;
+
+  ecl_grid_run_range( ecl_grid_xy_find_range , &find , num_points );
+  for (p = 0; p < num_points; p++)
+    if (item[p] >= 0)
+      found++;
+
+  return found;
+}
+
+
 /**
    This function returns the global index for the cell (in layer 'k')
    which contains the point x,y. Observe that if you are looking for
@@ -4161,15 +4625,33 @@ bool ecl_grid_cell_contains_xyz1( const ecl_grid_type * ecl_grid , int global_in
 */
 
 int ecl_grid_get_global_index_from_xy( const ecl_grid_type * ecl_grid , int k , bool lower_layer , double x , double y) {
+  const ecl_grid_xy_index_type * index = ecl_grid_get_xy_index( ecl_grid , k , lower_layer ? 0 : 4 );
+  int item = ecl_grid_xy_index_find( index , x , y );
+  if (item >= 0)
+    return item + k * ecl_grid->nx * ecl_grid->ny;
+  else
+    return -1; /* Did not find x,y */
+}
 
-  int i,j;
-  for (j=0; j < ecl_grid->ny; j++)
-    for (i=0; i < ecl_grid->nx; i++) {
-      int global_index = ecl_grid_get_global_index3( ecl_grid , i , j , k );
-      if (ecl_cell_layer_contains_xy( ecl_grid_get_cell( ecl_grid , global_index ) , lower_layer , x , y))
-        return global_index;
-    }
-  return -1; /* Did not find x,y */
+
+/**
+   Batched version of ecl_grid_get_global_index_from_xy(): the global
+   index of the cell containing (x[p],y[p]) is stored in
+   global_index[p], -1 if the point is not in the layer. Large batches
+   are evaluated in parallel. Returns the number of points found.
+*/
+
+int ecl_grid_get_global_index_from_xy_list( const ecl_grid_type * ecl_grid , int k , bool lower_layer , int num_points , const double * x , const double * y , int * global_index) {
+  const ecl_grid_xy_index_type * index = ecl_grid_get_xy_index( ecl_grid , k , lower_layer ? 0 : 4 );
+  int offset = k * ecl_grid->nx * ecl_grid->ny;
+  int found = ecl_grid_xy_index_find_list( index , num_points , x , y , global_index );
+  int p;
+
+  for (p = 0; p < num_points; p++)
+    if (global_index[p] >= 0)
+      global_index[p] += offset;
+
+  return found;
 }
 
 
@@ -4311,88 +4793,44 @@ bool ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , doub
 }
 
 
-static bool ecl_grid_sublayer_contanins_xy__(const ecl_grid_type * grid , double x , double y , int k , int i1 , int i2 , int j1 , int j2, geo_polygon_type * polygon) {
-  int i,j;
-
-  geo_polygon_reset( polygon );
-
-  /* Bottom edge */
-  for (i=i1; i < i2; i++) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i , j1 , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
-  }
-
-  /* Right edge */
-  for (j=j1; j < j2; j++) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i2 , j , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
-  }
-
-  /* Top edge */
-  for (i=i2; i > i1; i--) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i , j2 , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
-  }
+/**
+   Finds the column (i,j) which contains the point (x,y) in the corner
+   layer k, i.e. the layer of corners returned from
+   ecl_grid_get_corner_xyz( grid , i , j , k ) with k in [0,nz]. The
+   function returns false if the point is outside the layer.
+*/
 
-  /* Left edge */
-  for (j=j2; j > j1; j--) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i1 , j , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
-  }
-  geo_polygon_close( polygon );
-  return geo_polygon_contains_point__( polygon , x  , y , true );
+bool ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j) {
+  const ecl_grid_xy_index_type * index = ecl_grid_get_xy_index( grid , k , -1 );
+  int item = ecl_grid_xy_index_find( index , x , y );
+  if (item >= 0) {
+    *i = item % grid->nx;
+    *j = item / grid->nx;
+    return true;
+  } else
+    return false;
 }
 
 
+/**
+   Batched version of ecl_grid_get_ij_from_xy(); points which are not
+   in the layer get i[p] = j[p] = -1. Large batches are evaluated in
+   parallel. Returns the number of points found.
+*/
 
-bool ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j) {
-  geo_polygon_type * polygon = geo_polygon_alloc( NULL );
-  int nx = ecl_grid_get_nx( grid );
-  int ny = ecl_grid_get_ny( grid );
-  bool inside = ecl_grid_sublayer_contanins_xy__(grid , x , y , k , 0 , nx , 0 , ny , polygon);
-  if (inside) {
-    int i1 = 0;
-    int i2 = nx;
-    int j1 = 0;
-    int j2 = ny;
+int ecl_grid_get_ij_from_xy_list( const ecl_grid_type * grid , int k , int num_points , const double * x , const double * y , int * i , int * j) {
+  const ecl_grid_xy_index_type * index = ecl_grid_get_xy_index( grid , k , -1 );
+  int found = ecl_grid_xy_index_find_list( index , num_points , x , y , i );
+  int p;
 
-    while (true) {
-      if ((i2 - i1) > 1) {
-        int ic = (i1 + i2) / 2;
-        if (ecl_grid_sublayer_contanins_xy__(grid , x , y , k , i1 , ic , j1 , j2 , polygon))
-          i2 = ic;
-        else {
-          if (!ecl_grid_sublayer_contanins_xy__(grid , x , y , k , ic , i2 , j1 , j2 , polygon))
-            util_abort("%s: point nowhere to be found ... \n",__func__);
-          i1 = ic;
-        }
-      }
-
-      if ((j2 - j1) > 1) {
-        int jc = (j1 + j2) / 2;
-        if (ecl_grid_sublayer_contanins_xy__(grid , x , y , k , i1 , i2 , j1 , jc , polygon))
-          j2 = jc;
-        else {
-          if (!ecl_grid_sublayer_contanins_xy__(grid , x , y , k , i1 , i2 , jc , j2 , polygon))
-            util_abort("%s: point nowhere to be found ... \n",__func__);
-          j1 = jc;
-        }
-      }
-
-      if ((i2 - i1) == 1 && (j2 - j1) == 1) {
-        *i = i1;
-        *j = j1;
-        break;
-      }
-    }
+  for (p = 0; p < num_points; p++) {
+    if (i[p] >= 0) {
+      j[p] = i[p] / grid->nx;
+      i[p] = i[p] % grid->nx;
+    } else
+      j[p] = -1;
   }
-
-  geo_polygon_free( polygon );
-  return inside;
+  return found;
 }
 
 
@@ -4473,7 +4911,7 @@ void ecl_grid_free(ecl_grid_type * grid) {
   if (ECL_GRID_MAINGRID_LGR_NR == grid->lgr_nr) { /* This is the main grid. */
     vector_free( grid->LGR_list );
     int_vector_free( grid->lgr_index_map);
-    hash_free( grid->LGR_hash );
+    str_hash_free( grid->LGR_hash );
   }
   if (grid->coord_kw != NULL)
     ecl_kw_free( grid->coord_kw );
@@ -4482,6 +4920,7 @@ void ecl_grid_free(ecl_grid_type * grid) {
   hash_free( grid->children );
   util_safe_free( grid->parent_name );
   util_safe_free( grid->visited );
+  ecl_grid_free_xy_index( grid );
   util_safe_free( grid->name );
   free( grid );
 }
@@ -5117,7 +5556,7 @@ ecl_grid_type * ecl_grid_get_lgr(const ecl_grid_type * main_grid, const char * _
   __assert_main_grid( main_grid );
   {
     char * lgr_name          = util_alloc_strip_copy( __lgr_name );
-    ecl_grid_type * lgr_grid = hash_get(main_grid->LGR_hash , lgr_name);
+    ecl_grid_type * lgr_grid = str_hash_get(main_grid->LGR_hash , lgr_name);
     free(lgr_name);
     return lgr_grid;
   }
@@ -5136,7 +5575,7 @@ bool ecl_grid_has_lgr(const ecl_grid_type * main_grid, const char * __lgr_name)
   __assert_main_grid( main_grid );
   {
     char * lgr_name          = util_alloc_strip_copy( __lgr_name );
-    bool has_lgr             = hash_has_key( main_grid->LGR_hash , lgr_name );
+    bool has_lgr             = str_hash_has_key( main_grid->LGR_hash , lgr_name );
     free(lgr_name);
     return has_lgr;
   }
@@ -5258,7 +5697,7 @@ const ecl_grid_type * ecl_grid_get_global_grid( const ecl_grid_type * grid ) {
 stringlist_type * ecl_grid_alloc_lgr_name_list(const ecl_grid_type * ecl_grid) {
   __assert_main_grid( ecl_grid );
   {
-    return hash_alloc_stringlist( ecl_grid->LGR_hash );
+    return str_hash_alloc_stringlist( ecl_grid->LGR_hash );
   }
 }
 
@@ -5376,6 +5815,50 @@ double ecl_grid_get_cell_volume1A( const ecl_grid_type * ecl_grid, int active_in
 }
 
 
+typedef struct {
+  const ecl_grid_type * grid;
+  const int           * global_index;
+  double              * xpos;
+  double              * ypos;
+  double              * zpos;
+  double              * volume;
+} ecl_grid_cell_export_type;
+
+
+static void ecl_grid_export_cell_centers_range( void * arg , int begin , int end) {
+  ecl_grid_cell_export_type * cells = arg;
+  int index;
+  for (index = begin; index < end; index++)
+    ecl_grid_get_xyz1( cells->grid , cells->global_index[index] , &cells->xpos[index] , &cells->ypos[index] , &cells->zpos[index] );
+}
+
+
+static void ecl_grid_export_cell_volumes_range( void * arg , int begin , int end) {
+  ecl_grid_cell_export_type * cells = arg;
+  int index;
+  for (index = begin; index < end; index++)
+    cells->volume[index] = ecl_cell_get_volume( ecl_grid_get_cell( cells->grid , cells->global_index[index] ));
+}
+
+
+/**
+   Bulk versions of ecl_grid_get_xyz1() and ecl_grid_get_cell_volume1()
+   for the num_cells cells in the global_index list; large lists are
+   evaluated in parallel.
+*/
+
+void ecl_grid_export_cell_centers( const ecl_grid_type * grid , int num_cells , const int * global_index , double * xpos , double * ypos , double * zpos) {
+  ecl_grid_cell_export_type cells = { grid , global_index , xpos , ypos , zpos , NULL };
+  ecl_grid_run_range( ecl_grid_export_cell_centers_range , &cells , num_cells );
+}
+
+
+void ecl_grid_export_cell_volumes( const ecl_grid_type * grid , int num_cells , const int * global_index , double * volume) {
+  ecl_grid_cell_export_type cells = { grid , global_index , NULL , NULL , NULL , volume };
+  ecl_grid_run_range( ecl_grid_export_cell_volumes_range , &cells , num_cells );
+}
+
+
 
 double ecl_grid_get_cell_volume1_tskille( const ecl_grid_type * ecl_grid, int global_index ) {
   ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
@@ -5699,7 +6182,7 @@ void ecl_grid_grdecl_fprintf_kw( const ecl_grid_type * ecl_grid , const ecl_kw_t
       util_abort("%s: invalid type \n",__func__);
 
     {
-      ecl_kw_type * tmp_kw = ecl_kw_alloc_scatter_copy( ecl_kw , ecl_grid->size , ecl_grid->inv_index_map , default_ptr );
+      ecl_kw_type * tmp_kw = ecl_kw_alloc_scatter_copy_distinct( ecl_kw , ecl_grid->size , ecl_grid->inv_index_map , default_ptr );
       ecl_kw_fprintf_grdecl__( tmp_kw , special_header , stream );
       ecl_kw_free( tmp_kw );
     }
@@ -6447,33 +6930,212 @@ ecl_kw_type * ecl_grid_alloc_actnum_kw( const ecl_grid_type * grid ) {
 }
 
 
+/*
+  The copy and export functions below move the data through the
+  inv_index_map / inv_fracture_index_map of the grid with the gather
+  and scatter kernels from ecl_kw_kernel.c, i.e. without testing the
+  active status and calling ecl_kw_iset() for every cell. The
+  inv_index_map has one entry per active cell, also for grids with
+  coarse groups, and the entries are distinct.
+*/
+
 void ecl_grid_compressed_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw) {
   if ((ecl_kw_get_size( target_kw ) == ecl_grid_get_nactive(grid)) && (ecl_kw_get_size( src_kw ) == ecl_grid_get_global_size(grid))) {
-    int active_index = 0;
-    int global_index;
-    for (global_index = 0; global_index < ecl_grid_get_global_size( grid ); global_index++) {
-      if (ecl_grid_cell_active1(grid, global_index)) {
-        ecl_kw_iset( target_kw , active_index , ecl_kw_iget_ptr(src_kw , global_index));
-        active_index++;
-      }
-    }
+    if (!ecl_type_is_equal( ecl_kw_get_data_type( target_kw ) , ecl_kw_get_data_type( src_kw )))
+      util_abort("%s: type mismatch between %s and %s \n",__func__ , ecl_kw_get_header( target_kw ) , ecl_kw_get_header( src_kw ));
+
+    ecl_kw_kernel_gather( ecl_kw_get_void_ptr( target_kw ) , ecl_kw_get_void_ptr( src_kw ) , ecl_kw_get_sizeof_ctype( src_kw ) , grid->inv_index_map , grid->total_active );
   } else
-    util_abort("%s: size mismatch target:%d  src:%d  expected %d,%d \n",ecl_kw_get_size( target_kw ), ecl_kw_get_size( src_kw ) , ecl_grid_get_nactive(grid) , ecl_grid_get_global_size(grid));
+    util_abort("%s: size mismatch target:%d  src:%d  expected %d,%d \n",__func__ , ecl_kw_get_size( target_kw ), ecl_kw_get_size( src_kw ) , ecl_grid_get_nactive(grid) , ecl_grid_get_global_size(grid));
 }
 
 
 void ecl_grid_global_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw) {
   if ((ecl_kw_get_size( src_kw ) == ecl_grid_get_nactive(grid)) && (ecl_kw_get_size( target_kw ) == ecl_grid_get_global_size(grid))) {
-    int active_index = 0;
-    int global_index;
-    for (global_index = 0; global_index < ecl_grid_get_global_size( grid ); global_index++) {
-      if (ecl_grid_cell_active1(grid, global_index)) {
-        ecl_kw_iset( target_kw , global_index , ecl_kw_iget_ptr(src_kw , active_index));
-        active_index++;
-      }
-    }
+    if (!ecl_type_is_equal( ecl_kw_get_data_type( target_kw ) , ecl_kw_get_data_type( src_kw )))
+      util_abort("%s: type mismatch between %s and %s \n",__func__ , ecl_kw_get_header( target_kw ) , ecl_kw_get_header( src_kw ));
+
+    ecl_kw_kernel_scatter( ecl_kw_get_void_ptr( target_kw ) , ecl_kw_get_void_ptr( src_kw ) , ecl_kw_get_sizeof_ctype( src_kw ) , grid->inv_index_map , grid->total_active );
   } else
-    util_abort("%s: size mismatch target:%d  src:%d  expected %d,%d \n",ecl_kw_get_size( target_kw ), ecl_kw_get_size( src_kw ) , ecl_grid_get_global_size(grid), ecl_grid_get_nactive(grid));
+    util_abort("%s: size mismatch target:%d  src:%d  expected %d,%d \n",__func__ , ecl_kw_get_size( target_kw ), ecl_kw_get_size( src_kw ) , ecl_grid_get_global_size(grid), ecl_grid_get_nactive(grid));
+}
+
+
+/*
+  Direct access to the index maps, for callers which want to do their
+  own gather / scatter. The fracture maps are NULL for single porosity
+  grids. The pointers are owned by the grid.
+*/
+
+const int * ecl_grid_get_index_map_ptr( const ecl_grid_type * grid ) {
+  return grid->index_map;
+}
+
+const int * ecl_grid_get_inv_index_map_ptr( const ecl_grid_type * grid ) {
+  return grid->inv_index_map;
+}
+
+const int * ecl_grid_get_fracture_index_map_ptr( const ecl_grid_type * grid ) {
+  return grid->fracture_index_map;
+}
+
+const int * ecl_grid_get_inv_fracture_index_map_ptr( const ecl_grid_type * grid ) {
+  return grid->inv_fracture_index_map;
+}
+
+
+/*
+  The ecl_grid_export_kw_xxx() and ecl_grid_import_kw_global()
+  functions copy numeric keyword data to / from caller supplied
+  buffers with elements of the keyword type; the keyword can have
+  either nactive or nx*ny*nz elements. These are used to fill numpy
+  arrays from Python without a per element function call.
+
+  For dual porosity grids the keywords in the restart and init files
+  have nactive + nactive_fracture elements, with the fracture values
+  after the matrix values. ecl_grid_export_kw_global() will export the
+  matrix part of such a keyword and ecl_grid_export_fracture_kw_global()
+  the fracture part.
+*/
+
+static void ecl_grid_assert_export_kw( const ecl_grid_type * grid , const ecl_kw_type * kw , const char * caller) {
+  int size = ecl_kw_get_size( kw );
+  if (!ecl_type_is_numeric( ecl_kw_get_data_type( kw )))
+    util_abort("%s: only numeric keywords can be exported \n",caller);
+
+  if ((size != grid->total_active) && (size != grid->size))
+    util_abort("%s: size mismatch for %s: %d  - expected %d or %d \n",caller , ecl_kw_get_header( kw ) , size , grid->total_active , grid->size);
+}
+
+
+static void ecl_grid_assert_export_dual_kw( const ecl_grid_type * grid , const ecl_kw_type * kw , const char * caller) {
+  int size = ecl_kw_get_size( kw );
+  if (!ecl_type_is_numeric( ecl_kw_get_data_type( kw )))
+    util_abort("%s: only numeric keywords can be exported \n",caller);
+
+  if ((size != grid->total_active) && (size != grid->size) && (size != grid->total_active + grid->total_active_fracture))
+    util_abort("%s: size mismatch for %s: %d  - expected %d, %d or %d \n",caller , ecl_kw_get_header( kw ) , size ,
+               grid->total_active , grid->total_active + grid->total_active_fracture , grid->size);
+}
+
+
+static void ecl_grid_fill_default( const ecl_grid_type * grid , ecl_data_type data_type , double default_value , void * global_data) {
+  int global_index;
+  if (ecl_type_is_int( data_type )) {
+    int * data = global_data;
+    for (global_index = 0; global_index < grid->size; global_index++)
+      data[global_index] = (int) default_value;
+  } else if (ecl_type_is_float( data_type )) {
+    float * data = global_data;
+    for (global_index = 0; global_index < grid->size; global_index++)
+      data[global_index] = (float) default_value;
+  } else {
+    double * data = global_data;
+    for (global_index = 0; global_index < grid->size; global_index++)
+      data[global_index] = default_value;
+  }
+}
+
+
+/*
+  Common implementation of the global exports; the keywords in
+  @kw_list which are already global are copied directly, the others
+  are scattered in one batch, starting at element @src_offset.
+*/
+
+static void ecl_grid_export_kw_list_global__( const ecl_grid_type * grid , int num_kw , const ecl_kw_type ** kw_list , double default_value , void ** global_data ,
+                                              const int * inv_map , int nactive , int src_offset) {
+  void ** target = util_calloc( num_kw , sizeof * target );
+  const void ** src = util_calloc( num_kw , sizeof * src );
+  int * element_size = util_calloc( num_kw , sizeof * element_size );
+  int num_scatter = 0;
+  int ikw;
+
+  for (ikw = 0; ikw < num_kw; ikw++) {
+    const ecl_kw_type * kw = kw_list[ikw];
+    const char * kw_data = ecl_kw_get_void_ptr( kw );
+    int sizeof_ctype = ecl_kw_get_sizeof_ctype( kw );
+
+    if ((ecl_kw_get_size( kw ) == grid->size) && (src_offset == 0))
+      memcpy( global_data[ikw] , kw_data , (size_t) grid->size * sizeof_ctype );
+    else {
+      ecl_grid_fill_default( grid , ecl_kw_get_data_type( kw ) , default_value , global_data[ikw] );
+      target[num_scatter] = global_data[ikw];
+      src[num_scatter] = &kw_data[ (size_t) src_offset * sizeof_ctype ];
+      element_size[num_scatter] = sizeof_ctype;
+      num_scatter++;
+    }
+  }
+
+  if (num_scatter > 0)
+    ecl_kw_kernel_scatter_list( num_scatter , target , src , element_size , inv_map , nactive );
+
+  free( element_size );
+  free( src );
+  free( target );
+}
+
+
+void ecl_grid_export_kw_global( const ecl_grid_type * grid , const ecl_kw_type * kw , double default_value , void * global_data) {
+  ecl_grid_assert_export_dual_kw( grid , kw , __func__ );
+  ecl_grid_export_kw_list_global__( grid , 1 , &kw , default_value , &global_data , grid->inv_index_map , grid->total_active , 0 );
+}
+
+
+void ecl_grid_export_fracture_kw_global( const ecl_grid_type * grid , const ecl_kw_type * kw , double default_value , void * global_data) {
+  if (grid->total_active_fracture == 0)
+    util_abort("%s: the grid does not have any active fracture cells \n",__func__);
+
+  if (ecl_kw_get_size( kw ) != grid->total_active + grid->total_active_fracture)
+    util_abort("%s: size mismatch for %s: %d  - expected %d \n",__func__ , ecl_kw_get_header( kw ) , ecl_kw_get_size( kw ) ,
+               grid->total_active + grid->total_active_fracture);
+
+  ecl_grid_assert_export_dual_kw( grid , kw , __func__ );
+  ecl_grid_export_kw_list_global__( grid , 1 , &kw , default_value , &global_data , grid->inv_fracture_index_map , grid->total_active_fracture , grid->total_active );
+}
+
+
+/*
+  Batched version of ecl_grid_export_kw_global(); the work for all the
+  keywords is split over the threads in one go, which is much better
+  than one call per keyword when a restart block with many small
+  fields is expanded to global size.
+*/
+
+void ecl_grid_export_kw_list_global( const ecl_grid_type * grid , int num_kw , const ecl_kw_type ** kw_list , double default_value , void ** global_data) {
+  int ikw;
+  for (ikw = 0; ikw < num_kw; ikw++)
+    ecl_grid_assert_export_dual_kw( grid , kw_list[ikw] , __func__ );
+
+  ecl_grid_export_kw_list_global__( grid , num_kw , kw_list , default_value , global_data , grid->inv_index_map , grid->total_active , 0 );
+}
+
+
+void ecl_grid_export_kw_active( const ecl_grid_type * grid , const ecl_kw_type * kw , void * active_data) {
+  const size_t element_size = ecl_kw_get_sizeof_ctype( kw );
+
+  ecl_grid_assert_export_kw( grid , kw , __func__ );
+  if (ecl_kw_get_size( kw ) == grid->total_active)
+    memcpy( active_data , ecl_kw_get_void_ptr( kw ) , grid->total_active * element_size );
+  else
+    ecl_kw_kernel_gather( active_data , ecl_kw_get_void_ptr( kw ) , element_size , grid->inv_index_map , grid->total_active );
+}
+
+
+/*
+  Will set the content of @kw from the nx*ny*nz elements in
+  @global_data; if @kw has nactive elements only the values of the
+  active cells are used.
+*/
+
+void ecl_grid_import_kw_global( const ecl_grid_type * grid , ecl_kw_type * kw , const void * global_data) {
+  const size_t element_size = ecl_kw_get_sizeof_ctype( kw );
+
+  ecl_grid_assert_export_kw( grid , kw , __func__ );
+  if (ecl_kw_get_size( kw ) == grid->size)
+    memcpy( ecl_kw_get_void_ptr( kw ) , global_data , grid->size * element_size );
+  else
+    ecl_kw_kernel_gather( ecl_kw_get_void_ptr( kw ) , global_data , element_size , grid->inv_index_map , grid->total_active );
 }
 
 
@@ -18,10 +18,18 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <stdbool.h>
 
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 #include <ert/util/util.h>
+#include <ert/util/vector.h>
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_util.h>
@@ -37,52 +45,199 @@
    position of all the active cells. This is just a minor
    simplification to speed up repeated calls to get the true world
    coordinates of a cell.
+
+   The positions are stored either as double, or as float relative to
+   an origin inside the grid; in the latter case the precision is
+   relative to the extent of the grid and not to the magnitude of the
+   UTM coordinates.
+
+   A cache can have subsets, which are caches with the positions of a
+   selection of the cells (typically a region without the aquifer
+   cells) stored contiguously. A subset is reference counted like the
+   cache itself, and it holds a reference to the cache it was created
+   from; when the last reference to a subset is released it is removed
+   from the parent cache.
 */
 
+#define ECL_GRID_CACHE_BLOCK_SIZE 1048576
+
+typedef struct {
+  int                 * active_list;   /* Copy of the selection the subset was created from; NULL for all cells. */
+  int                   list_size;
+  bool                * exclude;       /* Copy of the exclude mask with one element for each cell in the cache; NULL for no mask. */
+  ecl_grid_cache_type * subset;
+} ecl_grid_cache_subset_node_type;
+
+
 struct ecl_grid_cache_struct {
   int                   size;         /* The length of the vectors, equal to the number of active elements in the grid. */
-  double              * xpos;
+  bool                  float_storage;
+  double                origin[3];    /* The float positions are relative to this point. */
+  double              * xpos;         /* NULL with float storage. */
   double              * ypos;
   double              * zpos;
+  float               * xpos_float;   /* NULL with double storage. */
+  float               * ypos_float;
+  float               * zpos_float;
   double              * volume;       /* Will be initialized on demand. */
   int                 * global_index; /* Maps from active index (i.e. natural index in this context) - to the corresponding global index. */
+  int                 * parent_index; /* For subsets: the index of each element in the cache the subset was created from - NULL otherwise. */
+  ecl_grid_cache_type * parent;       /* For subsets: the cache the subset was created from - NULL otherwise. */
   const ecl_grid_type * grid;
+  int                   ref_count;
+  bool                  shared;       /* Registered in the shared_caches list. */
+  vector_type         * subsets;      /* ecl_grid_cache_subset_node_type instances. */
 };
 
 
+/*
+  The lock protects the registry of shared caches, the reference
+  counts and the on demand initialization of volumes and subsets.
+*/
 
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t grid_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+#define ECL_GRID_CACHE_LOCK()   pthread_mutex_lock( &grid_cache_lock )
+#define ECL_GRID_CACHE_UNLOCK() pthread_mutex_unlock( &grid_cache_lock )
+#else
+#define ECL_GRID_CACHE_LOCK()
+#define ECL_GRID_CACHE_UNLOCK()
+#endif
 
+static vector_type * shared_caches = NULL;
 
-ecl_grid_cache_type * ecl_grid_cache_alloc( const ecl_grid_type * grid ) {
+
+static void ecl_grid_cache_subset_node_free( void * arg ) {
+  ecl_grid_cache_subset_node_type * node = arg;
+  util_safe_free( node->active_list );
+  util_safe_free( node->exclude );
+  free( node );
+}
+
+
+static ecl_grid_cache_type * ecl_grid_cache_alloc_empty( const ecl_grid_type * grid , int size , bool float_storage) {
   ecl_grid_cache_type * grid_cache = util_malloc( sizeof * grid_cache );
 
   grid_cache->grid          = grid;
+  grid_cache->size          = size;
+  grid_cache->float_storage = float_storage;
   grid_cache->volume        = NULL;
-  grid_cache->size          = ecl_grid_get_active_size( grid );
-  grid_cache->xpos          = util_calloc( grid_cache->size , sizeof * grid_cache->xpos );
-  grid_cache->ypos          = util_calloc( grid_cache->size , sizeof * grid_cache->ypos );
-  grid_cache->zpos          = util_calloc( grid_cache->size , sizeof * grid_cache->zpos );
-  grid_cache->global_index  = util_calloc( grid_cache->size , sizeof * grid_cache->global_index );
-  {
-    int active_index;
+  grid_cache->parent_index  = NULL;
+  grid_cache->parent        = NULL;
+  grid_cache->ref_count     = 1;
+  grid_cache->shared        = false;
+  grid_cache->subsets       = vector_alloc_new();
+  grid_cache->xpos          = NULL;
+  grid_cache->ypos          = NULL;
+  grid_cache->zpos          = NULL;
+  grid_cache->xpos_float    = NULL;
+  grid_cache->ypos_float    = NULL;
+  grid_cache->zpos_float    = NULL;
+  grid_cache->origin[0]     = 0;
+  grid_cache->origin[1]     = 0;
+  grid_cache->origin[2]     = 0;
+  grid_cache->global_index  = util_calloc( size , sizeof * grid_cache->global_index );
+
+  if (float_storage) {
+    grid_cache->xpos_float = util_calloc( size , sizeof * grid_cache->xpos_float );
+    grid_cache->ypos_float = util_calloc( size , sizeof * grid_cache->ypos_float );
+    grid_cache->zpos_float = util_calloc( size , sizeof * grid_cache->zpos_float );
+  } else {
+    grid_cache->xpos = util_calloc( size , sizeof * grid_cache->xpos );
+    grid_cache->ypos = util_calloc( size , sizeof * grid_cache->ypos );
+    grid_cache->zpos = util_calloc( size , sizeof * grid_cache->zpos );
+  }
+
+  return grid_cache;
+}
+
+
+/**
+   Allocates a cache of the active cells in the grid; the cell centers
+   are calculated in parallel with ecl_grid_export_cell_centers(). With
+   float_storage == true the positions are stored as float, which
+   halves the memory.
+*/
+
+ecl_grid_cache_type * ecl_grid_cache_alloc__( const ecl_grid_type * grid , bool float_storage) {
+  int size = ecl_grid_get_active_size( grid );
+  ecl_grid_cache_type * grid_cache = ecl_grid_cache_alloc_empty( grid , size , float_storage );
+
+  if (size > 0)
+    memcpy( grid_cache->global_index , ecl_grid_get_inv_index_map_ptr( grid ) , size * sizeof * grid_cache->global_index );
+
+  if (!float_storage)
+    ecl_grid_export_cell_centers( grid , size , grid_cache->global_index , grid_cache->xpos , grid_cache->ypos , grid_cache->zpos );
+  else if (size > 0) {
+    int block_size = util_int_min( size , ECL_GRID_CACHE_BLOCK_SIZE );
+    double * xpos = util_calloc( block_size , sizeof * xpos );
+    double * ypos = util_calloc( block_size , sizeof * ypos );
+    double * zpos = util_calloc( block_size , sizeof * zpos );
+    int offset;
+
+    ecl_grid_get_xyz1( grid , grid_cache->global_index[0] , &grid_cache->origin[0] , &grid_cache->origin[1] , &grid_cache->origin[2]);
+    for (offset = 0; offset < size; offset += block_size) {
+      int count = util_int_min( block_size , size - offset );
+      int index;
+
+      ecl_grid_export_cell_centers( grid , count , &grid_cache->global_index[offset] , xpos , ypos , zpos );
+      for (index = 0; index < count; index++) {
+        grid_cache->xpos_float[offset + index] = (float) (xpos[index] - grid_cache->origin[0]);
+        grid_cache->ypos_float[offset + index] = (float) (ypos[index] - grid_cache->origin[1]);
+        grid_cache->zpos_float[offset + index] = (float) (zpos[index] - grid_cache->origin[2]);
+      }
+    }
+
+    free( zpos );
+    free( ypos );
+    free( xpos );
+  }
+
+  return grid_cache;
+}
 
 
-    /* Go trough all the active cells and extract the cell center
-       position and store it in xpos/ypos/zpos. */
+ecl_grid_cache_type * ecl_grid_cache_alloc( const ecl_grid_type * grid ) {
+  return ecl_grid_cache_alloc__( grid , false );
+}
+
+
+/**
+   Returns a reference counted cache which is shared with all other
+   callers asking for a shared cache of the same grid and storage
+   type; the reference is released with ecl_grid_cache_free(). The
+   grid must outlive the cache.
+*/
 
-    for (active_index = 0; active_index < grid_cache->size; active_index++) {
-      int global_index = ecl_grid_get_global_index1A( grid , active_index );
-      grid_cache->global_index[ active_index ] = global_index;
-      ecl_grid_get_xyz1( grid , global_index ,
-                         &grid_cache->xpos[ active_index ] ,
-                         &grid_cache->ypos[ active_index ] ,
-                         &grid_cache->zpos[ active_index ]);
+ecl_grid_cache_type * ecl_grid_cache_alloc_shared( const ecl_grid_type * grid , bool float_storage) {
+  ecl_grid_cache_type * grid_cache = NULL;
+
+  ECL_GRID_CACHE_LOCK();
+  {
+    if (shared_caches == NULL)
+      shared_caches = vector_alloc_new();
+
+    for (int i = 0; i < vector_get_size( shared_caches ); i++) {
+      ecl_grid_cache_type * shared_cache = vector_iget( shared_caches , i );
+      if ((shared_cache->grid == grid) && (shared_cache->float_storage == float_storage)) {
+        grid_cache = shared_cache;
+        grid_cache->ref_count++;
+        break;
+      }
     }
 
+    if (grid_cache == NULL) {
+      grid_cache = ecl_grid_cache_alloc__( grid , float_storage );
+      grid_cache->shared = true;
+      vector_append_ref( shared_caches , grid_cache );
+    }
   }
+  ECL_GRID_CACHE_UNLOCK();
+
   return grid_cache;
 }
 
+
 int ecl_grid_cache_get_size( const ecl_grid_cache_type * grid_cache ) {
   return grid_cache->size;
 }
@@ -96,37 +251,253 @@ const int * ecl_grid_cache_get_global_index( const ecl_grid_cache_type * grid_ca
   return grid_cache->global_index;
 }
 
+
+bool ecl_grid_cache_float_storage( const ecl_grid_cache_type * grid_cache ) {
+  return grid_cache->float_storage;
+}
+
+
+void ecl_grid_cache_get_origin( const ecl_grid_cache_type * grid_cache , double * x0 , double * y0 , double * z0) {
+  *x0 = grid_cache->origin[0];
+  *y0 = grid_cache->origin[1];
+  *z0 = grid_cache->origin[2];
+}
+
+
+static void ecl_grid_cache_assert_storage( const ecl_grid_cache_type * grid_cache , bool float_storage , const char * caller) {
+  if (grid_cache->float_storage != float_storage)
+    util_abort("%s: the cache uses %s storage for the positions\n", caller , grid_cache->float_storage ? "float" : "double");
+}
+
+
 const double * ecl_grid_cache_get_xpos( const ecl_grid_cache_type * grid_cache ) {
+  ecl_grid_cache_assert_storage( grid_cache , false , __func__ );
   return grid_cache->xpos;
 }
 
 const double * ecl_grid_cache_get_ypos( const ecl_grid_cache_type * grid_cache ) {
+  ecl_grid_cache_assert_storage( grid_cache , false , __func__ );
   return grid_cache->ypos;
 }
 
 const double * ecl_grid_cache_get_zpos( const ecl_grid_cache_type * grid_cache ) {
+  ecl_grid_cache_assert_storage( grid_cache , false , __func__ );
   return grid_cache->zpos;
 }
 
+
+/*
+  The float positions are relative to the origin returned by
+  ecl_grid_cache_get_origin().
+*/
+
+const float * ecl_grid_cache_get_xpos_float( const ecl_grid_cache_type * grid_cache ) {
+  ecl_grid_cache_assert_storage( grid_cache , true , __func__ );
+  return grid_cache->xpos_float;
+}
+
+const float * ecl_grid_cache_get_ypos_float( const ecl_grid_cache_type * grid_cache ) {
+  ecl_grid_cache_assert_storage( grid_cache , true , __func__ );
+  return grid_cache->ypos_float;
+}
+
+const float * ecl_grid_cache_get_zpos_float( const ecl_grid_cache_type * grid_cache ) {
+  ecl_grid_cache_assert_storage( grid_cache , true , __func__ );
+  return grid_cache->zpos_float;
+}
+
+
 const double * ecl_grid_cache_get_volume( const ecl_grid_cache_type * grid_cache ) {
 
+  ECL_GRID_CACHE_LOCK();
   if (!grid_cache->volume) {
     // C++ style const cast.
     ecl_grid_cache_type * gc = (ecl_grid_cache_type *) grid_cache;
     gc->volume = util_calloc( gc->size , sizeof * gc->volume );
-    for (int active_index = 0; active_index < grid_cache->size; active_index++)
-      gc->volume[active_index] = ecl_grid_get_cell_volume1A( gc->grid , active_index );
+    ecl_grid_export_cell_volumes( gc->grid , gc->size , gc->global_index , gc->volume );
   }
+  ECL_GRID_CACHE_UNLOCK();
 
   return grid_cache->volume;
 }
 
 
-void ecl_grid_cache_free( ecl_grid_cache_type * grid_cache ) {
-  free( grid_cache->xpos );
-  free( grid_cache->ypos );
-  free( grid_cache->zpos );
+/*****************************************************************/
+
+static bool ecl_grid_cache_subset_node_equal( const ecl_grid_cache_type * grid_cache , const ecl_grid_cache_subset_node_type * node , const int * active_list , int list_size , const bool * exclude) {
+  if ((node->exclude == NULL) != (exclude == NULL))
+    return false;
+
+  if (exclude && (memcmp( node->exclude , exclude , grid_cache->size * sizeof * exclude ) != 0))
+    return false;
+
+  if (active_list == NULL)
+    return (node->active_list == NULL);
+
+  if ((node->active_list == NULL) || (node->list_size != list_size))
+    return false;
+
+  return (memcmp( node->active_list , active_list , list_size * sizeof * active_list ) == 0);
+}
+
+
+static ecl_grid_cache_type * ecl_grid_cache_alloc_subset( const ecl_grid_cache_type * grid_cache , const int * active_list , int list_size , const bool * exclude) {
+  int num_candidates = (active_list == NULL) ? grid_cache->size : list_size;
+  int * parent_index = util_calloc( util_int_max( 1 , num_candidates ) , sizeof * parent_index );
+  int size = 0;
+  ecl_grid_cache_type * subset;
+
+  for (int i = 0; i < num_candidates; i++) {
+    int index = (active_list == NULL) ? i : active_list[i];
+    if ((exclude == NULL) || (!exclude[index]))
+      parent_index[size++] = index;
+  }
+
+  subset = ecl_grid_cache_alloc_empty( grid_cache->grid , size , grid_cache->float_storage );
+  subset->parent_index = parent_index;
+  subset->origin[0] = grid_cache->origin[0];
+  subset->origin[1] = grid_cache->origin[1];
+  subset->origin[2] = grid_cache->origin[2];
+
+  for (int i = 0; i < size; i++) {
+    int index = parent_index[i];
+    subset->global_index[i] = grid_cache->global_index[index];
+    if (grid_cache->float_storage) {
+      subset->xpos_float[i] = grid_cache->xpos_float[index];
+      subset->ypos_float[i] = grid_cache->ypos_float[index];
+      subset->zpos_float[i] = grid_cache->zpos_float[index];
+    } else {
+      subset->xpos[i] = grid_cache->xpos[index];
+      subset->ypos[i] = grid_cache->ypos[index];
+      subset->zpos[i] = grid_cache->zpos[index];
+    }
+  }
+
+  return subset;
+}
+
+
+/**
+   Returns a subset with the cells in active_list (all cells if
+   active_list == NULL) which are not flagged in the exclude array
+   (can be NULL), in the order of active_list. The positions of the
+   subset are stored contiguously, so loops over the subset do not
+   need to go through the index list; use
+   ecl_grid_cache_get_parent_index() to map back to the full cache.
+
+   A subset is identified by the content of active_list and exclude,
+   both are copied. Asking again for the same selection returns the
+   same subset as long as it is alive. The returned subset holds a
+   reference which the caller must release with
+   ecl_grid_cache_free().
+*/
+
+ecl_grid_cache_type * ecl_grid_cache_get_subset( const ecl_grid_cache_type * grid_cache , const int * active_list , int list_size , const bool * exclude) {
+  /* The subset list and the reference count are not part of the cache content. */
+  ecl_grid_cache_type * gc = (ecl_grid_cache_type *) grid_cache;
+  ecl_grid_cache_type * subset = NULL;
+
+  ECL_GRID_CACHE_LOCK();
+  {
+    for (int i = 0; i < vector_get_size( gc->subsets ); i++) {
+      const ecl_grid_cache_subset_node_type * node = vector_iget( gc->subsets , i );
+      if (ecl_grid_cache_subset_node_equal( gc , node , active_list , list_size , exclude )) {
+        subset = node->subset;
+        subset->ref_count++;
+        break;
+      }
+    }
+
+    if (subset == NULL) {
+      ecl_grid_cache_subset_node_type * node = util_malloc( sizeof * node );
+
+      node->active_list = (active_list == NULL) ? NULL : util_alloc_copy( active_list , list_size * sizeof * active_list );
+      node->list_size   = list_size;
+      node->exclude     = (exclude == NULL) ? NULL : util_alloc_copy( exclude , gc->size * sizeof * exclude );
+      node->subset      = ecl_grid_cache_alloc_subset( gc , active_list , list_size , exclude );
+      subset = node->subset;
+      subset->parent = gc;
+      gc->ref_count++;
+
+      vector_append_owned_ref( gc->subsets , node , ecl_grid_cache_subset_node_free );
+    }
+  }
+  ECL_GRID_CACHE_UNLOCK();
+
+  return subset;
+}
+
+
+/*
+  For a subset: the index of each element in the cache the subset was
+  created from. NULL for a cache which is not a subset.
+*/
+
+const int * ecl_grid_cache_get_parent_index( const ecl_grid_cache_type * grid_cache ) {
+  return grid_cache->parent_index;
+}
+
+
+/*****************************************************************/
+
+static void ecl_grid_cache_free__( ecl_grid_cache_type * grid_cache ) {
+  vector_free( grid_cache->subsets );
+  util_safe_free( grid_cache->xpos );
+  util_safe_free( grid_cache->ypos );
+  util_safe_free( grid_cache->zpos );
+  util_safe_free( grid_cache->xpos_float );
+  util_safe_free( grid_cache->ypos_float );
+  util_safe_free( grid_cache->zpos_float );
   free( grid_cache->global_index );
+  util_safe_free( grid_cache->parent_index );
   free( grid_cache->volume );
   free( grid_cache );
 }
+
+
+/**
+   Releases one reference to the cache; the cache is freed when the
+   last reference is released.
+*/
+
+void ecl_grid_cache_free( ecl_grid_cache_type * grid_cache ) {
+  bool free_cache;
+
+  ECL_GRID_CACHE_LOCK();
+  {
+    grid_cache->ref_count--;
+    free_cache = (grid_cache->ref_count == 0);
+
+    if (free_cache && grid_cache->parent) {
+      vector_type * subsets = grid_cache->parent->subsets;
+      for (int i = 0; i < vector_get_size( subsets ); i++) {
+        const ecl_grid_cache_subset_node_type * node = vector_iget_const( subsets , i );
+        if (node->subset == grid_cache) {
+          vector_idel( subsets , i );
+          break;
+        }
+      }
+    }
+
+    if (free_cache && grid_cache->shared) {
+      for (int i = 0; i < vector_get_size( shared_caches ); i++) {
+        if (vector_iget( shared_caches , i ) == grid_cache) {
+          vector_idel( shared_caches , i );
+          break;
+        }
+      }
+      if (vector_get_size( shared_caches ) == 0) {
+        vector_free( shared_caches );
+        shared_caches = NULL;
+      }
+    }
+  }
+  ECL_GRID_CACHE_UNLOCK();
+
+  if (free_cache) {
+    ecl_grid_cache_type * parent = grid_cache->parent;
+    ecl_grid_cache_free__( grid_cache );
+    if (parent)
+      ecl_grid_cache_free( parent );
+  }
+}
@@ -0,0 +1,438 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_surface.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/util.h>
+#include <ert/util/thread_pool.h>
+
+#include <ert/geometry/geo_util.h>
+#include <ert/geometry/geo_surface.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_grid_surface.h>
+
+/*
+  Mapping between the columns of an ecl_grid and the nodes of a
+  regular (possibly rotated) geo_surface lattice.
+
+  Grid -> surface: the footprint of a cell is the top face, the bottom
+  face or the quadrilateral halfway between them, i.e. the xy average
+  of the corresponding top and bottom corners. The footprints are
+  transformed to the lattice coordinates of the surface, where the
+  nodes are at integer positions, and every node inside the footprint
+  gets the value of the cell. This is done in three passes:
+
+    1. For all the cells in the k range the range of lattice rows
+       covered by the footprint is computed.
+
+    2. The lattice rows are split in one band per thread, and the
+       cells are binned on the bands they overlap.
+
+    3. Every band is handled by one thread; the thread visits the
+       cells of its bin and accumulates into the nodes of the band
+       only, so there is no need for locking.
+
+  Surface -> grid: the surface is sampled with bilinear interpolation
+  at the cell centers.
+*/
+
+#define GRID_SURFACE_MIN_PARALLEL 10000
+
+
+static int grid_surface_num_threads( int64_t work ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  if (work >= GRID_SURFACE_MIN_PARALLEL)
+    return util_get_num_cpu();
+#endif
+  return 1;
+}
+
+
+static void grid_surface_run( thread_pool_range_ftype * func , void * arg , int num_items , int num_threads) {
+#ifdef ERT_HAVE_THREAD_POOL
+  thread_pool_run_range( func , arg , num_items , num_threads );
+#else
+  func( arg , 0 , num_items );
+#endif
+}
+
+/*****************************************************************/
+
+typedef struct {
+  const ecl_grid_type    * grid;
+  const ecl_kw_type      * kw;
+  const geo_surface_type * surface;
+  ecl_grid_map_enum        op;
+  ecl_grid_footprint_enum  footprint;
+  int                      nx , ny;         /* The grid dimensions. */
+  int                      k1;
+  int                      num_cells;       /* nx*ny*(k2 - k1 + 1). */
+  int                      surface_nx;
+  int                      surface_ny;
+  int                    * row_range;       /* [2*cell] = first row, [2*cell + 1] = last row; -1 if the cell is skipped. */
+  int                      num_bands;
+  int                    * band_row;        /* Band b is the rows [band_row[b],band_row[b+1]). */
+  int                    * band_offset;     /* The cells of band b are band_cells[band_offset[b]] ... band_cells[band_offset[b+1] - 1]. */
+  int                    * band_cells;
+  double                 * acc;
+  double                 * weight;
+  int                    * count;
+} grid_map_type;
+
+
+/* The corners of a cell are numbered with i running fastest, then j, then k; the order below goes around the face. */
+static const int footprint_corners[4] = { 0 , 1 , 3 , 2 };
+
+
+static void grid_map_footprint( const grid_map_type * map , int global_index , double * u , double * v) {
+  int c;
+  for (c = 0; c < 4; c++) {
+    double x , y , z;
+
+    if (map->footprint == ECL_GRID_FOOTPRINT_MID) {
+      double x2 , y2 , z2;
+      ecl_grid_get_cell_corner_xyz1( map->grid , global_index , footprint_corners[c]     , &x  , &y  , &z );
+      ecl_grid_get_cell_corner_xyz1( map->grid , global_index , footprint_corners[c] + 4 , &x2 , &y2 , &z2 );
+      x = 0.5 * (x + x2);
+      y = 0.5 * (y + y2);
+    } else {
+      int corner = footprint_corners[c] + ((map->footprint == ECL_GRID_FOOTPRINT_BOTTOM) ? 4 : 0);
+      ecl_grid_get_cell_corner_xyz1( map->grid , global_index , corner , &x , &y , &z );
+    }
+
+    geo_surface_get_lattice_coord( map->surface , x , y , &u[c] , &v[c] );
+  }
+}
+
+
+static int grid_map_global_index( const grid_map_type * map , int cell ) {
+  int layer_size = map->nx * map->ny;
+  int k = map->k1 + cell / layer_size;
+  return k * layer_size + (cell % layer_size);
+}
+
+
+static void grid_map_row_range( void * arg , int begin , int end) {
+  grid_map_type * map = arg;
+  int cell;
+  for (cell = begin; cell < end; cell++) {
+    int global_index = grid_map_global_index( map , cell );
+    map->row_range[2*cell]     = -1;
+    map->row_range[2*cell + 1] = -1;
+
+    if (ecl_grid_cell_active1( map->grid , global_index )) {
+      double u[4] , v[4];
+      double vmin , vmax;
+      int c;
+
+      grid_map_footprint( map , global_index , u , v );
+      vmin = vmax = v[0];
+      for (c = 1; c < 4; c++) {
+        vmin = util_double_min( vmin , v[c] );
+        vmax = util_double_max( vmax , v[c] );
+      }
+
+      {
+        double first = util_double_max( ceil( vmin ) , 0 );
+        double last  = util_double_min( floor( vmax ) , map->surface_ny - 1 );
+        if (first <= last) {
+          map->row_range[2*cell]     = (int) first;
+          map->row_range[2*cell + 1] = (int) last;
+        }
+      }
+    }
+  }
+}
+
+
+static double grid_map_cell_value( const grid_map_type * map , int global_index ) {
+  if (map->kw == NULL)
+    return 1;
+
+  if (ecl_kw_get_size( map->kw ) == ecl_grid_get_global_size( map->grid ))
+    return ecl_kw_iget_as_double( map->kw , global_index );
+  else
+    return ecl_kw_iget_as_double( map->kw , ecl_grid_get_active_index1( map->grid , global_index ));
+}
+
+
+static void grid_map_add( grid_map_type * map , int node , double value , double thickness) {
+  switch (map->op) {
+  case(ECL_GRID_MAP_SUM):
+    map->acc[node] += value;
+    break;
+  case(ECL_GRID_MAP_MIN):
+    map->acc[node] = (map->count[node] == 0) ? value : util_double_min( map->acc[node] , value );
+    break;
+  case(ECL_GRID_MAP_MAX):
+    map->acc[node] = (map->count[node] == 0) ? value : util_double_max( map->acc[node] , value );
+    break;
+  case(ECL_GRID_MAP_AVERAGE):
+    map->acc[node] += value * thickness;
+    map->weight[node] += thickness;
+    break;
+  case(ECL_GRID_MAP_INTEGRAL):
+    map->acc[node] += value * thickness;
+    break;
+  }
+  map->count[node]++;
+}
+
+
+/*
+  Lists every cell with a non empty row range in the bins of all the
+  bands it overlaps; within a bin the cells are in increasing order,
+  i.e. the nodes are accumulated in the same order as in a serial
+  run.
+*/
+
+static void grid_map_bin_cells( grid_map_type * map ) {
+  int * row_band = util_malloc( map->surface_ny * sizeof * row_band );
+  int * fill;
+  int band , row , cell;
+
+  map->band_row = util_malloc( (map->num_bands + 1) * sizeof * map->band_row );
+  for (band = 0; band <= map->num_bands; band++)
+    map->band_row[band] = (int) (((int64_t) map->surface_ny * band) / map->num_bands);
+
+  for (band = 0; band < map->num_bands; band++)
+    for (row = map->band_row[band]; row < map->band_row[band + 1]; row++)
+      row_band[row] = band;
+
+  map->band_offset = util_calloc( map->num_bands + 1 , sizeof * map->band_offset );
+  for (cell = 0; cell < map->num_cells; cell++) {
+    int first_row = map->row_range[2*cell];
+    if (first_row >= 0) {
+      for (band = row_band[first_row]; band <= row_band[ map->row_range[2*cell + 1] ]; band++)
+        map->band_offset[band + 1]++;
+    }
+  }
+
+  for (band = 0; band < map->num_bands; band++)
+    map->band_offset[band + 1] += map->band_offset[band];
+
+  map->band_cells = util_malloc( util_int_max( 1 , map->band_offset[map->num_bands] ) * sizeof * map->band_cells );
+  fill = util_alloc_copy( map->band_offset , map->num_bands * sizeof * fill );
+  for (cell = 0; cell < map->num_cells; cell++) {
+    int first_row = map->row_range[2*cell];
+    if (first_row >= 0) {
+      for (band = row_band[first_row]; band <= row_band[ map->row_range[2*cell + 1] ]; band++)
+        map->band_cells[ fill[band]++ ] = cell;
+    }
+  }
+
+  free( fill );
+  free( row_band );
+}
+
+
+/*
+  Handles the lattice rows of the bands [band1,band2); only the cells
+  in the bins of these bands are visited.
+*/
+
+static void grid_map_bands( void * arg , int band1 , int band2 ) {
+  grid_map_type * map = arg;
+  int band;
+
+  for (band = band1; band < band2; band++) {
+    int row1 = map->band_row[band];
+    int row2 = map->band_row[band + 1];
+    int i;
+
+    for (i = map->band_offset[band]; i < map->band_offset[band + 1]; i++) {
+      int cell = map->band_cells[i];
+      int first_row = map->row_range[2*cell];
+      int last_row  = map->row_range[2*cell + 1];
+      int global_index = grid_map_global_index( map , cell );
+      double value = grid_map_cell_value( map , global_index );
+      double thickness = ecl_grid_get_cell_thickness1( map->grid , global_index );
+      double u[4] , v[4];
+      double umin , umax;
+      int c , row;
+
+      grid_map_footprint( map , global_index , u , v );
+      umin = umax = u[0];
+      for (c = 1; c < 4; c++) {
+        umin = util_double_min( umin , u[c] );
+        umax = util_double_max( umax , u[c] );
+      }
+
+      for (row = util_int_max( first_row , row1 ); row <= util_int_min( last_row , row2 - 1 ); row++) {
+        int col1 = (int) util_double_max( ceil( umin ) , 0 );
+        int col2 = (int) util_double_min( floor( umax ) , map->surface_nx - 1 );
+        int col;
+
+        for (col = col1; col <= col2; col++) {
+          if (geo_util_inside_polygon( u , v , 4 , col , row ))
+            grid_map_add( map , row * map->surface_nx + col , value , thickness );
+        }
+      }
+    }
+  }
+}
+
+
+/*
+  Will map the values of @kw for the active cells in layers [k1,k2]
+  onto the nodes of @surface, combined with @op, and store the result
+  in @zcoord - which must have room for one value per surface node.
+  Nodes which are not covered by the @footprint of any cell get
+  @undefined_value. The keyword can have nactive or nx*ny*nz elements;
+  if @kw is NULL all cells get the value 1, i.e. the INTEGRAL operator
+  gives a gross thickness map.
+
+  The result can be written with geo_surface_fprintf_irap_external_zcoord().
+*/
+
+void ecl_grid_map_kw_footprint( const ecl_grid_type * grid , const ecl_kw_type * kw , int k1 , int k2 , ecl_grid_map_enum op ,
+                                ecl_grid_footprint_enum footprint ,
+                                const geo_surface_type * surface , double undefined_value , double * zcoord) {
+  grid_map_type map;
+  int num_cells;
+  int num_nodes;
+
+  if ((k1 < 0) || (k2 >= ecl_grid_get_nz( grid )) || (k1 > k2))
+    util_abort("%s: invalid k range [%d,%d] \n",__func__ , k1 , k2 );
+
+  if (kw) {
+    int size = ecl_kw_get_size( kw );
+    if (!ecl_type_is_numeric( ecl_kw_get_data_type( kw )))
+      util_abort("%s: keyword %s is not numeric \n",__func__ , ecl_kw_get_header( kw ));
+
+    if ((size != ecl_grid_get_global_size( grid )) && (size != ecl_grid_get_nactive( grid )))
+      util_abort("%s: size mismatch for %s: %d  - expected %d or %d \n",__func__ , ecl_kw_get_header( kw ) , size ,
+                 ecl_grid_get_nactive( grid ) , ecl_grid_get_global_size( grid ));
+  }
+
+  map.grid = grid;
+  map.kw = kw;
+  map.surface = surface;
+  map.op = op;
+  map.footprint = footprint;
+  map.nx = ecl_grid_get_nx( grid );
+  map.ny = ecl_grid_get_ny( grid );
+  map.k1 = k1;
+  map.surface_nx = geo_surface_get_nx( surface );
+  map.surface_ny = geo_surface_get_ny( surface );
+
+  num_cells = map.nx * map.ny * (k2 - k1 + 1);
+  map.num_cells = num_cells;
+  num_nodes = map.surface_nx * map.surface_ny;
+  map.row_range = util_calloc( 2 * num_cells , sizeof * map.row_range );
+  map.acc = util_calloc( num_nodes , sizeof * map.acc );
+  map.weight = util_calloc( num_nodes , sizeof * map.weight );
+  map.count = util_calloc( num_nodes , sizeof * map.count );
+
+  grid_surface_run( grid_map_row_range , &map , num_cells , grid_surface_num_threads( num_cells ));
+
+  map.num_bands = util_int_max( 1 , util_int_min( grid_surface_num_threads( (int64_t) num_cells + num_nodes ) , map.surface_ny ));
+  grid_map_bin_cells( &map );
+  grid_surface_run( grid_map_bands , &map , map.num_bands , map.num_bands );
+
+  {
+    int node;
+    for (node = 0; node < num_nodes; node++) {
+      if (map.count[node] == 0)
+        zcoord[node] = undefined_value;
+      else if (op == ECL_GRID_MAP_AVERAGE)
+        zcoord[node] = (map.weight[node] > 0) ? map.acc[node] / map.weight[node] : undefined_value;
+      else
+        zcoord[node] = map.acc[node];
+    }
+  }
+
+  free( map.band_cells );
+  free( map.band_offset );
+  free( map.band_row );
+  free( map.count );
+  free( map.weight );
+  free( map.acc );
+  free( map.row_range );
+}
+
+
+/*
+  As ecl_grid_map_kw_footprint() with the footprint halfway between
+  the top and bottom face of the cells.
+*/
+
+void ecl_grid_map_kw( const ecl_grid_type * grid , const ecl_kw_type * kw , int k1 , int k2 , ecl_grid_map_enum op ,
+                      const geo_surface_type * surface , double undefined_value , double * zcoord) {
+  ecl_grid_map_kw_footprint( grid , kw , k1 , k2 , op , ECL_GRID_FOOTPRINT_MID , surface , undefined_value , zcoord );
+}
+
+/*****************************************************************/
+
+typedef struct {
+  const ecl_grid_type    * grid;
+  const geo_surface_type * surface;
+  double                   undefined_value;
+  int                      k;            /* -1: all cells. */
+  double                 * values;
+} grid_sample_type;
+
+
+static void grid_sample_range( void * arg , int begin , int end) {
+  grid_sample_type * sample = arg;
+  int layer_size = ecl_grid_get_nx( sample->grid ) * ecl_grid_get_ny( sample->grid );
+  int index;
+
+  for (index = begin; index < end; index++) {
+    int global_index = (sample->k < 0) ? index : sample->k * layer_size + index;
+    double x , y , z;
+
+    ecl_grid_get_xyz1( sample->grid , global_index , &x , &y , &z );
+    if (!geo_surface_interpolate_z( sample->surface , x , y , &sample->values[index] ))
+      sample->values[index] = sample->undefined_value;
+  }
+}
+
+
+/*
+  Samples @surface at the center of all nx*ny*nz cells, and stores
+  the result in @values; cells outside the surface get
+  @undefined_value.
+*/
+
+void ecl_grid_sample_surface( const ecl_grid_type * grid , const geo_surface_type * surface , double undefined_value , double * values) {
+  grid_sample_type sample = { .grid = grid , .surface = surface , .undefined_value = undefined_value , .k = -1 , .values = values };
+  int size = ecl_grid_get_global_size( grid );
+  grid_surface_run( grid_sample_range , &sample , size , grid_surface_num_threads( size ));
+}
+
+
+/*
+  Samples @surface at the centers of the nx*ny cells in layer @k;
+  @values is indexed as i + j*nx.
+*/
+
+void ecl_grid_sample_surface_layer( const ecl_grid_type * grid , const geo_surface_type * surface , int k , double undefined_value , double * values) {
+  grid_sample_type sample = { .grid = grid , .surface = surface , .undefined_value = undefined_value , .k = k , .values = values };
+  int size = ecl_grid_get_nx( grid ) * ecl_grid_get_ny( grid );
+
+  if ((k < 0) || (k >= ecl_grid_get_nz( grid )))
+    util_abort("%s: invalid k:%d \n",__func__ , k );
+
+  grid_surface_run( grid_sample_range , &sample , size , grid_surface_num_threads( size ));
+}
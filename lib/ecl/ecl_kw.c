@@ -30,6 +30,8 @@
 #include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_endian_flip.h>
 #include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_perf.h>
+#include <ert/ecl/ecl_kw_kernel.h>
 
 
 #define ECL_KW_TYPE_ID  6111098
@@ -46,6 +48,8 @@ struct ecl_kw_struct {
   char            * header;               /* Header which is trimmed to no-space. */
   char            * data;                 /* The actual data vector. */
   bool              shared_data;          /* Whether this keyword has shared data or not. */
+  int               pin_count;            /* Number of outstanding views aliasing the data vector. */
+  bool              free_pending;         /* ecl_kw_free() has been called while pinned. */
 };
 
 
@@ -258,8 +262,11 @@ static void ecl_kw_assert_index(const ecl_kw_type *ecl_kw , int index, const cha
 
 
 static void ecl_kw_endian_convert_data(ecl_kw_type *ecl_kw) {
-  if (ecl_type_is_numeric(ecl_kw->data_type) || ecl_type_is_bool(ecl_kw->data_type))
+  if (ecl_type_is_numeric(ecl_kw->data_type) || ecl_type_is_bool(ecl_kw->data_type)) {
+    int64_t start = ECL_PERF_START();
     util_endian_flip_vector(ecl_kw->data , ecl_kw_get_sizeof_ctype(ecl_kw) , ecl_kw->size);
+    ECL_PERF_STOP( ECL_PERF_ENDIAN_NS , start );
+  }
 }
 
 
@@ -548,6 +555,8 @@ ecl_kw_type * ecl_kw_alloc_empty() {
   ecl_kw->data           = NULL;
   ecl_kw->shared_data    = false;
   ecl_kw->size           = 0;
+  ecl_kw->pin_count      = 0;
+  ecl_kw->free_pending   = false;
 
   UTIL_TYPE_ID_INIT(ecl_kw , ECL_KW_TYPE_ID);
 
@@ -556,13 +565,69 @@ ecl_kw_type * ecl_kw_alloc_empty() {
 
 
 
-void ecl_kw_free(ecl_kw_type *ecl_kw) {
+/*
+  A keyword can be pinned by code which holds a raw pointer into the
+  data vector, e.g. a numpy array created with EclKW.numpy_view() or
+  a span in the C++ api. While the keyword is pinned the data vector
+  will not be moved or released: resizing or reallocating the data
+  will fail hard, and ecl_kw_free() is deferred until the final
+  ecl_kw_unpin().
+
+  The pin count is not protected by any lock; pinning and unpinning
+  the same keyword from several threads must be serialized by the
+  caller.
+*/
+
+void ecl_kw_pin( ecl_kw_type * ecl_kw ) {
+  if (ecl_kw->free_pending)
+    util_abort("%s: can not pin keyword:%s - it has already been freed \n",__func__ , ecl_kw->header);
+
+  ecl_kw->pin_count++;
+}
+
+
+static void ecl_kw_free_storage( ecl_kw_type * ecl_kw ) {
   util_safe_free( ecl_kw->header );
   util_safe_free(ecl_kw->header8);
-  ecl_kw_free_data(ecl_kw);
+  if (!ecl_kw->shared_data)
+    util_safe_free(ecl_kw->data);
   free(ecl_kw);
 }
 
+
+void ecl_kw_unpin( ecl_kw_type * ecl_kw ) {
+  if (ecl_kw->pin_count == 0)
+    util_abort("%s: keyword:%s is not pinned \n",__func__ , ecl_kw->header);
+
+  ecl_kw->pin_count--;
+  if ((ecl_kw->pin_count == 0) && ecl_kw->free_pending)
+    ecl_kw_free_storage( ecl_kw );
+}
+
+
+bool ecl_kw_is_pinned( const ecl_kw_type * ecl_kw ) {
+  return (ecl_kw->pin_count > 0);
+}
+
+
+int ecl_kw_get_pin_count( const ecl_kw_type * ecl_kw ) {
+  return ecl_kw->pin_count;
+}
+
+
+static void ecl_kw_assert_unpinned( const ecl_kw_type * ecl_kw , const char * caller) {
+  if (ecl_kw->pin_count > 0)
+    util_abort("%s: keyword:%s is pinned by %d view(s) - the data can not be reallocated \n", caller , ecl_kw->header , ecl_kw->pin_count);
+}
+
+
+void ecl_kw_free(ecl_kw_type *ecl_kw) {
+  if (ecl_kw->pin_count > 0)
+    ecl_kw->free_pending = true;
+  else
+    ecl_kw_free_storage( ecl_kw );
+}
+
 void ecl_kw_free__(void *void_ecl_kw) {
   ecl_kw_free((ecl_kw_type *) void_ecl_kw);
 }
@@ -653,6 +718,7 @@ ecl_kw_type * ecl_kw_alloc_slice_copy( const ecl_kw_type * src, int index1, int
 
 
 void ecl_kw_resize( ecl_kw_type * ecl_kw, int new_size) {
+  ecl_kw_assert_unpinned( ecl_kw , __func__ );
   if (ecl_kw->shared_data)
     util_abort("%s: trying to allocate data for ecl_kw object which has been declared with shared storage - aborting \n",__func__);
 
@@ -1089,7 +1155,7 @@ static double __fscanf_ECL_double( FILE * stream , const char * fmt) {
   return value;
 }
 
-bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
+static bool ecl_kw_fread_data__(ecl_kw_type *ecl_kw, fortio_type *fortio) {
   const char null_char         = '\0';
   bool fmt_file                = fortio_fmt_file( fortio );
   if (ecl_kw->size > 0) {
@@ -1098,6 +1164,7 @@ bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
       const int blocks      = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
       char * read_fmt       = alloc_read_fmt( ecl_kw->data_type );
       FILE * stream         = fortio_get_FILE(fortio);
+      offset_type start_pos = util_ftell( stream );
       int    offset         = 0;
       int    index          = 0;
       int    ib,ir;
@@ -1167,6 +1234,7 @@ bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
 
       /* Skip the trailing newline */
       fortio_fseek( fortio , 1 , SEEK_CUR);
+      ECL_PERF_ADD( ECL_PERF_BYTES_READ , util_ftell( stream ) - start_pos );
       free(read_fmt);
       return true;
     } else {
@@ -1190,6 +1258,7 @@ bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
               util_fread( &ecl_kw->data[(ib * blocksize + ir) * sizeof_ctype] , 1 , sizeof_ctype_fortio , stream , __func__);
               ecl_kw->data[(ib * blocksize + ir) * sizeof_ctype + sizeof_ctype_fortio] = null_char;
             }
+            ECL_PERF_ADD( ECL_PERF_BYTES_READ , record_size );
             read_ok = fortio_complete_read(fortio , record_size);
           } else
             read_ok = false;
@@ -1218,6 +1287,21 @@ bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
 }
 
 
+bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
+  int64_t start = ECL_PERF_START();
+  bool read_ok = ecl_kw_fread_data__( ecl_kw , fortio );
+
+  if (read_ok)
+    ECL_PERF_ADD( ECL_PERF_KW_READ , 1 );
+
+  if (fortio_fmt_file( fortio ))
+    ECL_PERF_STOP( ECL_PERF_FORMATTED_NS , start );
+
+  ECL_PERF_TRACE( "ecl_kw_fread" , ecl_kw->header , start );
+  return read_ok;
+}
+
+
 void ecl_kw_fread_indexed_data(fortio_type * fortio, offset_type data_offset, ecl_data_type data_type, int element_count, const int_vector_type* index_map, char* buffer) {
     const int block_size = get_blocksize(data_type);
     FILE *stream  = fortio_get_FILE( fortio );
@@ -1238,9 +1322,12 @@ void ecl_kw_fread_indexed_data(fortio_type * fortio, offset_type data_offset, ec
         fortio_data_fseek(fortio, data_offset, element_index, element_size, element_count, block_size);
         util_fread(&buffer[index * element_size], element_size, 1, stream, __func__);
     }
+    ECL_PERF_ADD( ECL_PERF_BYTES_READ , int_vector_size(index_map) * element_size );
 
     if (ECL_ENDIAN_FLIP) {
+        int64_t start = ECL_PERF_START();
         util_endian_flip_vector(buffer, element_size, int_vector_size(index_map));
+        ECL_PERF_STOP( ECL_PERF_ENDIAN_NS , start );
     }
 }
 
@@ -1286,6 +1373,34 @@ bool ecl_kw_fskip_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
 }
 
 
+
+/**
+   Copies the keyword at the current position of @src - header and
+   data - byte for byte to the current position of @target, without
+   decoding it. The two files must have the same format, see
+   fortio_same_format(). Returns false if no keyword could be read
+   from @src; otherwise @src is positioned after the keyword.
+*/
+
+bool ecl_kw_fcopy_raw( fortio_type * src , fortio_type * target ) {
+  offset_type start = fortio_ftell( src );
+  ecl_kw_type * ecl_kw = ecl_kw_alloc_empty( );
+  bool copy_ok = false;
+
+  if (!fortio_same_format( src , target ))
+    util_abort("%s: can not copy raw keywords between %s and %s - different format\n",__func__ , fortio_filename_ref( src ) , fortio_filename_ref( target ));
+
+  if (ecl_kw_fread_header( ecl_kw , src ) == ECL_KW_READ_OK) {
+    if (ecl_kw_fskip_data( ecl_kw , src )) {
+      offset_type end = fortio_ftell( src );
+      copy_ok = fortio_fcopy_range( src , start , end - start , target );
+    }
+  }
+
+  ecl_kw_free( ecl_kw );
+  return copy_ok;
+}
+
 /**
    This function will skip the header part of an ecl_kw instance. The
    function will read the file content at the current position, it is
@@ -1316,6 +1431,7 @@ ecl_read_status_enum ecl_kw_fread_header(ecl_kw_type *ecl_kw , fortio_type * for
   int size;
 
   if (fmt_file) {
+    offset_type start_pos = util_ftell( stream );
     if(!ecl_kw_fscanf_qstring(header , "%8c" , 8 , stream))
       return ECL_KW_READ_FAIL;
 
@@ -1327,6 +1443,7 @@ ecl_read_status_enum ecl_kw_fread_header(ecl_kw_type *ecl_kw , fortio_type * for
       return ECL_KW_READ_FAIL;
 
     fgetc(stream);             /* Reading the trailing newline ... */
+    ECL_PERF_ADD( ECL_PERF_BYTES_READ , util_ftell( stream ) - start_pos );
   }
   else {
     header[ECL_STRING8_LENGTH]    = null_char;
@@ -1338,6 +1455,7 @@ ecl_read_status_enum ecl_kw_fread_header(ecl_kw_type *ecl_kw , fortio_type * for
 
     char buffer[ECL_KW_HEADER_DATA_SIZE];
     size_t read_bytes = fread(buffer , 1 , ECL_KW_HEADER_DATA_SIZE , stream);
+    ECL_PERF_ADD( ECL_PERF_BYTES_READ , read_bytes );
 
     if (read_bytes != ECL_KW_HEADER_DATA_SIZE)
       return ECL_KW_READ_FAIL;
@@ -1449,6 +1567,7 @@ bool ecl_kw_fseek_last_kw(const char * kw , bool abort_on_error , fortio_type *f
 
 
 void ecl_kw_set_data_ptr(ecl_kw_type * ecl_kw , void * data) {
+  ecl_kw_assert_unpinned( ecl_kw , __func__ );
   if (!ecl_kw->shared_data)
     util_safe_free( ecl_kw->data );
   ecl_kw->data = data;
@@ -1459,6 +1578,7 @@ void ecl_kw_set_data_ptr(ecl_kw_type * ecl_kw , void * data) {
    This is where the storage buffer of the ecl_kw is allocated.
 */
 void ecl_kw_alloc_data(ecl_kw_type *ecl_kw) {
+  ecl_kw_assert_unpinned( ecl_kw , __func__ );
   if (ecl_kw->shared_data)
     util_abort("%s: trying to allocate data for ecl_kw object which has been declared with shared storage - aborting \n",__func__);
 
@@ -1472,6 +1592,7 @@ void ecl_kw_alloc_data(ecl_kw_type *ecl_kw) {
 
 
 void ecl_kw_free_data(ecl_kw_type *ecl_kw) {
+  ecl_kw_assert_unpinned( ecl_kw , __func__ );
   if (!ecl_kw->shared_data)
     util_safe_free(ecl_kw->data);
 
@@ -1602,7 +1723,7 @@ static void ecl_kw_fwrite_data_unformatted( ecl_kw_type * ecl_kw , fortio_type *
      updated accordingly.
   */
 
-   static void __fprintf_scientific(FILE * stream, const char * fmt , double x) {
+   static int __fprintf_scientific(FILE * stream, const char * fmt , double x) {
     double pow_x = ceil(log10(fabs(x)));
     double arg_x   = x / pow(10.0 , pow_x);
     if (x != 0.0) {
@@ -1614,7 +1735,7 @@ static void ecl_kw_fwrite_data_unformatted( ecl_kw_type * ecl_kw , fortio_type *
       arg_x = 0.0;
       pow_x = 0.0;
     }
-    fprintf(stream , fmt , arg_x , (int) pow_x);
+    return fprintf(stream , fmt , arg_x , (int) pow_x);
   }
 
 
@@ -1627,6 +1748,7 @@ static void ecl_kw_fwrite_data_formatted( ecl_kw_type * ecl_kw , fortio_type * f
     const  int columns      = get_columns( ecl_kw->data_type );
     char * write_fmt        = alloc_write_fmt( ecl_kw->data_type );
     const int num_blocks    = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+    int64_t bytes_written   = 0;
     int block_nr;
 
     for (block_nr = 0; block_nr < num_blocks; block_nr++) {
@@ -1641,36 +1763,36 @@ static void ecl_kw_fwrite_data_formatted( ecl_kw_type * ecl_kw , fortio_type * f
           void * data_ptr = ecl_kw_iget_ptr_static( ecl_kw , data_index );
           switch (ecl_kw_get_type(ecl_kw)) {
           case(ECL_CHAR_TYPE):
-            fprintf(stream , write_fmt , data_ptr);
+            bytes_written += fprintf(stream , write_fmt , data_ptr);
             break;
           case(ECL_STRING_TYPE):
-            fprintf(stream , write_fmt , data_ptr);
+            bytes_written += fprintf(stream , write_fmt , data_ptr);
             break;
           case(ECL_INT_TYPE):
             {
               int int_value = ((int *) data_ptr)[0];
-              fprintf(stream , write_fmt , int_value);
+              bytes_written += fprintf(stream , write_fmt , int_value);
             }
             break;
           case(ECL_BOOL_TYPE):
             {
               bool bool_value = ((bool *) data_ptr)[0];
               if (bool_value)
-                fprintf(stream , write_fmt , BOOL_TRUE_CHAR);
+                bytes_written += fprintf(stream , write_fmt , BOOL_TRUE_CHAR);
               else
-                fprintf(stream , write_fmt , BOOL_FALSE_CHAR);
+                bytes_written += fprintf(stream , write_fmt , BOOL_FALSE_CHAR);
             }
             break;
           case(ECL_FLOAT_TYPE):
             {
               float float_value = ((float *) data_ptr)[0];
-              __fprintf_scientific( stream , write_fmt , float_value );
+              bytes_written += __fprintf_scientific( stream , write_fmt , float_value );
             }
             break;
           case(ECL_DOUBLE_TYPE):
             {
               double double_value = ((double *) data_ptr)[0];
-              __fprintf_scientific( stream , write_fmt , double_value );
+              bytes_written += __fprintf_scientific( stream , write_fmt , double_value );
             }
             break;
           case(ECL_MESS_TYPE):
@@ -1678,10 +1800,11 @@ static void ecl_kw_fwrite_data_formatted( ecl_kw_type * ecl_kw , fortio_type * f
             break;
           }
         }
-        fprintf(stream , "\n");
+        bytes_written += fprintf(stream , "\n");
       }
     }
 
+    ECL_PERF_ADD( ECL_PERF_BYTES_WRITTEN , bytes_written );
     free(write_fmt);
   }
 }
@@ -1691,9 +1814,11 @@ void ecl_kw_fwrite_data(const ecl_kw_type *_ecl_kw , fortio_type *fortio) {
   ecl_kw_type *ecl_kw = (ecl_kw_type *) _ecl_kw;
   bool  fmt_file      = fortio_fmt_file( fortio );
 
-  if (fmt_file)
+  if (fmt_file) {
+    int64_t start = ECL_PERF_START();
     ecl_kw_fwrite_data_formatted( ecl_kw , fortio );
-  else
+    ECL_PERF_STOP( ECL_PERF_FORMATTED_NS , start );
+  } else
     ecl_kw_fwrite_data_unformatted( ecl_kw ,fortio );
 }
 
@@ -1704,9 +1829,10 @@ void ecl_kw_fwrite_header(const ecl_kw_type *ecl_kw , fortio_type *fortio) {
   bool fmt_file = fortio_fmt_file(fortio);
   char * type_name = ecl_type_alloc_name(ecl_kw->data_type);
 
-  if (fmt_file)
-    fprintf(stream , WRITE_HEADER_FMT , ecl_kw->header8 , ecl_kw->size , type_name);
-  else {
+  if (fmt_file) {
+    int bytes_written = fprintf(stream , WRITE_HEADER_FMT , ecl_kw->header8 , ecl_kw->size , type_name);
+    ECL_PERF_ADD( ECL_PERF_BYTES_WRITTEN , bytes_written );
+  } else {
     int size = ecl_kw->size;
     if (ECL_ENDIAN_FLIP)
       util_endian_flip_vector(&size , sizeof size , 1);
@@ -1726,12 +1852,16 @@ void ecl_kw_fwrite_header(const ecl_kw_type *ecl_kw , fortio_type *fortio) {
 
 
 bool ecl_kw_fwrite(const ecl_kw_type *ecl_kw , fortio_type *fortio) {
+  int64_t start;
   if (strlen(ecl_kw_get_header( ecl_kw)) > ECL_STRING8_LENGTH) {
      fortio_fwrite_error(fortio);
      return false;
   }
+  start = ECL_PERF_START();
   ecl_kw_fwrite_header(ecl_kw ,  fortio);
   ecl_kw_fwrite_data(ecl_kw   ,  fortio);
+  ECL_PERF_ADD( ECL_PERF_KW_WRITTEN , 1 );
+  ECL_PERF_TRACE( "ecl_kw_fwrite" , ecl_kw->header , start );
   return true;
 }
 
@@ -1858,21 +1988,32 @@ void ecl_kw_get_data_as_float(const ecl_kw_type * ecl_kw , float * float_data) {
 
 
 
-/**
-   Will create a new keyword of the same type as src_kw, and size
-   @target_size. The integer array mapping is a list sizeof(src_kw)
-   elements, where each element is the new index, i.e.
+/*
+  Checks that all the values in mapping are valid indices in
+  [0,target_size), and returns whether they are distinct.
+*/
 
-       new_kw[ mapping[i] ]  = src_kw[i]
+static bool ecl_kw_mapping_distinct( const int * mapping , int size , int target_size ) {
+  bool distinct = true;
+  char * used = util_calloc( target_size , sizeof * used );
+  int i;
 
-   For all inactive elements in new kw are set as follows:
+  for (i = 0; i < size; i++) {
+    int index = mapping[i];
+    if ((index < 0) || (index >= target_size))
+      util_abort("%s: mapping[%d] = %d is outside the target keyword with %d elements \n",__func__ , i , index , target_size);
 
-   0          - For float / int / double
-   False      - For logical
-   ""         - For char
-*/
+    if (used[index])
+      distinct = false;
+    used[index] = 1;
+  }
 
-ecl_kw_type * ecl_kw_alloc_scatter_copy( const ecl_kw_type * src_kw , int target_size , const int * mapping, void * def_value) {
+  free( used );
+  return distinct;
+}
+
+
+static ecl_kw_type * ecl_kw_alloc_scatter_copy__( const ecl_kw_type * src_kw , int target_size , const int * mapping, bool distinct , void * def_value) {
   int default_int           = 0;
   double default_double     = 0;
   float default_float       = 0;
@@ -1906,11 +2047,14 @@ ecl_kw_type * ecl_kw_alloc_scatter_copy( const ecl_kw_type * src_kw , int target
   }
 
   {
-    int sizeof_ctype = ecl_type_get_sizeof_ctype( src_kw->data_type );
-    int i;
-        for( i =0; i < src_kw->size; i++) {
-      int target_index = mapping[i];
-      memcpy( &new_kw->data[ target_index * sizeof_ctype ] , &src_kw->data[ i * sizeof_ctype] , sizeof_ctype);
+    const int element_size = ecl_type_get_sizeof_ctype( src_kw->data_type );
+    if (distinct)
+      ecl_kw_kernel_scatter( new_kw->data , src_kw->data , element_size , mapping , src_kw->size );
+    else {
+      /* The parallel kernel does not define which duplicate wins; copy in order. */
+      int i;
+      for (i = 0; i < src_kw->size; i++)
+        memcpy( &new_kw->data[ mapping[i] * element_size ] , &src_kw->data[ i * element_size ] , element_size );
     }
   }
 
@@ -1918,6 +2062,42 @@ ecl_kw_type * ecl_kw_alloc_scatter_copy( const ecl_kw_type * src_kw , int target
 }
 
 
+/**
+   Will create a new keyword of the same type as src_kw, and size
+   @target_size. The integer array mapping is a list sizeof(src_kw)
+   elements, where each element is the new index, i.e.
+
+       new_kw[ mapping[i] ]  = src_kw[i]
+
+   If several elements in src_kw map to the same index the last one
+   wins, i.e. the result is as if the elements were copied in order.
+
+   For all inactive elements in new kw are set as follows:
+
+   0          - For float / int / double
+   False      - For logical
+   ""         - For char
+*/
+
+ecl_kw_type * ecl_kw_alloc_scatter_copy( const ecl_kw_type * src_kw , int target_size , const int * mapping, void * def_value) {
+  bool distinct = ecl_kw_mapping_distinct( mapping , src_kw->size , target_size );
+  return ecl_kw_alloc_scatter_copy__( src_kw , target_size , mapping , distinct , def_value );
+}
+
+
+/**
+   As ecl_kw_alloc_scatter_copy(), but the caller guarantees that the
+   values in mapping are distinct and in the range [0,target_size),
+   e.g. because mapping is the inv_index_map of a grid. The mapping is
+   then not checked, which saves a pass over it and a temporary array
+   of target_size elements on every copy.
+*/
+
+ecl_kw_type * ecl_kw_alloc_scatter_copy_distinct( const ecl_kw_type * src_kw , int target_size , const int * mapping, void * def_value) {
+  return ecl_kw_alloc_scatter_copy__( src_kw , target_size , mapping , true , def_value );
+}
+
+
 
 void ecl_kw_fread_double_param(const char * filename , bool fmt_file , double * double_data) {
   fortio_type   * fortio      = fortio_open_reader(filename , fmt_file , ECL_ENDIAN_FLIP);
@@ -2024,10 +2204,7 @@ void ecl_kw_scale_ ## ctype (ecl_kw_type * ecl_kw , ctype scale_factor) {
     util_abort("%s: Keyword: %s is wrong type - aborting \n",__func__ , ecl_kw_get_header8(ecl_kw));  \
   {                                                                                                   \
      ctype * data = ecl_kw_get_data_ref(ecl_kw);                                                      \
-     int    size  = ecl_kw_get_size(ecl_kw);                                                          \
-     int i;                                                                                           \
-     for (i=0; i < size; i++)                                                                         \
-        data[i] *= scale_factor;                                                                      \
+     ecl_kw_kernel_scale_ ## ctype( data , ecl_kw_get_size(ecl_kw) , scale_factor );                    \
   }                                                                                                   \
 }
 
@@ -2053,10 +2230,7 @@ void ecl_kw_shift_ ## ctype (ecl_kw_type * ecl_kw , ctype shift_value) {
     util_abort("%s: Keyword: %s is wrong type - aborting \n",__func__ , ecl_kw_get_header8(ecl_kw));  \
   {                                                                                                   \
      ctype * data = ecl_kw_get_data_ref(ecl_kw);                                                      \
-     int    size  = ecl_kw_get_size(ecl_kw);                                                          \
-     int i;                                                                                           \
-     for (i=0; i < size; i++)                                                                         \
-        data[i] += shift_value;                                                                       \
+     ecl_kw_kernel_shift_ ## ctype( data , ecl_kw_get_size(ecl_kw) , shift_value );                    \
   }                                                                                                   \
 }
 
@@ -2125,11 +2299,7 @@ static void ecl_kw_inplace_add_indexed_ ## ctype( ecl_kw_type * target_kw , cons
     const ctype * add_data = ecl_kw_get_data_ref( add_kw );                                \
     int set_size     = int_vector_size( index_set );                                       \
     const int * index_data = int_vector_get_const_ptr( index_set );                        \
-    int i;                                                                                 \
-    for (i=0; i < set_size; i++) {                                                         \
-      int index = index_data[i];                                                           \
-      target_data[index] += add_data[index];                                               \
-    }                                                                                      \
+    ecl_kw_kernel_add_indexed_ ## ctype( target_data , add_data , index_data , set_size ); \
   }                                                                                        \
 }
 
@@ -2166,9 +2336,7 @@ static void ecl_kw_inplace_add_ ## ctype( ecl_kw_type * target_kw , const ecl_kw
  {                                                                                         \
     ctype * target_data = ecl_kw_get_data_ref( target_kw );                                \
     const ctype * add_data = ecl_kw_get_data_ref( add_kw );                                \
-    int i;                                                                                 \
-    for (i=0; i < target_kw->size; i++)                                                    \
-      target_data[i] += add_data[i];                                                       \
+    ecl_kw_kernel_add_ ## ctype( target_data , add_data , target_kw->size );             \
  }                                                                                         \
 }
 ECL_KW_TYPED_INPLACE_ADD( int )
@@ -2206,9 +2374,7 @@ void ecl_kw_inplace_sub_ ## ctype( ecl_kw_type * target_kw , const ecl_kw_type *
  {                                                                                         \
     ctype * target_data = ecl_kw_get_data_ref( target_kw );                                \
     const ctype * sub_data = ecl_kw_get_data_ref( sub_kw );                                \
-    int i;                                                                                 \
-    for (i=0; i < target_kw->size; i++)                                                    \
-      target_data[i] -= sub_data[i];                                                       \
+    ecl_kw_kernel_sub_ ## ctype( target_data , sub_data , target_kw->size );             \
  }                                                                                         \
 }
 ECL_KW_TYPED_INPLACE_SUB( int )
@@ -2242,11 +2408,7 @@ static void ecl_kw_inplace_sub_indexed_ ## ctype( ecl_kw_type * target_kw , cons
     const ctype * sub_data = ecl_kw_get_data_ref( sub_kw );                                \
     int set_size     = int_vector_size( index_set );                                       \
     const int * index_data = int_vector_get_const_ptr( index_set );                        \
-    int i;                                                                                 \
-    for (i=0; i < set_size; i++) {                                                         \
-      int index = index_data[i];                                                           \
-      target_data[index] -= sub_data[index];                                               \
-    }                                                                                      \
+    ecl_kw_kernel_sub_indexed_ ## ctype( target_data , sub_data , index_data , set_size ); \
   }                                                                                        \
 }
 
@@ -2318,9 +2480,7 @@ void ecl_kw_inplace_mul_ ## ctype( ecl_kw_type * target_kw , const ecl_kw_type *
  {                                                                                         \
     ctype * target_data = ecl_kw_get_data_ref( target_kw );                                \
     const ctype * mul_data = ecl_kw_get_data_ref( mul_kw );                                \
-    int i;                                                                                 \
-    for (i=0; i < target_kw->size; i++)                                                    \
-      target_data[i] *= mul_data[i];                                                       \
+    ecl_kw_kernel_mul_ ## ctype( target_data , mul_data , target_kw->size );             \
  }                                                                                         \
 }
 ECL_KW_TYPED_INPLACE_MUL( int )
@@ -2354,11 +2514,7 @@ static void ecl_kw_inplace_mul_indexed_ ## ctype( ecl_kw_type * target_kw , cons
     const ctype * mul_data = ecl_kw_get_data_ref( mul_kw );                                \
     int set_size     = int_vector_size( index_set );                                       \
     const int * index_data = int_vector_get_const_ptr( index_set );                        \
-    int i;                                                                                 \
-    for (i=0; i < set_size; i++) {                                                         \
-      int index = index_data[i];                                                           \
-      target_data[index] *= mul_data[index];                                               \
-    }                                                                                      \
+    ecl_kw_kernel_mul_indexed_ ## ctype( target_data , mul_data , index_data , set_size ); \
   }                                                                                        \
 }
 
@@ -2396,9 +2552,7 @@ void ecl_kw_inplace_div_ ## ctype( ecl_kw_type * target_kw , const ecl_kw_type *
  {                                                                                         \
     ctype * target_data = ecl_kw_get_data_ref( target_kw );                                \
     const ctype * div_data = ecl_kw_get_data_ref( div_kw );                                \
-    int i;                                                                                 \
-    for (i=0; i < target_kw->size; i++)                                                    \
-      target_data[i] /= div_data[i];                                                       \
+    ecl_kw_kernel_div_ ## ctype( target_data , div_data , target_kw->size );             \
  }                                                                                         \
 }
 ECL_KW_TYPED_INPLACE_DIV( int )
@@ -2433,11 +2587,7 @@ static void ecl_kw_inplace_div_indexed_ ## ctype( ecl_kw_type * target_kw , cons
     const ctype * div_data = ecl_kw_get_data_ref( div_kw );                                \
     int set_size     = int_vector_size( index_set );                                       \
     const int * index_data = int_vector_get_const_ptr( index_set );                        \
-    int i;                                                                                 \
-    for (i=0; i < set_size; i++) {                                                         \
-      int index = index_data[i];                                                           \
-      target_data[index] *= div_data[index];                                               \
-    }                                                                                      \
+    ecl_kw_kernel_div_indexed_ ## ctype( target_data , div_data , index_data , set_size ); \
   }                                                                                        \
 }
 
@@ -2559,16 +2709,14 @@ bool ecl_kw_is_kw_file(fortio_type * fortio) {
 }
 
 
-#define KW_MAX_MIN(type)                                       \
-{                                                              \
-  type * data = ecl_kw_get_data_ref(ecl_kw);                   \
-  type max = data[0];                                          \
-  type min = data[0];                                          \
-  int i;                                                       \
-  for (i=1; i < ecl_kw_get_size(ecl_kw); i++)                  \
-      util_update_ ## type ## _max_min(data[i] , &max , &min); \
-  memcpy(_max , &max , ecl_kw_get_sizeof_ctype(ecl_kw));       \
-  memcpy(_min , &min , ecl_kw_get_sizeof_ctype(ecl_kw));       \
+#define KW_MAX_MIN(type)                                                      \
+{                                                                             \
+  const type * data = ecl_kw_get_data_ref(ecl_kw);                            \
+  type max = 0;                                                               \
+  type min = 0;                                                               \
+  ecl_kw_kernel_max_min_ ## type( data , ecl_kw_get_size(ecl_kw) , &max , &min); \
+  memcpy(_max , &max , ecl_kw_get_sizeof_ctype(ecl_kw));                      \
+  memcpy(_min , &min , ecl_kw_get_sizeof_ctype(ecl_kw));                      \
 }
 
 
@@ -2630,11 +2778,9 @@ ECL_KW_MIN( double )
 #define KW_SUM_INDEXED(type)                                       \
 {                                                                  \
   const type * data = ecl_kw_get_data_ref(ecl_kw);                 \
-  type sum = 0;                                                    \
   int size = int_vector_size( index_list );                        \
   const int * index_ptr = int_vector_get_const_ptr( index_list );  \
-  for (int i = 0; i < size; i++)                                   \
-     sum += data[index_ptr[i]];                                    \
+  type sum = (type) ecl_kw_kernel_sum_indexed_ ## type( data , index_ptr , size ); \
   memcpy(_sum , &sum , ecl_kw_get_sizeof_ctype(ecl_kw));           \
 }
 
@@ -2675,13 +2821,11 @@ void ecl_kw_element_sum_indexed(const ecl_kw_type * ecl_kw , const int_vector_ty
 
 
 
-#define KW_SUM(type)                                        \
-{                                                           \
-  const type * data = ecl_kw_get_data_ref(ecl_kw);          \
-  type sum = 0;                                             \
-  for (int i=0; i < ecl_kw_get_size(ecl_kw); i++)           \
-     sum += data[i];                                        \
-  memcpy(_sum , &sum , ecl_kw_get_sizeof_ctype(ecl_kw));    \
+#define KW_SUM(type)                                                           \
+{                                                                              \
+  const type * data = ecl_kw_get_data_ref(ecl_kw);                             \
+  type sum = (type) ecl_kw_kernel_sum_ ## type( data , ecl_kw_get_size(ecl_kw)); \
+  memcpy(_sum , &sum , ecl_kw_get_sizeof_ctype(ecl_kw));                       \
 }
 
 
@@ -2784,13 +2928,6 @@ void ecl_kw_fprintf_data( const ecl_kw_type * ecl_kw , const char * fmt , FILE *
 
 
 
-static bool ecl_kw_elm_equal_numeric__( const ecl_kw_type * ecl_kw1 , const ecl_kw_type * ecl_kw2 , int offset, double abs_epsilon, double rel_epsilon) {
-  double v1 = ecl_kw_iget_as_double( ecl_kw1 , offset );
-  double v2 = ecl_kw_iget_as_double( ecl_kw2 , offset );
-  return util_double_approx_equal__( v1, v2 , rel_epsilon , abs_epsilon );
-}
-
-
 static bool ecl_kw_elm_equal__( const ecl_kw_type * ecl_kw1 , const ecl_kw_type * ecl_kw2 , int offset) {
   size_t data_offset = ecl_kw_get_sizeof_ctype(ecl_kw1) * offset;
   int cmp = memcmp( &ecl_kw1->data[ data_offset ] , &ecl_kw2->data[ data_offset ] , ecl_kw_get_sizeof_ctype(ecl_kw1));
@@ -2810,20 +2947,31 @@ int ecl_kw_first_different( const ecl_kw_type * ecl_kw1 , const ecl_kw_type * ec
     util_abort("%s: sorry - invalid offset value\n",__func__);
 
   {
-    bool numeric_compare = false;
+    int size = ecl_kw_get_size( ecl_kw1 );
+
+    if ((abs_epsilon > 0) || (rel_epsilon > 0)) {
+      if (ecl_type_is_float( ecl_kw1->data_type )) {
+        const float * data1 = (const float *) ecl_kw1->data;
+        const float * data2 = (const float *) ecl_kw2->data;
+        return offset + ecl_kw_kernel_first_diff_float( &data1[offset] , &data2[offset] , size - offset , abs_epsilon , rel_epsilon );
+      }
+
+      if (ecl_type_is_double( ecl_kw1->data_type )) {
+        const double * data1 = (const double *) ecl_kw1->data;
+        const double * data2 = (const double *) ecl_kw2->data;
+        return offset + ecl_kw_kernel_first_diff_double( &data1[offset] , &data2[offset] , size - offset , abs_epsilon , rel_epsilon );
+      }
+    }
 
-    if (((abs_epsilon > 0) || (rel_epsilon > 0)) && ((ecl_kw_get_type( ecl_kw1 ) == ECL_FLOAT_TYPE) || (ecl_kw_get_type( ecl_kw1 ) == ECL_DOUBLE_TYPE)))
-      numeric_compare = true;
     {
       int index = offset;
 
       while (true) {
-        bool equal = (numeric_compare) ? ecl_kw_elm_equal_numeric__( ecl_kw1 , ecl_kw2, index , abs_epsilon, rel_epsilon) : ecl_kw_elm_equal__( ecl_kw1 , ecl_kw2 , index );
-        if (!equal)
+        if (!ecl_kw_elm_equal__( ecl_kw1 , ecl_kw2 , index ))
           break;
 
         index++;
-        if (index == ecl_kw_get_size( ecl_kw1 ))
+        if (index == size)
           break;
       }
 
@@ -0,0 +1,732 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_kw_kernel.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/ert_api_config.h>
+#include "ert/util/build_config.h"
+#include <ert/util/util.h>
+#include <ert/util/thread_pool.h>
+
+#include <ert/ecl/ecl_kw_kernel.h>
+
+/*
+  The kernels in this file implement the elementwise arithmetic and
+  the reductions used by ecl_kw (and thereby ecl_region and the Python
+  EclKW operators) on plain C arrays.
+
+   1. The inner loops are simple unit stride loops which the compiler
+      can vectorize. When the compiler supports it the leaf functions
+      are compiled in an AVX2 and a baseline version, and the loader
+      selects the version to use based on the cpu at runtime
+      (KERNEL_DISPATCH below).
+
+   2. Arrays with more than ECL_KW_KERNEL_PARALLEL_SIZE elements are
+      split in contiguous ranges which are handled by a thread_pool.
+
+   3. Floating point sums are computed in double precision with
+      pairwise summation over fixed blocks of ECL_KW_KERNEL_SUM_BLOCK
+      elements; the block sums are then again added pairwise. The
+      block layout does not depend on the number of threads, or the
+      instruction set used, so the result of a sum is bitwise
+      reproducible.
+
+   The indexed elementwise operations are always run in one thread,
+   since an index list can contain the same cell several times.
+*/
+
+#ifdef HAVE_TARGET_CLONES
+#define KERNEL_DISPATCH __attribute__((target_clones("avx2","default")))
+#else
+#define KERNEL_DISPATCH
+#endif
+
+#define PAIRWISE_BASE_SIZE 128
+
+
+static int kernel_num_threads   = 0;
+static int kernel_parallel_size = ECL_KW_KERNEL_PARALLEL_SIZE;
+
+
+/*
+  A num_threads value of zero (the default) means one thread per cpu.
+*/
+
+void ecl_kw_kernel_set_num_threads( int num_threads ) {
+  kernel_num_threads = util_int_max( 0 , num_threads );
+}
+
+
+int ecl_kw_kernel_get_num_threads( void ) {
+  if (kernel_num_threads > 0)
+    return kernel_num_threads;
+  else
+    return util_get_num_cpu();
+}
+
+
+void ecl_kw_kernel_set_parallel_size( int parallel_size ) {
+  if (parallel_size <= 0)
+    kernel_parallel_size = ECL_KW_KERNEL_PARALLEL_SIZE;
+  else
+    kernel_parallel_size = parallel_size;
+}
+
+/*****************************************************************/
+
+typedef struct {
+  void       * target;
+  const void * src;
+  const int  * index;
+  int          size;
+  double       value;
+  void       * block_max;
+  void       * block_min;
+  double     * block_sum;
+  int64_t    * block_isum;
+} kernel_args_type;
+
+
+/*
+  Will call func( arg , begin , end ) for ranges covering
+  [0,num_items); the work argument is the total number of array
+  elements involved and is used to decide whether to use threads.
+*/
+
+static void kernel_run( thread_pool_range_ftype * func , void * arg , int num_items , int64_t work) {
+#ifdef ERT_HAVE_THREAD_POOL
+  int num_threads = 1;
+  if (work >= kernel_parallel_size)
+    num_threads = ecl_kw_kernel_get_num_threads();
+
+  thread_pool_run_range( func , arg , num_items , num_threads );
+#else
+  func( arg , 0 , num_items );
+#endif
+}
+
+
+static int kernel_num_blocks( int size ) {
+  return (size + ECL_KW_KERNEL_SUM_BLOCK - 1) / ECL_KW_KERNEL_SUM_BLOCK;
+}
+
+/*****************************************************************/
+/* Elementwise binary operations: target[i] OP= src[i].          */
+
+#define KERNEL_BINARY( ctype , name , OP )                                                                 \
+static KERNEL_DISPATCH void kernel_ ## name ## _ ## ctype( ctype * target , const ctype * src , int size) { \
+  int i;                                                                                                    \
+  for (i = 0; i < size; i++)                                                                                \
+    target[i] OP src[i];                                                                                    \
+}                                                                                                           \
+                                                                                                            \
+static void kernel_ ## name ## _ ## ctype ## _range( void * arg , int begin , int end) {                    \
+  kernel_args_type * args = arg;                                                                            \
+  kernel_ ## name ## _ ## ctype( (ctype *) args->target + begin , (const ctype *) args->src + begin , end - begin ); \
+}                                                                                                           \
+                                                                                                            \
+void ecl_kw_kernel_ ## name ## _ ## ctype( ctype * target , const ctype * src , int size) {                 \
+  kernel_args_type args = { .target = target , .src = src };                                                \
+  kernel_run( kernel_ ## name ## _ ## ctype ## _range , &args , size , size );                              \
+}                                                                                                           \
+                                                                                                            \
+void ecl_kw_kernel_ ## name ## _indexed_ ## ctype( ctype * target , const ctype * src , const int * index , int index_size) { \
+  int i;                                                                                                    \
+  for (i = 0; i < index_size; i++)                                                                          \
+    target[index[i]] OP src[index[i]];                                                                      \
+}
+
+#define KERNEL_BINARY_TYPED( ctype )   \
+KERNEL_BINARY( ctype , add , += )      \
+KERNEL_BINARY( ctype , sub , -= )      \
+KERNEL_BINARY( ctype , mul , *= )      \
+KERNEL_BINARY( ctype , div , /= )
+
+KERNEL_BINARY_TYPED( int )
+KERNEL_BINARY_TYPED( float )
+KERNEL_BINARY_TYPED( double )
+#undef KERNEL_BINARY_TYPED
+#undef KERNEL_BINARY
+
+/*****************************************************************/
+/* Operations with a scalar: data[i] OP= value.                  */
+
+#define KERNEL_SCALAR( ctype , name , OP )                                                                 \
+static KERNEL_DISPATCH void kernel_ ## name ## _ ## ctype( ctype * data , int size , ctype value) {          \
+  int i;                                                                                                    \
+  for (i = 0; i < size; i++)                                                                                \
+    data[i] OP value;                                                                                       \
+}                                                                                                           \
+                                                                                                            \
+static void kernel_ ## name ## _ ## ctype ## _range( void * arg , int begin , int end) {                    \
+  kernel_args_type * args = arg;                                                                            \
+  kernel_ ## name ## _ ## ctype( (ctype *) args->target + begin , end - begin , (ctype) args->value );       \
+}                                                                                                           \
+                                                                                                            \
+void ecl_kw_kernel_ ## name ## _ ## ctype( ctype * data , int size , ctype value) {                         \
+  kernel_args_type args = { .target = data , .value = value };                                              \
+  kernel_run( kernel_ ## name ## _ ## ctype ## _range , &args , size , size );                              \
+}
+
+KERNEL_SCALAR( int    , scale , *= )
+KERNEL_SCALAR( float  , scale , *= )
+KERNEL_SCALAR( double , scale , *= )
+KERNEL_SCALAR( int    , shift , += )
+KERNEL_SCALAR( float  , shift , += )
+KERNEL_SCALAR( double , shift , += )
+#undef KERNEL_SCALAR
+
+/*****************************************************************/
+/* Max / min; computed per block and combined in block order.     */
+
+#define KERNEL_MAX_MIN( ctype )                                                                            \
+static KERNEL_DISPATCH void kernel_max_min_ ## ctype( const ctype * data , int size , ctype * _max , ctype * _min) { \
+  ctype max = data[0];                                                                                      \
+  ctype min = data[0];                                                                                      \
+  int i;                                                                                                    \
+  for (i = 1; i < size; i++) {                                                                              \
+    max = (data[i] > max) ? data[i] : max;                                                                  \
+    min = (data[i] < min) ? data[i] : min;                                                                  \
+  }                                                                                                         \
+  *_max = max;                                                                                              \
+  *_min = min;                                                                                              \
+}                                                                                                           \
+                                                                                                            \
+static void kernel_max_min_ ## ctype ## _range( void * arg , int begin , int end) {                         \
+  kernel_args_type * args = arg;                                                                            \
+  const ctype * data = args->src;                                                                           \
+  ctype * block_max = args->block_max;                                                                      \
+  ctype * block_min = args->block_min;                                                                      \
+  int block;                                                                                                \
+  for (block = begin; block < end; block++) {                                                               \
+    int offset = block * ECL_KW_KERNEL_SUM_BLOCK;                                                           \
+    int size = util_int_min( ECL_KW_KERNEL_SUM_BLOCK , args->size - offset );                               \
+    kernel_max_min_ ## ctype( data + offset , size , &block_max[block] , &block_min[block] );               \
+  }                                                                                                         \
+}                                                                                                           \
+                                                                                                            \
+void ecl_kw_kernel_max_min_ ## ctype( const ctype * data , int size , ctype * _max , ctype * _min) {         \
+  if (size == 0)                                                                                            \
+    return;                                                                                                 \
+  {                                                                                                         \
+    int num_blocks = kernel_num_blocks( size );                                                             \
+    ctype * block_max = util_calloc( num_blocks , sizeof * block_max );                                     \
+    ctype * block_min = util_calloc( num_blocks , sizeof * block_min );                                     \
+    kernel_args_type args = { .src = data , .size = size , .block_max = block_max , .block_min = block_min }; \
+    ctype max , min;                                                                                        \
+    int block;                                                                                              \
+                                                                                                            \
+    kernel_run( kernel_max_min_ ## ctype ## _range , &args , num_blocks , size );                           \
+    max = block_max[0];                                                                                     \
+    min = block_min[0];                                                                                     \
+    for (block = 1; block < num_blocks; block++) {                                                          \
+      max = (block_max[block] > max) ? block_max[block] : max;                                              \
+      min = (block_min[block] < min) ? block_min[block] : min;                                              \
+    }                                                                                                       \
+    *_max = max;                                                                                            \
+    *_min = min;                                                                                            \
+    free( block_max );                                                                                      \
+    free( block_min );                                                                                      \
+  }                                                                                                         \
+}
+
+KERNEL_MAX_MIN( int )
+KERNEL_MAX_MIN( float )
+KERNEL_MAX_MIN( double )
+#undef KERNEL_MAX_MIN
+
+/*****************************************************************/
+/* Sums.                                                          */
+
+/*
+  The floating point sums use eight independent accumulators in the
+  leaf functions, which both lets the compiler vectorize the loop and
+  fixes the order of the additions. The leaf functions are used for
+  ranges up to PAIRWISE_BASE_SIZE elements, and the ranges are
+  combined pairwise.
+*/
+
+#define SUM_LEAF_BODY( LOAD )                                                                              \
+  double acc[8] = {0,0,0,0,0,0,0,0};                                                                        \
+  double sum;                                                                                               \
+  int i = 0;                                                                                                \
+  int j;                                                                                                    \
+  for (; i + 8 <= size; i += 8)                                                                             \
+    for (j = 0; j < 8; j++)                                                                                 \
+      acc[j] += (double) LOAD( i + j );                                                                     \
+                                                                                                            \
+  sum = ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));                  \
+  for (; i < size; i++)                                                                                     \
+    sum += (double) LOAD( i );                                                                              \
+  return sum;
+
+#define PLAIN_LOAD( i )   data[(i)]
+#define INDEXED_LOAD( i ) data[index[(i)]]
+
+
+#define KERNEL_SUM( ctype )                                                                                \
+static KERNEL_DISPATCH double kernel_sum_leaf_ ## ctype( const ctype * data , int size) {                   \
+  SUM_LEAF_BODY( PLAIN_LOAD )                                                                               \
+}                                                                                                           \
+                                                                                                            \
+static KERNEL_DISPATCH double kernel_sum_leaf_indexed_ ## ctype( const ctype * data , const int * index , int size) { \
+  SUM_LEAF_BODY( INDEXED_LOAD )                                                                             \
+}                                                                                                           \
+                                                                                                            \
+static double kernel_sum_pairwise_ ## ctype( const ctype * data , const int * index , int size) {          \
+  if (size <= PAIRWISE_BASE_SIZE) {                                                                         \
+    if (index)                                                                                              \
+      return kernel_sum_leaf_indexed_ ## ctype( data , index , size );                                      \
+    else                                                                                                    \
+      return kernel_sum_leaf_ ## ctype( data , size );                                                      \
+  } else {                                                                                                  \
+    int half = (size / 2) & ~7;                                                                             \
+    if (index)                                                                                              \
+      return kernel_sum_pairwise_ ## ctype( data , index , half ) +                                         \
+             kernel_sum_pairwise_ ## ctype( data , index + half , size - half );                            \
+    else                                                                                                    \
+      return kernel_sum_pairwise_ ## ctype( data , NULL , half ) +                                          \
+             kernel_sum_pairwise_ ## ctype( data + half , NULL , size - half );                             \
+  }                                                                                                         \
+}                                                                                                           \
+                                                                                                            \
+static void kernel_sum_ ## ctype ## _range( void * arg , int begin , int end) {                             \
+  kernel_args_type * args = arg;                                                                            \
+  const ctype * data = args->src;                                                                           \
+  int block;                                                                                                \
+  for (block = begin; block < end; block++) {                                                               \
+    int offset = block * ECL_KW_KERNEL_SUM_BLOCK;                                                           \
+    int size = util_int_min( ECL_KW_KERNEL_SUM_BLOCK , args->size - offset );                               \
+    if (args->index)                                                                                        \
+      args->block_sum[block] = kernel_sum_pairwise_ ## ctype( data , args->index + offset , size );         \
+    else                                                                                                    \
+      args->block_sum[block] = kernel_sum_pairwise_ ## ctype( data + offset , NULL , size );                \
+  }                                                                                                         \
+}                                                                                                           \
+                                                                                                            \
+static double kernel_sum_ ## ctype( const ctype * data , const int * index , int size) {                    \
+  int num_blocks = kernel_num_blocks( size );                                                               \
+  if (num_blocks <= 1)                                                                                      \
+    return kernel_sum_pairwise_ ## ctype( data , index , size );                                            \
+  {                                                                                                         \
+    double * block_sum = util_calloc( num_blocks , sizeof * block_sum );                                    \
+    kernel_args_type args = { .src = data , .index = index , .size = size , .block_sum = block_sum };       \
+    double sum;                                                                                             \
+                                                                                                            \
+    kernel_run( kernel_sum_ ## ctype ## _range , &args , num_blocks , size );                               \
+    sum = kernel_sum_pairwise_double( block_sum , NULL , num_blocks );                                      \
+    free( block_sum );                                                                                      \
+    return sum;                                                                                             \
+  }                                                                                                         \
+}                                                                                                           \
+                                                                                                            \
+double ecl_kw_kernel_sum_ ## ctype( const ctype * data , int size) {                                        \
+  return kernel_sum_ ## ctype( data , NULL , size );                                                        \
+}                                                                                                           \
+                                                                                                            \
+double ecl_kw_kernel_sum_indexed_ ## ctype( const ctype * data , const int * index , int index_size) {       \
+  return kernel_sum_ ## ctype( data , index , index_size );                                                 \
+}
+
+KERNEL_SUM( double )
+KERNEL_SUM( float )
+#undef KERNEL_SUM
+#undef SUM_LEAF_BODY
+
+
+/*
+  Integer sums are accumulated in 64 bit; integer addition is
+  associative so the blocks are only used to split the work.
+*/
+
+static KERNEL_DISPATCH int64_t kernel_sum_leaf_int( const int * data , int size) {
+  int64_t sum = 0;
+  int i;
+  for (i = 0; i < size; i++)
+    sum += data[i];
+  return sum;
+}
+
+
+static int64_t kernel_sum_leaf_indexed_int( const int * data , const int * index , int size) {
+  int64_t sum = 0;
+  int i;
+  for (i = 0; i < size; i++)
+    sum += data[index[i]];
+  return sum;
+}
+
+
+static void kernel_sum_int_range( void * arg , int begin , int end) {
+  kernel_args_type * args = arg;
+  const int * data = args->src;
+  int block;
+  for (block = begin; block < end; block++) {
+    int offset = block * ECL_KW_KERNEL_SUM_BLOCK;
+    int size = util_int_min( ECL_KW_KERNEL_SUM_BLOCK , args->size - offset );
+    if (args->index)
+      args->block_isum[block] = kernel_sum_leaf_indexed_int( data , args->index + offset , size );
+    else
+      args->block_isum[block] = kernel_sum_leaf_int( data + offset , size );
+  }
+}
+
+
+static int64_t kernel_sum_int( const int * data , const int * index , int size) {
+  int num_blocks = kernel_num_blocks( size );
+  int64_t * block_isum = util_calloc( util_int_max( 1 , num_blocks ) , sizeof * block_isum );
+  kernel_args_type args = { .src = data , .index = index , .size = size , .block_isum = block_isum };
+  int64_t sum = 0;
+  int block;
+
+  kernel_run( kernel_sum_int_range , &args , num_blocks , size );
+  for (block = 0; block < num_blocks; block++)
+    sum += block_isum[block];
+
+  free( block_isum );
+  return sum;
+}
+
+
+int64_t ecl_kw_kernel_sum_int( const int * data , int size) {
+  return kernel_sum_int( data , NULL , size );
+}
+
+
+int64_t ecl_kw_kernel_sum_indexed_int( const int * data , const int * index , int index_size) {
+  return kernel_sum_int( data , index , index_size );
+}
+
+#undef PLAIN_LOAD
+#undef INDEXED_LOAD
+
+/*****************************************************************/
+/* Gather / scatter through an index map.                         */
+
+/*
+  The gather and scatter kernels copy elements through an index map,
+  typically the index_map / inv_index_map of an ecl_grid:
+
+     gather:   target[i]        = src[index[i]]
+     scatter:  target[index[i]] = src[i]
+
+  The elements are moved as opaque 4 or 8 byte words, so the same
+  kernels serve int, float, bool and double keywords; other element
+  sizes (i.e. character keywords) fall back to memcpy(). With AVX2 the
+  compiler turns the gather loops into vector gather instructions.
+
+  The list versions apply the same index map to several arrays, the
+  work is split in (array, block) items so that many small keywords
+  are spread over the threads just as well as one large keyword. The
+  scatter kernels can be threaded, hence the index values must be
+  distinct.
+*/
+
+#define KERNEL_MOVE( wtype )                                                                               \
+static KERNEL_DISPATCH void kernel_gather_ ## wtype( wtype * target , const wtype * src , const int * index , int size) { \
+  int i;                                                                                                    \
+  for (i = 0; i < size; i++)                                                                                \
+    target[i] = src[index[i]];                                                                              \
+}                                                                                                           \
+                                                                                                            \
+static KERNEL_DISPATCH void kernel_scatter_ ## wtype( wtype * target , const wtype * src , const int * index , int size) { \
+  int i;                                                                                                    \
+  for (i = 0; i < size; i++)                                                                                \
+    target[index[i]] = src[i];                                                                              \
+}
+
+KERNEL_MOVE( int32_t )
+KERNEL_MOVE( int64_t )
+#undef KERNEL_MOVE
+
+
+static void kernel_move_bytes( char * target , const char * src , int element_size , const int * index , int size , bool gather) {
+  int i;
+  for (i = 0; i < size; i++) {
+    if (gather)
+      memcpy( &target[ (size_t) i * element_size ] , &src[ (size_t) index[i] * element_size ] , element_size );
+    else
+      memcpy( &target[ (size_t) index[i] * element_size ] , &src[ (size_t) i * element_size ] , element_size );
+  }
+}
+
+
+typedef struct {
+  void       ** target;
+  const void ** src;
+  const int   * element_size;
+  const int   * index;
+  int           size;
+  int           num_blocks;
+  bool          gather;
+} kernel_move_args_type;
+
+
+static void kernel_move_range( void * arg , int begin , int end) {
+  kernel_move_args_type * args = arg;
+  int item;
+  for (item = begin; item < end; item++) {
+    int array        = item / args->num_blocks;
+    int offset       = (item % args->num_blocks) * ECL_KW_KERNEL_SUM_BLOCK;
+    int size         = util_int_min( ECL_KW_KERNEL_SUM_BLOCK , args->size - offset );
+    int element_size = args->element_size[array];
+    const int * index = args->index + offset;
+    char * target     = args->target[array];
+    const char * src  = args->src[array];
+
+    /*
+      For gather the output is contiguous and the input indexed; for
+      scatter it is the other way round.
+    */
+    if (args->gather)
+      target += (size_t) offset * element_size;
+    else
+      src += (size_t) offset * element_size;
+
+    if (element_size == 4) {
+      if (args->gather)
+        kernel_gather_int32_t( (int32_t *) target , (const int32_t *) src , index , size );
+      else
+        kernel_scatter_int32_t( (int32_t *) target , (const int32_t *) src , index , size );
+    } else if (element_size == 8) {
+      if (args->gather)
+        kernel_gather_int64_t( (int64_t *) target , (const int64_t *) src , index , size );
+      else
+        kernel_scatter_int64_t( (int64_t *) target , (const int64_t *) src , index , size );
+    } else
+      kernel_move_bytes( target , src , element_size , index , size , args->gather );
+  }
+}
+
+
+static void kernel_move( int num_arrays , void ** target , const void ** src , const int * element_size , const int * index , int size , bool gather) {
+  int num_blocks = kernel_num_blocks( size );
+  if (num_blocks == 0)
+    return;
+  {
+    kernel_move_args_type args = { .target = target , .src = src , .element_size = element_size ,
+                                   .index = index , .size = size , .num_blocks = num_blocks , .gather = gather };
+    kernel_run( kernel_move_range , &args , num_arrays * num_blocks , (int64_t) num_arrays * size );
+  }
+}
+
+
+void ecl_kw_kernel_gather( void * target , const void * src , int element_size , const int * index , int size) {
+  kernel_move( 1 , &target , &src , &element_size , index , size , true );
+}
+
+
+void ecl_kw_kernel_scatter( void * target , const void * src , int element_size , const int * index , int size) {
+  kernel_move( 1 , &target , &src , &element_size , index , size , false );
+}
+
+
+void ecl_kw_kernel_gather_list( int num_arrays , void ** target , const void ** src , const int * element_size , const int * index , int size) {
+  kernel_move( num_arrays , target , src , element_size , index , size , true );
+}
+
+
+void ecl_kw_kernel_scatter_list( int num_arrays , void ** target , const void ** src , const int * element_size , const int * index , int size) {
+  kernel_move( num_arrays , target , src , element_size , index , size , false );
+}
+
+
+/*****************************************************************/
+/* Comparison of two arrays.                                      */
+
+/*
+  The tolerance test is the one in util_double_approx_equal__(): with
+  diff = |v1 - v2| two elements are different if abs_epsilon > 0 and
+  diff > abs_epsilon, or if rel_epsilon > 0 and diff / (|v1| + |v2|) >
+  rel_epsilon. If neither epsilon is positive the elements must be
+  exactly equal. In addition a NaN is only equal to another NaN. All
+  types are compared in double precision.
+
+  The count and the max deviations are computed per block, with
+  vectorizable loops, and combined in block order; the first
+  difference and the positions of the max deviations are then found
+  by rescanning only the blocks involved.
+*/
+
+static inline int kernel_cmp_elm( double v1 , double v2 , double abs_epsilon , double rel_epsilon , double * abs_diff , double * rel_diff) {
+  double diff = fabs( v1 - v2 );
+  double sum  = fabs( v1 ) + fabs( v2 );
+  double rel  = (sum > 0) ? diff / sum : 0;
+  int nan_diff = ((v1 != v1) != (v2 != v2));
+  int different;
+
+  if ((abs_epsilon > 0) || (rel_epsilon > 0))
+    different = ((abs_epsilon > 0) && (diff > abs_epsilon)) || ((rel_epsilon > 0) && (rel > rel_epsilon));
+  else
+    different = (diff > 0);
+
+  *abs_diff = diff;
+  *rel_diff = rel;
+  return different || nan_diff;
+}
+
+
+typedef struct {
+  const void * data1;
+  const void * data2;
+  int          size;
+  double       abs_epsilon;
+  double       rel_epsilon;
+  int64_t    * block_num_diff;
+  double     * block_abs_diff;
+  double     * block_rel_diff;
+} kernel_cmp_args_type;
+
+
+/*
+  mode == 0: first element which is different, mode == 1: first
+  element with abs deviation == value, mode == 2: first element with
+  rel deviation == value. Returns end if no element is found.
+*/
+
+#define KERNEL_CMP( ctype )                                                                                 \
+static KERNEL_DISPATCH void kernel_cmp_leaf_ ## ctype( const ctype * data1 , const ctype * data2 , int size , \
+                                                       double abs_epsilon , double rel_epsilon ,            \
+                                                       int64_t * _num_diff , double * _abs_diff , double * _rel_diff) { \
+  int64_t num_diff = 0;                                                                                     \
+  double max_abs = 0;                                                                                       \
+  double max_rel = 0;                                                                                       \
+  int i;                                                                                                    \
+  for (i = 0; i < size; i++) {                                                                              \
+    double abs_diff , rel_diff;                                                                             \
+    num_diff += kernel_cmp_elm( data1[i] , data2[i] , abs_epsilon , rel_epsilon , &abs_diff , &rel_diff );  \
+    max_abs = (abs_diff > max_abs) ? abs_diff : max_abs;                                                    \
+    max_rel = (rel_diff > max_rel) ? rel_diff : max_rel;                                                    \
+  }                                                                                                         \
+  *_num_diff = num_diff;                                                                                    \
+  *_abs_diff = max_abs;                                                                                     \
+  *_rel_diff = max_rel;                                                                                     \
+}                                                                                                           \
+                                                                                                            \
+static void kernel_cmp_ ## ctype ## _range( void * arg , int begin , int end) {                             \
+  kernel_cmp_args_type * args = arg;                                                                        \
+  const ctype * data1 = args->data1;                                                                        \
+  const ctype * data2 = args->data2;                                                                        \
+  int block;                                                                                                \
+  for (block = begin; block < end; block++) {                                                               \
+    int offset = block * ECL_KW_KERNEL_SUM_BLOCK;                                                           \
+    int size = util_int_min( ECL_KW_KERNEL_SUM_BLOCK , args->size - offset );                               \
+    kernel_cmp_leaf_ ## ctype( data1 + offset , data2 + offset , size , args->abs_epsilon , args->rel_epsilon , \
+                               &args->block_num_diff[block] , &args->block_abs_diff[block] , &args->block_rel_diff[block] ); \
+  }                                                                                                         \
+}                                                                                                           \
+                                                                                                            \
+static int kernel_cmp_scan_ ## ctype( const ctype * data1 , const ctype * data2 , int offset , int end ,    \
+                                      double abs_epsilon , double rel_epsilon , int mode , double value) {   \
+  int i;                                                                                                    \
+  for (i = offset; i < end; i++) {                                                                          \
+    double abs_diff , rel_diff;                                                                             \
+    int different = kernel_cmp_elm( data1[i] , data2[i] , abs_epsilon , rel_epsilon , &abs_diff , &rel_diff ); \
+    if ((mode == 0) && different)                                                                           \
+      break;                                                                                                \
+    if ((mode == 1) && (abs_diff == value))                                                                 \
+      break;                                                                                                \
+    if ((mode == 2) && (rel_diff == value))                                                                 \
+      break;                                                                                                \
+  }                                                                                                         \
+  return i;                                                                                                 \
+}                                                                                                           \
+                                                                                                            \
+void ecl_kw_kernel_cmp_ ## ctype( const ctype * data1 , const ctype * data2 , int size ,                    \
+                                  double abs_epsilon , double rel_epsilon , ecl_kw_kernel_cmp_type * result) { \
+  result->num_diff      = 0;                                                                                \
+  result->first_diff    = -1;                                                                               \
+  result->max_abs_diff  = 0;                                                                                \
+  result->max_abs_index = -1;                                                                               \
+  result->max_rel_diff  = 0;                                                                                \
+  result->max_rel_index = -1;                                                                               \
+  if (size > 0) {                                                                                           \
+    int num_blocks = kernel_num_blocks( size );                                                             \
+    int64_t * block_num_diff = util_calloc( num_blocks , sizeof * block_num_diff );                         \
+    double * block_abs_diff  = util_calloc( num_blocks , sizeof * block_abs_diff );                         \
+    double * block_rel_diff  = util_calloc( num_blocks , sizeof * block_rel_diff );                         \
+    kernel_cmp_args_type args = { .data1 = data1 , .data2 = data2 , .size = size ,                          \
+                                  .abs_epsilon = abs_epsilon , .rel_epsilon = rel_epsilon ,                 \
+                                  .block_num_diff = block_num_diff ,                                        \
+                                  .block_abs_diff = block_abs_diff ,                                        \
+                                  .block_rel_diff = block_rel_diff };                                       \
+    int first_block = -1;                                                                                   \
+    int abs_block = 0;                                                                                      \
+    int rel_block = 0;                                                                                      \
+    int block;                                                                                              \
+                                                                                                            \
+    kernel_run( kernel_cmp_ ## ctype ## _range , &args , num_blocks , size );                               \
+    for (block = 0; block < num_blocks; block++) {                                                          \
+      result->num_diff += block_num_diff[block];                                                            \
+      if ((first_block < 0) && (block_num_diff[block] > 0))                                                 \
+        first_block = block;                                                                                \
+      if (block_abs_diff[block] > block_abs_diff[abs_block])                                                \
+        abs_block = block;                                                                                  \
+      if (block_rel_diff[block] > block_rel_diff[rel_block])                                                \
+        rel_block = block;                                                                                  \
+    }                                                                                                       \
+                                                                                                            \
+    if (first_block >= 0) {                                                                                 \
+      int offset = first_block * ECL_KW_KERNEL_SUM_BLOCK;                                                   \
+      int end = util_int_min( size , offset + ECL_KW_KERNEL_SUM_BLOCK );                                    \
+      result->first_diff = kernel_cmp_scan_ ## ctype( data1 , data2 , offset , end , abs_epsilon , rel_epsilon , 0 , 0 ); \
+    }                                                                                                       \
+                                                                                                            \
+    result->max_abs_diff = block_abs_diff[abs_block];                                                       \
+    if (result->max_abs_diff > 0) {                                                                         \
+      int offset = abs_block * ECL_KW_KERNEL_SUM_BLOCK;                                                     \
+      int end = util_int_min( size , offset + ECL_KW_KERNEL_SUM_BLOCK );                                    \
+      result->max_abs_index = kernel_cmp_scan_ ## ctype( data1 , data2 , offset , end , abs_epsilon , rel_epsilon , 1 , result->max_abs_diff ); \
+    }                                                                                                       \
+                                                                                                            \
+    result->max_rel_diff = block_rel_diff[rel_block];                                                       \
+    if (result->max_rel_diff > 0) {                                                                         \
+      int offset = rel_block * ECL_KW_KERNEL_SUM_BLOCK;                                                     \
+      int end = util_int_min( size , offset + ECL_KW_KERNEL_SUM_BLOCK );                                    \
+      result->max_rel_index = kernel_cmp_scan_ ## ctype( data1 , data2 , offset , end , abs_epsilon , rel_epsilon , 2 , result->max_rel_diff ); \
+    }                                                                                                       \
+                                                                                                            \
+    free( block_num_diff );                                                                                 \
+    free( block_abs_diff );                                                                                 \
+    free( block_rel_diff );                                                                                 \
+  }                                                                                                         \
+}                                                                                                           \
+                                                                                                            \
+int ecl_kw_kernel_first_diff_ ## ctype( const ctype * data1 , const ctype * data2 , int size ,              \
+                                        double abs_epsilon , double rel_epsilon) {                          \
+  int offset;                                                                                               \
+  for (offset = 0; offset < size; offset += ECL_KW_KERNEL_SUM_BLOCK) {                                      \
+    int block_size = util_int_min( ECL_KW_KERNEL_SUM_BLOCK , size - offset );                               \
+    int64_t num_diff;                                                                                       \
+    double abs_diff , rel_diff;                                                                             \
+    kernel_cmp_leaf_ ## ctype( data1 + offset , data2 + offset , block_size , abs_epsilon , rel_epsilon ,   \
+                               &num_diff , &abs_diff , &rel_diff );                                         \
+    if (num_diff > 0)                                                                                       \
+      return kernel_cmp_scan_ ## ctype( data1 , data2 , offset , offset + block_size , abs_epsilon , rel_epsilon , 0 , 0 ); \
+  }                                                                                                         \
+  return size;                                                                                              \
+}
+
+KERNEL_CMP( int )
+KERNEL_CMP( float )
+KERNEL_CMP( double )
+#undef KERNEL_CMP
@@ -0,0 +1,546 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_perf.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <ert/util/util.h>
+#include <ert/ecl/ecl_perf.h>
+
+#ifdef ERT_HAVE_UNISTD
+#include <unistd.h>
+#endif
+
+/*
+  Each thread which touches a counter gets its own ecl_perf_thread
+  block, so that the counters can be updated without locking or
+  atomic operations. The blocks are linked together in a global list
+  which is only traversed when the counters are queried. When a
+  thread exits its counts and trace events are moved over to the
+  'retired' block, so that short lived threads, e.g. from the
+  thread_pool, do not accumulate.
+
+  Reading the counters while other threads are doing I/O is safe, but
+  the result is only a snapshot; the counters of the other threads
+  might be updated while they are summed up.
+
+  When tracing is enabled each instrumented call is in addition
+  recorded as an event with start time and duration, these can be
+  written out in the Chrome trace event format with
+  ecl_perf_fwrite_trace() and viewed in chrome://tracing or
+  Perfetto. The environment variables ECL_PERF_JSON and ECL_PERF_TRACE
+  can be set to filenames where the counters and the trace
+  respectively will be written when the process exits.
+*/
+
+#define ECL_PERF_ARG_LENGTH  32
+#define ECL_PERF_MAX_EVENTS  (1 << 20)
+
+typedef struct {
+  const char * name;
+  int          thread_id;
+  char         arg[ECL_PERF_ARG_LENGTH];
+  int64_t      start_ns;
+  int64_t      duration_ns;
+} ecl_perf_event_type;
+
+
+typedef struct ecl_perf_thread_struct ecl_perf_thread_type;
+
+struct ecl_perf_thread_struct {
+  int64_t                counters[ECL_PERF_NUM_COUNTERS];
+  int                    thread_id;
+  int                    num_events;
+  int                    alloc_events;
+  ecl_perf_event_type  * events;
+  ecl_perf_thread_type * next;
+};
+
+
+static const char * counter_names[ECL_PERF_NUM_COUNTERS] = {"bytes_read",
+                                                           "bytes_written",
+                                                           "records_read",
+                                                           "records_written",
+                                                           "kw_read",
+                                                           "kw_written",
+                                                           "seek",
+                                                           "endian_ns",
+                                                           "formatted_ns",
+                                                           "cache_hit",
+                                                           "cache_miss"};
+
+static volatile int    perf_state    = -1;     /* -1: not initialized, 0: off, 1: counters, 2: counters and trace. */
+static int             next_thread_id = 0;
+static int             total_events  = 0;
+static int64_t         clock_origin  = 0;
+static char          * json_file     = NULL;
+static char          * trace_file    = NULL;
+static ecl_perf_thread_type * thread_list = NULL;
+static ecl_perf_thread_type   retired;
+
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t perf_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t  perf_once = PTHREAD_ONCE_INIT;
+static pthread_key_t   perf_key;
+#define ECL_PERF_LOCK()   pthread_mutex_lock( &perf_lock )
+#define ECL_PERF_UNLOCK() pthread_mutex_unlock( &perf_lock )
+#else
+static ecl_perf_thread_type * single_thread = NULL;
+#define ECL_PERF_LOCK()
+#define ECL_PERF_UNLOCK()
+#endif
+
+
+int64_t ecl_perf_clock_ns( void ) {
+#ifdef HAVE_CLOCK_GETTIME
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC , &ts );
+  return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+  return (int64_t) ((double) clock() * 1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+
+static void ecl_perf_thread_merge( ecl_perf_thread_type * target , ecl_perf_thread_type * src) {
+  for (int i=0; i < ECL_PERF_NUM_COUNTERS; i++)
+    target->counters[i] += src->counters[i];
+
+  if (src->num_events > 0) {
+    if (target->num_events + src->num_events > target->alloc_events) {
+      target->alloc_events = 2 * (target->num_events + src->num_events);
+      target->events = util_realloc( target->events , target->alloc_events * sizeof * target->events );
+    }
+    memcpy( &target->events[target->num_events] , src->events , src->num_events * sizeof * src->events );
+    target->num_events += src->num_events;
+  }
+}
+
+
+#ifdef HAVE_PTHREAD
+
+/* Called by pthreads when a thread which has a counter block exits. */
+static void ecl_perf_thread_exit( void * arg ) {
+  ecl_perf_thread_type * thread = arg;
+  ECL_PERF_LOCK();
+  {
+    ecl_perf_thread_type ** ptr = &thread_list;
+    while (*ptr != thread)
+      ptr = &(*ptr)->next;
+    *ptr = thread->next;
+
+    ecl_perf_thread_merge( &retired , thread );
+  }
+  ECL_PERF_UNLOCK();
+  free( thread->events );
+  free( thread );
+}
+
+#endif
+
+
+static void ecl_perf_atexit( void ) {
+  if (json_file)
+    ecl_perf_fwrite_json( json_file );
+
+  if (trace_file)
+    ecl_perf_fwrite_trace( trace_file );
+}
+
+
+static void ecl_perf_init__( void ) {
+  const char * env_perf  = getenv( "ECL_PERF" );
+  const char * env_json  = getenv( "ECL_PERF_JSON" );
+  const char * env_trace = getenv( "ECL_PERF_TRACE" );
+  int state = 0;
+
+#ifdef HAVE_PTHREAD
+  pthread_key_create( &perf_key , ecl_perf_thread_exit );
+#endif
+  memset( &retired , 0 , sizeof retired );
+  retired.thread_id = -1;
+  clock_origin = ecl_perf_clock_ns( );
+
+  if (env_perf && (strcmp( env_perf , "0" ) != 0))
+    state = 1;
+
+  if (env_json && strlen( env_json )) {
+    json_file = util_alloc_string_copy( env_json );
+    state = util_int_max( state , 1 );
+  }
+
+  if (env_trace && strlen( env_trace )) {
+    trace_file = util_alloc_string_copy( env_trace );
+    state = 2;
+  }
+
+  if (json_file || trace_file)
+    atexit( ecl_perf_atexit );
+
+  perf_state = state;
+}
+
+
+static void ecl_perf_init( void ) {
+  if (perf_state < 0) {
+#ifdef HAVE_PTHREAD
+    pthread_once( &perf_once , ecl_perf_init__ );
+#else
+    ecl_perf_init__( );
+#endif
+  }
+}
+
+
+static ecl_perf_thread_type * ecl_perf_get_thread_block( void ) {
+  ecl_perf_thread_type * thread;
+  ecl_perf_init( );
+#ifdef HAVE_PTHREAD
+  thread = pthread_getspecific( perf_key );
+#else
+  thread = single_thread;
+#endif
+
+  if (!thread) {
+    thread = util_malloc( sizeof * thread );
+    memset( thread , 0 , sizeof * thread );
+
+    ECL_PERF_LOCK();
+    thread->thread_id = next_thread_id++;
+    thread->next = thread_list;
+    thread_list = thread;
+    ECL_PERF_UNLOCK();
+
+#ifdef HAVE_PTHREAD
+    pthread_setspecific( perf_key , thread );
+#else
+    single_thread = thread;
+#endif
+  }
+  return thread;
+}
+
+
+void ecl_perf_enable( bool enable ) {
+  ecl_perf_init( );
+  perf_state = enable ? util_int_max( perf_state , 1 ) : 0;
+}
+
+
+bool ecl_perf_enabled( void ) {
+  if (perf_state < 0)
+    ecl_perf_init( );
+  return (perf_state > 0);
+}
+
+
+/*
+  Enabling the trace will also enable the counters; disabling the
+  trace will leave the counters enabled.
+*/
+
+void ecl_perf_trace_enable( bool enable ) {
+  ecl_perf_init( );
+  if (enable)
+    perf_state = 2;
+  else if (perf_state == 2)
+    perf_state = 1;
+}
+
+
+bool ecl_perf_trace_enabled( void ) {
+  ecl_perf_init( );
+  return (perf_state == 2);
+}
+
+
+void ecl_perf_reset( void ) {
+  ecl_perf_init( );
+  ECL_PERF_LOCK();
+  {
+    ecl_perf_thread_type * thread = thread_list;
+    while (thread) {
+      memset( thread->counters , 0 , sizeof thread->counters );
+      thread->num_events = 0;
+      thread = thread->next;
+    }
+    memset( retired.counters , 0 , sizeof retired.counters );
+    retired.num_events = 0;
+    __atomic_store_n( &total_events , 0 , __ATOMIC_RELAXED );
+  }
+  ECL_PERF_UNLOCK();
+}
+
+
+int ecl_perf_num_counters( void ) {
+  return ECL_PERF_NUM_COUNTERS;
+}
+
+
+static void ecl_perf_assert_counter( ecl_perf_counter_enum counter ) {
+  if (((int) counter < 0) || ((int) counter >= ECL_PERF_NUM_COUNTERS))
+    util_abort("%s: invalid counter:%d \n",__func__ , counter);
+}
+
+
+const char * ecl_perf_counter_name( ecl_perf_counter_enum counter ) {
+  ecl_perf_assert_counter( counter );
+  return counter_names[counter];
+}
+
+
+void ecl_perf_add( ecl_perf_counter_enum counter , int64_t value ) {
+  ecl_perf_thread_type * thread = ecl_perf_get_thread_block( );
+  thread->counters[counter] += value;
+}
+
+
+int64_t ecl_perf_get( ecl_perf_counter_enum counter ) {
+  int64_t value;
+  ecl_perf_assert_counter( counter );
+  ecl_perf_init( );
+
+  ECL_PERF_LOCK();
+  {
+    ecl_perf_thread_type * thread = thread_list;
+    value = retired.counters[counter];
+    while (thread) {
+      value += thread->counters[counter];
+      thread = thread->next;
+    }
+  }
+  ECL_PERF_UNLOCK();
+  return value;
+}
+
+
+/*
+  The value of the counter for the calling thread only.
+*/
+
+int64_t ecl_perf_get_thread( ecl_perf_counter_enum counter ) {
+  ecl_perf_assert_counter( counter );
+  return ecl_perf_get_thread_block( )->counters[counter];
+}
+
+
+/*
+  Returns 0 when the counters are disabled; in that case the
+  corresponding ecl_perf_timer_stop() and ecl_perf_trace_event()
+  calls are no-ops.
+*/
+
+int64_t ecl_perf_timer_start( void ) {
+  if (ecl_perf_enabled())
+    return ecl_perf_clock_ns( );
+  else
+    return 0;
+}
+
+
+void ecl_perf_timer_stop( ecl_perf_counter_enum counter , int64_t start_ns ) {
+  if (start_ns > 0)
+    ecl_perf_add( counter , ecl_perf_clock_ns( ) - start_ns );
+}
+
+
+/*
+  Records one trace event from @start_ns, which should come from
+  ecl_perf_timer_start(), until now. The name must be a string
+  literal, the optional arg is copied and truncated to the last 31
+  characters.
+
+  The event is appended to the event list of the calling thread while
+  holding the lock, so that ecl_perf_fprintf_trace() and
+  ecl_perf_reset() never see a list which is being reallocated or a
+  half written event.
+*/
+
+void ecl_perf_trace_event( const char * name , const char * arg , int64_t start_ns ) {
+  if ((start_ns > 0) && (perf_state == 2)) {
+    ecl_perf_thread_type * thread = ecl_perf_get_thread_block( );
+    int64_t duration_ns = ecl_perf_clock_ns( ) - start_ns;
+
+    /* Checked again under the lock; this avoids taking the lock when the limit is reached. */
+    if (__atomic_load_n( &total_events , __ATOMIC_RELAXED ) >= ECL_PERF_MAX_EVENTS)
+      return;
+
+    if (arg) {
+      /* Long arguments are typically paths; the tail is kept. */
+      size_t length = strlen( arg );
+      if (length >= ECL_PERF_ARG_LENGTH)
+        arg += length - (ECL_PERF_ARG_LENGTH - 1);
+    }
+
+    ECL_PERF_LOCK();
+    if (__atomic_load_n( &total_events , __ATOMIC_RELAXED ) < ECL_PERF_MAX_EVENTS) {
+      ecl_perf_event_type * event;
+
+      if (thread->num_events == thread->alloc_events) {
+        thread->alloc_events = util_int_max( 256 , 2 * thread->alloc_events );
+        thread->events = util_realloc( thread->events , thread->alloc_events * sizeof * thread->events );
+      }
+
+      event = &thread->events[thread->num_events];
+      event->name = name;
+      event->thread_id = thread->thread_id;
+      event->start_ns = start_ns;
+      event->duration_ns = duration_ns;
+      if (arg)
+        strcpy( event->arg , arg );
+      else
+        event->arg[0] = '\0';
+
+      thread->num_events++;
+      __atomic_fetch_add( &total_events , 1 , __ATOMIC_RELAXED );
+    }
+    ECL_PERF_UNLOCK();
+  }
+}
+
+
+/*****************************************************************/
+
+static void ecl_perf_fprintf_json_string( FILE * stream , const char * s ) {
+  fputc( '"' , stream );
+  while (*s) {
+    unsigned char c = *s;
+    if ((c == '"') || (c == '\\'))
+      fprintf( stream , "\\%c" , c );
+    else if (c < 0x20)
+      fprintf( stream , "\\u%04x" , c );
+    else
+      fputc( c , stream );
+    s++;
+  }
+  fputc( '"' , stream );
+}
+
+
+static void ecl_perf_fprintf_counters( FILE * stream , const int64_t * counters ) {
+  fprintf( stream , "{" );
+  for (int i=0; i < ECL_PERF_NUM_COUNTERS; i++)
+    fprintf( stream , "%s\"%s\": %lld" , (i == 0) ? "" : ", " , counter_names[i] , (long long) counters[i] );
+  fprintf( stream , "}" );
+}
+
+
+/*
+  Writes the counters as a JSON object; the 'total' element is the
+  sum over all threads, and the 'threads' element has the counters of
+  the threads which are still alive.
+*/
+
+void ecl_perf_fprintf_json( FILE * stream ) {
+  ecl_perf_init( );
+  ECL_PERF_LOCK();
+  {
+    int64_t total[ECL_PERF_NUM_COUNTERS];
+    ecl_perf_thread_type * thread;
+
+    memcpy( total , retired.counters , sizeof total );
+    for (thread = thread_list; thread; thread = thread->next) {
+      for (int i=0; i < ECL_PERF_NUM_COUNTERS; i++)
+        total[i] += thread->counters[i];
+    }
+
+    fprintf( stream , "{\"total\": " );
+    ecl_perf_fprintf_counters( stream , total );
+    fprintf( stream , ",\n \"threads\": [" );
+    for (thread = thread_list; thread; thread = thread->next) {
+      fprintf( stream , "%s\n  {\"tid\": %d, \"counters\": " , (thread == thread_list) ? "" : "," , thread->thread_id );
+      ecl_perf_fprintf_counters( stream , thread->counters );
+      fprintf( stream , "}" );
+    }
+    fprintf( stream , "]}\n" );
+  }
+  ECL_PERF_UNLOCK();
+}
+
+
+static void ecl_perf_fprintf_events( FILE * stream , const ecl_perf_thread_type * thread , int pid , bool * first ) {
+  for (int i=0; i < thread->num_events; i++) {
+    const ecl_perf_event_type * event = &thread->events[i];
+    fprintf( stream , "%s\n  {\"name\": \"%s\", \"cat\": \"ecl\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %d, \"tid\": %d" ,
+             (*first) ? "" : ",",
+             event->name ,
+             (event->start_ns - clock_origin) * 1e-3 ,
+             event->duration_ns * 1e-3 ,
+             pid ,
+             event->thread_id );
+    if (event->arg[0]) {
+      fprintf( stream , ", \"args\": {\"arg\": " );
+      ecl_perf_fprintf_json_string( stream , event->arg );
+      fprintf( stream , "}" );
+    }
+    fprintf( stream , "}" );
+    *first = false;
+  }
+}
+
+
+/*
+  Writes the trace events in the Chrome trace event format.
+*/
+
+void ecl_perf_fprintf_trace( FILE * stream ) {
+  int pid = 0;
+#ifdef ERT_HAVE_UNISTD
+  pid = getpid( );
+#endif
+  ecl_perf_init( );
+  ECL_PERF_LOCK();
+  {
+    bool first = true;
+    fprintf( stream , "{\"traceEvents\": [" );
+    ecl_perf_fprintf_events( stream , &retired , pid , &first );
+    for (ecl_perf_thread_type * thread = thread_list; thread; thread = thread->next)
+      ecl_perf_fprintf_events( stream , thread , pid , &first );
+    fprintf( stream , "],\n \"displayTimeUnit\": \"ms\"}\n" );
+  }
+  ECL_PERF_UNLOCK();
+}
+
+
+bool ecl_perf_fwrite_json( const char * filename ) {
+  FILE * stream = fopen( filename , "w" );
+  if (stream) {
+    ecl_perf_fprintf_json( stream );
+    fclose( stream );
+    return true;
+  } else
+    return false;
+}
+
+
+bool ecl_perf_fwrite_trace( const char * filename ) {
+  FILE * stream = fopen( filename , "w" );
+  if (stream) {
+    ecl_perf_fprintf_trace( stream );
+    fclose( stream );
+    return true;
+  } else
+    return false;
+}
@@ -26,7 +26,7 @@
 #endif
 
 #include <ert/util/util.h>
-#include <ert/util/hash.h>
+#include <ert/util/str_hash.h>
 #include <ert/util/vector.h>
 #include <ert/util/int_vector.h>
 
@@ -57,7 +57,7 @@ struct ecl_rft_file_struct {
   UTIL_TYPE_ID_DECLARATION;
   char        * filename;
   vector_type * data;          /* This vector just contains all the rft nodes in one long vector. */
-  hash_type   * well_index;    /* This indexes well names into the data vector - very similar to the scheme used in ecl_file. */
+  str_hash_type * well_index;    /* This indexes well names into the data vector - very similar to the scheme used in ecl_file. */
 };
 
 
@@ -67,7 +67,7 @@ static ecl_rft_file_type * ecl_rft_file_alloc_empty(const char * filename) {
   UTIL_TYPE_ID_INIT( rft_vector , ECL_RFT_FILE_ID );
   rft_vector->data       = vector_alloc_new();
   rft_vector->filename   = util_alloc_string_copy(filename);
-  rft_vector->well_index = hash_alloc();
+  rft_vector->well_index = str_hash_alloc();
   return rft_vector;
 }
 
@@ -103,10 +103,10 @@ ecl_rft_file_type * ecl_rft_file_alloc(const char * filename) {
       if (rft_node != NULL) {
         const char * well_name = ecl_rft_node_get_well_name( rft_node );
         ecl_rft_file_add_node(rft_vector , rft_node);
-        if (!hash_has_key( rft_vector->well_index , well_name))
-          hash_insert_hash_owned_ref( rft_vector->well_index , well_name , int_vector_alloc( 0 , 0 ) , int_vector_free__);
+        if (!str_hash_has_key( rft_vector->well_index , well_name))
+          str_hash_insert_owned_ref( rft_vector->well_index , well_name , int_vector_alloc( 0 , 0 ) , int_vector_free__);
         {
-          int_vector_type * index_list = hash_get( rft_vector->well_index , well_name );
+          int_vector_type * index_list = str_hash_get( rft_vector->well_index , well_name );
           int_vector_append(index_list , global_index);
         }
         global_index++;
@@ -118,6 +118,7 @@ ecl_rft_file_type * ecl_rft_file_alloc(const char * filename) {
     ecl_file_view_free( rft_view );
   }
   ecl_file_close( ecl_file );
+  str_hash_freeze( rft_vector->well_index );
   return rft_vector;
 }
 
@@ -195,7 +196,7 @@ bool ecl_rft_file_case_has_rft( const char * case_input ) {
 
 void ecl_rft_file_free(ecl_rft_file_type * rft_vector) {
   vector_free(rft_vector->data);
-  hash_free( rft_vector->well_index );
+  str_hash_free( rft_vector->well_index );
   free(rft_vector->filename);
   free(rft_vector);
 }
@@ -306,15 +307,15 @@ ecl_rft_node_type * ecl_rft_file_iget_node( const ecl_rft_file_type * rft_file ,
 
 
 ecl_rft_node_type * ecl_rft_file_iget_well_rft( const ecl_rft_file_type * rft_file , const char * well, int index) {
-  const int_vector_type * index_vector = hash_get(rft_file->well_index , well);
+  const int_vector_type * index_vector = str_hash_get(rft_file->well_index , well);
   return ecl_rft_file_iget_node( rft_file , int_vector_iget(index_vector , index));
 }
 
 
 static int ecl_rft_file_get_node_index_time_rft( const ecl_rft_file_type * rft_file , const char * well , time_t recording_time) {
   int global_index = -1;
-  if (hash_has_key( rft_file->well_index , well)) {
-    const int_vector_type * index_vector = hash_get(rft_file->well_index , well);
+  if (str_hash_has_key( rft_file->well_index , well)) {
+    const int_vector_type * index_vector = str_hash_get(rft_file->well_index , well);
     int well_index = 0;
     while (true) {
       if (well_index == int_vector_size( index_vector ))
@@ -355,7 +356,7 @@ ecl_rft_node_type * ecl_rft_file_get_well_time_rft( const ecl_rft_file_type * rf
 
 
 bool ecl_rft_file_has_well( const ecl_rft_file_type * rft_file , const char * well) {
-  return hash_has_key(rft_file->well_index , well);
+  return str_hash_has_key(rft_file->well_index , well);
 }
 
 
@@ -364,7 +365,7 @@ bool ecl_rft_file_has_well( const ecl_rft_file_type * rft_file , const char * we
 */
 
 int ecl_rft_file_get_well_occurences( const ecl_rft_file_type * rft_file , const char * well) {
-  const int_vector_type * index_vector = hash_get(rft_file->well_index , well);
+  const int_vector_type * index_vector = str_hash_get(rft_file->well_index , well);
   return int_vector_size( index_vector );
 }
 
@@ -373,13 +374,13 @@ int ecl_rft_file_get_well_occurences( const ecl_rft_file_type * rft_file , const
    Returns the number of distinct wells in RFT file.
 */
 int ecl_rft_file_get_num_wells( const ecl_rft_file_type * rft_file ) {
-  return hash_get_size( rft_file->well_index );
+  return str_hash_get_size( rft_file->well_index );
 }
 
 
 
 stringlist_type * ecl_rft_file_alloc_well_list(const ecl_rft_file_type * rft_file ) {
-  return hash_alloc_stringlist( rft_file->well_index );
+  return str_hash_alloc_stringlist( rft_file->well_index );
 }
 
 
@@ -21,7 +21,9 @@
 #include <math.h>
 #include <time.h>
 
-#include <ert/util/hash.h>
+#include <ert/util/arena.h>
+#include <ert/util/str_intern.h>
+#include <ert/util/str_hash.h>
 #include <ert/util/util.h>
 #include <ert/util/vector.h>
 #include <ert/util/int_vector.h>
@@ -103,17 +105,19 @@ struct ecl_smspec_struct {
     smspec_node instances. The actual smspec_node instances are
     owned by the smspec_nodes vector;
   */
-  hash_type          * well_var_index;             /* Indexes for all well variables: {well1: {var1: index1 , var2: index2} , well2: {var1: index1 , var2: index2}} */
-  hash_type          * well_completion_var_index;  /* Indexes for completion indexes .*/
-  hash_type          * group_var_index;            /* Indexes for group variables.*/
-  hash_type          * field_var_index;
-  hash_type          * region_var_index;           /* The stored index is an offset. */
-  hash_type          * misc_var_index;             /* Variables like 'TCPU' and 'NEWTON'. */
-  hash_type          * block_var_index;            /* Block variables like BPR */
-  hash_type          * gen_var_index;              /* This is "everything" - things can either be found as gen_var("WWCT:OP_X") or as well_var("WWCT" , "OP_X") */
+  str_hash_type      * well_var_index;             /* Indexes for all well variables: {well1: {var1: index1 , var2: index2} , well2: {var1: index1 , var2: index2}} */
+  str_hash_type      * well_completion_var_index;  /* Indexes for completion indexes .*/
+  str_hash_type      * group_var_index;            /* Indexes for group variables.*/
+  str_hash_type      * field_var_index;
+  str_hash_type      * region_var_index;           /* The stored index is an offset. */
+  str_hash_type      * misc_var_index;             /* Variables like 'TCPU' and 'NEWTON'. */
+  str_hash_type      * block_var_index;            /* Block variables like BPR */
+  str_hash_type      * gen_var_index;              /* This is "everything" - things can either be found as gen_var("WWCT:OP_X") or as well_var("WWCT" , "OP_X") */
 
 
   vector_type        * smspec_nodes;
+  arena_type         * arena;                      /* The smspec_node instances loaded from file are allocated here. */
+  str_intern_type    * strings;                    /* The keyword, well and group names of the arena nodes are interned here. */
   bool                 write_mode;
   bool                 need_nums;
   bool                 locked;
@@ -251,19 +255,21 @@ static ecl_smspec_type * ecl_smspec_alloc_empty(bool write_mode , const char * k
   ecl_smspec = util_malloc(sizeof *ecl_smspec );
   UTIL_TYPE_ID_INIT(ecl_smspec , ECL_SMSPEC_ID);
 
-  ecl_smspec->well_var_index                 = hash_alloc();
-  ecl_smspec->well_completion_var_index      = hash_alloc();
-  ecl_smspec->group_var_index                = hash_alloc();
-  ecl_smspec->field_var_index                = hash_alloc();
-  ecl_smspec->region_var_index               = hash_alloc();
-  ecl_smspec->misc_var_index                 = hash_alloc();
-  ecl_smspec->block_var_index                = hash_alloc();
-  ecl_smspec->gen_var_index                  = hash_alloc();
+  ecl_smspec->well_var_index                 = str_hash_alloc();
+  ecl_smspec->well_completion_var_index      = str_hash_alloc();
+  ecl_smspec->group_var_index                = str_hash_alloc();
+  ecl_smspec->field_var_index                = str_hash_alloc();
+  ecl_smspec->region_var_index               = str_hash_alloc();
+  ecl_smspec->misc_var_index                 = str_hash_alloc();
+  ecl_smspec->block_var_index                = str_hash_alloc();
+  ecl_smspec->gen_var_index                  = str_hash_alloc();
   ecl_smspec->sim_start_time                 = -1;
   ecl_smspec->key_join_string                = key_join_string;
   ecl_smspec->header_file                    = NULL;
 
   ecl_smspec->smspec_nodes                   = vector_alloc_new();
+  ecl_smspec->arena                          = arena_alloc( 0 );
+  ecl_smspec->strings                        = str_intern_alloc( );
 
   ecl_smspec->time_index   = -1;
   ecl_smspec->day_index    = -1;
@@ -780,14 +786,14 @@ static void ecl_smspec_install_gen_keys( ecl_smspec_type * smspec , smspec_node_
   {
     const char * gen_key1 = smspec_node_get_gen_key1( smspec_node );
     if (gen_key1 != NULL)
-      hash_insert_ref(smspec->gen_var_index , gen_key1 , smspec_node);
+      str_hash_insert_ref(smspec->gen_var_index , gen_key1 , smspec_node);
   }
 
   /* Insert the (optional) extra mapping for block related variables and region_2_region variables: */
   {
     const char * gen_key2 = smspec_node_get_gen_key2( smspec_node );
     if (gen_key2 != NULL)
-      hash_insert_ref(smspec->gen_var_index , gen_key2 , smspec_node);
+      str_hash_insert_ref(smspec->gen_var_index , gen_key2 , smspec_node);
   }
 }
 
@@ -809,17 +815,17 @@ static void ecl_smspec_install_special_keys( ecl_smspec_type * ecl_smspec , smsp
   switch(var_type) {
   case(ECL_SMSPEC_COMPLETION_VAR):
     /* Three level indexing: variable -> well -> string(cell_nr)*/
-    if (!hash_has_key(ecl_smspec->well_completion_var_index , well))
-      hash_insert_hash_owned_ref(ecl_smspec->well_completion_var_index , well , hash_alloc() , hash_free__);
+    if (!str_hash_has_key(ecl_smspec->well_completion_var_index , well))
+      str_hash_insert_owned_ref(ecl_smspec->well_completion_var_index , well , str_hash_alloc() , str_hash_free__);
     {
-      hash_type * cell_hash = hash_get(ecl_smspec->well_completion_var_index , well);
+      str_hash_type * cell_hash = str_hash_get(ecl_smspec->well_completion_var_index , well);
       char cell_str[16];
       sprintf(cell_str , "%d" , num);
-      if (!hash_has_key(cell_hash , cell_str))
-        hash_insert_hash_owned_ref(cell_hash , cell_str , hash_alloc() , hash_free__);
+      if (!str_hash_has_key(cell_hash , cell_str))
+        str_hash_insert_owned_ref(cell_hash , cell_str , str_hash_alloc() , str_hash_free__);
       {
-        hash_type * var_hash = hash_get(cell_hash , cell_str);
-        hash_insert_ref(var_hash , keyword , smspec_node );
+        str_hash_type * var_hash = str_hash_get(cell_hash , cell_str);
+        str_hash_insert_ref(var_hash , keyword , smspec_node );
       }
     }
     break;
@@ -827,48 +833,48 @@ static void ecl_smspec_install_special_keys( ecl_smspec_type * ecl_smspec , smsp
     /*
       Field variable
     */
-    hash_insert_ref( ecl_smspec->field_var_index , keyword , smspec_node );
+    str_hash_insert_ref( ecl_smspec->field_var_index , keyword , smspec_node );
     break;
   case(ECL_SMSPEC_GROUP_VAR):
-    if (!hash_has_key(ecl_smspec->group_var_index , group))
-      hash_insert_hash_owned_ref(ecl_smspec->group_var_index , group, hash_alloc() , hash_free__);
+    if (!str_hash_has_key(ecl_smspec->group_var_index , group))
+      str_hash_insert_owned_ref(ecl_smspec->group_var_index , group, str_hash_alloc() , str_hash_free__);
     {
-      hash_type * var_hash = hash_get(ecl_smspec->group_var_index , group);
-      hash_insert_ref(var_hash , keyword , smspec_node );
+      str_hash_type * var_hash = str_hash_get(ecl_smspec->group_var_index , group);
+      str_hash_insert_ref(var_hash , keyword , smspec_node );
     }
     break;
   case(ECL_SMSPEC_REGION_VAR):
-    if (!hash_has_key(ecl_smspec->region_var_index , keyword))
-      hash_insert_hash_owned_ref( ecl_smspec->region_var_index , keyword , hash_alloc() , hash_free__);
+    if (!str_hash_has_key(ecl_smspec->region_var_index , keyword))
+      str_hash_insert_owned_ref( ecl_smspec->region_var_index , keyword , str_hash_alloc() , str_hash_free__);
     {
-      hash_type * var_hash = hash_get(ecl_smspec->region_var_index , keyword);
+      str_hash_type * var_hash = str_hash_get(ecl_smspec->region_var_index , keyword);
       char num_str[16];
       sprintf( num_str , "%d" , num);
-      hash_insert_ref(var_hash , num_str , smspec_node);
+      str_hash_insert_ref(var_hash , num_str , smspec_node);
     }
     ecl_smspec->num_regions = util_int_max(ecl_smspec->num_regions , num);
     break;
   case (ECL_SMSPEC_WELL_VAR):
-    if (!hash_has_key(ecl_smspec->well_var_index , well))
-      hash_insert_hash_owned_ref(ecl_smspec->well_var_index , well , hash_alloc() , hash_free__);
+    if (!str_hash_has_key(ecl_smspec->well_var_index , well))
+      str_hash_insert_owned_ref(ecl_smspec->well_var_index , well , str_hash_alloc() , str_hash_free__);
     {
-      hash_type * var_hash = hash_get(ecl_smspec->well_var_index , well);
-      hash_insert_ref(var_hash , keyword , smspec_node );
+      str_hash_type * var_hash = str_hash_get(ecl_smspec->well_var_index , well);
+      str_hash_insert_ref(var_hash , keyword , smspec_node );
     }
     break;
   case(ECL_SMSPEC_MISC_VAR):
     /* Misc variable - i.e. date or CPU time ... */
-    hash_insert_ref(ecl_smspec->misc_var_index , keyword , smspec_node );
+    str_hash_insert_ref(ecl_smspec->misc_var_index , keyword , smspec_node );
     break;
   case(ECL_SMSPEC_BLOCK_VAR):
     /* A block variable */
-    if (!hash_has_key(ecl_smspec->block_var_index , keyword))
-      hash_insert_hash_owned_ref(ecl_smspec->block_var_index , keyword , hash_alloc() , hash_free__);
+    if (!str_hash_has_key(ecl_smspec->block_var_index , keyword))
+      str_hash_insert_owned_ref(ecl_smspec->block_var_index , keyword , str_hash_alloc() , str_hash_free__);
     {
-      hash_type * block_hash = hash_get(ecl_smspec->block_var_index , keyword);
+      str_hash_type * block_hash = str_hash_get(ecl_smspec->block_var_index , keyword);
       char block_nr[16];
       sprintf( block_nr , "%d" , num );
-      hash_insert_ref(block_hash , block_nr , smspec_node);
+      str_hash_insert_ref(block_hash , block_nr , smspec_node);
     }
     break;
     /**
@@ -1187,9 +1193,9 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
           int lgr_j = ecl_kw_iget_int( numly , params_index );
           int lgr_k = ecl_kw_iget_int( numlz , params_index );
           lgr_name  = util_alloc_strip_copy(  ecl_kw_iget_ptr( lgrs , params_index ));
-          smspec_node = smspec_node_alloc_lgr( var_type , well , kw , unit , lgr_name , ecl_smspec->key_join_string , lgr_i , lgr_j , lgr_k , params_index, default_value);
+          smspec_node = smspec_node_alloc_lgr_arena( ecl_smspec->arena , ecl_smspec->strings , var_type , well , kw , unit , lgr_name , ecl_smspec->key_join_string , lgr_i , lgr_j , lgr_k , params_index, default_value);
         } else
-          smspec_node = smspec_node_alloc( var_type , well , kw , unit , ecl_smspec->key_join_string , ecl_smspec->grid_dims , num , params_index , default_value);
+          smspec_node = smspec_node_alloc_arena( ecl_smspec->arena , ecl_smspec->strings , var_type , well , kw , unit , ecl_smspec->key_join_string , ecl_smspec->grid_dims , num , params_index , default_value);
 
 
         ecl_smspec_add_node( ecl_smspec , smspec_node );
@@ -1214,6 +1220,35 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
 
 
 
+/*
+  When the header has been loaded from file the index tables are
+  frozen; lookup in the tables is then guaranteed to be safe from
+  several threads concurrently. The smspec instances created for
+  writing are still updated after construction and are not frozen.
+*/
+
+static void ecl_smspec_freeze_nested_index( str_hash_type * index , int depth) {
+  if (depth > 0) {
+    int i;
+    for (i=0; i < str_hash_get_size( index ); i++)
+      ecl_smspec_freeze_nested_index( str_hash_iget_value( index , i ) , depth - 1);
+  }
+  str_hash_freeze( index );
+}
+
+
+static void ecl_smspec_freeze_index( ecl_smspec_type * ecl_smspec ) {
+  ecl_smspec_freeze_nested_index( ecl_smspec->well_var_index , 1 );
+  ecl_smspec_freeze_nested_index( ecl_smspec->well_completion_var_index , 2 );
+  ecl_smspec_freeze_nested_index( ecl_smspec->group_var_index , 1 );
+  ecl_smspec_freeze_nested_index( ecl_smspec->field_var_index , 0 );
+  ecl_smspec_freeze_nested_index( ecl_smspec->region_var_index , 1 );
+  ecl_smspec_freeze_nested_index( ecl_smspec->misc_var_index , 0 );
+  ecl_smspec_freeze_nested_index( ecl_smspec->block_var_index , 1 );
+  ecl_smspec_freeze_nested_index( ecl_smspec->gen_var_index , 0 );
+}
+
+
 ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * key_join_string , bool include_restart) {
   ecl_smspec_type *ecl_smspec;
 
@@ -1226,8 +1261,8 @@ ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * k
 
   if (ecl_smspec_fread_header(ecl_smspec , header_file , include_restart)) {
 
-    if (hash_has_key( ecl_smspec->misc_var_index , "TIME")) {
-      const smspec_node_type * time_node = hash_get(ecl_smspec->misc_var_index , "TIME");
+    if (str_hash_has_key( ecl_smspec->misc_var_index , "TIME")) {
+      const smspec_node_type * time_node = str_hash_get(ecl_smspec->misc_var_index , "TIME");
       const char * time_unit = smspec_node_get_unit( time_node );
       ecl_smspec->time_index = smspec_node_get_params_index( time_node );
 
@@ -1239,10 +1274,10 @@ ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * k
         util_abort("%s: time_unit:%s not recognized \n",__func__ , time_unit);
     }
 
-    if (hash_has_key(ecl_smspec->misc_var_index , "DAY")) {
-      ecl_smspec->day_index   = smspec_node_get_params_index( hash_get(ecl_smspec->misc_var_index , "DAY") );
-      ecl_smspec->month_index = smspec_node_get_params_index( hash_get(ecl_smspec->misc_var_index , "MONTH") );
-      ecl_smspec->year_index  = smspec_node_get_params_index( hash_get(ecl_smspec->misc_var_index , "YEAR") );
+    if (str_hash_has_key(ecl_smspec->misc_var_index , "DAY")) {
+      ecl_smspec->day_index   = smspec_node_get_params_index( str_hash_get(ecl_smspec->misc_var_index , "DAY") );
+      ecl_smspec->month_index = smspec_node_get_params_index( str_hash_get(ecl_smspec->misc_var_index , "MONTH") );
+      ecl_smspec->year_index  = smspec_node_get_params_index( str_hash_get(ecl_smspec->misc_var_index , "YEAR") );
     }
 
     if ((ecl_smspec->time_index == -1) && ( ecl_smspec->day_index == -1)) {
@@ -1255,6 +1290,7 @@ ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * k
       util_abort("%s: Sorry the SMSPEC file seems to lack all time information, need either TIME, or DAY/MONTH/YEAR information. Can not proceed.",__func__);
       return NULL;
     }
+    ecl_smspec_freeze_index( ecl_smspec );
     return ecl_smspec;
   } else {
     /** Failed to load from disk. */
@@ -1265,12 +1301,12 @@ ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * k
 
 
 int ecl_smspec_get_num_groups(const ecl_smspec_type * ecl_smspec) {
-  return hash_get_size(ecl_smspec->group_var_index);
+  return str_hash_get_size(ecl_smspec->group_var_index);
 }
 
 
 char ** ecl_smspec_alloc_group_names(const ecl_smspec_type * ecl_smspec) {
-  return hash_alloc_keylist(ecl_smspec->group_var_index);
+  return str_hash_alloc_keylist(ecl_smspec->group_var_index);
 }
 
 int ecl_smspec_get_num_regions(const ecl_smspec_type * ecl_smspec) {
@@ -1325,10 +1361,10 @@ int ecl_smspec_get_num_regions(const ecl_smspec_type * ecl_smspec) {
 
 const smspec_node_type * ecl_smspec_get_well_var_node( const ecl_smspec_type * smspec , const char * well , const char * var) {
   const smspec_node_type * node = NULL;
-  if (hash_has_key( smspec->well_var_index , well)) {
-    hash_type * var_hash = hash_get(smspec->well_var_index , well);
-    if (hash_has_key(var_hash , var))
-      node = hash_get(var_hash , var);
+  if (str_hash_has_key( smspec->well_var_index , well)) {
+    str_hash_type * var_hash = str_hash_get(smspec->well_var_index , well);
+    if (str_hash_has_key(var_hash , var))
+      node = str_hash_get(var_hash , var);
   }
   return node;
 }
@@ -1352,10 +1388,10 @@ bool ecl_smspec_has_well_var(const ecl_smspec_type * ecl_smspec , const char * w
 
 const smspec_node_type * ecl_smspec_get_group_var_node( const ecl_smspec_type * smspec , const char * group , const char * var) {
   const smspec_node_type * node = NULL;
-  if (hash_has_key(smspec->group_var_index , group)) {
-    hash_type * var_hash = hash_get(smspec->group_var_index , group);
-    if (hash_has_key(var_hash , var))
-      node = hash_get(var_hash , var);
+  if (str_hash_has_key(smspec->group_var_index , group)) {
+    str_hash_type * var_hash = str_hash_get(smspec->group_var_index , group);
+    if (str_hash_has_key(var_hash , var))
+      node = str_hash_get(var_hash , var);
   }
   return node;
 }
@@ -1378,8 +1414,8 @@ bool ecl_smspec_has_group_var(const ecl_smspec_type * ecl_smspec , const char *
 
 const smspec_node_type * ecl_smspec_get_field_var_node(const ecl_smspec_type * ecl_smspec , const char *var) {
   const smspec_node_type * node = NULL;
-  if (hash_has_key(ecl_smspec->field_var_index , var))
-    node = hash_get(ecl_smspec->field_var_index , var);
+  if (str_hash_has_key(ecl_smspec->field_var_index , var))
+    node = str_hash_get(ecl_smspec->field_var_index , var);
 
   return node;
 }
@@ -1412,10 +1448,10 @@ bool ecl_smspec_has_field_var(const ecl_smspec_type * ecl_smspec , const char *v
 static const smspec_node_type * ecl_smspec_get_block_var_node_string(const ecl_smspec_type * ecl_smspec , const char * block_var , const char * block_str) {
   const smspec_node_type * node = NULL;
 
-  if (hash_has_key(ecl_smspec->block_var_index , block_var)) {
-    hash_type * block_hash = hash_get(ecl_smspec->block_var_index , block_var);
-    if (hash_has_key(block_hash , block_str))
-      node = hash_get(block_hash , block_str);
+  if (str_hash_has_key(ecl_smspec->block_var_index , block_var)) {
+    str_hash_type * block_hash = str_hash_get(ecl_smspec->block_var_index , block_var);
+    if (str_hash_has_key(block_hash , block_str))
+      node = str_hash_get(block_hash , block_str);
   }
 
   return node;
@@ -1471,11 +1507,11 @@ int ecl_smspec_get_block_var_params_index_ijk(const ecl_smspec_type * ecl_smspec
 const smspec_node_type * ecl_smspec_get_region_var_node(const ecl_smspec_type * ecl_smspec , const char *region_var , int region_nr) {
   const smspec_node_type * node = NULL;
 
-  if (hash_has_key(ecl_smspec->region_var_index , region_var)) {
+  if (str_hash_has_key(ecl_smspec->region_var_index , region_var)) {
     char * nr_str = util_alloc_sprintf( "%d" , region_nr );
-    hash_type * nr_hash = hash_get(ecl_smspec->region_var_index , region_var);
-    if (hash_has_key( nr_hash , nr_str))
-      node = hash_get( nr_hash , nr_str );
+    str_hash_type * nr_hash = str_hash_get(ecl_smspec->region_var_index , region_var);
+    if (str_hash_has_key( nr_hash , nr_str))
+      node = str_hash_get( nr_hash , nr_str );
     free( nr_str );
   }
 
@@ -1500,8 +1536,8 @@ int ecl_smspec_get_region_var_params_index(const ecl_smspec_type * ecl_smspec ,
 const smspec_node_type * ecl_smspec_get_misc_var_node(const ecl_smspec_type * ecl_smspec , const char *var) {
   const smspec_node_type * node = NULL;
 
-  if (hash_has_key(ecl_smspec->misc_var_index , var))
-    node = hash_get(ecl_smspec->misc_var_index , var);
+  if (str_hash_has_key(ecl_smspec->misc_var_index , var))
+    node = str_hash_get(ecl_smspec->misc_var_index , var);
 
   return node;
 }
@@ -1526,13 +1562,13 @@ const smspec_node_type * ecl_smspec_get_well_completion_var_node(const ecl_smspe
   const smspec_node_type * node = NULL;
 
   char * cell_str = util_alloc_sprintf("%d" , cell_nr);
-  if (hash_has_key(ecl_smspec->well_completion_var_index , well)) {
-    hash_type * cell_hash = hash_get(ecl_smspec->well_completion_var_index , well);
+  if (str_hash_has_key(ecl_smspec->well_completion_var_index , well)) {
+    str_hash_type * cell_hash = str_hash_get(ecl_smspec->well_completion_var_index , well);
 
-    if (hash_has_key(cell_hash , cell_str)) {
-      hash_type * var_hash = hash_get(cell_hash , cell_str);
-      if (hash_has_key(var_hash , var))
-        node = hash_get( var_hash , var);
+    if (str_hash_has_key(cell_hash , cell_str)) {
+      str_hash_type * var_hash = str_hash_get(cell_hash , cell_str);
+      if (str_hash_has_key(var_hash , var))
+        node = str_hash_get( var_hash , var);
     }
   }
   free(cell_str);
@@ -1563,8 +1599,8 @@ int  ecl_smspec_get_well_completion_var_params_index(const ecl_smspec_type * ecl
 
 
 const smspec_node_type * ecl_smspec_get_general_var_node( const ecl_smspec_type * smspec , const char * lookup_kw ) {
-  if (hash_has_key( smspec->gen_var_index , lookup_kw )) {
-    const smspec_node_type * smspec_node = hash_get( smspec->gen_var_index , lookup_kw );
+  if (str_hash_has_key( smspec->gen_var_index , lookup_kw )) {
+    const smspec_node_type * smspec_node = str_hash_get( smspec->gen_var_index , lookup_kw );
     return smspec_node;
   } else
     return NULL;
@@ -1585,7 +1621,7 @@ bool ecl_smspec_has_general_var(const ecl_smspec_type * ecl_smspec , const char
 
 /** DIES if the lookup_kw is not present. */
 const char * ecl_smspec_get_general_var_unit( const ecl_smspec_type * ecl_smspec , const char * lookup_kw) {
-  const smspec_node_type * smspec_node = hash_get( ecl_smspec->gen_var_index , lookup_kw );
+  const smspec_node_type * smspec_node = str_hash_get( ecl_smspec->gen_var_index , lookup_kw );
   return smspec_node_get_unit( smspec_node );
 }
 
@@ -1653,18 +1689,20 @@ const float_vector_type * ecl_smspec_get_params_default( const ecl_smspec_type *
 
 
 void ecl_smspec_free(ecl_smspec_type *ecl_smspec) {
-  hash_free(ecl_smspec->well_var_index);
-  hash_free(ecl_smspec->well_completion_var_index);
-  hash_free(ecl_smspec->group_var_index);
-  hash_free(ecl_smspec->field_var_index);
-  hash_free(ecl_smspec->region_var_index);
-  hash_free(ecl_smspec->misc_var_index);
-  hash_free(ecl_smspec->block_var_index);
-  hash_free(ecl_smspec->gen_var_index);
+  str_hash_free(ecl_smspec->well_var_index);
+  str_hash_free(ecl_smspec->well_completion_var_index);
+  str_hash_free(ecl_smspec->group_var_index);
+  str_hash_free(ecl_smspec->field_var_index);
+  str_hash_free(ecl_smspec->region_var_index);
+  str_hash_free(ecl_smspec->misc_var_index);
+  str_hash_free(ecl_smspec->block_var_index);
+  str_hash_free(ecl_smspec->gen_var_index);
   util_safe_free( ecl_smspec->header_file );
   int_vector_free( ecl_smspec->index_map );
   float_vector_free( ecl_smspec->params_default );
   vector_free( ecl_smspec->smspec_nodes );
+  arena_free( ecl_smspec->arena );
+  str_intern_free( ecl_smspec->strings );
   free( ecl_smspec->restart_case );
   free( ecl_smspec );
 }
@@ -1698,7 +1736,7 @@ int ecl_smspec_get_date_year_index( const ecl_smspec_type * smspec ) {
 
 
 bool ecl_smspec_general_is_total( const ecl_smspec_type * smspec , const char * gen_key) {
-  const  smspec_node_type * smspec_node = hash_get( smspec->gen_var_index , gen_key );
+  const  smspec_node_type * smspec_node = str_hash_get( smspec->gen_var_index , gen_key );
   return smspec_node_is_total( smspec_node );
 }
 
@@ -1727,15 +1765,14 @@ bool ecl_smspec_general_is_total( const ecl_smspec_type * smspec , const char *
 
 
 void ecl_smspec_select_matching_general_var_list( const ecl_smspec_type * smspec , const char * pattern , stringlist_type * keys) {
-  hash_type * ex_keys = hash_alloc( );
+  str_hash_type * ex_keys = str_hash_alloc( );
   int i;
   for (i=0; i < stringlist_get_size( keys ); i++)
-    hash_insert_int( ex_keys , stringlist_iget( keys , i ) , 1);
+    str_hash_insert_ref( ex_keys , stringlist_iget( keys , i ) , NULL);
 
   {
-    hash_iter_type * iter = hash_iter_alloc( smspec->gen_var_index );
-    while (!hash_iter_is_complete( iter )) {
-      const char * key = hash_iter_get_next_key( iter );
+    for (i=0; i < str_hash_get_size( smspec->gen_var_index ); i++) {
+      const char * key = str_hash_iget_key( smspec->gen_var_index , i );
 
       /*
          The TIME is typically special cased by output and will not
@@ -1748,14 +1785,13 @@ void ecl_smspec_select_matching_general_var_list( const ecl_smspec_type * smspec
 
 
       if ((pattern == NULL) || (util_fnmatch( pattern , key ) == 0)) {
-        if (!hash_has_key( ex_keys , key))
+        if (!str_hash_has_key( ex_keys , key))
           stringlist_append_copy( keys , key );
       }
     }
-    hash_iter_free( iter );
   }
 
-  hash_free( ex_keys );
+  str_hash_free( ex_keys );
   stringlist_sort( keys , (string_cmp_ftype *) util_strcmp_int );
 }
 
@@ -1794,16 +1830,14 @@ const char * ecl_smspec_get_join_string( const ecl_smspec_type * smspec) {
 stringlist_type * ecl_smspec_alloc_well_list( const ecl_smspec_type * smspec , const char * pattern) {
   stringlist_type * well_list = stringlist_alloc_new( );
   {
-    hash_iter_type * iter = hash_iter_alloc( smspec->well_var_index );
-
-    while (!hash_iter_is_complete( iter )) {
-      const char * well_name = hash_iter_get_next_key( iter );
+    int i;
+    for (i=0; i < str_hash_get_size( smspec->well_var_index ); i++) {
+      const char * well_name = str_hash_iget_key( smspec->well_var_index , i );
       if (pattern == NULL)
         stringlist_append_copy( well_list , well_name );
       else if (util_fnmatch( pattern , well_name) == 0)
         stringlist_append_copy( well_list , well_name );
     }
-    hash_iter_free(iter);
   }
   stringlist_sort( well_list , (string_cmp_ftype *) util_strcmp_int );
   return well_list;
@@ -1819,16 +1853,14 @@ stringlist_type * ecl_smspec_alloc_well_list( const ecl_smspec_type * smspec , c
 stringlist_type * ecl_smspec_alloc_group_list( const ecl_smspec_type * smspec , const char * pattern) {
   stringlist_type * group_list = stringlist_alloc_new( );
   {
-    hash_iter_type * iter = hash_iter_alloc( smspec->group_var_index );
-
-    while (!hash_iter_is_complete( iter )) {
-      const char * group_name = hash_iter_get_next_key( iter );
+    int i;
+    for (i=0; i < str_hash_get_size( smspec->group_var_index ); i++) {
+      const char * group_name = str_hash_iget_key( smspec->group_var_index , i );
       if (pattern == NULL)
         stringlist_append_copy( group_list , group_name );
       else if (util_fnmatch( pattern , group_name) == 0)
         stringlist_append_copy( group_list , group_name );
     }
-    hash_iter_free(iter);
   }
   stringlist_sort( group_list , (string_cmp_ftype *) util_strcmp_int );
   return group_list;
@@ -1843,10 +1875,8 @@ stringlist_type * ecl_smspec_alloc_group_list( const ecl_smspec_type * smspec ,
 */
 
 stringlist_type * ecl_smspec_alloc_well_var_list( const ecl_smspec_type * smspec ) {
-  hash_iter_type * well_iter = hash_iter_alloc( smspec->well_var_index );
-  hash_type      * var_hash = hash_iter_get_next_value( well_iter );
-  hash_iter_free( well_iter );
-  return hash_alloc_stringlist( var_hash );
+  const str_hash_type * var_hash = str_hash_iget_value( smspec->well_var_index , 0 );
+  return str_hash_alloc_stringlist( var_hash );
 }
 
 
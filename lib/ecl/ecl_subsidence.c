@@ -58,6 +58,7 @@ struct ecl_subsidence_struct {
                                           for each interesting time. */
   double               * compressibility; /*total compressibility*/
   double               * poisson_ratio;
+  vector_type          * tree_list;    /* ecl_grav_tree_type instances used by the _list() functions; one for each region. */
 };
 
 
@@ -136,6 +137,62 @@ static void ecl_subsidence_survey_free__( void * __subsidence_survey ) {
 
 /*****************************************************************/
 
+/*
+   The weights of the biot-savart evaluation, the pore volume times the
+   pressure change, for the cells parent_index[0 ... size); with
+   parent_index == NULL the weights of all the active cells are
+   returned.
+*/
+
+static double * ecl_subsidence_survey_alloc_weight( const ecl_subsidence_survey_type * base_survey ,
+                                                    const ecl_subsidence_survey_type * monitor_survey,
+                                                    const int * parent_index , int size) {
+  double * weight = util_calloc( util_int_max( 1 , size ) , sizeof * weight );
+  int index;
+
+  if (monitor_survey != NULL) {
+    for (index = 0; index < size; index++) {
+      int active_index = parent_index ? parent_index[index] : index;
+      weight[index] = base_survey->porv[active_index] * (base_survey->pressure[active_index] - monitor_survey->pressure[active_index]);
+    }
+  } else {
+    for (index = 0; index < size; index++) {
+      int active_index = parent_index ? parent_index[index] : index;
+      weight[index] = base_survey->porv[active_index] * base_survey->pressure[active_index];
+    }
+  }
+
+  return weight;
+}
+
+
+/*
+   The weights of the geertsma evaluation, the scaled cell volume
+   times the pressure change, for the same cells as
+   ecl_subsidence_survey_alloc_weight().
+*/
+
+static double * ecl_subsidence_survey_alloc_geertsma_weight( const ecl_subsidence_survey_type * base_survey ,
+                                                             const ecl_subsidence_survey_type * monitor_survey,
+                                                             const int * parent_index , int size ,
+                                                             double youngs_modulus, double poisson_ratio) {
+  const double * cell_volume = ecl_grid_cache_get_volume( base_survey->grid_cache );
+  double scale_factor = 1e4 *(1 + poisson_ratio) * ( 1 - 2*poisson_ratio) / ( 4*M_PI*( 1 - poisson_ratio)  * youngs_modulus );
+  double * weight = util_calloc( util_int_max( 1 , size ) , sizeof * weight );
+
+  for (int index = 0; index < size; index++) {
+    int active_index = parent_index ? parent_index[index] : index;
+    if (monitor_survey) {
+        weight[index] = scale_factor * cell_volume[active_index] * (base_survey->pressure[active_index] - monitor_survey->pressure[active_index]);
+    } else {
+        weight[index] = scale_factor * cell_volume[active_index] * (base_survey->pressure[active_index] );
+    }
+  }
+
+  return weight;
+}
+
+
 static double ecl_subsidence_survey_eval( const ecl_subsidence_survey_type * base_survey ,
                                           const ecl_subsidence_survey_type * monitor_survey,
                                           ecl_region_type * region ,
@@ -143,18 +200,8 @@ static double ecl_subsidence_survey_eval( const ecl_subsidence_survey_type * bas
                                           double compressibility, double poisson_ratio) {
 
   const ecl_grid_cache_type * grid_cache = base_survey->grid_cache;
-  const int size  = ecl_grid_cache_get_size( grid_cache );
-  double * weight = util_calloc( size , sizeof * weight );
+  double * weight = ecl_subsidence_survey_alloc_weight( base_survey , monitor_survey , NULL , ecl_grid_cache_get_size( grid_cache ));
   double deltaz;
-  int index;
-
-  if (monitor_survey != NULL) {
-    for (index = 0; index < size; index++)
-      weight[index] = base_survey->porv[index] * (base_survey->pressure[index] - monitor_survey->pressure[index]);
-  } else {
-    for (index = 0; index < size; index++)
-      weight[index] = base_survey->porv[index] * base_survey->pressure[index];
-  }
 
   deltaz = compressibility * 31.83099*(1-poisson_ratio) *
     ecl_grav_common_eval_biot_savart( grid_cache , region , base_survey->aquifer_cell , weight , utm_x , utm_y , depth );
@@ -171,20 +218,9 @@ static double ecl_subsidence_survey_eval_geertsma( const ecl_subsidence_survey_t
                                                    double youngs_modulus, double poisson_ratio, double seabed) {
 
   const ecl_grid_cache_type * grid_cache = base_survey->grid_cache;
-  const double * cell_volume = ecl_grid_cache_get_volume( grid_cache );
-  const int size  = ecl_grid_cache_get_size( grid_cache );
-  double scale_factor = 1e4 *(1 + poisson_ratio) * ( 1 - 2*poisson_ratio) / ( 4*M_PI*( 1 - poisson_ratio)  * youngs_modulus );
-  double * weight = util_calloc( size , sizeof * weight );
+  double * weight = ecl_subsidence_survey_alloc_geertsma_weight( base_survey , monitor_survey , NULL , ecl_grid_cache_get_size( grid_cache ) , youngs_modulus , poisson_ratio );
   double deltaz;
 
-  for (int index = 0; index < size; index++) {
-    if (monitor_survey) {
-        weight[index] = scale_factor * cell_volume[index] * (base_survey->pressure[index] - monitor_survey->pressure[index]);
-    } else {
-        weight[index] = scale_factor * cell_volume[index] * (base_survey->pressure[index] );
-    }
-  }
-
   deltaz = ecl_grav_common_eval_geertsma( grid_cache , region , base_survey->aquifer_cell , weight , utm_x , utm_y , depth , poisson_ratio, seabed);
 
   free( weight );
@@ -195,7 +231,9 @@ static double ecl_subsidence_survey_eval_geertsma( const ecl_subsidence_survey_t
 
 /*****************************************************************/
 /**
-   The grid instance is only used during the construction phase. The
+   The grid cache is shared with the other ecl_grav and ecl_subsidence
+   instances of the same grid, see ecl_grid_cache_alloc_shared(); the
+   grid must therefore not be destroyed before this object. The
    @init_file object is used by the ecl_subsidence_add_survey_XXX()
    functions; and calling scope must NOT destroy this object before
    all surveys have been added.
@@ -204,10 +242,11 @@ static double ecl_subsidence_survey_eval_geertsma( const ecl_subsidence_survey_t
 ecl_subsidence_type * ecl_subsidence_alloc( const ecl_grid_type * ecl_grid, const ecl_file_type * init_file) {
   ecl_subsidence_type * ecl_subsidence = util_malloc( sizeof * ecl_subsidence );
   ecl_subsidence->init_file      = init_file;
-  ecl_subsidence->grid_cache     = ecl_grid_cache_alloc( ecl_grid );
+  ecl_subsidence->grid_cache     = ecl_grid_cache_alloc_shared( ecl_grid , false );
   ecl_subsidence->aquifer_cell   = ecl_grav_common_alloc_aquifer_cell( ecl_subsidence->grid_cache , init_file );
 
   ecl_subsidence->surveys        = hash_alloc();
+  ecl_subsidence->tree_list      = vector_alloc_new();
   return ecl_subsidence;
 }
 
@@ -253,10 +292,59 @@ double ecl_subsidence_eval_geertsma( const ecl_subsidence_type * subsidence , co
   return ecl_subsidence_survey_eval_geertsma( base_survey , monitor_survey , region , utm_x , utm_y , depth , youngs_modulus, poisson_ratio, seabed);
 }
 
+
+/**
+   The _list() functions evaluate ecl_subsidence_eval() and
+   ecl_subsidence_eval_geertsma() for num_stations stations, the
+   result for station i is stored in result[i]. Clusters of cells
+   which are far away from a station compared to their size are
+   lumped together, theta is the largest ratio size / distance of a
+   lumped cluster - see ecl_grav_eval_list(). The trees of the most
+   recently used regions are kept in the ecl_subsidence instance, see
+   ecl_grav_common_acquire_tree().
+*/
+
+void ecl_subsidence_eval_list( const ecl_subsidence_type * subsidence , const char * base, const char * monitor , ecl_region_type * region ,
+                               int num_stations , const double * utm_x, const double * utm_y , const double * depth,
+                               double compressibility, double poisson_ratio, double theta , double * result) {
+  ecl_subsidence_survey_type * base_survey    = ecl_subsidence_get_survey( subsidence , base );
+  ecl_subsidence_survey_type * monitor_survey = ecl_subsidence_get_survey( subsidence , monitor );
+  ecl_grav_tree_type * tree = ecl_grav_common_acquire_tree( subsidence->tree_list , subsidence->grid_cache , region , subsidence->aquifer_cell );
+  const ecl_grid_cache_type * subset = ecl_grav_tree_get_subset( tree );
+  double * weight = ecl_subsidence_survey_alloc_weight( base_survey , monitor_survey ,
+                                                        ecl_grid_cache_get_parent_index( subset ) , ecl_grid_cache_get_size( subset ));
+
+  ecl_grav_common_eval_biot_savart_tree( tree , weight , num_stations , utm_x , utm_y , depth , theta , result );
+  for (int station = 0; station < num_stations; station++)
+    result[station] *= compressibility * 31.83099*(1-poisson_ratio);
+
+  ecl_grav_common_release_tree( tree );
+  free( weight );
+}
+
+
+void ecl_subsidence_eval_geertsma_list( const ecl_subsidence_type * subsidence , const char * base, const char * monitor , ecl_region_type * region ,
+                                        int num_stations , const double * utm_x, const double * utm_y , const double * depth,
+                                        double youngs_modulus, double poisson_ratio, double seabed, double theta , double * result) {
+  ecl_subsidence_survey_type * base_survey    = ecl_subsidence_get_survey( subsidence , base );
+  ecl_subsidence_survey_type * monitor_survey = ecl_subsidence_get_survey( subsidence , monitor );
+  ecl_grav_tree_type * tree = ecl_grav_common_acquire_tree( subsidence->tree_list , subsidence->grid_cache , region , subsidence->aquifer_cell );
+  const ecl_grid_cache_type * subset = ecl_grav_tree_get_subset( tree );
+  double * weight = ecl_subsidence_survey_alloc_geertsma_weight( base_survey , monitor_survey ,
+                                                                 ecl_grid_cache_get_parent_index( subset ) , ecl_grid_cache_get_size( subset ) ,
+                                                                 youngs_modulus , poisson_ratio );
+
+  ecl_grav_common_eval_geertsma_tree( tree , weight , num_stations , utm_x , utm_y , depth , poisson_ratio , seabed , theta , result );
+
+  ecl_grav_common_release_tree( tree );
+  free( weight );
+}
+
 void ecl_subsidence_free( ecl_subsidence_type * ecl_subsidence ) {
+  hash_free( ecl_subsidence->surveys );
+  vector_free( ecl_subsidence->tree_list );
   ecl_grid_cache_free( ecl_subsidence->grid_cache );
   free( ecl_subsidence->aquifer_cell );
-  hash_free( ecl_subsidence->surveys );
   free( ecl_subsidence );
 }
 
@@ -38,6 +38,7 @@
 #include <ert/ecl/ecl_smspec.h>
 #include <ert/ecl/ecl_sum_data.h>
 #include <ert/ecl/smspec_node.h>
+#include <ert/ecl/ecl_perf.h>
 
 
 /**
@@ -187,6 +188,7 @@ static void ecl_sum_fread_history( ecl_sum_type * ecl_sum ) {
 
 
 static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart) {
+  int64_t start = ECL_PERF_START();
   ecl_sum->smspec = ecl_smspec_fread_alloc( header_file , ecl_sum->key_join_string , include_restart);
   if (ecl_sum->smspec) {
     bool fmt_file;
@@ -210,6 +212,7 @@ static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , con
   if (include_restart && ecl_smspec_get_restart_case( ecl_sum->smspec ))
     ecl_sum_fread_history( ecl_sum );
 
+  ECL_PERF_TRACE( "ecl_sum_fread" , header_file , start );
   return true;
 }
 
@@ -796,6 +799,49 @@ double_vector_type * ecl_sum_alloc_data_vector( const ecl_sum_type * ecl_sum  ,
 }
 
 
+/*
+  Bulk export to caller supplied buffers, see the documentation in
+  ecl_sum_data.c. The main consumer is the Python wrapping where the
+  buffers are numpy arrays.
+*/
+
+int ecl_sum_get_export_length( const ecl_sum_type * ecl_sum , bool report_only) {
+  return ecl_sum_data_get_export_length( ecl_sum->data , report_only );
+}
+
+void ecl_sum_export_days( const ecl_sum_type * ecl_sum , bool report_only , double * days) {
+  ecl_sum_data_export_days( ecl_sum->data , report_only , days );
+}
+
+void ecl_sum_export_time( const ecl_sum_type * ecl_sum , bool report_only , int64_t * sim_time) {
+  ecl_sum_data_export_time( ecl_sum->data , report_only , sim_time );
+}
+
+void ecl_sum_export_report_step( const ecl_sum_type * ecl_sum , bool report_only , int * report_steps) {
+  ecl_sum_data_export_report_step( ecl_sum->data , report_only , report_steps );
+}
+
+void ecl_sum_export_mini_step( const ecl_sum_type * ecl_sum , bool report_only , int * mini_steps) {
+  ecl_sum_data_export_mini_step( ecl_sum->data , report_only , mini_steps );
+}
+
+void ecl_sum_export_vector( const ecl_sum_type * ecl_sum , const char * gen_key , bool report_only , double * values) {
+  int params_index = ecl_sum_get_general_var_params_index( ecl_sum , gen_key );
+  ecl_sum_data_export_vector( ecl_sum->data , params_index , report_only , values );
+}
+
+void ecl_sum_export_vectors( const ecl_sum_type * ecl_sum , const stringlist_type * keys , bool report_only , double * values) {
+  int num_vectors = stringlist_get_size( keys );
+  int * params_index = util_calloc( num_vectors , sizeof * params_index );
+  int ivec;
+  for (ivec = 0; ivec < num_vectors; ivec++)
+    params_index[ivec] = ecl_sum_get_general_var_params_index( ecl_sum , stringlist_iget( keys , ivec ));
+
+  ecl_sum_data_export_vectors( ecl_sum->data , params_index , num_vectors , report_only , values );
+  free( params_index );
+}
+
+
 
 void ecl_sum_summarize( const ecl_sum_type * ecl_sum , FILE * stream ) {
   ecl_sum_data_summarize( ecl_sum->data , stream );
@@ -1455,6 +1455,110 @@ double_vector_type * ecl_sum_data_alloc_data_vector( const ecl_sum_data_type * d
 }
 
 
+/*
+  The ecl_sum_data_export_xxx() functions fill caller supplied
+  buffers with one element per ministep, or with one element per
+  report step if report_only is true. The buffers must have room for
+  ecl_sum_data_get_export_length() elements. Report steps which are
+  missing completely from the data are skipped.
+*/
+
+static int ecl_sum_data_iget_export_index( const ecl_sum_data_type * data , bool report_only , int index , int * report_step) {
+  if (report_only) {
+    int last_index;
+    do {
+      last_index = int_vector_safe_iget( data->report_last_index , *report_step );
+      (*report_step)++;
+    } while (last_index < 0);
+    return last_index;
+  } else
+    return index;
+}
+
+
+int ecl_sum_data_get_export_length( const ecl_sum_data_type * data , bool report_only) {
+  if (report_only) {
+    int length = 0;
+    int report_step;
+    for (report_step = data->first_report_step; report_step <= data->last_report_step; report_step++) {
+      if (int_vector_safe_iget( data->report_last_index , report_step ) >= 0)
+        length++;
+    }
+    return length;
+  } else
+    return vector_get_size( data->data );
+}
+
+
+void ecl_sum_data_export_days( const ecl_sum_data_type * data , bool report_only , double * days) {
+  int length = ecl_sum_data_get_export_length( data , report_only );
+  int report_step = data->first_report_step;
+  int i;
+  for (i = 0; i < length; i++) {
+    const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , ecl_sum_data_iget_export_index( data , report_only , i , &report_step ));
+    days[i] = ecl_sum_tstep_get_sim_days( ministep );
+  }
+}
+
+
+void ecl_sum_data_export_time( const ecl_sum_data_type * data , bool report_only , int64_t * sim_time) {
+  int length = ecl_sum_data_get_export_length( data , report_only );
+  int report_step = data->first_report_step;
+  int i;
+  for (i = 0; i < length; i++) {
+    const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , ecl_sum_data_iget_export_index( data , report_only , i , &report_step ));
+    sim_time[i] = ecl_sum_tstep_get_sim_time( ministep );
+  }
+}
+
+
+void ecl_sum_data_export_report_step( const ecl_sum_data_type * data , bool report_only , int * report_steps) {
+  int length = ecl_sum_data_get_export_length( data , report_only );
+  int report_step = data->first_report_step;
+  int i;
+  for (i = 0; i < length; i++) {
+    const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , ecl_sum_data_iget_export_index( data , report_only , i , &report_step ));
+    report_steps[i] = ecl_sum_tstep_get_report( ministep );
+  }
+}
+
+
+void ecl_sum_data_export_mini_step( const ecl_sum_data_type * data , bool report_only , int * mini_steps) {
+  int length = ecl_sum_data_get_export_length( data , report_only );
+  int report_step = data->first_report_step;
+  int i;
+  for (i = 0; i < length; i++) {
+    const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , ecl_sum_data_iget_export_index( data , report_only , i , &report_step ));
+    mini_steps[i] = ecl_sum_tstep_get_ministep( ministep );
+  }
+}
+
+
+/*
+  Will export the vectors given by the num_vectors elements in
+  params_index to a row major [num_vectors x length] buffer. The
+  ministeps are the outer loop, so every ministep is only visited
+  once irrespective of the number of vectors.
+*/
+
+void ecl_sum_data_export_vectors( const ecl_sum_data_type * data , const int * params_index , int num_vectors , bool report_only , double * values) {
+  int length = ecl_sum_data_get_export_length( data , report_only );
+  int report_step = data->first_report_step;
+  int i;
+  for (i = 0; i < length; i++) {
+    const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , ecl_sum_data_iget_export_index( data , report_only , i , &report_step ));
+    int ivec;
+    for (ivec = 0; ivec < num_vectors; ivec++)
+      values[ (size_t) ivec * length + i ] = ecl_sum_tstep_iget( ministep , params_index[ivec] );
+  }
+}
+
+
+void ecl_sum_data_export_vector( const ecl_sum_data_type * data , int params_index , bool report_only , double * values) {
+  ecl_sum_data_export_vectors( data , &params_index , 1 , report_only , values );
+}
+
+
 
 /**
    This function will return the total number of ministeps in the
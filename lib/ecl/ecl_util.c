@@ -31,6 +31,7 @@
 
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_dir.h>
 
 
 #define ECL_PHASE_NAME_OIL   "SOIL"   // SHould match the keywords found in restart file
@@ -572,7 +573,61 @@ int ecl_util_fname_report_cmp(const void *f1, const void *f2) {
 
 
 
-int ecl_util_select_filelist( const char * path , const char * base , ecl_file_enum file_type , bool fmt_file , stringlist_type * filelist) {
+/*
+  Returns the shared ecl_dir catalogue of the directory containing the
+  case @base, which can have an embedded path component, and the
+  basename of the case in @dir_base. If @scan is false the directory
+  is not scanned; NULL is returned unless there is already a current
+  catalogue. NULL is also returned if the directory can not be read,
+  and for bases which can not be used with the catalogue - the callers
+  then fall back to glob() and stat().
+*/
+
+static ecl_dir_type * ecl_util_alloc_case_dir( const char * path , const char * base , bool scan , char ** dir_base) {
+  ecl_dir_type * ecl_dir = NULL;
+  *dir_base = NULL;
+
+  if ((base != NULL) && (strpbrk( base , "*?[" ) == NULL)) {
+    const char * sep = strrchr( base , UTIL_PATH_SEP_CHAR );
+    char * dir_path = NULL;
+
+    if (sep == NULL) {
+      dir_path = util_alloc_string_copy( path );
+      *dir_base = util_alloc_string_copy( base );
+    } else if (sep != base) {
+      char * base_path = util_alloc_substring_copy( base , 0 , sep - base );
+      dir_path = util_alloc_filename( path , base_path , NULL );
+      *dir_base = util_alloc_string_copy( sep + 1 );
+      free( base_path );
+    }
+
+    if (*dir_base != NULL) {
+      if (scan)
+        ecl_dir = ecl_dir_alloc_shared( dir_path );
+      else
+        ecl_dir = ecl_dir_alloc_shared_current( dir_path );
+    }
+    util_safe_free( dir_path );
+  }
+
+  return ecl_dir;
+}
+
+
+static char * ecl_util_alloc_exfilename_dir( const ecl_dir_type * ecl_dir , const char * path, const char * base , ecl_file_enum file_type , bool fmt_file, int report_nr) {
+  if (ecl_dir) {
+    char * filename = ecl_util_alloc_filename( path , base , file_type , fmt_file , report_nr );
+    if (!ecl_dir_has_file( ecl_dir , filename )) {
+      free( filename );
+      filename = NULL;
+    }
+    return filename;
+  } else
+    return ecl_util_alloc_exfilename( path , base , file_type , fmt_file , report_nr );
+}
+
+
+static int ecl_util_select_filelist__( const char * path , const char * base , ecl_file_enum file_type , bool fmt_file , stringlist_type * filelist) {
   char       * file_pattern;
   char       * base_pattern;
   const char * extension = ecl_util_get_file_pattern( file_type , fmt_file );
@@ -592,6 +647,37 @@ int ecl_util_select_filelist( const char * path , const char * base , ecl_file_e
 }
 
 
+static int ecl_util_select_filelist_dir( const ecl_dir_type * ecl_dir , const char * path , const char * base , const char * dir_base , ecl_file_enum file_type , bool fmt_file , stringlist_type * filelist) {
+  if (ecl_dir)
+    return ecl_dir_select_files( ecl_dir , dir_base , file_type , fmt_file , filelist );
+  else
+    return ecl_util_select_filelist__( path , base , file_type , fmt_file , filelist );
+}
+
+
+/*
+  When the case is given explicitly the files are taken from the
+  ecl_dir catalogue of the directory; i.e. repeated calls for the
+  different file types of a case only read the directory once.
+*/
+
+int ecl_util_select_filelist( const char * path , const char * base , ecl_file_enum file_type , bool fmt_file , stringlist_type * filelist) {
+  char * dir_base = NULL;
+  ecl_dir_type * ecl_dir = NULL;
+  int num_files;
+
+  if (file_type != ECL_OTHER_FILE)
+    ecl_dir = ecl_util_alloc_case_dir( path , base , true , &dir_base );
+
+  num_files = ecl_util_select_filelist_dir( ecl_dir , path , base , dir_base , file_type , fmt_file , filelist );
+
+  if (ecl_dir)
+    ecl_dir_free( ecl_dir );
+  util_safe_free( dir_base );
+  return num_files;
+}
+
+
 bool ecl_util_unified_file(const char *filename) {
   int report_nr;
   ecl_file_enum file_type;
@@ -697,9 +783,9 @@ void ecl_util_memcpy_typed_data(void *_target_data , const void * _src_data , ec
   @base input can contain an embedded path component.
 */
 
-void ecl_util_alloc_summary_data_files(const char * path , const char * base , bool fmt_file , stringlist_type * filelist) {
-  char  * unif_data_file = ecl_util_alloc_exfilename(path , base , ECL_UNIFIED_SUMMARY_FILE , fmt_file , -1);
-  int files = ecl_util_select_filelist( path , base , ECL_SUMMARY_FILE , fmt_file , filelist);
+static void ecl_util_alloc_summary_data_files__(const ecl_dir_type * ecl_dir , const char * path , const char * base , const char * dir_base , bool fmt_file , stringlist_type * filelist) {
+  char  * unif_data_file = ecl_util_alloc_exfilename_dir(ecl_dir , path , base , ECL_UNIFIED_SUMMARY_FILE , fmt_file , -1);
+  int files = ecl_util_select_filelist_dir( ecl_dir , path , base , dir_base , ECL_SUMMARY_FILE , fmt_file , filelist);
 
   if ((files > 0) && (unif_data_file != NULL)) {
     /*
@@ -728,6 +814,18 @@ void ecl_util_alloc_summary_data_files(const char * path , const char * base , b
 }
 
 
+void ecl_util_alloc_summary_data_files(const char * path , const char * base , bool fmt_file , stringlist_type * filelist) {
+  char * dir_base;
+  ecl_dir_type * ecl_dir = ecl_util_alloc_case_dir( path , base , true , &dir_base );
+
+  ecl_util_alloc_summary_data_files__( ecl_dir , path , base , dir_base , fmt_file , filelist );
+
+  if (ecl_dir)
+    ecl_dir_free( ecl_dir );
+  util_safe_free( dir_base );
+}
+
+
 
 /**
    This routine allocates summary header and data files from a
@@ -774,6 +872,8 @@ bool ecl_util_alloc_summary_files(const char * path , const char * _base , const
 
   char  * header_file    = NULL;
   char  * base;
+  char  * dir_base;
+  ecl_dir_type * ecl_dir;
 
   *_header_file = NULL;
 
@@ -821,44 +921,47 @@ bool ecl_util_alloc_summary_files(const char * path , const char * _base , const
   }
 
 
+  /*
+    The directory is read once and all the files are looked up in the
+    ecl_dir catalogue; except when we are only looking for unified
+    files, then a few stat() calls are cheaper than a scan.
+  */
+  ecl_dir = ecl_util_alloc_case_dir( path , base , !(unif_set && unif_input) , &dir_base );
+
   /*
     2: We continue by looking for header files.
   */
 
   {
-    char * fsmspec_file = ecl_util_alloc_exfilename(path , base , ECL_SUMMARY_HEADER_FILE , true  , -1);
-    char *  smspec_file = ecl_util_alloc_exfilename(path , base , ECL_SUMMARY_HEADER_FILE , false , -1);
-
-    if ((fsmspec_file == NULL) && (smspec_file == NULL))   /* Neither file exists */
-      return false;
-
-
-    if (fmt_set)  /* The question of formatted|unformatted has already been settled based on the input filename. */
-      fmt_file = fmt_input;
-    else {
-      if ((fsmspec_file != NULL) && (smspec_file != NULL)) {   /* Both fsmspec and smspec exist - we take the newest. */
-        if (util_file_difftime(fsmspec_file , smspec_file) < 0)
-          fmt_file = true;
-        else
-          fmt_file = false;
-      } else {                                                /* Only one of fsmspec / smspec exists */
-        if (fsmspec_file != NULL)
-          fmt_file = true;
-        else
-          fmt_file = false;
+    char * fsmspec_file = ecl_util_alloc_exfilename_dir(ecl_dir , path , base , ECL_SUMMARY_HEADER_FILE , true  , -1);
+    char *  smspec_file = ecl_util_alloc_exfilename_dir(ecl_dir , path , base , ECL_SUMMARY_HEADER_FILE , false , -1);
+
+    if ((fsmspec_file != NULL) || (smspec_file != NULL)) {
+      if (fmt_set)  /* The question of formatted|unformatted has already been settled based on the input filename. */
+        fmt_file = fmt_input;
+      else {
+        if ((fsmspec_file != NULL) && (smspec_file != NULL)) {   /* Both fsmspec and smspec exist - we take the newest. */
+          if (util_file_difftime(fsmspec_file , smspec_file) < 0)
+            fmt_file = true;
+          else
+            fmt_file = false;
+        } else {                                                /* Only one of fsmspec / smspec exists */
+          if (fsmspec_file != NULL)
+            fmt_file = true;
+          else
+            fmt_file = false;
+        }
       }
-    }
 
-    if (fmt_file) {
-      header_file = fsmspec_file;
-      util_safe_free( smspec_file );
-    } else {
-      header_file = smspec_file;
-      util_safe_free( fsmspec_file );
+      if (fmt_file) {
+        header_file = fsmspec_file;
+        util_safe_free( smspec_file );
+      } else {
+        header_file = smspec_file;
+        util_safe_free( fsmspec_file );
+      }
     }
-
-    if (header_file == NULL)
-      return false;                                           /* If you insist on e.g. unformatted and only fsmspec exists - no results for you. */
+    /* If you insist on e.g. unformatted and only fsmspec exists - no results for you. */
   }
 
 
@@ -868,23 +971,32 @@ bool ecl_util_alloc_summary_files(const char * path , const char * _base , const
      XXX.Snnnn / XXX.UNSMRY files.
   */
 
-  if (unif_set) { /* Based on the input file we have inferred whether to look for unified or
-                     non-unified input files. */
+  if (header_file != NULL) {
+    if (unif_set) { /* Based on the input file we have inferred whether to look for unified or
+                       non-unified input files. */
 
-    if ( unif_input ) {
-      char  * unif_data_file = ecl_util_alloc_exfilename(path , base , ECL_UNIFIED_SUMMARY_FILE , fmt_file , -1);
-      if (unif_data_file != NULL) {
-        stringlist_append_copy( filelist , unif_data_file );
-        free( unif_data_file );
-      }
+      if ( unif_input ) {
+        char  * unif_data_file = ecl_util_alloc_exfilename_dir(ecl_dir , path , base , ECL_UNIFIED_SUMMARY_FILE , fmt_file , -1);
+        if (unif_data_file != NULL) {
+          stringlist_append_copy( filelist , unif_data_file );
+          free( unif_data_file );
+        }
+      } else
+        ecl_util_select_filelist_dir( ecl_dir , path , base , dir_base , ECL_SUMMARY_FILE , fmt_file , filelist);
     } else
-      ecl_util_select_filelist( path , base , ECL_SUMMARY_FILE , fmt_file , filelist);
-  } else
-    ecl_util_alloc_summary_data_files( path , base , fmt_file , filelist );
+      ecl_util_alloc_summary_data_files__( ecl_dir , path , base , dir_base , fmt_file , filelist );
+  }
+
+  if (ecl_dir)
+    ecl_dir_free( ecl_dir );
+  util_safe_free( dir_base );
 
   if (_base == NULL)
     free(base);
 
+  if (header_file == NULL)
+    return false;
+
   *_header_file    = header_file;
 
   return (stringlist_get_size(filelist) > 0) ? true : false;
@@ -913,99 +1025,113 @@ bool ecl_util_alloc_summary_files(const char * path , const char * _base , const
 
 
 
-void ecl_util_alloc_restart_files(const char * path , const char * _base , char *** _restart_files , int * num_restart_files , bool * _fmt_file , bool * _unified) {
+static void ecl_util_alloc_restart_files__(const char * path , const char * base , char *** _restart_files , int * num_restart_files , bool * _fmt_file , bool * _unified) {
+  char * dir_base;
+  ecl_dir_type * ecl_dir = ecl_util_alloc_case_dir( path , base , true , &dir_base );
+  stringlist_type * F_files = stringlist_alloc_new( );
+  stringlist_type * X_files = stringlist_alloc_new( );
+  char * unrst_file  = ecl_util_alloc_exfilename_dir( ecl_dir , path , base , ECL_UNIFIED_RESTART_FILE , false , -1);
+  char * funrst_file = ecl_util_alloc_exfilename_dir( ecl_dir , path , base , ECL_UNIFIED_RESTART_FILE , true  , -1);
+  const char * unif_file = NULL;
+  const char * FX_file = NULL;
+  const char * final_file = NULL;
+  int num_F_files = ecl_util_select_filelist_dir( ecl_dir , path , base , dir_base , ECL_RESTART_FILE , true  , F_files );
+  int num_X_files = ecl_util_select_filelist_dir( ecl_dir , path , base , dir_base , ECL_RESTART_FILE , false , X_files );
+
+  if (unrst_file && funrst_file)
+    unif_file = util_newest_file( unrst_file , funrst_file );
+  else if (unrst_file)
+    unif_file = unrst_file;
+  else
+    unif_file = funrst_file;
 
-  util_exit("Function:%s currently not implemented - sorry \n",__func__);
-
-  //char * base = NULL;
-  //if (_base == NULL)
-  //  base = ecl_util_alloc_base_guess(path);
-  //else
-  //  base = (char *) _base;
-  //{
-  //  int num_F_files;
-  //  int num_X_files;
-  //
-  //  char *  unrst_file  = ecl_util_alloc_filename(path , base , ECL_UNIFIED_RESTART_FILE , false , -1);
-  //  char *  funrst_file = ecl_util_alloc_filename(path , base , ECL_UNIFIED_RESTART_FILE , true  , -1);
-  //  char *  unif_file   = NULL;
-  //
-  //  char ** F_files     = ecl_util_alloc_scandir_filelist(path , base , ECL_RESTART_FILE , true  , &num_F_files);
-  //  char ** X_files     = ecl_util_alloc_scandir_filelist(path , base , ECL_RESTART_FILE , false , &num_X_files);
-  //  char *  FX_file      = NULL;
-  //  char *  final_file;
-  //
-  //  /*
-  //    Ok now we have formatted/unformatted unified and not
-  //    unified: Time to check what exists in the filesystem, and which
-  //    is the newest.
-  //  */
-  //  unif_file = util_newest_file(unrst_file , funrst_file);
-  //
-  //  if (num_F_files > 0 || num_X_files > 0) {
-  //    if (num_F_files > 0 && num_X_files > 0) {
-  //      /*
-  //         We have both a list of .Fnnnn and a list of .Xnnnn files; if
-  //         the length of lists is not equal we take the longest,
-  //         otherwise we compare the dates of the last files in the
-  //         list.
-  //      */
-  //      if (num_F_files == num_X_files) {
-  //        FX_file = util_newest_file( F_files[num_F_files - 1] , X_files[num_X_files - 1]);
-  //      } else if (num_F_files > num_X_files)
-  //        FX_file = F_files[num_F_files - 1];
-  //      else
-  //        FX_file = X_files[num_X_files - 1];
-  //    } else if (num_F_files > 0)
-  //      FX_file = F_files[num_F_files - 1];
-  //    else
-  //      FX_file = X_files[num_X_files - 1];
-  //
-  //    if (unif_file != NULL)
-  //      final_file = util_newest_file(unif_file , FX_file);
-  //    else
-  //      final_file = FX_file;
-  //  } else
-  //    final_file = unif_file;
-  //
-  //
-  //  if (final_file == NULL)
-  //    util_abort("%s: could not find any restart data in %s/%s \n",__func__ , path , base);
-  //
-  //
-  //  /*
-  //     Determine type of final_file. Thois block is where the return
-  //     values are actually set.
-  //  */
-  //  {
-  //    char ** restart_files;
-  //    bool fmt_file , unified;
-  //    ecl_file_enum file_type;
-  //
-  //    ecl_util_get_file_type( final_file , &file_type , &fmt_file , NULL);
-  //    if (file_type == ECL_UNIFIED_RESTART_FILE) {
-  //      *num_restart_files = 1;
-  //      restart_files = util_malloc(sizeof * restart_files, __func__);
-  //      restart_files[0] = util_alloc_string_copy( final_file );
-  //      unified = true;
-  //    } else {
-  //      restart_files = ecl_util_alloc_scandir_filelist( path , base , ECL_RESTART_FILE , fmt_file , num_restart_files);
-  //      unified = false;
-  //    }
-  //    *_restart_files = restart_files;
-  //
-  //    if (_fmt_file != NULL) *_fmt_file = fmt_file;
-  //    if (_unified  != NULL) *_unified  = unified;
-  //  }
-  //
-  //  util_free_stringlist(F_files , num_F_files);
-  //  util_free_stringlist(X_files , num_X_files);
-  //  free(unrst_file);
-  //  free(funrst_file);
-  //}
-  //
-  //if (_base == NULL)
-  //  free(base);
+  if ((num_F_files > 0) && (num_X_files > 0)) {
+    /*
+      We have both a list of .Fnnnn and a list of .Xnnnn files; if the
+      length of lists is not equal we take the longest, otherwise we
+      compare the dates of the last files in the list.
+    */
+    if (num_F_files == num_X_files)
+      FX_file = util_newest_file( stringlist_iget( F_files , num_F_files - 1) , stringlist_iget( X_files , num_X_files - 1));
+    else if (num_F_files > num_X_files)
+      FX_file = stringlist_iget( F_files , num_F_files - 1 );
+    else
+      FX_file = stringlist_iget( X_files , num_X_files - 1 );
+  } else if (num_F_files > 0)
+    FX_file = stringlist_iget( F_files , num_F_files - 1 );
+  else if (num_X_files > 0)
+    FX_file = stringlist_iget( X_files , num_X_files - 1 );
+
+  if (unif_file && FX_file)
+    final_file = util_newest_file( unif_file , FX_file );
+  else if (unif_file)
+    final_file = unif_file;
+  else
+    final_file = FX_file;
+
+  {
+    char ** restart_files = NULL;
+    bool fmt_file = false;
+    bool unified = false;
+
+    *num_restart_files = 0;
+    if (final_file != NULL) {
+      ecl_file_enum file_type = ecl_util_get_file_type( final_file , &fmt_file , NULL );
+      if (file_type == ECL_UNIFIED_RESTART_FILE) {
+        restart_files = util_malloc( sizeof * restart_files );
+        restart_files[0] = util_alloc_string_copy( final_file );
+        *num_restart_files = 1;
+        unified = true;
+      } else {
+        const stringlist_type * files = fmt_file ? F_files : X_files;
+        int i;
+
+        *num_restart_files = stringlist_get_size( files );
+        restart_files = util_calloc( *num_restart_files , sizeof * restart_files );
+        for (i = 0; i < *num_restart_files; i++)
+          restart_files[i] = util_alloc_string_copy( stringlist_iget( files , i ));
+      }
+    }
+
+    *_restart_files = restart_files;
+    if (_fmt_file != NULL) *_fmt_file = fmt_file;
+    if (_unified  != NULL) *_unified  = unified;
+  }
+
+  stringlist_free( F_files );
+  stringlist_free( X_files );
+  util_safe_free( unrst_file );
+  util_safe_free( funrst_file );
+  if (ecl_dir)
+    ecl_dir_free( ecl_dir );
+  util_safe_free( dir_base );
+}
+
+
+/**
+   Finds the restart files of a case: either a unified file or a list
+   of BASE.Xnnnn / BASE.Fnnnn files, formatted or unformatted. When
+   several of these exist the one with the most recent file is used;
+   for two lists of non-unified files the longest list is used. The
+   files are returned in a newly allocated array which the caller must
+   free with util_free_stringlist(); if no restart files are found
+   *num_restart_files is zero and *restart_files NULL.
+
+   The directory is read once, through the ecl_dir catalogue.
+*/
+
+void ecl_util_alloc_restart_files(const char * path , const char * _base , char *** _restart_files , int * num_restart_files , bool * _fmt_file , bool * _unified) {
+  char * base = (_base == NULL) ? ecl_util_alloc_base_guess(path) : (char *) _base;
+  if (base == NULL) {
+    *_restart_files = NULL;
+    *num_restart_files = 0;
+    if (_fmt_file != NULL) *_fmt_file = false;
+    if (_unified  != NULL) *_unified  = false;
+    return;
+  }
+  ecl_util_alloc_restart_files__( path , base , _restart_files , num_restart_files , _fmt_file , _unified );
+  if (_base == NULL)
+    free( base );
 }
 
 
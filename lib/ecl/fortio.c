@@ -25,6 +25,7 @@
 #include <ert/util/util.h>
 #include <ert/util/type_macros.h>
 #include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_perf.h>
 
 
 #define FORTIO_ID  345116
@@ -459,6 +460,7 @@ int fortio_init_read(fortio_type *fortio) {
     if (fortio->endian_flip_header)
       util_endian_flip_vector(&record_size , sizeof record_size , 1);
 
+    ECL_PERF_ADD( ECL_PERF_RECORDS_READ , 1 );
     return record_size;
   } else
     return -1;
@@ -526,6 +528,7 @@ static int fortio_fread_record(fortio_type *fortio , char *buffer) {
   int record_size = fortio_init_read(fortio);
   if (record_size >= 0) {
     size_t items_read = fread(buffer , 1 , record_size , fortio->stream);
+    ECL_PERF_ADD( ECL_PERF_BYTES_READ , items_read );
     if (items_read == record_size) {
       bool complete_ok = fortio_complete_read(fortio , record_size);
       if (!complete_ok)
@@ -605,6 +608,7 @@ void fortio_copy_record(fortio_type * src_stream , fortio_type * target_stream ,
 
     util_fread(buffer , 1 , bytes , src_stream->stream     , __func__);
     util_fwrite(buffer , 1 , bytes , target_stream->stream , __func__);
+    ECL_PERF_ADD( ECL_PERF_BYTES_READ , bytes );
 
     bytes_read += bytes;
   }
@@ -623,6 +627,8 @@ void fortio_copy_record(fortio_type * src_stream , fortio_type * target_stream ,
 
 void  fortio_init_write(fortio_type *fortio , int record_size) {
   int file_header;
+  ECL_PERF_ADD( ECL_PERF_RECORDS_WRITTEN , 1 );
+  ECL_PERF_ADD( ECL_PERF_BYTES_WRITTEN , record_size );
   file_header = record_size;
   if (fortio->endian_flip_header)
     util_endian_flip_vector(&file_header , sizeof file_header , 1);
@@ -651,6 +657,7 @@ void * fortio_fread_alloc_record(fortio_type * fortio) {
   int record_size = fortio_init_read(fortio);
   buffer = util_malloc( record_size );
   util_fread(buffer , 1 , record_size , fortio->stream , __func__);
+  ECL_PERF_ADD( ECL_PERF_BYTES_READ , record_size );
   fortio_complete_read(fortio , record_size);
   return buffer;
 }
@@ -749,6 +756,7 @@ offset_type fortio_ftell( const fortio_type * fortio ) {
 
 static bool fortio_fseek__(fortio_type * fortio , offset_type offset , int whence) {
   int fseek_return = util_fseek( fortio->stream , offset , whence );
+  ECL_PERF_ADD( ECL_PERF_SEEK , 1 );
   if (fseek_return == 0)
     return true;
   else
@@ -814,7 +822,72 @@ int fortio_fileno( fortio_type * fortio ) {
 }
 
 
+/*
+  Will read size bytes starting at the absolute offset into buffer,
+  without going through the stdio buffer and without moving the
+  current position of the fortio stream. Pending writes are flushed
+  first so the read sees the current content of the file. Observe
+  that the offset is a raw byte offset; the function does not know
+  about the record headers, and that the fortio instance must have
+  been opened for reading.
+*/
+
+bool fortio_pread( fortio_type * fortio , offset_type offset , void * buffer , size_t size) {
+  if (fortio->writable)
+    fflush( fortio->stream );
+
+  ECL_PERF_ADD( ECL_PERF_BYTES_READ , size );
+  return util_pread( fileno( fortio->stream ) , buffer , size , offset );
+}
+
+
+
+
+
+/*
+  Two fortio instances have the same format if they are both
+  formatted or both unformatted and have the same byte order for the
+  record headers; data can then be copied between them byte for byte.
+*/
 
+bool fortio_same_format( const fortio_type * fortio1 , const fortio_type * fortio2 ) {
+  return (fortio1->fmt_file == fortio2->fmt_file) && (fortio1->endian_flip_header == fortio2->endian_flip_header);
+}
+
+
+/*
+  Copies size raw bytes starting at the absolute offset in @src to the
+  current position of @target, and positions @target after the copied
+  bytes; the position of @src is not changed. The bytes are passed
+  through unchanged - no record structure is checked and no endian
+  conversion is done - so the range should cover complete records,
+  and the two files should have the same format, see
+  fortio_same_format(). Where possible the copy is done by the kernel
+  with copy_file_range() or sendfile().
+*/
+
+#define FORTIO_COPY_BUFFER_SIZE (64 * 1024)
+
+bool fortio_fcopy_range( fortio_type * src , offset_type offset , offset_type size , fortio_type * target) {
+  char buffer[FORTIO_COPY_BUFFER_SIZE];
+  offset_type target_offset;
+  bool copy_ok;
+
+  if (src->writable)
+    fflush( src->stream );
+  fflush( target->stream );
+  target_offset = fortio_ftell( target );
+
+  copy_ok = util_copy_fd_range( fileno( src->stream ) , offset , fileno( target->stream ) , target_offset , size , sizeof buffer , buffer );
+  if (copy_ok) {
+    ECL_PERF_ADD( ECL_PERF_BYTES_READ , size );
+    ECL_PERF_ADD( ECL_PERF_BYTES_WRITTEN , size );
+  }
+
+  /* The stdio stream of target must be brought in sync with the descriptor. */
+  fortio_fseek__( target , target_offset + size , SEEK_SET );
+  return copy_ok;
+}
 
 /*
   It is massively undefined behaviour to call this function for a file
@@ -0,0 +1,326 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'fortio_cache.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <ert/util/util.h>
+#include <ert/util/vector.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/fortio_cache.h>
+
+
+/*
+  The fortio_cache keeps many fortio instances alive while limiting
+  the number of open streams, and thereby file descriptors. A fortio
+  instance whose stream has been closed is reopened on demand by
+  fortio_cache_acquire(); since all readers seek to an absolute
+  offset before reading, the position lost when a stream is closed
+  does not matter.
+
+  The cache lock protects the bookkeeping; the entry lock is held by
+  the thread using the fortio instance between acquire() and
+  release(). An entry which has been acquired - or is waited for - is
+  never closed by the eviction.
+*/
+
+
+typedef struct {
+  fortio_type     * fortio;
+  int               in_use;
+  int64_t           last_use;
+#ifdef HAVE_PTHREAD
+  pthread_mutex_t   lock;
+#endif
+} fortio_cache_entry_type;
+
+
+struct fortio_cache_struct {
+  vector_type     * entries;    /* The id is the index in this vector; removed entries are NULL. */
+  int_vector_type * free_ids;
+  int               max_open;
+  int               num_open;
+  int64_t           clock;
+#ifdef HAVE_PTHREAD
+  pthread_mutex_t   lock;
+#endif
+};
+
+
+#ifdef HAVE_PTHREAD
+#define FORTIO_CACHE_LOCK( cache )     pthread_mutex_lock( &((fortio_cache_type *) (cache))->lock )
+#define FORTIO_CACHE_UNLOCK( cache )   pthread_mutex_unlock( &((fortio_cache_type *) (cache))->lock )
+#define FORTIO_ENTRY_LOCK( entry )     pthread_mutex_lock( &(entry)->lock )
+#define FORTIO_ENTRY_UNLOCK( entry )   pthread_mutex_unlock( &(entry)->lock )
+
+static pthread_mutex_t shared_lock = PTHREAD_MUTEX_INITIALIZER;
+#else
+#define FORTIO_CACHE_LOCK( cache )
+#define FORTIO_CACHE_UNLOCK( cache )
+#define FORTIO_ENTRY_LOCK( entry )
+#define FORTIO_ENTRY_UNLOCK( entry )
+#endif
+
+static fortio_cache_type * shared_cache = NULL;
+
+
+
+fortio_cache_type * fortio_cache_alloc( int max_open ) {
+  fortio_cache_type * cache = util_malloc( sizeof * cache );
+  cache->entries  = vector_alloc_new( );
+  cache->free_ids = int_vector_alloc( 0 , 0 );
+  cache->max_open = util_int_max( 1 , max_open );
+  cache->num_open = 0;
+  cache->clock    = 0;
+#ifdef HAVE_PTHREAD
+  pthread_mutex_init( &cache->lock , NULL );
+#endif
+  return cache;
+}
+
+
+static void fortio_cache_entry_free( fortio_cache_entry_type * entry ) {
+  fortio_fclose( entry->fortio );
+#ifdef HAVE_PTHREAD
+  pthread_mutex_destroy( &entry->lock );
+#endif
+  free( entry );
+}
+
+
+void fortio_cache_free( fortio_cache_type * cache ) {
+  int id;
+  for (id = 0; id < vector_get_size( cache->entries ); id++) {
+    fortio_cache_entry_type * entry = vector_iget( cache->entries , id );
+    if (entry)
+      fortio_cache_entry_free( entry );
+  }
+  vector_free( cache->entries );
+  int_vector_free( cache->free_ids );
+#ifdef HAVE_PTHREAD
+  pthread_mutex_destroy( &cache->lock );
+#endif
+  free( cache );
+}
+
+
+/*
+  The process wide cache; it is created on first use and lives until
+  the process exits.
+*/
+
+fortio_cache_type * fortio_cache_get_shared( void ) {
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock( &shared_lock );
+#endif
+  if (!shared_cache)
+    shared_cache = fortio_cache_alloc( FORTIO_CACHE_DEFAULT_MAX_OPEN );
+#ifdef HAVE_PTHREAD
+  pthread_mutex_unlock( &shared_lock );
+#endif
+  return shared_cache;
+}
+
+
+static fortio_cache_entry_type * fortio_cache_iget_entry( const fortio_cache_type * cache , int id ) {
+  fortio_cache_entry_type * entry = NULL;
+  if ((id >= 0) && (id < vector_get_size( cache->entries )))
+    entry = vector_iget( cache->entries , id );
+
+  if (!entry)
+    util_abort("%s: no fortio instance with id:%d - the file has been removed from the cache.\n",__func__ , id);
+
+  return entry;
+}
+
+
+/*
+  Closes idle streams, least recently used first, until at most
+  @limit streams are open. Must be called with the cache lock held.
+*/
+
+static void fortio_cache_close_idle( fortio_cache_type * cache , int limit ) {
+  while (cache->num_open > limit) {
+    fortio_cache_entry_type * lru = NULL;
+    int id;
+
+    for (id = 0; id < vector_get_size( cache->entries ); id++) {
+      fortio_cache_entry_type * entry = vector_iget( cache->entries , id );
+      if (entry && (entry->in_use == 0) && fortio_stream_is_open( entry->fortio )) {
+        if (!lru || (entry->last_use < lru->last_use))
+          lru = entry;
+      }
+    }
+
+    if (!lru)
+      break;     /* All the open streams are in use; the limit is exceeded until they are released. */
+
+    fortio_fclose_stream( lru->fortio );
+    cache->num_open--;
+  }
+}
+
+
+void fortio_cache_set_max_open( fortio_cache_type * cache , int max_open ) {
+  FORTIO_CACHE_LOCK( cache );
+  cache->max_open = util_int_max( 1 , max_open );
+  fortio_cache_close_idle( cache , cache->max_open );
+  FORTIO_CACHE_UNLOCK( cache );
+}
+
+
+int fortio_cache_get_max_open( const fortio_cache_type * cache ) {
+  return cache->max_open;
+}
+
+
+int fortio_cache_get_num_open( const fortio_cache_type * cache ) {
+  int num_open;
+  FORTIO_CACHE_LOCK( cache );
+  num_open = cache->num_open;
+  FORTIO_CACHE_UNLOCK( cache );
+  return num_open;
+}
+
+
+int fortio_cache_get_size( const fortio_cache_type * cache ) {
+  int size;
+  FORTIO_CACHE_LOCK( cache );
+  size = vector_get_size( cache->entries ) - int_vector_size( cache->free_ids );
+  FORTIO_CACHE_UNLOCK( cache );
+  return size;
+}
+
+
+/*
+  The cache takes ownership of the fortio instance, and closes the
+  stream; the fortio instance is closed and freed with
+  fortio_cache_remove(). The fortio instance must own its stream,
+  i.e. it can not be a FILE wrapper.
+*/
+
+int fortio_cache_add( fortio_cache_type * cache , fortio_type * fortio ) {
+  fortio_cache_entry_type * entry = util_malloc( sizeof * entry );
+  int id;
+
+  fortio_fclose_stream( fortio );
+  entry->fortio   = fortio;
+  entry->in_use   = 0;
+  entry->last_use = 0;
+#ifdef HAVE_PTHREAD
+  pthread_mutex_init( &entry->lock , NULL );
+#endif
+
+  FORTIO_CACHE_LOCK( cache );
+  if (int_vector_size( cache->free_ids ) > 0) {
+    id = int_vector_pop( cache->free_ids );
+    vector_iset_ref( cache->entries , id , entry );
+  } else
+    id = vector_append_ref( cache->entries , entry );
+  FORTIO_CACHE_UNLOCK( cache );
+
+  return id;
+}
+
+
+void fortio_cache_remove( fortio_cache_type * cache , int id ) {
+  fortio_cache_entry_type * entry;
+
+  FORTIO_CACHE_LOCK( cache );
+  entry = fortio_cache_iget_entry( cache , id );
+  if (entry->in_use > 0)
+    util_abort("%s: the fortio instance:%s is in use.\n",__func__ , fortio_filename_ref( entry->fortio ));
+
+  if (fortio_stream_is_open( entry->fortio ))
+    cache->num_open--;
+
+  vector_iset_ref( cache->entries , id , NULL );
+  int_vector_append( cache->free_ids , id );
+  FORTIO_CACHE_UNLOCK( cache );
+
+  fortio_cache_entry_free( entry );
+}
+
+
+const char * fortio_cache_iget_filename( const fortio_cache_type * cache , int id ) {
+  const fortio_cache_entry_type * entry;
+  FORTIO_CACHE_LOCK( cache );
+  entry = fortio_cache_iget_entry( cache , id );
+  FORTIO_CACHE_UNLOCK( cache );
+  return fortio_filename_ref( entry->fortio );
+}
+
+
+/*
+  Returns the fortio instance with an open stream, or NULL if the
+  stream could not be opened. The fortio instance must be handed back
+  with fortio_cache_release() when the caller is done with it; the
+  stream should not be closed by the caller.
+*/
+
+fortio_type * fortio_cache_acquire( fortio_cache_type * cache , int id ) {
+  fortio_cache_entry_type * entry;
+  bool stream_open;
+
+  FORTIO_CACHE_LOCK( cache );
+  entry = fortio_cache_iget_entry( cache , id );
+  entry->in_use++;
+  if (!fortio_stream_is_open( entry->fortio )) {
+    fortio_cache_close_idle( cache , cache->max_open - 1 );
+    if (fortio_fopen_stream( entry->fortio ))
+      cache->num_open++;
+  }
+  cache->clock++;
+  entry->last_use = cache->clock;
+  stream_open = fortio_stream_is_open( entry->fortio );
+  if (!stream_open)
+    entry->in_use--;
+  FORTIO_CACHE_UNLOCK( cache );
+
+  if (!stream_open)
+    return NULL;
+
+  FORTIO_ENTRY_LOCK( entry );
+  return entry->fortio;
+}
+
+
+void fortio_cache_release( fortio_cache_type * cache , int id ) {
+  fortio_cache_entry_type * entry;
+
+  FORTIO_CACHE_LOCK( cache );
+  entry = fortio_cache_iget_entry( cache , id );
+  FORTIO_CACHE_UNLOCK( cache );
+
+  FORTIO_ENTRY_UNLOCK( entry );
+
+  FORTIO_CACHE_LOCK( cache );
+  entry->in_use--;
+  fortio_cache_close_idle( cache , cache->max_open );
+  FORTIO_CACHE_UNLOCK( cache );
+}
@@ -21,6 +21,8 @@
 #include <math.h>
 #include <time.h>
 
+#include <ert/util/arena.h>
+#include <ert/util/str_intern.h>
 #include <ert/util/hash.h>
 #include <ert/util/util.h>
 #include <ert/util/set.h>
@@ -45,6 +47,16 @@
    and NUMS. The index field of this struct points to where the actual data
    can be found in the PARAMS vector of the *.Snnnn / *.UNSMRY files;
    probably the most important field.
+
+   The smspec_node instances created when loading a SMSPEC file are
+   allocated from an arena owned by the ecl_smspec instance, together
+   with all their strings and ijk vectors. For such nodes
+   smspec_node_free() is a no-op and the memory is released when the
+   arena is freed; nodes created with the ordinary smspec_node_alloc()
+   functions own their memory as before. For the arena nodes the
+   keyword, wgname, unit and lgr_name strings are in addition interned
+   in a str_intern table owned by the ecl_smspec, so that e.g. all the
+   nodes for well 'OP_1' share one wgname pointer.
 */
 
 #define SMSPEC_TYPE_ID 61550451
@@ -71,6 +83,8 @@ struct smspec_node_struct {
   int                    params_index;       /* The index of this variable (applies to all the vectors - in particular the PARAMS vectors of the summary files *.Snnnn / *.UNSMRY ). */
   float                  default_value;      /* Default value for this variable. */
   bool                   valid;
+  arena_type           * arena;              /* Not owned - NULL unless the node was allocated from an arena. */
+  str_intern_type      * strings;            /* Not owned - NULL unless the node was allocated from an arena with a strings table. */
 };
 
 
@@ -259,12 +273,61 @@ char * smspec_alloc_local_completion_key( const char * join_string, const char *
 
 /*****************************************************************/
 
+static char * smspec_node_alloc_substring( smspec_node_type * smspec_node , const char * s , int N) {
+  if (smspec_node->strings)
+    return (char *) str_intern_add_substring( smspec_node->strings , s , N );
+  else if (smspec_node->arena)
+    return arena_alloc_substring_copy( smspec_node->arena , s , 0 , N );
+  else
+    return util_alloc_substring_copy( s , 0 , N );
+}
+
+
+static char * smspec_node_alloc_string( smspec_node_type * smspec_node , const char * s ) {
+  if (smspec_node->strings)
+    return (char *) str_intern_add( smspec_node->strings , s );
+  else if (smspec_node->arena)
+    return arena_alloc_string_copy( smspec_node->arena , s );
+  else
+    return util_alloc_string_copy( s );
+}
+
+
+static void smspec_node_release( const smspec_node_type * smspec_node , void * ptr ) {
+  if (smspec_node->arena == NULL)
+    util_safe_free( ptr );
+}
+
+
+static int * smspec_node_alloc_ijk( smspec_node_type * smspec_node ) {
+  if (smspec_node->arena)
+    return arena_calloc( smspec_node->arena , 3 , sizeof(int) );
+  else
+    return util_calloc( 3 , sizeof(int) );
+}
+
+
+/*
+  The gen_key strings are created with util_alloc_sprintf(); for arena
+  nodes they are moved into the arena.
+*/
+
+static char * smspec_node_adopt_key( smspec_node_type * smspec_node , char * key ) {
+  if (smspec_node->arena && key) {
+    char * arena_key = arena_alloc_string_copy( smspec_node->arena , key );
+    free( key );
+    return arena_key;
+  } else
+    return key;
+}
+
+
 static void smspec_node_set_keyword( smspec_node_type * smspec_node , const char * keyword ) {
   // ECLIPSE Standard: Max eight characters - everything beyond is silently dropped
   // This function can __ONLY__ be called on time; run-time chaning of keyword is not
   // allowed.
   if (smspec_node->keyword == NULL)
-    smspec_node->keyword = util_alloc_substring_copy( keyword , 0 , 8);
+    smspec_node->keyword = smspec_node_alloc_substring( smspec_node , keyword , 8);
   else
     util_abort("%s: fatal error - attempt to change keyword runtime detected - aborting\n",__func__);
 }
@@ -362,8 +425,14 @@ float smspec_node_get_default( const smspec_node_type * smspec_node ) {
 }
 
 
-smspec_node_type * smspec_node_alloc_new(int params_index, float default_value) {
-  smspec_node_type * node = util_malloc( sizeof * node );
+static smspec_node_type * smspec_node_alloc_new__( arena_type * arena , str_intern_type * strings , int params_index, float default_value) {
+  smspec_node_type * node;
+  if (arena)
+    node = arena_malloc( arena , sizeof * node );
+  else
+    node = util_malloc( sizeof * node );
+  node->arena = arena;
+  node->strings = arena ? strings : NULL;
 
   UTIL_TYPE_ID_INIT( node , SMSPEC_TYPE_ID);
   node->params_index  = params_index;
@@ -386,25 +455,27 @@ smspec_node_type * smspec_node_alloc_new(int params_index, float default_value)
 }
 
 
+smspec_node_type * smspec_node_alloc_new(int params_index, float default_value) {
+  return smspec_node_alloc_new__( NULL , NULL , params_index , default_value );
+}
+
+
 static void smspec_node_set_wgname( smspec_node_type * index , const char * wgname ) {
-  if (wgname == NULL) {
-    util_safe_free( index->wgname );
-    index->wgname = NULL;
-  } else {
-    index->wgname = util_realloc_string_copy(index->wgname , wgname );
-  }
+  smspec_node_release( index , index->wgname );
+  index->wgname = smspec_node_alloc_string( index , wgname );
 }
 
 
 
 static void smspec_node_set_lgr_name( smspec_node_type * index , const char * lgr_name ) {
-  index->lgr_name = util_realloc_string_copy(index->lgr_name , lgr_name);
+  smspec_node_release( index , index->lgr_name );
+  index->lgr_name = smspec_node_alloc_string( index , lgr_name );
 }
 
 
 static void smspec_node_set_lgr_ijk( smspec_node_type * index , int lgr_i , int lgr_j , int lgr_k) {
   if (index->lgr_ijk == NULL)
-    index->lgr_ijk = util_calloc( 3 , sizeof * index->lgr_ijk );
+    index->lgr_ijk = smspec_node_alloc_ijk( index );
 
   index->lgr_ijk[0] = lgr_i;
   index->lgr_ijk[1] = lgr_j;
@@ -434,7 +505,7 @@ static void smspec_node_set_num( smspec_node_type * index , const int grid_dims[
   index->num = num;
   if ((index->var_type == ECL_SMSPEC_COMPLETION_VAR) || (index->var_type == ECL_SMSPEC_BLOCK_VAR)) {
     int global_index = num - 1;
-    index->ijk = util_calloc( 3 , sizeof * index->ijk );
+    index->ijk = smspec_node_alloc_ijk( index );
 
     index->ijk[2] = global_index / ( grid_dims[0] * grid_dims[1] );   global_index -= index->ijk[2] * (grid_dims[0] * grid_dims[1]);
     index->ijk[1] = global_index /  grid_dims[0] ;                    global_index -= index->ijk[1] * grid_dims[0];
@@ -544,6 +615,8 @@ static void smspec_node_set_gen_keys( smspec_node_type * smspec_node , const cha
   default:
     util_abort("%s: internal error - should not be here? \n" , __func__);
   }
+  smspec_node->gen_key1 = smspec_node_adopt_key( smspec_node , smspec_node->gen_key1 );
+  smspec_node->gen_key2 = smspec_node_adopt_key( smspec_node , smspec_node->gen_key2 );
   smspec_node->valid = true;
 }
 
@@ -551,8 +624,10 @@ static void smspec_node_set_gen_keys( smspec_node_type * smspec_node , const cha
 
 void smspec_node_update_wgname( smspec_node_type * index , const char * wgname , const char * key_join_string) {
   smspec_node_set_wgname( index , wgname );
-  util_safe_free( index->gen_key1 );
-  util_safe_free( index->gen_key2 );
+  smspec_node_release( index , index->gen_key1 );
+  smspec_node_release( index , index->gen_key2 );
+  index->gen_key1 = NULL;
+  index->gen_key2 = NULL;
   smspec_node_set_gen_keys( index , key_join_string );
 }
 
@@ -709,7 +784,29 @@ smspec_node_type * smspec_node_alloc( ecl_smspec_var_type var_type ,
        completely.
   */
 
-  smspec_node_type * smspec_node = smspec_node_alloc_new( param_index , default_value );
+  return smspec_node_alloc_arena( NULL , NULL , var_type , wgname , keyword , unit , key_join_string , grid_dims , num , param_index , default_value );
+}
+
+
+/*
+  As smspec_node_alloc(), but the node and all its strings are
+  allocated from the arena; the arena must outlive the node. With
+  arena == NULL this is identical to smspec_node_alloc(). The names
+  are interned in the strings table, which is only used together
+  with an arena and can be NULL.
+*/
+
+smspec_node_type * smspec_node_alloc_arena( arena_type * arena ,
+                                            str_intern_type * strings ,
+                                            ecl_smspec_var_type var_type ,
+                                            const char * wgname  ,
+                                            const char * keyword ,
+                                            const char * unit    ,
+                                            const char * key_join_string ,
+                                            const int grid_dims[3] ,
+                                            int num , int param_index, float default_value) {
+
+  smspec_node_type * smspec_node = smspec_node_alloc_new__( arena , strings , param_index , default_value );
   smspec_node_init( smspec_node , var_type , wgname , keyword , unit , key_join_string , grid_dims, num);
   return smspec_node;
 }
@@ -766,7 +863,22 @@ smspec_node_type * smspec_node_alloc_lgr( ecl_smspec_var_type var_type ,
                                           int   lgr_i, int lgr_j , int lgr_k,
                                           int param_index , float default_value) {
 
-  smspec_node_type * smspec_node = smspec_node_alloc_new( param_index , default_value );
+  return smspec_node_alloc_lgr_arena( NULL , NULL , var_type , wgname , keyword , unit , lgr , key_join_string , lgr_i , lgr_j , lgr_k , param_index , default_value );
+}
+
+
+smspec_node_type * smspec_node_alloc_lgr_arena( arena_type * arena ,
+                                                str_intern_type * strings ,
+                                                ecl_smspec_var_type var_type ,
+                                                const char * wgname  ,
+                                                const char * keyword ,
+                                                const char * unit    ,
+                                                const char * lgr ,
+                                                const char * key_join_string ,
+                                                int   lgr_i, int lgr_j , int lgr_k,
+                                                int param_index , float default_value) {
+
+  smspec_node_type * smspec_node = smspec_node_alloc_new__( arena , strings , param_index , default_value );
   smspec_node_init_lgr( smspec_node , var_type , wgname , keyword , unit , lgr , key_join_string , lgr_i, lgr_j , lgr_k);
   return smspec_node;
 }
@@ -778,6 +890,8 @@ smspec_node_type* smspec_node_alloc_copy( const smspec_node_type* node ) {
   {
     smspec_node_type* copy = util_malloc( sizeof * copy );
     UTIL_TYPE_ID_INIT( copy, SMSPEC_TYPE_ID );
+    copy->arena = NULL;
+    copy->strings = NULL;
     copy->gen_key1 = util_alloc_string_copy( node->gen_key1 );
     copy->gen_key2 = util_alloc_string_copy( node->gen_key2 );
     copy->var_type = node->var_type;
@@ -810,6 +924,9 @@ smspec_node_type* smspec_node_alloc_copy( const smspec_node_type* node ) {
 }
 
 void smspec_node_free( smspec_node_type * index ) {
+  if (index->arena)
+    return;
+
   util_safe_free( index->unit );
   util_safe_free( index->keyword );
   util_safe_free( index->ijk );
@@ -892,8 +1009,8 @@ const char  * smspec_node_get_unit( const smspec_node_type * smspec_node) {
 
 void smspec_node_set_unit( smspec_node_type * smspec_node , const char * unit ) {
   // ECLIPSE Standard: Max eight characters - everything beyond is silently dropped
-  util_safe_free( smspec_node->unit );
-  smspec_node->unit = util_alloc_substring_copy( unit , 0 , 8);
+  smspec_node_release( smspec_node , smspec_node->unit );
+  smspec_node->unit = smspec_node_alloc_substring( smspec_node , unit , 8);
 }
 
 
@@ -967,6 +1084,18 @@ void smspec_node_fprintf( const smspec_node_type * smspec_node , FILE * stream)
 }
 
 
+/*
+  For the nodes loaded from a SMSPEC file the names are interned, so
+  equal names will usually also be equal pointers.
+*/
+
+static int smspec_node_strcmp( const char * s1 , const char * s2 ) {
+  if (s1 == s2)
+    return 0;
+  return strcmp( s1 , s2 );
+}
+
+
 static bool smspec_node_equal_MISC( const smspec_node_type * node1, const smspec_node_type * node2) {
   return util_string_equal( node1->keyword , node2->keyword);
 }
@@ -1005,7 +1134,7 @@ static int smspec_node_cmp_MISC( const smspec_node_type * node1, const smspec_no
   if (!node1_early && node2_early)
     return 1;
 
-  return strcmp( node1->keyword, node2->keyword);
+  return smspec_node_strcmp( node1->keyword , node2->keyword );
 }
 
 
@@ -1033,11 +1162,11 @@ static int smspec_node_cmp_LGRIJK( const smspec_node_type * node1, const smspec_
 
 
 static int smspec_node_cmp_KEYWORD_LGR_LGRIJK( const smspec_node_type * node1, const smspec_node_type * node2) {
-  int keyword_cmp = strcmp( node1->keyword , node2->keyword);
+  int keyword_cmp = smspec_node_strcmp( node1->keyword , node2->keyword );
   if (keyword_cmp != 0)
     return keyword_cmp;
 
-  int lgr_cmp = strcmp( node1->lgr_name , node2->lgr_name);
+  int lgr_cmp = smspec_node_strcmp( node1->lgr_name , node2->lgr_name );
   if (lgr_cmp != 0)
     return lgr_cmp;
 
@@ -1046,11 +1175,11 @@ static int smspec_node_cmp_KEYWORD_LGR_LGRIJK( const smspec_node_type * node1, c
 
 
 static int smspec_node_cmp_KEYWORD_WGNAME_NUM( const smspec_node_type * node1, const smspec_node_type * node2) {
-  int keyword_cmp = strcmp( node1->keyword , node2->keyword);
+  int keyword_cmp = smspec_node_strcmp( node1->keyword , node2->keyword );
   if (keyword_cmp != 0)
     return keyword_cmp;
 
-  int wgname_cmp = strcmp( node1->wgname , node2->wgname);
+  int wgname_cmp = smspec_node_strcmp( node1->wgname , node2->wgname );
   if (wgname_cmp != 0)
     return wgname_cmp;
 
@@ -1058,28 +1187,28 @@ static int smspec_node_cmp_KEYWORD_WGNAME_NUM( const smspec_node_type * node1, c
 }
 
 static int smspec_node_cmp_KEYWORD_WGNAME_LGR( const smspec_node_type * node1, const smspec_node_type * node2) {
-  int keyword_cmp = strcmp( node1->keyword , node2->keyword);
+  int keyword_cmp = smspec_node_strcmp( node1->keyword , node2->keyword );
   if (keyword_cmp != 0)
     return keyword_cmp;
 
-  int wgname_cmp = strcmp( node1->wgname , node2->wgname);
+  int wgname_cmp = smspec_node_strcmp( node1->wgname , node2->wgname );
   if (wgname_cmp != 0)
     return wgname_cmp;
 
-  return strcmp( node1->lgr_name , node2->lgr_name);
+  return smspec_node_strcmp( node1->lgr_name , node2->lgr_name );
 }
 
 
 static int smspec_node_cmp_KEYWORD_WGNAME_LGR_LGRIJK( const smspec_node_type * node1, const smspec_node_type * node2) {
-  int keyword_cmp = strcmp( node1->keyword , node2->keyword);
+  int keyword_cmp = smspec_node_strcmp( node1->keyword , node2->keyword );
   if (keyword_cmp != 0)
     return keyword_cmp;
 
-  int wgname_cmp = strcmp( node1->wgname , node2->wgname);
+  int wgname_cmp = smspec_node_strcmp( node1->wgname , node2->wgname );
   if (wgname_cmp != 0)
     return wgname_cmp;
 
-  int lgr_cmp = strcmp( node1->lgr_name , node2->lgr_name);
+  int lgr_cmp = smspec_node_strcmp( node1->lgr_name , node2->lgr_name );
   if (lgr_cmp != 0)
     return lgr_cmp;
 
@@ -1090,7 +1219,7 @@ static int smspec_node_cmp_KEYWORD_WGNAME_LGR_LGRIJK( const smspec_node_type * n
 
 
 static int smspec_node_cmp_KEYWORD_WGNAME( const smspec_node_type * node1, const smspec_node_type * node2) {
-  int keyword_cmp = strcmp( node1->keyword , node2->keyword);
+  int keyword_cmp = smspec_node_strcmp( node1->keyword , node2->keyword );
   if (keyword_cmp != 0)
     return keyword_cmp;
 
@@ -1104,12 +1233,12 @@ static int smspec_node_cmp_KEYWORD_WGNAME( const smspec_node_type * node1, const
   if (IS_DUMMY_WELL( node2->wgname ))
     return -1;
 
-  return strcmp( node1->wgname , node2->wgname);
+  return smspec_node_strcmp( node1->wgname , node2->wgname );
 }
 
 
 static int smspec_node_cmp_KEYWORD_NUM( const smspec_node_type * node1, const smspec_node_type * node2) {
-  int keyword_cmp = strcmp( node1->keyword , node2->keyword);
+  int keyword_cmp = smspec_node_strcmp( node1->keyword , node2->keyword );
   if (keyword_cmp != 0)
     return keyword_cmp;
 
@@ -1118,7 +1247,7 @@ static int smspec_node_cmp_KEYWORD_NUM( const smspec_node_type * node1, const sm
 
 
 static int smspec_node_cmp_KEYWORD( const smspec_node_type * node1, const smspec_node_type * node2) {
-  return strcmp( node1->keyword , node2->keyword );
+  return smspec_node_strcmp( node1->keyword , node2->keyword );
 }
 
 static int smspec_node_cmp_key1( const smspec_node_type * node1, const smspec_node_type * node2) {
@@ -0,0 +1,282 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_cmp.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_kernel.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_cmp.h>
+
+
+
+void test_kernel( ) {
+  const int size = 3 * ECL_KW_KERNEL_SUM_BLOCK + 17;
+  double * data1 = util_malloc( size * sizeof * data1 );
+  double * data2 = util_malloc( size * sizeof * data2 );
+  ecl_kw_kernel_cmp_type cmp1 , cmp4;
+
+  for (int i = 0; i < size; i++) {
+    data1[i] = 1 + i;
+    data2[i] = 1 + i;
+  }
+  data1[10] = NAN;
+  data2[10] = NAN;
+
+  ecl_kw_kernel_cmp_double( data1 , data2 , size , 0 , 0 , &cmp1 );
+  test_assert_int_equal( cmp1.num_diff , 0 );
+  test_assert_int_equal( cmp1.first_diff , -1 );
+  test_assert_int_equal( ecl_kw_kernel_first_diff_double( data1 , data2 , size , 0 , 0 ) , size );
+
+  data2[ECL_KW_KERNEL_SUM_BLOCK + 5] += 1e-3;
+  data2[2 * ECL_KW_KERNEL_SUM_BLOCK + 7] += 10;
+  data2[3 * ECL_KW_KERNEL_SUM_BLOCK + 3] += 5;
+  data2[100] = NAN;
+
+  ecl_kw_kernel_set_parallel_size( 1000 );
+  ecl_kw_kernel_set_num_threads( 1 );
+  ecl_kw_kernel_cmp_double( data1 , data2 , size , 0 , 0 , &cmp1 );
+  ecl_kw_kernel_set_num_threads( 4 );
+  ecl_kw_kernel_cmp_double( data1 , data2 , size , 0 , 0 , &cmp4 );
+  ecl_kw_kernel_set_num_threads( 0 );
+  ecl_kw_kernel_set_parallel_size( 0 );
+
+  test_assert_mem_equal( &cmp1 , &cmp4 , sizeof cmp1 );
+  test_assert_int_equal( cmp1.num_diff , 4 );
+  test_assert_int_equal( cmp1.first_diff , 100 );
+  test_assert_double_equal( cmp1.max_abs_diff , 10 );
+  test_assert_int_equal( cmp1.max_abs_index , 2 * ECL_KW_KERNEL_SUM_BLOCK + 7 );
+  test_assert_int_equal( cmp1.max_rel_index , 2 * ECL_KW_KERNEL_SUM_BLOCK + 7 );
+
+  /* Absolute tolerance: the 1e-3 change is accepted, the NaN is not. */
+  ecl_kw_kernel_cmp_double( data1 , data2 , size , 0.01 , 0 , &cmp1 );
+  test_assert_int_equal( cmp1.num_diff , 3 );
+  test_assert_int_equal( ecl_kw_kernel_first_diff_double( data1 , data2 , size , 0.01 , 0 ) , 100 );
+
+  /* Relative tolerance: 5 / (2*196k) is accepted, 10 / (2*131k) is not. */
+  data2[100] = data1[100];
+  ecl_kw_kernel_cmp_double( data1 , data2 , size , 0 , 3e-5 , &cmp1 );
+  test_assert_int_equal( cmp1.num_diff , 1 );
+  test_assert_int_equal( cmp1.first_diff , 2 * ECL_KW_KERNEL_SUM_BLOCK + 7 );
+
+  free( data1 );
+  free( data2 );
+}
+
+
+void test_first_different( ) {
+  ecl_kw_type * kw1 = ecl_kw_alloc( "PRESSURE" , 1000 , ECL_FLOAT );
+  ecl_kw_type * kw2 = ecl_kw_alloc( "PRESSURE" , 1000 , ECL_FLOAT );
+
+  for (int i = 0; i < 1000; i++) {
+    ecl_kw_iset_float( kw1 , i , 100 + i );
+    ecl_kw_iset_float( kw2 , i , 100 + i );
+  }
+  ecl_kw_iset_float( kw2 , 200 , 300.01 );
+  ecl_kw_iset_float( kw2 , 700 , 900 );
+
+  test_assert_int_equal( ecl_kw_first_different( kw1 , kw2 , 0 , 0 , 0 ) , 200 );
+  test_assert_int_equal( ecl_kw_first_different( kw1 , kw2 , 0 , 0.1 , 0 ) , 700 );
+  test_assert_int_equal( ecl_kw_first_different( kw1 , kw2 , 201 , 0 , 0 ) , 700 );
+  test_assert_int_equal( ecl_kw_first_different( kw1 , kw2 , 701 , 0.1 , 0 ) , 1000 );
+
+  ecl_kw_free( kw1 );
+  ecl_kw_free( kw2 );
+}
+
+
+void write_file( const char * filename , bool second ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int size = 100000;
+  for (int step = 0; step < 3; step++) {
+    ecl_kw_type * seqnum = ecl_kw_alloc( "SEQNUM" , 1 , ECL_INT );
+    ecl_kw_type * pressure = ecl_kw_alloc( "PRESSURE" , size , ECL_FLOAT );
+    ecl_kw_type * names = ecl_kw_alloc( "NAMES" , 3 , ECL_CHAR );
+
+    ecl_kw_iset_int( seqnum , 0 , step );
+    for (int i = 0; i < size; i++)
+      ecl_kw_iset_float( pressure , i , 200 + i * 0.001 + step );
+    ecl_kw_iset_char_ptr( names , 0 , "OP_1" );
+    ecl_kw_iset_char_ptr( names , 1 , "OP_2" );
+    ecl_kw_iset_char_ptr( names , 2 , "INJ" );
+
+    if (second && (step == 1)) {
+      ecl_kw_iset_float( pressure , 500 , 200.5f + 1 + 0.01f );
+      ecl_kw_iset_float( pressure , 900 , 210 );
+      ecl_kw_iset_char_ptr( names , 2 , "WINJ" );
+    }
+
+    ecl_kw_fwrite( seqnum , fortio );
+    ecl_kw_fwrite( pressure , fortio );
+    ecl_kw_fwrite( names , fortio );
+    ecl_kw_free( seqnum );
+    ecl_kw_free( pressure );
+    ecl_kw_free( names );
+  }
+
+  {
+    ecl_kw_type * swat = ecl_kw_alloc( second ? "SGAS" : "SWAT" , 10 , ECL_FLOAT );
+    ecl_kw_type * poro = ecl_kw_alloc( "PORO" , 10 , second ? ECL_DOUBLE : ECL_FLOAT );
+    ecl_kw_scalar_set_float_or_double( swat , 0.5 );
+    ecl_kw_scalar_set_float_or_double( poro , 0.25 );
+    ecl_kw_fwrite( swat , fortio );
+    ecl_kw_fwrite( poro , fortio );
+    ecl_kw_free( swat );
+    ecl_kw_free( poro );
+  }
+  fortio_fclose( fortio );
+}
+
+
+void test_files( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_cmp/files" );
+  write_file( "FILE1.UNRST" , false );
+  write_file( "FILE2.UNRST" , true );
+  {
+    ecl_file_type * file1 = ecl_file_open( "FILE1.UNRST" , 0 );
+    ecl_file_type * file2 = ecl_file_open( "FILE2.UNRST" , 0 );
+    ecl_cmp_type * ecl_cmp = ecl_cmp_alloc( 0 , 0 );
+    const ecl_cmp_result_type * result;
+
+    test_assert_false( ecl_cmp_files( ecl_cmp , file1 , file2 ));
+    test_assert_int_equal( ecl_cmp_get_size( ecl_cmp ) , 12 );
+    test_assert_int_equal( ecl_cmp_get_num_different( ecl_cmp ) , 5 );
+
+    result = ecl_cmp_get_result( ecl_cmp , "PRESSURE" , 1 );
+    test_assert_int_equal( ecl_cmp_result_get_status( result ) , ECL_CMP_DIFFERENT );
+    test_assert_int_equal( ecl_cmp_result_get_num_different( result ) , 2 );
+    test_assert_int_equal( ecl_cmp_result_get_first_different( result ) , 500 );
+    test_assert_int_equal( ecl_cmp_result_get_max_abs_index( result ) , 900 );
+    test_assert_int_equal( ecl_cmp_result_get_status( ecl_cmp_get_result( ecl_cmp , "PRESSURE" , 2 )) , ECL_CMP_EQUAL );
+
+    result = ecl_cmp_get_result( ecl_cmp , "NAMES" , 1 );
+    test_assert_int_equal( ecl_cmp_result_get_status( result ) , ECL_CMP_DIFFERENT );
+    test_assert_int_equal( ecl_cmp_result_get_first_different( result ) , 2 );
+
+    test_assert_int_equal( ecl_cmp_result_get_status( ecl_cmp_get_result( ecl_cmp , "SWAT" , 0 )) , ECL_CMP_MISSING_SECOND );
+    test_assert_int_equal( ecl_cmp_result_get_status( ecl_cmp_get_result( ecl_cmp , "SGAS" , 0 )) , ECL_CMP_MISSING_FIRST );
+    test_assert_int_equal( ecl_cmp_result_get_status( ecl_cmp_get_result( ecl_cmp , "PORO" , 0 )) , ECL_CMP_TYPE_MISMATCH );
+    test_assert_NULL( ecl_cmp_get_result( ecl_cmp , "PRESSURE" , 3 ));
+
+    /* With tolerance for PRESSURE and ignoring the rest only the 210 bar deviation remains. */
+    ecl_cmp_clear( ecl_cmp );
+    ecl_cmp_add_tolerance( ecl_cmp , "PRESSURE" , 0.1 , 0 );
+    ecl_cmp_add_ignore( ecl_cmp , "NAMES" );
+    ecl_cmp_add_ignore( ecl_cmp , "SWAT" );
+    ecl_cmp_add_ignore( ecl_cmp , "SGAS" );
+    ecl_cmp_add_ignore( ecl_cmp , "PORO" );
+    test_assert_false( ecl_cmp_files( ecl_cmp , file1 , file2 ));
+    test_assert_int_equal( ecl_cmp_get_size( ecl_cmp ) , 6 );
+    test_assert_int_equal( ecl_cmp_get_num_different( ecl_cmp ) , 1 );
+    result = ecl_cmp_get_result( ecl_cmp , "PRESSURE" , 1 );
+    test_assert_int_equal( ecl_cmp_result_get_first_different( result ) , 900 );
+
+    ecl_cmp_clear( ecl_cmp );
+    test_assert_true( ecl_cmp_files( ecl_cmp , file1 , file1 ));
+
+    /* Loaded keywords are taken from memory. */
+    ecl_kw_iset_float( ecl_file_iget_named_kw( file1 , "PRESSURE" , 0 ) , 17 , 0 );
+    ecl_cmp_clear( ecl_cmp );
+    test_assert_false( ecl_cmp_files( ecl_cmp , file1 , file2 ));
+    test_assert_int_equal( ecl_cmp_result_get_first_different( ecl_cmp_get_result( ecl_cmp , "PRESSURE" , 0 )) , 17 );
+
+    ecl_cmp_free( ecl_cmp );
+    ecl_file_close( file1 );
+    ecl_file_close( file2 );
+  }
+  test_work_area_free( work_area );
+}
+
+
+void write_summary( const char * name , double step_length , double wopr_offset ) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , false , true , ":" , util_make_date_utc( 1,1,2010 ) , true , 10 , 10 , 10 );
+  smspec_node_type * fopt = ecl_sum_add_var( ecl_sum , "FOPT" , NULL   , 0 , "SM3"   , 0 );
+  smspec_node_type * wopr = ecl_sum_add_var( ecl_sum , "WOPR" , "OP_1" , 0 , "SM3/DAY" , 0 );
+  double sim_seconds = 0;
+  int report_step = 1;
+
+  while (sim_seconds <= 100 * 86400) {
+    double days = sim_seconds / 86400;
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , report_step , sim_seconds );
+    ecl_sum_tstep_set_from_node( tstep , fopt , 1000 * days );
+    ecl_sum_tstep_set_from_node( tstep , wopr , 1000 + ((days > 50) ? wopr_offset : 0) );
+    sim_seconds += step_length;
+    report_step++;
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+void test_sum( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_cmp/sum" );
+  write_summary( "CASE1" , 86400 , 0 );
+  write_summary( "CASE2" , 86400 , 5 );
+  write_summary( "CASE3" , 2 * 86400 , 0 );
+  {
+    ecl_sum_type * sum1 = ecl_sum_fread_alloc_case( "CASE1" , ":" );
+    ecl_sum_type * sum2 = ecl_sum_fread_alloc_case( "CASE2" , ":" );
+    ecl_sum_type * sum3 = ecl_sum_fread_alloc_case( "CASE3" , ":" );
+    ecl_cmp_type * ecl_cmp = ecl_cmp_alloc( 0 , 1e-6 );
+    const ecl_cmp_result_type * result;
+
+    test_assert_false( ecl_cmp_sum( ecl_cmp , sum1 , sum2 ));
+    test_assert_int_equal( ecl_cmp_get_size( ecl_cmp ) , 2 );
+    test_assert_int_equal( ecl_cmp_get_num_different( ecl_cmp ) , 1 );
+    result = ecl_cmp_get_result( ecl_cmp , "WOPR:OP_1" , 0 );
+    test_assert_int_equal( ecl_cmp_result_get_size( result ) , 101 );
+    test_assert_int_equal( ecl_cmp_result_get_num_different( result ) , 50 );
+    test_assert_int_equal( ecl_cmp_result_get_first_different( result ) , 51 );
+    test_assert_double_equal( ecl_cmp_result_get_max_abs_diff( result ) , 5 );
+
+    ecl_cmp_clear( ecl_cmp );
+    ecl_cmp_add_tolerance( ecl_cmp , "WOPR" , 10 , 0 );
+    test_assert_true( ecl_cmp_sum( ecl_cmp , sum1 , sum2 ));
+
+    /* Different time axes: CASE3 is interpolated to the time steps of CASE1. */
+    ecl_cmp_clear( ecl_cmp );
+    test_assert_true( ecl_cmp_sum( ecl_cmp , sum1 , sum3 ));
+    result = ecl_cmp_get_result( ecl_cmp , "FOPT" , 0 );
+    test_assert_int_equal( ecl_cmp_result_get_size( result ) , 101 );
+
+    ecl_cmp_fprintf( ecl_cmp , stdout , false );
+    ecl_cmp_free( ecl_cmp );
+    ecl_sum_free( sum1 );
+    ecl_sum_free( sum2 );
+    ecl_sum_free( sum3 );
+  }
+  test_work_area_free( work_area );
+}
+
+
+int main( int argc , char ** argv) {
+  test_kernel( );
+  test_first_different( );
+  test_files( );
+  test_sum( );
+  exit(0);
+}
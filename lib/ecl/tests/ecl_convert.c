@@ -0,0 +1,164 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_convert.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_convert.h>
+
+
+#define NUM_ROUNDS 25
+
+/*
+  Writes keywords of all types, including empty keywords, for more
+  than ECL_CONVERT_CHUNK_SIZE * ECL_CONVERT_CHUNKS_PER_THREAD * 2 bytes
+  in total, so that the chunk ring of a two thread conversion wraps
+  around. The offset of the end of the first keyword in round
+  NUM_ROUNDS / 2 is returned.
+*/
+
+offset_type write_file( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  offset_type boundary = 0;
+  int round;
+
+  for (round = 0; round < NUM_ROUNDS; round++) {
+    ecl_kw_type * double_kw = ecl_kw_alloc( "DOUBLE" , 25000 , ECL_DOUBLE );
+    ecl_kw_type * float_kw = ecl_kw_alloc( "FLOAT" , 50000 , ECL_FLOAT );
+    ecl_kw_type * int_kw = ecl_kw_alloc( "INT" , 25000 + round , ECL_INT );
+    ecl_kw_type * char_kw = ecl_kw_alloc( "CHAR" , 250 , ECL_CHAR );
+    ecl_kw_type * string_kw = ecl_kw_alloc( "STRING" , 30 , ECL_STRING( 10 ));
+    ecl_kw_type * bool_kw = ecl_kw_alloc( "BOOL" , 1001 , ECL_BOOL );
+    ecl_kw_type * mess_kw = ecl_kw_alloc( "MESS" , 0 , ECL_MESS );
+    ecl_kw_type * empty_kw = ecl_kw_alloc( "EMPTY" , 0 , ECL_INT );
+    int i;
+
+    for (i = 0; i < ecl_kw_get_size( double_kw ); i++)
+      ecl_kw_iset_double( double_kw , i , (i - 12500) * 0.731 + round );
+
+    for (i = 0; i < ecl_kw_get_size( float_kw ); i++)
+      ecl_kw_iset_float( float_kw , i , (i % 977) * 1.25e-3 - round );
+
+    for (i = 0; i < ecl_kw_get_size( int_kw ); i++)
+      ecl_kw_iset_int( int_kw , i , i * (round - 12));
+
+    for (i = 0; i < ecl_kw_get_size( char_kw ); i++) {
+      char s8[16];
+      sprintf( s8 , "S%d" , (i * 31 + round) % 1000 );
+      ecl_kw_iset_string8( char_kw , i , s8 );
+    }
+
+    for (i = 0; i < ecl_kw_get_size( string_kw ); i++) {
+      char s10[16];
+      sprintf( s10 , "LONG %d" , i + round );
+      ecl_kw_iset_string_ptr( string_kw , i , s10 );
+    }
+
+    for (i = 0; i < ecl_kw_get_size( bool_kw ); i++)
+      ecl_kw_iset_bool( bool_kw , i , (i % 3) == (round % 3));
+
+    ecl_kw_fwrite( double_kw , fortio );
+    if (round == NUM_ROUNDS / 2)
+      boundary = fortio_ftell( fortio );
+    ecl_kw_fwrite( float_kw , fortio );
+    ecl_kw_fwrite( mess_kw , fortio );
+    ecl_kw_fwrite( int_kw , fortio );
+    ecl_kw_fwrite( char_kw , fortio );
+    ecl_kw_fwrite( empty_kw , fortio );
+    ecl_kw_fwrite( string_kw , fortio );
+    ecl_kw_fwrite( bool_kw , fortio );
+
+    ecl_kw_free( double_kw );
+    ecl_kw_free( float_kw );
+    ecl_kw_free( int_kw );
+    ecl_kw_free( char_kw );
+    ecl_kw_free( string_kw );
+    ecl_kw_free( bool_kw );
+    ecl_kw_free( mess_kw );
+    ecl_kw_free( empty_kw );
+  }
+
+  fortio_fclose( fortio );
+  return boundary;
+}
+
+
+void write_prefix( const char * src_file , const char * target_file , offset_type size ) {
+  FILE * src = util_fopen( src_file , "rb" );
+  FILE * target = util_fopen( target_file , "wb" );
+  char * buffer = util_malloc( size );
+
+  util_fread( buffer , 1 , size , src , __func__ );
+  util_fwrite( buffer , 1 , size , target , __func__ );
+
+  free( buffer );
+  fclose( target );
+  fclose( src );
+}
+
+
+void test_convert( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_convert" );
+  write_file( "DATA" );
+
+  test_assert_true( ecl_convert_file( "DATA" , false , "FDATA_SERIAL" , 1 ));
+  test_assert_true( ecl_convert_file( "DATA" , false , "FDATA_PIPELINE" , 2 ));
+  test_assert_true( ecl_convert_file( "DATA" , false , "FDATA_PIPELINE8" , 8 ));
+  test_assert_true( util_files_equal( "FDATA_SERIAL" , "FDATA_PIPELINE" ));
+  test_assert_true( util_files_equal( "FDATA_SERIAL" , "FDATA_PIPELINE8" ));
+
+  test_assert_true( ecl_convert_file( "FDATA_PIPELINE" , true , "DATA_SERIAL" , 1 ));
+  test_assert_true( ecl_convert_file( "FDATA_PIPELINE" , true , "DATA_PIPELINE" , 2 ));
+  test_assert_true( util_files_equal( "DATA_SERIAL" , "DATA_PIPELINE" ));
+  test_assert_int_equal( util_file_size( "DATA" ) , util_file_size( "DATA_PIPELINE" ));
+
+  test_work_area_free( work_area );
+}
+
+
+void test_truncated( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_convert_truncated" );
+  offset_type boundary = write_file( "DATA" );
+
+  write_prefix( "DATA" , "PREFIX" , boundary );
+  write_prefix( "DATA" , "TRUNCATED" , boundary + 1000 );
+
+  test_assert_true( ecl_convert_file( "PREFIX" , false , "FPREFIX" , 2 ));
+  test_assert_false( ecl_convert_file( "TRUNCATED" , false , "FTRUNCATED" , 2 ));
+  test_assert_true( util_files_equal( "FPREFIX" , "FTRUNCATED" ));
+
+  write_prefix( "FPREFIX" , "FPREFIX_TRUNCATED" , util_file_size( "FPREFIX" ) - 100 );
+  test_assert_false( ecl_convert_file( "FPREFIX_TRUNCATED" , true , "PREFIX_TRUNCATED" , 2 ));
+  test_assert_true( util_file_size( "PREFIX_TRUNCATED" ) < boundary );
+
+  test_work_area_free( work_area );
+}
+
+
+int main( int argc , char ** argv) {
+  test_convert( );
+  test_truncated( );
+  exit(0);
+}
@@ -0,0 +1,193 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_dir.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#include <utime.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_dir.h>
+
+
+void touch( const char * filename , time_t mtime ) {
+  FILE * stream = util_fopen( filename , "w" );
+  fclose( stream );
+  if (mtime > 0) {
+    struct utimbuf times = { .actime = mtime , .modtime = mtime };
+    utime( filename , &times );
+  }
+}
+
+
+/* Backdate the directory so the scan is trusted. */
+void settle( const char * path ) {
+  time_t mtime = time( NULL ) - 10;
+  struct utimbuf times = { .actime = mtime , .modtime = mtime };
+  utime( path , &times );
+}
+
+
+void test_catalogue( ) {
+  time_t now = time( NULL );
+  ecl_dir_type * ecl_dir;
+  const ecl_dir_case_type * dir_case;
+
+  touch( "CASE.EGRID" , 0 );
+  touch( "CASE.INIT" , 0 );
+  touch( "CASE.UNRST" , now - 100 );
+  touch( "CASE.X0003" , now - 200 );
+  touch( "CASE.X0001" , now - 200 );
+  touch( "CASE.X0002" , now - 200 );
+  touch( "CASE.x0004" , 0 );
+  touch( "CASE.X00005" , 0 );
+  touch( "CASE.SMSPEC" , 0 );
+  touch( "CASE.S0002" , 0 );
+  touch( "CASE.S0001" , 0 );
+  touch( "OTHER.FEGRID" , 0 );
+  touch( "OTHER.DATA" , 0 );
+  touch( "notes.txt" , 0 );
+
+  ecl_dir = ecl_dir_alloc( NULL );
+  test_assert_int_equal( ecl_dir_get_num_cases( ecl_dir ) , 2 );
+  test_assert_NULL( ecl_dir_get_case( ecl_dir , "notes" ));
+
+  dir_case = ecl_dir_get_case( ecl_dir , "CASE" );
+  test_assert_string_equal( ecl_dir_case_get_base( dir_case ) , "CASE" );
+  test_assert_string_equal( ecl_dir_case_get_file( dir_case , ECL_EGRID_FILE , false ) , "CASE.EGRID" );
+  test_assert_string_equal( ecl_dir_case_get_file( dir_case , ECL_UNIFIED_RESTART_FILE , false ) , "CASE.UNRST" );
+  test_assert_NULL( ecl_dir_case_get_file( dir_case , ECL_UNIFIED_RESTART_FILE , true ));
+  test_assert_int_equal( ecl_dir_case_get_num_files( dir_case , ECL_RESTART_FILE , false ) , 3 );
+  test_assert_int_equal( ecl_dir_case_get_num_files( dir_case , ECL_RESTART_FILE , true ) , 0 );
+  for (int i = 0; i < 3; i++)
+    test_assert_int_equal( ecl_dir_case_iget_report_step( dir_case , ECL_RESTART_FILE , false , i ) , i + 1 );
+
+  test_assert_true( ecl_dir_has_file( ecl_dir , "CASE.X0002" ));
+  test_assert_false( ecl_dir_has_file( ecl_dir , "CASE.x0004" ));
+  test_assert_false( ecl_dir_has_file( ecl_dir , "CASE.X00005" ));
+
+  dir_case = ecl_dir_get_case( ecl_dir , "OTHER" );
+  test_assert_string_equal( ecl_dir_case_get_file( dir_case , ECL_EGRID_FILE , true ) , "OTHER.FEGRID" );
+  test_assert_string_equal( ecl_dir_case_get_file( dir_case , ECL_DATA_FILE , false ) , "OTHER.DATA" );
+
+  /* The catalogue must agree with the glob patterns. */
+  {
+    stringlist_type * glob_files = stringlist_alloc_new( );
+    stringlist_type * dir_files = stringlist_alloc_new( );
+
+    stringlist_select_matching_files( glob_files , NULL , "CASE.X[0-9][0-9][0-9][0-9]" );
+    stringlist_sort( glob_files , ecl_util_fname_report_cmp );
+    ecl_dir_select_files( ecl_dir , "CASE" , ECL_RESTART_FILE , false , dir_files );
+    test_assert_true( stringlist_equal( glob_files , dir_files ));
+
+    test_assert_int_equal( ecl_util_select_filelist( NULL , "CASE" , ECL_SUMMARY_FILE , false , dir_files ) , 2 );
+    test_assert_string_equal( stringlist_iget( dir_files , 0 ) , "CASE.S0001" );
+
+    stringlist_free( glob_files );
+    stringlist_free( dir_files );
+  }
+  ecl_dir_free( ecl_dir );
+
+  {
+    char ** restart_files;
+    int num_files;
+    bool fmt_file , unified;
+
+    ecl_util_alloc_restart_files( NULL , "CASE" , &restart_files , &num_files , &fmt_file , &unified );
+    test_assert_int_equal( num_files , 1 );
+    test_assert_true( unified );
+    test_assert_false( fmt_file );
+    test_assert_string_equal( restart_files[0] , "CASE.UNRST" );
+    util_free_stringlist( restart_files , num_files );
+
+    ecl_util_alloc_restart_files( NULL , "MISSING" , &restart_files , &num_files , &fmt_file , &unified );
+    test_assert_int_equal( num_files , 0 );
+  }
+}
+
+
+void test_shared( ) {
+  ecl_dir_type * dir1;
+  ecl_dir_type * dir2;
+
+  util_make_path( "sub" );
+  touch( "sub/DEEP.SMSPEC" , 0 );
+  touch( "sub/DEEP.UNSMRY" , 0 );
+  touch( "sub/DEEP.EGRID" , 0 );
+  settle( "sub" );
+
+  test_assert_NULL( ecl_dir_alloc_shared_current( "sub" ));
+  dir1 = ecl_dir_alloc_shared( "sub" );
+  test_assert_true( ecl_dir_is_current( dir1 ));
+  test_assert_string_equal( ecl_dir_case_get_file( ecl_dir_get_case( dir1 , "DEEP" ) , ECL_UNIFIED_SUMMARY_FILE , false ) , "sub/DEEP.UNSMRY" );
+
+  dir2 = ecl_dir_alloc_shared_current( "sub" );
+  test_assert_ptr_equal( dir1 , dir2 );
+  ecl_dir_free( dir2 );
+
+  {
+    char * header_file;
+    stringlist_type * data_files = stringlist_alloc_new( );
+
+    test_assert_true( ecl_util_alloc_summary_files( NULL , "sub/DEEP" , NULL , &header_file , data_files ));
+    test_assert_string_equal( header_file , "sub/DEEP.SMSPEC" );
+    test_assert_int_equal( stringlist_get_size( data_files ) , 1 );
+    test_assert_string_equal( stringlist_iget( data_files , 0 ) , "sub/DEEP.UNSMRY" );
+    free( header_file );
+    stringlist_free( data_files );
+
+    test_assert_true( ecl_sum_case_exists( "sub/DEEP" ));
+    test_assert_false( ecl_sum_case_exists( "sub/MISSING" ));
+  }
+
+  {
+    char * grid_file = ecl_grid_alloc_case_filename( "sub/DEEP" );
+    test_assert_string_equal( grid_file , "sub/DEEP.EGRID" );
+    free( grid_file );
+  }
+
+  /* A new file changes the mtime of the directory, and the catalogue is scanned again. */
+  touch( "sub/DEEP.INIT" , 0 );
+  test_assert_false( ecl_dir_is_current( dir1 ));
+  test_assert_NULL( ecl_dir_alloc_shared_current( "sub" ));
+  dir2 = ecl_dir_alloc_shared( "sub" );
+  test_assert_ptr_not_equal( dir1 , dir2 );
+  test_assert_not_NULL( ecl_dir_case_get_file( ecl_dir_get_case( dir2 , "DEEP" ) , ECL_INIT_FILE , false ));
+  test_assert_NULL( ecl_dir_case_get_file( ecl_dir_get_case( dir1 , "DEEP" ) , ECL_INIT_FILE , false ));
+
+  ecl_dir_free( dir1 );
+  ecl_dir_free( dir2 );
+  ecl_dir_shared_clear( );
+  test_assert_NULL( ecl_dir_alloc( "does/not/exist" ));
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_dir" );
+  test_catalogue( );
+  test_shared( );
+  test_work_area_free( work_area );
+  exit(0);
+}
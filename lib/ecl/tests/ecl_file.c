@@ -84,9 +84,85 @@ void test_truncated() {
 }
 
 
+static void test_assert_kw_file( const char * filename , ecl_kw_type ** kw_list , int num_kw) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+  test_assert_int_equal( num_kw , ecl_file_get_size( ecl_file ));
+  for (int i = 0; i < num_kw; i++) {
+    const ecl_kw_type * kw = ecl_file_iget_kw( ecl_file , i );
+    /* Formatted doubles do not survive a round trip bit for bit. */
+    test_assert_string_equal( ecl_kw_get_header( kw_list[i] ) , ecl_kw_get_header( kw ));
+    test_assert_true( ecl_kw_numeric_equal( kw_list[i] , kw , 0 , 1e-12 ));
+  }
+  ecl_file_close( ecl_file );
+}
+
+
+void test_fwrite_raw(bool fmt_file) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_fwrite_raw");
+  ecl_kw_type * kw_list[3];
+
+  kw_list[0] = ecl_kw_alloc("INTKW", 1337, ECL_INT);
+  kw_list[1] = ecl_kw_alloc("DOUBLEKW", 500, ECL_DOUBLE);
+  kw_list[2] = ecl_kw_alloc("CHARKW", 10, ECL_CHAR);
+  for (int i = 0; i < 1337; i++)
+    ecl_kw_iset_int( kw_list[0] , i , i*7 );
+  for (int i = 0; i < 500; i++)
+    ecl_kw_iset_double( kw_list[1] , i , i*0.25 );
+  for (int i = 0; i < 10; i++)
+    ecl_kw_iset_char_ptr( kw_list[2] , i , "ABC" );
+
+  {
+    fortio_type * fortio = fortio_open_writer( "SRC" , fmt_file , ECL_ENDIAN_FLIP );
+    for (int i = 0; i < 3; i++)
+      ecl_kw_fwrite( kw_list[i] , fortio );
+    fortio_fclose( fortio );
+  }
+
+  /* Raw copy of the first and last keyword. */
+  {
+    fortio_type * src = fortio_open_reader( "SRC" , fmt_file , ECL_ENDIAN_FLIP );
+    fortio_type * target = fortio_open_writer( "RAW" , fmt_file , ECL_ENDIAN_FLIP );
+    ecl_kw_type * expected[2] = { kw_list[0] , kw_list[2] };
+
+    test_assert_true( ecl_kw_fcopy_raw( src , target ));
+    ecl_kw_fskip( src );
+    test_assert_true( ecl_kw_fcopy_raw( src , target ));
+    test_assert_false( ecl_kw_fcopy_raw( src , target ));
+    fortio_fclose( src );
+    fortio_fclose( target );
+    test_assert_kw_file( "RAW" , expected , 2 );
+  }
+
+  /*
+     Unloaded keywords are copied raw, the modified keyword must be
+     written from memory.
+  */
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "SRC" , 0 );
+    ecl_kw_type * kw = ecl_file_iget_kw( ecl_file , 1 );
+    ecl_kw_iset_double( kw , 0 , -1 );
+    ecl_kw_iset_double( kw_list[1] , 0 , -1 );
+
+    ecl_file_fwrite( ecl_file , "COPY" , fmt_file );
+    ecl_file_fwrite( ecl_file , "OTHER_FORMAT" , !fmt_file );
+    ecl_file_close( ecl_file );
+
+    test_assert_true( util_file_size( "COPY" ) == util_file_size( "SRC" ));
+    test_assert_kw_file( "COPY" , kw_list , 3 );
+    test_assert_kw_file( "OTHER_FORMAT" , kw_list , 3 );
+  }
+
+  for (int i = 0; i < 3; i++)
+    ecl_kw_free( kw_list[i] );
+  test_work_area_free( work_area );
+}
+
+
 int main( int argc , char ** argv) {
   test_writable(10);
   test_writable(1337);
   test_truncated();
+  test_fwrite_raw(false);
+  test_fwrite_raw(true);
   exit(0);
 }
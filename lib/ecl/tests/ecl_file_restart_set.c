@@ -0,0 +1,217 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_file_restart_set.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/fortio_cache.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_rsthead.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_cmp.h>
+
+
+void write_restart_file( const char * filename , int report_step , bool fmt_file ) {
+  fortio_type * fortio = fortio_open_writer( filename , fmt_file , ECL_ENDIAN_FLIP );
+  ecl_kw_type * intehead = ecl_kw_alloc( INTEHEAD_KW , 100 , ECL_INT );
+  ecl_kw_type * doubhead = ecl_kw_alloc( DOUBHEAD_KW , 10 , ECL_DOUBLE );
+  ecl_kw_type * pressure = ecl_kw_alloc( "PRESSURE" , 100 , ECL_FLOAT );
+  int i;
+
+  ecl_kw_scalar_set_int( intehead , 0 );
+  ecl_kw_iset_int( intehead , INTEHEAD_DAY_INDEX , 1 );
+  ecl_kw_iset_int( intehead , INTEHEAD_MONTH_INDEX , 1 + report_step % 12 );
+  ecl_kw_iset_int( intehead , INTEHEAD_YEAR_INDEX , 2000 + report_step / 12 );
+  ecl_kw_scalar_set_double( doubhead , 0 );
+  ecl_kw_iset_double( doubhead , DOUBHEAD_DAYS_INDEX , 30.0 * report_step );
+  for (i = 0; i < 100; i++)
+    ecl_kw_iset_float( pressure , i , report_step + i );
+
+  ecl_kw_fwrite( intehead , fortio );
+  ecl_kw_fwrite( doubhead , fortio );
+  ecl_kw_fwrite( pressure , fortio );
+
+  ecl_kw_free( intehead );
+  ecl_kw_free( doubhead );
+  ecl_kw_free( pressure );
+  fortio_fclose( fortio );
+}
+
+
+time_t report_date( int report_step ) {
+  return ecl_util_make_date( 1 , 1 + report_step % 12 , 2000 + report_step / 12 );
+}
+
+
+stringlist_type * alloc_restart_set( ) {
+  stringlist_type * files = stringlist_alloc_new( );
+  stringlist_append_copy( files , "SET.X0010" );
+  stringlist_append_copy( files , "SET.X0000" );
+  stringlist_append_copy( files , "SET.X0005" );
+  stringlist_append_copy( files , "SET.X0002" );
+  for (int i = 0; i < stringlist_get_size( files ); i++) {
+    int report_step;
+    ecl_util_get_file_type( stringlist_iget( files , i ) , NULL , &report_step );
+    write_restart_file( stringlist_iget( files , i ) , report_step , false );
+  }
+  return files;
+}
+
+
+void test_cache( ) {
+  fortio_cache_type * cache = fortio_cache_alloc( 2 );
+  int id[3];
+  int i;
+
+  write_restart_file( "CACHE.X0001" , 1 , false );
+  for (i = 0; i < 3; i++)
+    id[i] = fortio_cache_add( cache , fortio_open_reader( "CACHE.X0001" , false , ECL_ENDIAN_FLIP ));
+
+  test_assert_int_equal( fortio_cache_get_size( cache ) , 3 );
+  test_assert_int_equal( fortio_cache_get_num_open( cache ) , 0 );
+  for (i = 0; i < 3; i++) {
+    fortio_type * fortio = fortio_cache_acquire( cache , id[i] );
+    test_assert_not_NULL( fortio );
+    test_assert_true( fortio_stream_is_open( fortio ));
+    fortio_cache_release( cache , id[i] );
+  }
+  test_assert_int_equal( fortio_cache_get_num_open( cache ) , 2 );
+
+  /* The least recently used stream, i.e. id[0], has been closed. */
+  fortio_cache_remove( cache , id[0] );
+  test_assert_int_equal( fortio_cache_get_num_open( cache ) , 2 );
+  fortio_cache_remove( cache , id[1] );
+  test_assert_int_equal( fortio_cache_get_num_open( cache ) , 1 );
+  test_assert_int_equal( fortio_cache_add( cache , fortio_open_reader( "CACHE.X0001" , false , ECL_ENDIAN_FLIP )) , id[1] );
+
+  fortio_cache_set_max_open( cache , 1 );
+  test_assert_int_equal( fortio_cache_get_max_open( cache ) , 1 );
+  fortio_cache_free( cache );
+}
+
+
+void test_restart_set( ) {
+  stringlist_type * files = alloc_restart_set( );
+  fortio_cache_type * shared = fortio_cache_get_shared( );
+  int shared_size = fortio_cache_get_size( shared );
+  ecl_file_type * rst_file = ecl_file_open_restart_set( files , 0 );
+
+  test_assert_not_NULL( rst_file );
+  test_assert_int_equal( fortio_cache_get_size( shared ) , shared_size + 4 );
+  test_assert_int_equal( ecl_file_get_size( rst_file ) , 16 );
+  test_assert_int_equal( ecl_file_get_num_named_kw( rst_file , SEQNUM_KW ) , 4 );
+  test_assert_int_equal( ecl_file_get_num_named_kw( rst_file , "PRESSURE" ) , 4 );
+  test_assert_string_equal( ecl_file_get_src_file( rst_file ) , "SET.X0000" );
+  test_assert_false( ecl_file_writable( rst_file ));
+
+  test_assert_true( ecl_file_has_report_step( rst_file , 5 ));
+  test_assert_false( ecl_file_has_report_step( rst_file , 3 ));
+  test_assert_int_equal( ecl_kw_iget_int( ecl_file_iget_named_kw( rst_file , SEQNUM_KW , 1 ) , 0 ) , 2 );
+  test_assert_int_equal( ecl_file_get_restart_index( rst_file , report_date( 5 )) , 2 );
+  test_assert_double_equal( ecl_file_iget_restart_sim_days( rst_file , 3 ) , 300 );
+
+  {
+    ecl_file_view_type * view = ecl_file_get_restart_view( rst_file , -1 , 10 , -1 , -1 );
+    test_assert_not_NULL( view );
+    test_assert_string_equal( ecl_file_view_get_src_file( view ) , "SET.X0010" );
+    test_assert_int_equal( ecl_file_view_get_size( view ) , 4 );
+    test_assert_float_equal( ecl_kw_iget_float( ecl_file_view_iget_named_kw( view , "PRESSURE" , 0 ) , 1 ) , 11 );
+
+    view = ecl_file_get_restart_view( rst_file , -1 , -1 , report_date( 2 ) , -1 );
+    test_assert_not_NULL( view );
+    test_assert_string_equal( ecl_file_view_get_src_file( view ) , "SET.X0002" );
+  }
+
+  /* The keywords loaded in a transaction are dropped again, the SEQNUM keywords stay. */
+  {
+    ecl_file_view_type * global_view = ecl_file_get_global_view( rst_file );
+    ecl_file_transaction_type * t = ecl_file_view_start_transaction( global_view );
+    ecl_file_view_iget_named_kw( global_view , "PRESSURE" , 2 );
+    ecl_file_view_end_transaction( global_view , t );
+    free( t );
+    test_assert_false( ecl_file_kw_is_loaded( ecl_file_view_iget_named_file_kw( global_view , "PRESSURE" , 2 )));
+    test_assert_true( ecl_file_kw_is_loaded( ecl_file_view_iget_named_file_kw( global_view , SEQNUM_KW , 2 )));
+  }
+
+  /* With a limit on the open files. */
+  fortio_cache_set_max_open( shared , 2 );
+  test_assert_true( ecl_file_load_all( rst_file ));
+  test_assert_true( fortio_cache_get_num_open( shared ) <= 2 );
+  fortio_cache_set_max_open( shared , FORTIO_CACHE_DEFAULT_MAX_OPEN );
+
+  /* Written out the set is an ordinary unified restart file. */
+  ecl_file_fwrite( rst_file , "COPY.UNRST" , false );
+  {
+    ecl_file_type * unrst_file = ecl_file_open( "COPY.UNRST" , 0 );
+    ecl_file_type * set_file = ecl_file_open_restart_case( NULL , "SET" , 0 );
+    ecl_cmp_type * ecl_cmp = ecl_cmp_alloc( 0 , 0 );
+
+    test_assert_not_NULL( set_file );
+    test_assert_int_equal( ecl_file_get_num_named_kw( unrst_file , SEQNUM_KW ) , 4 );
+    test_assert_true( ecl_cmp_files( ecl_cmp , unrst_file , set_file ));
+    test_assert_int_equal( ecl_cmp_get_size( ecl_cmp ) , 16 );
+
+    ecl_cmp_free( ecl_cmp );
+    ecl_file_close( set_file );
+    ecl_file_close( unrst_file );
+  }
+
+  ecl_file_close( rst_file );
+  test_assert_int_equal( fortio_cache_get_size( shared ) , shared_size );
+  stringlist_free( files );
+}
+
+
+void test_invalid( ) {
+  stringlist_type * files = stringlist_alloc_new( );
+
+  test_assert_NULL( ecl_file_open_restart_set( files , 0 ));
+
+  stringlist_append_copy( files , "SET.X0005" );
+  stringlist_append_copy( files , "SET.X0007" );
+  test_assert_NULL( ecl_file_open_restart_set( files , 0 ));
+
+  write_restart_file( "SET.F0007" , 7 , true );
+  stringlist_iset_copy( files , 1 , "SET.F0005" );
+  write_restart_file( "SET.F0005" , 5 , true );
+  test_assert_NULL( ecl_file_open_restart_set( files , 0 ));
+
+  stringlist_iset_copy( files , 1 , "COPY.UNRST" );
+  test_assert_NULL( ecl_file_open_restart_set( files , 0 ));
+
+  test_assert_NULL( ecl_file_open_restart_case( NULL , "MISSING" , 0 ));
+  stringlist_free( files );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_file_restart_set" );
+  test_cache( );
+  test_restart_set( );
+  test_invalid( );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -22,6 +22,7 @@
 #include <ert/util/test_util.h>
 #include <ert/util/util.h>
 #include <ert/util/test_work_area.h>
+#include <ert/util/str_intern.h>
 
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_file.h>
@@ -110,8 +111,49 @@ void test_create_file_kw() {
 }
 
 
+void test_blockview_interned() {
+  const char * headers[] = {"SEQNUM", "PRESSURE", "SWAT", "SEQNUM", "PRESSURE", "SEQNUM", "SWAT"};
+  str_intern_type * strings = str_intern_alloc();
+  int flags = 0;
+  ecl_file_view_type * view = ecl_file_view_alloc( NULL , &flags , NULL , true );
+  ecl_file_view_set_strings( view , strings );
+
+  for (int i=0; i < 7; i++) {
+    ecl_kw_type * ecl_kw = ecl_kw_alloc( headers[i] , 10 , ECL_INT );
+    ecl_file_view_add_kw( view , ecl_file_kw_alloc_arena( NULL , strings , ecl_kw , i ));
+    ecl_kw_free( ecl_kw );
+  }
+  ecl_file_view_make_index( view );
+  test_assert_int_equal( 3 , str_intern_get_size( strings ));
+  test_assert_ptr_equal( ecl_file_view_iget_header( view , 0 ) , ecl_file_view_iget_header( view , 3 ));
+  test_assert_ptr_equal( ecl_file_view_iget_distinct_kw( view , 0 ) , ecl_file_view_iget_header( view , 5 ));
+  {
+    ecl_file_view_type * block = ecl_file_view_alloc_blockview( view , "SEQNUM" , 1 );
+    test_assert_int_equal( 2 , ecl_file_view_get_size( block ));
+    ecl_file_view_free( block );
+
+    block = ecl_file_view_alloc_blockview2( view , "PRESSURE" , "NO_SUCH_KW" , 0 );
+    test_assert_int_equal( 6 , ecl_file_view_get_size( block ));
+    ecl_file_view_free( block );
+  }
+
+  /* A keyword which is not interned turns off the pointer comparison. */
+  ecl_file_view_add_kw( view , ecl_file_kw_alloc0( "SEQNUM" , ECL_INT , 10 , 100 ));
+  ecl_file_view_make_index( view );
+  {
+    ecl_file_view_type * block = ecl_file_view_alloc_blockview( view , "SEQNUM" , 2 );
+    test_assert_int_equal( 2 , ecl_file_view_get_size( block ));
+    ecl_file_view_free( block );
+  }
+
+  ecl_file_view_free( view );
+  str_intern_free( strings );
+}
+
+
 int main( int argc , char ** argv) {
   util_install_signals();
   test_file_kw_equal( );
   test_create_file_kw( );
+  test_blockview_interned( );
 }
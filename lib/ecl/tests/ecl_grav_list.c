@@ -0,0 +1,259 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grav_list.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+#include <ert/util/thread_pool.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_grav.h>
+#include <ert/ecl/ecl_subsidence.h>
+
+
+/*
+  The _list() functions of ecl_grav and ecl_subsidence with theta == 0
+  should give the same results as the corresponding single station
+  functions. The model is a 20 x 20 x 5 grid with water and gas,
+  where every thirteenth cell is inactive and every seventh active
+  cell is a numerical aquifer cell; the surveys are written to a test
+  work area.
+*/
+
+#define NX 20
+#define NY 20
+#define NZ 5
+#define NUM_STATIONS 16
+#define NUM_THREADS 4
+
+#define PHASE_MASK (ECL_WATER_PHASE + ECL_GAS_PHASE)
+#define COMPRESSIBILITY 1e-4
+#define POISSON_RATIO 0.25
+#define YOUNGS_MODULUS 1e9
+#define SEABED -500
+
+
+static ecl_grid_type * alloc_grid() {
+  const double ivec[3] = {100 ,   0 ,  0};
+  const double jvec[3] = {  0 , 100 ,  0};
+  const double kvec[3] = {  0 ,   0 , 10};
+  int * actnum = util_malloc( NX * NY * NZ * sizeof * actnum );
+  ecl_grid_type * grid;
+
+  for (int g=0; g < NX*NY*NZ; g++)
+    actnum[g] = (g % 13) == 5 ? 0 : 1;
+
+  grid = ecl_grid_alloc_regular( NX , NY , NZ , ivec , jvec , kvec , actnum );
+  free( actnum );
+  return grid;
+}
+
+
+static void write_kw( fortio_type * fortio , const char * name , int size , ecl_data_type data_type , double value0 , double step) {
+  ecl_kw_type * kw = ecl_kw_alloc( name , size , data_type );
+  for (int i=0; i < size; i++) {
+    double value = value0 + step * (i % 17);
+    if (ecl_type_is_int( data_type ))
+      ecl_kw_iset_int( kw , i , (int) value );
+    else
+      ecl_kw_iset_float( kw , i , value );
+  }
+  ecl_kw_fwrite( kw , fortio );
+  ecl_kw_free( kw );
+}
+
+
+static void write_init( const ecl_grid_type * grid ) {
+  const int active_size = ecl_grid_get_active_size( grid );
+  fortio_type * fortio = fortio_open_writer( "GRAV.INIT" , false , true );
+  {
+    ecl_kw_type * intehead = ecl_kw_alloc( INTEHEAD_KW , 100 , ECL_INT );
+    for (int i=0; i < 100; i++)
+      ecl_kw_iset_int( intehead , i , 0 );
+    ecl_kw_iset_int( intehead , INTEHEAD_PHASE_INDEX , PHASE_MASK );
+    ecl_kw_fwrite( intehead , fortio );
+    ecl_kw_free( intehead );
+  }
+  write_kw( fortio , PORV_KW , ecl_grid_get_global_size( grid ) , ECL_FLOAT , 1000 , 10 );
+  write_kw( fortio , PVTNUM_KW , active_size , ECL_INT , 1 , 0 );
+  {
+    ecl_kw_type * aquifer = ecl_kw_alloc( AQUIFER_KW , active_size , ECL_INT );
+    for (int i=0; i < active_size; i++)
+      ecl_kw_iset_int( aquifer , i , (i % 7) == 3 ? -1 : 0 );
+    ecl_kw_fwrite( aquifer , fortio );
+    ecl_kw_free( aquifer );
+  }
+  fortio_fclose( fortio );
+}
+
+
+static void write_restart( const ecl_grid_type * grid , const char * filename , double scale) {
+  const int active_size = ecl_grid_get_active_size( grid );
+  fortio_type * fortio = fortio_open_writer( filename , false , true );
+  write_kw( fortio , FIPWAT_KW , active_size , ECL_FLOAT , 500 * scale , 3 * scale );
+  write_kw( fortio , FIPGAS_KW , active_size , ECL_FLOAT , 100 * scale , 7 * scale );
+  write_kw( fortio , PRESSURE_KW , active_size , ECL_FLOAT , 200 * scale , 1 * scale );
+  fortio_fclose( fortio );
+}
+
+
+static void alloc_stations( double ** utm_x , double ** utm_y , double ** depth ) {
+  *utm_x = util_malloc( NUM_STATIONS * sizeof ** utm_x );
+  *utm_y = util_malloc( NUM_STATIONS * sizeof ** utm_y );
+  *depth = util_malloc( NUM_STATIONS * sizeof ** depth );
+
+  for (int s = 0; s < NUM_STATIONS; s++) {
+    (*utm_x)[s] = -500 + 800 * (s % 4);
+    (*utm_y)[s] = -300 + 700 * (s / 4);
+    (*depth)[s] = SEABED;
+  }
+}
+
+
+static void assert_close( double expected , double value ) {
+  test_assert_true( fabs( value - expected ) <= 1e-10 * fabs( expected ));
+}
+
+
+typedef struct {
+  const ecl_grav_type       * grav;
+  const ecl_subsidence_type * subsidence;
+  ecl_region_type           * region;
+  const double              * utm_x;
+  const double              * utm_y;
+  const double              * depth;
+  double                      grav_result[NUM_STATIONS];
+  double                      subsidence_result[NUM_STATIONS];
+  double                      geertsma_result[NUM_STATIONS];
+} eval_job_type;
+
+
+static void * eval_job_main( void * arg ) {
+  eval_job_type * job = arg;
+  ecl_grav_eval_list( job->grav , "BASE" , "MONITOR" , job->region , NUM_STATIONS , job->utm_x , job->utm_y , job->depth , PHASE_MASK , 0 , job->grav_result );
+  ecl_subsidence_eval_list( job->subsidence , "BASE" , "MONITOR" , job->region , NUM_STATIONS , job->utm_x , job->utm_y , job->depth ,
+                            COMPRESSIBILITY , POISSON_RATIO , 0 , job->subsidence_result );
+  ecl_subsidence_eval_geertsma_list( job->subsidence , "BASE" , "MONITOR" , job->region , NUM_STATIONS , job->utm_x , job->utm_y , job->depth ,
+                                     YOUNGS_MODULUS , POISSON_RATIO , SEABED , 0 , job->geertsma_result );
+  return NULL;
+}
+
+
+/*
+  The objects are fresh, so the trees are built by the concurrent
+  calls.
+*/
+
+static void test_eval_list( const ecl_grid_type * grid , ecl_region_type * region , bool concurrent ) {
+  ecl_file_type * init_file = ecl_file_open( "GRAV.INIT" , 0 );
+  ecl_file_type * base_file = ecl_file_open( "GRAV.X0001" , 0 );
+  ecl_file_type * monitor_file = ecl_file_open( "GRAV.X0002" , 0 );
+  ecl_grav_type * grav = ecl_grav_alloc( grid , init_file );
+  ecl_subsidence_type * subsidence = ecl_subsidence_alloc( grid , init_file );
+  double * utm_x , * utm_y , * depth;
+  int num_jobs = concurrent ? NUM_THREADS : 1;
+  eval_job_type * jobs = util_malloc( num_jobs * sizeof * jobs );
+
+  ecl_grav_new_std_density( grav , ECL_WATER_PHASE , 1000 );
+  ecl_grav_new_std_density( grav , ECL_GAS_PHASE , 100 );
+  ecl_grav_add_survey_FIP( grav , "BASE" , ecl_file_get_global_view( base_file ));
+  ecl_grav_add_survey_FIP( grav , "MONITOR" , ecl_file_get_global_view( monitor_file ));
+  ecl_subsidence_add_survey_PRESSURE( subsidence , "BASE" , ecl_file_get_global_view( base_file ));
+  ecl_subsidence_add_survey_PRESSURE( subsidence , "MONITOR" , ecl_file_get_global_view( monitor_file ));
+
+  alloc_stations( &utm_x , &utm_y , &depth );
+  for (int j=0; j < num_jobs; j++) {
+    jobs[j].grav = grav;
+    jobs[j].subsidence = subsidence;
+    jobs[j].region = region;
+    jobs[j].utm_x = utm_x;
+    jobs[j].utm_y = utm_y;
+    jobs[j].depth = depth;
+  }
+
+#ifdef ERT_HAVE_THREAD_POOL
+  if (concurrent) {
+    thread_pool_type * tp = thread_pool_alloc( num_jobs , true );
+    for (int j=0; j < num_jobs; j++)
+      thread_pool_add_job( tp , eval_job_main , &jobs[j] );
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+  } else
+#endif
+  for (int j=0; j < num_jobs; j++)
+    eval_job_main( &jobs[j] );
+
+  for (int s=0; s < NUM_STATIONS; s++) {
+    double grav_expected = ecl_grav_eval( grav , "BASE" , "MONITOR" , region , utm_x[s] , utm_y[s] , depth[s] , PHASE_MASK );
+    double subsidence_expected = ecl_subsidence_eval( subsidence , "BASE" , "MONITOR" , region , utm_x[s] , utm_y[s] , depth[s] ,
+                                                      COMPRESSIBILITY , POISSON_RATIO );
+    double geertsma_expected = ecl_subsidence_eval_geertsma( subsidence , "BASE" , "MONITOR" , region , utm_x[s] , utm_y[s] , depth[s] ,
+                                                             YOUNGS_MODULUS , POISSON_RATIO , SEABED );
+
+    test_assert_true( grav_expected != 0 );
+    test_assert_true( subsidence_expected != 0 );
+    test_assert_true( geertsma_expected != 0 );
+    for (int j=0; j < num_jobs; j++) {
+      assert_close( grav_expected , jobs[j].grav_result[s] );
+      assert_close( subsidence_expected , jobs[j].subsidence_result[s] );
+      assert_close( geertsma_expected , jobs[j].geertsma_result[s] );
+    }
+  }
+
+  free( jobs );
+  free( utm_x );
+  free( utm_y );
+  free( depth );
+  ecl_subsidence_free( subsidence );
+  ecl_grav_free( grav );
+  ecl_file_close( monitor_file );
+  ecl_file_close( base_file );
+  ecl_file_close( init_file );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_grav_list");
+  ecl_grid_type * grid = alloc_grid();
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+
+  ecl_region_select_k1k2( region , 1 , 3 );
+  write_init( grid );
+  write_restart( grid , "GRAV.X0001" , 1.0 );
+  write_restart( grid , "GRAV.X0002" , 1.5 );
+
+  /* The serial calls also build the active list of the region, which is not thread safe. */
+  test_eval_list( grid , NULL , false );
+  test_eval_list( grid , region , false );
+  test_eval_list( grid , NULL , true );
+  test_eval_list( grid , region , true );
+
+  ecl_region_free( region );
+  ecl_grid_free( grid );
+  test_work_area_free( work_area );
+  exit(0);
+}
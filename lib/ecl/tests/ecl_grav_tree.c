@@ -0,0 +1,260 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grav_tree.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/vector.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_grid_cache.h>
+#include <ert/ecl/ecl_grav_common.h>
+
+
+#define NUM_STATIONS 25
+
+
+/*
+  A 40 x 40 x 10 grid, 1000 m below the stations, where every
+  thirteenth cell is inactive.
+*/
+
+ecl_grid_type * alloc_grid() {
+  const double ivec[3] = {100 , 10 , 0};
+  const double jvec[3] = {-5 , 100 , 2};
+  const double kvec[3] = { 0 ,  0 , 10};
+  int * actnum = util_malloc( 40 * 40 * 10 * sizeof * actnum );
+  ecl_grid_type * grid;
+
+  for (int g=0; g < 40*40*10; g++)
+    actnum[g] = (g % 13) == 5 ? 0 : 1;
+
+  grid = ecl_grid_alloc_regular( 40 , 40 , 10 , ivec , jvec , kvec , actnum );
+  free( actnum );
+  return grid;
+}
+
+
+/*
+  The stations are on the seabed at depth -1000; for the geertsma
+  kernel the depth is relative to the seabed.
+*/
+
+static void alloc_stations( double ** utm_x , double ** utm_y , double ** depth , double ** seabed_depth) {
+  *utm_x = util_malloc( NUM_STATIONS * sizeof ** utm_x );
+  *utm_y = util_malloc( NUM_STATIONS * sizeof ** utm_y );
+  *depth = util_malloc( NUM_STATIONS * sizeof ** depth );
+  *seabed_depth = util_malloc( NUM_STATIONS * sizeof ** seabed_depth );
+
+  for (int s = 0; s < NUM_STATIONS; s++) {
+    (*utm_x)[s] = -1000 + 1500 * (s % 5);
+    (*utm_y)[s] = -1000 + 1500 * (s / 5);
+    (*depth)[s] = -1000;
+    (*seabed_depth)[s] = 0;
+  }
+}
+
+
+void test_tree( const ecl_grid_type * grid ) {
+  ecl_grid_cache_type * cache = ecl_grid_cache_alloc( grid );
+  ecl_grid_cache_type * subset = ecl_grid_cache_get_subset( cache , NULL , 0 , NULL );
+  vector_type * tree_list = vector_alloc_new();
+  ecl_grav_tree_type * tree = ecl_grav_common_acquire_tree( tree_list , cache , NULL , NULL );
+  int size = ecl_grid_cache_get_size( subset );
+  double * weight = util_malloc( size * sizeof * weight );
+  double * abs_weight = util_malloc( size * sizeof * abs_weight );
+  double * result = util_malloc( NUM_STATIONS * sizeof * result );
+  double * utm_x , * utm_y , * depth , * seabed_depth;
+
+  test_assert_true( tree == ecl_grav_common_acquire_tree( tree_list , cache , NULL , NULL ));
+  test_assert_int_equal( 1 , vector_get_size( tree_list ));
+  test_assert_true( subset == ecl_grav_tree_get_subset( tree ));
+
+  alloc_stations( &utm_x , &utm_y , &depth , &seabed_depth );
+  for (int i = 0; i < size; i++) {
+    weight[i] = 1000 * sin( 0.37 * i ) + 200;
+    abs_weight[i] = fabs( weight[i] );
+  }
+
+  ecl_grav_common_eval_biot_savart_tree( tree , weight , NUM_STATIONS , utm_x , utm_y , depth , 0 , result );
+  for (int s = 0; s < NUM_STATIONS; s++) {
+    double scale = ecl_grav_common_eval_biot_savart_subset( subset , abs_weight , utm_x[s] , utm_y[s] , depth[s] );
+    double expected = ecl_grav_common_eval_biot_savart_subset( subset , weight , utm_x[s] , utm_y[s] , depth[s] );
+    test_assert_true( fabs( result[s] - expected ) < 1e-10 * scale );
+  }
+
+  ecl_grav_common_eval_biot_savart_tree( tree , weight , NUM_STATIONS , utm_x , utm_y , depth , 0.5 , result );
+  for (int s = 0; s < NUM_STATIONS; s++) {
+    double scale = ecl_grav_common_eval_biot_savart_subset( subset , abs_weight , utm_x[s] , utm_y[s] , depth[s] );
+    double expected = ecl_grav_common_eval_biot_savart_subset( subset , weight , utm_x[s] , utm_y[s] , depth[s] );
+    test_assert_true( fabs( result[s] - expected ) < 1e-3 * scale );
+  }
+
+  ecl_grav_common_eval_geertsma_tree( tree , weight , NUM_STATIONS , utm_x , utm_y , seabed_depth , 0.25 , -1000 , 0 , result );
+  for (int s = 0; s < NUM_STATIONS; s++) {
+    double scale = fabs( ecl_grav_common_eval_geertsma_subset( subset , abs_weight , utm_x[s] , utm_y[s] , seabed_depth[s] , 0.25 , -1000 ));
+    double expected = ecl_grav_common_eval_geertsma_subset( subset , weight , utm_x[s] , utm_y[s] , seabed_depth[s] , 0.25 , -1000 );
+    test_assert_true( fabs( result[s] - expected ) < 1e-10 * scale );
+  }
+
+  ecl_grav_common_eval_geertsma_tree( tree , weight , NUM_STATIONS , utm_x , utm_y , seabed_depth , 0.25 , -1000 , 0.5 , result );
+  for (int s = 0; s < NUM_STATIONS; s++) {
+    double scale = fabs( ecl_grav_common_eval_geertsma_subset( subset , abs_weight , utm_x[s] , utm_y[s] , seabed_depth[s] , 0.25 , -1000 ));
+    double expected = ecl_grav_common_eval_geertsma_subset( subset , weight , utm_x[s] , utm_y[s] , seabed_depth[s] , 0.25 , -1000 );
+    test_assert_true( fabs( result[s] - expected ) < 1e-3 * scale );
+  }
+
+  free( utm_x );
+  free( utm_y );
+  free( depth );
+  free( seabed_depth );
+  free( result );
+  free( abs_weight );
+  free( weight );
+  ecl_grav_common_release_tree( tree );
+  ecl_grav_common_release_tree( tree );
+  vector_free( tree_list );
+  ecl_grid_cache_free( subset );
+  ecl_grid_cache_free( cache );
+}
+
+
+/*
+  The plain eval functions visit the cells of the region directly;
+  they should agree with the _subset functions on the corresponding
+  subset.
+*/
+
+void test_direct( const ecl_grid_type * grid ) {
+  ecl_grid_cache_type * cache = ecl_grid_cache_alloc( grid );
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  int size = ecl_grid_cache_get_size( cache );
+  bool * aquifer = util_malloc( size * sizeof * aquifer );
+  double * weight = util_malloc( size * sizeof * weight );
+
+  for (int i = 0; i < size; i++) {
+    aquifer[i] = (i % 7) == 3;
+    weight[i] = 1000 * sin( 0.37 * i ) + 200;
+  }
+  ecl_region_select_k1k2( region , 2 , 6 );
+
+  {
+    const int_vector_type * index_vector = ecl_region_get_active_list( region );
+    ecl_grid_cache_type * subset = ecl_grid_cache_get_subset( cache , int_vector_get_const_ptr( index_vector ) , int_vector_size( index_vector ) , aquifer );
+    const int * parent_index = ecl_grid_cache_get_parent_index( subset );
+    int subset_size = ecl_grid_cache_get_size( subset );
+    double * subset_weight = util_malloc( subset_size * sizeof * subset_weight );
+
+    for (int i = 0; i < subset_size; i++)
+      subset_weight[i] = weight[ parent_index[i] ];
+
+    for (int s = 0; s < NUM_STATIONS; s++) {
+      double x = -1000 + 1500 * (s % 5);
+      double y = -1000 + 1500 * (s / 5);
+      double expected = ecl_grav_common_eval_biot_savart_subset( subset , subset_weight , x , y , -1000 );
+      double value = ecl_grav_common_eval_biot_savart( cache , region , aquifer , weight , x , y , -1000 );
+      test_assert_true( fabs( value - expected ) <= 1e-10 * fabs( expected ));
+
+      expected = ecl_grav_common_eval_geertsma_subset( subset , subset_weight , x , y , 0 , 0.25 , -1000 );
+      value = ecl_grav_common_eval_geertsma( cache , region , aquifer , weight , x , y , 0 , 0.25 , -1000 );
+      test_assert_true( fabs( value - expected ) <= 1e-10 * fabs( expected ));
+    }
+
+    free( subset_weight );
+    ecl_grid_cache_free( subset );
+  }
+
+  free( weight );
+  free( aquifer );
+  ecl_region_free( region );
+  ecl_grid_cache_free( cache );
+}
+
+
+/*
+  Trees which are not in use are evicted when new regions are added,
+  the tree of a region which is in use is kept.
+*/
+
+void test_evict( const ecl_grid_type * grid ) {
+  ecl_grid_cache_type * cache = ecl_grid_cache_alloc( grid );
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  vector_type * tree_list = vector_alloc_new();
+  ecl_grav_tree_type * first_tree;
+
+  ecl_region_select_k1k2( region , 0 , 0 );
+  first_tree = ecl_grav_common_acquire_tree( tree_list , cache , region , NULL );
+  for (int k = 1; k < 10; k++) {
+    ecl_grav_tree_type * tree;
+
+    ecl_region_select_k1k2( region , k , k );
+    tree = ecl_grav_common_acquire_tree( tree_list , cache , region , NULL );
+    test_assert_int_equal( ecl_grid_cache_get_size( ecl_grav_tree_get_subset( tree )) , int_vector_size( ecl_region_get_active_list( region )));
+    ecl_grav_common_release_tree( tree );
+  }
+
+  test_assert_true( vector_get_size( tree_list ) < 10 );
+  test_assert_true( first_tree == vector_iget( tree_list , 0 ));
+
+  ecl_grav_common_release_tree( first_tree );
+  vector_free( tree_list );
+  ecl_region_free( region );
+  ecl_grid_cache_free( cache );
+}
+
+
+void test_empty( const ecl_grid_type * grid ) {
+  ecl_grid_cache_type * cache = ecl_grid_cache_alloc( grid );
+  int size = ecl_grid_cache_get_size( cache );
+  bool * exclude = util_malloc( size * sizeof * exclude );
+  double utm_x = 0 , utm_y = 0 , depth = -1000;
+  double result = 1;
+
+  for (int i = 0; i < size; i++)
+    exclude[i] = true;
+
+  {
+    ecl_grid_cache_type * subset = ecl_grid_cache_get_subset( cache , NULL , 0 , exclude );
+    ecl_grav_tree_type * tree = ecl_grav_tree_alloc( subset );
+    double weight = 0;
+
+    ecl_grav_common_eval_biot_savart_tree( tree , &weight , 1 , &utm_x , &utm_y , &depth , 0.5 , &result );
+    test_assert_double_equal( 0 , result );
+    ecl_grav_tree_free( tree );
+    ecl_grid_cache_free( subset );
+  }
+
+  free( exclude );
+  ecl_grid_cache_free( cache );
+}
+
+
+int main(int argc , char ** argv) {
+  ecl_grid_type * grid = alloc_grid();
+
+  test_tree( grid );
+  test_direct( grid );
+  test_evict( grid );
+  test_empty( grid );
+
+  ecl_grid_free( grid );
+  exit(0);
+}
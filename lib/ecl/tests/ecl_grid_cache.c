@@ -0,0 +1,255 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_cache.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_grid_cache.h>
+#include <ert/ecl/ecl_grav_common.h>
+
+
+/*
+  A skewed 20 x 15 x 6 grid where every seventh cell is inactive.
+*/
+
+ecl_grid_type * alloc_grid() {
+  const double ivec[3] = {50 , 10 , 0};
+  const double jvec[3] = {-5 , 40 , 1};
+  const double kvec[3] = { 0 ,  0 , 4};
+  int * actnum = util_malloc( 20 * 15 * 6 * sizeof * actnum );
+  ecl_grid_type * grid;
+
+  for (int g=0; g < 20*15*6; g++)
+    actnum[g] = (g % 7) == 3 ? 0 : 1;
+
+  grid = ecl_grid_alloc_regular( 20 , 15 , 6 , ivec , jvec , kvec , actnum );
+  free( actnum );
+  return grid;
+}
+
+
+void test_positions( const ecl_grid_type * grid ) {
+  ecl_grid_cache_type * cache = ecl_grid_cache_alloc( grid );
+  ecl_grid_cache_type * float_cache = ecl_grid_cache_alloc__( grid , true );
+  const double * volume = ecl_grid_cache_get_volume( cache );
+  double x0 , y0 , z0;
+
+  test_assert_int_equal( ecl_grid_cache_get_size( cache ) , ecl_grid_get_active_size( grid ));
+  test_assert_int_equal( ecl_grid_cache_get_size( float_cache ) , ecl_grid_get_active_size( grid ));
+  test_assert_false( ecl_grid_cache_float_storage( cache ));
+  test_assert_true( ecl_grid_cache_float_storage( float_cache ));
+  test_assert_NULL( ecl_grid_cache_get_parent_index( cache ));
+
+  ecl_grid_cache_get_origin( float_cache , &x0 , &y0 , &z0 );
+  for (int active_index = 0; active_index < ecl_grid_get_active_size( grid ); active_index++) {
+    int global_index = ecl_grid_get_global_index1A( grid , active_index );
+    double x , y , z;
+
+    ecl_grid_get_xyz1( grid , global_index , &x , &y , &z );
+    test_assert_int_equal( global_index , ecl_grid_cache_iget_global_index( cache , active_index ));
+    test_assert_double_equal( x , ecl_grid_cache_get_xpos( cache )[active_index] );
+    test_assert_double_equal( y , ecl_grid_cache_get_ypos( cache )[active_index] );
+    test_assert_double_equal( z , ecl_grid_cache_get_zpos( cache )[active_index] );
+    test_assert_double_equal( volume[active_index] , ecl_grid_get_cell_volume1( grid , global_index ));
+
+    test_assert_true( fabs( x - (x0 + ecl_grid_cache_get_xpos_float( float_cache )[active_index])) < 1e-3 );
+    test_assert_true( fabs( y - (y0 + ecl_grid_cache_get_ypos_float( float_cache )[active_index])) < 1e-3 );
+    test_assert_true( fabs( z - (z0 + ecl_grid_cache_get_zpos_float( float_cache )[active_index])) < 1e-3 );
+  }
+
+  ecl_grid_cache_free( float_cache );
+  ecl_grid_cache_free( cache );
+}
+
+
+void test_shared( const ecl_grid_type * grid ) {
+  ecl_grid_cache_type * cache1 = ecl_grid_cache_alloc_shared( grid , false );
+  ecl_grid_cache_type * cache2 = ecl_grid_cache_alloc_shared( grid , false );
+  ecl_grid_cache_type * float_cache = ecl_grid_cache_alloc_shared( grid , true );
+
+  test_assert_true( cache1 == cache2 );
+  test_assert_true( cache1 != float_cache );
+
+  ecl_grid_cache_free( cache1 );
+  ecl_grid_cache_free( float_cache );
+  test_assert_int_equal( ecl_grid_cache_get_size( cache2 ) , ecl_grid_get_active_size( grid ));
+  ecl_grid_cache_free( cache2 );
+
+  cache1 = ecl_grid_cache_alloc_shared( grid , false );
+  test_assert_int_equal( ecl_grid_cache_get_size( cache1 ) , ecl_grid_get_active_size( grid ));
+  ecl_grid_cache_free( cache1 );
+}
+
+
+void test_subset( const ecl_grid_type * grid ) {
+  ecl_grid_cache_type * cache = ecl_grid_cache_alloc( grid );
+  int size = ecl_grid_cache_get_size( cache );
+  bool * exclude = util_malloc( size * sizeof * exclude );
+  int active_list[] = {17 , 4 , 9 , 10 , 100};
+
+  for (int i = 0; i < size; i++)
+    exclude[i] = (i % 4) == 1;
+
+  {
+    ecl_grid_cache_type * subset = ecl_grid_cache_get_subset( cache , active_list , 5 , exclude );
+    const int * parent_index = ecl_grid_cache_get_parent_index( subset );
+
+    test_assert_int_equal( 3 , ecl_grid_cache_get_size( subset ));
+    test_assert_int_equal( 4 , parent_index[0] );
+    test_assert_int_equal( 10 , parent_index[1] );
+    test_assert_int_equal( 100 , parent_index[2] );
+    for (int i = 0; i < 3; i++) {
+      test_assert_int_equal( ecl_grid_cache_iget_global_index( cache , parent_index[i] ) , ecl_grid_cache_iget_global_index( subset , i ));
+      test_assert_double_equal( ecl_grid_cache_get_xpos( cache )[parent_index[i]] , ecl_grid_cache_get_xpos( subset )[i] );
+      test_assert_double_equal( ecl_grid_cache_get_zpos( cache )[parent_index[i]] , ecl_grid_cache_get_zpos( subset )[i] );
+    }
+
+    {
+      ecl_grid_cache_type * subset2 = ecl_grid_cache_get_subset( cache , active_list , 5 , exclude );
+      test_assert_true( subset == subset2 );
+      ecl_grid_cache_free( subset2 );
+    }
+    active_list[0] = 18;
+    {
+      ecl_grid_cache_type * subset2 = ecl_grid_cache_get_subset( cache , active_list , 5 , exclude );
+      ecl_grid_cache_type * subset3 = ecl_grid_cache_get_subset( cache , active_list , 5 , NULL );
+      test_assert_true( subset != subset2 );
+      test_assert_true( subset != subset3 );
+      ecl_grid_cache_free( subset3 );
+      ecl_grid_cache_free( subset2 );
+    }
+    ecl_grid_cache_free( subset );
+  }
+
+  {
+    ecl_grid_cache_type * subset = ecl_grid_cache_get_subset( cache , NULL , 0 , exclude );
+    int expected_size = 0;
+    for (int i = 0; i < size; i++)
+      if (!exclude[i])
+        expected_size++;
+    test_assert_int_equal( expected_size , ecl_grid_cache_get_size( subset ));
+
+    /* The subset is identified by the content of the exclude mask, not the address. */
+    {
+      bool * exclude_copy = util_alloc_copy( exclude , size * sizeof * exclude );
+      ecl_grid_cache_type * subset2 = ecl_grid_cache_get_subset( cache , NULL , 0 , exclude_copy );
+      test_assert_true( subset == subset2 );
+      ecl_grid_cache_free( subset2 );
+
+      exclude[0] = !exclude[0];
+      subset2 = ecl_grid_cache_get_subset( cache , NULL , 0 , exclude );
+      test_assert_true( subset != subset2 );
+      test_assert_int_equal( expected_size + (exclude[0] ? -1 : 1) , ecl_grid_cache_get_size( subset2 ));
+      ecl_grid_cache_free( subset2 );
+      free( exclude_copy );
+    }
+    ecl_grid_cache_free( subset );
+  }
+
+  /* A subset holds a reference to the cache it is created from. */
+  {
+    ecl_grid_cache_type * subset = ecl_grid_cache_get_subset( cache , NULL , 0 , NULL );
+    ecl_grid_cache_free( cache );
+    test_assert_int_equal( size , ecl_grid_cache_get_size( subset ));
+    test_assert_int_equal( ecl_grid_cache_get_parent_index( subset )[size - 1] , size - 1 );
+    ecl_grid_cache_free( subset );
+  }
+
+  free( exclude );
+}
+
+
+static double biot_savart( const ecl_grid_type * grid , const bool * selected , const double * weight , double utm_x , double utm_y , double depth) {
+  double sum = 0;
+  for (int active_index = 0; active_index < ecl_grid_get_active_size( grid ); active_index++) {
+    if (selected[active_index]) {
+      double x , y , z;
+      ecl_grid_get_xyz1( grid , ecl_grid_get_global_index1A( grid , active_index ) , &x , &y , &z );
+      {
+        double dist_x = x - utm_x;
+        double dist_y = y - utm_y;
+        double dist_z = z - depth;
+        double dist = sqrt( dist_x*dist_x + dist_y*dist_y + dist_z*dist_z );
+        sum += weight[active_index] * dist_z / (dist * dist * dist);
+      }
+    }
+  }
+  return sum;
+}
+
+
+void test_eval( ecl_grid_type * grid ) {
+  ecl_grid_cache_type * cache = ecl_grid_cache_alloc( grid );
+  ecl_grid_cache_type * float_cache = ecl_grid_cache_alloc__( grid , true );
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  int size = ecl_grid_cache_get_size( cache );
+  bool * aquifer = util_malloc( size * sizeof * aquifer );
+  bool * selected = util_malloc( size * sizeof * selected );
+  double * weight = util_malloc( size * sizeof * weight );
+
+  for (int i = 0; i < size; i++) {
+    aquifer[i] = (i % 11) == 0;
+    weight[i] = 1 + 0.01 * i;
+  }
+
+  for (int i = 0; i < size; i++)
+    selected[i] = !aquifer[i];
+  {
+    double expected = biot_savart( grid , selected , weight , 400 , 300 , -50 );
+    test_assert_double_equal( expected , ecl_grav_common_eval_biot_savart( cache , NULL , aquifer , weight , 400 , 300 , -50 ));
+    test_assert_true( fabs( expected - ecl_grav_common_eval_biot_savart( float_cache , NULL , aquifer , weight , 400 , 300 , -50 )) < 1e-6 * fabs( expected ));
+  }
+
+  ecl_region_select_from_ijkbox( region , 2 , 10 , 3 , 8 , 1 , 4 );
+  {
+    const int_vector_type * active_list = ecl_region_get_active_list( region );
+    for (int i = 0; i < size; i++)
+      selected[i] = false;
+    for (int i = 0; i < int_vector_size( active_list ); i++) {
+      int active_index = int_vector_iget( active_list , i );
+      selected[active_index] = !aquifer[active_index];
+    }
+  }
+  {
+    double expected = biot_savart( grid , selected , weight , 400 , 300 , -50 );
+    test_assert_true( fabs( expected - ecl_grav_common_eval_biot_savart( cache , region , aquifer , weight , 400 , 300 , -50 )) < 1e-12 * fabs( expected ));
+  }
+
+  free( weight );
+  free( selected );
+  free( aquifer );
+  ecl_region_free( region );
+  ecl_grid_cache_free( float_cache );
+  ecl_grid_cache_free( cache );
+}
+
+
+int main(int argc , char ** argv) {
+  ecl_grid_type * grid = alloc_grid();
+  test_positions( grid );
+  test_shared( grid );
+  test_subset( grid );
+  test_eval( grid );
+  ecl_grid_free( grid );
+  exit(0);
+}
@@ -153,6 +153,105 @@ void export_mapaxes( const ecl_grid_type * grid , ecl_file_type * ecl_file ) {
 
 
 
+void export_kw( const ecl_grid_type * grid ) {
+  const int global_size = ecl_grid_get_global_size( grid );
+  const int nactive = ecl_grid_get_nactive( grid );
+  ecl_kw_type * active_kw = ecl_kw_alloc( "PORO" , nactive , ECL_FLOAT );
+  ecl_kw_type * global_kw = ecl_kw_alloc( "PORO" , global_size , ECL_FLOAT );
+  float * global_data = util_malloc( global_size * sizeof * global_data );
+  float * active_data = util_malloc( nactive * sizeof * active_data );
+
+  for (int i=0; i < nactive; i++)
+    ecl_kw_iset_float( active_kw , i , i );
+
+  ecl_grid_export_kw_global( grid , active_kw , -1 , global_data );
+  for (int g=0; g < global_size; g++) {
+    int active_index = ecl_grid_get_active_index1( grid , g );
+    if (active_index >= 0)
+      test_assert_float_equal( global_data[g] , active_index );
+    else
+      test_assert_float_equal( global_data[g] , -1 );
+  }
+
+  ecl_grid_import_kw_global( grid , global_kw , global_data );
+  ecl_grid_export_kw_active( grid , global_kw , active_data );
+  for (int i=0; i < nactive; i++)
+    test_assert_float_equal( active_data[i] , i );
+
+  ecl_kw_scalar_set_float( active_kw , 0 );
+  ecl_grid_import_kw_global( grid , active_kw , global_data );
+  for (int i=0; i < nactive; i++)
+    test_assert_float_equal( ecl_kw_iget_float( active_kw , i ) , i );
+
+  free( active_data );
+  free( global_data );
+  ecl_kw_free( global_kw );
+  ecl_kw_free( active_kw );
+}
+
+
+void export_kw_list( const ecl_grid_type * grid ) {
+  const int global_size = ecl_grid_get_global_size( grid );
+  const int nactive = ecl_grid_get_nactive( grid );
+  const int * inv_index_map = ecl_grid_get_inv_index_map_ptr( grid );
+  ecl_kw_type * int_kw = ecl_kw_alloc( "SATNUM" , nactive , ECL_INT );
+  ecl_kw_type * double_kw = ecl_kw_alloc( "PRESSURE" , nactive , ECL_DOUBLE );
+  ecl_kw_type * global_kw = ecl_kw_alloc( "PORV" , global_size , ECL_DOUBLE );
+  ecl_kw_type * compressed_kw = ecl_kw_alloc( "PORV" , nactive , ECL_DOUBLE );
+  int * int_data = util_malloc( global_size * sizeof * int_data );
+  double * double_data = util_malloc( global_size * sizeof * double_data );
+  double * porv_data = util_malloc( global_size * sizeof * porv_data );
+
+  for (int i=0; i < nactive; i++) {
+    ecl_kw_iset_int( int_kw , i , i + 1 );
+    ecl_kw_iset_double( double_kw , i , 0.5 * i );
+  }
+  for (int g=0; g < global_size; g++)
+    ecl_kw_iset_double( global_kw , g , g );
+
+  {
+    const ecl_kw_type * kw_list[3] = { int_kw , double_kw , global_kw };
+    void * data_list[3] = { int_data , double_data , porv_data };
+    ecl_grid_export_kw_list_global( grid , 3 , kw_list , 0 , data_list );
+  }
+
+  for (int g=0; g < global_size; g++) {
+    int active_index = ecl_grid_get_active_index1( grid , g );
+    test_assert_double_equal( porv_data[g] , g );
+    if (active_index >= 0) {
+      test_assert_int_equal( inv_index_map[active_index] , g );
+      test_assert_int_equal( int_data[g] , active_index + 1 );
+      test_assert_double_equal( double_data[g] , 0.5 * active_index );
+    } else {
+      test_assert_int_equal( int_data[g] , 0 );
+      test_assert_double_equal( double_data[g] , 0 );
+    }
+  }
+
+  ecl_grid_compressed_kw_copy( grid , compressed_kw , global_kw );
+  for (int i=0; i < nactive; i++)
+    test_assert_double_equal( ecl_kw_iget_double( compressed_kw , i ) , ecl_grid_get_global_index1A( grid , i ));
+
+  ecl_kw_scalar_set_double( global_kw , -1 );
+  ecl_grid_global_kw_copy( grid , global_kw , double_kw );
+  for (int g=0; g < global_size; g++) {
+    int active_index = ecl_grid_get_active_index1( grid , g );
+    if (active_index >= 0)
+      test_assert_double_equal( ecl_kw_iget_double( global_kw , g ) , 0.5 * active_index );
+    else
+      test_assert_double_equal( ecl_kw_iget_double( global_kw , g ) , -1 );
+  }
+
+  free( porv_data );
+  free( double_data );
+  free( int_data );
+  ecl_kw_free( compressed_kw );
+  ecl_kw_free( global_kw );
+  ecl_kw_free( double_kw );
+  ecl_kw_free( int_kw );
+}
+
+
 int main(int argc , char ** argv) {
   test_work_area_type * work_area = test_work_area_alloc("grid_export");
   {
@@ -179,5 +278,18 @@ int main(int argc , char ** argv) {
       ecl_grid_free( ecl_grid );
     }
   }
+
+  /* The keyword export functions are tested on a grid with inactive cells. */
+  {
+    int actnum[32];
+    ecl_grid_type * grid;
+
+    for (int i=0; i < 32; i++)
+      actnum[i] = (i % 3) ? 1 : 0;
+    grid = ecl_grid_alloc_rectangular(4,4,2,1,1,1,actnum);
+    export_kw( grid );
+    export_kw_list( grid );
+    ecl_grid_free( grid );
+  }
   test_work_area_free( work_area );
 }
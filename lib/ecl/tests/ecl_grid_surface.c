@@ -0,0 +1,203 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_surface.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/geometry/geo_surface.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_grid_surface.h>
+
+#define UNDEFINED -999
+
+/*
+  The grid is 10 x 8 x 3 cells of 10 x 10 x 2 m, with cell (0,0,0)
+  inactive. The surface nodes are at the half meters, so no node is on
+  a cell edge.
+*/
+
+ecl_grid_type * alloc_grid() {
+  int actnum[240];
+  for (int i=0; i < 240; i++)
+    actnum[i] = 1;
+  actnum[0] = 0;
+  return ecl_grid_alloc_rectangular( 10 , 8 , 3 , 10 , 10 , 2 , actnum );
+}
+
+
+void test_map( const ecl_grid_type * grid ) {
+  geo_surface_type * surface = geo_surface_alloc_new( 110 , 80 , 1.0 , 1.0 , 0.5 , 0.5 , 0 );
+  ecl_kw_type * k_kw = ecl_kw_alloc( "KINDEX" , ecl_grid_get_global_size( grid ) , ECL_FLOAT );
+  double * zcoord = util_calloc( geo_surface_get_size( surface ) , sizeof * zcoord );
+
+  for (int g=0; g < ecl_grid_get_global_size( grid ); g++) {
+    int i,j,k;
+    ecl_grid_get_ijk1( grid , g , &i , &j , &k );
+    ecl_kw_iset_float( k_kw , g , k );
+  }
+
+  ecl_grid_map_kw( grid , NULL , 0 , 2 , ECL_GRID_MAP_INTEGRAL , surface , UNDEFINED , zcoord );
+  for (int iy=0; iy < 80; iy++) {
+    for (int ix=0; ix < 110; ix++) {
+      double z = zcoord[ ix + iy * 110 ];
+      if (ix >= 100)
+        test_assert_double_equal( z , UNDEFINED );
+      else if ((ix < 10) && (iy < 10))
+        test_assert_double_equal( z , 4 );
+      else
+        test_assert_double_equal( z , 6 );
+    }
+  }
+
+  ecl_grid_map_kw( grid , k_kw , 0 , 2 , ECL_GRID_MAP_SUM , surface , UNDEFINED , zcoord );
+  test_assert_double_equal( zcoord[ 50 + 50*110 ] , 3 );
+  test_assert_double_equal( zcoord[ 0 ] , 3 );
+
+  ecl_grid_map_kw( grid , k_kw , 0 , 2 , ECL_GRID_MAP_AVERAGE , surface , UNDEFINED , zcoord );
+  test_assert_double_equal( zcoord[ 50 + 50*110 ] , 1 );
+  test_assert_double_equal( zcoord[ 0 ] , 1.5 );
+
+  ecl_grid_map_kw( grid , k_kw , 1 , 2 , ECL_GRID_MAP_MIN , surface , UNDEFINED , zcoord );
+  test_assert_double_equal( zcoord[ 50 + 50*110 ] , 1 );
+
+  ecl_grid_map_kw( grid , k_kw , 0 , 1 , ECL_GRID_MAP_MAX , surface , UNDEFINED , zcoord );
+  test_assert_double_equal( zcoord[ 50 + 50*110 ] , 1 );
+
+  ecl_grid_map_kw( grid , k_kw , 0 , 0 , ECL_GRID_MAP_MAX , surface , UNDEFINED , zcoord );
+  test_assert_double_equal( zcoord[ 0 ] , UNDEFINED );
+
+  free( zcoord );
+  ecl_kw_free( k_kw );
+  geo_surface_free( surface );
+}
+
+
+void test_map_rotated( const ecl_grid_type * grid ) {
+  geo_surface_type * surface = geo_surface_alloc_new( 150 , 150 , 0.75 , 0.75 , 20.1 , -30.3 , 30 );
+  double * zcoord = util_calloc( geo_surface_get_size( surface ) , sizeof * zcoord );
+
+  ecl_grid_map_kw( grid , NULL , 0 , 2 , ECL_GRID_MAP_INTEGRAL , surface , UNDEFINED , zcoord );
+  for (int node=0; node < geo_surface_get_size( surface ); node++) {
+    double x,y;
+    geo_surface_iget_xy( surface , node , &x , &y );
+    if ((x < 0) || (x > 100) || (y < 0) || (y > 80))
+      test_assert_double_equal( zcoord[node] , UNDEFINED );
+    else if ((x < 10) && (y < 10))
+      test_assert_double_equal( zcoord[node] , 4 );
+    else
+      test_assert_double_equal( zcoord[node] , 6 );
+  }
+
+  free( zcoord );
+  geo_surface_free( surface );
+}
+
+
+/*
+  One 10 x 10 x 10 m cell with pillars leaning 10 m in the x
+  direction; the top face covers x in [0,10] and the bottom face x in
+  [10,20].
+*/
+
+void test_map_footprint() {
+  float coord[24];
+  float zcorn[8];
+  geo_surface_type * surface = geo_surface_alloc_new( 25 , 3 , 1.0 , 2.0 , 0.5 , 3.5 , 0 );
+  double * zcoord = util_calloc( geo_surface_get_size( surface ) , sizeof * zcoord );
+  ecl_grid_type * grid;
+
+  for (int j=0; j < 2; j++) {
+    for (int i=0; i < 2; i++) {
+      float * pillar = &coord[ 6 * (i + 2*j) ];
+      pillar[0] = 10 * i;
+      pillar[1] = 10 * j;
+      pillar[2] = 0;
+      pillar[3] = 10 * i + 10;
+      pillar[4] = 10 * j;
+      pillar[5] = 10;
+    }
+  }
+  for (int c=0; c < 8; c++)
+    zcorn[c] = (c < 4) ? 0 : 10;
+  grid = ecl_grid_alloc_GRDECL_data( 1 , 1 , 1 , zcorn , coord , NULL , false , NULL );
+
+  ecl_grid_map_kw_footprint( grid , NULL , 0 , 0 , ECL_GRID_MAP_SUM , ECL_GRID_FOOTPRINT_TOP , surface , UNDEFINED , zcoord );
+  for (int iy=0; iy < 3; iy++)
+    for (int ix=0; ix < 25; ix++)
+      test_assert_double_equal( zcoord[ ix + 25*iy ] , (ix < 10) ? 1 : UNDEFINED );
+
+  ecl_grid_map_kw_footprint( grid , NULL , 0 , 0 , ECL_GRID_MAP_SUM , ECL_GRID_FOOTPRINT_BOTTOM , surface , UNDEFINED , zcoord );
+  for (int iy=0; iy < 3; iy++)
+    for (int ix=0; ix < 25; ix++)
+      test_assert_double_equal( zcoord[ ix + 25*iy ] , ((ix >= 10) && (ix < 20)) ? 1 : UNDEFINED );
+
+  ecl_grid_map_kw( grid , NULL , 0 , 0 , ECL_GRID_MAP_SUM , surface , UNDEFINED , zcoord );
+  for (int iy=0; iy < 3; iy++)
+    for (int ix=0; ix < 25; ix++)
+      test_assert_double_equal( zcoord[ ix + 25*iy ] , ((ix >= 5) && (ix < 15)) ? 1 : UNDEFINED );
+
+  ecl_grid_free( grid );
+  free( zcoord );
+  geo_surface_free( surface );
+}
+
+
+void test_sample( const ecl_grid_type * grid ) {
+  geo_surface_type * surface = geo_surface_alloc_new( 61 , 51 , 2.0 , 2.0 , -10 , -10 , 0 );
+  double * values = util_calloc( ecl_grid_get_global_size( grid ) , sizeof * values );
+
+  for (int node=0; node < geo_surface_get_size( surface ); node++) {
+    double x,y;
+    geo_surface_iget_xy( surface , node , &x , &y );
+    geo_surface_iset_zvalue( surface , node , 1000 + 2*x + 3*y );
+  }
+
+  ecl_grid_sample_surface( grid , surface , UNDEFINED , values );
+  for (int g=0; g < ecl_grid_get_global_size( grid ); g++) {
+    double x,y,z;
+    ecl_grid_get_xyz1( grid , g , &x , &y , &z );
+    test_assert_double_equal( values[g] , 1000 + 2*x + 3*y );
+  }
+
+  ecl_grid_sample_surface_layer( grid , surface , 2 , UNDEFINED , values );
+  test_assert_double_equal( values[3 + 2*10] , 1000 + 2*35 + 3*25 );
+
+  geo_surface_free( surface );
+  surface = geo_surface_alloc_new( 11 , 11 , 2.0 , 2.0 , -10 , -10 , 0 );
+  ecl_grid_sample_surface_layer( grid , surface , 0 , UNDEFINED , values );
+  test_assert_double_equal( values[9] , UNDEFINED );
+
+  free( values );
+  geo_surface_free( surface );
+}
+
+
+int main( int argc , char ** argv) {
+  ecl_grid_type * grid = alloc_grid();
+  test_map( grid );
+  test_map_rotated( grid );
+  test_map_footprint();
+  test_sample( grid );
+  ecl_grid_free( grid );
+  exit(0);
+}
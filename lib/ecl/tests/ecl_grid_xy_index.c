@@ -0,0 +1,252 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_xy_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/thread_pool.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+/*
+  The grid is a skewed 30 x 20 x 3 grid of parallelogram cells, where
+  the layers are also shifted in the xy plane. The corner (i,j,k) is
+  at i*ivec + j*jvec + k*kvec, so the expected (i,j) of a point can be
+  found by solving a 2x2 linear system.
+*/
+
+#define NX 30
+#define NY 20
+#define NZ 3
+#define NUM_POINTS 50000
+
+static const double ivec[3] = {10 , 3 , 0};
+static const double jvec[3] = {-2 , 8 , 0};
+static const double kvec[3] = { 1 , 0.5 , 2};
+
+
+/*
+  Returns false if the point is outside corner layer k, or so close to
+  a cell edge that the expected result is ambiguous.
+*/
+
+static bool expected_ij( int k , double x , double y , int * i , int * j) {
+  double det = ivec[0]*jvec[1] - ivec[1]*jvec[0];
+  double px = x - k*kvec[0];
+  double py = y - k*kvec[1];
+  double a = ( px*jvec[1] - py*jvec[0]) / det;
+  double b = (-px*ivec[1] + py*ivec[0]) / det;
+
+  if ((fabs( a - floor( a + 0.5 )) < 1e-6) || (fabs( b - floor( b + 0.5 )) < 1e-6))
+    return false;
+
+  *i = (int) floor( a );
+  *j = (int) floor( b );
+  return ((*i >= 0) && (*i < NX) && (*j >= 0) && (*j < NY));
+}
+
+
+static void random_points( double * x , double * y , int num_points) {
+  for (int p=0; p < num_points; p++) {
+    x[p] = -60 + 380 * ((double) rand() / RAND_MAX);
+    y[p] =  -5 + 260 * ((double) rand() / RAND_MAX);
+  }
+}
+
+
+void test_ij( const ecl_grid_type * grid ) {
+  double * x = util_malloc( NUM_POINTS * sizeof * x );
+  double * y = util_malloc( NUM_POINTS * sizeof * y );
+  int * i_list = util_malloc( NUM_POINTS * sizeof * i_list );
+  int * j_list = util_malloc( NUM_POINTS * sizeof * j_list );
+
+  random_points( x , y , NUM_POINTS );
+  for (int k=0; k <= NZ; k++) {
+    int found = ecl_grid_get_ij_from_xy_list( grid , k , NUM_POINTS , x , y , i_list , j_list );
+    int expected_found = 0;
+
+    for (int p=0; p < NUM_POINTS; p++) {
+      int i , j;
+      int find_i , find_j;
+      bool inside = ecl_grid_get_ij_from_xy( grid , x[p] , y[p] , k , &find_i , &find_j );
+
+      if (inside) {
+        expected_found++;
+        test_assert_int_equal( find_i , i_list[p] );
+        test_assert_int_equal( find_j , j_list[p] );
+      } else {
+        test_assert_int_equal( -1 , i_list[p] );
+        test_assert_int_equal( -1 , j_list[p] );
+      }
+
+      if (expected_ij( k , x[p] , y[p] , &i , &j )) {
+        test_assert_true( inside );
+        test_assert_int_equal( i , find_i );
+        test_assert_int_equal( j , find_j );
+      }
+    }
+    test_assert_int_equal( found , expected_found );
+    test_assert_true( found > NUM_POINTS / 4 );
+  }
+
+  {
+    int i , j;
+    test_assert_false( ecl_grid_get_ij_from_xy( grid , -1000 , -1000 , 0 , &i , &j ));
+    test_assert_false( ecl_grid_get_ij_from_xy( grid , NAN , 10 , 0 , &i , &j ));
+  }
+
+  free( j_list );
+  free( i_list );
+  free( y );
+  free( x );
+}
+
+
+void test_global_index( const ecl_grid_type * grid ) {
+  double * x = util_malloc( NUM_POINTS * sizeof * x );
+  double * y = util_malloc( NUM_POINTS * sizeof * y );
+  int * global_list = util_malloc( NUM_POINTS * sizeof * global_list );
+
+  random_points( x , y , NUM_POINTS );
+  for (int k=0; k < NZ; k++) {
+    for (int upper=0; upper < 2; upper++) {
+      bool lower_layer = (upper == 0);
+      ecl_grid_get_global_index_from_xy_list( grid , k , lower_layer , NUM_POINTS , x , y , global_list );
+
+      for (int p=0; p < NUM_POINTS; p++) {
+        int i , j;
+        int g = ecl_grid_get_global_index_from_xy( grid , k , lower_layer , x[p] , y[p] );
+        test_assert_int_equal( g , global_list[p] );
+
+        if (expected_ij( k + upper , x[p] , y[p] , &i , &j ))
+          test_assert_int_equal( g , ecl_grid_get_global_index3( grid , i , j , k ));
+
+        if (k == 0 && lower_layer)
+          test_assert_int_equal( g , ecl_grid_get_global_index_from_xy_bottom( grid , x[p] , y[p] ));
+
+        if (k == (NZ - 1) && !lower_layer)
+          test_assert_int_equal( g , ecl_grid_get_global_index_from_xy_top( grid , x[p] , y[p] ));
+      }
+    }
+  }
+  test_assert_int_equal( -1 , ecl_grid_get_global_index_from_xy_top( grid , -1000 , -1000 ));
+
+  free( global_list );
+  free( y );
+  free( x );
+}
+
+
+#define NUM_THREADS 4
+#define NUM_THREAD_POINTS 2000
+
+typedef struct {
+  const ecl_grid_type * grid;
+  const double        * x;
+  const double        * y;
+  int                 * i_list;
+  int                 * j_list;
+} query_job_type;
+
+
+static void * query_job_main( void * arg ) {
+  query_job_type * job = arg;
+  for (int k=0; k <= NZ; k++) {
+    for (int p=0; p < NUM_THREAD_POINTS; p++) {
+      int index = k * NUM_THREAD_POINTS + p;
+      if (!ecl_grid_get_ij_from_xy( job->grid , job->x[p] , job->y[p] , k , &job->i_list[index] , &job->j_list[index] )) {
+        job->i_list[index] = -1;
+        job->j_list[index] = -1;
+      }
+    }
+  }
+  return NULL;
+}
+
+
+/*
+  Single point queries from several threads against a fresh grid, so
+  that the search structures are built while other threads are
+  reading them; all threads must get the serial results.
+*/
+
+void test_concurrent_queries( const ecl_grid_type * ref_grid ) {
+  ecl_grid_type * grid = ecl_grid_alloc_regular( NX , NY , NZ , ivec , jvec , kvec , NULL );
+  double * x = util_malloc( NUM_THREAD_POINTS * sizeof * x );
+  double * y = util_malloc( NUM_THREAD_POINTS * sizeof * y );
+  query_job_type jobs[NUM_THREADS];
+
+  random_points( x , y , NUM_THREAD_POINTS );
+  for (int t=0; t < NUM_THREADS; t++) {
+    jobs[t].grid = grid;
+    jobs[t].x = x;
+    jobs[t].y = y;
+    jobs[t].i_list = util_malloc( (NZ + 1) * NUM_THREAD_POINTS * sizeof * jobs[t].i_list );
+    jobs[t].j_list = util_malloc( (NZ + 1) * NUM_THREAD_POINTS * sizeof * jobs[t].j_list );
+  }
+
+#ifdef ERT_HAVE_THREAD_POOL
+  {
+    thread_pool_type * tp = thread_pool_alloc( NUM_THREADS , true );
+    for (int t=0; t < NUM_THREADS; t++)
+      thread_pool_add_job( tp , query_job_main , &jobs[t] );
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+  }
+#else
+  for (int t=0; t < NUM_THREADS; t++)
+    query_job_main( &jobs[t] );
+#endif
+
+  for (int k=0; k <= NZ; k++) {
+    for (int p=0; p < NUM_THREAD_POINTS; p++) {
+      int index = k * NUM_THREAD_POINTS + p;
+      int i = -1 , j = -1;
+      if (!ecl_grid_get_ij_from_xy( ref_grid , x[p] , y[p] , k , &i , &j )) {
+        i = -1;
+        j = -1;
+      }
+      for (int t=0; t < NUM_THREADS; t++) {
+        test_assert_int_equal( i , jobs[t].i_list[index] );
+        test_assert_int_equal( j , jobs[t].j_list[index] );
+      }
+    }
+  }
+
+  for (int t=0; t < NUM_THREADS; t++) {
+    free( jobs[t].i_list );
+    free( jobs[t].j_list );
+  }
+  free( y );
+  free( x );
+  ecl_grid_free( grid );
+}
+
+
+int main(int argc , char ** argv) {
+  ecl_grid_type * grid = ecl_grid_alloc_regular( NX , NY , NZ , ivec , jvec , kvec , NULL );
+  srand( 1 );
+  test_ij( grid );
+  test_global_index( grid );
+  test_concurrent_queries( grid );
+  ecl_grid_free( grid );
+  exit(0);
+}
@@ -57,9 +57,37 @@ void test_float() {
 }
 
 
+void resize_pinned( void * arg ) {
+  ecl_kw_type * kw = arg;
+  ecl_kw_resize( kw , 2 * ecl_kw_get_size( kw ));
+}
+
+
+void test_pin() {
+  ecl_kw_type * kw = ecl_kw_alloc("KW" , 100 , ECL_INT);
+  const int * data = ecl_kw_get_int_ptr( kw );
+
+  test_assert_false( ecl_kw_is_pinned( kw ));
+  ecl_kw_pin( kw );
+  ecl_kw_pin( kw );
+  test_assert_int_equal( 2 , ecl_kw_get_pin_count( kw ));
+  test_assert_util_abort( "ecl_kw_assert_unpinned" , resize_pinned , kw );
+
+  ecl_kw_iset_int( kw , 99 , 77 );
+  ecl_kw_free( kw );
+  test_assert_int_equal( 77 , data[99] );
+
+  ecl_kw_unpin( kw );
+  test_assert_true( ecl_kw_is_pinned( kw ));
+  test_assert_int_equal( 77 , data[99] );
+  ecl_kw_unpin( kw );
+}
+
+
 int main( int argc , char ** argv) {
   test_int();
   test_double();
   test_float();
+  test_pin();
   exit(0);
 }
@@ -0,0 +1,252 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_kw_kernel.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/rng.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_kernel.h>
+
+
+ecl_kw_type * alloc_random_kw( rng_type * rng , int size ) {
+  ecl_kw_type * kw = ecl_kw_alloc( "RANDOM" , size , ECL_DOUBLE );
+  double * data = ecl_kw_get_double_ptr( kw );
+  rng_fill_double( rng , data , size );
+  for (int i=0; i < size; i++)
+    data[i] = (data[i] - 0.25) * 1e6;
+  return kw;
+}
+
+
+/*
+  The sums must be bitwise identical whatever number of threads is
+  used; the parallel size is lowered to make sure the threaded path
+  is exercised.
+*/
+
+void test_sum_reproducible( rng_type * rng ) {
+  const int size = 3 * ECL_KW_KERNEL_SUM_BLOCK + 17;
+  ecl_kw_type * kw = alloc_random_kw( rng , size );
+  const double * data = ecl_kw_get_double_ptr( kw );
+  int_vector_type * index = int_vector_alloc( 0 , 0 );
+  double sum1, sum4, isum1, isum4;
+  long double ref = 0;
+
+  for (int i = size - 1; i >= 0; i -= 3) {
+    int_vector_append( index , i );
+    ref += data[i];
+  }
+
+  ecl_kw_kernel_set_parallel_size( 1000 );
+  ecl_kw_kernel_set_num_threads( 1 );
+  sum1 = ecl_kw_element_sum_float( kw );
+  isum1 = ecl_kw_kernel_sum_indexed_double( data , int_vector_get_const_ptr( index ) , int_vector_size( index ));
+
+  ecl_kw_kernel_set_num_threads( 4 );
+  sum4 = ecl_kw_element_sum_float( kw );
+  isum4 = ecl_kw_kernel_sum_indexed_double( data , int_vector_get_const_ptr( index ) , int_vector_size( index ));
+
+  test_assert_mem_equal( &sum1 , &sum4 , sizeof sum1 );
+  test_assert_mem_equal( &isum1 , &isum4 , sizeof isum1 );
+  test_assert_true( fabs( isum1 - (double) ref ) <= 1e-9 * fabs( (double) ref ));
+
+  ecl_kw_kernel_set_num_threads( 0 );
+  ecl_kw_kernel_set_parallel_size( 0 );
+  int_vector_free( index );
+  ecl_kw_free( kw );
+}
+
+
+void test_float_sum() {
+  /* 2^24 + 1 can not be represented in float; a naive float sum of many ones stalls at 2^24. */
+  const int size = (1 << 24) + 64;
+  float * data = util_calloc( size , sizeof * data );
+  for (int i=0; i < size; i++)
+    data[i] = 1;
+  test_assert_double_equal( ecl_kw_kernel_sum_float( data , size ) , size );
+  free( data );
+}
+
+
+void test_elementwise() {
+  const int size = 1001;
+  ecl_kw_type * kw1 = ecl_kw_alloc( "KW1" , size , ECL_INT );
+  ecl_kw_type * kw2 = ecl_kw_alloc( "KW2" , size , ECL_INT );
+  int_vector_type * index = int_vector_alloc( 0 , 0 );
+
+  for (int i=0; i < size; i++) {
+    ecl_kw_iset_int( kw1 , i , 6*i );
+    ecl_kw_iset_int( kw2 , i , 3 );
+  }
+  for (int i=0; i < size; i += 2)
+    int_vector_append( index , i );
+
+  ecl_kw_kernel_set_parallel_size( 100 );
+  ecl_kw_kernel_set_num_threads( 3 );
+
+  ecl_kw_inplace_add( kw1 , kw2 );
+  ecl_kw_inplace_sub( kw1 , kw2 );
+  ecl_kw_inplace_mul( kw1 , kw2 );
+  ecl_kw_inplace_div( kw1 , kw2 );
+  ecl_kw_scale_int( kw1 , 2 );
+  ecl_kw_shift_int( kw1 , -1 );
+  for (int i=0; i < size; i++)
+    test_assert_int_equal( ecl_kw_iget_int( kw1 , i ) , 12*i - 1 );
+
+  ecl_kw_shift_int( kw1 , 1 );
+  ecl_kw_inplace_div_indexed( kw1 , index , kw2 );
+  for (int i=0; i < size; i++)
+    test_assert_int_equal( ecl_kw_iget_int( kw1 , i ) , (i % 2) ? 12*i : 4*i );
+
+  {
+    int max , min;
+    ecl_kw_iset_int( kw1 , 500 , -7 );
+    ecl_kw_max_min_int( kw1 , &max , &min );
+    test_assert_int_equal( max , 12*999 );
+    test_assert_int_equal( min , -7 );
+  }
+  {
+    int sum;
+    ecl_kw_element_sum_indexed( kw2 , index , &sum );
+    test_assert_int_equal( sum , 3 * int_vector_size( index ));
+    test_assert_int_equal( ecl_kw_element_sum_int( kw2 ) , 3 * size );
+  }
+
+  ecl_kw_kernel_set_num_threads( 0 );
+  ecl_kw_kernel_set_parallel_size( 0 );
+  int_vector_free( index );
+  ecl_kw_free( kw2 );
+  ecl_kw_free( kw1 );
+}
+
+
+void test_gather_scatter() {
+  const int size = 2 * ECL_KW_KERNEL_SUM_BLOCK + 11;
+  int * index = util_calloc( size , sizeof * index );
+  double * src = util_calloc( size , sizeof * src );
+  double * target = util_calloc( size , sizeof * target );
+  char * char_src = util_calloc( size * 9 , sizeof * char_src );
+  char * char_target = util_calloc( size * 9 , sizeof * char_target );
+
+  for (int i=0; i < size; i++) {
+    index[i] = size - 1 - i;
+    src[i] = i;
+    sprintf( &char_src[9*i] , "%08d" , i % 100000000 );
+  }
+
+  ecl_kw_kernel_set_parallel_size( 1000 );
+  ecl_kw_kernel_set_num_threads( 4 );
+
+  ecl_kw_kernel_gather( target , src , sizeof * src , index , size );
+  for (int i=0; i < size; i++)
+    test_assert_double_equal( target[i] , size - 1 - i );
+
+  ecl_kw_kernel_scatter( src , target , sizeof * src , index , size );
+  for (int i=0; i < size; i++)
+    test_assert_double_equal( src[i] , i );
+
+  ecl_kw_kernel_gather( char_target , char_src , 9 , index , size );
+  test_assert_string_equal( &char_target[0] , &char_src[ 9*(size - 1) ] );
+  test_assert_string_equal( &char_target[ 9*(size - 1) ] , &char_src[0] );
+
+  {
+    int * int_src = util_calloc( size , sizeof * int_src );
+    int * int_target = util_calloc( size , sizeof * int_target );
+    void * targets[2] = { int_target , target };
+    const void * srcs[2] = { int_src , src };
+    int element_size[2] = { sizeof * int_src , sizeof * src };
+
+    for (int i=0; i < size; i++)
+      int_src[i] = 2*i;
+
+    ecl_kw_kernel_gather_list( 2 , targets , srcs , element_size , index , size );
+    for (int i=0; i < size; i++) {
+      test_assert_int_equal( int_target[i] , 2*(size - 1 - i) );
+      test_assert_double_equal( target[i] , size - 1 - i );
+    }
+    free( int_target );
+    free( int_src );
+  }
+
+  ecl_kw_kernel_set_num_threads( 0 );
+  ecl_kw_kernel_set_parallel_size( 0 );
+  free( char_target );
+  free( char_src );
+  free( target );
+  free( src );
+  free( index );
+}
+
+
+void test_scatter_copy() {
+  const int size = 2 * ECL_KW_KERNEL_SUM_BLOCK + 11;
+  const int target_size = size / 2 + 1;
+  ecl_kw_type * src_kw = ecl_kw_alloc( "SRC" , size , ECL_INT );
+  int * mapping = util_calloc( size , sizeof * mapping );
+
+  for (int i=0; i < size; i++)
+    ecl_kw_iset_int( src_kw , i , i );
+
+  ecl_kw_kernel_set_parallel_size( 1000 );
+  ecl_kw_kernel_set_num_threads( 4 );
+
+  for (int i=0; i < size; i++)
+    mapping[i] = size - 1 - i;
+  {
+    ecl_kw_type * target_kw = ecl_kw_alloc_scatter_copy( src_kw , size , mapping , NULL );
+    ecl_kw_type * distinct_kw = ecl_kw_alloc_scatter_copy_distinct( src_kw , size , mapping , NULL );
+    for (int i=0; i < size; i++)
+      test_assert_int_equal( ecl_kw_iget_int( target_kw , i ) , size - 1 - i );
+    test_assert_true( ecl_kw_equal( target_kw , distinct_kw ));
+    ecl_kw_free( distinct_kw );
+    ecl_kw_free( target_kw );
+  }
+
+  /* Duplicate targets: the last source element wins. */
+  for (int i=0; i < size; i++)
+    mapping[i] = i / 2;
+  {
+    ecl_kw_type * target_kw = ecl_kw_alloc_scatter_copy( src_kw , target_size , mapping , NULL );
+    for (int i=0; i < target_size; i++)
+      test_assert_int_equal( ecl_kw_iget_int( target_kw , i ) , util_int_min( 2*i + 1 , size - 1 ));
+    ecl_kw_free( target_kw );
+  }
+
+  ecl_kw_kernel_set_num_threads( 0 );
+  ecl_kw_kernel_set_parallel_size( 0 );
+  free( mapping );
+  ecl_kw_free( src_kw );
+}
+
+
+int main( int argc , char ** argv) {
+  rng_type * rng = rng_alloc( XOSHIRO , INIT_DEFAULT );
+  test_sum_reproducible( rng );
+  test_float_sum();
+  test_elementwise();
+  test_gather_scatter();
+  test_scatter_copy();
+  rng_free( rng );
+  exit(0);
+}
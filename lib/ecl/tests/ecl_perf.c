@@ -0,0 +1,199 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_perf.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/thread_pool.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_perf.h>
+
+
+void test_names() {
+  test_assert_int_equal( ECL_PERF_NUM_COUNTERS , ecl_perf_num_counters( ));
+  test_assert_string_equal( "bytes_read" , ecl_perf_counter_name( ECL_PERF_BYTES_READ ));
+  test_assert_string_equal( "cache_miss" , ecl_perf_counter_name( ECL_PERF_CACHE_MISS ));
+}
+
+
+void * add_job( void * arg ) {
+  ecl_perf_add( ECL_PERF_SEEK , 10 );
+  test_assert_int_equal( 10 , ecl_perf_get_thread( ECL_PERF_SEEK ));
+  return NULL;
+}
+
+
+/*
+  The counters of threads which have exited are still part of the
+  total.
+*/
+
+void test_threads() {
+  thread_pool_type * tp = thread_pool_alloc( 4 , true );
+  ecl_perf_reset( );
+  for (int i=0; i < 8; i++)
+    thread_pool_add_job( tp , add_job , NULL );
+  thread_pool_join( tp );
+  thread_pool_free( tp );
+
+  test_assert_int_equal( 80 , ecl_perf_get( ECL_PERF_SEEK ));
+  test_assert_int_equal( 0 , ecl_perf_get_thread( ECL_PERF_SEEK ));
+  ecl_perf_reset( );
+  test_assert_int_equal( 0 , ecl_perf_get( ECL_PERF_SEEK ));
+}
+
+
+void test_io() {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_perf");
+  ecl_kw_type * kw = ecl_kw_alloc( "PRESSURE" , 2000 , ECL_FLOAT );
+  ecl_kw_scalar_set_float_or_double( kw , 1.0 );
+
+  ecl_perf_enable( true );
+  ecl_perf_trace_enable( true );
+  ecl_perf_reset( );
+  {
+    fortio_type * fortio = fortio_open_writer( "FILE.UNRST" , false , true );
+    ecl_kw_fwrite( kw , fortio );
+    fortio_fclose( fortio );
+  }
+#ifdef ERT_HAVE_PERF_COUNTERS
+  test_assert_int_equal( 1 , ecl_perf_get( ECL_PERF_KW_WRITTEN ));
+  /* One header record and two data records with 1000 elements each. */
+  test_assert_int_equal( 3 , ecl_perf_get( ECL_PERF_RECORDS_WRITTEN ));
+  test_assert_true( ecl_perf_get( ECL_PERF_BYTES_WRITTEN ) >= 2000 * 4 );
+#endif
+
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "FILE.UNRST" , 0 );
+    ecl_file_iget_named_kw( ecl_file , "PRESSURE" , 0 );
+    ecl_file_iget_named_kw( ecl_file , "PRESSURE" , 0 );
+#ifdef ERT_HAVE_PERF_COUNTERS
+    test_assert_int_equal( 1 , ecl_perf_get( ECL_PERF_KW_READ ));
+    test_assert_int_equal( 1 , ecl_perf_get( ECL_PERF_CACHE_MISS ));
+    test_assert_int_equal( 1 , ecl_perf_get( ECL_PERF_CACHE_HIT ));
+    test_assert_true( ecl_perf_get( ECL_PERF_BYTES_READ ) >= 2000 * 4 );
+    test_assert_true( ecl_perf_get( ECL_PERF_SEEK ) > 0 );
+#endif
+    ecl_file_close( ecl_file );
+  }
+
+  test_assert_true( ecl_perf_fwrite_json( "perf.json" ));
+  test_assert_true( ecl_perf_fwrite_trace( "trace.json" ));
+  {
+    char * content = util_fread_alloc_file_content( "trace.json" , NULL );
+    test_assert_true( strncmp( content , "{\"traceEvents\": [" , 17 ) == 0 );
+#ifdef ERT_HAVE_PERF_COUNTERS
+    test_assert_not_NULL( strstr( content , "\"ecl_kw_fwrite\"" ));
+    test_assert_not_NULL( strstr( content , "\"arg\": \"PRESSURE\"" ));
+    test_assert_not_NULL( strstr( content , "FILE.UNRST" ));
+#endif
+    free( content );
+  }
+  {
+    char * content = util_fread_alloc_file_content( "perf.json" , NULL );
+    test_assert_not_NULL( strstr( content , "\"kw_written\": " ));
+    free( content );
+  }
+
+  ecl_perf_trace_enable( false );
+  test_assert_true( ecl_perf_enabled( ));
+  ecl_perf_enable( false );
+  test_assert_false( ecl_perf_enabled( ));
+  ecl_perf_reset( );
+  {
+    fortio_type * fortio = fortio_open_writer( "FILE2.UNRST" , false , true );
+    ecl_kw_fwrite( kw , fortio );
+    fortio_fclose( fortio );
+  }
+  test_assert_int_equal( 0 , ecl_perf_get( ECL_PERF_KW_WRITTEN ));
+
+  ecl_kw_free( kw );
+  test_work_area_free( work_area );
+}
+
+
+void test_bytes_written() {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_perf_bytes_written");
+  ecl_kw_type * kw = ecl_kw_alloc( "PRESSURE" , 2000 , ECL_FLOAT );
+  ecl_kw_scalar_set_float_or_double( kw , 1.0 );
+
+  ecl_perf_enable( true );
+  ecl_perf_reset( );
+  {
+    fortio_type * fortio = fortio_open_writer( "FILE.FUNRST" , true , true );
+    ecl_kw_fwrite( kw , fortio );
+    fortio_fclose( fortio );
+  }
+#ifdef ERT_HAVE_PERF_COUNTERS
+  test_assert_int_equal( util_file_size( "FILE.FUNRST" ) , ecl_perf_get( ECL_PERF_BYTES_WRITTEN ));
+#endif
+
+  /* Formatted reads count all the characters of the keyword. */
+  ecl_perf_reset( );
+  {
+    fortio_type * fortio = fortio_open_reader( "FILE.FUNRST" , true , true );
+    ecl_kw_type * read_kw = ecl_kw_fread_alloc( fortio );
+    test_assert_not_NULL( read_kw );
+    ecl_kw_free( read_kw );
+    fortio_fclose( fortio );
+  }
+#ifdef ERT_HAVE_PERF_COUNTERS
+  test_assert_int_equal( util_file_size( "FILE.FUNRST" ) , ecl_perf_get( ECL_PERF_BYTES_READ ));
+#endif
+
+  {
+    fortio_type * fortio = fortio_open_writer( "FILE.UNRST" , false , true );
+    ecl_kw_fwrite( kw , fortio );
+    fortio_fclose( fortio );
+  }
+  ecl_perf_reset( );
+  {
+    fortio_type * src = fortio_open_reader( "FILE.UNRST" , false , true );
+    fortio_type * target = fortio_open_writer( "COPY.UNRST" , false , true );
+    char buffer[1024];
+    bool at_eof;
+
+    /* The header record: 16 bytes of payload and two record markers. */
+    fortio_copy_record( src , target , sizeof buffer , buffer , &at_eof );
+    fortio_fclose( src );
+    fortio_fclose( target );
+  }
+#ifdef ERT_HAVE_PERF_COUNTERS
+  test_assert_int_equal( util_file_size( "COPY.UNRST" ) - 8 , ecl_perf_get( ECL_PERF_BYTES_WRITTEN ));
+#endif
+  ecl_perf_reset( );
+  ecl_perf_enable( false );
+
+  ecl_kw_free( kw );
+  test_work_area_free( work_area );
+}
+
+
+int main(int argc , char ** argv) {
+  test_names();
+  test_threads();
+  test_io();
+  test_bytes_written();
+  exit(0);
+}
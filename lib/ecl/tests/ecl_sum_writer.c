@@ -133,6 +133,60 @@ void test_write_read( ) {
 }
 
 
+void test_export( ) {
+  const char * name = "CASE";
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  int num_dates = 5;
+  int num_ministep = 10;
+  double ministep_length = 36000;
+  test_work_area_type * work_area = test_work_area_alloc("sum/export");
+  ecl_sum_type * ecl_sum;
+
+  write_summary( name , start_time , 10 , 11 , 12 , num_dates , num_ministep , ministep_length);
+  ecl_sum = ecl_sum_fread_alloc_case( name , ":" );
+  {
+    int length = ecl_sum_get_export_length( ecl_sum , false );
+    double * days = util_calloc( length , sizeof * days );
+    int64_t * sim_time = util_calloc( length , sizeof * sim_time );
+    int * report_step = util_calloc( length , sizeof * report_step );
+    double * values = util_calloc( 2 * length , sizeof * values );
+    stringlist_type * keys = stringlist_alloc_new( );
+
+    stringlist_append_copy( keys , "FOPT" );
+    stringlist_append_copy( keys , "WWCT:OP-1" );
+    test_assert_int_equal( length , ecl_sum_get_data_length( ecl_sum ));
+
+    ecl_sum_export_days( ecl_sum , false , days );
+    ecl_sum_export_time( ecl_sum , false , sim_time );
+    ecl_sum_export_report_step( ecl_sum , false , report_step );
+    ecl_sum_export_vectors( ecl_sum , keys , false , values );
+    for (int i=0; i < length; i++) {
+      test_assert_double_equal( days[i] , ecl_sum_iget_sim_days( ecl_sum , i ));
+      test_assert_time_t_equal( sim_time[i] , ecl_sum_iget_sim_time( ecl_sum , i ));
+      test_assert_int_equal( report_step[i] , ecl_sum_iget_report_step( ecl_sum , i ));
+      test_assert_double_equal( values[i] , ecl_sum_get_general_var( ecl_sum , i , "FOPT" ));
+      test_assert_double_equal( values[length + i] , ecl_sum_get_general_var( ecl_sum , i , "WWCT:OP-1" ));
+    }
+
+    test_assert_int_equal( num_dates , ecl_sum_get_export_length( ecl_sum , true ));
+    ecl_sum_export_vector( ecl_sum , "FOPT" , true , values );
+    ecl_sum_export_report_step( ecl_sum , true , report_step );
+    for (int i=0; i < num_dates; i++) {
+      test_assert_int_equal( i + 1 , report_step[i] );
+      test_assert_double_equal( values[i] , ecl_sum_get_general_var( ecl_sum , ecl_sum_iget_report_end( ecl_sum , i + 1 ) , "FOPT" ));
+    }
+
+    stringlist_free( keys );
+    free( values );
+    free( report_step );
+    free( sim_time );
+    free( days );
+  }
+  ecl_sum_free( ecl_sum );
+  test_work_area_free( work_area );
+}
+
+
 void test_ecl_sum_alloc_restart_writer() {
 
    test_work_area_type * work_area = test_work_area_alloc("sum_write_restart");
@@ -211,6 +265,7 @@ void test_long_restart_names() {
 
 int main( int argc , char ** argv) {
   test_write_read();
+  test_export();
   test_ecl_sum_alloc_restart_writer();
   test_long_restart_names();
   exit(0);
@@ -0,0 +1,98 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'eclxx_file.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdexcept>
+#include <numeric>
+
+#include <ert/util/test_util.h>
+#include <ert/util/TestArea.hpp>
+
+#include <ert/ecl/EclKW.hpp>
+#include <ert/ecl/EclFile.hpp>
+#include <ert/ecl/FortIO.hpp>
+
+
+void write_file( const std::string& filename ) {
+    ERT::FortIO fortio( filename, std::ios_base::out );
+    std::vector< double > pressure( 100 );
+    std::iota( pressure.begin(), pressure.end(), 100.0 );
+
+    ERT::EclKW< int > seqnum( "SEQNUM", std::vector< int >{ 1 } );
+    ERT::EclKW< double > kw( "PRESSURE", pressure );
+    seqnum.fwrite( fortio );
+    kw.fwrite( fortio );
+    kw.fwrite( fortio );
+}
+
+
+void test_view() {
+    ERT::TestArea work_area("eclxx_file");
+    write_file( "FILE.UNRST" );
+
+    ERT::EclKWView< double > view = ERT::EclFile( "FILE.UNRST" ).view< double >( "PRESSURE", 1 );
+
+    /* The view is still valid after the file has been closed. */
+    test_assert_size_t_equal( view.size(), 100 );
+    test_assert_double_equal( view[ 99 ], 199 );
+    test_assert_double_equal( std::accumulate( view.begin(), view.end(), 0.0 ), 100 * 149.5 );
+
+    ERT::EclKWView< double > moved( std::move( view ) );
+    test_assert_int_equal( ecl_kw_get_pin_count( moved.get() ), 1 );
+
+    ERT::span< const double > data = moved.data_span();
+    test_assert_double_equal( data.back(), 199 );
+    test_assert_double_equal( data.subspan( 10, 5 ).front(), 110 );
+}
+
+
+void test_file() {
+    ERT::TestArea work_area("eclxx_file");
+    write_file( "FILE.UNRST" );
+
+    ERT::EclFile file( "FILE.UNRST" );
+    test_assert_int_equal( file.size(), 3 );
+    test_assert_int_equal( file.num_named_kw( "PRESSURE" ), 2 );
+    test_assert_true( file.has_kw( "SEQNUM" ));
+    test_assert_true( file.keywords() == std::vector< std::string >({ "SEQNUM", "PRESSURE" }));
+
+    {
+        ERT::EclKW_ref< int > seqnum = file.ref< int >( "SEQNUM" );
+        test_assert_int_equal( seqnum[0], 1 );
+    }
+
+    try {
+        file.view< float >( "PRESSURE" );
+        test_assert_true( false );
+    } catch( const std::invalid_argument& ) {}
+
+    try {
+        file.view< double >( "PRESSURE", 2 );
+        test_assert_true( false );
+    } catch( const std::out_of_range& ) {}
+
+    try {
+        ERT::EclFile missing( "MISSING.UNRST" );
+        test_assert_true( false );
+    } catch( const std::invalid_argument& ) {}
+}
+
+
+int main( int argc , char ** argv) {
+    test_file();
+    test_view();
+}
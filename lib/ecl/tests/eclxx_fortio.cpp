@@ -19,6 +19,7 @@
 
 #include <stdexcept>
 #include <fstream>
+#include <algorithm>
 
 
 #include <ert/util/TestArea.hpp>
@@ -130,8 +131,43 @@ void test_fortio_kw() {
 
 
 
+void test_pread() {
+    ERT::TestArea work_area("fortio_pread");
+    std::vector<int> data;
+    for (size_t i=0; i < 1000; i++)
+        data.push_back(i);
+
+    {
+        ERT::FortIO fortio;
+        fortio.open( "new_file" , std::fstream::out );
+        fortio_fwrite_record( fortio.get() , reinterpret_cast<char *>(data.data()) , 1000 * 4 );
+        fortio.close();
+    }
+
+    {
+        fortio_type * fortio = fortio_open_readwrite( "new_file" , false , true );
+        std::vector<int> data2(1000, 99);
+        offset_type record_size = 1000 * 4 + 8;
+
+        fortio_fseek( fortio , 0 , SEEK_END );
+        fortio_fwrite_record( fortio , reinterpret_cast<char *>(data.data()) , 500 * 4 );
+
+        /* Unflushed data is visible; the data starts after the 4 byte header. */
+        test_assert_true( fortio_pread( fortio , record_size + 4 , data2.data() , 500 * 4 ) );
+        test_assert_true( std::equal( data2.begin() , data2.begin() + 500 , data.begin() ));
+        test_assert_true( fortio_pread( fortio , 4 , data2.data() , 1000 * 4 ) );
+        test_assert_true( data == data2 );
+        test_assert_true( fortio_ftell( fortio ) == record_size + 500 * 4 + 8 );
+        data2.resize( 2000 );
+        test_assert_false( fortio_pread( fortio , 4 , data2.data() , 2000 * 4 ) );
+        fortio_fclose( fortio );
+    }
+}
+
+
 int main(int argc , char ** argv) {
     test_open();
+    test_pread();
     test_fortio();
     test_fortio_kw();
 }
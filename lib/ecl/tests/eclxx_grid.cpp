@@ -0,0 +1,86 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'eclxx_grid.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <vector>
+#include <stdexcept>
+
+#include <ert/util/test_util.h>
+
+#include <ert/ecl/EclGrid.hpp>
+
+
+void test_iterate() {
+    const int nx = 4, ny = 3, nz = 2;
+    std::vector< int > actnum( nx * ny * nz, 1 );
+    actnum[0] = 0;
+    actnum[nx * ny + 5] = 0;
+
+    ERT::EclGrid grid( ecl_grid_alloc_rectangular( nx, ny, nz, 1, 2, 3, actnum.data() ));
+    test_assert_int_equal( grid.global_size(), nx * ny * nz );
+    test_assert_int_equal( grid.active_size(), nx * ny * nz - 2 );
+
+    {
+        int count = 0;
+        int num_active = 0;
+        for( const auto& cell : grid.cells() ) {
+            test_assert_int_equal( cell.global.value, count );
+            test_assert_true( grid.global_index( cell.i, cell.j, cell.k ) == cell.global );
+            test_assert_true( cell.is_active() == ( actnum[ count ] == 1 ));
+            if( cell.is_active() )
+                num_active++;
+            count++;
+        }
+        test_assert_int_equal( count, grid.global_size() );
+        test_assert_int_equal( num_active, grid.active_size() );
+    }
+
+    {
+        int count = 0;
+        double volume = 0;
+        for( const auto& cell : grid.active_cells() ) {
+            test_assert_int_equal( cell.active.value, count );
+            test_assert_true( grid.global_index( cell.active ) == cell.global );
+            test_assert_true( grid.active_index( cell.global ) == cell.active );
+            volume += grid.cell_volume( cell.active );
+            count++;
+        }
+        test_assert_int_equal( count, grid.active_size() );
+        test_assert_double_equal( volume, 6.0 * grid.active_size() );
+    }
+
+    {
+        auto pos = grid.xyz( grid.global_index( 1, 1, 1 ));
+        test_assert_double_equal( pos[0], 1.5 );
+        test_assert_double_equal( pos[1], 3.0 );
+        test_assert_double_equal( pos[2], 4.5 );
+    }
+}
+
+
+void test_move() {
+    ERT::EclGrid grid1( ecl_grid_alloc_rectangular( 2, 2, 2, 1, 1, 1, NULL ));
+    ERT::EclGrid grid2( std::move( grid1 ));
+    test_assert_true( grid1.get() == nullptr );
+    test_assert_int_equal( grid2.active_size(), 8 );
+}
+
+
+int main( int argc , char ** argv) {
+    test_iterate();
+    test_move();
+}
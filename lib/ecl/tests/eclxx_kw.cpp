@@ -67,6 +67,13 @@ void test_kw_vector_string() {
     test_assert_string_equal( kw.at( 2 ), vec.at( 2 ) );
     test_assert_string_equal( kw.at( 3 ), "verylong" );
     test_assert_string_not_equal( kw.at( 2 ), "verylongkeyword" );
+
+    {
+        ERT::EclKWView< const char* > view( kw.get() );
+        test_assert_true( ecl_kw_is_pinned( kw.get() ));
+        test_assert_string_equal( view.at( 1 ), "sweet   " );
+    }
+    test_assert_false( ecl_kw_is_pinned( kw.get() ));
 }
 
 void test_move_semantics_no_crash() {
@@ -97,6 +104,25 @@ void test_resize() {
 }
 
 
+void test_span() {
+    ERT::EclKW< float > kw( "XYZ", std::vector< float >{ 1, 2, 3, 4 } );
+    float sum = 0;
+    for( float v : kw )
+        sum += v;
+    test_assert_float_equal( sum, 10 );
+
+    ERT::span< float > data = kw.data_span();
+    data[ 3 ] = 8;
+    test_assert_float_equal( kw.at( 3 ), 8 );
+
+    {
+        ERT::EclKWView< float > view( kw.get() );
+        test_assert_true( ecl_kw_is_pinned( kw.get() ));
+        test_assert_float_equal( view[ 3 ], 8 );
+    }
+    test_assert_false( ecl_kw_is_pinned( kw.get() ));
+}
+
 int main (int argc, char **argv) {
     test_kw_name();
     test_kw_vector_assign();
@@ -104,5 +130,6 @@ int main (int argc, char **argv) {
     test_move_semantics_no_crash();
     test_exception_assing_ref_wrong_type();
     test_resize();
+    test_span();
 }
 
@@ -0,0 +1,83 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'eclxx_sum.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdexcept>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/TestArea.hpp>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_sum_tstep.h>
+#include <ert/ecl/EclSum.hpp>
+
+
+void write_case( const char * name ) {
+    ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , false , true , ":" , util_make_date_utc( 1 , 1 , 2010 ) , true , 10 , 10 , 10 );
+    smspec_node_type * fopt = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0 );
+    smspec_node_type * wopr = ecl_sum_add_var( ecl_sum , "WOPR" , "OP_1" , 0 , "SM3/DAY" , 0 );
+
+    for (int report_step = 1; report_step <= 10; report_step++) {
+        for (int step = 0; step < 2; step++) {
+            double days = 2 * (report_step - 1) + step + 1;
+            ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , report_step , days * 86400 );
+            ecl_sum_tstep_set_from_node( tstep , fopt , 10 * days );
+            ecl_sum_tstep_set_from_node( tstep , wopr , days );
+        }
+    }
+    ecl_sum_fwrite( ecl_sum );
+    ecl_sum_free( ecl_sum );
+}
+
+
+void test_columns() {
+    ERT::TestArea work_area("eclxx_sum");
+    write_case( "CASE" );
+
+    ERT::EclSum sum( "CASE" );
+    test_assert_size_t_equal( sum.size(), 20 );
+    test_assert_true( sum.has_key( "WOPR:OP_1" ));
+    test_assert_true( sum.keys( "W*" ) == std::vector< std::string >({ "WOPR:OP_1" }));
+
+    auto days = sum.days();
+    auto fopt = sum.column( "FOPT" );
+    auto wopr = sum.column( "WOPR:OP_1" );
+    test_assert_size_t_equal( fopt.size(), 20 );
+    for (size_t i = 0; i < sum.size(); i++) {
+        test_assert_double_equal( days[i], i + 1 );
+        test_assert_double_equal( fopt[i], 10 * days[i] );
+        test_assert_double_equal( wopr[i], days[i] );
+    }
+    test_assert_true( sum.time()[1] - sum.time()[0] == 86400 );
+
+    /* Repeated lookups are served from the cache. */
+    test_assert_true( sum.column( "FOPT" ).data() == fopt.data() );
+
+    ERT::EclSum moved( std::move( sum ));
+    test_assert_true( moved.column( "FOPT" ).data() == fopt.data() );
+
+    try {
+        moved.column( "FWPR" );
+        test_assert_true( false );
+    } catch( const std::out_of_range& ) {}
+}
+
+
+int main( int argc , char ** argv) {
+    test_columns();
+}
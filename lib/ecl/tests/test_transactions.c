@@ -105,9 +105,57 @@ void test_transaction() {
 }
 
 
+void test_pinned() {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_pinned");
+  {
+    fortio_type * fortio = fortio_open_writer("data_file", false, ECL_ENDIAN_FLIP);
+    ecl_kw_type * kw = ecl_kw_alloc("TEST_KW", 1000, ECL_FLOAT);
+    for (int i = 0; i < 1000; i++)
+      ecl_kw_iset_float(kw, i, 0.25 * i);
+    ecl_kw_fwrite(kw, fortio);
+    fortio_fclose(fortio);
+    ecl_kw_free(kw);
+  }
+  {
+    ecl_file_type * file = ecl_file_open("data_file", 0);
+    ecl_file_view_type * file_view = ecl_file_get_global_view(file);
+    ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( file_view , 0);
+    ecl_kw_type * pinned;
+    const float * data;
+
+    ecl_file_transaction_type * t = ecl_file_view_start_transaction( file_view );
+      pinned = ecl_file_view_iget_named_pinned_kw( file_view , "TEST_KW" , 0 );
+      data = ecl_kw_get_float_ptr( pinned );
+      test_assert_true( ecl_file_kw_is_pinned( file_kw ));
+    ecl_file_view_end_transaction( file_view , t );
+
+    /*
+       The keyword is released from the file when the transaction
+       ends, but the pinned data stays valid until it is unpinned.
+    */
+    test_assert_NULL( ecl_file_kw_get_kw_ptr( file_kw ));
+    test_assert_false( ecl_file_kw_is_pinned( file_kw ));
+    test_assert_float_equal( 0.25 * 999 , data[999] );
+
+    /* A new lookup loads a fresh copy. */
+    {
+      ecl_kw_type * kw = ecl_file_view_iget_named_kw( file_view , "TEST_KW" , 0 );
+      test_assert_true( kw != pinned );
+      test_assert_float_equal( 0.25 * 999 , ecl_kw_iget_float( kw , 999 ));
+    }
+
+    /* ... and the pinned data outlives the file. */
+    ecl_file_close(file);
+    test_assert_float_equal( 0.25 * 999 , data[999] );
+    ecl_kw_unpin( pinned );
+  }
+  test_work_area_free( work_area );
+}
+
 
 int main( int argc , char ** argv) {
   util_install_signals();
   test_transaction();
+  test_pinned();
   exit(0);
 }
@@ -20,6 +20,7 @@
 #include <string.h>
 
 #include <ert/util/util.h>
+#include <ert/util/arena.h>
 #include <ert/util/type_macros.h>
 
 #include <ert/ecl/ecl_kw.h>
@@ -90,9 +91,14 @@ UTIL_IS_INSTANCE_FUNCTION( well_conn , WELL_CONN_TYPE_ID)
 UTIL_SAFE_CAST_FUNCTION( well_conn , WELL_CONN_TYPE_ID)
 
 
-static well_conn_type * well_conn_alloc__( int i , int j , int k , double connection_factor , well_conn_dir_enum dir , bool open, int segment_id, bool matrix_connection) {
+static well_conn_type * well_conn_alloc__( arena_type * arena , int i , int j , int k , double connection_factor , well_conn_dir_enum dir , bool open, int segment_id, bool matrix_connection) {
   if (well_conn_assert_direction( dir , matrix_connection)) {
-    well_conn_type * conn = util_malloc( sizeof * conn );
+    well_conn_type * conn;
+    if (arena)
+      conn = arena_malloc( arena , sizeof * conn );
+    else
+      conn = util_malloc( sizeof * conn );
+
     UTIL_TYPE_ID_INIT( conn , WELL_CONN_TYPE_ID );
     conn->i = i;
     conn->j = j;
@@ -121,25 +127,25 @@ static well_conn_type * well_conn_alloc__( int i , int j , int k , double connec
 
 
 well_conn_type * well_conn_alloc( int i , int j , int k , double connection_factor , well_conn_dir_enum dir , bool open) {
-  return well_conn_alloc__(i , j , k , connection_factor , dir , open , WELL_CONN_NORMAL_WELL_SEGMENT_ID , true );
+  return well_conn_alloc__(NULL , i , j , k , connection_factor , dir , open , WELL_CONN_NORMAL_WELL_SEGMENT_ID , true );
 }
 
 
 
 well_conn_type * well_conn_alloc_MSW( int i , int j , int k , double connection_factor , well_conn_dir_enum dir , bool open, int segment_id) {
-  return well_conn_alloc__(i , j , k , connection_factor , dir , open , segment_id , true );
+  return well_conn_alloc__(NULL , i , j , k , connection_factor , dir , open , segment_id , true );
 }
 
 
 
 well_conn_type * well_conn_alloc_fracture( int i , int j , int k , double connection_factor , well_conn_dir_enum dir , bool open) {
-  return well_conn_alloc__(i , j , k , connection_factor , dir , open , WELL_CONN_NORMAL_WELL_SEGMENT_ID , false);
+  return well_conn_alloc__(NULL , i , j , k , connection_factor , dir , open , WELL_CONN_NORMAL_WELL_SEGMENT_ID , false);
 }
 
 
 
 well_conn_type * well_conn_alloc_fracture_MSW( int i , int j , int k , double connection_factor , well_conn_dir_enum dir , bool open, int segment_id) {
-  return well_conn_alloc__(i , j , k , connection_factor , dir , open , segment_id , false);
+  return well_conn_alloc__(NULL , i , j , k , connection_factor , dir , open , segment_id , false);
 }
 
 
@@ -148,13 +154,17 @@ well_conn_type * well_conn_alloc_fracture_MSW( int i , int j , int k , double co
 /*
   Observe that the (ijk) and branch values are shifted to zero offset to be
   aligned with the rest of the ert libraries.
+
+  When the arena argument is non NULL the connection is allocated from
+  the arena, and must not be freed with well_conn_free().
 */
-well_conn_type * well_conn_alloc_from_kw( const ecl_kw_type * icon_kw ,
-                                          const ecl_kw_type * scon_kw ,
-                                          const ecl_kw_type * xcon_kw ,
-                                          const ecl_rsthead_type * header ,
-                                          int well_nr ,
-                                          int conn_nr ) {
+well_conn_type * well_conn_alloc_from_kw_arena( arena_type * arena ,
+                                                const ecl_kw_type * icon_kw ,
+                                                const ecl_kw_type * scon_kw ,
+                                                const ecl_kw_type * xcon_kw ,
+                                                const ecl_rsthead_type * header ,
+                                                int well_nr ,
+                                                int conn_nr ) {
 
   const int icon_offset = header->niconz * ( header->ncwmax * well_nr + conn_nr );
   int IC = ecl_kw_iget_int( icon_kw , icon_offset + ICON_IC_INDEX );
@@ -223,7 +233,7 @@ well_conn_type * well_conn_alloc_from_kw( const ecl_kw_type * icon_kw ,
     }
 
     int segment_id = ecl_kw_iget_int( icon_kw , icon_offset + ICON_SEGMENT_INDEX ) - ECLIPSE_WELL_SEGMENT_OFFSET + WELL_SEGMENT_OFFSET;
-    conn = well_conn_alloc__(i,j,k,connection_factor,dir,open,segment_id,matrix_connection);
+    conn = well_conn_alloc__(arena,i,j,k,connection_factor,dir,open,segment_id,matrix_connection);
 
     if (xcon_kw) {
       const int xcon_offset = header->nxconz * (header->ncwmax * well_nr + conn_nr);
@@ -247,6 +257,16 @@ well_conn_type * well_conn_alloc_from_kw( const ecl_kw_type * icon_kw ,
 }
 
 
+well_conn_type * well_conn_alloc_from_kw( const ecl_kw_type * icon_kw ,
+                                          const ecl_kw_type * scon_kw ,
+                                          const ecl_kw_type * xcon_kw ,
+                                          const ecl_rsthead_type * header ,
+                                          int well_nr ,
+                                          int conn_nr ) {
+  return well_conn_alloc_from_kw_arena( NULL , icon_kw , scon_kw , xcon_kw , header , well_nr , conn_nr );
+}
+
+
 void well_conn_free( well_conn_type * conn) {
   free( conn );
 }
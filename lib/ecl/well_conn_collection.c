@@ -19,6 +19,7 @@
 #include <stdbool.h>
 
 #include <ert/util/util.h>
+#include <ert/util/arena.h>
 #include <ert/util/type_macros.h>
 #include <ert/util/vector.h>
 
@@ -35,6 +36,7 @@
 struct well_conn_collection_struct {
   UTIL_TYPE_ID_DECLARATION;
   vector_type * connection_list;
+  arena_type  * arena;            /* Not owned - connections loaded from file are allocated here when != NULL. */
 };
 
 
@@ -43,9 +45,22 @@ static UTIL_SAFE_CAST_FUNCTION( well_conn_collection , WELL_CONN_COLLECTION_TYPE
 
 
 well_conn_collection_type * well_conn_collection_alloc() {
+  return well_conn_collection_alloc_arena( NULL );
+}
+
+
+/*
+  The connections created by well_conn_collection_load_from_kw() will
+  be allocated from the arena, which must outlive the collection. This
+  is used by the well_state, which owns one arena for all its
+  connections.
+*/
+
+well_conn_collection_type * well_conn_collection_alloc_arena( arena_type * arena ) {
   well_conn_collection_type * wellcc = util_malloc( sizeof * wellcc );
   UTIL_TYPE_ID_INIT( wellcc , WELL_CONN_COLLECTION_TYPE_ID );
   wellcc->connection_list = vector_alloc_new();
+  wellcc->arena = arena;
   return wellcc;
 }
 
@@ -113,9 +128,13 @@ int well_conn_collection_load_from_kw( well_conn_collection_type * wellcc ,
   int iconn;
 
   for (iconn = 0; iconn < num_connections; iconn++) {
-    well_conn_type * conn = well_conn_alloc_from_kw( icon_kw , scon_kw, xcon_kw, rst_head , iwell , iconn );
-    if (conn)
-      well_conn_collection_add( wellcc , conn );
+    well_conn_type * conn = well_conn_alloc_from_kw_arena( wellcc->arena , icon_kw , scon_kw, xcon_kw, rst_head , iwell , iconn );
+    if (conn) {
+      if (wellcc->arena)
+        well_conn_collection_add_ref( wellcc , conn );
+      else
+        well_conn_collection_add( wellcc , conn );
+    }
   }
   return num_connections;
 
@@ -297,7 +297,8 @@ void well_info_add_wells( well_info_type * well_info , ecl_file_type * rst_file
 /**
    Observe that this function will fail if the rst_file instance
    corresponds to a non-unified restart file, because these files do
-   not have the SEQNUM keyword.
+   not have the SEQNUM keyword. A set of non-unified restart files
+   opened with ecl_file_open_restart_set() does have SEQNUM keywords.
 */
 
 void well_info_add_UNRST_wells2( well_info_type * well_info , ecl_file_view_type * rst_view, bool load_segment_information) {
@@ -341,7 +342,7 @@ void well_info_load_rst_eclfile( well_info_type * well_info , ecl_file_type * ec
   ecl_file_enum file_type = ecl_util_get_file_type( filename , NULL , &report_nr);
   if ((file_type == ECL_RESTART_FILE) || (file_type == ECL_UNIFIED_RESTART_FILE))
   {
-    if (file_type == ECL_RESTART_FILE)
+    if ((file_type == ECL_RESTART_FILE) && !ecl_file_has_kw( ecl_file , SEQNUM_KW ))
       well_info_add_wells( well_info , ecl_file , report_nr , load_segment_information );
     else
       well_info_add_UNRST_wells( well_info , ecl_file , load_segment_information );
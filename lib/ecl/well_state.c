@@ -26,6 +26,7 @@
 #include <stdbool.h>
 
 #include <ert/util/util.h>
+#include <ert/util/arena.h>
 #include <ert/util/vector.h>
 #include <ert/util/hash.h>
 #include <ert/util/int_vector.h>
@@ -185,6 +186,7 @@ struct well_state_struct {
 
   vector_type    * index_wellhead;   // An well_conn_type instance representing the wellhead - indexed by grid_nr.
   hash_type      * name_wellhead;    // An well_conn_type instance representing the wellhead - indexed by lgr_name.
+  arena_type     * arena;            // The connections loaded from the restart file are allocated here.
 };
 
 
@@ -205,6 +207,7 @@ well_state_type * well_state_alloc(const char * well_name , int global_well_nr ,
   well_state->type = type;
   well_state->global_well_nr = global_well_nr;
   well_state->connections = hash_alloc();
+  well_state->arena = arena_alloc( 0 );
   well_state->segments = well_segment_collection_alloc();
   well_state->branches = well_branch_collection_alloc();
   well_state->is_MSW_well = false;
@@ -413,7 +416,7 @@ static void well_state_add_connections__( well_state_type * well_state ,
   well_state_add_wellhead( well_state , header , iwel_kw , well_nr , grid_name , grid_nr );
 
   if (!well_state_has_grid_connections( well_state , grid_name ))
-    hash_insert_hash_owned_ref( well_state->connections , grid_name, well_conn_collection_alloc( ) , well_conn_collection_free__ );
+    hash_insert_hash_owned_ref( well_state->connections , grid_name, well_conn_collection_alloc_arena( well_state->arena ) , well_conn_collection_free__ );
 
   {
     ecl_kw_type * scon_kw = NULL;
@@ -612,6 +615,7 @@ void well_state_free( well_state_type * well ) {
   hash_free( well->connections );
   well_segment_collection_free( well->segments );
   well_branch_collection_free( well->branches );
+  arena_free( well->arena );
 
   free( well->name );
   free( well );
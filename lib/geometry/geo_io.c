@@ -0,0 +1,396 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'geo_io.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <ctype.h>
+
+#include <ert/util/util.h>
+
+#include <ert/geometry/geo_io.h>
+
+/*
+  Buffered reading and writing of the whitespace separated numbers
+  found in the ASCII surface and polygon formats. The stdio functions
+  fscanf("%lg") and fprintf("%12.4f") go through the full format
+  string and locale machinery for every value, which dominates the
+  time when loading or writing large surfaces.
+
+  The reader fills a large buffer with fread() and parses the numbers
+  in place. Decimal numbers with at most 19 significant digits and a
+  moderate exponent are converted exactly with one multiplication or
+  division (both operands are exactly representable, so the result is
+  correctly rounded); everything else - long mantissas, large
+  exponents, nan / inf, hex floats - is passed on to strtod(). The
+  result is therefor identical to fscanf("%lg").
+
+  The writer formats fixed point numbers through a scaled integer;
+  values which are too large, or which are so close to a rounding tie
+  that the scaling could change the rounding, are formatted with
+  snprintf(). The output is identical to fprintf("%*.*f").
+*/
+
+#define READ_BUFFER_SIZE   (1024*1024)
+#define READ_LOOKAHEAD     256
+#define WRITE_BUFFER_SIZE  (1024*1024)
+#define WRITE_MAX_ITEM     GEO_IO_FORMAT_BUFFER_SIZE
+
+struct geo_io_reader_struct {
+  FILE   * stream;
+  char   * buffer;
+  size_t   pos;
+  size_t   size;
+  bool     eof;
+};
+
+
+struct geo_io_writer_struct {
+  FILE   * stream;
+  char   * buffer;
+  size_t   size;
+};
+
+
+static const double exact_pow10[] = { 1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 , 1e6 , 1e7 , 1e8 , 1e9 , 1e10 ,
+                                      1e11 , 1e12 , 1e13 , 1e14 , 1e15 , 1e16 , 1e17 , 1e18 , 1e19 , 1e20 ,
+                                      1e21 , 1e22 };
+
+
+geo_io_reader_type * geo_io_reader_alloc( FILE * stream ) {
+  geo_io_reader_type * reader = util_malloc( sizeof * reader );
+  reader->stream = stream;
+  reader->buffer = util_malloc( READ_BUFFER_SIZE + 1 );
+  reader->pos = 0;
+  reader->size = 0;
+  reader->eof = false;
+  reader->buffer[0] = '\0';
+  return reader;
+}
+
+
+void geo_io_reader_free( geo_io_reader_type * reader ) {
+  free( reader->buffer );
+  free( reader );
+}
+
+
+/*
+  Makes sure that at least READ_LOOKAHEAD bytes are available in the
+  buffer, unless the end of the file has been reached. The buffer is
+  always '\0' terminated, so strtod() can be used directly on it.
+*/
+
+static void geo_io_reader_fill( geo_io_reader_type * reader ) {
+  if (reader->eof || (reader->size - reader->pos >= READ_LOOKAHEAD))
+    return;
+
+  {
+    size_t remaining = reader->size - reader->pos;
+    size_t bytes_read;
+
+    memmove( reader->buffer , &reader->buffer[ reader->pos ] , remaining );
+    reader->pos = 0;
+    reader->size = remaining;
+
+    bytes_read = fread( &reader->buffer[ reader->size ] , 1 , READ_BUFFER_SIZE - reader->size , reader->stream );
+    reader->size += bytes_read;
+    if (bytes_read == 0)
+      reader->eof = true;
+
+    reader->buffer[ reader->size ] = '\0';
+  }
+}
+
+
+static bool is_space( char c ) {
+  return (c == ' ') || (c == '\n') || (c == '\t') || (c == '\r') || (c == '\v') || (c == '\f');
+}
+
+
+static void geo_io_reader_skip_space( geo_io_reader_type * reader ) {
+  while (true) {
+    while ((reader->pos < reader->size) && is_space( reader->buffer[ reader->pos ] ))
+      reader->pos++;
+
+    if (reader->pos < reader->size)
+      break;
+
+    geo_io_reader_fill( reader );
+    if (reader->pos == reader->size)
+      break;
+  }
+  geo_io_reader_fill( reader );
+}
+
+
+/*
+  Returns true if there is nothing but whitespace left in the file.
+*/
+
+bool geo_io_reader_at_eof( geo_io_reader_type * reader ) {
+  geo_io_reader_skip_space( reader );
+  return (reader->pos == reader->size);
+}
+
+
+static bool geo_io_parse_double( const char * s , const char ** end , double * value ) {
+  const char * p = s;
+  bool negative = false;
+  uint64_t mantissa = 0;
+  int num_digits = 0;
+  int exp10 = 0;
+  bool any_digit = false;
+
+  if ((*p == '-') || (*p == '+')) {
+    negative = (*p == '-');
+    p++;
+  }
+
+  while (*p == '0') {
+    any_digit = true;
+    p++;
+  }
+
+  while ((*p >= '0') && (*p <= '9')) {
+    if (num_digits == 19)
+      return false;
+    mantissa = 10*mantissa + (*p - '0');
+    num_digits++;
+    any_digit = true;
+    p++;
+  }
+
+  if (*p == '.') {
+    p++;
+    if (num_digits == 0) {
+      while (*p == '0') {
+        exp10--;
+        any_digit = true;
+        p++;
+      }
+    }
+
+    while ((*p >= '0') && (*p <= '9')) {
+      if (num_digits == 19)
+        return false;
+      mantissa = 10*mantissa + (*p - '0');
+      num_digits++;
+      exp10--;
+      any_digit = true;
+      p++;
+    }
+  }
+
+  if (!any_digit)
+    return false;
+
+  if ((*p == 'e') || (*p == 'E')) {
+    const char * q = p + 1;
+    bool exp_negative = false;
+    int exp_value = 0;
+
+    if ((*q == '-') || (*q == '+')) {
+      exp_negative = (*q == '-');
+      q++;
+    }
+
+    if ((*q < '0') || (*q > '9'))
+      return false;
+
+    while ((*q >= '0') && (*q <= '9')) {
+      if (exp_value > 1000)
+        return false;
+      exp_value = 10*exp_value + (*q - '0');
+      q++;
+    }
+    exp10 += exp_negative ? -exp_value : exp_value;
+    p = q;
+  }
+
+  /* Characters like 'x' (hex), 'n' (nan) or 'd' must be left to strtod(). */
+  if (isalpha( (unsigned char) *p ) || (*p == '.'))
+    return false;
+
+  if (mantissa > (UINT64_C(1) << 53))
+    return false;
+
+  if ((exp10 < -22) || (exp10 > 22))
+    return false;
+
+  {
+    double v = (double) mantissa;
+    if (exp10 < 0)
+      v /= exact_pow10[ -exp10 ];
+    else
+      v *= exact_pow10[ exp10 ];
+
+    *value = negative ? -v : v;
+  }
+  *end = p;
+  return true;
+}
+
+
+/*
+  Reads the next number; returns false at the end of the file, or if
+  the next token is not a number - as fscanf() would.
+*/
+
+bool geo_io_reader_read_double( geo_io_reader_type * reader , double * value ) {
+  geo_io_reader_skip_space( reader );
+  if (reader->pos == reader->size)
+    return false;
+
+  {
+    const char * s = &reader->buffer[ reader->pos ];
+    const char * end;
+
+    if (!geo_io_parse_double( s , &end , value )) {
+      char * strtod_end;
+      *value = strtod( s , &strtod_end );
+      if (strtod_end == s)
+        return false;
+      end = strtod_end;
+    }
+
+    reader->pos += end - s;
+  }
+  return true;
+}
+
+/*****************************************************************/
+
+geo_io_writer_type * geo_io_writer_alloc( FILE * stream ) {
+  geo_io_writer_type * writer = util_malloc( sizeof * writer );
+  writer->stream = stream;
+  writer->buffer = util_malloc( WRITE_BUFFER_SIZE );
+  writer->size = 0;
+  return writer;
+}
+
+
+void geo_io_writer_flush( geo_io_writer_type * writer ) {
+  if (writer->size > 0) {
+    if (fwrite( writer->buffer , 1 , writer->size , writer->stream ) != writer->size)
+      util_abort("%s: write failed \n",__func__);
+    writer->size = 0;
+  }
+}
+
+
+void geo_io_writer_free( geo_io_writer_type * writer ) {
+  geo_io_writer_flush( writer );
+  free( writer->buffer );
+  free( writer );
+}
+
+
+static void geo_io_writer_reserve( geo_io_writer_type * writer , size_t bytes ) {
+  if (writer->size + bytes > WRITE_BUFFER_SIZE)
+    geo_io_writer_flush( writer );
+}
+
+
+void geo_io_writer_puts( geo_io_writer_type * writer , const char * s ) {
+  size_t length = strlen( s );
+  if (length > WRITE_MAX_ITEM) {
+    geo_io_writer_flush( writer );
+    fputs( s , writer->stream );
+  } else {
+    geo_io_writer_reserve( writer , length );
+    memcpy( &writer->buffer[ writer->size ] , s , length );
+    writer->size += length;
+  }
+}
+
+
+/*
+  Formats @value as snprintf( buffer , "%*.*f" , width , decimals ,
+  value) would, and returns the number of characters written. The
+  buffer must have room for GEO_IO_FORMAT_BUFFER_SIZE characters.
+*/
+
+int geo_io_format_fixed( char * buffer , double value , int width , int decimals ) {
+  if (isfinite( value ) && (decimals >= 0) && (decimals <= 8) && (width < 32)) {
+    double scaled = fabs( value ) * exact_pow10[ decimals ];
+
+    /*
+      Below 2^40 the error in scaled is less than 2^-13; if the
+      fractional part is not within 1e-3 of 0.5 the rounding below is
+      the same as for the exact decimal value.
+    */
+    if (scaled < 1099511627776.0) {
+      double floor_scaled = floor( scaled );
+      double frac = scaled - floor_scaled;
+
+      if (fabs( frac - 0.5 ) > 1e-3) {
+        uint64_t ivalue = (uint64_t) floor_scaled + ((frac > 0.5) ? 1 : 0);
+        char digits[32];
+        int num_digits = 0;
+        int length;
+        int pos = 0;
+
+        do {
+          digits[ num_digits++ ] = '0' + (char) (ivalue % 10);
+          ivalue /= 10;
+        } while (ivalue > 0 || num_digits <= decimals);
+
+        /* sign + integer digits + '.' + decimals; the '.' is dropped for zero decimals. */
+        length = (signbit( value ) ? 1 : 0) + num_digits + ((decimals > 0) ? 1 : 0);
+        while (pos < width - length)
+          buffer[ pos++ ] = ' ';
+
+        if (signbit( value ))
+          buffer[ pos++ ] = '-';
+
+        while (num_digits > decimals)
+          buffer[ pos++ ] = digits[ --num_digits ];
+
+        if (decimals > 0) {
+          buffer[ pos++ ] = '.';
+          while (num_digits > 0)
+            buffer[ pos++ ] = digits[ --num_digits ];
+        }
+
+        buffer[ pos ] = '\0';
+        return pos;
+      }
+    }
+  }
+
+  return snprintf( buffer , WRITE_MAX_ITEM , "%*.*f" , width , decimals , value );
+}
+
+
+void geo_io_writer_fixed( geo_io_writer_type * writer , double value , int width , int decimals ) {
+  geo_io_writer_reserve( writer , WRITE_MAX_ITEM );
+  {
+    char tmp[ WRITE_MAX_ITEM ];
+    int length = geo_io_format_fixed( tmp , value , width , decimals );
+
+    if (length >= WRITE_MAX_ITEM)
+      util_abort("%s: formatted value too long \n",__func__);
+
+    memcpy( &writer->buffer[ writer->size ] , tmp , length );
+    writer->size += length;
+  }
+}
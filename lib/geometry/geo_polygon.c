@@ -27,6 +27,7 @@
 
 #include <ert/geometry/geo_util.h>
 #include <ert/geometry/geo_polygon.h>
+#include <ert/geometry/geo_io.h>
 
 
 
@@ -110,9 +111,12 @@ static geo_polygon_type * geo_polygon_fload_alloc_xyz( const char * filename , b
   geo_polygon_type * polygon = geo_polygon_alloc( filename );
   {
     FILE * stream = util_fopen( filename , "r");
+    geo_io_reader_type * reader = geo_io_reader_alloc( stream );
     double x , y , z;
     while (true) {
-      if (fscanf(stream , "%lg %lg %lg" , &x, &y , &z) == 3) {
+      if (geo_io_reader_read_double( reader , &x ) &&
+          geo_io_reader_read_double( reader , &y ) &&
+          geo_io_reader_read_double( reader , &z )) {
         if (stop_on_999 && (x == 999) && (y == 999) && (z == 999))
           break;
 
@@ -121,6 +125,7 @@ static geo_polygon_type * geo_polygon_fload_alloc_xyz( const char * filename , b
         break;
     }
 
+    geo_io_reader_free( reader );
     fclose( stream );
 
     if ((double_vector_size( polygon->xcoord ) > 1) && (skip_last_point)) {
@@ -156,6 +161,42 @@ geo_polygon_type * geo_polygon_fload_alloc_irap( const char * filename ) {
 
 
 
+/*
+  Writes the polygon in the irap format described above; the z
+  coordinate is written as zero, the polygon is closed and the
+  (999,999,999) terminator is appended.
+*/
+
+static void geo_polygon_fprintf_irap_point( geo_io_writer_type * writer , double x , double y) {
+  geo_io_writer_fixed( writer , x , 14 , 4 );
+  geo_io_writer_puts( writer , " " );
+  geo_io_writer_fixed( writer , y , 14 , 4 );
+  geo_io_writer_puts( writer , "         0.0000\n" );
+}
+
+
+void geo_polygon_fprintf_irap( const geo_polygon_type * polygon , const char * filename ) {
+  FILE * stream = util_mkdir_fopen( filename , "w");
+  geo_io_writer_type * writer = geo_io_writer_alloc( stream );
+  int size = double_vector_size( polygon->xcoord );
+  int i;
+
+  for (i=0; i < size; i++)
+    geo_polygon_fprintf_irap_point( writer , double_vector_iget( polygon->xcoord , i ) , double_vector_iget( polygon->ycoord , i ));
+
+  if (size > 1) {
+    if ((double_vector_get_last(polygon->xcoord) != double_vector_get_first(polygon->xcoord)) ||
+        (double_vector_get_last(polygon->ycoord) != double_vector_get_first(polygon->ycoord)))
+      geo_polygon_fprintf_irap_point( writer , double_vector_get_first( polygon->xcoord ) , double_vector_get_first( polygon->ycoord ));
+  }
+  geo_io_writer_puts( writer , "      999.0000       999.0000       999.0000\n" );
+
+  geo_io_writer_free( writer );
+  fclose( stream );
+}
+
+
+
 void geo_polygon_reset(geo_polygon_type * polygon ) {
   double_vector_reset( polygon->xcoord );
   double_vector_reset( polygon->ycoord );
@@ -20,15 +20,25 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include <stdint.h>
+#include <string.h>
+
 #include <ert/util/util.h>
 #include <ert/util/type_macros.h>
+#include <ert/util/util_endian.h>
 
 #include <ert/geometry/geo_pointset.h>
 #include <ert/geometry/geo_surface.h>
+#include <ert/geometry/geo_io.h>
 
 #define __PI                3.14159265
 #define GEO_SURFACE_TYPE_ID 111743
 
+#define IRAP_MAGIC               -996
+#define IRAP_BINARY_HEADER1_SIZE 8
+#define IRAP_BINARY_HEADER2_SIZE 4
+#define IRAP_BINARY_HEADER3_SIZE 7
+
 
 struct geo_surface_struct {
   UTIL_TYPE_ID_DECLARATION;
@@ -91,20 +101,22 @@ static void geo_surface_init_regular( geo_surface_type * surface , const double
 
 
 static bool geo_surface_fscanf_zcoord( const geo_surface_type * surface , FILE * stream , double * zcoord) {
-  int index = 0;
-
-  while (true) {
-    if (fscanf(stream , "%lg" , &zcoord[index]) == 1)
-      index++;
-    else
-      return false; // File is too short
-
-    if (index == surface->nx * surface->ny) {
-      double extra_value;
-      int fscanf_return = fscanf( stream , "%lg" , &extra_value);
-      return (fscanf_return == EOF); // no more data dangling at the end of the file.
+  geo_io_reader_type * reader = geo_io_reader_alloc( stream );
+  bool read_ok = true;
+  int index;
+
+  for (index = 0; index < surface->nx * surface->ny; index++) {
+    if (!geo_io_reader_read_double( reader , &zcoord[index] )) {
+      read_ok = false;  // File is too short
+      break;
     }
   }
+
+  if (read_ok)
+    read_ok = geo_io_reader_at_eof( reader ); // no more data dangling at the end of the file.
+
+  geo_io_reader_free( reader );
+  return read_ok;
 }
 
 
@@ -132,15 +144,17 @@ static void geo_surface_fprintf_irap_header( const geo_surface_type * surface ,
 
 
 static void geo_surface_fprintf_zcoord( const geo_surface_type * surface , FILE * stream , const double * zcoord ) {
+  geo_io_writer_type * writer = geo_io_writer_alloc( stream );
   int num_columns = 6;
-  const char * fmt = "%12.4f  ";
   int i;
   for (i=0; i < geo_surface_get_size( surface ); i++) {
-    fprintf(stream , fmt , zcoord[i]);
+    geo_io_writer_fixed( writer , zcoord[i] , 12 , 4 );
+    geo_io_writer_puts( writer , "  " );
 
     if (((i + 1) % num_columns) == 0)
-      fprintf(stream , "\n");
+      geo_io_writer_puts( writer , "\n" );
   }
+  geo_io_writer_free( writer );
 }
 
 
@@ -163,26 +177,34 @@ void geo_surface_fprintf_irap_external_zcoord( const geo_surface_type * surface,
   geo_surface_fprintf_irap__( surface , filename , zcoord );
 }
 
+static void geo_surface_init_header( geo_surface_type * surface ,
+                                     int nx,        int ny,
+                                     double xinc,   double yinc,
+                                     double xstart, double ystart,
+                                     double angle ) {
+  surface->origo[0]  = xstart;
+  surface->origo[1]  = ystart;
+  surface->rot_angle = angle * __PI / 180.0;
+  surface->nx = nx;
+  surface->ny = ny;
+
+  surface->vec1[0] = xinc * cos( surface->rot_angle ) ;
+  surface->vec1[1] = xinc * sin( surface->rot_angle ) ;
+
+  surface->vec2[0] = -yinc * sin( surface->rot_angle ) ;
+  surface->vec2[1] =  yinc * cos( surface->rot_angle );
+
+  surface->cell_size[0] = xinc;
+  surface->cell_size[1] = yinc;
+}
+
+
 geo_surface_type  * geo_surface_alloc_new( int nx,        int ny,
                                            double xinc,   double yinc,
                                            double xstart, double ystart,
                                            double angle ) {
     geo_surface_type * surface = geo_surface_alloc_empty( true );
-
-    surface->origo[0]  = xstart;
-    surface->origo[1]  = ystart;
-    surface->rot_angle = angle * __PI / 180.0;
-    surface->nx = nx;
-    surface->ny = ny;
-
-    surface->vec1[0] = xinc * cos( surface->rot_angle ) ;
-    surface->vec1[1] = xinc * sin( surface->rot_angle ) ;
-
-    surface->vec2[0] = -yinc * sin( surface->rot_angle ) ;
-    surface->vec2[1] =  yinc * cos( surface->rot_angle );
-
-    surface->cell_size[0] = xinc;
-    surface->cell_size[1] = yinc;
+    geo_surface_init_header( surface , nx , ny , xinc , yinc , xstart , ystart , angle );
     geo_surface_init_regular( surface, NULL );
     return surface;
 }
@@ -213,20 +235,7 @@ static void geo_surface_fload_irap_header( geo_surface_type * surface, FILE * st
           util_abort("%s: reading irap header failed \n",__func__ );
       }
 
-      surface->origo[0]  = xstart;
-      surface->origo[1]  = ystart;
-      surface->rot_angle = angle * __PI / 180.0;
-      surface->nx = nx;
-      surface->ny = ny;
-
-      surface->vec1[0] = xinc * cos( surface->rot_angle ) ;
-      surface->vec1[1] = xinc * sin( surface->rot_angle ) ;
-
-      surface->vec2[0] = -yinc * sin( surface->rot_angle ) ;
-      surface->vec2[1] =  yinc * cos( surface->rot_angle );
-
-      surface->cell_size[0] = xinc;
-      surface->cell_size[1] = yinc;
+      geo_surface_init_header( surface , nx , ny , xinc , yinc , xstart , ystart , angle );
     }  else
     util_abort("%s: reading irap header failed\n",__func__ );
 }
@@ -314,6 +323,249 @@ geo_surface_type * geo_surface_fload_alloc_irap( const char * filename , bool lo
 }
 
 
+
+/*****************************************************************/
+/*
+  IRAP binary surfaces are stored as big endian Fortran unformatted
+  records:
+
+    1. -996 ny xori xmax yori ymax xinc yinc  (2 int + 6 float)
+    2. nx rot xori yori                       (1 int + 3 float)
+    3. 0 0 0 0 0 0 0                          (7 int)
+    4. The nx*ny z values as float, x running fastest, split over
+       an arbitrary number of records.
+*/
+
+static bool geo_surface_host_little_endian( void ) {
+  const int32_t one = 1;
+  return (*((const char *) &one) == 1);
+}
+
+
+static void geo_surface_flip_be( void * data , int elements ) {
+  if (geo_surface_host_little_endian())
+    util_endian_flip_vector( data , 4 , elements );
+}
+
+
+/*
+  Reads one record of 4 byte elements into @data. Returns the number
+  of elements read, or -1 if the end of file is reached or the
+  record is broken / larger than @max_elements.
+*/
+
+static int geo_surface_fread_irap_record( FILE * stream , void * data , int max_elements ) {
+  int32_t head , tail;
+
+  if (fread( &head , sizeof head , 1 , stream ) != 1)
+    return -1;
+  geo_surface_flip_be( &head , 1 );
+
+  if ((head < 0) || (head % 4) || (head / 4 > max_elements))
+    return -1;
+
+  if (fread( data , 1 , head , stream ) != (size_t) head)
+    return -1;
+
+  if (fread( &tail , sizeof tail , 1 , stream ) != 1)
+    return -1;
+  geo_surface_flip_be( &tail , 1 );
+
+  if (tail != head)
+    return -1;
+
+  geo_surface_flip_be( data , head / 4 );
+  return head / 4;
+}
+
+
+static void geo_surface_fwrite_irap_record( FILE * stream , const void * data , int elements ) {
+  int32_t marker = 4 * elements;
+  char * buffer = util_malloc( 4 * elements + 8 );
+
+  memcpy( buffer , &marker , 4 );
+  memcpy( &buffer[4] , data , 4 * elements );
+  memcpy( &buffer[4 + 4 * elements] , &marker , 4 );
+  geo_surface_flip_be( buffer , elements + 2 );
+
+  util_fwrite( buffer , 1 , 4 * elements + 8 , stream , __func__ );
+  free( buffer );
+}
+
+
+static bool geo_surface_fread_irap_binary_header( geo_surface_type * surface , FILE * stream ) {
+  char header1[4 * IRAP_BINARY_HEADER1_SIZE];
+  char header2[4 * IRAP_BINARY_HEADER2_SIZE];
+  int32_t header3[IRAP_BINARY_HEADER3_SIZE];
+  int32_t magic , nx , ny;
+  float xori , yori , xinc , yinc , rot;
+
+  if (geo_surface_fread_irap_record( stream , header1 , IRAP_BINARY_HEADER1_SIZE ) != IRAP_BINARY_HEADER1_SIZE)
+    return false;
+
+  if (geo_surface_fread_irap_record( stream , header2 , IRAP_BINARY_HEADER2_SIZE ) != IRAP_BINARY_HEADER2_SIZE)
+    return false;
+
+  if (geo_surface_fread_irap_record( stream , header3 , IRAP_BINARY_HEADER3_SIZE ) != IRAP_BINARY_HEADER3_SIZE)
+    return false;
+
+  memcpy( &magic , &header1[0]  , 4 );
+  memcpy( &ny    , &header1[4]  , 4 );
+  memcpy( &xori  , &header1[8]  , 4 );
+  memcpy( &yori  , &header1[16] , 4 );
+  memcpy( &xinc  , &header1[24] , 4 );
+  memcpy( &yinc  , &header1[28] , 4 );
+  memcpy( &nx    , &header2[0]  , 4 );
+  memcpy( &rot   , &header2[4]  , 4 );
+
+  if ((magic != IRAP_MAGIC) || (nx <= 0) || (ny <= 0))
+    return false;
+
+  geo_surface_init_header( surface , nx , ny , xinc , yinc , xori , yori , rot );
+  return true;
+}
+
+
+static bool geo_surface_fread_irap_binary_zcoord( const geo_surface_type * surface , FILE * stream , double * zcoord) {
+  const int size = surface->nx * surface->ny;
+  float * buffer = util_calloc( size , sizeof * buffer );
+  int index = 0;
+  bool read_ok = true;
+
+  while (index < size) {
+    int elements = geo_surface_fread_irap_record( stream , &buffer[index] , size - index );
+    if (elements <= 0) {
+      read_ok = false;
+      break;
+    }
+    index += elements;
+  }
+
+  if (read_ok) {
+    int i;
+    for (i = 0; i < size; i++)
+      zcoord[i] = buffer[i];
+
+    read_ok = (fgetc( stream ) == EOF);  // no more data dangling at the end of the file.
+  }
+
+  free( buffer );
+  return read_ok;
+}
+
+
+static bool geo_surface_fload_irap_binary( geo_surface_type * surface , const char * filename , bool loadz) {
+  FILE * stream = util_fopen( filename , "rb");
+  bool read_ok = geo_surface_fread_irap_binary_header( surface , stream );
+
+  if (read_ok) {
+    double * zcoord = NULL;
+
+    if (loadz) {
+      zcoord = util_calloc( surface->nx * surface->ny , sizeof * zcoord  );
+      read_ok = geo_surface_fread_irap_binary_zcoord( surface , stream , zcoord );
+    }
+
+    if (read_ok)
+      geo_surface_init_regular( surface , zcoord );
+    util_safe_free( zcoord );
+  }
+
+  fclose( stream );
+  return read_ok;
+}
+
+
+geo_surface_type * geo_surface_fload_alloc_irap_binary( const char * filename , bool loadz) {
+  geo_surface_type * surface = geo_surface_alloc_empty( loadz );
+  bool load_ok = geo_surface_fload_irap_binary( surface , filename , loadz );
+  if (!load_ok) {
+    geo_surface_free( surface );
+    surface = NULL;
+  }
+  return surface;
+}
+
+
+/**
+   As geo_surface_fload_irap_zcoord(); the header in the file must
+   agree with the header of @surface - observe that the header values
+   are stored as float in the binary format.
+*/
+
+bool geo_surface_fload_irap_binary_zcoord( const geo_surface_type * surface, const char * filename, double *zcoord) {
+  FILE * stream = util_fopen__( filename , "rb");
+  if (stream) {
+    bool loadOK;
+    {
+      geo_surface_type * tmp_surface = geo_surface_alloc_empty( false );
+
+      loadOK = geo_surface_fread_irap_binary_header( tmp_surface , stream );
+      if (loadOK)
+        loadOK = geo_surface_equal_header( surface , tmp_surface );
+      geo_surface_free( tmp_surface );
+    }
+    if (loadOK)
+      loadOK = geo_surface_fread_irap_binary_zcoord( surface , stream , zcoord);
+
+    fclose( stream );
+    return loadOK;
+  } else
+    return false;
+}
+
+
+static void geo_surface_fwrite_irap_binary__( const geo_surface_type * surface, const char * filename , const double * zcoord) {
+  FILE * stream = util_mkdir_fopen( filename , "wb");
+  {
+    char header1[4 * IRAP_BINARY_HEADER1_SIZE];
+    char header2[4 * IRAP_BINARY_HEADER2_SIZE];
+    int32_t header3[IRAP_BINARY_HEADER3_SIZE] = {0,0,0,0,0,0,0};
+    int32_t magic = IRAP_MAGIC;
+    int32_t nx = surface->nx;
+    int32_t ny = surface->ny;
+    float values1[6] = { surface->origo[0] , surface->origo[0] + surface->cell_size[0] * (surface->nx - 1) ,
+                         surface->origo[1] , surface->origo[1] + surface->cell_size[1] * (surface->ny - 1) ,
+                         surface->cell_size[0] , surface->cell_size[1] };
+    float values2[3] = { surface->rot_angle * 180 / __PI , surface->origo[0] , surface->origo[1] };
+
+    memcpy( &header1[0] , &magic , 4 );
+    memcpy( &header1[4] , &ny , 4 );
+    memcpy( &header1[8] , values1 , sizeof values1 );
+    memcpy( &header2[0] , &nx , 4 );
+    memcpy( &header2[4] , values2 , sizeof values2 );
+
+    geo_surface_fwrite_irap_record( stream , header1 , IRAP_BINARY_HEADER1_SIZE );
+    geo_surface_fwrite_irap_record( stream , header2 , IRAP_BINARY_HEADER2_SIZE );
+    geo_surface_fwrite_irap_record( stream , header3 , IRAP_BINARY_HEADER3_SIZE );
+  }
+
+  {
+    float * row = util_calloc( surface->nx , sizeof * row );
+    int ix , iy;
+    for (iy = 0; iy < surface->ny; iy++) {
+      for (ix = 0; ix < surface->nx; ix++)
+        row[ix] = zcoord[ iy * surface->nx + ix ];
+      geo_surface_fwrite_irap_record( stream , row , surface->nx );
+    }
+    free( row );
+  }
+  fclose( stream );
+}
+
+
+void geo_surface_fwrite_irap_binary( const geo_surface_type * surface, const char * filename ) {
+  const double * zcoord = geo_pointset_get_zcoord( surface->pointset );
+  geo_surface_fwrite_irap_binary__( surface , filename , zcoord );
+}
+
+
+void geo_surface_fwrite_irap_binary_external_zcoord( const geo_surface_type * surface, const char * filename , const double * zcoord) {
+  geo_surface_fwrite_irap_binary__( surface , filename , zcoord );
+}
+
+/*****************************************************************/
+
 geo_surface_type * geo_surface_alloc_copy( const geo_surface_type * src , bool copy_zdata) {
   geo_surface_type * target = geo_surface_alloc_empty( true );
 
@@ -364,6 +616,64 @@ int geo_surface_get_ny( const geo_surface_type * surface ) {
 
 
 
+/*
+  Converts the world coordinate (x,y) to the fractional lattice
+  coordinate (u,v) of the surface, i.e. the node (ix,iy) is found at
+  (u,v) = (ix,iy). The conversion takes the rotation into account.
+*/
+
+void geo_surface_get_lattice_coord( const geo_surface_type * surface , double x , double y , double * u , double * v) {
+  double dx = x - surface->origo[0];
+  double dy = y - surface->origo[1];
+  double det = surface->vec1[0] * surface->vec2[1] - surface->vec1[1] * surface->vec2[0];
+
+  *u = (dx * surface->vec2[1] - dy * surface->vec2[0]) / det;
+  *v = (surface->vec1[0] * dy - surface->vec1[1] * dx) / det;
+}
+
+
+/*
+  Bilinear interpolation of the z values of the surface at the world
+  coordinate (x,y). Returns false if the point is outside the surface
+  or the surface does not have any z values.
+*/
+
+bool geo_surface_interpolate_z( const geo_surface_type * surface , double x , double y , double * z) {
+  const double * zcoord = geo_pointset_get_zcoord( surface->pointset );
+  double u , v;
+
+  if (zcoord == NULL)
+    return false;
+
+  geo_surface_get_lattice_coord( surface , x , y , &u , &v );
+  if ((u < 0) || (v < 0) || (u > surface->nx - 1) || (v > surface->ny - 1))
+    return false;
+
+  {
+    int ix = util_int_min( (int) u , surface->nx - 2 );
+    int iy = util_int_min( (int) v , surface->ny - 2 );
+    double fu , fv;
+
+    /* Degenerate surfaces with only one row or column of nodes. */
+    ix = util_int_max( ix , 0 );
+    iy = util_int_max( iy , 0 );
+    fu = (surface->nx > 1) ? u - ix : 0;
+    fv = (surface->ny > 1) ? v - iy : 0;
+
+    {
+      int i00 = ix + iy * surface->nx;
+      int i10 = (surface->nx > 1) ? i00 + 1 : i00;
+      int i01 = (surface->ny > 1) ? i00 + surface->nx : i00;
+      int i11 = (surface->nx > 1) ? i01 + 1 : i01;
+
+      *z = (1 - fv) * ((1 - fu) * zcoord[i00] + fu * zcoord[i10]) +
+                fv  * ((1 - fu) * zcoord[i01] + fu * zcoord[i11]);
+    }
+  }
+  return true;
+}
+
+
 bool geo_surface_equal( const geo_surface_type * surface1 , const geo_surface_type * surface2) {
   if (geo_surface_equal_header(surface1 , surface2))
     return geo_pointset_equal( surface1->pointset , surface2->pointset);
@@ -0,0 +1,209 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'geo_io.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/geometry/geo_io.h>
+#include <ert/geometry/geo_surface.h>
+#include <ert/geometry/geo_polygon.h>
+
+
+void test_format_value( double value , int width , int decimals ) {
+  char expected[GEO_IO_FORMAT_BUFFER_SIZE];
+  char formatted[GEO_IO_FORMAT_BUFFER_SIZE];
+
+  snprintf( expected , sizeof expected , "%*.*f" , width , decimals , value );
+  test_assert_int_equal( geo_io_format_fixed( formatted , value , width , decimals ) , strlen( expected ));
+  test_assert_string_equal( formatted , expected );
+}
+
+
+void test_format( rng_type * rng ) {
+  const double special[] = { 0 , -0.0 , 0.5 , 1.5 , 2.5 , -2.5 , 0.00005 , 0.00015 , -0.00005 , 1.23456789 ,
+                             9999900.0 , 1e30 , -1e30 , 1e300 , 123456789012.5 , NAN , INFINITY , -INFINITY };
+  for (int i = 0; i < sizeof special / sizeof special[0]; i++) {
+    test_format_value( special[i] , 12 , 4 );
+    test_format_value( special[i] , 0 , 0 );
+    test_format_value( special[i] , 14 , 3 );
+  }
+
+  for (int i = 0; i < 100000; i++) {
+    double value = (rng_get_double( rng ) - 0.5) * pow( 10 , rng_get_int( rng , 16 ) - 6 );
+    test_format_value( value , 12 , 4 );
+    test_format_value( value , 1 , rng_get_int( rng , 9 ));
+  }
+}
+
+
+void test_read_string( const char * text , int expected_count ) {
+  FILE * stream = util_fopen( "numbers.txt" , "w");
+  fputs( text , stream );
+  fclose( stream );
+
+  stream = util_fopen( "numbers.txt" , "r");
+  {
+    geo_io_reader_type * reader = geo_io_reader_alloc( stream );
+    const char * p = text;
+    double value;
+    int count = 0;
+
+    while (geo_io_reader_read_double( reader , &value )) {
+      char * end;
+      double expected = strtod( p , &end );
+      test_assert_mem_equal( &value , &expected , sizeof value );
+      p = end;
+      count++;
+    }
+    test_assert_int_equal( count , expected_count );
+    geo_io_reader_free( reader );
+  }
+  fclose( stream );
+}
+
+
+void test_read( rng_type * rng ) {
+  test_read_string( "1 -2 +3.5 .25 -0.0 1e5 1.5E-3 007 0.000123 123456789012345678901234 1e400 1e-400 nan inf 0x10 4.9e-324" , 16 );
+  test_read_string( "  \n\t1.0\r\n2.0  " , 2 );
+  test_read_string( "1.0 2.0 xyz 3.0" , 2 );
+
+  {
+    const int count = 200000;
+    const char * fmt[] = { "%.17g " , "%.4f\n" , "%e " , "%g\t" , "%.0f " };
+    FILE * stream = util_fopen( "random.txt" , "w");
+    double * values = util_calloc( count , sizeof * values );
+
+    for (int i = 0; i < count; i++) {
+      char buffer[64];
+      double value = (rng_get_double( rng ) - 0.5) * pow( 10 , rng_get_int( rng , 30 ) - 15 );
+      snprintf( buffer , sizeof buffer , fmt[ i % 5 ] , value );
+      values[i] = strtod( buffer , NULL );
+      fputs( buffer , stream );
+    }
+    fclose( stream );
+
+    stream = util_fopen( "random.txt" , "r");
+    {
+      geo_io_reader_type * reader = geo_io_reader_alloc( stream );
+      for (int i = 0; i < count; i++) {
+        double value;
+        test_assert_true( geo_io_reader_read_double( reader , &value ));
+        test_assert_mem_equal( &value , &values[i] , sizeof value );
+      }
+      test_assert_true( geo_io_reader_at_eof( reader ));
+      geo_io_reader_free( reader );
+    }
+    fclose( stream );
+    free( values );
+  }
+}
+
+
+geo_surface_type * alloc_surface( rng_type * rng ) {
+  geo_surface_type * surface = geo_surface_alloc_new( 123 , 77 , 25.0 , 12.5 , 444230.0 , 6809537.0 , -30.0 );
+  geo_pointset_type * pointset = geo_surface_get_pointset( surface );
+  for (int i = 0; i < geo_surface_get_size( surface ); i++)
+    geo_pointset_iset_z( pointset , i , 1500 + rng_get_int( rng , 100000 ) / 16.0 );
+  return surface;
+}
+
+
+void test_surface( rng_type * rng ) {
+  geo_surface_type * surface = alloc_surface( rng );
+  double * zcoord = util_calloc( geo_surface_get_size( surface ) , sizeof * zcoord );
+
+  geo_surface_fprintf_irap( surface , "surface.irap" );
+  {
+    geo_surface_type * surface2 = geo_surface_fload_alloc_irap( "surface.irap" , true );
+    test_assert_true( geo_surface_equal( surface , surface2 ));
+    geo_surface_free( surface2 );
+  }
+
+  geo_surface_fwrite_irap_binary( surface , "surface.bin" );
+  {
+    geo_surface_type * surface2 = geo_surface_fload_alloc_irap_binary( "surface.bin" , true );
+    test_assert_not_NULL( surface2 );
+    test_assert_true( geo_surface_equal( surface , surface2 ));
+    test_assert_true( geo_surface_fload_irap_binary_zcoord( surface , "surface.bin" , zcoord ));
+    for (int i = 0; i < geo_surface_get_size( surface ); i++)
+      test_assert_double_equal( zcoord[i] , geo_surface_iget_zvalue( surface , i ));
+    geo_surface_free( surface2 );
+  }
+
+  /* Binary file with a truncated data section. */
+  {
+    FILE * src = util_fopen( "surface.bin" , "rb");
+    FILE * target = util_fopen( "broken.bin" , "wb");
+    for (int i = 0; i < 1000; i++)
+      fputc( fgetc( src ) , target );
+    fclose( target );
+    fclose( src );
+    test_assert_NULL( geo_surface_fload_alloc_irap_binary( "broken.bin" , true ));
+    test_assert_false( geo_surface_fload_irap_binary_zcoord( surface , "broken.bin" , zcoord ));
+  }
+
+  /* ASCII file with extra data at the end. */
+  {
+    FILE * stream = util_fopen( "surface.irap" , "a");
+    fprintf( stream , "\n1.0\n");
+    fclose( stream );
+    test_assert_false( geo_surface_fload_irap_zcoord( surface , "surface.irap" , zcoord ));
+  }
+
+  free( zcoord );
+  geo_surface_free( surface );
+}
+
+
+void test_polygon() {
+  geo_polygon_type * polygon = geo_polygon_alloc( "polygon.irap" );
+  geo_polygon_add_point( polygon , 0 , 0 );
+  geo_polygon_add_point( polygon , 100.25 , 0 );
+  geo_polygon_add_point( polygon , 100.25 , 50.5 );
+  geo_polygon_add_point( polygon , 0 , 50.5 );
+
+  geo_polygon_fprintf_irap( polygon , "polygon.irap" );
+  {
+    geo_polygon_type * polygon2 = geo_polygon_fload_alloc_irap( "polygon.irap" );
+    test_assert_true( geo_polygon_equal( polygon , polygon2 ));
+    geo_polygon_free( polygon2 );
+  }
+  geo_polygon_free( polygon );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "geo_io" );
+  rng_type * rng = rng_alloc( XOSHIRO , INIT_DEFAULT );
+
+  test_format( rng );
+  test_read( rng );
+  test_surface( rng );
+  test_polygon();
+
+  rng_free( rng );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,102 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'EclFile.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_FILE_HPP
+#define ERT_ECL_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/EclKW.hpp>
+
+#include <ert/util/ert_unique_ptr.hpp>
+
+namespace ERT {
+
+    /*
+      Move-only wrapper around an ecl_file instance. Keywords are loaded
+      lazily by the underlying ecl_file; view< T >() returns a pinned
+      EclKWView which stays valid also after the EclFile itself has been
+      destroyed.
+    */
+
+    class EclFile {
+    public:
+        explicit EclFile( const std::string& filename, int flags = 0 ) :
+            m_file( ecl_file_open( filename.c_str(), flags ) )
+        {
+            if( !this->m_file )
+                throw std::invalid_argument( "Could not open file: " + filename );
+        }
+
+        EclFile( EclFile&& ) = default;
+        EclFile& operator=( EclFile&& ) = default;
+
+        bool has_kw( const std::string& kw ) const {
+            return ecl_file_has_kw( this->get(), kw.c_str() );
+        }
+
+        int num_named_kw( const std::string& kw ) const {
+            return ecl_file_get_num_named_kw( this->get(), kw.c_str() );
+        }
+
+        int size() const {
+            return ecl_file_get_size( this->get() );
+        }
+
+        std::vector< std::string > keywords() const {
+            std::vector< std::string > kw_list;
+            for( int i = 0; i < ecl_file_get_num_distinct_kw( this->get() ); i++ )
+                kw_list.push_back( ecl_file_iget_distinct_kw( this->get(), i ) );
+            return kw_list;
+        }
+
+        template< typename T >
+        EclKWView< T > view( const std::string& kw, int ith = 0 ) const {
+            return EclKWView< T >( this->iget_named_kw( kw, ith ) );
+        }
+
+        /*
+          The EclKW_ref is owned by the file, and only valid as long as
+          the EclFile is alive.
+        */
+        template< typename T >
+        EclKW_ref< T > ref( const std::string& kw, int ith = 0 ) const {
+            return EclKW_ref< T >( this->iget_named_kw( kw, ith ) );
+        }
+
+        ecl_file_type* get() const {
+            return this->m_file.get();
+        }
+
+    private:
+        ecl_kw_type* iget_named_kw( const std::string& kw, int ith ) const {
+            if( ith < 0 || ith >= this->num_named_kw( kw ) )
+                throw std::out_of_range( "No such keyword: " + kw );
+
+            return ecl_file_iget_named_kw( this->get(), kw.c_str(), ith );
+        }
+
+        ert_unique_ptr< ecl_file_type, ecl_file_close > m_file;
+    };
+
+}
+
+#endif
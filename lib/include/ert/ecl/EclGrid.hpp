@@ -0,0 +1,218 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'EclGrid.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_GRID_HPP
+#define ERT_ECL_GRID_HPP
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <iterator>
+#include <stdexcept>
+
+#include <ert/ecl/ecl_grid.h>
+
+#include <ert/util/ert_unique_ptr.hpp>
+
+namespace ERT {
+
+    /*
+      Distinct types for the two index spaces of a grid, so that a
+      global index can not silently be passed where an active index is
+      expected - and vice versa.
+    */
+
+    struct GlobalIndex {
+        int value;
+        bool operator==( const GlobalIndex& other ) const { return this->value == other.value; }
+        bool operator!=( const GlobalIndex& other ) const { return this->value != other.value; }
+    };
+
+    struct ActiveIndex {
+        int value;
+        bool operator==( const ActiveIndex& other ) const { return this->value == other.value; }
+        bool operator!=( const ActiveIndex& other ) const { return this->value != other.value; }
+    };
+
+    struct GridCell {
+        GlobalIndex global;
+        ActiveIndex active;          /* value == -1 for inactive cells. */
+        int i, j, k;
+
+        bool is_active() const { return this->active.value >= 0; }
+    };
+
+
+    class EclGrid {
+    public:
+        explicit EclGrid( const std::string& case_name ) :
+            m_grid( ecl_grid_load_case( case_name.c_str() ) )
+        {
+            if( !this->m_grid )
+                throw std::invalid_argument( "Could not load grid: " + case_name );
+        }
+
+        /* Takes ownership of an existing ecl_grid instance. */
+        explicit EclGrid( ecl_grid_type* grid ) :
+            m_grid( grid )
+        {
+            if( !this->m_grid )
+                throw std::invalid_argument( "EclGrid: NULL grid" );
+        }
+
+        EclGrid( EclGrid&& ) = default;
+        EclGrid& operator=( EclGrid&& ) = default;
+
+        int nx() const { return ecl_grid_get_nx( this->get() ); }
+        int ny() const { return ecl_grid_get_ny( this->get() ); }
+        int nz() const { return ecl_grid_get_nz( this->get() ); }
+        int global_size() const { return ecl_grid_get_global_size( this->get() ); }
+        int active_size() const { return ecl_grid_get_active_size( this->get() ); }
+
+        GlobalIndex global_index( int i, int j, int k ) const {
+            return GlobalIndex{ ecl_grid_get_global_index3( this->get(), i, j, k ) };
+        }
+
+        GlobalIndex global_index( ActiveIndex active ) const {
+            return GlobalIndex{ ecl_grid_get_global_index1A( this->get(), active.value ) };
+        }
+
+        ActiveIndex active_index( GlobalIndex global ) const {
+            return ActiveIndex{ ecl_grid_get_active_index1( this->get(), global.value ) };
+        }
+
+        double cell_volume( GlobalIndex global ) const {
+            return ecl_grid_get_cell_volume1( this->get(), global.value );
+        }
+
+        double cell_volume( ActiveIndex active ) const {
+            return ecl_grid_get_cell_volume1A( this->get(), active.value );
+        }
+
+        std::array< double, 3 > xyz( GlobalIndex global ) const {
+            std::array< double, 3 > pos;
+            ecl_grid_get_xyz1( this->get(), global.value, &pos[0], &pos[1], &pos[2] );
+            return pos;
+        }
+
+
+        /*
+          Forward iteration over the cells of the grid, either all the
+          cells in global order or only the active cells in active
+          order. The ijk values are computed directly from the global
+          index instead of going through ecl_grid_get_ijk1().
+        */
+
+        class cell_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = GridCell;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const GridCell*;
+            using reference = const GridCell&;
+
+            cell_iterator( const EclGrid& grid, int index, bool active_only ) :
+                m_grid( grid.get() ),
+                m_nx( grid.nx() ),
+                m_ny( grid.ny() ),
+                m_active_only( active_only ),
+                m_size( active_only ? grid.active_size() : grid.global_size() ),
+                m_index( index ),
+                m_cell()
+            {
+                this->update();
+            }
+
+            const GridCell& operator*() const { return this->m_cell; }
+            const GridCell* operator->() const { return &this->m_cell; }
+
+            cell_iterator& operator++() {
+                this->m_index++;
+                this->update();
+                return *this;
+            }
+
+            cell_iterator operator++( int ) {
+                cell_iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            bool operator==( const cell_iterator& other ) const { return this->m_index == other.m_index; }
+            bool operator!=( const cell_iterator& other ) const { return this->m_index != other.m_index; }
+
+        private:
+            void update() {
+                int global;
+                if( this->m_index >= this->m_size )
+                    return;
+
+                if( this->m_active_only ) {
+                    global = ecl_grid_get_global_index1A( this->m_grid, this->m_index );
+                    this->m_cell.active = ActiveIndex{ this->m_index };
+                } else {
+                    global = this->m_index;
+                    this->m_cell.active = ActiveIndex{ ecl_grid_get_active_index1( this->m_grid, global ) };
+                }
+
+                this->m_cell.global = GlobalIndex{ global };
+                this->m_cell.i = global % this->m_nx;
+                this->m_cell.j = ( global / this->m_nx ) % this->m_ny;
+                this->m_cell.k = global / ( this->m_nx * this->m_ny );
+            }
+
+            const ecl_grid_type* m_grid;
+            int m_nx, m_ny;
+            bool m_active_only;
+            int m_size;
+            int m_index;
+            GridCell m_cell;
+        };
+
+        class cell_range {
+        public:
+            cell_range( const EclGrid& grid, bool active_only ) :
+                m_grid( grid ), m_active_only( active_only )
+            {}
+
+            cell_iterator begin() const { return cell_iterator( this->m_grid, 0, this->m_active_only ); }
+            cell_iterator end() const { return cell_iterator( this->m_grid, this->size(), this->m_active_only ); }
+
+            int size() const {
+                return this->m_active_only ? this->m_grid.active_size() : this->m_grid.global_size();
+            }
+
+        private:
+            const EclGrid& m_grid;
+            bool m_active_only;
+        };
+
+        cell_range cells() const { return cell_range( *this, false ); }
+        cell_range active_cells() const { return cell_range( *this, true ); }
+
+        ecl_grid_type* get() const {
+            return this->m_grid.get();
+        }
+
+    private:
+        ert_unique_ptr< ecl_grid_type, ecl_grid_free > m_grid;
+    };
+
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include <ert/ecl/ecl_util.h>
 
 #include <ert/util/ert_unique_ptr.hpp>
+#include <ert/util/ert_span.hpp>
 #include <ert/ecl/FortIO.hpp>
 
 namespace ERT {
@@ -78,9 +79,20 @@ namespace ERT {
         }
 
         T& operator[](size_t i) {
-            return *static_cast< T* >( ecl_kw_iget_ptr( this->m_kw, i ) );
+            return static_cast< T* >( ecl_kw_get_ptr( this->m_kw ) )[ i ];
+        }
+
+        /*
+          The span is only valid as long as the keyword is alive and not
+          resized; use an EclKWView to pin the keyword.
+        */
+        span< T > data_span() const {
+            return span< T >( static_cast< T* >( ecl_kw_get_ptr( this->m_kw ) ), this->size() );
         }
 
+        T* begin() const { return this->data_span().begin(); }
+        T* end() const { return this->data_span().end(); }
+
         const typename std::remove_pointer< T >::type* data() const {
             using Tp = const typename std::remove_pointer< T >::type*;
             return static_cast< Tp >( ecl_kw_get_ptr( this->m_kw ) );
@@ -98,6 +110,88 @@ namespace ERT {
         ecl_kw_type* m_kw = nullptr;
     };
 
+/*
+  Move-only view of the data of a keyword; the keyword is pinned for
+  the lifetime of the view, i.e. the data can not be reallocated, and
+  it will not be freed before the view is destroyed - also if the
+  keyword is owned by an ecl_file which is closed. String keywords are
+  only available through at().
+*/
+
+template< typename T >
+class EclKWView {
+    static_assert( std::is_arithmetic< T >::value || std::is_same< T, const char* >::value,
+                   "EclKWView is only available for numeric and string keywords" );
+
+    public:
+        explicit EclKWView( ecl_kw_type* kw ) : m_kw( kw ) {
+            if( !kw )
+                throw std::invalid_argument("EclKWView: NULL keyword");
+
+            if( ecl_type_get_type(ecl_kw_get_data_type( kw )) != ecl_type< T >::type )
+                throw std::invalid_argument("Type error");
+
+            ecl_kw_pin( kw );
+        }
+
+        EclKWView( const EclKWView& ) = delete;
+        EclKWView& operator=( const EclKWView& ) = delete;
+
+        EclKWView( EclKWView&& rhs ) noexcept : m_kw( rhs.m_kw ) {
+            rhs.m_kw = nullptr;
+        }
+
+        EclKWView& operator=( EclKWView&& rhs ) noexcept {
+            if( this != &rhs ) {
+                this->reset();
+                this->m_kw = rhs.m_kw;
+                rhs.m_kw = nullptr;
+            }
+            return *this;
+        }
+
+        ~EclKWView() {
+            this->reset();
+        }
+
+        const char* name() const {
+            return ecl_kw_get_header( this->m_kw );
+        }
+
+        size_t size() const {
+            return size_t( ecl_kw_get_size( this->m_kw ) );
+        }
+
+        span< T > data_span() const {
+            return span< T >( static_cast< T* >( ecl_kw_get_ptr( this->m_kw ) ), this->size() );
+        }
+
+        T* begin() const { return this->data_span().begin(); }
+        T* end() const { return this->data_span().end(); }
+
+        T& operator[]( size_t i ) const {
+            return static_cast< T* >( ecl_kw_get_ptr( this->m_kw ) )[ i ];
+        }
+
+        T at( size_t i ) const {
+            return *static_cast< T* >( ecl_kw_iget_ptr( this->m_kw, i ) );
+        }
+
+        const ecl_kw_type* get() const {
+            return this->m_kw;
+        }
+
+    private:
+        void reset() {
+            if( this->m_kw )
+                ecl_kw_unpin( this->m_kw );
+            this->m_kw = nullptr;
+        }
+
+        ecl_kw_type* m_kw = nullptr;
+};
+
+
 template<>
 inline const char* EclKW_ref< const char* >::at( size_t i ) const {
     return ecl_kw_iget_char_ptr( this->m_kw, i );
@@ -107,12 +201,39 @@ inline const char* EclKW_ref< const char* >::at( size_t i ) const {
 /*
   The current implementation of "string" storage in the underlying C
   ecl_kw structure does not lend itself to easily implement
-  operator[]. We have therefor explicitly deleted it here.
+  operator[]. We have therefor explicitly deleted it here, along with
+  the raw data access through data_span(), begin() and end().
 */
 
 template<>
 const char*& EclKW_ref< const char* >::operator[]( size_t i )  = delete;
 
+template<>
+span< const char* > EclKW_ref< const char* >::data_span() const = delete;
+
+template<>
+const char** EclKW_ref< const char* >::begin() const = delete;
+
+template<>
+const char** EclKW_ref< const char* >::end() const = delete;
+
+template<>
+inline const char* EclKWView< const char* >::at( size_t i ) const {
+    return ecl_kw_iget_char_ptr( this->m_kw, i );
+}
+
+template<>
+const char*& EclKWView< const char* >::operator[]( size_t i ) const = delete;
+
+template<>
+span< const char* > EclKWView< const char* >::data_span() const = delete;
+
+template<>
+const char** EclKWView< const char* >::begin() const = delete;
+
+template<>
+const char** EclKWView< const char* >::end() const = delete;
+
 
 template< typename T >
 class EclKW : public EclKW_ref< T > {
@@ -0,0 +1,130 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'EclSum.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_SUM_HPP
+#define ERT_ECL_SUM_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <ert/util/stringlist.h>
+#include <ert/ecl/ecl_sum.h>
+
+#include <ert/util/ert_unique_ptr.hpp>
+#include <ert/util/ert_span.hpp>
+
+namespace ERT {
+
+    /*
+      Move-only wrapper around an ecl_sum instance.
+
+      The summary data is stored one timestep at a time in the ecl_sum
+      layer, so a column is assembled with one bulk export the first
+      time it is requested; after that the column is cached in the
+      EclSum object and column() hands out views of the cached
+      data. The spans are valid as long as the EclSum object is alive.
+      The cache is not thread safe.
+    */
+
+    class EclSum {
+    public:
+        explicit EclSum( const std::string& case_name, const std::string& key_join_string = ":" ) :
+            m_sum( ecl_sum_fread_alloc_case( case_name.c_str(), key_join_string.c_str() ) )
+        {
+            if( !this->m_sum )
+                throw std::invalid_argument( "Could not load summary case: " + case_name );
+
+            this->init_time();
+        }
+
+        /* Takes ownership of an existing ecl_sum instance. */
+        explicit EclSum( ecl_sum_type* ecl_sum ) :
+            m_sum( ecl_sum )
+        {
+            if( !this->m_sum )
+                throw std::invalid_argument( "EclSum: NULL summary" );
+
+            this->init_time();
+        }
+
+        EclSum( EclSum&& ) = default;
+        EclSum& operator=( EclSum&& ) = default;
+
+        size_t size() const {
+            return this->m_days.size();
+        }
+
+        bool has_key( const std::string& key ) const {
+            return ecl_sum_has_key( this->get(), key.c_str() );
+        }
+
+        std::vector< std::string > keys( const std::string& pattern = "*" ) const {
+            std::vector< std::string > key_list;
+            stringlist_type * s = ecl_sum_alloc_matching_general_var_list( this->get(), pattern.c_str() );
+            for( int i = 0; i < stringlist_get_size( s ); i++ )
+                key_list.push_back( stringlist_iget( s, i ) );
+            stringlist_free( s );
+            return key_list;
+        }
+
+        span< const double > days() const {
+            return span< const double >( this->m_days.data(), this->m_days.size() );
+        }
+
+        span< const int64_t > time() const {
+            return span< const int64_t >( this->m_time.data(), this->m_time.size() );
+        }
+
+        span< const double > column( const std::string& key ) const {
+            auto iter = this->m_columns.find( key );
+            if( iter == this->m_columns.end() ) {
+                if( !this->has_key( key ) )
+                    throw std::out_of_range( "No such summary key: " + key );
+
+                std::vector< double > values( this->size() );
+                ecl_sum_export_vector( this->get(), key.c_str(), false, values.data() );
+                iter = this->m_columns.emplace( key, std::move( values ) ).first;
+            }
+
+            return span< const double >( iter->second.data(), iter->second.size() );
+        }
+
+        ecl_sum_type* get() const {
+            return this->m_sum.get();
+        }
+
+    private:
+        void init_time() {
+            int length = ecl_sum_get_export_length( this->get(), false );
+            this->m_days.resize( length );
+            this->m_time.resize( length );
+            ecl_sum_export_days( this->get(), false, this->m_days.data() );
+            ecl_sum_export_time( this->get(), false, this->m_time.data() );
+        }
+
+        ert_unique_ptr< ecl_sum_type, ecl_sum_free > m_sum;
+        std::vector< double > m_days;
+        std::vector< int64_t > m_time;
+        mutable std::map< std::string, std::vector< double > > m_columns;
+    };
+
+}
+
+#endif
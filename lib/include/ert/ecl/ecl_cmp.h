@@ -0,0 +1,85 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_cmp.h' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_CMP_H
+#define ERT_ECL_CMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_sum.h>
+
+/*
+  Comparison of two ECLIPSE files (restart, INIT, ...) or two summary
+  cases. The keywords of the two files are paired by (name,
+  occurrence) and the payloads are compared with the tolerance
+  kernels in ecl_kw_kernel.c; summary cases are compared vector by
+  vector at the full time resolution. For every pair a result with
+  the number of differing elements, the first difference and the max
+  absolute and relative deviations is recorded.
+*/
+
+typedef enum {
+  ECL_CMP_EQUAL          = 0,
+  ECL_CMP_DIFFERENT      = 1,
+  ECL_CMP_TYPE_MISMATCH  = 2,   /* Different type or size. */
+  ECL_CMP_MISSING_FIRST  = 3,   /* Only present in the second file / case. */
+  ECL_CMP_MISSING_SECOND = 4    /* Only present in the first file / case. */
+} ecl_cmp_status_enum;
+
+typedef struct ecl_cmp_struct        ecl_cmp_type;
+typedef struct ecl_cmp_result_struct ecl_cmp_result_type;
+
+  ecl_cmp_type              * ecl_cmp_alloc( double abs_epsilon , double rel_epsilon );
+  void                        ecl_cmp_free( ecl_cmp_type * ecl_cmp );
+  void                        ecl_cmp_add_tolerance( ecl_cmp_type * ecl_cmp , const char * key , double abs_epsilon , double rel_epsilon );
+  void                        ecl_cmp_add_ignore( ecl_cmp_type * ecl_cmp , const char * key );
+  void                        ecl_cmp_clear( ecl_cmp_type * ecl_cmp );
+
+  bool                        ecl_cmp_files( ecl_cmp_type * ecl_cmp , ecl_file_type * file1 , ecl_file_type * file2 );
+  bool                        ecl_cmp_sum( ecl_cmp_type * ecl_cmp , const ecl_sum_type * sum1 , const ecl_sum_type * sum2 );
+
+  bool                        ecl_cmp_equal( const ecl_cmp_type * ecl_cmp );
+  int                         ecl_cmp_get_size( const ecl_cmp_type * ecl_cmp );
+  int                         ecl_cmp_get_num_different( const ecl_cmp_type * ecl_cmp );
+  const ecl_cmp_result_type * ecl_cmp_iget_result( const ecl_cmp_type * ecl_cmp , int index );
+  const ecl_cmp_result_type * ecl_cmp_get_result( const ecl_cmp_type * ecl_cmp , const char * key , int occurence );
+  void                        ecl_cmp_fprintf( const ecl_cmp_type * ecl_cmp , FILE * stream , bool only_different );
+
+  const char                * ecl_cmp_result_get_key( const ecl_cmp_result_type * result );
+  int                         ecl_cmp_result_get_occurence( const ecl_cmp_result_type * result );
+  ecl_cmp_status_enum         ecl_cmp_result_get_status( const ecl_cmp_result_type * result );
+  int                         ecl_cmp_result_get_size( const ecl_cmp_result_type * result );
+  int64_t                     ecl_cmp_result_get_num_different( const ecl_cmp_result_type * result );
+  int                         ecl_cmp_result_get_first_different( const ecl_cmp_result_type * result );
+  double                      ecl_cmp_result_get_max_abs_diff( const ecl_cmp_result_type * result );
+  int                         ecl_cmp_result_get_max_abs_index( const ecl_cmp_result_type * result );
+  double                      ecl_cmp_result_get_max_rel_diff( const ecl_cmp_result_type * result );
+  int                         ecl_cmp_result_get_max_rel_index( const ecl_cmp_result_type * result );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,58 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_convert.h' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_CONVERT_H
+#define ERT_ECL_CONVERT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+/*
+  Conversion of a file with ECLIPSE keywords between the formatted
+  and the unformatted representation; the target file gets the
+  opposite format of the source file. The result is byte for byte
+  identical to reading the keywords with ecl_kw_fread_alloc() and
+  writing them with ecl_kw_fwrite().
+
+  The conversion runs as a pipeline: one thread splits the source
+  file into chunks of whole keywords, num_threads worker threads
+  decode and encode the chunks, and the calling thread writes the
+  converted chunks to the target file in the original order. With
+  num_threads <= 0 the number of threads from
+  ecl_kw_kernel_get_num_threads() is used, and with num_threads == 1
+  - or when threads are not available - the keywords are converted
+  one at a time in the calling thread.
+
+  The return value is false if the source file could not be read to
+  the end, or if writing the target file failed; the keywords
+  preceding the failure are still written to the target file.
+*/
+
+#define ECL_CONVERT_CHUNK_SIZE        1048576
+#define ECL_CONVERT_CHUNKS_PER_THREAD 4
+
+  bool ecl_convert_file( const char * src_file , bool fmt_src , const char * target_file , int num_threads );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,71 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_dir.h' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_DIR_H
+#define ERT_ECL_DIR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_util.h>
+
+/*
+  Catalogue of the ECLIPSE files in one directory, built with a single
+  pass over the directory entries. The files are classified with
+  ecl_util_get_file_type() and grouped per case (basename); only names
+  which are exactly what ecl_util_alloc_filename() would produce are
+  included, i.e. the catalogue gives the same answers as the glob
+  patterns and file existence tests in ecl_util.
+
+  The filenames are stored with the path as given to ecl_dir_alloc(),
+  in the same way as ecl_util_alloc_filename() would combine them.
+*/
+
+typedef struct ecl_dir_struct      ecl_dir_type;
+typedef struct ecl_dir_case_struct ecl_dir_case_type;
+
+  ecl_dir_type            * ecl_dir_alloc( const char * path );
+  ecl_dir_type            * ecl_dir_alloc_shared( const char * path );
+  ecl_dir_type            * ecl_dir_alloc_shared_current( const char * path );
+  void                      ecl_dir_free( ecl_dir_type * ecl_dir );
+  void                      ecl_dir_shared_clear( void );
+
+  bool                      ecl_dir_is_current( const ecl_dir_type * ecl_dir );
+  const char              * ecl_dir_get_path( const ecl_dir_type * ecl_dir );
+  bool                      ecl_dir_has_file( const ecl_dir_type * ecl_dir , const char * filename );
+  int                       ecl_dir_get_num_cases( const ecl_dir_type * ecl_dir );
+  const ecl_dir_case_type * ecl_dir_iget_case( const ecl_dir_type * ecl_dir , int index );
+  const ecl_dir_case_type * ecl_dir_get_case( const ecl_dir_type * ecl_dir , const char * base );
+  int                       ecl_dir_select_files( const ecl_dir_type * ecl_dir , const char * base , ecl_file_enum file_type , bool fmt_file , stringlist_type * filelist );
+
+  const char              * ecl_dir_case_get_base( const ecl_dir_case_type * dir_case );
+  const char              * ecl_dir_case_get_file( const ecl_dir_case_type * dir_case , ecl_file_enum file_type , bool fmt_file );
+  int                       ecl_dir_case_get_num_files( const ecl_dir_case_type * dir_case , ecl_file_enum file_type , bool fmt_file );
+  const char              * ecl_dir_case_iget_file( const ecl_dir_case_type * dir_case , ecl_file_enum file_type , bool fmt_file , int index );
+  int                       ecl_dir_case_iget_report_step( const ecl_dir_case_type * dir_case , ecl_file_enum file_type , bool fmt_file , int index );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
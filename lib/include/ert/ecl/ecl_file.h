@@ -26,6 +26,7 @@ extern "C" {
 #include <stdbool.h>
 #include <time.h>
 
+#include <ert/util/stringlist.h>
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file_kw.h>
@@ -47,6 +48,8 @@ extern "C" {
   typedef struct ecl_file_struct ecl_file_type;
   bool             ecl_file_load_all( ecl_file_type * ecl_file );
   ecl_file_type  * ecl_file_open( const char * filename , int flags);
+  ecl_file_type  * ecl_file_open_restart_set( const stringlist_type * restart_files , int flags);
+  ecl_file_type  * ecl_file_open_restart_case( const char * path , const char * base , int flags);
   ecl_file_type  * ecl_file_fast_open( const char * filename , const char * index_filename , int flags);
   bool             ecl_file_write_index( const ecl_file_type * ecl_file , const char * index_filename);
   bool             ecl_file_index_valid(const char * file_name, const char * index_file_name);
@@ -84,6 +87,7 @@ extern "C" {
   int                ecl_file_iget_size( const ecl_file_type * file , int global_index);
   const char       * ecl_file_iget_header( const ecl_file_type * file , int global_index);
   ecl_kw_type      * ecl_file_iget_named_kw( const ecl_file_type * file , const char * kw, int ith);
+  ecl_kw_type      * ecl_file_iget_named_pinned_kw( const ecl_file_type * file , const char * kw, int ith);
   ecl_data_type      ecl_file_iget_named_data_type( const ecl_file_type * file , const char * kw , int ith);
   int                ecl_file_iget_named_size( const ecl_file_type * file , const char * kw , int ith);
   void               ecl_file_indexed_read(const ecl_file_type * file , const char * kw, int index, const int_vector_type * index_map, char* buffer);
@@ -26,6 +26,8 @@ extern "C" {
 #include <stdbool.h>
 
 #include <ert/util/util.h>
+#include <ert/util/arena.h>
+#include <ert/util/str_intern.h>
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/fortio.h>
@@ -39,15 +41,21 @@ typedef struct inv_map_struct inv_map_type;
   bool               ecl_file_kw_equal( const ecl_file_kw_type * kw1 , const ecl_file_kw_type * kw2);
   ecl_file_kw_type * ecl_file_kw_alloc( const ecl_kw_type * ecl_kw , offset_type offset);
   ecl_file_kw_type * ecl_file_kw_alloc0( const char * header , ecl_data_type data_type , int size , offset_type offset);
+  ecl_file_kw_type * ecl_file_kw_alloc_arena( arena_type * arena , str_intern_type * strings , const ecl_kw_type * ecl_kw , offset_type offset);
+  ecl_file_kw_type * ecl_file_kw_alloc_source( arena_type * arena , str_intern_type * strings , const char * header , ecl_data_type data_type , int size , offset_type offset , int source);
+  ecl_file_kw_type * ecl_file_kw_alloc_memory( arena_type * arena , str_intern_type * strings , ecl_kw_type * ecl_kw , inv_map_type * inv_map , int source);
   void               ecl_file_kw_free( ecl_file_kw_type * file_kw );
   void               ecl_file_kw_free__( void * arg );
   ecl_kw_type      * ecl_file_kw_get_kw( ecl_file_kw_type * file_kw , fortio_type * fortio, inv_map_type * inv_map);
   ecl_kw_type      * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw );
+  bool               ecl_file_kw_is_pinned( const ecl_file_kw_type * file_kw );
+  bool               ecl_file_kw_is_loaded( const ecl_file_kw_type * file_kw );
   ecl_file_kw_type * ecl_file_kw_alloc_copy( const ecl_file_kw_type * src );
   const char       * ecl_file_kw_get_header( const ecl_file_kw_type * file_kw );
   int                ecl_file_kw_get_size( const ecl_file_kw_type * file_kw );
   ecl_data_type      ecl_file_kw_get_data_type(const ecl_file_kw_type *);
   offset_type        ecl_file_kw_get_offset(const ecl_file_kw_type * file_kw);
+  int                ecl_file_kw_get_source( const ecl_file_kw_type * file_kw );
   bool               ecl_file_kw_ptr_eq( const ecl_file_kw_type * file_kw , const ecl_kw_type * ecl_kw);
   void               ecl_file_kw_replace_kw( ecl_file_kw_type * file_kw , fortio_type * target , ecl_kw_type * new_kw );
   bool               ecl_file_kw_fskip_data( const ecl_file_kw_type * file_kw , fortio_type * fortio);
@@ -55,6 +63,7 @@ typedef struct inv_map_struct inv_map_type;
 
   void                ecl_file_kw_fwrite( const ecl_file_kw_type * file_kw , FILE * stream );
   ecl_file_kw_type ** ecl_file_kw_fread_alloc_multiple( FILE * stream , int num);
+  ecl_file_kw_type ** ecl_file_kw_fread_alloc_multiple_arena( FILE * stream , int num , arena_type * arena , str_intern_type * strings);
   ecl_file_kw_type *  ecl_file_kw_fread_alloc( FILE * stream );
 
   void                ecl_file_kw_start_transaction(const ecl_file_kw_type * file_kw, int * ref_count);
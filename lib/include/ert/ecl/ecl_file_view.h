@@ -26,6 +26,7 @@
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file_kw.h>
 #include <ert/ecl/ecl_type.h>
+#include <ert/ecl/fortio_cache.h>
 
 
 #ifdef __cplusplus
@@ -55,6 +56,9 @@ typedef struct ecl_file_transaction_struct ecl_file_transaction_type;
   bool ecl_file_view_check_flags( int state_flags , int query_flags);
 
   ecl_file_view_type      * ecl_file_view_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map , bool owner );
+  void                      ecl_file_view_set_strings( ecl_file_view_type * ecl_file_view , const str_intern_type * strings );
+  void                      ecl_file_view_set_cache( ecl_file_view_type * ecl_file_view , fortio_cache_type * cache );
+  fortio_cache_type       * ecl_file_view_get_cache( const ecl_file_view_type * ecl_file_view );
   int                       ecl_file_view_get_global_index( const ecl_file_view_type * ecl_file_view , const char * kw , int ith);
   void                      ecl_file_view_make_index( ecl_file_view_type * ecl_file_view );
   bool                      ecl_file_view_has_kw( const ecl_file_view_type * ecl_file_view, const char * kw);
@@ -70,6 +74,7 @@ typedef struct ecl_file_transaction_struct ecl_file_transaction_type;
   int                       ecl_file_view_iget_size( const ecl_file_view_type * ecl_file_view , int index);
   const char              * ecl_file_view_iget_header( const ecl_file_view_type * ecl_file_view , int index);
   ecl_kw_type             * ecl_file_view_iget_named_kw( const ecl_file_view_type * ecl_file_view , const char * kw, int ith);
+  ecl_kw_type             * ecl_file_view_iget_named_pinned_kw( const ecl_file_view_type * ecl_file_view , const char * kw, int ith);
   ecl_data_type             ecl_file_view_iget_named_data_type( const ecl_file_view_type * ecl_file_view , const char * kw , int ith);
   int                       ecl_file_view_iget_named_size( const ecl_file_view_type * ecl_file_view , const char * kw , int ith);
   void      ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type * old_kw , ecl_kw_type * new_kw , bool insert_copy);
@@ -103,7 +108,7 @@ typedef struct ecl_file_transaction_struct ecl_file_transaction_type;
   void                 ecl_file_view_fclose_stream( ecl_file_view_type * file_view );
 
   void                 ecl_file_view_write_index(const ecl_file_view_type * file_view, FILE * ostream);
-  ecl_file_view_type * ecl_file_view_fread_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map, FILE * istream );
+  ecl_file_view_type * ecl_file_view_fread_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map, arena_type * arena , str_intern_type * strings , FILE * istream );
 
   ecl_file_transaction_type * ecl_file_view_start_transaction(ecl_file_view_type * file_view);
   void                        ecl_file_view_end_transaction( ecl_file_view_type * file_view, ecl_file_transaction_type * transaction);
@@ -25,8 +25,13 @@ extern "C" {
 #endif
 #include <stdbool.h>
 
+#include <ert/util/vector.h>
+
 #include <ert/ecl/ecl_grid_cache.h>
 #include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_region.h>
+
+typedef struct ecl_grav_tree_struct ecl_grav_tree_type;
 
 bool * ecl_grav_common_alloc_aquifer_cell(const ecl_grid_cache_type * grid_cache,
                                           const ecl_file_type * init_file);
@@ -39,6 +44,20 @@ double ecl_grav_common_eval_biot_savart(const ecl_grid_cache_type * grid_cache,
                                         double utm_y,
                                         double depth);
 
+double ecl_grav_common_eval_biot_savart_subset(const ecl_grid_cache_type * subset,
+                                               const double * weight,
+                                               double utm_x,
+                                               double utm_y,
+                                               double depth);
+
+double ecl_grav_common_eval_geertsma_subset(const ecl_grid_cache_type * subset,
+                                            const double * weight,
+                                            double utm_x,
+                                            double utm_y,
+                                            double depth,
+                                            double poisson_ratio,
+                                            double seabed);
+
 double ecl_grav_common_eval_geertsma(const ecl_grid_cache_type * grid_cache,
                                      ecl_region_type * region,
                                      const bool * aquifer,
@@ -49,6 +68,35 @@ double ecl_grav_common_eval_geertsma(const ecl_grid_cache_type * grid_cache,
                                      double poisson_ratio,
                                      double seabed);
 
+ecl_grav_tree_type * ecl_grav_tree_alloc(const ecl_grid_cache_type * subset);
+void ecl_grav_tree_free(ecl_grav_tree_type * tree);
+const ecl_grid_cache_type * ecl_grav_tree_get_subset(const ecl_grav_tree_type * tree);
+ecl_grav_tree_type * ecl_grav_common_acquire_tree(vector_type * tree_list,
+                                                  const ecl_grid_cache_type * grid_cache,
+                                                  ecl_region_type * region,
+                                                  const bool * aquifer);
+void ecl_grav_common_release_tree(ecl_grav_tree_type * tree);
+
+void ecl_grav_common_eval_biot_savart_tree(const ecl_grav_tree_type * tree,
+                                           const double * weight,
+                                           int num_stations,
+                                           const double * utm_x,
+                                           const double * utm_y,
+                                           const double * depth,
+                                           double theta,
+                                           double * result);
+
+void ecl_grav_common_eval_geertsma_tree(const ecl_grav_tree_type * tree,
+                                        const double * weight,
+                                        int num_stations,
+                                        const double * utm_x,
+                                        const double * utm_y,
+                                        const double * depth,
+                                        double poisson_ratio,
+                                        double seabed,
+                                        double theta,
+                                        double * result);
+
 #ifdef __cplusplus
 }
 
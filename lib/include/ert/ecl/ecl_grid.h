@@ -80,17 +80,21 @@ extern "C" {
   double          ecl_grid_get_cdepth1(const ecl_grid_type * grid , int global_index);
   double          ecl_grid_get_cdepth3(const ecl_grid_type * grid , int i, int j , int k);
   int             ecl_grid_get_global_index_from_xy( const ecl_grid_type * ecl_grid , int k , bool lower_layer , double x , double y);
+  int             ecl_grid_get_global_index_from_xy_list( const ecl_grid_type * ecl_grid , int k , bool lower_layer , int num_points , const double * x , const double * y , int * global_index);
   bool            ecl_grid_cell_contains_xyz1( const ecl_grid_type * ecl_grid , int global_index , double x , double y , double z);
   bool            ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i , int j , int k, double x , double y , double z );
   double          ecl_grid_get_cell_volume1( const ecl_grid_type * ecl_grid, int global_index );
   double          ecl_grid_get_cell_volume1_tskille( const ecl_grid_type * ecl_grid, int global_index );
   double          ecl_grid_get_cell_volume3( const ecl_grid_type * ecl_grid, int i , int j , int k);
   double          ecl_grid_get_cell_volume1A( const ecl_grid_type * ecl_grid, int active_index );
+  void            ecl_grid_export_cell_centers( const ecl_grid_type * grid , int num_cells , const int * global_index , double * xpos , double * ypos , double * zpos);
+  void            ecl_grid_export_cell_volumes( const ecl_grid_type * grid , int num_cells , const int * global_index , double * volume);
   bool            ecl_grid_cell_contains1(const ecl_grid_type * grid , int global_index , double x , double y , double z);
   bool            ecl_grid_cell_contains3(const ecl_grid_type * grid , int i , int j ,int k , double x , double y , double z);
   int             ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index);
   bool            ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k );
   bool            ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j);
+  int             ecl_grid_get_ij_from_xy_list( const ecl_grid_type * grid , int k , int num_points , const double * x , const double * y , int * i , int * j);
   const  char   * ecl_grid_get_name( const ecl_grid_type * );
   int             ecl_grid_get_active_index3(const ecl_grid_type * ecl_grid , int i , int j , int k);
   int             ecl_grid_get_active_index1(const ecl_grid_type * ecl_grid , int global_index);
@@ -254,6 +258,15 @@ extern "C" {
   void ecl_grid_reset_actnum( ecl_grid_type * grid , const int * actnum );
   void ecl_grid_compressed_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw);
   void ecl_grid_global_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw);
+  void ecl_grid_export_kw_global( const ecl_grid_type * grid , const ecl_kw_type * kw , double default_value , void * global_data);
+  void ecl_grid_export_kw_active( const ecl_grid_type * grid , const ecl_kw_type * kw , void * active_data);
+  void ecl_grid_import_kw_global( const ecl_grid_type * grid , ecl_kw_type * kw , const void * global_data);
+  void ecl_grid_export_fracture_kw_global( const ecl_grid_type * grid , const ecl_kw_type * kw , double default_value , void * global_data);
+  void ecl_grid_export_kw_list_global( const ecl_grid_type * grid , int num_kw , const ecl_kw_type ** kw_list , double default_value , void ** global_data);
+  const int * ecl_grid_get_index_map_ptr( const ecl_grid_type * grid );
+  const int * ecl_grid_get_inv_index_map_ptr( const ecl_grid_type * grid );
+  const int * ecl_grid_get_fracture_index_map_ptr( const ecl_grid_type * grid );
+  const int * ecl_grid_get_inv_fracture_index_map_ptr( const ecl_grid_type * grid );
 
   UTIL_IS_INSTANCE_HEADER( ecl_grid );
   UTIL_SAFE_CAST_HEADER( ecl_grid );
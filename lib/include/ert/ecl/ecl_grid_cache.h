@@ -20,6 +20,8 @@
 #ifndef ERT_ECL_GRID_CACHE_H
 #define ERT_ECL_GRID_CACHE_H
 
+#include <stdbool.h>
+
 #include <ert/ecl/ecl_grid.h>
 
 #ifdef __cplusplus
@@ -30,13 +32,22 @@ extern "C" {
 
 
   ecl_grid_cache_type  * ecl_grid_cache_alloc( const ecl_grid_type * grid );
+  ecl_grid_cache_type  * ecl_grid_cache_alloc__( const ecl_grid_type * grid , bool float_storage);
+  ecl_grid_cache_type  * ecl_grid_cache_alloc_shared( const ecl_grid_type * grid , bool float_storage);
   int                    ecl_grid_cache_get_size( const ecl_grid_cache_type * grid_cache );
   int                    ecl_grid_cache_iget_global_index( const ecl_grid_cache_type * grid_cache , int active_index);
   const int            * ecl_grid_cache_get_global_index( const ecl_grid_cache_type * grid_cache );
+  bool                   ecl_grid_cache_float_storage( const ecl_grid_cache_type * grid_cache );
+  void                   ecl_grid_cache_get_origin( const ecl_grid_cache_type * grid_cache , double * x0 , double * y0 , double * z0);
   const double         * ecl_grid_cache_get_xpos( const ecl_grid_cache_type * grid_cache );
   const double         * ecl_grid_cache_get_ypos( const ecl_grid_cache_type * grid_cache );
   const double         * ecl_grid_cache_get_zpos( const ecl_grid_cache_type * grid_cache );
+  const float          * ecl_grid_cache_get_xpos_float( const ecl_grid_cache_type * grid_cache );
+  const float          * ecl_grid_cache_get_ypos_float( const ecl_grid_cache_type * grid_cache );
+  const float          * ecl_grid_cache_get_zpos_float( const ecl_grid_cache_type * grid_cache );
   const double         * ecl_grid_cache_get_volume( const ecl_grid_cache_type * grid_cache );
+  ecl_grid_cache_type  * ecl_grid_cache_get_subset( const ecl_grid_cache_type * grid_cache , const int * active_list , int list_size , const bool * exclude);
+  const int            * ecl_grid_cache_get_parent_index( const ecl_grid_cache_type * grid_cache );
   void                   ecl_grid_cache_free( ecl_grid_cache_type * grid_cache );
 
 
@@ -0,0 +1,76 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_surface.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_GRID_SURFACE_H
+#define ERT_ECL_GRID_SURFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ert/geometry/geo_surface.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+
+/*
+  The aggregation used when mapping a grid property onto a surface;
+  the values of all the active cells in the k range whose footprint
+  covers a surface node are combined:
+
+    SUM      : sum of the values.
+    MIN/MAX  : smallest / largest value.
+    AVERAGE  : thickness weighted average of the values.
+    INTEGRAL : sum of value * cell thickness, i.e. with NTG you get a
+               net thickness map, with PORO*NTG*SOIL a hydrocarbon
+               pore column map.
+*/
+
+typedef enum {
+  ECL_GRID_MAP_SUM      = 1,
+  ECL_GRID_MAP_MIN      = 2,
+  ECL_GRID_MAP_MAX      = 3,
+  ECL_GRID_MAP_AVERAGE  = 4,
+  ECL_GRID_MAP_INTEGRAL = 5
+} ecl_grid_map_enum;
+
+
+/*
+  The part of a cell which is rasterised onto the surface: the top
+  face, the bottom face, or the quadrilateral halfway between them.
+*/
+
+typedef enum {
+  ECL_GRID_FOOTPRINT_TOP    = 1,
+  ECL_GRID_FOOTPRINT_BOTTOM = 2,
+  ECL_GRID_FOOTPRINT_MID    = 3
+} ecl_grid_footprint_enum;
+
+  void ecl_grid_map_kw_footprint( const ecl_grid_type * grid , const ecl_kw_type * kw , int k1 , int k2 , ecl_grid_map_enum op ,
+                                  ecl_grid_footprint_enum footprint ,
+                                  const geo_surface_type * surface , double undefined_value , double * zcoord);
+
+  void ecl_grid_map_kw( const ecl_grid_type * grid , const ecl_kw_type * kw , int k1 , int k2 , ecl_grid_map_enum op ,
+                        const geo_surface_type * surface , double undefined_value , double * zcoord);
+  void ecl_grid_sample_surface( const ecl_grid_type * grid , const geo_surface_type * surface , double undefined_value , double * values);
+  void ecl_grid_sample_surface_layer( const ecl_grid_type * grid , const geo_surface_type * surface , int k , double undefined_value , double * values);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
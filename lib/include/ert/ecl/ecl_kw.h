@@ -92,6 +92,10 @@ extern "C" {
   void           ecl_kw_fread_indexed_data(fortio_type * fortio, offset_type data_offset, ecl_data_type, int element_count, const int_vector_type* index_map, char* buffer);
   void           ecl_kw_free(ecl_kw_type *);
   void           ecl_kw_free__(void *);
+  void           ecl_kw_pin( ecl_kw_type * ecl_kw );
+  void           ecl_kw_unpin( ecl_kw_type * ecl_kw );
+  bool           ecl_kw_is_pinned( const ecl_kw_type * ecl_kw );
+  int            ecl_kw_get_pin_count( const ecl_kw_type * ecl_kw );
   ecl_kw_type *  ecl_kw_alloc_copy (const ecl_kw_type *);
   ecl_kw_type *  ecl_kw_alloc_sub_copy( const ecl_kw_type * src, const char * new_kw , int offset , int count);
   const void  *  ecl_kw_copyc__(const void *);
@@ -138,6 +142,7 @@ extern "C" {
   bool           ecl_kw_content_equal( const ecl_kw_type * ecl_kw1 , const ecl_kw_type * ecl_kw2);
   bool           ecl_kw_fskip_data__( ecl_data_type, int, fortio_type *);
   bool           ecl_kw_fskip_data(ecl_kw_type *ecl_kw, fortio_type *fortio);
+  bool           ecl_kw_fcopy_raw( fortio_type * src , fortio_type * target );
   bool           ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio);
   void           ecl_kw_fskip_header( fortio_type * fortio);
 
@@ -172,7 +177,10 @@ extern "C" {
   ECL_KW_SCALAR_SET_TYPED_HEADER( double )
 #undef ECL_KW_SCALAR_SET_TYPED_HEADER
 
+  /* new_kw[ mapping[i] ] = src_kw[i]; with duplicate mapping values the last element wins. */
   ecl_kw_type * ecl_kw_alloc_scatter_copy( const ecl_kw_type * src_kw , int target_size , const int * mapping, void * def_value);
+  /* As above, the caller guarantees that mapping is distinct and in range. */
+  ecl_kw_type * ecl_kw_alloc_scatter_copy_distinct( const ecl_kw_type * src_kw , int target_size , const int * mapping, void * def_value);
 
   void ecl_kw_inplace_add( ecl_kw_type * target_kw , const ecl_kw_type * add_kw);
   void ecl_kw_inplace_sub( ecl_kw_type * target_kw , const ecl_kw_type * sub_kw);
@@ -0,0 +1,102 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_kw_kernel.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_KW_KERNEL_H
+#define ERT_ECL_KW_KERNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+  Elementwise kernels on raw int / float / double arrays; these are
+  the work horses behind the ecl_kw arithmetic functions.
+*/
+
+#define ECL_KW_KERNEL_PARALLEL_SIZE  1000000
+#define ECL_KW_KERNEL_SUM_BLOCK      65536
+
+  void    ecl_kw_kernel_set_num_threads( int num_threads );
+  int     ecl_kw_kernel_get_num_threads( void );
+  void    ecl_kw_kernel_set_parallel_size( int parallel_size );
+
+#define ECL_KW_KERNEL_HEADER( ctype , sum_type )                                                                            \
+  void     ecl_kw_kernel_add_ ## ctype( ctype * target , const ctype * src , int size);                                     \
+  void     ecl_kw_kernel_sub_ ## ctype( ctype * target , const ctype * src , int size);                                     \
+  void     ecl_kw_kernel_mul_ ## ctype( ctype * target , const ctype * src , int size);                                     \
+  void     ecl_kw_kernel_div_ ## ctype( ctype * target , const ctype * src , int size);                                     \
+  void     ecl_kw_kernel_add_indexed_ ## ctype( ctype * target , const ctype * src , const int * index , int index_size);   \
+  void     ecl_kw_kernel_sub_indexed_ ## ctype( ctype * target , const ctype * src , const int * index , int index_size);   \
+  void     ecl_kw_kernel_mul_indexed_ ## ctype( ctype * target , const ctype * src , const int * index , int index_size);   \
+  void     ecl_kw_kernel_div_indexed_ ## ctype( ctype * target , const ctype * src , const int * index , int index_size);   \
+  void     ecl_kw_kernel_scale_ ## ctype( ctype * data , int size , ctype factor);                                          \
+  void     ecl_kw_kernel_shift_ ## ctype( ctype * data , int size , ctype shift);                                           \
+  void     ecl_kw_kernel_max_min_ ## ctype( const ctype * data , int size , ctype * max , ctype * min);                     \
+  sum_type ecl_kw_kernel_sum_ ## ctype( const ctype * data , int size);                                                     \
+  sum_type ecl_kw_kernel_sum_indexed_ ## ctype( const ctype * data , const int * index , int index_size);
+
+ECL_KW_KERNEL_HEADER( int    , int64_t )
+ECL_KW_KERNEL_HEADER( float  , double )
+ECL_KW_KERNEL_HEADER( double , double )
+#undef ECL_KW_KERNEL_HEADER
+
+/*
+  Gather: target[i] = src[index[i]], scatter: target[index[i]] =
+  src[i] for i in [0,size). The index values used for scatter must be
+  distinct.
+*/
+
+  void    ecl_kw_kernel_gather( void * target , const void * src , int element_size , const int * index , int size);
+  void    ecl_kw_kernel_scatter( void * target , const void * src , int element_size , const int * index , int size);
+  void    ecl_kw_kernel_gather_list( int num_arrays , void ** target , const void ** src , const int * element_size , const int * index , int size);
+  void    ecl_kw_kernel_scatter_list( int num_arrays , void ** target , const void ** src , const int * element_size , const int * index , int size);
+
+/*
+  Comparison of two arrays with absolute / relative tolerance, see
+  ecl_kw_kernel.c for the exact test. The relative deviation of two
+  elements is |v1 - v2| / (|v1| + |v2|). Indices are -1 when there is
+  no difference / deviation; first_diff() returns size when the arrays
+  are equal.
+*/
+
+typedef struct {
+  int64_t num_diff;         /* Number of elements outside the tolerance. */
+  int     first_diff;
+  double  max_abs_diff;
+  int     max_abs_index;
+  double  max_rel_diff;
+  int     max_rel_index;
+} ecl_kw_kernel_cmp_type;
+
+#define ECL_KW_KERNEL_CMP_HEADER( ctype )                                                                   \
+  void     ecl_kw_kernel_cmp_ ## ctype( const ctype * data1 , const ctype * data2 , int size ,               \
+                                        double abs_epsilon , double rel_epsilon , ecl_kw_kernel_cmp_type * result); \
+  int      ecl_kw_kernel_first_diff_ ## ctype( const ctype * data1 , const ctype * data2 , int size ,         \
+                                               double abs_epsilon , double rel_epsilon);
+
+ECL_KW_KERNEL_CMP_HEADER( int )
+ECL_KW_KERNEL_CMP_HEADER( float )
+ECL_KW_KERNEL_CMP_HEADER( double )
+#undef ECL_KW_KERNEL_CMP_HEADER
+
+#ifdef __cplusplus
+}
+#endif
+#endif
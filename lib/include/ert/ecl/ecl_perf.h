@@ -0,0 +1,109 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_perf.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_PERF_H
+#define ERT_ECL_PERF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <ert/util/ert_api_config.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Counters for the fortio / ecl_kw / ecl_file I/O stack. The counters
+  are kept per thread, and ecl_perf_get() returns the sum over all
+  threads. The counting is off by default; it can be switched on with
+  ecl_perf_enable() or by setting the environment variable ECL_PERF=1.
+
+  The time counters are in nanoseconds. The bytes_read and
+  bytes_written counters hold the payload of the unformatted records
+  - including records copied with fortio_copy_record() and
+  fortio_fcopy_range() - and all characters read from or written to
+  formatted files.
+*/
+
+typedef enum {
+  ECL_PERF_BYTES_READ       = 0,
+  ECL_PERF_BYTES_WRITTEN    = 1,
+  ECL_PERF_RECORDS_READ     = 2,
+  ECL_PERF_RECORDS_WRITTEN  = 3,
+  ECL_PERF_KW_READ          = 4,
+  ECL_PERF_KW_WRITTEN       = 5,
+  ECL_PERF_SEEK             = 6,
+  ECL_PERF_ENDIAN_NS        = 7,
+  ECL_PERF_FORMATTED_NS     = 8,
+  ECL_PERF_CACHE_HIT        = 9,
+  ECL_PERF_CACHE_MISS       = 10
+} ecl_perf_counter_enum;
+
+#define ECL_PERF_NUM_COUNTERS 11
+
+  void         ecl_perf_enable( bool enable );
+  bool         ecl_perf_enabled( void );
+  void         ecl_perf_trace_enable( bool enable );
+  bool         ecl_perf_trace_enabled( void );
+  void         ecl_perf_reset( void );
+
+  int          ecl_perf_num_counters( void );
+  const char * ecl_perf_counter_name( ecl_perf_counter_enum counter );
+  void         ecl_perf_add( ecl_perf_counter_enum counter , int64_t value );
+  int64_t      ecl_perf_get( ecl_perf_counter_enum counter );
+  int64_t      ecl_perf_get_thread( ecl_perf_counter_enum counter );
+
+  int64_t      ecl_perf_clock_ns( void );
+  int64_t      ecl_perf_timer_start( void );
+  void         ecl_perf_timer_stop( ecl_perf_counter_enum counter , int64_t start_ns );
+  void         ecl_perf_trace_event( const char * name , const char * arg , int64_t start_ns );
+
+  void         ecl_perf_fprintf_json( FILE * stream );
+  bool         ecl_perf_fwrite_json( const char * filename );
+  void         ecl_perf_fprintf_trace( FILE * stream );
+  bool         ecl_perf_fwrite_trace( const char * filename );
+
+
+/*
+  The macros are used on the hot paths in the library; when the
+  library is configured with ERT_PERF_COUNTERS=OFF they compile to
+  nothing.
+*/
+
+#ifdef ERT_HAVE_PERF_COUNTERS
+
+#define ECL_PERF_ADD(counter , value)  do { if (ecl_perf_enabled()) ecl_perf_add( (counter) , (value) ); } while (0)
+#define ECL_PERF_START()               ecl_perf_timer_start()
+#define ECL_PERF_STOP(counter , start) ecl_perf_timer_stop( (counter) , (start) )
+#define ECL_PERF_TRACE(name , arg , start) ecl_perf_trace_event( (name) , (arg) , (start) )
+
+#else
+
+#define ECL_PERF_ADD(counter , value)  do { (void) (value); } while (0)
+#define ECL_PERF_START()               ((int64_t) 0)
+#define ECL_PERF_STOP(counter , start) do { (void) (start); } while (0)
+#define ECL_PERF_TRACE(name , arg , start) do { (void) (start); } while (0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
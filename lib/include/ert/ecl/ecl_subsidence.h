@@ -42,6 +42,23 @@ extern "C" {
                                                     const char * base, const char * monitor , 
                                                     ecl_region_type * region , 
                                                     double utm_x, double utm_y , double depth, double compressibility, double poisson_ratio);
+  double                       ecl_subsidence_eval_geertsma( const ecl_subsidence_type * subsidence ,
+                                                             const char * base, const char * monitor ,
+                                                             ecl_region_type * region ,
+                                                             double utm_x, double utm_y , double depth,
+                                                             double youngs_modulus, double poisson_ratio, double seabed);
+
+  void                         ecl_subsidence_eval_list( const ecl_subsidence_type * subsidence ,
+                                                         const char * base, const char * monitor ,
+                                                         ecl_region_type * region ,
+                                                         int num_stations , const double * utm_x, const double * utm_y , const double * depth,
+                                                         double compressibility, double poisson_ratio, double theta , double * result);
+  void                         ecl_subsidence_eval_geertsma_list( const ecl_subsidence_type * subsidence ,
+                                                                  const char * base, const char * monitor ,
+                                                                  ecl_region_type * region ,
+                                                                  int num_stations , const double * utm_x, const double * utm_y , const double * depth,
+                                                                  double youngs_modulus, double poisson_ratio, double seabed,
+                                                                  double theta , double * result);
 
 
 #ifdef __plusplus
@@ -25,6 +25,7 @@ extern "C" {
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 
 #include <ert/util/stringlist.h>
@@ -162,6 +163,14 @@ typedef struct ecl_sum_struct       ecl_sum_type;
                                                 bool report_only );
   double_vector_type * ecl_sum_alloc_data_vector( const ecl_sum_type * ecl_sum  , int data_index , bool report_only);
   time_t_vector_type * ecl_sum_alloc_time_vector( const ecl_sum_type * ecl_sum  , bool report_only);
+
+  int                  ecl_sum_get_export_length( const ecl_sum_type * ecl_sum , bool report_only);
+  void                 ecl_sum_export_days( const ecl_sum_type * ecl_sum , bool report_only , double * days);
+  void                 ecl_sum_export_time( const ecl_sum_type * ecl_sum , bool report_only , int64_t * sim_time);
+  void                 ecl_sum_export_report_step( const ecl_sum_type * ecl_sum , bool report_only , int * report_steps);
+  void                 ecl_sum_export_mini_step( const ecl_sum_type * ecl_sum , bool report_only , int * mini_steps);
+  void                 ecl_sum_export_vector( const ecl_sum_type * ecl_sum , const char * gen_key , bool report_only , double * values);
+  void                 ecl_sum_export_vectors( const ecl_sum_type * ecl_sum , const stringlist_type * keys , bool report_only , double * values);
   time_t       ecl_sum_get_data_start( const ecl_sum_type * ecl_sum );
   time_t       ecl_sum_get_end_time( const ecl_sum_type * ecl_sum);
   time_t       ecl_sum_get_start_time(const ecl_sum_type * );
@@ -24,6 +24,7 @@
 extern "C" {
 #endif
 #include <stdlib.h>
+#include <stdint.h>
 #include <time.h>
 
 #include <ert/util/time_t_vector.h>
@@ -53,6 +54,13 @@ typedef struct ecl_sum_data_struct ecl_sum_data_type ;
   double_vector_type     * ecl_sum_data_alloc_data_vector( const ecl_sum_data_type * data , int data_index , bool report_only);
   void                     ecl_sum_data_init_data_vector( const ecl_sum_data_type * data , double_vector_type * data_vector , int data_index , bool report_only);
   void                     ecl_sum_data_init_time_vector( const ecl_sum_data_type * data , time_t_vector_type * time_vector , bool report_only);
+  int                      ecl_sum_data_get_export_length( const ecl_sum_data_type * data , bool report_only);
+  void                     ecl_sum_data_export_days( const ecl_sum_data_type * data , bool report_only , double * days);
+  void                     ecl_sum_data_export_time( const ecl_sum_data_type * data , bool report_only , int64_t * sim_time);
+  void                     ecl_sum_data_export_report_step( const ecl_sum_data_type * data , bool report_only , int * report_steps);
+  void                     ecl_sum_data_export_mini_step( const ecl_sum_data_type * data , bool report_only , int * mini_steps);
+  void                     ecl_sum_data_export_vector( const ecl_sum_data_type * data , int params_index , bool report_only , double * values);
+  void                     ecl_sum_data_export_vectors( const ecl_sum_data_type * data , const int * params_index , int num_vectors , bool report_only , double * values);
   time_t_vector_type     * ecl_sum_data_alloc_time_vector( const ecl_sum_data_type * data , bool report_only);
   time_t                   ecl_sum_data_get_data_start( const ecl_sum_data_type * data );
   time_t                   ecl_sum_data_get_report_time( const ecl_sum_data_type * data , int report_step);
@@ -72,6 +72,9 @@ typedef struct fortio_struct fortio_type;
   bool               fortio_data_fskip(fortio_type* fortio, const int element_size, const int element_count, const int block_count);
   void               fortio_data_fseek(fortio_type* fortio, offset_type data_offset, size_t data_element, const int element_size, const int element_count, const int block_size);
   int                fortio_fileno( fortio_type * fortio );
+  bool               fortio_pread( fortio_type * fortio , offset_type offset , void * buffer , size_t size);
+  bool               fortio_same_format( const fortio_type * fortio1 , const fortio_type * fortio2 );
+  bool               fortio_fcopy_range( fortio_type * src , offset_type offset , offset_type size , fortio_type * target);
   bool               fortio_ftruncate( fortio_type * fortio , offset_type size);
   int                fortio_fclean(fortio_type * fortio);
 
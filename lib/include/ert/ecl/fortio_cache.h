@@ -0,0 +1,65 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'fortio_cache.h' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_FORTIO_CACHE_H
+#define ERT_FORTIO_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include <ert/ecl/fortio.h>
+
+/*
+  A set of fortio instances where at most max_open of the underlying
+  streams are open at the same time; when a stream must be opened and
+  the limit is reached the least recently used idle stream is closed.
+  The fortio instances are identified with the integer id returned
+  from fortio_cache_add(). All functions are thread safe; between
+  fortio_cache_acquire() and fortio_cache_release() the calling thread
+  has exclusive use of the fortio instance.
+
+  The shared cache from fortio_cache_get_shared() is used by the
+  ecl_file instances spanning several files, so that the limit holds
+  for all of them together.
+*/
+
+#define FORTIO_CACHE_DEFAULT_MAX_OPEN 64
+
+typedef struct fortio_cache_struct fortio_cache_type;
+
+  fortio_cache_type * fortio_cache_alloc( int max_open );
+  void                fortio_cache_free( fortio_cache_type * cache );
+  fortio_cache_type * fortio_cache_get_shared( void );
+  void                fortio_cache_set_max_open( fortio_cache_type * cache , int max_open );
+  int                 fortio_cache_get_max_open( const fortio_cache_type * cache );
+  int                 fortio_cache_get_num_open( const fortio_cache_type * cache );
+  int                 fortio_cache_get_size( const fortio_cache_type * cache );
+  int                 fortio_cache_add( fortio_cache_type * cache , fortio_type * fortio );
+  void                fortio_cache_remove( fortio_cache_type * cache , int id );
+  const char        * fortio_cache_iget_filename( const fortio_cache_type * cache , int id );
+  fortio_type       * fortio_cache_acquire( fortio_cache_type * cache , int id );
+  void                fortio_cache_release( fortio_cache_type * cache , int id );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -23,6 +23,9 @@
 #include <stdbool.h>
 #include <stdio.h>
 
+#include <ert/util/arena.h>
+#include <ert/util/str_intern.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -106,6 +109,28 @@ typedef enum {ECL_SMSPEC_INVALID_VAR            =  0 ,
                                             int param_index, 
                                             float default_value);
 
+  smspec_node_type * smspec_node_alloc_arena( arena_type * arena ,
+                                              str_intern_type * strings ,
+                                              ecl_smspec_var_type var_type ,
+                                              const char * wgname  ,
+                                              const char * keyword ,
+                                              const char * unit    ,
+                                              const char * key_join_string ,
+                                              const int grid_dims[3] ,
+                                              int num , int param_index, float default_value);
+
+  smspec_node_type * smspec_node_alloc_lgr_arena( arena_type * arena ,
+                                                  str_intern_type * strings ,
+                                                  ecl_smspec_var_type var_type ,
+                                                  const char * wgname  ,
+                                                  const char * keyword ,
+                                                  const char * unit    ,
+                                                  const char * lgr ,
+                                                  const char * key_join_string ,
+                                                  int   lgr_i, int lgr_j , int lgr_k,
+                                                  int param_index,
+                                                  float default_value);
+
   smspec_node_type *  smspec_node_alloc_new(int params_index, float default_value);
   smspec_node_type *  smspec_node_alloc_copy( const smspec_node_type* );
 
@@ -28,6 +28,7 @@ extern "C" {
 #include <stdbool.h>
 
 #include <ert/util/type_macros.h>
+#include <ert/util/arena.h>
 
 #include <ert/ecl/ecl_rsthead.h>
 
@@ -54,6 +55,7 @@ extern "C" {
   bool             well_conn_MSW(const well_conn_type * conn);
 
   well_conn_type * well_conn_alloc_from_kw( const ecl_kw_type * icon_kw , const ecl_kw_type * scon_kw , const ecl_kw_type* xcon_kw, const ecl_rsthead_type * header , int well_nr , int conn_nr);
+  well_conn_type * well_conn_alloc_from_kw_arena( arena_type * arena , const ecl_kw_type * icon_kw , const ecl_kw_type * scon_kw , const ecl_kw_type* xcon_kw, const ecl_rsthead_type * header , int well_nr , int conn_nr);
   well_conn_type * well_conn_alloc_wellhead( const ecl_kw_type * iwel_kw , const ecl_rsthead_type * header , int well_nr);
 
   int                well_conn_get_i(const well_conn_type * conn);
@@ -26,6 +26,7 @@ extern "C" {
 #endif
 
 #include <ert/util/type_macros.h>
+#include <ert/util/arena.h>
 
 #include <ert/ecl/ecl_kw.h>
 
@@ -34,6 +35,7 @@ extern "C" {
 typedef struct well_conn_collection_struct well_conn_collection_type;
 
 well_conn_collection_type * well_conn_collection_alloc(void);
+well_conn_collection_type * well_conn_collection_alloc_arena(arena_type * arena);
 void                   well_conn_collection_free(well_conn_collection_type * wellcc);
 void                   well_conn_collection_free__(void * arg);
 int                    well_conn_collection_get_size(const well_conn_collection_type * wellcc);
@@ -0,0 +1,50 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'geo_io.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_GEO_IO_H
+#define ERT_GEO_IO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#define GEO_IO_FORMAT_BUFFER_SIZE 512
+
+  typedef struct geo_io_reader_struct geo_io_reader_type;
+  typedef struct geo_io_writer_struct geo_io_writer_type;
+
+  geo_io_reader_type * geo_io_reader_alloc( FILE * stream );
+  void                 geo_io_reader_free( geo_io_reader_type * reader );
+  bool                 geo_io_reader_read_double( geo_io_reader_type * reader , double * value );
+  bool                 geo_io_reader_at_eof( geo_io_reader_type * reader );
+
+  geo_io_writer_type * geo_io_writer_alloc( FILE * stream );
+  void                 geo_io_writer_free( geo_io_writer_type * writer );
+  void                 geo_io_writer_flush( geo_io_writer_type * writer );
+  void                 geo_io_writer_puts( geo_io_writer_type * writer , const char * s );
+  void                 geo_io_writer_fixed( geo_io_writer_type * writer , double value , int width , int decimals );
+
+  int                  geo_io_format_fixed( char * buffer , double value , int width , int decimals );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
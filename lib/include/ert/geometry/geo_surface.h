@@ -39,12 +39,19 @@ extern "C" {
   geo_surface_type  * geo_surface_alloc_new( int nx, int ny, double xinc, double yinc, double xstart, double ystart, double angle );
   bool                geo_surface_fload_irap_zcoord( const geo_surface_type * surface, const char * filename, double *zlist);
   double              geo_surface_iget_zvalue(const geo_surface_type * surface, int index);
+  void                geo_surface_iset_zvalue(geo_surface_type * surface, int index , double value);
   int                 geo_surface_get_size( const geo_surface_type * surface );
   void                geo_surface_fprintf_irap( const geo_surface_type * surface, const char * filename );
   void                geo_surface_fprintf_irap_external_zcoord( const geo_surface_type * surface, const char * filename , const double * zcoord);
+  geo_surface_type  * geo_surface_fload_alloc_irap_binary( const char * filename , bool loadz);
+  bool                geo_surface_fload_irap_binary_zcoord( const geo_surface_type * surface, const char * filename, double *zlist);
+  void                geo_surface_fwrite_irap_binary( const geo_surface_type * surface, const char * filename );
+  void                geo_surface_fwrite_irap_binary_external_zcoord( const geo_surface_type * surface, const char * filename , const double * zcoord);
   int                 geo_surface_get_nx( const geo_surface_type * surface );
   int                 geo_surface_get_ny( const geo_surface_type * surface );
   void                geo_surface_iget_xy( const geo_surface_type* surface, int index, double* x, double* y);
+  void                geo_surface_get_lattice_coord( const geo_surface_type * surface , double x , double y , double * u , double * v);
+  bool                geo_surface_interpolate_z( const geo_surface_type * surface , double x , double y , double * z);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,49 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'arena.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ARENA_H
+#define ERT_ARENA_H
+
+#include <stdlib.h>
+
+#include <ert/util/type_macros.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct arena_struct arena_type;
+
+  arena_type * arena_alloc( size_t block_size );
+  void         arena_free( arena_type * arena );
+  void         arena_clear( arena_type * arena );
+
+  void       * arena_malloc( arena_type * arena , size_t size );
+  void       * arena_calloc( arena_type * arena , size_t elements , size_t element_size );
+  char       * arena_alloc_string_copy( arena_type * arena , const char * src );
+  char       * arena_alloc_substring_copy( arena_type * arena , const char * src , size_t offset , size_t N );
+
+  size_t       arena_get_used( const arena_type * arena );
+  size_t       arena_get_capacity( const arena_type * arena );
+
+UTIL_IS_INSTANCE_HEADER( arena );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
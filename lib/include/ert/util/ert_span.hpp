@@ -0,0 +1,88 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_span.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_SPAN_HPP
+#define ERT_SPAN_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ERT {
+
+    /*
+      Non owning view of a contiguous range of elements; modelled after
+      std::span from C++20, but usable from C++11 code. The span is only
+      valid as long as the memory it points into is alive - use the RAII
+      view classes (EclKWView, EclSum::column(), ...) to tie the
+      lifetime to the owner.
+    */
+
+    template< typename T >
+    class span {
+    public:
+        using element_type = T;
+        using value_type = typename std::remove_cv< T >::type;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        span() noexcept = default;
+        span( T* data, size_type size ) noexcept :
+            m_data( data ), m_size( size )
+        {}
+
+        /* A span< T > converts implicitly to span< const T >. */
+        template< typename U,
+                  typename = typename std::enable_if< std::is_convertible< U(*)[], T(*)[] >::value >::type >
+        span( const span< U >& other ) noexcept :
+            m_data( other.data() ), m_size( other.size() )
+        {}
+
+        T* data() const noexcept { return this->m_data; }
+        size_type size() const noexcept { return this->m_size; }
+        bool empty() const noexcept { return this->m_size == 0; }
+
+        iterator begin() const noexcept { return this->m_data; }
+        iterator end() const noexcept { return this->m_data + this->m_size; }
+
+        T& operator[]( size_type i ) const { return this->m_data[ i ]; }
+
+        T& at( size_type i ) const {
+            if( i >= this->m_size )
+                throw std::out_of_range( "span index out of range" );
+            return this->m_data[ i ];
+        }
+
+        T& front() const { return this->m_data[ 0 ]; }
+        T& back() const { return this->m_data[ this->m_size - 1 ]; }
+
+        span subspan( size_type offset, size_type count ) const {
+            if( offset + count > this->m_size )
+                throw std::out_of_range( "subspan out of range" );
+            return span( this->m_data + offset, count );
+        }
+
+    private:
+        T* m_data = nullptr;
+        size_type m_size = 0;
+    };
+
+}
+
+#endif
@@ -119,6 +119,8 @@ typedef struct matrix_struct matrix_type;
 
 
   void          matrix_inplace_matmul(matrix_type * A, const matrix_type * B);
+  void          matrix_native_dgemm(matrix_type * C , const matrix_type * A , const matrix_type * B , bool transA , bool transB , double alpha , double beta);
+  void          matrix_native_gram_set( const matrix_type * X , matrix_type * G , bool col);
   void          matrix_inplace_matmul_mt1(matrix_type * A, const matrix_type * B , int num_threads);
 #ifdef HAVE_THREAD_POOL
   void          matrix_inplace_matmul_mt2(matrix_type * A, const matrix_type * B , thread_pool_type * thread_pool);
@@ -133,6 +135,10 @@ typedef struct matrix_struct matrix_type;
   double        matrix_get_column_abssum(const matrix_type * matrix , int column);
   double        matrix_get_row_sum2(const matrix_type * matrix , int column);
   void          matrix_subtract_row_mean(matrix_type * matrix);
+  void          matrix_get_row_sums(const matrix_type * matrix , double * row_sum);
+  void          matrix_get_row_means(const matrix_type * matrix , double * row_mean);
+  void          matrix_get_column_sums(const matrix_type * matrix , double * column_sum);
+  void          matrix_subtract_row_vector(matrix_type * matrix , const double * row_values);
   void          matrix_subtract_and_store_row_mean(matrix_type * matrix, matrix_type * row_mean);
   void          matrix_scale_column(matrix_type * matrix , int column  , double scale_factor);
   void          matrix_scale_row(matrix_type * matrix , int row  , double scale_factor);
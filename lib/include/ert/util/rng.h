@@ -23,6 +23,7 @@
 extern "C" {
 #endif
 #include <stdio.h>
+#include <stdbool.h>
 
 #include <ert/util/type_macros.h>
 
@@ -36,7 +37,8 @@ typedef enum {
 
 
 typedef enum {
-  MZRAN = 1
+  MZRAN   = 1,
+  XOSHIRO = 2     /* xoshiro128++ - supports rng_jump() and independent streams. */
 } rng_alg_type;
 
 
@@ -47,6 +49,7 @@ typedef enum {
   typedef void         ( rng_free_ftype )           ( void * );
   typedef void         ( rng_fscanf_ftype )         ( void * , FILE * );
   typedef void         ( rng_fprintf_ftype )        ( const void * , FILE * );
+  typedef void         ( rng_jump_ftype )           ( void * );
 
   typedef struct rng_struct rng_type;
 
@@ -73,6 +76,13 @@ typedef enum {
   unsigned int    rng_get_max_int(const rng_type * rng);
 
   double          rng_std_normal( rng_type * rng );
+  void            rng_fill_double( rng_type * rng , double * data , size_t size);
+  void            rng_fill_std_normal( rng_type * rng , double * data , size_t size);
+  void            rng_fill_std_normal_mt( rng_type * rng , double * data , size_t size , int num_threads);
+
+  bool            rng_can_jump( const rng_type * rng );
+  void            rng_jump( rng_type * rng );
+  rng_type      * rng_alloc_split( rng_type * rng );
   void            rng_shuffle_int( rng_type * rng , int * data , size_t num_elements);
   void            rng_shuffle( rng_type * rng , char * data , size_t element_size , size_t num_elements);
   void            rng_free__( void * arg);
@@ -0,0 +1,61 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'str_hash.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_STR_HASH_H
+#define ERT_STR_HASH_H
+
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+#include <ert/util/node_data.h>
+#include <ert/util/stringlist.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct str_hash_struct str_hash_type;
+
+  str_hash_type   * str_hash_alloc( void );
+  void              str_hash_free( str_hash_type * str_hash );
+  void              str_hash_free__( void * arg );
+  void              str_hash_reserve( str_hash_type * str_hash , int size );
+  void              str_hash_clear( str_hash_type * str_hash );
+  void              str_hash_freeze( str_hash_type * str_hash );
+  bool              str_hash_is_frozen( const str_hash_type * str_hash );
+
+  void              str_hash_insert_ref( str_hash_type * str_hash , const char * key , const void * value);
+  void              str_hash_insert_owned_ref( str_hash_type * str_hash , const char * key , const void * value , free_ftype * del);
+
+  bool              str_hash_has_key( const str_hash_type * str_hash , const char * key );
+  void            * str_hash_get( const str_hash_type * str_hash , const char * key );
+  void            * str_hash_safe_get( const str_hash_type * str_hash , const char * key );
+  int               str_hash_get_size( const str_hash_type * str_hash );
+
+  const char      * str_hash_iget_key( const str_hash_type * str_hash , int index);
+  void            * str_hash_iget_value( const str_hash_type * str_hash , int index);
+  stringlist_type * str_hash_alloc_stringlist( const str_hash_type * str_hash );
+  char           ** str_hash_alloc_keylist( const str_hash_type * str_hash );
+
+UTIL_IS_INSTANCE_HEADER( str_hash );
+UTIL_SAFE_CAST_HEADER( str_hash );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
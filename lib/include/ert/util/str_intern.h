@@ -0,0 +1,49 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'str_intern.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_STR_INTERN_H
+#define ERT_STR_INTERN_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ert/util/type_macros.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct str_intern_struct str_intern_type;
+
+  str_intern_type * str_intern_alloc( void );
+  void              str_intern_free( str_intern_type * strings );
+  void              str_intern_clear( str_intern_type * strings );
+
+  const char      * str_intern_add( str_intern_type * strings , const char * s );
+  const char      * str_intern_add_substring( str_intern_type * strings , const char * s , size_t N );
+  const char      * str_intern_get( const str_intern_type * strings , const char * s );
+  bool              str_intern_has( const str_intern_type * strings , const char * s );
+  bool              str_intern_is_interned( const str_intern_type * strings , const char * s );
+  int               str_intern_get_size( const str_intern_type * strings );
+
+UTIL_IS_INSTANCE_HEADER( str_intern );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -185,6 +185,11 @@ typedef enum {left_pad   = 0,
   void         util_rewind(FILE * stream);
   int          util_stat(const char * filename , stat_type * stat_info);
   int          util_fstat(int fileno, stat_type * stat_info);
+  bool         util_pread(int fd , void * buffer , size_t size , offset_type offset);
+  bool         util_pwrite(int fd , const void * buffer , size_t size , offset_type offset);
+  bool         util_fallocate(int fd , offset_type size);
+  bool         util_copy_fd(int src_fd , int target_fd , size_t buffer_size , void * buffer);
+  bool         util_copy_fd_range(int src_fd , offset_type src_offset , int target_fd , offset_type target_offset , offset_type size , size_t buffer_size , void * buffer);
 
 
 
@@ -287,6 +292,7 @@ typedef enum {left_pad   = 0,
   bool         util_is_first_day_in_month_utc( time_t t);
 
   unsigned int util_dev_urandom_seed( );
+  int          util_get_num_cpu( void );
   unsigned int util_clock_seed( void );
   void         util_fread_dev_random(int , char * );
   void         util_fread_dev_urandom(int , char * );
@@ -0,0 +1,46 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'xoshiro.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_XOSHIRO_H
+#define ERT_XOSHIRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+
+typedef struct xoshiro_struct xoshiro_type;
+
+#define XOSHIRO_MAX_VALUE  4294967296
+#define XOSHIRO_STATE_SIZE 16             /* Size of the seed buffer - in bytes. */
+
+
+void              xoshiro_fscanf_state( void * __rng , FILE * stream );
+unsigned int      xoshiro_forward(void * __rng);
+void              xoshiro_jump(void * __rng);
+void            * xoshiro_alloc( void );
+void              xoshiro_set_state(void * __rng , const char * seed_buffer);
+void              xoshiro_get_state(void * __rng , char * state_buffer);
+void              xoshiro_fprintf_state( const void * __rng , FILE * stream);
+void              xoshiro_free( void * __rng );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,229 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'arena.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+#include <ert/util/arena.h>
+
+/*
+  The arena is a simple bump allocator for objects which are created
+  in large numbers and all share the lifetime of one owner object,
+  like the ecl_file_kw instances of an ecl_file or the smspec_node
+  instances of an ecl_smspec. Memory is handed out sequentially from
+  large blocks allocated with malloc(); there is no way to free an
+  individual allocation, instead all the memory is released in one go
+  with arena_clear() or arena_free().
+
+  All allocations are aligned to ARENA_ALIGNMENT bytes. The first
+  block is small, and the size of each new block is doubled until it
+  reaches the block size given to arena_alloc(); that way an arena
+  which only holds a handful of objects does not waste a full
+  block. Requests which are larger than a quarter of the block size
+  get a block of their own, so that the remaining space in the
+  current block is not wasted. The arena is not thread safe.
+*/
+
+#define ARENA_TYPE_ID          55101873
+#define ARENA_ALIGNMENT        16
+#define ARENA_DEFAULT_BLOCK    (64 * 1024)
+#define ARENA_MIN_BLOCK        512
+
+#define ARENA_ALIGN(size) (((size) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1))
+
+
+typedef struct arena_block_struct arena_block_type;
+
+struct arena_block_struct {
+  arena_block_type * next;
+  size_t             size;
+  size_t             used;
+};
+
+/* The data of a block starts at this offset from the block header. */
+#define ARENA_BLOCK_HEADER ARENA_ALIGN(sizeof(arena_block_type))
+
+
+struct arena_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  size_t             block_size;
+  size_t             next_block_size;
+  size_t             used;
+  size_t             capacity;
+  arena_block_type * blocks;       /* The head of the list is the block currently being filled. */
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( arena , ARENA_TYPE_ID )
+
+
+/*
+  block_size == 0 will give the default block size of 64kB.
+*/
+
+arena_type * arena_alloc( size_t block_size ) {
+  arena_type * arena = util_malloc( sizeof * arena );
+  UTIL_TYPE_ID_INIT( arena , ARENA_TYPE_ID );
+  if (block_size == 0)
+    block_size = ARENA_DEFAULT_BLOCK;
+
+  arena->block_size = ARENA_ALIGN( block_size );
+  arena->next_block_size = util_size_t_min( ARENA_MIN_BLOCK , arena->block_size );
+  arena->used = 0;
+  arena->capacity = 0;
+  arena->blocks = NULL;
+  return arena;
+}
+
+
+static arena_block_type * arena_alloc_block( arena_type * arena , size_t size ) {
+  arena_block_type * block = util_malloc( ARENA_BLOCK_HEADER + size );
+  block->size = size;
+  block->used = 0;
+  arena->capacity += size;
+  return block;
+}
+
+
+void arena_clear( arena_type * arena ) {
+  arena_block_type * block = arena->blocks;
+  while (block) {
+    arena_block_type * next = block->next;
+    free( block );
+    block = next;
+  }
+  arena->blocks = NULL;
+  arena->next_block_size = util_size_t_min( ARENA_MIN_BLOCK , arena->block_size );
+  arena->used = 0;
+  arena->capacity = 0;
+}
+
+
+void arena_free( arena_type * arena ) {
+  arena_clear( arena );
+  free( arena );
+}
+
+
+void * arena_malloc( arena_type * arena , size_t size ) {
+  arena_block_type * block = arena->blocks;
+  size = ARENA_ALIGN( size );
+
+  if (size > arena->block_size / 4) {
+    /*
+      Large allocation: a dedicated block which is linked in behind
+      the current block, so that the current block can still be used
+      for small allocations.
+    */
+    arena_block_type * large_block = arena_alloc_block( arena , size );
+    large_block->used = size;
+    if (block) {
+      large_block->next = block->next;
+      block->next = large_block;
+    } else {
+      large_block->next = NULL;
+      arena->blocks = large_block;
+    }
+    arena->used += size;
+    return (char *) large_block + ARENA_BLOCK_HEADER;
+  }
+
+  if ((block == NULL) || (block->size - block->used < size)) {
+    while (arena->next_block_size < size)
+      arena->next_block_size *= 2;
+
+    block = arena_alloc_block( arena , arena->next_block_size );
+    arena->next_block_size = util_size_t_min( 2 * arena->next_block_size , arena->block_size );
+    block->next = arena->blocks;
+    arena->blocks = block;
+  }
+
+  {
+    void * ptr = (char *) block + ARENA_BLOCK_HEADER + block->used;
+    block->used += size;
+    arena->used += size;
+    return ptr;
+  }
+}
+
+
+void * arena_calloc( arena_type * arena , size_t elements , size_t element_size ) {
+  void * ptr = arena_malloc( arena , elements * element_size );
+  memset( ptr , 0 , elements * element_size );
+  return ptr;
+}
+
+
+/*
+  Like util_alloc_substring_copy(); will copy at most N characters
+  starting at offset. The src string can be NULL, in which case NULL
+  is returned.
+*/
+
+char * arena_alloc_substring_copy( arena_type * arena , const char * src , size_t offset , size_t N ) {
+  if (src == NULL)
+    return NULL;
+  {
+    size_t length = strlen( src );
+    char * copy;
+
+    if (offset > length)
+      offset = length;
+
+    if (N > length - offset)
+      N = length - offset;
+
+    copy = arena_malloc( arena , N + 1 );
+    memcpy( copy , &src[offset] , N );
+    copy[N] = '\0';
+    return copy;
+  }
+}
+
+
+char * arena_alloc_string_copy( arena_type * arena , const char * src ) {
+  if (src == NULL)
+    return NULL;
+  {
+    size_t size = strlen( src ) + 1;
+    char * copy = arena_malloc( arena , size );
+    memcpy( copy , src , size );
+    return copy;
+  }
+}
+
+
+/*
+  The number of bytes handed out, including alignment padding.
+*/
+
+size_t arena_get_used( const arena_type * arena ) {
+  return arena->used;
+}
+
+
+/*
+  The number of bytes allocated from the system, excluding the block
+  headers.
+*/
+
+size_t arena_get_capacity( const arena_type * arena ) {
+  return arena->capacity;
+}
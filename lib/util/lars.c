@@ -126,7 +126,7 @@ static double sgn(double x) {
 }
 
 
-static void lars_estimate_init( lars_type * lars, matrix_type * X , matrix_type * Y) {
+static void lars_estimate_init( lars_type * lars, matrix_type * X , matrix_type * Y , int max_vars) {
   int nvar     = matrix_get_columns( lars->X );
   
   matrix_assign( X , lars->X );
@@ -141,7 +141,7 @@ static void lars_estimate_init( lars_type * lars, matrix_type * X , matrix_type
 
   if (lars->beta != NULL)
     matrix_free( lars->beta );
-  lars->beta = matrix_alloc( nvar , nvar );
+  lars->beta = matrix_alloc( nvar , max_vars );
   lars->Y_mean = regression_scale( X , Y , lars->X_mean , lars->X_norm);
 }
 
@@ -186,45 +186,100 @@ void lars_select_beta( lars_type * lars , int beta_index) {
      correlation level.
 
   4. Update the beta estimate and the current 'location' mu.
+
+  The Gram matrix of the active covariates is never formed and
+  inverted explicitly. Instead a Cholesky factor @L of X_A'X_A is
+  extended with one row each time a covariate enters the active set,
+  and the equiangular direction is found with two triangular
+  solves. The correlations @C are not recalculated from the residual;
+  when mu is moved a step gamma*u the correlations are updated as
+  C -= gamma*X'u. All work matrices are allocated once, before the
+  iterations start.
+*/
+
+
+/*
+  Extends the Cholesky factor @L of the active Gram matrix with the
+  column @new_var of @X; @active_set must already contain the indices
+  of the @active_size covariates which are factorized in @L.
+*/
+
+static void lars_cholesky_add( matrix_type * L , const matrix_type * X , const int_vector_type * active_set , int active_size , int new_var) {
+  double d2 = matrix_column_column_dot_product( X , new_var , X , new_var );
+  int i,j;
+
+  for (i=0; i < active_size; i++) {
+    double l = matrix_column_column_dot_product( X , int_vector_iget( active_set , i ) , X , new_var );
+    for (j=0; j < i; j++)
+      l -= matrix_iget( L , i , j ) * matrix_iget( L , active_size , j );
+    l /= matrix_iget( L , i , i );
+    matrix_iset( L , active_size , i , l );
+    d2 -= l*l;
+  }
+  matrix_iset( L , active_size , active_size , sqrt( util_double_max( d2 , 1e-12 )));
+}
+
+
+/*
+  Solves (L*L')*z = s in place, where L is the @size x @size leading
+  block of the lower triangular matrix @L.
 */
 
+static void lars_cholesky_solve( const matrix_type * L , int size , matrix_type * z) {
+  int i,j;
+  for (i=0; i < size; i++) {
+    double value = matrix_iget( z , i , 0 );
+    for (j=0; j < i; j++)
+      value -= matrix_iget( L , i , j ) * matrix_iget( z , j , 0 );
+    matrix_iset( z , i , 0 , value / matrix_iget( L , i , i ));
+  }
+
+  for (i=size - 1; i >= 0; i--) {
+    double value = matrix_iget( z , i , 0 );
+    for (j=i+1; j < size; j++)
+      value -= matrix_iget( L , j , i ) * matrix_iget( z , j , 0 );
+    matrix_iset( z , i , 0 , value / matrix_iget( L , i , i ));
+  }
+}
+
+
 void lars_estimate(lars_type * lars , int max_vars , double max_beta , bool verbose) {
   int nvars       = matrix_get_columns( lars->X );
   int nsample     = matrix_get_rows( lars->X );
   matrix_type * X = matrix_alloc( nsample, nvars );    // Allocate local X and Y variables
   matrix_type * Y = matrix_alloc( nsample, 1 );        // which will hold the normalized data 
-  lars_estimate_init( lars , X , Y);                   // during the estimation process.
+
+  if ((max_vars <= 0) || (max_vars > nvars))
+    max_vars = nvars;
+
+  lars_estimate_init( lars , X , Y , max_vars );       // during the estimation process.
   {
-    matrix_type * G                = matrix_alloc_gram( X , true );
-    matrix_type * mu               = matrix_alloc( nsample , 1 );
     matrix_type * C                = matrix_alloc( nvars , 1 );
-    matrix_type * Y_mu             = matrix_alloc_copy( Y ); 
+    matrix_type * equi_corr        = matrix_alloc( nvars , 1 );
+    matrix_type * u                = matrix_alloc( nsample , 1 );
+    matrix_type * L                = matrix_alloc( max_vars , max_vars );
+    matrix_type * weights          = matrix_alloc( max_vars , 1 );
     int_vector_type * active_set   = int_vector_alloc(0,0);
     int_vector_type * inactive_set = int_vector_alloc(0,0);
     int    active_size;
 
-    
-    if ((max_vars <= 0) || (max_vars > nvars))
-      max_vars = nvars;
-    
     {
       int i;
       for (i=0; i < nvars; i++)
         int_vector_iset( inactive_set , i , i );
     }
-    matrix_set( mu , 0 );
+    matrix_dgemm( C , X , Y , true , false , 1.0 , 0);      // C = X' * Y
 
     while (true) {
       double maxC = 0;
 
       /*
-        The first step is to calculate the correlations between the
-        covariates, and the current residual. All the currently inactive
-        covariates are searched; the covariate with the greatest
-        correlation with (Y - mu) is selected and added to the active set.
+        The first step is to find the covariate with the greatest
+        correlation with the current residual (Y - mu). All the
+        currently inactive covariates are searched; the covariate with
+        the greatest correlation is selected and added to the active
+        set.
       */
-      matrix_sub( Y_mu , Y , mu );                            // Y_mu = Y - mu 
-      matrix_dgemm( C , X , Y_mu , true , false , 1.0 , 0);   // C    = X' * Y_mu
       { 
         int i;
         int max_set_index = 0;
@@ -240,141 +295,87 @@ void lars_estimate(lars_type * lars , int max_vars , double max_beta , bool verb
         }
         /* 
            Remove element corresponding to max_set_index from the
-           inactive set and add it to the active set:
+           inactive set, extend the Cholesky factor and add it to the
+           active set:
         */
-        int_vector_append( active_set , int_vector_idel( inactive_set , max_set_index ));
+        {
+          int new_var = int_vector_idel( inactive_set , max_set_index );
+          lars_cholesky_add( L , X , active_set , int_vector_size( active_set ) , new_var );
+          int_vector_append( active_set , new_var );
+        }
       }
       active_size = int_vector_size( active_set );
-      /*
-        Now we have calculated the correlations between all the
-        covariates and the current residual @Y_mu. The correlations are
-        stored in the matrix @C. The value of the maximum correlation is
-        stored in @maxC.
-      
-        Based on the value of @maxC we have added one new covariate to
-        the model, technically by moving the index from @inactive_set to
-        @active_set.
-      */
 
       /*****************************************************************/
 
 
       {
-        matrix_type * weights     = matrix_alloc( active_size , 1);
         double scale;
 
-        /*****************************************************************/
-        /* This scope should compute and initialize the variables
-           @weights and @scale. */
+        /*
+          The equiangular weights are given by:
+
+             weights = scale * inv(G_A) * s
+
+          where G_A = X_A'X_A is the Gram matrix of the active
+          covariates, s is the vector of signs of the correlations
+          between the active covariates and the residual, and
+          scale = 1/sqrt(s' * inv(G_A) * s).
+        */
         {
-          matrix_type * subG        = matrix_alloc( active_size , active_size );
-          matrix_type * STS         = matrix_alloc( active_size , active_size );
-          matrix_type * sign_vector = matrix_alloc( active_size , 1);
-          int i , j;
-
-          /*
-            STS = S' o S where 'o' is the Schur product and S is given
-            by:
-
-            [  s1   s2   s3   s4 ]  
-        S = [  s1   s2   s3   s4 ]
-            [  s1   s2   s3   s4 ]
-            [  s1   s2   s3   s4 ]
-
-            Where si is the sign of the correlation between (active)
-            variable 'i' and Y_mu.
-          */
+          double sz = 0;
+          int i;
 
-                
           for (i=0; i < active_size ; i++) {
-            int     vari  = int_vector_iget( active_set , i );
-            double  signi = sgn( matrix_iget( C , vari , 0));
-            matrix_iset( sign_vector , i , 0 , signi );
-            for (j=0; j < active_size; j++) {
-              int     varj  = int_vector_iget( active_set , j );
-              double  signj = sgn( matrix_iget( C , varj , 0));
-            
-              matrix_iset( STS , i , j , signi * signj );
-            }
+            int vari = int_vector_iget( active_set , i );
+            matrix_iset( weights , i , 0 , sgn( matrix_iget( C , vari , 0)));
           }
-        
-          // Extract the elements from G corresponding to active indices and
-          // copy to the matrix subG:
+          lars_cholesky_solve( L , active_size , weights );
+
           for (i=0; i < active_size ; i++) {
-            int ii = int_vector_iget( active_set , i );
-            for (j=0; j < active_size; j++) {
-              int jj = int_vector_iget( active_set , j );
-            
-              matrix_iset( subG , i , j , matrix_iget(G , ii , jj));
-            }
-          }
-      
-          // Weights 
-          matrix_inplace_mul( subG , STS );  
-          matrix_inv( subG );
-        
-          {
-            matrix_type * ones = matrix_alloc( active_size , 1 );
-            matrix_type * GA1  = matrix_alloc( active_size , 1 );
-          
-            matrix_set( ones , 1.0 );
-            matrix_matmul( GA1 , subG , ones );
-            scale = 1.0 / sqrt( matrix_get_column_sum( GA1 , 0 ));
-          
-            matrix_mul( weights , GA1 , sign_vector );
-            matrix_scale( weights , scale );
-          
-            matrix_free( GA1 );
-            matrix_free( ones );
+            int vari = int_vector_iget( active_set , i );
+            sz += sgn( matrix_iget( C , vari , 0)) * matrix_iget( weights , i , 0 );
           }
-        
-          matrix_free( sign_vector );
-          matrix_free( subG );
-          matrix_free( STS );
+          scale = 1.0 / sqrt( sz );
+          matrix_scale( weights , scale );
         }
       
         /******************************************************************/
         /* The variables weight and scale have been calculated, proceed
            to calculate the step length @gamma. */ 
         {
-          int i;
+          int i,j;
           double  gamma;
-        
-          {
-            matrix_type * u = matrix_alloc( nsample , 1 );
-            int j;
-
-            for (i=0; i < nsample; i++) {
-              double row_sum = 0;
-              for (j =0; j < active_size; j++) 
-                row_sum += matrix_iget( X , i , int_vector_iget( active_set , j)) * matrix_iget(weights , j , 0 );
-            
-              matrix_iset( u , i , 0 , row_sum );
-            }
+
+          /* u = X_A * weights */
+          matrix_set( u , 0 );
+          for (j =0; j < active_size; j++) {
+            int var_index = int_vector_iget( active_set , j );
+            double w      = matrix_iget( weights , j , 0 );
+            for (i=0; i < nsample; i++)
+              matrix_iadd( u , i , 0 , matrix_iget( X , i , var_index ) * w);
+          }
           
-            gamma = maxC / scale;
-            if (active_size < matrix_get_columns( X )) {
-              matrix_type * equi_corr = matrix_alloc( nvars , 1 );
-              matrix_dgemm( equi_corr , X , u , true , false , 1.0 , 0);     // equi_corr = X'u
-              for (i=0; i < (nvars - active_size); i++) {
-                int var_index  = int_vector_iget( inactive_set , i );
-                double gamma1  = (maxC - matrix_iget(C , var_index , 0 )) / ( scale - matrix_iget( equi_corr , var_index , 0));
-                double gamma2  = (maxC + matrix_iget(C , var_index , 0 )) / ( scale + matrix_iget( equi_corr , var_index , 0));
+          gamma = maxC / scale;
+          if (active_size < nvars) {
+            matrix_dgemm( equi_corr , X , u , true , false , 1.0 , 0);     // equi_corr = X'*u
+            for (i=0; i < (nvars - active_size); i++) {
+              int var_index  = int_vector_iget( inactive_set , i );
+              double gamma1  = (maxC - matrix_iget(C , var_index , 0 )) / ( scale - matrix_iget( equi_corr , var_index , 0));
+              double gamma2  = (maxC + matrix_iget(C , var_index , 0 )) / ( scale + matrix_iget( equi_corr , var_index , 0));
               
-                if ((gamma1 > 0) && (gamma1 < gamma))
-                  gamma = gamma1;
+              if ((gamma1 > 0) && (gamma1 < gamma))
+                gamma = gamma1;
               
-                if ((gamma2 > 0) && (gamma2 < gamma))
-                  gamma = gamma2;
+              if ((gamma2 > 0) && (gamma2 < gamma))
+                gamma = gamma2;
               
-              }
-              matrix_free( equi_corr );
             }
-            /* Update the current estimated 'location' mu. */
-            matrix_scale( u , gamma );
-            matrix_inplace_add( mu , u );
-            matrix_free( u );
-          } 
+
+            /* Moving mu -> mu + gamma*u changes the correlations with X'*(gamma*u). */
+            for (i=0; i < nvars; i++)
+              matrix_isub( C , i , 0 , gamma * matrix_iget( equi_corr , i , 0 ));
+          }
       
           /* 
              We have calculated the step length @gamma, and the @weights. Update the @beta matrix.
@@ -385,8 +386,6 @@ void lars_estimate(lars_type * lars , int max_vars , double max_beta , bool verb
           if (active_size > 1) 
             for (i=0; i < nvars; i++)
               matrix_iadd( lars->beta , i , active_size - 1 , matrix_iget( lars->beta , i , active_size - 2)); 
-        
-          matrix_free( weights );
         }
       }
     
@@ -414,10 +413,11 @@ void lars_estimate(lars_type * lars , int max_vars , double max_beta , bool verb
         }
       }
     }
-    matrix_free( G );
-    matrix_free( mu );
     matrix_free( C );
-    matrix_free( Y_mu );
+    matrix_free( equi_corr );
+    matrix_free( u );
+    matrix_free( L );
+    matrix_free( weights );
     int_vector_free( active_set );
     int_vector_free( inactive_set );
     matrix_resize( lars->beta , nvars , active_size , true );
@@ -29,6 +29,10 @@
 #include <ert/util/arg_pack.h>
 #include <ert/util/rng.h>
 
+#ifdef ERT_HAVE_LAPACK
+#include <ert/util/matrix_blas.h>
+#endif
+
 /**
    This is V E R Y  S I M P L E matrix implementation. It is not
    designed to be fast/efficient or anything. It is purely a minor
@@ -1024,17 +1028,30 @@ void matrix_inplace_div(matrix_type * A , const matrix_type * B) {
          matrix_transpose(X , X)
 
    will fail in mysterious ways.
+
+   The transpose is done in square tiles of MATRIX_TRANSPOSE_BLOCK x
+   MATRIX_TRANSPOSE_BLOCK elements, so that both the reads from A and
+   the writes to T stay within a limited number of cache lines.
 */
 
+#define MATRIX_TRANSPOSE_BLOCK 32
+
 void matrix_transpose(const matrix_type * A , matrix_type * T) {
   if ((A->columns == T->rows) && (A->rows == T->columns)) {
-    int i,j;
-    for (i=0; i < A->rows; i++) {
-      for (j=0; j < A->columns; j++) {
-        size_t src_index    = GET_INDEX(A , i , j );
-        size_t target_index = GET_INDEX(T , j , i );
-
-        T->data[ target_index ] = A->data[ src_index ];
+    int i0,j0;
+    for (j0=0; j0 < A->columns; j0 += MATRIX_TRANSPOSE_BLOCK) {
+      int j1 = util_int_min( j0 + MATRIX_TRANSPOSE_BLOCK , A->columns );
+      for (i0=0; i0 < A->rows; i0 += MATRIX_TRANSPOSE_BLOCK) {
+        int i1 = util_int_min( i0 + MATRIX_TRANSPOSE_BLOCK , A->rows );
+        int i,j;
+        for (j=j0; j < j1; j++) {
+          for (i=i0; i < i1; i++) {
+            size_t src_index    = GET_INDEX(A , i , j );
+            size_t target_index = GET_INDEX(T , j , i );
+
+            T->data[ target_index ] = A->data[ src_index ];
+          }
+        }
       }
     }
   } else
@@ -1058,6 +1075,204 @@ matrix_type * matrix_alloc_transpose( const matrix_type * A) {
 }
 
 
+/*****************************************************************/
+/* Native blocked matrix multiplication.
+
+   The matrix_native_dgemm() function implements the same operation
+   as the BLAS based matrix_dgemm() in matrix_blas.c:
+
+       C = alpha * op(A) * op(B)  +  beta * C
+
+   but without any external dependencies. The op(A) matrix is packed
+   block by block into a contiguous column major buffer of at most
+   MATRIX_GEMM_ROW_BLOCK x MATRIX_GEMM_INNER_BLOCK elements, and each
+   column of C is then updated with contiguous axpy operations against
+   the packed block; the inner loop is a unit stride loop which the
+   compiler can vectorize.
+
+   For large products the columns of C are distributed over a
+   thread_pool. Every thread packs its own A blocks, the result does
+   not depend on the number of threads.
+*/
+
+#define MATRIX_GEMM_ROW_BLOCK     128
+#define MATRIX_GEMM_INNER_BLOCK   256
+#define MATRIX_GEMM_MT_FLOPS      4000000.0
+
+
+static double matrix_op_iget( const matrix_type * M , bool trans , int i , int j) {
+  if (trans)
+    return M->data[ GET_INDEX( M , j , i ) ];
+  else
+    return M->data[ GET_INDEX( M , i , j ) ];
+}
+
+
+static void matrix_native_dgemm__(matrix_type * C , const matrix_type * A , const matrix_type * B , bool transA , bool transB , double alpha , double beta , int col_offset , int num_cols) {
+  const int m = C->rows;
+  const int k = transA ? A->rows : A->columns;
+  double * packed = (double*)util_calloc( MATRIX_GEMM_ROW_BLOCK * MATRIX_GEMM_INNER_BLOCK , sizeof * packed );
+  double * tmp    = (double*)util_calloc( MATRIX_GEMM_ROW_BLOCK , sizeof * tmp );
+  int i0,k0,i,j,l;
+
+  for (j=col_offset; j < col_offset + num_cols; j++) {
+    if (beta == 0) {
+      for (i=0; i < m; i++)
+        C->data[ GET_INDEX( C , i , j ) ] = 0;
+    } else if (beta != 1) {
+      for (i=0; i < m; i++)
+        C->data[ GET_INDEX( C , i , j ) ] *= beta;
+    }
+  }
+
+  if (alpha != 0) {
+    for (i0 = 0; i0 < m; i0 += MATRIX_GEMM_ROW_BLOCK) {
+      const int mb = util_int_min( MATRIX_GEMM_ROW_BLOCK , m - i0 );
+      for (k0 = 0; k0 < k; k0 += MATRIX_GEMM_INNER_BLOCK) {
+        const int kb = util_int_min( MATRIX_GEMM_INNER_BLOCK , k - k0 );
+
+        for (l=0; l < kb; l++)
+          for (i=0; i < mb; i++)
+            packed[ i + l*mb ] = matrix_op_iget( A , transA , i0 + i , k0 + l );
+
+        for (j=col_offset; j < col_offset + num_cols; j++) {
+          for (i=0; i < mb; i++)
+            tmp[i] = 0;
+
+          for (l=0; l < kb; l++) {
+            const double b = matrix_op_iget( B , transB , k0 + l , j );
+            if (b != 0) {
+              const double * a = &packed[ l*mb ];
+              for (i=0; i < mb; i++)
+                tmp[i] += a[i] * b;
+            }
+          }
+
+          for (i=0; i < mb; i++)
+            C->data[ GET_INDEX( C , i0 + i , j ) ] += alpha * tmp[i];
+        }
+      }
+    }
+  }
+
+  free( tmp );
+  free( packed );
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+static void * matrix_native_dgemm_mt__(void * arg) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  matrix_type * C        = (matrix_type*)      arg_pack_iget_ptr( arg_pack , 0 );
+  const matrix_type * A  = (const matrix_type*)arg_pack_iget_const_ptr( arg_pack , 1 );
+  const matrix_type * B  = (const matrix_type*)arg_pack_iget_const_ptr( arg_pack , 2 );
+  bool transA            =                     arg_pack_iget_bool( arg_pack , 3 );
+  bool transB            =                     arg_pack_iget_bool( arg_pack , 4 );
+  double alpha           =                     arg_pack_iget_double( arg_pack , 5 );
+  double beta            =                     arg_pack_iget_double( arg_pack , 6 );
+  int col_offset         =                     arg_pack_iget_int( arg_pack , 7 );
+  int num_cols           =                     arg_pack_iget_int( arg_pack , 8 );
+
+  matrix_native_dgemm__( C , A , B , transA , transB , alpha , beta , col_offset , num_cols );
+  return NULL;
+}
+
+#endif
+
+
+static int matrix_gemm_num_threads( const matrix_type * C , int k ) {
+  double flops = 2.0 * C->rows * C->columns * k;
+  if (flops < MATRIX_GEMM_MT_FLOPS)
+    return 1;
+  return util_int_max( 1 , util_int_min( util_get_num_cpu() , C->columns ));
+}
+
+
+void matrix_native_dgemm(matrix_type * C , const matrix_type * A , const matrix_type * B , bool transA , bool transB , double alpha , double beta) {
+  int innerA = transA ? A->rows    : A->columns;
+  int outerA = transA ? A->columns : A->rows;
+  int innerB = transB ? B->columns : B->rows;
+  int outerB = transB ? B->rows    : B->columns;
+
+  if ((innerA != innerB) || (outerA != C->rows) || (outerB != C->columns))
+    util_abort("%s: size mismatch: C:[%d,%d]  A:[%d,%d]  B:[%d,%d] \n",__func__ ,
+               C->rows , C->columns , A->rows , A->columns , B->rows , B->columns);
+
+  if ((C->data == A->data) || (C->data == B->data))
+    util_abort("%s: the target matrix C can not share storage with A or B\n",__func__);
+
+  {
+    int num_threads = matrix_gemm_num_threads( C , innerA );
+#ifdef ERT_HAVE_THREAD_POOL
+    if (num_threads > 1) {
+      thread_pool_type * thread_pool = thread_pool_alloc( num_threads , true );
+      arg_pack_type ** arglist = (arg_pack_type**)util_malloc( num_threads * sizeof * arglist );
+      int cols       = C->columns / num_threads;
+      int cols_mod   = C->columns % num_threads;
+      int col_offset = 0;
+      int it;
+
+      for (it = 0; it < num_threads; it++) {
+        int num_cols = cols + ((it < cols_mod) ? 1 : 0);
+        arglist[it] = arg_pack_alloc();
+        arg_pack_append_ptr( arglist[it] , C );
+        arg_pack_append_const_ptr( arglist[it] , A );
+        arg_pack_append_const_ptr( arglist[it] , B );
+        arg_pack_append_bool( arglist[it] , transA );
+        arg_pack_append_bool( arglist[it] , transB );
+        arg_pack_append_double( arglist[it] , alpha );
+        arg_pack_append_double( arglist[it] , beta );
+        arg_pack_append_int( arglist[it] , col_offset );
+        arg_pack_append_int( arglist[it] , num_cols );
+        thread_pool_add_job( thread_pool , matrix_native_dgemm_mt__ , arglist[it] );
+        col_offset += num_cols;
+      }
+      thread_pool_join( thread_pool );
+
+      for (it = 0; it < num_threads; it++)
+        arg_pack_free( arglist[it] );
+      free( arglist );
+      thread_pool_free( thread_pool );
+      return;
+    }
+#endif
+    matrix_native_dgemm__( C , A , B , transA , transB , alpha , beta , 0 , C->columns );
+  }
+}
+
+
+/**
+   Will calculate the Gram matrix G = X'*X (col == true) or G = X*X'
+   (col == false) with the native kernel; see matrix_gram_set() in
+   matrix_blas.c for the BLAS based version.
+*/
+
+void matrix_native_gram_set( const matrix_type * X , matrix_type * G , bool col) {
+  if (col)
+    matrix_native_dgemm( G , X , X , true , false , 1 , 0 );
+  else
+    matrix_native_dgemm( G , X , X , false , true , 1 , 0 );
+}
+
+
+/*
+  Internal dispatch: when the library has been built with BLAS/LAPACK
+  support, and the matrices have the column major layout expected by
+  BLAS, the product is calculated with dgemm(), otherwise with the
+  native kernel above.
+*/
+
+static void matrix_gemm__(matrix_type * C , const matrix_type * A , const matrix_type * B , bool transA , bool transB , double alpha , double beta) {
+#ifdef ERT_HAVE_LAPACK
+  if ((A->row_stride == 1) && (B->row_stride == 1) && (C->row_stride == 1)) {
+    matrix_dgemm( C , A , B , transA , transB , alpha , beta );
+    return;
+  }
+#endif
+  matrix_native_dgemm( C , A , B , transA , transB , alpha , beta );
+}
+
 
 /**
    For this function to work the following must be satisfied:
@@ -1066,33 +1281,32 @@ matrix_type * matrix_alloc_transpose( const matrix_type * A) {
 
    For general matrix multiplactions where A = B * C all have
    different dimensions you can use matrix_matmul() (which calls the
-   BLAS routine dgemm());
+   BLAS routine dgemm()) or matrix_native_dgemm().
+
+   The product is calculated for blocks of MATRIX_GEMM_ROW_BLOCK rows
+   of A at a time into a scratch matrix, which is then copied back to
+   A; i.e. the temporary storage is one block of rows and not a copy
+   of A.
 */
 
 
 void matrix_inplace_matmul(matrix_type * A, const matrix_type * B) {
   if ((A->columns == B->rows) && (B->rows == B->columns)) {
-    double * tmp = (double*)util_malloc( sizeof * A->data * A->columns );
-    int i,j,k;
-
-    for (i=0; i < A->rows; i++) {
+    int block_rows = util_int_min( MATRIX_GEMM_ROW_BLOCK , A->rows );
+    matrix_type * scratch = matrix_alloc( util_int_max( 1 , block_rows ) , A->columns );
 
-      /* Clearing the tmp vector */
-      for (k=0; k < B->rows; k++)
-        tmp[k] = 0;
+    for (int row = 0; row < A->rows; row += block_rows) {
+      int rows = util_int_min( block_rows , A->rows - row );
+      matrix_type * A_view       = matrix_alloc_shared( A , row , 0 , rows , A->columns );
+      matrix_type * scratch_view = matrix_alloc_shared( scratch , 0 , 0 , rows , A->columns );
 
-      for (j=0; j < B->rows; j++) {
-        double scalar_product = 0;
-        for (k=0; k < A->columns; k++)
-          scalar_product += A->data[ GET_INDEX(A,i,k) ] * B->data[ GET_INDEX(B,k,j) ];
+      matrix_gemm__( scratch_view , A_view , B , false , false , 1 , 0 );
+      matrix_assign( A_view , scratch_view );
 
-        /* Assign first to tmp[j] */
-        tmp[j] = scalar_product;
-      }
-      for (j=0; j < A->columns; j++)
-        A->data[ GET_INDEX(A , i, j) ] = tmp[j];
+      matrix_free( scratch_view );
+      matrix_free( A_view );
     }
-    free(tmp);
+    matrix_free( scratch );
   } else
     util_abort("%s: size mismatch: A:[%d,%d]   B:[%d,%d]\n",__func__ , matrix_get_rows(A) , matrix_get_columns(A) , matrix_get_rows(B) , matrix_get_columns(B));
 }
@@ -1265,6 +1479,52 @@ void matrix_shift_row(matrix_type * matrix , int row , double shift) {
 
 
 
+/**
+   The row functions above access the matrix with a stride equal to
+   the number of rows. The functions below calculate the reductions
+   for all the rows in one pass over the matrix, column by column,
+   i.e. with unit stride for the default column major storage.
+*/
+
+void matrix_get_row_sums(const matrix_type * matrix , double * row_sum) {
+  int i,j;
+  for (i=0; i < matrix->rows; i++)
+    row_sum[i] = 0;
+
+  for (j=0; j < matrix->columns; j++)
+    for (i=0; i < matrix->rows; i++)
+      row_sum[i] += matrix->data[ GET_INDEX( matrix , i , j ) ];
+}
+
+
+void matrix_get_row_means(const matrix_type * matrix , double * row_mean) {
+  int i;
+  matrix_get_row_sums( matrix , row_mean );
+  for (i=0; i < matrix->rows; i++)
+    row_mean[i] /= matrix->columns;
+}
+
+
+void matrix_get_column_sums(const matrix_type * matrix , double * column_sum) {
+  int j;
+  for (j=0; j < matrix->columns; j++)
+    column_sum[j] = matrix_get_column_sum( matrix , j );
+}
+
+
+/**
+   Will subtract element i of the vector from all the elements on row
+   i of the matrix.
+*/
+
+void matrix_subtract_row_vector(matrix_type * matrix , const double * row_values) {
+  int i,j;
+  for (j=0; j < matrix->columns; j++)
+    for (i=0; i < matrix->rows; i++)
+      matrix->data[ GET_INDEX( matrix , i , j ) ] -= row_values[i];
+}
+
+
 /**
    For each row in the matrix we will do the operation
 
@@ -1272,20 +1532,20 @@ void matrix_shift_row(matrix_type * matrix , int row , double shift) {
 */
 
 void matrix_subtract_row_mean(matrix_type * matrix) {
-		int i;
-		for ( i=0; i < matrix->rows; i++) {
-    double row_mean = matrix_get_row_sum(matrix , i) / matrix->columns;
-    matrix_shift_row( matrix , i , -row_mean);
-  }
+  double * row_mean = (double*)util_calloc( matrix->rows , sizeof * row_mean );
+  matrix_get_row_means( matrix , row_mean );
+  matrix_subtract_row_vector( matrix , row_mean );
+  free( row_mean );
 }
 
 void matrix_subtract_and_store_row_mean(matrix_type * matrix, matrix_type * row_mean) {
-        int i;
-        for ( i=0; i < matrix->rows; i++) {
-    double mean = matrix_get_row_sum(matrix , i) / matrix->columns;
-    matrix_shift_row( matrix , i , -mean);
-    matrix_iset(row_mean , i , 0, mean );
-  }
+  double * mean = (double*)util_calloc( matrix->rows , sizeof * mean );
+  int i;
+  matrix_get_row_means( matrix , mean );
+  matrix_subtract_row_vector( matrix , mean );
+  for ( i=0; i < matrix->rows; i++)
+    matrix_iset(row_mean , i , 0, mean[i] );
+  free( mean );
 }
 
 void matrix_imul_col( matrix_type * matrix , int column , double factor) {
@@ -20,10 +20,17 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/util.h>
 #include <ert/util/rng.h>
 #include <ert/util/mzran.h>
+#include <ert/util/xoshiro.h>
 #include <ert/util/type_macros.h>
+
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#include <ert/util/arg_pack.h>
+#endif
 #define RNG_TYPE_ID 66154432
 
 #ifdef __cplusplus
@@ -48,6 +55,7 @@ struct rng_struct {
   rng_free_ftype       * free_state;
   rng_fscanf_ftype     * fscanf_state;     /* Loads the state from a formatted file with (integer representation of) bytes. */
   rng_fprintf_ftype    * fprintf_state;    /* Writes the state as a formatted series of bytes. */
+  rng_jump_ftype       * jump;             /* Advances the state a large fixed number of steps; NULL if the algorithm does not support it. */
   /******************************************************************/
   rng_alg_type           type;
   void                 * state;            /* The current state - the return value from alloc_state() - passed as parameter to all the function pointers. */
@@ -68,6 +76,7 @@ rng_type * rng_alloc__(rng_alloc_ftype     * alloc_state,
                        rng_get_state_ftype * get_state  ,
                        rng_fscanf_ftype    * fscanf_state ,
                        rng_fprintf_ftype   * fprintf_state ,
+                       rng_jump_ftype      * jump ,
                        rng_alg_type          type ,
                        int state_size ,
                        uint64_t max_value) {
@@ -81,6 +90,7 @@ rng_type * rng_alloc__(rng_alloc_ftype     * alloc_state,
   rng->get_state     = get_state;
   rng->fscanf_state  = fscanf_state;
   rng->fprintf_state = fprintf_state;
+  rng->jump          = jump;
 
   rng->state_size   = state_size;
   rng->max_value    = max_value;
@@ -171,10 +181,24 @@ rng_type * rng_alloc( rng_alg_type type , rng_init_mode init_mode ) {
                        mzran_get_state ,
                        mzran_fscanf_state ,
                        mzran_fprintf_state ,
+                       NULL ,
                        type ,
                        MZRAN_STATE_SIZE ,
                        MZRAN_MAX_VALUE );
     break;
+  case(XOSHIRO):
+    rng = rng_alloc__( xoshiro_alloc ,
+                       xoshiro_free ,
+                       xoshiro_forward ,
+                       xoshiro_set_state ,
+                       xoshiro_get_state ,
+                       xoshiro_fscanf_state ,
+                       xoshiro_fprintf_state ,
+                       xoshiro_jump ,
+                       type ,
+                       XOSHIRO_STATE_SIZE ,
+                       XOSHIRO_MAX_VALUE );
+    break;
   default:
     util_abort("%s: rng type:%d not recognized \n",__func__ , type);
     rng = NULL;
@@ -292,6 +316,188 @@ double rng_std_normal( rng_type * rng ) {
   return sqrt(-2.0 * log(R1)) * cos(2.0 * pi * R2);
 }
 
+
+/*****************************************************************/
+/* Bulk generation and streams.
+
+   The rng_fill_xxx() functions fill a whole array in one call. The
+   random integers are first drawn into a small buffer, and the
+   conversion to double values is then done in a separate loop
+   without function pointer calls - that loop can be vectorized by
+   the compiler.
+
+   Observe that rng_fill_std_normal() uses both the cos() and the
+   sin() branch of the Box-Muller transform, i.e. it consumes one
+   uniform number per normal number and will not give the same values
+   as repeated calls to rng_std_normal().
+*/
+
+#define RNG_FILL_BUFFER_SIZE 256
+
+void rng_fill_double( rng_type * rng , double * data , size_t size) {
+  unsigned int buffer[RNG_FILL_BUFFER_SIZE];
+  size_t offset = 0;
+
+  while (offset < size) {
+    size_t block_size = util_size_t_min( RNG_FILL_BUFFER_SIZE , size - offset );
+    size_t i;
+
+    for (i=0; i < block_size; i++)
+      buffer[i] = rng->forward( rng->state );
+
+    for (i=0; i < block_size; i++)
+      data[offset + i] = buffer[i] * rng->inv_max;
+
+    offset += block_size;
+  }
+}
+
+
+void rng_fill_std_normal( rng_type * rng , double * data , size_t size) {
+  const double pi = 3.141592653589;
+  double uniform[RNG_FILL_BUFFER_SIZE];
+  size_t offset = 0;
+
+  while (offset < size) {
+    size_t block_size = util_size_t_min( RNG_FILL_BUFFER_SIZE , size - offset );
+    size_t num_pairs = (block_size + 1) / 2;
+    size_t i;
+
+    rng_fill_double( rng , uniform , 2 * num_pairs );
+    for (i=0; i < num_pairs; i++) {
+      double R1 = 1.0 - uniform[2*i];              /* In (0,1] - avoid log(0). */
+      double R2 = uniform[2*i + 1];
+      double r = sqrt(-2.0 * log(R1));
+      double theta = 2.0 * pi * R2;
+
+      uniform[2*i]     = r * cos( theta );
+      uniform[2*i + 1] = r * sin( theta );
+    }
+    memcpy( &data[offset] , uniform , block_size * sizeof * data );
+    offset += block_size;
+  }
+}
+
+
+bool rng_can_jump( const rng_type * rng ) {
+  return (rng->jump != NULL);
+}
+
+
+void rng_jump( rng_type * rng ) {
+  if (rng->jump == NULL)
+    util_abort("%s: the rng algorithm:%d does not support jump\n",__func__ , rng->type);
+
+  rng->jump( rng->state );
+}
+
+
+/**
+   Will allocate a new rng instance which can be used as an
+   independent stream, e.g. in a separate thread. The new rng will
+   start at the current state of @rng, and @rng is then advanced;
+   calling rng_alloc_split() repeatedly will give a deterministic
+   series of streams.
+
+   For algorithms which support jumping - i.e. XOSHIRO - @rng is
+   advanced with rng_jump() and the streams are guaranteed to be non
+   overlapping for 2^64 draws. For MZRAN the new rng is instead seeded
+   with rng_rng_init() from @rng, which gives statistically
+   independent, but not provably disjoint, streams.
+*/
+
+rng_type * rng_alloc_split( rng_type * rng ) {
+  rng_type * stream = rng_alloc( rng->type , INIT_DEFAULT );
+  if (rng_can_jump( rng )) {
+    char * state = (char *) util_calloc( rng->state_size , sizeof * state );
+    rng_get_state( rng , state );
+    rng_set_state( stream , state );
+    rng_jump( rng );
+    free( state );
+  } else
+    rng_rng_init( stream , rng );
+
+  return stream;
+}
+
+
+/**
+   Will fill @data with standard normal values using several
+   threads. The array is divided in fixed size chunks, and every chunk
+   is filled from its own stream created with rng_alloc_split(); the
+   result is therefore independent of the number of threads.
+*/
+
+#define RNG_FILL_CHUNK_SIZE 65536
+
+static void rng_fill_std_normal_chunks( rng_type ** streams , double * data , size_t size , int first_chunk , int num_chunks , int chunk_step) {
+  int chunk;
+  for (chunk = first_chunk; chunk < num_chunks; chunk += chunk_step) {
+    size_t offset = (size_t) chunk * RNG_FILL_CHUNK_SIZE;
+    size_t chunk_size = util_size_t_min( RNG_FILL_CHUNK_SIZE , size - offset );
+    rng_fill_std_normal( streams[chunk] , &data[offset] , chunk_size );
+  }
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+static void * rng_fill_std_normal_mt__( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  rng_type ** streams = (rng_type **) arg_pack_iget_ptr( arg_pack , 0 );
+  double * data       = (double *) arg_pack_iget_ptr( arg_pack , 1 );
+  size_t size         = arg_pack_iget_size_t( arg_pack , 2 );
+  int first_chunk     = arg_pack_iget_int( arg_pack , 3 );
+  int num_chunks      = arg_pack_iget_int( arg_pack , 4 );
+  int chunk_step      = arg_pack_iget_int( arg_pack , 5 );
+
+  rng_fill_std_normal_chunks( streams , data , size , first_chunk , num_chunks , chunk_step );
+  return NULL;
+}
+
+#endif
+
+
+void rng_fill_std_normal_mt( rng_type * rng , double * data , size_t size , int num_threads) {
+  int num_chunks = (size + RNG_FILL_CHUNK_SIZE - 1) / RNG_FILL_CHUNK_SIZE;
+  rng_type ** streams = (rng_type **) util_calloc( num_chunks , sizeof * streams );
+  int chunk;
+
+  for (chunk = 0; chunk < num_chunks; chunk++)
+    streams[chunk] = rng_alloc_split( rng );
+
+  num_threads = util_int_max( 1 , util_int_min( num_threads , num_chunks ));
+#ifdef ERT_HAVE_THREAD_POOL
+  if (num_threads > 1) {
+    thread_pool_type * thread_pool = thread_pool_alloc( num_threads , true );
+    arg_pack_type ** arglist = (arg_pack_type **) util_calloc( num_threads , sizeof * arglist );
+    int it;
+
+    for (it = 0; it < num_threads; it++) {
+      arglist[it] = arg_pack_alloc();
+      arg_pack_append_ptr( arglist[it] , streams );
+      arg_pack_append_ptr( arglist[it] , data );
+      arg_pack_append_size_t( arglist[it] , size );
+      arg_pack_append_int( arglist[it] , it );
+      arg_pack_append_int( arglist[it] , num_chunks );
+      arg_pack_append_int( arglist[it] , num_threads );
+      thread_pool_add_job( thread_pool , rng_fill_std_normal_mt__ , arglist[it] );
+    }
+    thread_pool_join( thread_pool );
+
+    for (it = 0; it < num_threads; it++)
+      arg_pack_free( arglist[it] );
+    free( arglist );
+    thread_pool_free( thread_pool );
+  } else
+#endif
+    rng_fill_std_normal_chunks( streams , data , size , 0 , num_chunks , 1 );
+
+  for (chunk = 0; chunk < num_chunks; chunk++)
+    rng_free( streams[chunk] );
+  free( streams );
+}
+
 #ifdef __cplusplus
 }
 #endif
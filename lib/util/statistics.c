@@ -141,3 +141,102 @@ double statistics_empirical_quantile__( const double_vector_type * data , double
     }
   }
 }
+
+
+/**
+   Will calculate the same quantile as statistics_empirical_quantile(),
+   but the data vector is not modified and it is never sorted. The
+   lower order statistic is located with a selection algorithm in a
+   copy of the data; a linear scan then finds the extent of the run
+   of elements equal to it and the nearest distinct values above and
+   below, which is all the interpolation in
+   statistics_empirical_quantile__() needs.
+
+   The copy is made in the scratch vector, which can be reused between
+   calls to avoid allocating a new vector each time; if scratch is
+   NULL a temporary vector is used.
+*/
+
+static double statistics_empirical_quantile_interp( double lower_value , int lower_index , double upper_value , int upper_index , int size , double quantile) {
+  double upper_quantile = upper_index * 1.0 / size;
+  double lower_quantile = lower_index * 1.0 / size;
+  double a = (upper_value - lower_value) / (upper_quantile - lower_quantile);
+
+  return lower_value + a*(quantile - lower_quantile);
+}
+
+
+double statistics_empirical_quantile_select( const double_vector_type * data , double quantile , double_vector_type * scratch) {
+  if ((quantile < 0) || (quantile > 1.0))
+    util_abort("%s: quantile must be in [0,1] \n",__func__);
+
+  {
+    double_vector_type * copy = scratch ? scratch : double_vector_alloc( 0 , 0 );
+    const int size    = (double_vector_size( data ) - 1);
+    double real_index = quantile * size;
+    int lower_index   = floor( real_index );
+    int upper_index   = ceil( real_index );
+    double value;
+
+    double_vector_memcpy( copy , data );
+    value = double_vector_select_nth( copy , lower_index );
+    {
+      const double * copy_data = double_vector_get_const_ptr( copy );
+      int num_less  = 0;
+      int num_equal = 0;
+      bool has_above = false;
+      bool has_below = false;
+      double above = 0;   /* Smallest element > value. */
+      double below = 0;   /* Largest element < value.  */
+
+      for (int i = 0; i <= size; i++) {
+        double x = copy_data[i];
+        if (x < value) {
+          num_less++;
+          if (!has_below || (x > below)) {
+            below = x;
+            has_below = true;
+          }
+        } else if (x > value) {
+          if (!has_above || (x < above)) {
+            above = x;
+            has_above = true;
+          }
+        } else
+          num_equal++;
+      }
+
+      if (!has_above && !has_below)
+        /* All elements are equal. */
+        ;
+      else if ((upper_index > lower_index) && (upper_index >= num_less + num_equal))
+        /* The upper order statistic is already above the run of equal values. */
+        value = statistics_empirical_quantile_interp( value , lower_index , above , upper_index , size , quantile );
+      else {
+        /*
+           The interpolation in statistics_empirical_quantile__()
+           moves the upper index one step up and the lower index one
+           step down in turn, until one of them leaves the run
+           [run_start, run_end] of elements equal to value.
+        */
+        const int run_start = num_less;
+        const int run_end   = num_less + num_equal - 1;
+        const int upper_steps = has_above ? run_end - upper_index + 1 : -1;
+        const int lower_steps = has_below ? lower_index - run_start + 1 : -1;
+
+        if ((lower_steps < 0) || ((upper_steps >= 0) && (upper_steps <= lower_steps)))
+          value = statistics_empirical_quantile_interp( value , util_int_max( 0 , lower_index - (upper_steps - 1)) ,
+                                                        above , run_end + 1 ,
+                                                        size , quantile );
+        else
+          value = statistics_empirical_quantile_interp( below , run_start - 1 ,
+                                                        value , util_int_min( size , upper_index + lower_steps ) ,
+                                                        size , quantile );
+      }
+    }
+
+    if (copy != scratch)
+      double_vector_free( copy );
+    return value;
+  }
+}
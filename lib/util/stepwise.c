@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/util.h>
 #include <ert/util/matrix.h>
 #include <ert/util/regression.h>
@@ -8,6 +10,11 @@
 #include <ert/util/bool_vector.h>
 #include <ert/util/double_vector.h>
 
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#include <ert/util/arg_pack.h>
+#endif
+
 
 
 #define STEPWISE_TYPE_ID 8722106
@@ -137,92 +144,329 @@ static double stepwise_eval__( const stepwise_type * stepwise , const matrix_typ
 
 
 
-static double stepwise_test_var( stepwise_type * stepwise , int test_var , int blocks) {
-  double prediction_error = 0;
+/*****************************************************************/
+/*
+  Cross validation of the candidate variables.
+
+  In every iteration of stepwise_estimate() all the inactive variables
+  are tested as candidates for entering the active set. For each
+  candidate the augmented OLS problem (see regression_augmented_OLS())
+  must be solved for the active variables + the candidate, for each of
+  the cross validation folds.
+
+  Instead of solving these problems from scratch the Cholesky factor
+  of the normal equations for the current active set is calculated
+  once per fold, and every candidate is then handled as a rank one
+  extension of this factor. The cost per candidate and fold is then
+  proportional to nsample * nactive instead of nsample * nactive^2 +
+  nactive^3. All candidates are evaluated on the same random folds,
+  and the candidates are distributed over a thread_pool.
+*/
+
+#define STEPWISE_REGULARIZATION 1e-10
+#define STEPWISE_MT_LIMIT       250000
+
+typedef struct {
+  int      ntrain;
+  int      nvalid;
+  int      nactive;
+  int    * train_rows;
+  int    * valid_rows;
+  int    * active;     /* Index of the active variables. */
+  double * XA;         /* The active columns of X0 for the training rows; column major ntrain x nactive. */
+  double * EA;         /* The active columns of E0 for the training rows. */
+  double * y;          /* Y0 for the training rows. */
+  double * L;          /* Cholesky factor of XA'XA + EA'EA; row major nactive x nactive. */
+  double * w;          /* Solution of L*w = XA'y. */
+} stepwise_fold_type;
+
+
+static stepwise_fold_type * stepwise_fold_alloc( const stepwise_type * stepwise , const bool_vector_type * train , const bool_vector_type * valid) {
+  stepwise_fold_type * fold = (stepwise_fold_type*)util_malloc( sizeof * fold );
+  int nsample = matrix_get_rows( stepwise->X0 );
+  int nvar    = matrix_get_columns( stepwise->X0 );
+  int i,j,k,r;
+
+  fold->ntrain  = bool_vector_count_equal( train , true );
+  fold->nvalid  = bool_vector_count_equal( valid , true );
+  fold->nactive = bool_vector_count_equal( stepwise->active_set , true );
+
+  fold->train_rows = (int*)util_calloc( fold->ntrain , sizeof * fold->train_rows );
+  fold->valid_rows = (int*)util_calloc( fold->nvalid , sizeof * fold->valid_rows );
+  fold->active     = (int*)util_calloc( fold->nactive , sizeof * fold->active );
+  fold->XA         = (double*)util_calloc( fold->ntrain * fold->nactive , sizeof * fold->XA );
+  fold->EA         = (double*)util_calloc( fold->ntrain * fold->nactive , sizeof * fold->EA );
+  fold->y          = (double*)util_calloc( fold->ntrain , sizeof * fold->y );
+  fold->L          = (double*)util_calloc( fold->nactive * fold->nactive , sizeof * fold->L );
+  fold->w          = (double*)util_calloc( fold->nactive , sizeof * fold->w );
 
-  bool_vector_iset( stepwise->active_set , test_var , true );   // Temporarily activate this variable
   {
+    int itrain = 0;
+    int ivalid = 0;
+    for (r = 0; r < nsample; r++) {
+      if (bool_vector_iget( train , r ))
+        fold->train_rows[itrain++] = r;
+      if (bool_vector_iget( valid , r ))
+        fold->valid_rows[ivalid++] = r;
+    }
+  }
 
-    int nvar                       = matrix_get_columns( stepwise->X0 );
-    int nsample                    = matrix_get_rows( stepwise->X0 );
-    int block_size                 = nsample / blocks;
-    bool_vector_type * active_rows = bool_vector_alloc( nsample, true );
+  k = 0;
+  for (j = 0; j < nvar; j++)
+    if (bool_vector_iget( stepwise->active_set , j ))
+      fold->active[k++] = j;
 
+  for (k = 0; k < fold->nactive; k++) {
+    for (r = 0; r < fold->ntrain; r++) {
+      fold->XA[k * fold->ntrain + r] = matrix_iget( stepwise->X0 , fold->train_rows[r] , fold->active[k] );
+      fold->EA[k * fold->ntrain + r] = matrix_iget( stepwise->E0 , fold->train_rows[r] , fold->active[k] );
+    }
+  }
+  for (r = 0; r < fold->ntrain; r++)
+    fold->y[r] = matrix_iget( stepwise->Y0 , fold->train_rows[r] , 0 );
+
+  /* Cholesky factorization of the normal equations, and forward solve for the right hand side. */
+  for (i = 0; i < fold->nactive; i++) {
+    const double * xi = &fold->XA[i * fold->ntrain];
+    const double * ei = &fold->EA[i * fold->ntrain];
+    double rhs = 0;
+
+    for (j = 0; j <= i; j++) {
+      const double * xj = &fold->XA[j * fold->ntrain];
+      const double * ej = &fold->EA[j * fold->ntrain];
+      double g = (i == j) ? STEPWISE_REGULARIZATION : 0;
+
+      for (r = 0; r < fold->ntrain; r++)
+        g += xi[r] * xj[r] + ei[r] * ej[r];
+
+      for (k = 0; k < j; k++)
+        g -= fold->L[i * fold->nactive + k] * fold->L[j * fold->nactive + k];
+
+      if (i == j)
+        fold->L[i * fold->nactive + i] = sqrt( util_double_max( g , STEPWISE_REGULARIZATION ));
+      else
+        fold->L[i * fold->nactive + j] = g / fold->L[j * fold->nactive + j];
+    }
 
+    for (r = 0; r < fold->ntrain; r++)
+      rhs += xi[r] * fold->y[r];
+    for (k = 0; k < i; k++)
+      rhs -= fold->L[i * fold->nactive + k] * fold->w[k];
+    fold->w[i] = rhs / fold->L[i * fold->nactive + i];
+  }
 
+  return fold;
+}
 
 
-    /*True Cross-Validation: */
-    int * randperms     = (int*)util_calloc( nsample , sizeof * randperms );
-    for (int i=0; i < nsample; i++)
-      randperms[i] = i;
+static void stepwise_fold_free( stepwise_fold_type * fold ) {
+  free( fold->train_rows );
+  free( fold->valid_rows );
+  free( fold->active );
+  free( fold->XA );
+  free( fold->EA );
+  free( fold->y );
+  free( fold->L );
+  free( fold->w );
+  free( fold );
+}
 
-    /* Randomly perturb ensemble indices */
-    rng_shuffle_int( stepwise->rng , randperms , nsample );
 
+/*
+  Solves the regression problem for the active variables of the fold
+  extended with the variable @var, and returns the squared prediction
+  error summed over the validation rows of the fold. The @work
+  buffer must have room for 2*(ntrain + nactive) elements.
+*/
+
+static double stepwise_fold_eval( const stepwise_type * stepwise , const stepwise_fold_type * fold , int var , double * work) {
+  const int nactive = fold->nactive;
+  const int ntrain  = fold->ntrain;
+  double * xv   = work;
+  double * ev   = &work[ntrain];
+  double * l    = &work[2*ntrain];
+  double * beta = &work[2*ntrain + nactive];
+  double c = STEPWISE_REGULARIZATION;
+  double rv = 0;
+  double beta_v;
+  double d2;
+  int i,k,r;
+
+  for (r = 0; r < ntrain; r++) {
+    xv[r] = matrix_iget( stepwise->X0 , fold->train_rows[r] , var );
+    ev[r] = matrix_iget( stepwise->E0 , fold->train_rows[r] , var );
+    c  += xv[r] * xv[r] + ev[r] * ev[r];
+    rv += xv[r] * fold->y[r];
+  }
 
-    for (int iblock = 0; iblock < blocks; iblock++) {
+  /* New row of the Cholesky factor: L*l = [XA'xv + EA'ev] */
+  d2 = c;
+  for (i = 0; i < nactive; i++) {
+    const double * xi = &fold->XA[i * ntrain];
+    const double * ei = &fold->EA[i * ntrain];
+    double value = 0;
 
-      int validation_start = iblock * block_size;
-      int validation_end   = validation_start + block_size - 1;
+    for (r = 0; r < ntrain; r++)
+      value += xi[r] * xv[r] + ei[r] * ev[r];
 
-      if (iblock == (blocks - 1))
-        validation_end = nsample - 1;
+    for (k = 0; k < i; k++)
+      value -= fold->L[i * nactive + k] * l[k];
 
-      /*
-        Ensure that the active_rows vector has a block consisting of
-        the interval [validation_start : validation_end] which is set to
-        false, and the remaining part of the vector is set to true.
-      */
-      {
-        bool_vector_set_all(active_rows, true);
-        /*
-           If blocks == 1 that means all datapoint are used in the
-           regression, and then subsequently reused in the R2
-           calculation.
-        */
-        if (blocks > 1) {
-          for (int i = validation_start; i <= validation_end; i++) {
-            bool_vector_iset( active_rows , randperms[i] , false );
-          }
-        }
-      }
+    l[i] = value / fold->L[i * nactive + i];
+    d2  -= l[i] * l[i];
+    rv  -= l[i] * fold->w[i];
+  }
 
+  {
+    double d = sqrt( util_double_max( d2 , STEPWISE_REGULARIZATION ));
+    beta_v = rv / (d * d);
+  }
 
-      /*
-        Evaluate the prediction error on the validation part of the
-        dataset.
-      */
-      {
-        stepwise_estimate__( stepwise , active_rows );
-        {
-          int irow;
-          matrix_type * x_vector = matrix_alloc( 1 , nvar );
-          //matrix_type * e_vector = matrix_alloc( 1 , nvar );
-          for (irow=validation_start; irow <= validation_end; irow++) {
-            matrix_copy_row( x_vector , stepwise->X0 , 0 , randperms[irow]);
-            //matrix_copy_row( e_vector , stepwise->E0 , 0 , randperms[irow]);
-            {
-              double true_value      = matrix_iget( stepwise->Y0 , randperms[irow] , 0 );
-              double estimated_value = stepwise_eval__( stepwise , x_vector );
-              prediction_error += (true_value - estimated_value) * (true_value - estimated_value);
-              //double e_estimated_value = stepwise_eval__( stepwise , e_vector );
-              //prediction_error += e_estimated_value*e_estimated_value;
-            }
+  /* Back substitution L'*beta = w - l*beta_v for the active variables. */
+  for (i = nactive - 1; i >= 0; i--) {
+    double value = fold->w[i] - l[i] * beta_v;
+    for (k = i + 1; k < nactive; k++)
+      value -= fold->L[k * nactive + i] * beta[k];
+    beta[i] = value / fold->L[i * nactive + i];
+  }
 
-          }
-          matrix_free( x_vector );
-        }
-      }
+  {
+    double prediction_error = 0;
+    for (r = 0; r < fold->nvalid; r++) {
+      int row = fold->valid_rows[r];
+      double estimated_value = matrix_iget( stepwise->X0 , row , var ) * beta_v;
+      double true_value      = matrix_iget( stepwise->Y0 , row , 0 );
+
+      for (i = 0; i < nactive; i++)
+        estimated_value += matrix_iget( stepwise->X0 , row , fold->active[i] ) * beta[i];
+
+      prediction_error += (true_value - estimated_value) * (true_value - estimated_value);
+    }
+    return prediction_error;
+  }
+}
+
+
+static void stepwise_fold_eval_range( const stepwise_type * stepwise , const stepwise_fold_type * fold , const int * candidates , int offset , int size , double * prediction_error) {
+  double * work = (double*)util_calloc( 2 * (fold->ntrain + fold->nactive) + 1 , sizeof * work );
+  int i;
+  for (i = offset; i < offset + size; i++)
+    prediction_error[i] += stepwise_fold_eval( stepwise , fold , candidates[i] , work );
+  free( work );
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+static void * stepwise_fold_eval_mt__( void * arg ) {
+  arg_pack_type * arg_pack              = arg_pack_safe_cast( arg );
+  const stepwise_type * stepwise        = (const stepwise_type*)arg_pack_iget_const_ptr( arg_pack , 0 );
+  const stepwise_fold_type * fold       = (const stepwise_fold_type*)arg_pack_iget_const_ptr( arg_pack , 1 );
+  const int * candidates                = (const int*)arg_pack_iget_const_ptr( arg_pack , 2 );
+  int offset                            = arg_pack_iget_int( arg_pack , 3 );
+  int size                              = arg_pack_iget_int( arg_pack , 4 );
+  double * prediction_error             = (double*)arg_pack_iget_ptr( arg_pack , 5 );
+
+  stepwise_fold_eval_range( stepwise , fold , candidates , offset , size , prediction_error );
+  return NULL;
+}
+
+#endif
+
+
+static void stepwise_fold_eval_candidates( const stepwise_type * stepwise , const stepwise_fold_type * fold , const int * candidates , int num_candidates , double * prediction_error) {
+  int num_threads = 1;
+  if (1.0 * num_candidates * fold->ntrain * (fold->nactive + 1) > STEPWISE_MT_LIMIT)
+    num_threads = util_int_max( 1 , util_int_min( util_get_num_cpu() , num_candidates ));
+
+#ifdef ERT_HAVE_THREAD_POOL
+  if (num_threads > 1) {
+    thread_pool_type * thread_pool = thread_pool_alloc( num_threads , true );
+    arg_pack_type ** arglist = (arg_pack_type**)util_calloc( num_threads , sizeof * arglist );
+    int size     = num_candidates / num_threads;
+    int size_mod = num_candidates % num_threads;
+    int offset   = 0;
+    int it;
+
+    for (it = 0; it < num_threads; it++) {
+      int job_size = size + ((it < size_mod) ? 1 : 0);
+      arglist[it] = arg_pack_alloc();
+      arg_pack_append_const_ptr( arglist[it] , stepwise );
+      arg_pack_append_const_ptr( arglist[it] , fold );
+      arg_pack_append_const_ptr( arglist[it] , candidates );
+      arg_pack_append_int( arglist[it] , offset );
+      arg_pack_append_int( arglist[it] , job_size );
+      arg_pack_append_ptr( arglist[it] , prediction_error );
+      thread_pool_add_job( thread_pool , stepwise_fold_eval_mt__ , arglist[it] );
+      offset += job_size;
     }
+    thread_pool_join( thread_pool );
 
-    free( randperms );
-    bool_vector_free( active_rows );
+    for (it = 0; it < num_threads; it++)
+      arg_pack_free( arglist[it] );
+    free( arglist );
+    thread_pool_free( thread_pool );
+    return;
   }
+#endif
+  stepwise_fold_eval_range( stepwise , fold , candidates , 0 , num_candidates , prediction_error );
+}
+
+
+/*
+  Will calculate the cross validated prediction error for all the
+  @num_candidates variables in @candidates, the result is stored in
+  @prediction_error.
+*/
+
+static void stepwise_test_vars( stepwise_type * stepwise , const int * candidates , int num_candidates , int blocks , double * prediction_error) {
+  int nsample                    = matrix_get_rows( stepwise->X0 );
+  int block_size                 = nsample / blocks;
+  bool_vector_type * train_rows  = bool_vector_alloc( nsample, true );
+  bool_vector_type * valid_rows  = bool_vector_alloc( nsample, false );
+  int * randperms                = (int*)util_calloc( nsample , sizeof * randperms );
+
+  for (int i=0; i < num_candidates; i++)
+    prediction_error[i] = 0;
+
+  /*True Cross-Validation: */
+  for (int i=0; i < nsample; i++)
+    randperms[i] = i;
 
-  /*inactivate the test_var-variable after completion*/
-  bool_vector_iset( stepwise->active_set , test_var , false );
-  return prediction_error;
+  /* Randomly perturb ensemble indices */
+  rng_shuffle_int( stepwise->rng , randperms , nsample );
+
+  for (int iblock = 0; iblock < blocks; iblock++) {
+    int validation_start = iblock * block_size;
+    int validation_end   = validation_start + block_size - 1;
+
+    if (iblock == (blocks - 1))
+      validation_end = nsample - 1;
+
+    /*
+      The rows in the interval [validation_start : validation_end] are
+      used for validation, the remaining rows for the regression. If
+      blocks == 1 that means all datapoint are used in the regression,
+      and then subsequently reused in the R2 calculation.
+    */
+    bool_vector_set_all( train_rows , true );
+    bool_vector_set_all( valid_rows , false );
+    for (int i = validation_start; i <= validation_end; i++) {
+      if (blocks > 1)
+        bool_vector_iset( train_rows , randperms[i] , false );
+      bool_vector_iset( valid_rows , randperms[i] , true );
+    }
+
+    {
+      stepwise_fold_type * fold = stepwise_fold_alloc( stepwise , train_rows , valid_rows );
+      stepwise_fold_eval_candidates( stepwise , fold , candidates , num_candidates , prediction_error );
+      stepwise_fold_free( fold );
+    }
+  }
+
+  free( randperms );
+  bool_vector_free( valid_rows );
+  bool_vector_free( train_rows );
 }
 
 
@@ -231,6 +475,8 @@ void stepwise_estimate( stepwise_type * stepwise , double deltaR2_limit , int CV
   int nsample       = matrix_get_rows( stepwise->X0 );
   double currentR2 = -1;
   bool_vector_type * active_rows = bool_vector_alloc( nsample , true );
+  int * candidates               = (int*)util_calloc( nvar , sizeof * candidates );
+  double * prediction_error      = (double*)util_calloc( nvar , sizeof * prediction_error );
 
 
   /*Reset beta*/
@@ -255,12 +501,19 @@ void stepwise_estimate( stepwise_type * stepwise , double deltaR2_limit , int CV
       resulting prediction error IF this particular variable is added;
       keep track of the variable which gives the lowest prediction error.
     */
-    for (int ivar = 0; ivar < nvar; ivar++) {
-      if (!bool_vector_iget( stepwise->active_set , ivar)) {
-        double newR2 = stepwise_test_var(stepwise , ivar , CV_blocks);
+    {
+      int num_candidates = 0;
+      for (int ivar = 0; ivar < nvar; ivar++) {
+        if (!bool_vector_iget( stepwise->active_set , ivar))
+          candidates[num_candidates++] = ivar;
+      }
+
+      stepwise_test_vars( stepwise , candidates , num_candidates , CV_blocks , prediction_error );
+      for (int i = 0; i < num_candidates; i++) {
+        double newR2 = prediction_error[i];
         if ((minR2 < 0) || (newR2 < minR2)) {
           minR2 = newR2;
-          best_var = ivar;
+          best_var = candidates[i];
         }
       }
     }
@@ -297,6 +550,8 @@ void stepwise_estimate( stepwise_type * stepwise , double deltaR2_limit , int CV
   }
 
   stepwise_set_R2(stepwise, currentR2);
+  free( prediction_error );
+  free( candidates );
   bool_vector_free( active_rows );
 }
 
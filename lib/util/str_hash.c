@@ -0,0 +1,415 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'str_hash.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/str_hash.h>
+
+/*
+  The str_hash is a string keyed hash table intended for the indexes
+  the library builds internally when it loads a file; i.e. the
+  keyword index in ecl_file_view, the variable indexes in ecl_smspec,
+  the well index in ecl_rft_file and the lgr index in ecl_grid.
+
+  Compared to the general hash_type implementation:
+
+    1. The table is open addressed with Robin Hood probing; the slot
+       array only contains the full hash value and an index into a
+       dense array of entries, so a probe sequence touches one or two
+       cache lines. The full hash is compared before the key.
+
+    2. Keys shorter than STR_HASH_INLINE_SIZE - which is the case for
+       all ECLIPSE keywords, well and group names - are stored inline
+       in the entry and do not require a separate allocation.
+
+    3. The values are stored as plain pointers, with an optional
+       destructor, without the node_data wrapping.
+
+    4. There is no locking. Lookup functions never modify the
+       table. When the index is complete the owner can call
+       str_hash_freeze(), after that point any attempt to insert in
+       the table will fail with util_abort() and an arbitrary number
+       of threads can read concurrently without any synchronization.
+
+    5. Iteration with str_hash_iget_key() / str_hash_iget_value() is
+       in insertion order.
+
+  Elements can not be removed individually, only the complete table
+  can be cleared with str_hash_clear() - which also unfreezes the
+  table.
+*/
+
+
+#define STR_HASH_TYPE_ID     661871
+#define STR_HASH_INLINE_SIZE 16
+#define STR_HASH_MIN_CAPACITY 16
+
+typedef struct {
+  uint32_t       hash;
+  uint32_t       key_length;
+  union {
+    char         inline_key[STR_HASH_INLINE_SIZE];
+    char       * heap_key;
+  } key;
+  void         * value;
+  free_ftype   * del;
+} str_hash_entry_type;
+
+
+/*
+  The entry field is the index of the entry + 1; i.e. a value of zero
+  signals an empty slot.
+*/
+
+typedef struct {
+  uint32_t hash;
+  uint32_t entry;
+} str_hash_slot_type;
+
+
+struct str_hash_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  uint32_t              capacity;       /* Number of slots - always a power of two. */
+  uint32_t              size;           /* Number of entries. */
+  uint32_t              alloc_size;     /* Allocated size of the entries vector. */
+  bool                  frozen;
+  str_hash_slot_type  * slots;
+  str_hash_entry_type * entries;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( str_hash , STR_HASH_TYPE_ID )
+UTIL_SAFE_CAST_FUNCTION( str_hash , STR_HASH_TYPE_ID )
+
+
+/*
+  32 bit FNV-1a.
+*/
+
+static uint32_t str_hash_hashf( const char * key , uint32_t * length) {
+  uint32_t hash = 2166136261u;
+  const unsigned char * p = (const unsigned char *) key;
+  while (*p) {
+    hash ^= *p;
+    hash *= 16777619u;
+    p++;
+  }
+  *length = (uint32_t) (p - (const unsigned char *) key);
+  return hash;
+}
+
+
+static const char * str_hash_entry_get_key( const str_hash_entry_type * entry ) {
+  if (entry->key_length < STR_HASH_INLINE_SIZE)
+    return entry->key.inline_key;
+  else
+    return entry->key.heap_key;
+}
+
+
+static void str_hash_entry_free_value( str_hash_entry_type * entry ) {
+  if (entry->del)
+    entry->del( entry->value );
+}
+
+
+static void str_hash_entry_free( str_hash_entry_type * entry ) {
+  str_hash_entry_free_value( entry );
+  if (entry->key_length >= STR_HASH_INLINE_SIZE)
+    free( entry->key.heap_key );
+}
+
+
+static void str_hash_alloc_slots( str_hash_type * str_hash , uint32_t capacity) {
+  str_hash->capacity = capacity;
+  str_hash->slots = (str_hash_slot_type*)util_calloc( capacity , sizeof * str_hash->slots );
+}
+
+
+str_hash_type * str_hash_alloc( void ) {
+  str_hash_type * str_hash = (str_hash_type*)util_malloc( sizeof * str_hash );
+  UTIL_TYPE_ID_INIT( str_hash , STR_HASH_TYPE_ID );
+  str_hash->size = 0;
+  str_hash->alloc_size = 0;
+  str_hash->entries = NULL;
+  str_hash->frozen = false;
+  str_hash_alloc_slots( str_hash , STR_HASH_MIN_CAPACITY );
+  return str_hash;
+}
+
+
+void str_hash_clear( str_hash_type * str_hash ) {
+  uint32_t i;
+  for (i=0; i < str_hash->size; i++)
+    str_hash_entry_free( &str_hash->entries[i] );
+
+  memset( str_hash->slots , 0 , str_hash->capacity * sizeof * str_hash->slots );
+  str_hash->size = 0;
+  str_hash->frozen = false;
+}
+
+
+void str_hash_free( str_hash_type * str_hash ) {
+  str_hash_clear( str_hash );
+  free( str_hash->entries );
+  free( str_hash->slots );
+  free( str_hash );
+}
+
+
+void str_hash_free__( void * arg ) {
+  str_hash_free( str_hash_safe_cast( arg ));
+}
+
+
+void str_hash_freeze( str_hash_type * str_hash ) {
+  str_hash->frozen = true;
+}
+
+
+bool str_hash_is_frozen( const str_hash_type * str_hash ) {
+  return str_hash->frozen;
+}
+
+
+/*
+  Returns the entry index of @key, or -1 if the key is not in the
+  table. With Robin Hood probing the search can be terminated as soon
+  as we meet an element which is closer to its home slot than we are
+  to ours.
+*/
+
+static int str_hash_lookup( const str_hash_type * str_hash , const char * key , uint32_t hash) {
+  const uint32_t mask = str_hash->capacity - 1;
+  uint32_t index = hash & mask;
+  uint32_t dist = 0;
+
+  while (true) {
+    const str_hash_slot_type * slot = &str_hash->slots[index];
+    if (slot->entry == 0)
+      return -1;
+
+    if (((index - (slot->hash & mask)) & mask) < dist)
+      return -1;
+
+    if (slot->hash == hash) {
+      const str_hash_entry_type * entry = &str_hash->entries[ slot->entry - 1 ];
+      if (strcmp( str_hash_entry_get_key( entry ) , key ) == 0)
+        return slot->entry - 1;
+    }
+
+    index = (index + 1) & mask;
+    dist++;
+  }
+}
+
+
+static void str_hash_insert_slot( str_hash_type * str_hash , str_hash_slot_type slot ) {
+  const uint32_t mask = str_hash->capacity - 1;
+  uint32_t index = slot.hash & mask;
+  uint32_t dist = 0;
+
+  while (true) {
+    str_hash_slot_type * current = &str_hash->slots[index];
+    if (current->entry == 0) {
+      *current = slot;
+      return;
+    }
+
+    {
+      uint32_t current_dist = (index - (current->hash & mask)) & mask;
+      if (current_dist < dist) {
+        str_hash_slot_type tmp = *current;
+        *current = slot;
+        slot = tmp;
+        dist = current_dist;
+      }
+    }
+
+    index = (index + 1) & mask;
+    dist++;
+  }
+}
+
+
+static void str_hash_resize_slots( str_hash_type * str_hash , uint32_t capacity) {
+  uint32_t i;
+  free( str_hash->slots );
+  str_hash_alloc_slots( str_hash , capacity );
+  for (i=0; i < str_hash->size; i++) {
+    str_hash_slot_type slot = { str_hash->entries[i].hash , i + 1 };
+    str_hash_insert_slot( str_hash , slot );
+  }
+}
+
+
+/*
+  Will make sure the table can hold @size elements without further
+  reallocation. The maximum load factor is 0.80.
+*/
+
+void str_hash_reserve( str_hash_type * str_hash , int size ) {
+  if (size > 0) {
+    uint32_t capacity = str_hash->capacity;
+    while (5 * (uint64_t) size > 4 * (uint64_t) capacity)
+      capacity *= 2;
+
+    if (capacity != str_hash->capacity)
+      str_hash_resize_slots( str_hash , capacity );
+
+    if ((uint32_t) size > str_hash->alloc_size) {
+      str_hash->entries = (str_hash_entry_type*)util_realloc( str_hash->entries , size * sizeof * str_hash->entries );
+      str_hash->alloc_size = size;
+    }
+  }
+}
+
+
+/*
+  If the key is already present the existing value is replaced, and
+  the destructor of the old value is called - i.e. the same semantics
+  as hash_insert_ref() / hash_insert_hash_owned_ref().
+*/
+
+void str_hash_insert_owned_ref( str_hash_type * str_hash , const char * key , const void * value , free_ftype * del) {
+  uint32_t length;
+  uint32_t hash = str_hash_hashf( key , &length );
+  int existing;
+
+  if (str_hash->frozen)
+    util_abort("%s: tried to insert key:%s in frozen table\n",__func__ , key);
+
+  existing = str_hash_lookup( str_hash , key , hash );
+  if (existing >= 0) {
+    str_hash_entry_type * entry = &str_hash->entries[existing];
+    str_hash_entry_free_value( entry );
+    entry->value = (void *) value;
+    entry->del = del;
+    return;
+  }
+
+  if (str_hash->size == str_hash->alloc_size) {
+    uint32_t new_size = util_int_max( STR_HASH_MIN_CAPACITY , 2 * str_hash->alloc_size );
+    str_hash->entries = (str_hash_entry_type*)util_realloc( str_hash->entries , new_size * sizeof * str_hash->entries );
+    str_hash->alloc_size = new_size;
+  }
+
+  if (5 * (uint64_t) (str_hash->size + 1) > 4 * (uint64_t) str_hash->capacity)
+    str_hash_resize_slots( str_hash , 2 * str_hash->capacity );
+
+  {
+    str_hash_entry_type * entry = &str_hash->entries[ str_hash->size ];
+    entry->hash = hash;
+    entry->key_length = length;
+    if (length < STR_HASH_INLINE_SIZE)
+      memcpy( entry->key.inline_key , key , length + 1);
+    else
+      entry->key.heap_key = util_alloc_string_copy( key );
+    entry->value = (void *) value;
+    entry->del = del;
+  }
+  str_hash->size++;
+
+  {
+    str_hash_slot_type slot = { hash , str_hash->size };
+    str_hash_insert_slot( str_hash , slot );
+  }
+}
+
+
+void str_hash_insert_ref( str_hash_type * str_hash , const char * key , const void * value) {
+  str_hash_insert_owned_ref( str_hash , key , value , NULL );
+}
+
+
+bool str_hash_has_key( const str_hash_type * str_hash , const char * key ) {
+  uint32_t length;
+  uint32_t hash = str_hash_hashf( key , &length );
+  return (str_hash_lookup( str_hash , key , hash ) >= 0);
+}
+
+
+void * str_hash_safe_get( const str_hash_type * str_hash , const char * key ) {
+  uint32_t length;
+  uint32_t hash = str_hash_hashf( key , &length );
+  int index = str_hash_lookup( str_hash , key , hash );
+  if (index >= 0)
+    return str_hash->entries[index].value;
+  else
+    return NULL;
+}
+
+
+void * str_hash_get( const str_hash_type * str_hash , const char * key ) {
+  uint32_t length;
+  uint32_t hash = str_hash_hashf( key , &length );
+  int index = str_hash_lookup( str_hash , key , hash );
+  if (index < 0)
+    util_abort("%s: tried to get from key:%s which does not exist - aborting \n",__func__ , key);
+
+  return str_hash->entries[index].value;
+}
+
+
+int str_hash_get_size( const str_hash_type * str_hash ) {
+  return str_hash->size;
+}
+
+
+const char * str_hash_iget_key( const str_hash_type * str_hash , int index) {
+  if (index < 0 || (uint32_t) index >= str_hash->size)
+    util_abort("%s: invalid index:%d \n",__func__ , index);
+
+  return str_hash_entry_get_key( &str_hash->entries[index] );
+}
+
+
+void * str_hash_iget_value( const str_hash_type * str_hash , int index) {
+  if (index < 0 || (uint32_t) index >= str_hash->size)
+    util_abort("%s: invalid index:%d \n",__func__ , index);
+
+  return str_hash->entries[index].value;
+}
+
+
+stringlist_type * str_hash_alloc_stringlist( const str_hash_type * str_hash ) {
+  stringlist_type * stringlist = stringlist_alloc_new();
+  uint32_t i;
+  for (i=0; i < str_hash->size; i++)
+    stringlist_append_copy( stringlist , str_hash_entry_get_key( &str_hash->entries[i] ));
+  return stringlist;
+}
+
+
+/*
+  Returns a NULL pointer for an empty table - like hash_alloc_keylist().
+*/
+
+char ** str_hash_alloc_keylist( const str_hash_type * str_hash ) {
+  char ** keylist = NULL;
+  if (str_hash->size > 0) {
+    uint32_t i;
+    keylist = (char**)util_calloc( str_hash->size , sizeof * keylist );
+    for (i=0; i < str_hash->size; i++)
+      keylist[i] = util_alloc_string_copy( str_hash_entry_get_key( &str_hash->entries[i] ));
+  }
+  return keylist;
+}
@@ -0,0 +1,170 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'str_intern.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+#include <ert/util/arena.h>
+#include <ert/util/str_hash.h>
+#include <ert/util/str_intern.h>
+
+/*
+  The str_intern table stores one canonical copy of each distinct
+  string added to it; all subsequent str_intern_add() calls with an
+  equal string return the same pointer. Strings which have been
+  interned in the same table can therefor be compared with '==' instead
+  of strcmp(). This is used for the keyword headers of an ecl_file and
+  the keyword, well and group names of an ecl_smspec, where a small
+  number of distinct 8 character names are repeated many times.
+
+  The table is per context, i.e. typically owned by the ecl_file or
+  ecl_smspec instance, and not global; that way the interned strings
+  are released together with the owner and no locking is needed. The
+  table is not thread safe for concurrent str_intern_add() calls.
+
+  The canonical strings are stored in an arena owned by the table, the
+  str_hash only maps from the string content to the canonical
+  pointer. The key pointers of the str_hash itself can not be used
+  because they move when the hash table grows.
+*/
+
+#define STR_INTERN_TYPE_ID   77152093
+#define STR_INTERN_BLOCK     (16 * 1024)
+#define STR_INTERN_MAX_STACK 64
+
+
+struct str_intern_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  str_hash_type * index;
+  arena_type    * arena;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( str_intern , STR_INTERN_TYPE_ID )
+
+
+str_intern_type * str_intern_alloc( void ) {
+  str_intern_type * strings = util_malloc( sizeof * strings );
+  UTIL_TYPE_ID_INIT( strings , STR_INTERN_TYPE_ID );
+  strings->index = str_hash_alloc();
+  strings->arena = arena_alloc( STR_INTERN_BLOCK );
+  return strings;
+}
+
+
+/*
+  Will invalidate all the pointers which have been returned from the
+  table.
+*/
+
+void str_intern_clear( str_intern_type * strings ) {
+  str_hash_clear( strings->index );
+  arena_clear( strings->arena );
+}
+
+
+void str_intern_free( str_intern_type * strings ) {
+  str_hash_free( strings->index );
+  arena_free( strings->arena );
+  free( strings );
+}
+
+
+/*
+  Will return the canonical copy of @s, adding it to the table if it
+  is not already present. The input string can be NULL, in which case
+  NULL is returned.
+*/
+
+const char * str_intern_add( str_intern_type * strings , const char * s ) {
+  if (s == NULL)
+    return NULL;
+  {
+    const char * interned = str_hash_safe_get( strings->index , s );
+    if (!interned) {
+      char * copy = arena_alloc_string_copy( strings->arena , s );
+      str_hash_insert_ref( strings->index , copy , copy );
+      interned = copy;
+    }
+    return interned;
+  }
+}
+
+
+/*
+  As str_intern_add() but only the first N characters of @s are
+  used; this is convenient for the ECLIPSE names which are silently
+  truncated to 8 characters.
+*/
+
+const char * str_intern_add_substring( str_intern_type * strings , const char * s , size_t N ) {
+  if (s == NULL)
+    return NULL;
+
+  if (strlen( s ) <= N)
+    return str_intern_add( strings , s );
+
+  if (N < STR_INTERN_MAX_STACK) {
+    char buffer[STR_INTERN_MAX_STACK];
+    memcpy( buffer , s , N );
+    buffer[N] = '\0';
+    return str_intern_add( strings , buffer );
+  } else {
+    char * tmp = util_alloc_substring_copy( s , 0 , N );
+    const char * interned = str_intern_add( strings , tmp );
+    free( tmp );
+    return interned;
+  }
+}
+
+
+/*
+  Lookup without inserting; will return NULL if @s has not been
+  interned. When NULL is returned no string in the table is equal
+  to @s.
+*/
+
+const char * str_intern_get( const str_intern_type * strings , const char * s ) {
+  if (s == NULL)
+    return NULL;
+  return str_hash_safe_get( strings->index , s );
+}
+
+
+bool str_intern_has( const str_intern_type * strings , const char * s ) {
+  return (str_intern_get( strings , s ) != NULL);
+}
+
+
+/*
+  Checks whether the pointer @s is the canonical pointer from this
+  table, and not only an equal string.
+*/
+
+bool str_intern_is_interned( const str_intern_type * strings , const char * s ) {
+  if (s == NULL)
+    return false;
+  return (str_intern_get( strings , s ) == s);
+}
+
+
+int str_intern_get_size( const str_intern_type * strings ) {
+  return str_hash_get_size( strings->index );
+}
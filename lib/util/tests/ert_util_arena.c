@@ -0,0 +1,94 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_util_arena.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/arena.h>
+
+
+void test_alloc() {
+  arena_type * arena = arena_alloc( 1024 );
+  test_assert_true( arena_is_instance( arena ));
+  test_assert_size_t_equal( 0 , arena_get_used( arena ));
+  test_assert_size_t_equal( 0 , arena_get_capacity( arena ));
+  {
+    char * s1 = arena_alloc_string_copy( arena , "WOPR" );
+    char * s2 = arena_alloc_substring_copy( arena , "PRESSURE_KEYWORD" , 0 , 8 );
+    char * s3 = arena_alloc_substring_copy( arena , "OP_1" , 3 , 100 );
+    double * d = arena_calloc( arena , 10 , sizeof * d );
+    int i;
+
+    test_assert_NULL( arena_alloc_string_copy( arena , NULL ));
+    test_assert_string_equal( s1 , "WOPR" );
+    test_assert_string_equal( s2 , "PRESSURE" );
+    test_assert_string_equal( s3 , "1" );
+    test_assert_size_t_equal( 0 , ((uintptr_t) s2) % 16 );
+    test_assert_size_t_equal( 0 , ((uintptr_t) d) % 16 );
+    for (i=0; i < 10; i++)
+      test_assert_double_equal( 0 , d[i] );
+    test_assert_size_t_equal( 512 , arena_get_capacity( arena ));
+  }
+
+  /* Large allocations get a block of their own. */
+  {
+    size_t used = arena_get_used( arena );
+    char * large = arena_malloc( arena , 10000 );
+    char * small = arena_malloc( arena , 8 );
+    memset( large , 1 , 10000 );
+    test_assert_size_t_equal( 512 + 10000 , arena_get_capacity( arena ));
+    test_assert_size_t_equal( used + 10000 + 16 , arena_get_used( arena ));
+    test_assert_ptr_not_equal( large , small );
+  }
+
+  arena_clear( arena );
+  test_assert_size_t_equal( 0 , arena_get_used( arena ));
+  test_assert_size_t_equal( 0 , arena_get_capacity( arena ));
+  arena_free( arena );
+}
+
+
+void test_many() {
+  arena_type * arena = arena_alloc( 0 );
+  const int size = 100000;
+  int ** ptr_list = util_calloc( size , sizeof * ptr_list );
+  int i;
+
+  for (i=0; i < size; i++) {
+    ptr_list[i] = arena_malloc( arena , (1 + i % 7) * sizeof(int) );
+    ptr_list[i][0] = i;
+  }
+
+  for (i=0; i < size; i++)
+    test_assert_int_equal( i , ptr_list[i][0] );
+
+  test_assert_true( arena_get_capacity( arena ) >= arena_get_used( arena ));
+  test_assert_true( arena_get_capacity( arena ) < arena_get_used( arena ) + 64 * 1024 );
+  free( ptr_list );
+  arena_free( arena );
+}
+
+
+int main(int argc , char ** argv) {
+  test_alloc();
+  test_many();
+  exit(0);
+}
@@ -21,6 +21,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 
 #include <ert/util/test_util.h>
 #include <ert/util/test_work_area.h>
@@ -50,8 +51,119 @@ void test_copy_file( const char * executable ) {
 
 
 
+bool util_copy_file__(const char * src_file , const char * target_file, size_t buffer_size , void * buffer , bool abort_on_error);
+
+
+void test_pread_pwrite() {
+  test_work_area_type * test_area = test_work_area_alloc( "pread-pwrite" );
+  int data[1000];
+  int data2[1000];
+  int i;
+  for (i=0; i < 1000; i++)
+    data[i] = i;
+
+  {
+    int fd = open( "data" , O_RDWR | O_CREAT | O_TRUNC , 0644 );
+    test_assert_true( util_pwrite( fd , data , sizeof data , 4000 ));
+    test_assert_true( util_pwrite( fd , data , 10 * sizeof data[0] , 0 ));
+    test_assert_int_equal( 0 , lseek( fd , 0 , SEEK_CUR ));
+    test_assert_int_equal( 8000 , util_file_size( "data" ));
+
+    test_assert_true( util_pread( fd , data2 , sizeof data2 , 4000 ));
+    test_assert_mem_equal( data , data2 , sizeof data );
+    test_assert_true( util_pread( fd , data2 , 10 * sizeof data2[0] , 0 ));
+    test_assert_mem_equal( data , data2 , 10 * sizeof data[0] );
+    test_assert_false( util_pread( fd , data2 , sizeof data2 , 7000 ));
+    close( fd );
+  }
+  test_work_area_free( test_area );
+}
+
+
+void test_copy_content() {
+  test_work_area_type * test_area = test_work_area_alloc( "content-copy" );
+  const size_t size = 3 * 1024 * 1024 + 17;
+  char * data = util_malloc( size );
+  size_t i;
+  for (i=0; i < size; i++)
+    data[i] = (i * 7919) % 251;
+
+  {
+    FILE * stream = util_fopen( "src" , "w");
+    util_fwrite( data , 1 , size , stream , __func__ );
+    fclose( stream );
+  }
+
+  {
+    char buffer[1000];
+    test_assert_true( util_copy_file( "src" , "target1" ));
+    test_assert_true( util_copy_file__( "src" , "target2" , sizeof buffer , buffer , true ));
+  }
+
+  {
+    int target_size;
+    char * content = util_fread_alloc_file_content( "target1" , &target_size );
+    test_assert_int_equal( size , target_size );
+    test_assert_mem_equal( data , content , size );
+    free( content );
+
+    content = util_fread_alloc_file_content( "target2" , &target_size );
+    test_assert_int_equal( size , target_size );
+    test_assert_mem_equal( data , content , size );
+    free( content );
+  }
+
+  /* Empty files, and files where stat() does not report the size. */
+  {
+    FILE * stream = util_fopen( "empty" , "w");
+    fclose( stream );
+    test_assert_true( util_copy_file( "empty" , "empty_copy" ));
+    test_assert_int_equal( 0 , util_file_size( "empty_copy" ));
+  }
+
+  if (util_file_exists( "/proc/self/status" )) {
+    test_assert_true( util_copy_file( "/proc/self/status" , "status" ));
+    test_assert_true( util_file_size( "status" ) > 0 );
+  }
+
+  free( data );
+  test_work_area_free( test_area );
+}
+
+
+void test_copy_sparse() {
+  test_work_area_type * test_area = test_work_area_alloc( "sparse-copy" );
+  const offset_type size = 64 * 1024 * 1024;
+  const char * tail = "TAIL";
+  {
+    int fd = open( "sparse" , O_RDWR | O_CREAT | O_TRUNC , 0644 );
+    test_assert_true( util_pwrite( fd , "HEAD" , 4 , 0 ));
+    test_assert_true( util_pwrite( fd , tail , 4 , size - 4 ));
+    close( fd );
+  }
+
+  test_assert_true( util_copy_file( "sparse" , "sparse_copy" ));
+  test_assert_int_equal( size , util_file_size( "sparse_copy" ));
+  {
+    char buffer[4];
+    int fd = open( "sparse_copy" , O_RDONLY );
+    test_assert_true( util_pread( fd , buffer , 4 , 0 ));
+    test_assert_mem_equal( buffer , "HEAD" , 4 );
+    test_assert_true( util_pread( fd , buffer , 4 , size / 2 ));
+    test_assert_mem_equal( buffer , "\0\0\0\0" , 4 );
+    test_assert_true( util_pread( fd , buffer , 4 , size - 4 ));
+    test_assert_mem_equal( buffer , tail , 4 );
+    close( fd );
+  }
+  test_work_area_free( test_area );
+}
+
+
 int main(int argc , char ** argv) {
    const char * executable = argv[1];
    test_copy_file( executable );
+   test_pread_pwrite();
+   test_copy_content();
+   test_copy_sparse();
    exit(0);
 }
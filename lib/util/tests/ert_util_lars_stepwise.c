@@ -0,0 +1,126 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_util_lars_stepwise.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/matrix.h>
+#include <ert/util/bool_vector.h>
+#include <ert/util/lars.h>
+#include <ert/util/stepwise.h>
+
+#define NSAMPLE 60
+#define NVAR    25
+
+
+/*
+  Y = 3*x2 - 2*x7 + 0.5*x11 + small noise
+*/
+
+static void init_data( matrix_type * X , matrix_type * Y , rng_type * rng) {
+  int i,j;
+  for (i=0; i < NSAMPLE; i++) {
+    for (j=0; j < matrix_get_columns( X ); j++)
+      matrix_iset( X , i , j , rng_std_normal( rng ));
+
+    matrix_iset( Y , i , 0 , 3 * matrix_iget( X , i , 2 ) - 2 * matrix_iget( X , i , 7 ) + 0.5 * matrix_iget( X , i , 11 ) + 0.01 * rng_std_normal( rng ));
+  }
+}
+
+
+void test_lars() {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  matrix_type * X = matrix_alloc( NSAMPLE , NVAR );
+  matrix_type * Y = matrix_alloc( NSAMPLE , 1 );
+  lars_type * lars = lars_alloc2( X , Y , false );
+
+  init_data( X , Y , rng );
+  lars_estimate( lars , 3 , 0 , false );
+  {
+    int j;
+    for (j=0; j < NVAR; j++) {
+      if (j == 2 || j == 7 || j == 11)
+        test_assert_double_not_equal( 0 , lars_iget_beta( lars , j ));
+      else
+        test_assert_double_equal( 0 , lars_iget_beta( lars , j ));
+    }
+  }
+
+  /*
+    The full LARS path; the reference values were calculated with the
+    original implementation which formed and inverted the Gram
+    matrix explicitly.
+  */
+  lars_estimate( lars , 0 , 0 , false );
+  test_assert_true( fabs( lars_iget_beta( lars , 2 ) - 2.6654381522 ) < 1e-8 );
+  test_assert_true( fabs( lars_iget_beta( lars , 7 ) + 2.33852321303 ) < 1e-8 );
+  test_assert_true( fabs( lars_iget_beta( lars , 11 ) - 0.626787687841 ) < 1e-8 );
+  test_assert_true( fabs( lars_iget_beta( lars , 12 ) + 0.00425964422485 ) < 1e-8 );
+  test_assert_true( fabs( lars_getY0( lars ) - 0.0160799337114 ) < 1e-8 );
+
+  lars_free( lars );
+  matrix_free( Y );
+  matrix_free( X );
+  rng_free( rng );
+}
+
+
+void test_stepwise( int nvar ) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  matrix_type * X = matrix_alloc( NSAMPLE , nvar );
+  matrix_type * E = matrix_alloc( NSAMPLE , nvar );
+  matrix_type * Y = matrix_alloc( NSAMPLE , 1 );
+  stepwise_type * stepwise;
+
+  init_data( X , Y , rng );
+  stepwise = stepwise_alloc1( NSAMPLE , nvar , rng , X , E );
+  stepwise_set_Y0( stepwise , Y );
+  stepwise_estimate( stepwise , 0.5 , 5 );
+  {
+    bool_vector_type * active_set = stepwise_get_active_set( stepwise );
+    int j;
+
+    test_assert_int_equal( 3 , stepwise_get_n_active( stepwise ));
+    test_assert_true( bool_vector_iget( active_set , 2 ));
+    test_assert_true( bool_vector_iget( active_set , 7 ));
+    test_assert_true( bool_vector_iget( active_set , 11 ));
+
+    test_assert_true( fabs( stepwise_iget_beta( stepwise , 2 ) - 3 ) < 0.01 );
+    test_assert_true( fabs( stepwise_iget_beta( stepwise , 7 ) + 2 ) < 0.01 );
+    test_assert_true( fabs( stepwise_iget_beta( stepwise , 11 ) - 0.5 ) < 0.01 );
+    for (j=0; j < nvar; j++)
+      if (!bool_vector_iget( active_set , j ))
+        test_assert_double_equal( 0 , stepwise_iget_beta( stepwise , j ));
+  }
+
+  stepwise_free( stepwise );   /* Will also free Y. */
+  matrix_free( E );
+  matrix_free( X );
+  rng_free( rng );
+}
+
+
+int main(int argc , char ** argv) {
+  test_lars();
+  test_stepwise( NVAR );
+  test_stepwise( 4000 );
+  exit(0);
+}
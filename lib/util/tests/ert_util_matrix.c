@@ -22,6 +22,7 @@
 #include <math.h>
 
 #include <ert/util/bool_vector.h>
+#include <ert/util/util.h>
 #include <ert/util/test_util.h>
 #include <ert/util/statistics.h>
 #include <ert/util/test_work_area.h>
@@ -228,6 +229,131 @@ void test_inplace_sub_column() {
 }
 
 
+static double naive_op_iget( const matrix_type * M , bool trans , int i , int j) {
+  return trans ? matrix_iget( M , j , i ) : matrix_iget( M , i , j );
+}
+
+
+void test_native_dgemm__( int m , int n , int k , bool transA , bool transB) {
+  rng_type * rng = rng_alloc(MZRAN , INIT_DEFAULT );
+  matrix_type * A = transA ? matrix_alloc( k , m ) : matrix_alloc( m , k );
+  matrix_type * B = transB ? matrix_alloc( n , k ) : matrix_alloc( k , n );
+  matrix_type * C = matrix_alloc( m , n );
+  matrix_type * C0;
+  int i,j,l;
+
+  matrix_random_init( A , rng );
+  matrix_random_init( B , rng );
+  matrix_random_init( C , rng );
+  C0 = matrix_alloc_copy( C );
+
+  matrix_native_dgemm( C , A , B , transA , transB , 2.0 , 0.5 );
+  for (i=0; i < m; i++) {
+    for (j=0; j < n; j++) {
+      double sum = 0;
+      for (l=0; l < k; l++)
+        sum += naive_op_iget( A , transA , i , l ) * naive_op_iget( B , transB , l , j );
+      test_assert_double_equal( 2.0 * sum + 0.5 * matrix_iget( C0 , i , j ) , matrix_iget( C , i , j ));
+    }
+  }
+
+  matrix_free( C0 );
+  matrix_free( C );
+  matrix_free( B );
+  matrix_free( A );
+  rng_free( rng );
+}
+
+
+void test_native_dgemm() {
+  test_native_dgemm__( 7 , 5 , 3 , false , false );
+  test_native_dgemm__( 7 , 5 , 3 , true , false );
+  test_native_dgemm__( 7 , 5 , 3 , false , true );
+  test_native_dgemm__( 7 , 5 , 3 , true , true );
+  test_native_dgemm__( 300 , 45 , 301 , false , false );
+  test_native_dgemm__( 131 , 260 , 270 , true , true );
+}
+
+
+void test_inplace_matmul() {
+  rng_type * rng = rng_alloc(MZRAN , INIT_DEFAULT );
+  matrix_type * A = matrix_alloc( 200 , 150 );
+  matrix_type * B = matrix_alloc( 150 , 150 );
+  matrix_type * C = matrix_alloc( 200 , 150 );
+
+  matrix_random_init( A , rng );
+  matrix_random_init( B , rng );
+  matrix_native_dgemm( C , A , B , false , false , 1 , 0 );
+  matrix_inplace_matmul( A , B );
+  {
+    int i,j;
+    for (i=0; i < 200; i++)
+      for (j=0; j < 150; j++)
+        test_assert_double_equal( matrix_iget( C , i , j ) , matrix_iget( A , i , j ));
+  }
+
+  {
+    matrix_type * G = matrix_alloc( 150 , 150 );
+    matrix_type * CT = matrix_alloc_transpose( C );
+    matrix_native_gram_set( C , G , true );
+    matrix_native_dgemm( B , CT , C , false , false , 1 , 0 );
+    test_assert_true( matrix_equal( G , B ));
+    matrix_free( CT );
+    matrix_free( G );
+  }
+
+  matrix_free( C );
+  matrix_free( B );
+  matrix_free( A );
+  rng_free( rng );
+}
+
+
+void test_transpose() {
+  rng_type * rng = rng_alloc(MZRAN , INIT_DEFAULT );
+  matrix_type * A = matrix_alloc( 77 , 33 );
+  matrix_type * T;
+  int i,j;
+
+  matrix_random_init( A , rng );
+  T = matrix_alloc_transpose( A );
+  test_assert_int_equal( 33 , matrix_get_rows( T ));
+  test_assert_int_equal( 77 , matrix_get_columns( T ));
+  for (i=0; i < 77; i++)
+    for (j=0; j < 33; j++)
+      test_assert_double_equal( matrix_iget( A , i , j ) , matrix_iget( T , j , i ));
+
+  matrix_free( T );
+  matrix_free( A );
+  rng_free( rng );
+}
+
+
+void test_row_mean() {
+  rng_type * rng = rng_alloc(MZRAN , INIT_DEFAULT );
+  matrix_type * A = matrix_alloc( 40 , 17 );
+  matrix_type * mean = matrix_alloc( 40 , 1 );
+  double * row_sum = util_calloc( 40 , sizeof * row_sum );
+  int i;
+
+  matrix_random_init( A , rng );
+  matrix_get_row_sums( A , row_sum );
+  for (i=0; i < 40; i++)
+    test_assert_double_equal( matrix_get_row_sum( A , i ) , row_sum[i] );
+
+  matrix_subtract_and_store_row_mean( A , mean );
+  for (i=0; i < 40; i++) {
+    test_assert_double_equal( row_sum[i] / 17 , matrix_iget( mean , i , 0 ));
+    test_assert_true( fabs( matrix_get_row_sum( A , i )) < 1e-10 );
+  }
+
+  free( row_sum );
+  matrix_free( mean );
+  matrix_free( A );
+  rng_free( rng );
+}
+
+
 int main( int argc , char ** argv) {
   test_create_invalid();
   test_resize();
@@ -238,5 +364,9 @@ int main( int argc , char ** argv) {
   test_diag_std();
   test_masked_copy();
   test_inplace_sub_column();
+  test_native_dgemm();
+  test_inplace_matmul();
+  test_transpose();
+  test_row_mean();
   exit(0);
 }
@@ -17,16 +17,106 @@
 */
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <math.h>
 
 #include <ert/util/test_util.h>
 #include <ert/util/util.h>
 #include <ert/util/rng.h>
 #include <ert/util/mzran.h>
+#include <ert/util/xoshiro.h>
 
 
 #define MAX_INT 666661
 
+
+void test_xoshiro_state() {
+  rng_type * rng = rng_alloc( XOSHIRO , INIT_DEFAULT );
+  char * buffer = util_calloc( rng_state_size( rng ) , sizeof * buffer );
+  int val1, val2;
+
+  test_assert_int_equal( XOSHIRO_STATE_SIZE , rng_state_size( rng ));
+  test_assert_true( rng_can_jump( rng ));
+  rng_get_state( rng , buffer );
+  val1 = rng_get_int( rng , MAX_INT );
+  val2 = rng_get_int( rng , MAX_INT );
+  test_assert_int_not_equal( val1 , val2 );
+
+  rng_set_state( rng , buffer );
+  test_assert_int_equal( val1 , rng_get_int( rng , MAX_INT ));
+
+  /* The all zero state is invalid and replaced with the default state. */
+  memset( buffer , 0 , rng_state_size( rng ));
+  rng_set_state( rng , buffer );
+  test_assert_int_equal( val1 , rng_get_int( rng , MAX_INT ));
+
+  free( buffer );
+  rng_free( rng );
+}
+
+
+void test_split() {
+  rng_type * rng1 = rng_alloc( XOSHIRO , INIT_DEFAULT );
+  rng_type * rng2 = rng_alloc( XOSHIRO , INIT_DEFAULT );
+  rng_type * stream1 = rng_alloc_split( rng1 );
+  rng_type * stream2 = rng_alloc_split( rng1 );
+  unsigned int first = rng_forward( rng2 );
+
+  test_assert_uint_equal( first , rng_forward( stream1 ));
+  test_assert_uint_not_equal( first , rng_forward( stream2 ));
+
+  rng_init( rng2 , INIT_DEFAULT );
+  rng_jump( rng2 );
+  rng_jump( rng2 );
+  test_assert_uint_equal( rng_forward( rng2 ) , rng_forward( rng1 ));
+
+  rng_free( stream2 );
+  rng_free( stream1 );
+  rng_free( rng2 );
+  rng_free( rng1 );
+}
+
+
+void test_fill( rng_alg_type alg ) {
+  const size_t size = 200001;
+  double * data1 = util_calloc( size , sizeof * data1 );
+  double * data2 = util_calloc( size , sizeof * data2 );
+  rng_type * rng1 = rng_alloc( alg , INIT_DEFAULT );
+  rng_type * rng2 = rng_alloc( alg , INIT_DEFAULT );
+  size_t i;
+
+  rng_fill_double( rng1 , data1 , 1000 );
+  for (i=0; i < 1000; i++) {
+    test_assert_double_equal( data1[i] , rng_get_double( rng2 ));
+    test_assert_true( data1[i] >= 0 && data1[i] < 1 );
+  }
+
+  rng_fill_std_normal_mt( rng1 , data1 , size , 1 );
+  rng_fill_std_normal_mt( rng2 , data2 , size , 4 );
+  test_assert_mem_equal( data1 , data2 , size * sizeof * data1 );
+  {
+    double sum = 0;
+    double sum2 = 0;
+    for (i=0; i < size; i++) {
+      sum += data1[i];
+      sum2 += data1[i] * data1[i];
+    }
+    test_assert_true( fabs( sum / size ) < 0.01 );
+    test_assert_true( fabs( sum2 / size - 1 ) < 0.02 );
+  }
+
+  rng_free( rng2 );
+  rng_free( rng1 );
+  free( data2 );
+  free( data1 );
+}
+
+
 int main(int argc , char ** argv) {
+  test_xoshiro_state();
+  test_split();
+  test_fill( MZRAN );
+  test_fill( XOSHIRO );
   rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT ); 
   {
     int val1 = rng_get_int( rng , MAX_INT);
@@ -35,6 +35,63 @@ void test_mean_std() {
 }
 
 
+void test_quantile_select() {
+  double_vector_type * d = double_vector_alloc(0,0);
+  double_vector_type * scratch = double_vector_alloc(0,0);
+  int i;
+
+  for (i=0; i < 1001; i++)
+    double_vector_append( d , (i * 37) % 1001 );
+  double_vector_append( d , 500 );
+  double_vector_append( d , 500 );
+
+  {
+    const double quantiles[5] = {0.0 , 0.1 , 0.5 , 0.77 , 1.0};
+    for (i=0; i < 5; i++) {
+      double_vector_type * copy = double_vector_alloc_copy( d );
+      double q = statistics_empirical_quantile_select( d , quantiles[i] , NULL );
+      test_assert_double_equal( q , statistics_empirical_quantile( copy , quantiles[i] ));
+      test_assert_double_equal( q , statistics_empirical_quantile_select( d , quantiles[i] , scratch ));
+      double_vector_free( copy );
+    }
+  }
+  test_assert_double_equal( 37 , double_vector_iget( d , 1 ));
+  double_vector_free( scratch );
+  double_vector_free( d );
+}
+
+
+/*
+  Small samples with many repeated values, so that the quantile often
+  falls on a run of equal values and the interpolation must search
+  outwards.
+*/
+
+void test_quantile_select_ties() {
+  double_vector_type * scratch = double_vector_alloc(0,0);
+
+  for (int size = 1; size < 40; size++) {
+    for (int num_values = 1; num_values < 5; num_values++) {
+      double_vector_type * d = double_vector_alloc(0,0);
+      for (int i=0; i < size; i++)
+        double_vector_append( d , (i * 7 + size) % num_values + ((i % 5) == 0 ? 0 : 10) );
+
+      for (int k=0; k <= 20; k++) {
+        double quantile = k / 20.0;
+        double_vector_type * copy = double_vector_alloc_copy( d );
+        double expected = statistics_empirical_quantile( copy , quantile );
+        test_assert_double_equal( expected , statistics_empirical_quantile_select( d , quantile , scratch ));
+        double_vector_free( copy );
+      }
+      double_vector_free( d );
+    }
+  }
+  double_vector_free( scratch );
+}
+
+
 int main( int argc , char ** argv ) {
   test_mean_std();
+  test_quantile_select();
+  test_quantile_select_ties();
 }
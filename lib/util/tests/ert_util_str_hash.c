@@ -0,0 +1,117 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_util_str_hash.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/str_hash.h>
+
+
+void test_insert_get() {
+  str_hash_type * h = str_hash_alloc();
+  int values[3] = {1,2,3};
+  const char * long_key = "A_KEY_WHICH_IS_TOO_LONG_TO_BE_STORED_INLINE";
+
+  test_assert_true( str_hash_is_instance( h ));
+  test_assert_int_equal( 0 , str_hash_get_size( h ));
+  test_assert_false( str_hash_has_key( h , "KEY" ));
+  test_assert_NULL( str_hash_safe_get( h , "KEY" ));
+
+  str_hash_insert_ref( h , "KEY" , &values[0] );
+  str_hash_insert_ref( h , long_key , &values[1] );
+  str_hash_insert_ref( h , "" , &values[2] );
+
+  test_assert_int_equal( 3 , str_hash_get_size( h ));
+  test_assert_ptr_equal( str_hash_get( h , "KEY" ) , &values[0] );
+  test_assert_ptr_equal( str_hash_get( h , long_key ) , &values[1] );
+  test_assert_ptr_equal( str_hash_get( h , "" ) , &values[2] );
+
+  str_hash_insert_ref( h , "KEY" , &values[2] );
+  test_assert_int_equal( 3 , str_hash_get_size( h ));
+  test_assert_ptr_equal( str_hash_get( h , "KEY" ) , &values[2] );
+
+  test_assert_string_equal( str_hash_iget_key( h , 0 ) , "KEY" );
+  test_assert_string_equal( str_hash_iget_key( h , 1 ) , long_key );
+  test_assert_string_equal( str_hash_iget_key( h , 2 ) , "" );
+
+  str_hash_free( h );
+}
+
+
+void test_many_keys() {
+  const int size = 50000;
+  str_hash_type * h = str_hash_alloc();
+  char key[32];
+  int i;
+
+  for (i=0; i < size; i++) {
+    sprintf(key , "%s:%d" , (i % 2) ? "WOPR" : "GROUP_WITH_LONG_NAME" , i);
+    str_hash_insert_owned_ref( h , key , int_vector_alloc( 1 , i ) , int_vector_free__ );
+  }
+  test_assert_int_equal( size , str_hash_get_size( h ));
+  str_hash_freeze( h );
+  test_assert_true( str_hash_is_frozen( h ));
+
+  for (i=0; i < size; i++) {
+    sprintf(key , "%s:%d" , (i % 2) ? "WOPR" : "GROUP_WITH_LONG_NAME" , i);
+    {
+      const int_vector_type * v = str_hash_get( h , key );
+      test_assert_int_equal( i , int_vector_iget( v , 0 ));
+      test_assert_ptr_equal( v , str_hash_iget_value( h , i ));
+    }
+  }
+  test_assert_false( str_hash_has_key( h , "WOPR:0" ));
+
+  {
+    stringlist_type * keys = str_hash_alloc_stringlist( h );
+    test_assert_int_equal( size , stringlist_get_size( keys ));
+    test_assert_string_equal( "GROUP_WITH_LONG_NAME:0" , stringlist_iget( keys , 0 ));
+    test_assert_string_equal( "WOPR:1" , stringlist_iget( keys , 1 ));
+    stringlist_free( keys );
+  }
+
+  str_hash_clear( h );
+  test_assert_int_equal( 0 , str_hash_get_size( h ));
+  test_assert_false( str_hash_is_frozen( h ));
+  str_hash_free( h );
+}
+
+
+void test_reserve() {
+  str_hash_type * h = str_hash_alloc();
+  str_hash_reserve( h , 1000 );
+  str_hash_insert_ref( h , "PRESSURE" , h );
+  test_assert_ptr_equal( h , str_hash_get( h , "PRESSURE" ));
+  {
+    char ** keylist = str_hash_alloc_keylist( h );
+    test_assert_string_equal( keylist[0] , "PRESSURE" );
+    util_free_stringlist( keylist , 1 );
+  }
+  str_hash_free( h );
+}
+
+
+int main(int argc , char ** argv) {
+  test_insert_get();
+  test_many_keys();
+  test_reserve();
+  exit(0);
+}
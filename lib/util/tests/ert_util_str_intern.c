@@ -0,0 +1,89 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_util_str_intern.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/str_intern.h>
+
+
+void test_add() {
+  str_intern_type * strings = str_intern_alloc();
+  char buffer[32];
+  const char * pressure;
+
+  test_assert_true( str_intern_is_instance( strings ));
+  test_assert_NULL( str_intern_add( strings , NULL ));
+  test_assert_NULL( str_intern_get( strings , "PRESSURE" ));
+
+  pressure = str_intern_add( strings , "PRESSURE" );
+  test_assert_string_equal( "PRESSURE" , pressure );
+  sprintf( buffer , "PRESS%s" , "URE" );
+  test_assert_ptr_not_equal( buffer , pressure );
+  test_assert_ptr_equal( pressure , str_intern_add( strings , buffer ));
+  test_assert_ptr_equal( pressure , str_intern_get( strings , buffer ));
+  test_assert_true( str_intern_is_interned( strings , pressure ));
+  test_assert_false( str_intern_is_interned( strings , buffer ));
+  test_assert_true( str_intern_has( strings , buffer ));
+
+  test_assert_ptr_equal( pressure , str_intern_add_substring( strings , "PRESSURE_TOO_LONG" , 8 ));
+  test_assert_ptr_equal( pressure , str_intern_add_substring( strings , "PRESSURE" , 100 ));
+  test_assert_int_equal( 1 , str_intern_get_size( strings ));
+
+  str_intern_clear( strings );
+  test_assert_int_equal( 0 , str_intern_get_size( strings ));
+  test_assert_false( str_intern_has( strings , "PRESSURE" ));
+  str_intern_free( strings );
+}
+
+
+/*
+  The interned pointers must stay valid while the table grows.
+*/
+
+void test_stable() {
+  const int size = 20000;
+  str_intern_type * strings = str_intern_alloc();
+  const char ** ptr = util_calloc( size , sizeof * ptr );
+  char key[64];
+  int i;
+
+  for (i=0; i < size; i++) {
+    sprintf(key , "%s%d" , (i % 2) ? "OP_" : "A_WELL_NAME_WHICH_IS_LONGER_THAN_INLINE_" , i);
+    ptr[i] = str_intern_add( strings , key );
+  }
+  test_assert_int_equal( size , str_intern_get_size( strings ));
+
+  for (i=0; i < size; i++) {
+    sprintf(key , "%s%d" , (i % 2) ? "OP_" : "A_WELL_NAME_WHICH_IS_LONGER_THAN_INLINE_" , i);
+    test_assert_string_equal( key , ptr[i] );
+    test_assert_ptr_equal( ptr[i] , str_intern_add( strings , key ));
+  }
+
+  free( ptr );
+  str_intern_free( strings );
+}
+
+
+int main(int argc , char ** argv) {
+  test_add();
+  test_stable();
+  exit(0);
+}
@@ -17,9 +17,12 @@
 */
 #include <stdlib.h>
 #include <stdbool.h>
+#include <math.h>
 
 #include <ert/util/int_vector.h>
 #include <ert/util/double_vector.h>
+#include <ert/util/perm_vector.h>
+#include <ert/util/util.h>
 #include <ert/util/test_util.h>
 
 void assert_equal( bool equal ) {
@@ -343,6 +346,124 @@ void test_empty() {
   int_vector_free( vec );
 }
 
+
+void test_sort_select() {
+  const int size = 10000;
+  int_vector_type * vec = int_vector_alloc(0,0);
+  int i;
+
+  srand( 1 );
+  for (i=0; i < size; i++)
+    int_vector_append( vec , rand() % 1000 );
+
+  {
+    int_vector_type * sorted = int_vector_alloc_copy( vec );
+    int_vector_type * rsorted = int_vector_alloc_copy( vec );
+    int_vector_type * selected = int_vector_alloc_copy( vec );
+
+    int_vector_sort( sorted );
+    int_vector_rsort( rsorted );
+    for (i=1; i < size; i++) {
+      test_assert_true( int_vector_iget( sorted , i - 1) <= int_vector_iget( sorted , i ));
+      test_assert_int_equal( int_vector_iget( sorted , i ) , int_vector_iget( rsorted , size - 1 - i ));
+    }
+
+    for (i=0; i < size; i += 997) {
+      int value = int_vector_select_nth( selected , i );
+      int j;
+      test_assert_int_equal( value , int_vector_iget( sorted , i ));
+      for (j=0; j < i; j++)
+        test_assert_true( int_vector_iget( selected , j ) <= value );
+      for (j=i+1; j < size; j++)
+        test_assert_true( int_vector_iget( selected , j ) >= value );
+    }
+
+    int_vector_free( selected );
+    int_vector_free( rsorted );
+    int_vector_free( sorted );
+  }
+
+  /* Equal elements keep their relative order in the permutations. */
+  {
+    perm_vector_type * perm = int_vector_alloc_sort_perm( vec );
+    perm_vector_type * rperm = int_vector_alloc_rsort_perm( vec );
+    for (i=1; i < size; i++) {
+      int v0 = int_vector_iget( vec , perm_vector_iget( perm , i - 1));
+      int v1 = int_vector_iget( vec , perm_vector_iget( perm , i ));
+      test_assert_true( v0 <= v1 );
+      if (v0 == v1)
+        test_assert_true( perm_vector_iget( perm , i - 1) < perm_vector_iget( perm , i ));
+
+      v0 = int_vector_iget( vec , perm_vector_iget( rperm , i - 1));
+      v1 = int_vector_iget( vec , perm_vector_iget( rperm , i ));
+      test_assert_true( v0 >= v1 );
+      if (v0 == v1)
+        test_assert_true( perm_vector_iget( rperm , i - 1) < perm_vector_iget( rperm , i ));
+    }
+    perm_vector_free( rperm );
+    perm_vector_free( perm );
+  }
+
+  int_vector_select_unique( vec );
+  test_assert_int_equal( 1000 , int_vector_size( vec ));
+  for (i=0; i < 1000; i++)
+    test_assert_int_equal( i , int_vector_iget( vec , i ));
+
+  int_vector_free( vec );
+}
+
+
+void test_sort_large() {
+  const int size = 2500000;
+  double_vector_type * vec = double_vector_alloc( size , 0 );
+  perm_vector_type * perm;
+  int i;
+
+  for (i=0; i < size; i++)
+    double_vector_iset( vec , i , fmod( i * 7919.0 , 1000003 ));
+
+  perm = double_vector_alloc_sort_perm( vec );
+  test_assert_int_equal( size , perm_vector_get_size( perm ));
+  {
+    bool * seen = util_malloc( size * sizeof * seen );
+    for (i=0; i < size; i++)
+      seen[i] = false;
+
+    for (i=0; i < size; i++) {
+      int index = perm_vector_iget( perm , i );
+      test_assert_true( (index >= 0) && (index < size) );
+      test_assert_false( seen[index] );
+      seen[index] = true;
+    }
+    free( seen );
+  }
+
+  /* The permutation sorts the values, and equal values keep their input order. */
+  for (i=1; i < size; i++) {
+    int prev  = perm_vector_iget( perm , i - 1 );
+    int index = perm_vector_iget( perm , i );
+    double prev_value = double_vector_iget( vec , prev );
+    double value      = double_vector_iget( vec , index );
+
+    test_assert_true( prev_value <= value );
+    if (prev_value == value)
+      test_assert_true( prev < index );
+  }
+
+  double_vector_sort( vec );
+  for (i=1; i < size; i++)
+    test_assert_true( double_vector_iget( vec , i - 1) <= double_vector_iget( vec , i ));
+
+  double_vector_permute( vec , perm );
+  double_vector_sort( vec );
+  test_assert_double_equal( 0 , double_vector_iget( vec , 0 ));
+  test_assert_double_equal( 1000002 , double_vector_iget( vec , size - 1 ));
+
+  perm_vector_free( perm );
+  double_vector_free( vec );
+}
+
+
 int main(int argc , char ** argv) {
 
   int_vector_type * int_vector = int_vector_alloc( 0 , 99);
@@ -433,5 +554,7 @@ int main(int argc , char ** argv) {
   test_resize();
   test_empty();
   test_insert_double();
+  test_sort_select();
+  test_sort_large();
   exit(0);
 }
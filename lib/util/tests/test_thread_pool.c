@@ -59,12 +59,32 @@ void run() {
   pthread_mutex_destroy( &lock );
 }
 
+void mark_range( void * arg , int begin , int end ) {
+  int * count = (int *) arg;
+  for (int i=begin; i < end; i++)
+    count[i]++;
+}
+
 
+/* Every item must be handled exactly once, for all thread counts. */
+void run_range() {
+  const int num_items = 1001;
+  int count[1001];
 
+  for (int num_threads = 0; num_threads <= 2 * num_items; num_threads += 333) {
+    for (int i=0; i < num_items; i++)
+      count[i] = 0;
 
+    thread_pool_run_range( mark_range , count , num_items , num_threads );
+    for (int i=0; i < num_items; i++)
+      test_assert_int_equal( count[i] , 1 );
+  }
+  thread_pool_run_range( mark_range , count , 0 , 4 );
+}
 
 
 int main( int argc , char ** argv) {
   create_and_destroy();
   run();
+  run_range();
 }
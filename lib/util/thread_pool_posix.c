@@ -20,6 +20,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <signal.h>
 #include <pthread.h>
 #include <unistd.h>
@@ -483,3 +484,52 @@ void thread_pool_free(thread_pool_type * pool) {
 int thread_pool_get_max_running( const thread_pool_type * pool ) {
   return pool->max_running;
 }
+
+
+/*****************************************************************/
+
+typedef struct {
+  thread_pool_range_ftype * func;
+  void                    * arg;
+  int                       begin;
+  int                       end;
+} thread_pool_range_job_type;
+
+
+static void * thread_pool_range_job_main( void * arg ) {
+  thread_pool_range_job_type * job = (thread_pool_range_job_type*)arg;
+  job->func( job->arg , job->begin , job->end );
+  return NULL;
+}
+
+
+/**
+   Will split [0,num_items) in num_threads contiguous ranges of
+   (almost) equal size, and call func( arg , begin , end ) for every
+   range on a thread_pool of num_threads threads; the function returns
+   when all ranges have been handled. The number of threads is limited
+   to num_items, and with one thread func( arg , 0 , num_items ) is
+   called directly in the calling thread. The range function must only
+   write to the elements in its own range.
+*/
+
+void thread_pool_run_range( thread_pool_range_ftype * func , void * arg , int num_items , int num_threads) {
+  num_threads = util_int_min( num_threads , num_items );
+  if (num_threads > 1) {
+    thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+    thread_pool_range_job_type * jobs = (thread_pool_range_job_type*)util_calloc( num_threads , sizeof * jobs );
+    int it;
+
+    for (it = 0; it < num_threads; it++) {
+      jobs[it].func  = func;
+      jobs[it].arg   = arg;
+      jobs[it].begin = (int) (((int64_t) num_items * it) / num_threads);
+      jobs[it].end   = (int) (((int64_t) num_items * (it + 1)) / num_threads);
+      thread_pool_add_job( tp , thread_pool_range_job_main , &jobs[it] );
+    }
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+    free( jobs );
+  } else
+    func( arg , 0 , num_items );
+}
@@ -62,6 +62,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef ERT_HAVE_UNISTD
+#include <unistd.h>
+#endif
+
 #ifdef HAVE_PTHREAD
 #include <pthread.h>
 #endif
@@ -308,6 +312,22 @@ unsigned int util_dev_urandom_seed( ) {
   return seed;
 }
 
+/*
+  Returns the number of online processors; this is used to size the
+  thread pools in the multithreaded kernels. If the number can not be
+  determined the function returns 1.
+*/
+
+int util_get_num_cpu( void ) {
+#if defined(ERT_HAVE_UNISTD) && defined(_SC_NPROCESSORS_ONLN)
+  long num_cpu = sysconf( _SC_NPROCESSORS_ONLN );
+  if (num_cpu > 0)
+    return (int) num_cpu;
+#endif
+  return 1;
+}
+
+
 unsigned int util_clock_seed( ) {
   int sec,min,hour;
   int mday,year,month;
@@ -2244,7 +2264,12 @@ char * util_fread_alloc_file_content(const char * filename , int * buffer_size)
   char * buffer = (char*)util_calloc(file_size + 1 , sizeof * buffer );
   {
     FILE * stream = util_fopen(filename , "r");
+#ifdef HAVE_PREAD
+    if (!util_pread( fileno(stream) , buffer , file_size , 0 ))
+      util_abort("%s: failed to read %zu bytes from %s \n",__func__ , file_size , filename);
+#else
     util_fread( buffer , 1 , file_size , stream , __func__);
+#endif
     fclose(stream);
   }
   if (buffer_size != NULL) *buffer_size = file_size;
@@ -2289,6 +2314,13 @@ bool util_copy_stream(FILE *src_stream , FILE *target_stream , size_t buffer_siz
 }
 
 
+/**
+   The actual copy is done with util_copy_fd() which will use
+   reflinks, copy_file_range() or sendfile() when available, and only
+   fall back to copying through the user supplied buffer when the data
+   must pass through user space.
+*/
+
 bool util_copy_file__(const char * src_file , const char * target_file, size_t buffer_size , void * buffer , bool abort_on_error) {
   if (util_same_file(src_file , target_file)) {
     fprintf(stderr,"%s Warning: trying to copy %s onto itself - nothing done\n",__func__ , src_file);
@@ -2297,7 +2329,10 @@ bool util_copy_file__(const char * src_file , const char * target_file, size_t b
     {
       FILE * src_stream      = util_fopen(src_file     , "r");
       FILE * target_stream   = util_fopen(target_file  , "w");
-      bool result = util_copy_stream(src_stream , target_stream , buffer_size , buffer , abort_on_error);
+      bool result = util_copy_fd(fileno(src_stream) , fileno(target_stream) , buffer_size , buffer);
+
+      if (!result && abort_on_error)
+        util_abort("%s: failed to copy %s -> %s - aborting \n",__func__ , src_file , target_file);
 
       fclose(src_stream);
       fclose(target_stream);
@@ -2321,11 +2356,16 @@ bool util_copy_file__(const char * src_file , const char * target_file, size_t b
 }
 
 
+/*
+  The buffer is only used when the data must be copied through user
+  space, there is no point in allocating more than a few MB.
+*/
+#define UTIL_COPY_BUFFER_SIZE (4 * 1024 * 1024)
 
 bool util_copy_file(const char * src_file , const char * target_file) {
   const bool abort_on_error = true;
   void * buffer   = NULL;
-  size_t buffer_size = util_size_t_max( 32 , util_file_size(src_file) );  /* The copy stream function will hang if buffer size == 0 */
+  size_t buffer_size = util_size_t_min( UTIL_COPY_BUFFER_SIZE , util_size_t_max( 32 , util_file_size(src_file) ));
   do {
     buffer = malloc(buffer_size);
     if (buffer == NULL) buffer_size /= 2;
@@ -3077,7 +3117,7 @@ char * util_newest_file(const char *file1 , const char *file2) {
   if (util_file_exists(file1)) {
     if (util_file_exists(file2)) {
       /* Actual comparison of two existing files. */
-      if (util_file_difftime(file1 , file2) < 0)
+      if (util_file_difftime(file1 , file2) > 0)
         return (char *) file1;
       else
         return (char *) file2;
@@ -4673,8 +4713,19 @@ void * util_malloc(size_t size) {
 }
 
 
+/**
+   As calloc(), i.e. the storage is initialized to zero, with the same
+   NULL / abort() behaviour as util_malloc().
+*/
+
 void * util_calloc( size_t elements , size_t element_size ) {
-  return util_malloc( elements * element_size );
+  void * data = NULL;
+  if ((elements > 0) && (element_size > 0)) {
+    data = calloc( elements , element_size );
+    if (data == NULL)
+      util_abort("%s: failed to allocate %zu x %zu bytes - aborting \n",__func__ , elements , element_size);
+  }
+  return data;
 }
 
 
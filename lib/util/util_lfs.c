@@ -53,7 +53,28 @@
   'offset_type' in util.h, and all file operations should use that type.
 */
 
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+
 #include <ert/util/util.h>
+#include <ert/util/ssize_t.h>
+#include "ert/util/build_config.h"
+
+#ifdef ERT_HAVE_UNISTD
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+#ifdef HAVE_FICLONE
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
+#ifdef HAVE_SENDFILE
+#include <sys/sendfile.h>
+#endif
 
 offset_type util_ftell(FILE * stream) {
 #ifdef ERT_WINDOWS_LFS
@@ -111,3 +132,278 @@ int util_fstat(int fileno, stat_type * stat_info) {
   return fstat(fileno , stat_info);
 #endif
 }
+
+
+
+/*
+  The functions below operate directly on file descriptors, and are
+  intended for bulk transfer of large files where the stdio buffering
+  only gets in the way. util_pread() and util_pwrite() read/write the
+  full buffer at an absolute offset, retrying on short transfers and
+  EINTR; the file offset of the descriptor is left unchanged. Where
+  pread()/pwrite() are not available the offset is saved and restored
+  around an ordinary lseek() + read()/write().
+*/
+
+#ifndef HAVE_PREAD
+static offset_type util_lseek__(int fd , offset_type offset , int whence) {
+#ifdef ERT_WINDOWS_LFS
+  return _lseeki64(fd , offset , whence);
+#else
+  return lseek(fd , offset , whence);
+#endif
+}
+#endif
+
+
+bool util_pread(int fd , void * buffer , size_t size , offset_type offset) {
+  char * ptr = buffer;
+#ifndef HAVE_PREAD
+  offset_type current_offset = util_lseek__(fd , 0 , SEEK_CUR);
+  if (util_lseek__(fd , offset , SEEK_SET) != offset)
+    return false;
+#endif
+
+  while (size > 0) {
+#ifdef HAVE_PREAD
+    ssize_t bytes_read = pread(fd , ptr , size , offset);
+#else
+    int bytes_read = read(fd , ptr , size);
+#endif
+    if (bytes_read < 0 && errno == EINTR)
+      continue;
+
+    if (bytes_read <= 0)
+      break;
+
+    ptr += bytes_read;
+    size -= bytes_read;
+    offset += bytes_read;
+  }
+
+#ifndef HAVE_PREAD
+  util_lseek__(fd , current_offset , SEEK_SET);
+#endif
+  return (size == 0);
+}
+
+
+bool util_pwrite(int fd , const void * buffer , size_t size , offset_type offset) {
+  const char * ptr = buffer;
+#ifndef HAVE_PWRITE
+  offset_type current_offset = util_lseek__(fd , 0 , SEEK_CUR);
+  if (util_lseek__(fd , offset , SEEK_SET) != offset)
+    return false;
+#endif
+
+  while (size > 0) {
+#ifdef HAVE_PWRITE
+    ssize_t bytes_written = pwrite(fd , ptr , size , offset);
+#else
+    int bytes_written = write(fd , ptr , size);
+#endif
+    if (bytes_written < 0 && errno == EINTR)
+      continue;
+
+    if (bytes_written <= 0)
+      break;
+
+    ptr += bytes_written;
+    size -= bytes_written;
+    offset += bytes_written;
+  }
+
+#ifndef HAVE_PWRITE
+  util_lseek__(fd , current_offset , SEEK_SET);
+#endif
+  return (size == 0);
+}
+
+
+/*
+  Will reserve disk space for a file of size bytes, and extend the
+  file to that size. This is purely an optimization which reduces
+  fragmentation and metadata updates when writing a large file of
+  known size; the function returns false if the filesystem (or
+  platform) does not support it, and that is not an error.
+
+  Observe that we prefer the Linux specific fallocate() over
+  posix_fallocate(), because posix_fallocate() will emulate the
+  preallocation by writing to every block when the filesystem does
+  not support it.
+*/
+
+bool util_fallocate(int fd , offset_type size) {
+  if (size <= 0)
+    return false;
+
+#if defined(HAVE_FALLOCATE)
+  return (fallocate(fd , 0 , 0 , size) == 0);
+#elif defined(HAVE_POSIX_FALLOCATE)
+  return (posix_fallocate(fd , 0 , size) == 0);
+#else
+  return false;
+#endif
+}
+
+
+/*
+  Copies the byte range [offset, end) from src_fd to target_fd; the
+  bytes are written at offset + shift in the target file. If end < 0
+  the copy will continue until EOF is reached on src_fd, this is
+  required for files where the size reported by stat() is not
+  reliable, e.g. files in /proc. The kernel side copy functions
+  copy_file_range() and sendfile() are tried first, whatever remains
+  is copied through the user supplied buffer.
+*/
+
+static bool util_copy_fd_range__(int src_fd , int target_fd , offset_type offset , offset_type end , offset_type shift , size_t buffer_size , void * buffer) {
+#ifdef HAVE_COPY_FILE_RANGE
+  {
+    loff_t src_offset = offset;
+    loff_t target_offset = offset + shift;
+
+    while (src_offset < end) {
+      ssize_t bytes_copied = copy_file_range(src_fd , &src_offset , target_fd , &target_offset , end - src_offset , 0);
+      if (bytes_copied < 0 && errno == EINTR)
+        continue;
+
+      if (bytes_copied <= 0)
+        break;
+    }
+    offset = src_offset;
+  }
+#endif
+
+#ifdef HAVE_SENDFILE
+  if (offset < end) {
+    /* sendfile() writes at the current offset of the target descriptor. */
+    off_t src_offset = offset;
+    if (lseek(target_fd , offset + shift , SEEK_SET) == offset + shift) {
+      while (src_offset < end) {
+        ssize_t bytes_copied = sendfile(target_fd , src_fd , &src_offset , end - src_offset);
+        if (bytes_copied < 0 && errno == EINTR)
+          continue;
+
+        if (bytes_copied <= 0)
+          break;
+      }
+      offset = src_offset;
+    }
+  }
+#endif
+
+  while ((end < 0) || (offset < end)) {
+    size_t bytes_to_read = buffer_size;
+    ssize_t bytes_read;
+
+    if ((end >= 0) && (end - offset < (offset_type) buffer_size))
+      bytes_to_read = end - offset;
+
+#ifdef HAVE_PREAD
+    bytes_read = pread(src_fd , buffer , bytes_to_read , offset);
+#else
+    if (util_lseek__(src_fd , offset , SEEK_SET) != offset)
+      return false;
+    bytes_read = read(src_fd , buffer , bytes_to_read);
+#endif
+
+    if (bytes_read < 0 && errno == EINTR)
+      continue;
+
+    if (bytes_read < 0)
+      return false;
+
+    if (bytes_read == 0)
+      return (end < 0);
+
+    if (!util_pwrite(target_fd , buffer , bytes_read , offset + shift))
+      return false;
+
+    offset += bytes_read;
+  }
+
+  return true;
+}
+
+
+
+/*
+  Copies size bytes starting at src_offset in src_fd to target_offset
+  in target_fd, with the same kernel side copy functions as
+  util_copy_fd(). The file offsets of the two descriptors are
+  undefined after the copy.
+*/
+
+bool util_copy_fd_range(int src_fd , offset_type src_offset , int target_fd , offset_type target_offset , offset_type size , size_t buffer_size , void * buffer) {
+  if (size <= 0)
+    return (size == 0);
+
+  return util_copy_fd_range__(src_fd , target_fd , src_offset , src_offset + size , target_offset - src_offset , buffer_size , buffer);
+}
+
+
+/*
+  Will copy the full content of src_fd to target_fd; target_fd should
+  be a newly created/truncated file. The copy is attempted in the
+  following order:
+
+    1. A reflink (FICLONE) which shares the data blocks between the
+       two files; this is instantaneous on filesystems like btrfs and
+       xfs.
+
+    2. If the source file is sparse only the data extents, as
+       reported by lseek(SEEK_DATA / SEEK_HOLE), are copied, and the
+       holes are recreated by truncating the target to full size.
+
+    3. Otherwise the target is preallocated and the file copied with
+       copy_file_range() / sendfile() / pread() + pwrite().
+
+  The buffer is only used when the data must pass through user space.
+  The file offsets of the two descriptors are undefined after the
+  copy.
+*/
+
+bool util_copy_fd(int src_fd , int target_fd , size_t buffer_size , void * buffer) {
+  stat_type stat_info;
+  offset_type file_size;
+
+  if (util_fstat(src_fd , &stat_info) != 0)
+    return false;
+  file_size = stat_info.st_size;
+
+#ifdef HAVE_FICLONE
+  if (S_ISREG(stat_info.st_mode) && (ioctl(target_fd , FICLONE , src_fd) == 0))
+    return true;
+#endif
+
+#ifdef HAVE_SEEK_DATA
+  if (S_ISREG(stat_info.st_mode) && (file_size > 0) && ((offset_type) stat_info.st_blocks * 512 < file_size)) {
+    offset_type offset = 0;
+    while (offset < file_size) {
+      offset_type data_start = lseek(src_fd , offset , SEEK_DATA);
+      offset_type data_end;
+
+      if (data_start < 0)
+        break;    /* ENXIO: The rest of the file is a hole. */
+
+      data_end = lseek(src_fd , data_start , SEEK_HOLE);
+      if (data_end < 0)
+        data_end = file_size;
+
+      if (!util_copy_fd_range__(src_fd , target_fd , data_start , data_end , 0 , buffer_size , buffer))
+        return false;
+
+      offset = data_end;
+    }
+    return (ftruncate(target_fd , file_size) == 0);
+  }
+#endif
+
+  util_fallocate(target_fd , file_size);
+  if (!util_copy_fd_range__(src_fd , target_fd , 0 , file_size , 0 , buffer_size , buffer))
+    return false;
+
+  /* The kernel copy functions have done their part; continue to EOF. */
+  return util_copy_fd_range__(src_fd , target_fd , file_size , -1 , 0 , buffer_size , buffer);
+}
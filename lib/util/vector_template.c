@@ -95,12 +95,19 @@
 
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/type_macros.h>
 #include <ert/util/util.h>
 #include <ert/util/buffer.h>
 #include <ert/util/@TYPE@_vector.h>
 
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#include <ert/util/arg_pack.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -1106,24 +1113,292 @@ int @TYPE@_vector_index_sorted(const @TYPE@_vector_type * vector , @TYPE@ value)
 /*****************************************************************/
 /* Functions for sorting a vector instance. */
 
-static int @TYPE@_vector_cmp(const void *_a, const void *_b) {
-  @TYPE@ a = *((@TYPE@ *) _a);
-  @TYPE@ b = *((@TYPE@ *) _b);
-
-  if (a > b)
-    return 1;
+/*
+  The sorting is implemented with typed kernels instead of qsort()
+  with a function pointer comparator; the kernels are generated with
+  the VECTOR_SORT_KERNELS() macro below, once for the plain @TYPE@
+  values and twice for the (value,index) nodes used when creating
+  sort permutations. The LESS argument to the macro is the strict
+  weak ordering used for the elements.
+
+  The sort is an introsort; i.e. quicksort with median of three pivot
+  selection which switches to heapsort if the recursion gets too deep
+  and to insertion sort for short ranges. The selection function is
+  the corresponding quickselect - with the same fallback.
+
+  For vectors with more than VECTOR_PARALLEL_SORT_SIZE elements, and
+  when the thread_pool is available, the sort is done by sorting
+  chunks of the vector in parallel and then merging the sorted chunks
+  pairwise, also in parallel.
+*/
 
-  if (a < b)
-    return -1;
+#define VECTOR_INSERTION_SORT_SIZE   16
+#define VECTOR_PARALLEL_SORT_SIZE    1000000
+
+#define VECTOR_SORT_KERNELS( prefix , elm_type , LESS )                                   \
+                                                                                          \
+static void prefix ## _insertion_sort( elm_type * data , int size ) {                     \
+  int i;                                                                                  \
+  for (i=1; i < size; i++) {                                                              \
+    elm_type value = data[i];                                                             \
+    int j = i;                                                                            \
+    while (j > 0 && LESS( value , data[j-1] )) {                                          \
+      data[j] = data[j-1];                                                                \
+      j--;                                                                                \
+    }                                                                                     \
+    data[j] = value;                                                                      \
+  }                                                                                       \
+}                                                                                         \
+                                                                                          \
+static void prefix ## _sift_down( elm_type * data , int root , int size ) {               \
+  elm_type value = data[root];                                                            \
+  while (true) {                                                                          \
+    int child = 2*root + 1;                                                               \
+    if (child >= size)                                                                    \
+      break;                                                                              \
+    if ((child + 1 < size) && LESS( data[child] , data[child + 1]))                       \
+      child++;                                                                            \
+    if (!LESS( value , data[child] ))                                                     \
+      break;                                                                              \
+    data[root] = data[child];                                                             \
+    root = child;                                                                         \
+  }                                                                                       \
+  data[root] = value;                                                                     \
+}                                                                                         \
+                                                                                          \
+static void prefix ## _heap_sort( elm_type * data , int size ) {                          \
+  int i;                                                                                  \
+  for (i = size/2 - 1; i >= 0; i--)                                                       \
+    prefix ## _sift_down( data , i , size );                                              \
+  for (i = size - 1; i > 0; i--) {                                                        \
+    elm_type tmp = data[0];                                                               \
+    data[0] = data[i];                                                                    \
+    data[i] = tmp;                                                                        \
+    prefix ## _sift_down( data , 0 , i );                                                 \
+  }                                                                                       \
+}                                                                                         \
+                                                                                          \
+/* Hoare partition around the median of the first, middle and last */                    \
+/* element; returns j such that [0,j] <= pivot <= [j+1,size).       */                    \
+static int prefix ## _partition( elm_type * data , int size ) {                           \
+  int mid = size / 2;                                                                     \
+  elm_type tmp;                                                                           \
+  if (LESS( data[mid] , data[0] ))                                                        \
+    { tmp = data[mid]; data[mid] = data[0]; data[0] = tmp; }                              \
+  if (LESS( data[size-1] , data[0] ))                                                     \
+    { tmp = data[size-1]; data[size-1] = data[0]; data[0] = tmp; }                        \
+  if (LESS( data[size-1] , data[mid] ))                                                   \
+    { tmp = data[size-1]; data[size-1] = data[mid]; data[mid] = tmp; }                    \
+  {                                                                                       \
+    elm_type pivot = data[mid];                                                           \
+    int i = -1;                                                                           \
+    int j = size;                                                                         \
+    while (true) {                                                                        \
+      do { i++; } while (LESS( data[i] , pivot ));                                        \
+      do { j--; } while (LESS( pivot , data[j] ));                                        \
+      if (i >= j)                                                                         \
+        return j;                                                                         \
+      tmp = data[i];                                                                      \
+      data[i] = data[j];                                                                  \
+      data[j] = tmp;                                                                      \
+    }                                                                                     \
+  }                                                                                       \
+}                                                                                         \
+                                                                                          \
+static void prefix ## _introsort( elm_type * data , int size , int depth) {               \
+  while (size > VECTOR_INSERTION_SORT_SIZE) {                                             \
+    if (depth == 0) {                                                                     \
+      prefix ## _heap_sort( data , size );                                                \
+      return;                                                                             \
+    }                                                                                     \
+    depth--;                                                                              \
+    {                                                                                     \
+      int j = prefix ## _partition( data , size ) + 1;                                    \
+      if (j < size - j) {                                                                 \
+        prefix ## _introsort( data , j , depth );                                         \
+        data += j;                                                                        \
+        size -= j;                                                                        \
+      } else {                                                                            \
+        prefix ## _introsort( data + j , size - j , depth );                              \
+        size = j;                                                                         \
+      }                                                                                   \
+    }                                                                                     \
+  }                                                                                       \
+  prefix ## _insertion_sort( data , size );                                               \
+}                                                                                         \
+                                                                                          \
+static int prefix ## _max_depth( int size ) {                                             \
+  int depth = 0;                                                                          \
+  while (size > 1) {                                                                      \
+    size >>= 1;                                                                           \
+    depth++;                                                                              \
+  }                                                                                       \
+  return 2*depth;                                                                         \
+}                                                                                         \
+                                                                                          \
+static void prefix ## _sort_serial( elm_type * data , int size ) {                        \
+  prefix ## _introsort( data , size , prefix ## _max_depth( size ));                      \
+}                                                                                         \
+                                                                                          \
+static void prefix ## _merge( const elm_type * src , int size1 , int size2 , elm_type * target) { \
+  const elm_type * src2 = src + size1;                                                    \
+  int i1 = 0;                                                                             \
+  int i2 = 0;                                                                             \
+  int k = 0;                                                                              \
+  while (i1 < size1 && i2 < size2) {                                                      \
+    if (LESS( src2[i2] , src[i1] ))                                                       \
+      target[k++] = src2[i2++];                                                           \
+    else                                                                                  \
+      target[k++] = src[i1++];                                                            \
+  }                                                                                       \
+  while (i1 < size1)                                                                      \
+    target[k++] = src[i1++];                                                              \
+  while (i2 < size2)                                                                      \
+    target[k++] = src2[i2++];                                                             \
+}
+
+#define VECTOR_SELECT_KERNEL( prefix , elm_type , LESS )                                  \
+                                                                                          \
+/* Rearranges data such that data[n] is the element which would be  */                   \
+/* at position n in the sorted array, all elements in front are <=  */                   \
+/* data[n] and all elements after are >= data[n].                   */                   \
+static void prefix ## _select( elm_type * data , int size , int n ) {                     \
+  int depth = prefix ## _max_depth( size );                                               \
+  while (size > VECTOR_INSERTION_SORT_SIZE) {                                             \
+    if (depth == 0) {                                                                     \
+      prefix ## _heap_sort( data , size );                                                \
+      return;                                                                             \
+    }                                                                                     \
+    depth--;                                                                              \
+    {                                                                                     \
+      int j = prefix ## _partition( data , size ) + 1;                                    \
+      if (n < j)                                                                          \
+        size = j;                                                                         \
+      else {                                                                              \
+        data += j;                                                                        \
+        size -= j;                                                                        \
+        n -= j;                                                                           \
+      }                                                                                   \
+    }                                                                                     \
+  }                                                                                       \
+  prefix ## _insertion_sort( data , size );                                               \
+}
+
+#define VECTOR_LESS( a , b )       ((a) < (b))
+#define VECTOR_NODE_LESS( a , b )  (((a).value < (b).value) || (((a).value == (b).value) && ((a).index < (b).index)))
+#define VECTOR_NODE_RLESS( a , b ) (((b).value < (a).value) || (((a).value == (b).value) && ((a).index < (b).index)))
+
+VECTOR_SORT_KERNELS( @TYPE@_vector_data , @TYPE@ , VECTOR_LESS )
+VECTOR_SORT_KERNELS( @TYPE@_vector_node , sort_node_type , VECTOR_NODE_LESS )
+VECTOR_SORT_KERNELS( @TYPE@_vector_rnode , sort_node_type , VECTOR_NODE_RLESS )
+VECTOR_SELECT_KERNEL( @TYPE@_vector_data , @TYPE@ , VECTOR_LESS )
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+#define VECTOR_PARALLEL_SORT( prefix , elm_type )                                         \
+                                                                                          \
+static void * prefix ## _sort_mt__( void * arg ) {                                        \
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );                                   \
+  elm_type * data = (elm_type*) arg_pack_iget_ptr( arg_pack , 0 );                        \
+  int size        = arg_pack_iget_int( arg_pack , 1 );                                    \
+  prefix ## _sort_serial( data , size );                                                  \
+  return NULL;                                                                            \
+}                                                                                         \
+                                                                                          \
+static void * prefix ## _merge_mt__( void * arg ) {                                       \
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );                                   \
+  const elm_type * src = (const elm_type*) arg_pack_iget_const_ptr( arg_pack , 0 );       \
+  int size1            = arg_pack_iget_int( arg_pack , 1 );                               \
+  int size2            = arg_pack_iget_int( arg_pack , 2 );                               \
+  elm_type * target    = (elm_type*) arg_pack_iget_ptr( arg_pack , 3 );                   \
+  prefix ## _merge( src , size1 , size2 , target );                                       \
+  return NULL;                                                                            \
+}                                                                                         \
+                                                                                          \
+static void prefix ## _sort_mt( elm_type * data , int size , int num_threads) {           \
+  int num_chunks = 1;                                                                     \
+  while (2*num_chunks <= num_threads)                                                     \
+    num_chunks *= 2;                                                                      \
+  {                                                                                       \
+    thread_pool_type * tp     = thread_pool_alloc( num_threads , true );                  \
+    arg_pack_type ** arg_list = (arg_pack_type**)util_calloc( num_chunks , sizeof * arg_list ); \
+    int * offset              = (int*)util_calloc( num_chunks + 1 , sizeof * offset );    \
+    elm_type * tmp            = (elm_type*)util_calloc( size , sizeof * tmp );            \
+    elm_type * src            = data;                                                     \
+    elm_type * target         = tmp;                                                      \
+    int chunk;                                                                            \
+    int stride;                                                                           \
+                                                                                          \
+    for (chunk = 0; chunk <= num_chunks; chunk++)                                         \
+      offset[chunk] = (int) (((int64_t) size * chunk) / num_chunks);                      \
+                                                                                          \
+    for (chunk = 0; chunk < num_chunks; chunk++) {                                        \
+      arg_list[chunk] = arg_pack_alloc();                                                 \
+      arg_pack_append_ptr( arg_list[chunk] , data + offset[chunk] );                      \
+      arg_pack_append_int( arg_list[chunk] , offset[chunk+1] - offset[chunk] );           \
+      thread_pool_add_job( tp , prefix ## _sort_mt__ , arg_list[chunk] );                 \
+    }                                                                                     \
+    thread_pool_join( tp );                                                               \
+    for (chunk = 0; chunk < num_chunks; chunk++)                                          \
+      arg_pack_free( arg_list[chunk] );                                                   \
+                                                                                          \
+    for (stride = 1; stride < num_chunks; stride *= 2) {                                  \
+      int njobs = 0;                                                                      \
+      thread_pool_restart( tp );                                                          \
+      for (chunk = 0; chunk < num_chunks; chunk += 2*stride) {                            \
+        int begin = offset[chunk];                                                        \
+        int mid   = offset[chunk + stride];                                               \
+        int end   = offset[chunk + 2*stride];                                             \
+        arg_list[njobs] = arg_pack_alloc();                                               \
+        arg_pack_append_const_ptr( arg_list[njobs] , src + begin );                       \
+        arg_pack_append_int( arg_list[njobs] , mid - begin );                             \
+        arg_pack_append_int( arg_list[njobs] , end - mid );                               \
+        arg_pack_append_ptr( arg_list[njobs] , target + begin );                          \
+        thread_pool_add_job( tp , prefix ## _merge_mt__ , arg_list[njobs] );              \
+        njobs++;                                                                          \
+      }                                                                                   \
+      thread_pool_join( tp );                                                             \
+      for (chunk = 0; chunk < njobs; chunk++)                                             \
+        arg_pack_free( arg_list[chunk] );                                                 \
+      {                                                                                   \
+        elm_type * swap = src;                                                            \
+        src = target;                                                                     \
+        target = swap;                                                                    \
+      }                                                                                   \
+    }                                                                                     \
+                                                                                          \
+    if (src != data)                                                                      \
+      memcpy( data , src , size * sizeof * data );                                        \
+                                                                                          \
+    free( tmp );                                                                          \
+    free( offset );                                                                       \
+    free( arg_list );                                                                     \
+    thread_pool_free( tp );                                                               \
+  }                                                                                       \
+}
+
+VECTOR_PARALLEL_SORT( @TYPE@_vector_data , @TYPE@ )
+VECTOR_PARALLEL_SORT( @TYPE@_vector_node , sort_node_type )
+VECTOR_PARALLEL_SORT( @TYPE@_vector_rnode , sort_node_type )
+
+#define VECTOR_SORT( prefix , data , size )                                               \
+  {                                                                                       \
+    int num_threads = util_get_num_cpu();                                                 \
+    if ((size) >= VECTOR_PARALLEL_SORT_SIZE && num_threads > 1)                           \
+      prefix ## _sort_mt( data , size , num_threads );                                    \
+    else                                                                                  \
+      prefix ## _sort_serial( data , size );                                              \
+  }
 
-  return 0;
-}
+#else
 
-/* Reverse compare function. */
+#define VECTOR_SORT( prefix , data , size )                                               \
+  {                                                                                       \
+    prefix ## _sort_serial( data , size );                                                \
+  }
 
-static int @TYPE@_vector_rcmp(const void *a, const void *b) {
-  return @TYPE@_vector_cmp( b , a );
-}
+#endif
 
 
 /**
@@ -1137,22 +1412,16 @@ static int @TYPE@_vector_rcmp(const void *a, const void *b) {
 void @TYPE@_vector_select_unique(@TYPE@_vector_type * vector) {
   @TYPE@_vector_assert_writable( vector );
   if (vector->size > 0) {
-    @TYPE@_vector_type * copy = @TYPE@_vector_alloc_copy( vector );
-    @TYPE@_vector_sort( copy );
-    @TYPE@_vector_reset( vector );
-    {
-      int i;
-      @TYPE@ previous_value = @TYPE@_vector_iget( copy , 0);
-      @TYPE@_vector_append( vector , previous_value);
-
-      for (i=1; i <  copy->size; i++) {
-        @TYPE@ value = @TYPE@_vector_iget( copy , i );
-        if (value != previous_value)
-          @TYPE@_vector_append( vector , value);
-        previous_value = value;
+    int i;
+    int unique_size = 1;
+    @TYPE@_vector_sort( vector );
+    for (i=1; i < vector->size; i++) {
+      if (vector->data[i] != vector->data[unique_size - 1]) {
+        vector->data[unique_size] = vector->data[i];
+        unique_size++;
       }
     }
-    @TYPE@_vector_free( copy );
+    @TYPE@_vector_resize( vector , unique_size );
   }
 }
 
@@ -1161,37 +1430,47 @@ void @TYPE@_vector_select_unique(@TYPE@_vector_type * vector) {
 */
 void @TYPE@_vector_sort(@TYPE@_vector_type * vector) {
   @TYPE@_vector_assert_writable( vector );
-  qsort(vector->data , vector->size , sizeof * vector->data ,  @TYPE@_vector_cmp);
+  VECTOR_SORT( @TYPE@_vector_data , vector->data , vector->size );
 }
 
 
 void @TYPE@_vector_rsort(@TYPE@_vector_type * vector) {
-  @TYPE@_vector_assert_writable( vector );
-  qsort(vector->data , vector->size , sizeof * vector->data ,  @TYPE@_vector_rcmp);
+  @TYPE@_vector_sort( vector );
+  {
+    int i;
+    for (i=0; i < vector->size / 2; i++) {
+      @TYPE@ tmp = vector->data[i];
+      vector->data[i] = vector->data[vector->size - 1 - i];
+      vector->data[vector->size - 1 - i] = tmp;
+    }
+  }
 }
 
 
+/**
+   Will rearrange the elements in the vector so that the element at
+   position @n is the element which would have been at position @n if
+   the vector was sorted. All the elements in front of position @n are
+   less than or equal to this element, and all the elements after are
+   greater than or equal - the order is otherwise unspecified. The
+   value of element @n is returned.
+
+   When only one order statistic - e.g. a quantile - is needed this is
+   considerably faster than a full sort.
+*/
 
-static int @TYPE@_vector_cmp_node(const void *_a, const void *_b) {
-  sort_node_type a = *((sort_node_type *) _a);
-  sort_node_type b = *((sort_node_type *) _b);
-
-  if (a.value < b.value)
-    return -1;
-
-  if (a.value > b.value)
-    return 1;
+@TYPE@ @TYPE@_vector_select_nth( @TYPE@_vector_type * vector , int n) {
+  @TYPE@_vector_assert_writable( vector );
+  if ((n < 0) || (n >= vector->size))
+    util_abort("%s: invalid index:%d - valid range: [0,%d) \n",__func__ , n , vector->size);
 
-  return 0;
+  @TYPE@_vector_data_select( vector->data , vector->size , n );
+  return vector->data[n];
 }
 
 
-static int @TYPE@_vector_rcmp_node(const void *a, const void *b) {
-  return @TYPE@_vector_cmp_node( b , a );
-}
-
 /**
-   This function will allocate a (int *) pointer of indices,
+   This function will allocate a perm_vector instance of indices,
    corresponding to the permutations of the elements in the vector to
    get it into sorted order. This permutation can then be used to sort
    several vectors identically:
@@ -1203,18 +1482,18 @@ static int @TYPE@_vector_rcmp_node(const void *a, const void *b) {
    .....
 
    {
-      int * sort_perm = int_vector_alloc_sort_perm( v1 );
+      perm_vector_type * sort_perm = int_vector_alloc_sort_perm( v1 );
       int_vector_permute( v1 , sort_perm );
       bool_vector_permute( v2 , sort_perm );
       double_vector_permute( v3 , sort_perm );
-      free(sort_perm);
+      perm_vector_free( sort_perm );
    }
 
+   Elements with equal value keep their relative order in the
+   permutation, also for the reverse sorted permutation.
 */
 
 
-
-
 static perm_vector_type * @TYPE@_vector_alloc_sort_perm__(const @TYPE@_vector_type * vector, bool reverse) {
   int * perm = (int*)util_calloc( vector->size , sizeof * perm ); // The perm_vector return value will take ownership of this array.
   sort_node_type * sort_nodes = (sort_node_type*)util_calloc( vector->size , sizeof * sort_nodes );
@@ -1224,9 +1503,9 @@ static perm_vector_type * @TYPE@_vector_alloc_sort_perm__(const @TYPE@_vector_ty
     sort_nodes[i].value = vector->data[i];
   }
   if (reverse)
-    qsort(sort_nodes , vector->size , sizeof * sort_nodes ,  @TYPE@_vector_rcmp_node);
+    VECTOR_SORT( @TYPE@_vector_rnode , sort_nodes , vector->size )
   else
-    qsort(sort_nodes , vector->size , sizeof * sort_nodes ,  @TYPE@_vector_cmp_node);
+    VECTOR_SORT( @TYPE@_vector_node , sort_nodes , vector->size )
 
   for (i=0; i < vector->size; i++)
     perm[i] = sort_nodes[i].index;
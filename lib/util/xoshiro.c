@@ -0,0 +1,239 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'xoshiro.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+#include <ert/util/xoshiro.h>
+
+/*****************************************************************/
+/*
+  This file implements the xoshiro128++ random number generator by
+  David Blackman and Sebastiano Vigna, see
+  http://prng.di.unimi.it/. The state is four 32 bit unsigned
+  integers - i.e. the same size as the mzran state, and the generator
+  has period 2^128 - 1.
+
+  In addition to the normal forward step the generator supports a
+  jump function which advances the state 2^64 steps. Calling the jump
+  function repeatedly on a copy of the state gives a sequence of
+  non-overlapping streams, this is used by the rng layer to split one
+  rng into several independent streams for parallel use.
+
+  The all zero state is invalid; when asked to set an all zero state
+  the generator falls back to the default state.
+*/
+
+
+
+#define XOSHIRO_TYPE_ID  77156499
+
+struct xoshiro_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  uint32_t s[4];
+};
+
+
+#define DEFAULT_S0  0x9e3779b9
+#define DEFAULT_S1  0x243f6a88
+#define DEFAULT_S2  0xb7e15162
+#define DEFAULT_S3  0x7f4a7c15
+
+
+static UTIL_SAFE_CAST_FUNCTION( xoshiro , XOSHIRO_TYPE_ID)
+static UTIL_SAFE_CAST_FUNCTION_CONST( xoshiro , XOSHIRO_TYPE_ID)
+
+
+static uint32_t rotl(const uint32_t x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+
+/*****************************************************************/
+
+
+static uint32_t xoshiro_next( xoshiro_type * rng ) {
+  uint32_t * s = rng->s;
+  const uint32_t result = rotl(s[0] + s[3], 7) + s[0];
+  const uint32_t t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+
+  s[2] ^= t;
+  s[3] = rotl(s[3], 11);
+
+  return result;
+}
+
+
+/**
+   This function will return and unsigned int. This is the fundamental
+   low level function which drives the random number generator state
+   forward. The returned value will be in the interval [0,XOSHIRO_MAX).
+*/
+
+unsigned int xoshiro_forward(void * __rng) {
+  xoshiro_type * rng = (xoshiro_type *) __rng;
+  return xoshiro_next( rng );
+}
+
+
+/**
+   Advances the state 2^64 steps; equivalent to 2^64 calls to
+   xoshiro_forward().
+*/
+
+void xoshiro_jump(void * __rng) {
+  static const uint32_t JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+  xoshiro_type * rng = xoshiro_safe_cast( __rng );
+  uint32_t s0 = 0;
+  uint32_t s1 = 0;
+  uint32_t s2 = 0;
+  uint32_t s3 = 0;
+  int i,b;
+
+  for (i = 0; i < 4; i++) {
+    for (b = 0; b < 32; b++) {
+      if (JUMP[i] & UINT32_C(1) << b) {
+        s0 ^= rng->s[0];
+        s1 ^= rng->s[1];
+        s2 ^= rng->s[2];
+        s3 ^= rng->s[3];
+      }
+      xoshiro_next( rng );
+    }
+  }
+
+  rng->s[0] = s0;
+  rng->s[1] = s1;
+  rng->s[2] = s2;
+  rng->s[3] = s3;
+}
+
+
+static void xoshiro_set_default_state( xoshiro_type * rng ) {
+  rng->s[0] = DEFAULT_S0;
+  rng->s[1] = DEFAULT_S1;
+  rng->s[2] = DEFAULT_S2;
+  rng->s[3] = DEFAULT_S3;
+}
+
+
+static void xoshiro_set_state4(xoshiro_type * rng ,
+                               uint32_t s0 , uint32_t s1,
+                               uint32_t s2 , uint32_t s3) {
+
+  if ((s0 | s1 | s2 | s3) == 0)
+    xoshiro_set_default_state( rng );
+  else {
+    rng->s[0] = s0;
+    rng->s[1] = s1;
+    rng->s[2] = s2;
+    rng->s[3] = s3;
+  }
+}
+
+
+static uint32_t fscanf_4bytes( FILE * stream ) {
+  uint32_t s;
+  char * char_ptr = (char *) &s;
+  int i;
+  for ( i=0; i < 4; i++) {
+    int c;
+    if ( fscanf(stream , "%d" , &c) == 1 )
+      char_ptr[i] = c;
+    else
+      util_abort("%s: reading bytes from stream failed.\n",__func__);
+  }
+  return s;
+}
+
+
+/**
+   The formatted state file uses the same format as mzran; the four
+   state integers are written as 16 individual bytes.
+*/
+
+void xoshiro_fscanf_state( void * __rng , FILE * stream ) {
+  uint32_t s0 = fscanf_4bytes( stream );
+  uint32_t s1 = fscanf_4bytes( stream );
+  uint32_t s2 = fscanf_4bytes( stream );
+  uint32_t s3 = fscanf_4bytes( stream );
+
+  xoshiro_type * rng = xoshiro_safe_cast( __rng );
+  xoshiro_set_state4( rng , s0 , s1 , s2 , s3);
+}
+
+
+static void fprintf_4bytes( uint32_t s , FILE * stream) {
+  char * char_ptr = (char *) &s;
+  int i;
+  for ( i=0; i < 4; i++)
+    fprintf(stream , "%d " , (int) char_ptr[i]);
+}
+
+
+void xoshiro_fprintf_state( const void * __rng , FILE * stream) {
+  const xoshiro_type * rng = xoshiro_safe_cast_const( __rng );
+  int i;
+  for (i=0; i < 4; i++)
+    fprintf_4bytes( rng->s[i] , stream );
+}
+
+
+/**
+   This function will set the state of the rng, based on a buffer of
+   length buffer size. 16 bytes will be read from the seed buffer.
+*/
+
+void xoshiro_set_state(void * __rng , const char * state_buffer) {
+  xoshiro_type * rng = xoshiro_safe_cast( __rng );
+  if (state_buffer == NULL)
+    xoshiro_set_default_state(rng);
+  else {
+    uint32_t state[4];
+    memcpy( state , state_buffer , sizeof state );
+    xoshiro_set_state4( rng , state[0] , state[1] , state[2] , state[3]);
+  }
+}
+
+
+void xoshiro_get_state(void * __rng , char * state_buffer) {
+  xoshiro_type * rng = xoshiro_safe_cast( __rng );
+  memcpy( state_buffer , rng->s , sizeof rng->s );
+}
+
+
+void * xoshiro_alloc( void ) {
+  xoshiro_type * rng = (xoshiro_type*) util_malloc( sizeof * rng );
+  UTIL_TYPE_ID_INIT( rng , XOSHIRO_TYPE_ID );
+  xoshiro_set_default_state( rng );
+  return rng;
+}
+
+
+void xoshiro_free( void * __rng ) {
+  xoshiro_type * rng = xoshiro_safe_cast( __rng );
+  free( rng );
+}
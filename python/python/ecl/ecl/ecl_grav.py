@@ -62,6 +62,7 @@ class EclGrav(BaseCClass):
         of EclGrid and EclFile respectively.
         """
         self.init_file = init_file   # Inhibit premature garbage collection of init_file
+        self.grid = grid             # The grid cache is shared, and refers to the grid
 
         c_ptr = self._grav_alloc(grid, init_file)
         super(EclGrav, self).__init__(c_ptr)
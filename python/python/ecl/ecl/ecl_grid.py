@@ -105,6 +105,9 @@ class EclGrid(BaseCClass):
     _init_actnum                  = EclPrototype("void   ecl_grid_init_actnum_data(ecl_grid, int*)")
     _compressed_kw_copy           = EclPrototype("void   ecl_grid_compressed_kw_copy(ecl_grid, ecl_kw, ecl_kw)")
     _global_kw_copy               = EclPrototype("void   ecl_grid_global_kw_copy(ecl_grid, ecl_kw, ecl_kw)")
+    _export_kw_global             = EclPrototype("void   ecl_grid_export_kw_global(ecl_grid, ecl_kw, double, void*)")
+    _export_kw_active             = EclPrototype("void   ecl_grid_export_kw_active(ecl_grid, ecl_kw, void*)")
+    _import_kw_global             = EclPrototype("void   ecl_grid_import_kw_global(ecl_grid, ecl_kw, void*)")
     _create_volume_keyword        = EclPrototype("ecl_kw_obj ecl_grid_alloc_volume_kw(ecl_grid, bool)")
     _use_mapaxes                  = EclPrototype("bool ecl_grid_use_mapaxes(ecl_grid)")
     _export_coord                 = EclPrototype("ecl_kw_obj ecl_grid_alloc_coord_kw(ecl_grid)")
@@ -1065,22 +1068,8 @@ class EclGrid(BaseCClass):
                     kw_name = kw_name[0:8]
 
                 kw = EclKW(kw_name, size, type)
-                active_index = 0
-                global_index = 0
-                for k in range(self.getNZ()):
-                    for j in range(self.getNY()):
-                        for i in range(self.getNX()):
-                            if pack:
-                                if self.active(global_index=global_index):
-                                    kw[active_index] = array[i,j,k]
-                                    active_index += 1
-                            else:
-                                if dtype == numpy.int32:
-                                    kw[global_index] = int(array[i,j,k])
-                                else:
-                                    kw[global_index] = array[i,j,k]
-
-                            global_index += 1
+                global_data = numpy.ascontiguousarray(array.reshape(self.getGlobalSize(), order='F'))
+                self._import_kw_global(kw, global_data.ctypes.data)
                 return kw
         raise ValueError("Wrong size / dimension on array")
 
@@ -1119,19 +1108,12 @@ class EclGrid(BaseCClass):
            value = grid.grid_value(ecl_kw, i, j, k)
 
         """
-        if len(ecl_kw) == self.getNumActive() or len(ecl_kw) == self.getGlobalSize():
-            array = numpy.ones([ self.getGlobalSize() ], dtype=ecl_kw.dtype) * default
-            kwa = ecl_kw.array
-            if len(ecl_kw) == self.getGlobalSize():
-                for i in range(kwa.size):
-                    array[i] = kwa[i]
-            else:
-                data_index = 0
-                for global_index in range(self.getGlobalSize()):
-                    if self.active(global_index=global_index):
-                        array[global_index] = kwa[data_index]
-                        data_index += 1
+        if not ecl_kw.dtype in (numpy.int32, numpy.float32, numpy.float64):
+            raise ValueError("Keyword \"%s\" is not numeric - can not create numpy array" % ecl_kw.getName())
 
+        if len(ecl_kw) == self.getNumActive() or len(ecl_kw) == self.getGlobalSize():
+            array = numpy.empty([ self.getGlobalSize() ], dtype=ecl_kw.dtype)
+            self._export_kw_global(ecl_kw, default, array.ctypes.data)
             array = array.reshape([self.getNX(), self.getNY(), self.getNZ()], order='F')
             return array
         else:
@@ -1140,6 +1122,22 @@ class EclGrid(BaseCClass):
                                      self.getGlobalSize())
             raise ValueError(err_msg)
 
+    def view_3d(self, ecl_kw):
+        """
+        Creates a 3D numpy view of the data in the global sized @ecl_kw.
+
+        In contrast to create_3d() no data is copied; the numpy array
+        aliases the keyword data and modifications are reflected in
+        the EclKW instance. The keyword is pinned while the view is
+        alive, see EclKW.numpy_view().
+        """
+        if len(ecl_kw) != self.getGlobalSize():
+            raise ValueError('Keyword "%s" has size %d; a 3D view requires nx*ny*nz=%d' % (ecl_kw.getName(), len(ecl_kw), self.getGlobalSize()))
+
+        view = ecl_kw.numpy_view()
+        return view.reshape([self.getNX(), self.getNY(), self.getNZ()], order='F')
+
+
     def save_grdecl(self, pyfile, output_unit=EclUnitTypeEnum.ECL_METRIC_UNITS):
         """
         Will write the the grid content as grdecl formatted keywords.
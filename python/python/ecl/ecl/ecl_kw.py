@@ -75,6 +75,24 @@ def warn_and_cast_data_type(data_type):
         dump_type_deprecation_warning()
         return EclDataType(data_type)
 
+class _EclKWPin(object):
+    """
+    Holds a pin on the underlying ecl_kw instance; attached to the
+    ctypes buffer behind the arrays returned from EclKW.numpy_view().
+    Only the C address is kept, so the EclKW object itself can be
+    garbage collected while views are still alive; in that case the
+    keyword is finally freed when the last view goes away.
+    """
+
+    def __init__(self, ecl_kw):
+        ecl_kw._pin()
+        self._address = ecl_kw._address()
+        self._unpin = EclKW._unpin_address
+
+    def __del__(self):
+        self._unpin(self._address)
+
+
 class EclKW(BaseCClass):
     """
     The EclKW class contains the information from one ECLIPSE keyword.
@@ -121,6 +139,9 @@ class EclKW(BaseCClass):
     _int_ptr           = EclPrototype("int*     ecl_kw_get_int_ptr(ecl_kw)")
     _double_ptr        = EclPrototype("double*  ecl_kw_get_double_ptr(ecl_kw)")
     _free              = EclPrototype("void     ecl_kw_free(ecl_kw)")
+    _pin               = EclPrototype("void     ecl_kw_pin(ecl_kw)")
+    _unpin_address     = EclPrototype("void     ecl_kw_unpin(void*)", bind = False)
+    _get_pin_count     = EclPrototype("int      ecl_kw_get_pin_count(ecl_kw)")
     _fwrite            = EclPrototype("void     ecl_kw_fwrite(ecl_kw, fortio)")
     _get_header        = EclPrototype("char*    ecl_kw_get_header (ecl_kw)")
     _set_header        = EclPrototype("void     ecl_kw_set_header_name (ecl_kw, char*)")
@@ -897,7 +918,13 @@ class EclKW(BaseCClass):
     def resize(self, new_size):
         """
         Will set the new size of the kw to @new_size.
+
+        The keyword can not be resized while there are live numpy
+        views of the data, see numpy_view().
         """
+        if self.pin_count() > 0:
+            raise ValueError("Can not resize keyword %s while numpy views of the data are alive" % self.getName())
+
         if new_size >= 0:
             self._resize(new_size)
 
@@ -1039,6 +1066,12 @@ class EclKW(BaseCClass):
         The data in this numpy array is *shared* with the EclKW
         instance, meaning that updates in one will be reflected in the
         other.
+
+        The keyword is pinned for as long as the numpy array - or any
+        array derived from it - is alive. While pinned the keyword can
+        not be resized, and the memory is not released when the EclKW
+        object is garbage collected, or when the EclFile it was loaded
+        from is closed.
         """
 
         if self.dtype is numpy.float64:
@@ -1051,7 +1084,14 @@ class EclKW(BaseCClass):
             raise ValueError("Invalid type - numpy array only valid for int/float/double")
 
         ap = ctypes.cast(self.data_ptr, ctypes.POINTER(ct * len(self)))
-        return numpy.frombuffer(ap.contents, dtype=self.dtype)
+        buffer = ap.contents
+        buffer._ecl_kw_pin = _EclKWPin(self)
+        return numpy.frombuffer(buffer, dtype=self.dtype)
+
+
+    def pin_count(self):
+        """The number of live numpy views aliasing the keyword data."""
+        return self._get_pin_count()
 
 
     def numpy_copy(self):
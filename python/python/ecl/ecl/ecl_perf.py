@@ -0,0 +1,118 @@
+#  Copyright (C) 2017  Statoil ASA, Norway.
+#
+#  The file 'ecl_perf.py' is part of ERT - Ensemble based Reservoir Tool.
+#
+#  ERT is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+#  WARRANTY; without even the implied warranty of MERCHANTABILITY or
+#  FITNESS FOR A PARTICULAR PURPOSE.
+#
+#  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+#  for more details.
+"""
+Access to the I/O counters of the fortio / ecl_kw / ecl_file layer.
+
+The counters are off by default, and must be enabled before the I/O
+which should be measured:
+
+   EclPerf.enable()
+   ecl_file = EclFile("CASE.UNRST")
+   ...
+   print(EclPerf.counters())
+
+The counters are summed over all threads; the time counters
+endian_ns and formatted_ns are in nanoseconds.
+"""
+from ecl.ecl import EclPrototype
+
+
+class EclPerf(object):
+    _enable         = EclPrototype("void   ecl_perf_enable(bool)", bind = False)
+    _enabled        = EclPrototype("bool   ecl_perf_enabled()", bind = False)
+    _trace_enable   = EclPrototype("void   ecl_perf_trace_enable(bool)", bind = False)
+    _trace_enabled  = EclPrototype("bool   ecl_perf_trace_enabled()", bind = False)
+    _reset          = EclPrototype("void   ecl_perf_reset()", bind = False)
+    _num_counters   = EclPrototype("int    ecl_perf_num_counters()", bind = False)
+    _counter_name   = EclPrototype("char*  ecl_perf_counter_name(int)", bind = False)
+    _get            = EclPrototype("int64  ecl_perf_get(int)", bind = False)
+    _get_thread     = EclPrototype("int64  ecl_perf_get_thread(int)", bind = False)
+    _fwrite_json    = EclPrototype("bool   ecl_perf_fwrite_json(char*)", bind = False)
+    _fwrite_trace   = EclPrototype("bool   ecl_perf_fwrite_trace(char*)", bind = False)
+
+
+    @staticmethod
+    def enable(enable = True):
+        EclPerf._enable(enable)
+
+    @staticmethod
+    def disable():
+        EclPerf._enable(False)
+
+    @staticmethod
+    def enabled():
+        return EclPerf._enabled()
+
+    @staticmethod
+    def enable_trace(enable = True):
+        """
+        Will record a trace event for each keyword read and written,
+        enabling the trace will also enable the counters.
+        """
+        EclPerf._trace_enable(enable)
+
+    @staticmethod
+    def trace_enabled():
+        return EclPerf._trace_enabled()
+
+    @staticmethod
+    def reset():
+        EclPerf._reset()
+
+    @staticmethod
+    def names():
+        return [EclPerf._counter_name(i) for i in range(EclPerf._num_counters())]
+
+    @staticmethod
+    def _index(name):
+        names = EclPerf.names()
+        if not name in names:
+            raise KeyError("No such counter: %s - valid counters: %s" % (name, names))
+        return names.index(name)
+
+    @staticmethod
+    def get(name):
+        """
+        Will return the value of counter @name summed over all threads.
+        """
+        return EclPerf._get(EclPerf._index(name))
+
+    @staticmethod
+    def get_thread(name):
+        """
+        Will return the value of counter @name for the calling thread.
+        """
+        return EclPerf._get_thread(EclPerf._index(name))
+
+    @staticmethod
+    def counters():
+        """
+        Will return a dictionary with the current value of all counters.
+        """
+        return {name : EclPerf._get(i) for i, name in enumerate(EclPerf.names())}
+
+    @staticmethod
+    def dump_json(filename):
+        if not EclPerf._fwrite_json(filename):
+            raise IOError("Failed to write counters to: %s" % filename)
+
+    @staticmethod
+    def dump_trace(filename):
+        """
+        Writes the recorded trace events in Chrome trace format.
+        """
+        if not EclPerf._fwrite_trace(filename):
+            raise IOError("Failed to write trace to: %s" % filename)
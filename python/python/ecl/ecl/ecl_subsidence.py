@@ -58,6 +58,7 @@ class EclSubsidence(BaseCClass):
         of EclGrid and EclFile respectively.
         """
         self.init_file = init_file   # Inhibit premature garbage collection of init_file
+        self.grid = grid             # The grid cache is shared, and refers to the grid
         c_ptr = self._alloc( grid , init_file )
         super( EclSubsidence , self ).__init__( c_ptr )
 
@@ -23,6 +23,7 @@ libecl/src directory.
 
 
 import numpy
+import ctypes
 import datetime
 import os.path
 
@@ -84,6 +85,18 @@ def date2num(dt):
     return base
 
 
+# date2num() of 1970-01-01, used to convert time_t values to
+# matplotlib dates without going through datetime instances.
+EPOCH_ORDINAL = 719163.0
+
+def _buffer_ptr(array, ctype):
+    """
+    Pointer to the data of the contiguous numpy array @array, for use
+    with the ecl_sum_export_xxx() functions.
+    """
+    return array.ctypes.data_as(ctypes.POINTER(ctype))
+
+
 class EclSum(BaseCClass):
     TYPE_NAME = "ecl_sum"
     _fread_alloc_case              = EclPrototype("void*     ecl_sum_fread_alloc_case__(char*, char*, bool)", bind=False)
@@ -137,6 +150,13 @@ class EclSum(BaseCClass):
     _add_tstep                     = EclPrototype("ecl_sum_tstep_ref ecl_sum_add_tstep(ecl_sum, int, double)")
     _export_csv                    = EclPrototype("void ecl_sum_export_csv(ecl_sum, char*, stringlist, char*, char*)")
     _identify_var_type             = EclPrototype("ecl_sum_var_type ecl_sum_identify_var_type(char*)", bind = False)
+    _get_export_length             = EclPrototype("int      ecl_sum_get_export_length(ecl_sum, bool)")
+    _export_days                   = EclPrototype("void     ecl_sum_export_days(ecl_sum, bool, double*)")
+    _export_time                   = EclPrototype("void     ecl_sum_export_time(ecl_sum, bool, int64*)")
+    _export_report_step            = EclPrototype("void     ecl_sum_export_report_step(ecl_sum, bool, int*)")
+    _export_mini_step              = EclPrototype("void     ecl_sum_export_mini_step(ecl_sum, bool, int*)")
+    _export_vector                 = EclPrototype("void     ecl_sum_export_vector(ecl_sum, char*, bool, double*)")
+    _export_vectors                = EclPrototype("void     ecl_sum_export_vectors(ecl_sum, stringlist, bool, double*)")
 
 
 
@@ -236,47 +256,28 @@ class EclSum(BaseCClass):
 
 
     def __private_init(self):
-        # Initializing the time vectors
-        length = self.length
-        self.__dates = [0] * length
-        self.__report_step = numpy.zeros(length, dtype=numpy.int32)
-        self.__mini_step = numpy.zeros(length, dtype=numpy.int32)
-        self.__days = numpy.zeros(length)
-        self.__mpl_dates = numpy.zeros(length)
-
-        for i in range(length):
-            self.__days[i] = self._iget_sim_days(i)
-            self.__dates[i] = self.iget_date(i)
-            self.__report_step[i] = self._iget_report_step(i)
-            self.__mini_step[i] = self._iget_mini_step(i)
-            self.__mpl_dates[i] = date2num(self.__dates[i])
-
-        index_list = self.report_index_list()
-
-        length = len(index_list) - index_list.count(-1)
-        self.__datesR = [0] * length
-        self.__report_stepR = numpy.zeros(length, dtype=numpy.int32)
-        self.__mini_stepR = numpy.zeros(length, dtype=numpy.int32)
-        self.__daysR = numpy.zeros(length)
-        self.__mpl_datesR = numpy.zeros(length)
-
-        # Slightly hysterical heuristics to accomoate for the
-        # situation where there are holes in the report steps series;
-        # when a report step is completely missing there will be -1
-        # entries in the index_list.
-        i1 = 0
-        for i0 in range(length):
-            while True:
-                time_index = index_list[i1]
-                if time_index >= 0:
-                    break
-                i1 += 1
-
-            self.__daysR[i0] = self._iget_sim_days(time_index)
-            self.__datesR[i0] = self.iget_date(time_index)
-            self.__report_stepR[i0] = self._iget_report_step(time_index)
-            self.__mini_stepR[i0] = self._iget_mini_step(time_index)
-            self.__mpl_datesR[i0] = date2num(self.__datesR[i0])
+        # Initializing the time vectors; the C library fills the numpy
+        # buffers directly.
+        (self.__days, self.__dates, self.__report_step, self.__mini_step, self.__mpl_dates) = self.__export_time_vectors(False)
+        (self.__daysR, self.__datesR, self.__report_stepR, self.__mini_stepR, self.__mpl_datesR) = self.__export_time_vectors(True)
+
+
+    def __export_time_vectors(self, report_only):
+        length = self._get_export_length(report_only)
+        days = numpy.zeros(length)
+        sim_time = numpy.zeros(length, dtype=numpy.int64)
+        report_step = numpy.zeros(length, dtype=numpy.int32)
+        mini_step = numpy.zeros(length, dtype=numpy.int32)
+
+        self._export_days(report_only, _buffer_ptr(days, ctypes.c_double))
+        self._export_time(report_only, _buffer_ptr(sim_time, ctypes.c_int64))
+        self._export_report_step(report_only, _buffer_ptr(report_step, ctypes.c_int))
+        self._export_mini_step(report_only, _buffer_ptr(mini_step, ctypes.c_int))
+
+        epoch = datetime.datetime(1970, 1, 1)
+        dates = [epoch + datetime.timedelta(seconds=int(t)) for t in sim_time]
+        mpl_dates = EPOCH_ORDINAL + sim_time / SECONDS_PER_DAY
+        return (days, dates, report_step, mini_step, mpl_dates)
 
 
     def get_vector(self, key, report_only=False):
@@ -339,24 +340,34 @@ class EclSum(BaseCClass):
         instance.
         """
         if self.has_key(key):
-            key_index = self._get_general_var_index(key)
-            if report_only:
-                index_list = self.report_index_list()
-                values = numpy.zeros(len(index_list))
-                for i in range(len(index_list)):
-                    time_index = index_list[i]
-                    values[i]  = self._iiget(time_index, key_index)
-            else:
-                length = self._data_length()
-                values = numpy.zeros(length)
-                for i in range(length):
-                    values[i] = self._iiget(i, key_index)
-
+            values = numpy.zeros(self._get_export_length(report_only))
+            self._export_vector(key, report_only, _buffer_ptr(values, ctypes.c_double))
             return values
         else:
             raise KeyError("Summary object does not have key:%s" % key)
 
 
+    def numpy_values(self, keys, report_only=False):
+        """
+        Will return a 2D numpy array with the values of all the @keys.
+
+        The array has one row for each key, and one column for each
+        ministep, or for each report step if @report_only is
+        True. All the vectors are extracted in one call to the C
+        library, which is much faster than calling get_values() in a
+        loop when many keys are needed.
+        """
+        key_list = StringList()
+        for key in keys:
+            self.assertKeyValid(key)
+            key_list.append(key)
+
+        values = numpy.zeros((len(key_list), self._get_export_length(report_only)))
+        if len(key_list) > 0:
+            self._export_vectors(key_list, report_only, _buffer_ptr(values, ctypes.c_double))
+        return values
+
+
     def get_key_index(self, key):
         """
         Lookup parameter index of @key.
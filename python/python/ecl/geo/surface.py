@@ -28,6 +28,7 @@ class Surface(BaseCClass):
     TYPE_NAME = "surface"
 
     _alloc        = GeoPrototype("void*  geo_surface_fload_alloc_irap( char* , bool )" , bind = False)
+    _alloc_binary = GeoPrototype("void*  geo_surface_fload_alloc_irap_binary( char* , bool )" , bind = False)
     _free         = GeoPrototype("void   geo_surface_free( surface )")
     _new          = GeoPrototype("void*  geo_surface_alloc_new( int, int, double, double, double, double, double )", bind = False)
     _get_nx       = GeoPrototype("int    geo_surface_get_nx( surface )")
@@ -35,6 +36,7 @@ class Surface(BaseCClass):
     _iget_zvalue  = GeoPrototype("double geo_surface_iget_zvalue( surface , int)")
     _iset_zvalue  = GeoPrototype("void   geo_surface_iset_zvalue( surface , int , double)")
     _write        = GeoPrototype("void   geo_surface_fprintf_irap( surface , char* )")
+    _write_binary = GeoPrototype("void   geo_surface_fwrite_irap_binary( surface , char* )")
     _equal        = GeoPrototype("bool   geo_surface_equal( surface , surface )")
     _header_equal = GeoPrototype("bool   geo_surface_equal_header( surface , surface )")
     _copy         = GeoPrototype("surface_obj geo_surface_alloc_copy( surface , bool )")
@@ -50,15 +52,21 @@ class Surface(BaseCClass):
 
 
     def __init__(self, filename=None, nx=None, ny=None, xinc=None, yinc=None,
-                                      xstart=None, ystart=None, angle=None):
+                                      xstart=None, ystart=None, angle=None, binary=False):
         """
         This will load a irap surface from file. The surface should
-        consist of a header and a set z values.
+        consist of a header and a set z values; with binary=True the
+        file is loaded as an IRAP binary surface.
         """
         if filename is not None:
             filename = str(filename)
             if os.path.isfile( filename ):
-                c_ptr = self._alloc(filename , True)
+                if binary:
+                    c_ptr = self._alloc_binary(filename , True)
+                    if not c_ptr:
+                        raise IOError('Failed to load IRAP binary surface from "%s".' % filename)
+                else:
+                    c_ptr = self._alloc(filename , True)
                 super(Surface , self).__init__(c_ptr)
             else:
                 raise IOError('No such file "%s".' % filename)
@@ -177,12 +185,16 @@ class Surface(BaseCClass):
         return self._copy( copy_data)
 
 
-    def write(self , filename):
+    def write(self , filename, binary=False):
 
         """
-        Will write the surface as an ascii formatted file to @filename.
+        Will write the surface as an ascii formatted file to @filename,
+        or as an IRAP binary file if binary=True.
         """
-        self._write(  filename )
+        if binary:
+            self._write_binary( filename )
+        else:
+            self._write(  filename )
 
 
 
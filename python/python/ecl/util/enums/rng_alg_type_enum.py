@@ -3,6 +3,8 @@ from cwrap import BaseCEnum
 class RngAlgTypeEnum(BaseCEnum):
     TYPE_NAME = "rng_alg_type_enum"
     MZRAN = None
+    XOSHIRO = None
 
 
 RngAlgTypeEnum.addEnum("MZRAN", 1)
+RngAlgTypeEnum.addEnum("XOSHIRO", 2)
@@ -381,6 +381,31 @@ class KWTest(ExtendedTestCase):
             with self.assertRaises(ValueError):
                 kw2.numpyView()
 
+    def test_numpy_view_pin(self):
+        kw = EclKW("DOUBLE", 10, EclDataType.ECL_DOUBLE)
+        kw.assign(1.5)
+        self.assertEqual(kw.pin_count(), 0)
+
+        view = kw.numpy_view()
+        sub = view[2:5]
+        self.assertEqual(kw.pin_count(), 1)
+        with self.assertRaises(ValueError):
+            kw.resize(20)
+
+        del view
+        self.assertEqual(kw.pin_count(), 1)
+        del sub
+        self.assertEqual(kw.pin_count(), 0)
+        kw.resize(20)
+
+        # The view keeps the data alive after the EclKW is gone.
+        view = kw.numpy_view()
+        kw[0] = 7
+        del kw
+        self.assertEqual(view[0], 7)
+        self.assertEqual(view[19], 0)
+
+
     def test_slice(self):
         N = 100
         kw = EclKW("KW", N, EclDataType.ECL_INT)
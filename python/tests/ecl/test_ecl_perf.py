@@ -0,0 +1,52 @@
+#  Copyright (C) 2017  Statoil ASA, Norway.
+#
+#  The file 'test_ecl_perf.py' is part of ERT - Ensemble based Reservoir Tool.
+#
+#  ERT is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+#  WARRANTY; without even the implied warranty of MERCHANTABILITY or
+#  FITNESS FOR A PARTICULAR PURPOSE.
+#
+#  See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+#  for more details.
+import json
+
+from ecl.ecl import EclPerf, EclKW, EclDataType, EclFile, FortIO, openFortIO
+from ecl.test import ExtendedTestCase, TestAreaContext
+
+
+class EclPerfTest(ExtendedTestCase):
+
+    def test_counters(self):
+        with TestAreaContext("ecl_perf"):
+            EclPerf.enable()
+            EclPerf.reset()
+            self.assertTrue(EclPerf.enabled())
+
+            kw = EclKW("PRESSURE", 100, EclDataType.ECL_FLOAT)
+            with openFortIO("FILE.UNRST", mode=FortIO.WRITE_MODE) as f:
+                kw.fwrite(f)
+
+            self.assertEqual(EclPerf.get("kw_written"), 1)
+            self.assertTrue(EclPerf.get("bytes_written") >= 400)
+
+            ecl_file = EclFile("FILE.UNRST")
+            ecl_file["PRESSURE"][0]
+            self.assertEqual(EclPerf.get("kw_read"), 1)
+
+            counters = EclPerf.counters()
+            self.assertEqual(set(counters.keys()), set(EclPerf.names()))
+            with self.assertRaises(KeyError):
+                EclPerf.get("no_such_counter")
+
+            EclPerf.dump_json("perf.json")
+            with open("perf.json") as f:
+                perf = json.load(f)
+            self.assertEqual(perf["total"]["kw_written"], 1)
+
+            EclPerf.disable()
+            self.assertFalse(EclPerf.enabled())
@@ -343,6 +343,49 @@ class GridTest(ExtendedTestCase):
         kw = EclKW( "SWAT" , nx*ny*nz , EclDataType.ECL_FLOAT )
         numpy_3d = grid.create3D( kw )
 
+    def test_view3D(self):
+        nx = 4
+        ny = 3
+        nz = 2
+        grid = GridGen.createRectangular((nx,ny,nz) , (1,1,1))
+        kw = EclKW( "SWAT" , nx*ny*nz , EclDataType.ECL_FLOAT )
+        view = grid.view_3d( kw )
+        view[1,2,1] = 0.5
+        self.assertEqual( kw[grid.get_global_index( ijk = (1,2,1))] , 0.5 )
+        self.assertEqual( kw.pin_count() , 1 )
+        del view
+        self.assertEqual( kw.pin_count() , 0 )
+
+        with self.assertRaises(ValueError):
+            grid.view_3d( EclKW( "PORO" , 10 , EclDataType.ECL_FLOAT ))
+
+    def test_numpy3D_active(self):
+        nx = 4
+        ny = 3
+        nz = 2
+        actnum = EclKW( "ACTNUM" , nx*ny*nz , EclDataType.ECL_INT )
+        actnum.assign( 1 )
+        actnum[0] = 0
+        actnum[nx*ny + 5] = 0
+        grid = GridGen.createRectangular( (nx,ny,nz) , (1,1,1), actnum = actnum)
+
+        kw = EclKW( "PORO" , grid.getNumActive() , EclDataType.ECL_FLOAT )
+        for i in range(len(kw)):
+            kw[i] = i
+        numpy_3d = grid.create3D( kw , default = -1 )
+        self.assertEqual( numpy_3d[0,0,0] , -1 )
+        self.assertEqual( numpy_3d[1,0,0] , 0 )
+        self.assertEqual( numpy_3d[1,1,1] , -1 )
+        self.assertEqual( numpy_3d[3,2,1] , grid.getNumActive() - 1 )
+
+        packed = grid.createKW( numpy_3d , "PORO" , True )
+        self.assertEqual( packed , kw )
+
+        full = grid.createKW( numpy_3d , "PORO" , False )
+        self.assertEqual( len(full) , nx*ny*nz )
+        self.assertEqual( full[0] , -1 )
+        self.assertEqual( full[nx*ny*nz - 1] , grid.getNumActive() - 1 )
+
     def test_len(self):
         nx = 10
         ny = 11
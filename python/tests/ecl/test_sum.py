@@ -230,6 +230,35 @@ class SumTest(ExtendedTestCase):
                 self.assertFloatEqual(x[i], y[i])
 
 
+    def test_numpy_values(self):
+        case = createEclSum("CSV" , [("FOPT", None , 0) , ("FOPR" , None , 0), ("FGPT" , None , 0)],
+                            sim_length_days = 100,
+                            num_report_step = 10,
+                            num_mini_step = 10,
+                            func_table = {"FOPT" : fopt,
+                                          "FOPR" : fopr ,
+                                          "FGPT" : fgpt })
+
+        keys = ["FOPT", "FGPT"]
+        for report_only in (False, True):
+            values = case.numpy_values(keys, report_only=report_only)
+            self.assertEqual(values.shape, (2, len(case.get_days(report_only))))
+            for row, key in enumerate(keys):
+                vector = case.get_values(key, report_only=report_only)
+                for i in range(len(vector)):
+                    self.assertFloatEqual(values[row, i], vector[i])
+
+        days = case.days
+        dates = case.dates
+        for i in range(len(days)):
+            self.assertFloatEqual(days[i], case.iget_days(i))
+            self.assertEqual(dates[i], case.iget_date(i))
+            self.assertFloatEqual(case.iget("FOPT", i), case.get_values("FOPT")[i])
+
+        with self.assertRaises(KeyError):
+            case.numpy_values(["FOPT", "NO_SUCH_KEY"])
+
+
     def test_different_names(self):
         length = 100
         case = createEclSum("CSV" , [("FOPT", None , 0) , ("FOPR" , None , 0), ("FGPT" , None , 0)],
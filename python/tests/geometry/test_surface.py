@@ -98,6 +98,17 @@ class SurfaceTest(ExtendedTestCase):
             self.assertFalse( s1 == s0 )
 
 
+    def test_write_binary(self):
+        with TestAreaContext("surface/write_binary"):
+            s0 = Surface(None, 30, 20, 50.0, 50.0, 463325.5625, 7336963.5, -65.0)
+            for i in range(len(s0)):
+                s0[i] = 1000 + 0.25 * i
+            s0.write( "new_surface.bin" , binary = True)
+
+            s1 = Surface( "new_surface.bin" , binary = True)
+            self.assertTrue( s1 == s0 )
+
+
 
     def test_copy(self):
         with TestAreaContext("surface/copy"):